@@ -29,6 +29,7 @@ extern "C" {
 #define PUBSUB_PUBLISHERMOCK_SCOPE "pubsub_publisher"
 #define PUBSUB_PUBLISHERMOCK_LOCAL_MSG_TYPE_ID_FOR_MSG_TYPE_METHOD "pubsub__publisherMock_localMsgTypeIdForMsgType"
 #define PUBSUB_PUBLISHERMOCK_SEND_METHOD "pubsub__publisherMock_send"
+#define PUBSUB_PUBLISHERMOCK_SEND_MANY_METHOD "pubsub__publisherMock_sendMany"
 #define PUBSUB_PUBLISHERMOCK_SEND_MULTIPART_METHOD "pubsub__publisherMock_sendMultipart"
 
 
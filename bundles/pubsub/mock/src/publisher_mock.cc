@@ -47,6 +47,18 @@ static int pubsub__publisherMock_send(void *handle, unsigned int msgTypeId, cons
         .returnIntValue();
 }
 
+/*============================================================================
+  MOCK - mock function for pubsub_publisher->sendMany
+  ============================================================================*/
+static int pubsub__publisherMock_sendMany(void *handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    return mock(PUBSUB_PUBLISHERMOCK_SCOPE)
+        .actualCall(PUBSUB_PUBLISHERMOCK_SEND_MANY_METHOD)
+        .withPointerParameter("handle", handle)
+        .withConstPointerParameter("msgs", msgs)
+        .withUnsignedLongIntParameter("nrOfMsgs", nrOfMsgs)
+        .returnIntValue();
+}
+
 /*============================================================================
   MOCK - mock setup for publisher service
   ============================================================================*/
@@ -54,4 +66,5 @@ void pubsub_publisherMock_init(pubsub_publisher_t* srv, void* handle) {
     srv->handle = handle;
     srv->localMsgTypeIdForMsgType = pubsub__publisherMock_localMsgTypeIdForMsgType;
     srv->send = pubsub__publisherMock_send;
+    srv->sendMany = pubsub__publisherMock_sendMany;
 }
@@ -0,0 +1,508 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <memory.h>
+#include <pubsub_endpoint.h>
+#include <pubsub_serializer.h>
+
+#include "pubsub_utils.h"
+#include "pubsub_local_admin.h"
+#include "pubsub_psa_local_constants.h"
+#include "pubsub_local_topic_sender.h"
+#include "pubsub_local_topic_receiver.h"
+
+#define L_DEBUG(...) \
+    celix_logHelper_log(psa->log, CELIX_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define L_INFO(...) \
+    celix_logHelper_log(psa->log, CELIX_LOG_LEVEL_INFO, __VA_ARGS__)
+#define L_WARN(...) \
+    celix_logHelper_log(psa->log, CELIX_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define L_ERROR(...) \
+    celix_logHelper_log(psa->log, CELIX_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+struct pubsub_local_admin {
+    celix_bundle_context_t *ctx;
+    celix_log_helper_t *log;
+    const char *fwUUID;
+
+    double qosSampleScore;
+    double qosControlScore;
+    double defaultScore;
+
+    bool verbose;
+
+    struct {
+        celix_thread_mutex_t mutex;
+        hash_map_t *map; //key = svcId, value = psa_local_serializer_entry_t*
+    } serializers;
+
+    //note lock order: serializers, topicSenders, topicReceivers
+    struct {
+        celix_thread_mutex_t mutex;
+        hash_map_t *map; //key = scope:topic key, value = pubsub_local_topic_sender_t*
+    } topicSenders;
+
+    struct {
+        celix_thread_mutex_t mutex;
+        hash_map_t *map; //key = scope:topic key, value = pubsub_local_topic_receiver_t*
+    } topicReceivers;
+};
+
+typedef struct psa_local_serializer_entry {
+    const char *serType;
+    long svcId;
+    pubsub_serializer_service_t *svc;
+} psa_local_serializer_entry_t;
+
+static celix_properties_t* pubsub_localAdmin_createEndpoint(pubsub_local_admin_t *psa, const char *scope, const char *topic, const char *endpointType, const char *serType);
+
+pubsub_local_admin_t* pubsub_localAdmin_create(celix_bundle_context_t *ctx, celix_log_helper_t *logHelper) {
+    pubsub_local_admin_t *psa = calloc(1, sizeof(*psa));
+    psa->ctx = ctx;
+    psa->log = logHelper;
+    psa->verbose = celix_bundleContext_getPropertyAsBool(ctx, PUBSUB_LOCAL_VERBOSE_KEY, PUBSUB_LOCAL_VERBOSE_DEFAULT);
+    psa->fwUUID = celix_bundleContext_getProperty(ctx, OSGI_FRAMEWORK_FRAMEWORK_UUID, NULL);
+
+    psa->defaultScore = celix_bundleContext_getPropertyAsDouble(ctx, PSA_LOCAL_DEFAULT_SCORE_KEY, PSA_LOCAL_DEFAULT_SCORE);
+    psa->qosSampleScore = celix_bundleContext_getPropertyAsDouble(ctx, PSA_LOCAL_QOS_SAMPLE_SCORE_KEY, PSA_LOCAL_DEFAULT_QOS_SAMPLE_SCORE);
+    psa->qosControlScore = celix_bundleContext_getPropertyAsDouble(ctx, PSA_LOCAL_QOS_CONTROL_SCORE_KEY, PSA_LOCAL_DEFAULT_QOS_CONTROL_SCORE);
+
+    celixThreadMutex_create(&psa->serializers.mutex, NULL);
+    psa->serializers.map = hashMap_create(NULL, NULL, NULL, NULL);
+
+    celixThreadMutex_create(&psa->topicSenders.mutex, NULL);
+    psa->topicSenders.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+    celixThreadMutex_create(&psa->topicReceivers.mutex, NULL);
+    psa->topicReceivers.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+    return psa;
+}
+
+void pubsub_localAdmin_destroy(pubsub_local_admin_t *psa) {
+    if (psa == NULL) {
+        return;
+    }
+
+    //note assuming al psa register services and service tracker are removed.
+
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(psa->topicSenders.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_local_topic_sender_t *sender = hashMapIterator_nextValue(&iter);
+        pubsub_localTopicSender_destroy(sender);
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    iter = hashMapIterator_construct(psa->topicReceivers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_local_topic_receiver_t *recv = hashMapIterator_nextValue(&iter);
+        pubsub_localTopicReceiver_destroy(recv);
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    iter = hashMapIterator_construct(psa->serializers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_local_serializer_entry_t *entry = hashMapIterator_nextValue(&iter);
+        free(entry);
+    }
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+
+    celixThreadMutex_destroy(&psa->topicSenders.mutex);
+    hashMap_destroy(psa->topicSenders.map, true, false);
+
+    celixThreadMutex_destroy(&psa->topicReceivers.mutex);
+    hashMap_destroy(psa->topicReceivers.map, true, false);
+
+    celixThreadMutex_destroy(&psa->serializers.mutex);
+    hashMap_destroy(psa->serializers.map, false, false);
+
+    free(psa);
+}
+
+void pubsub_localAdmin_addSerializerSvc(void *handle, void *svc, const celix_properties_t *props) {
+    pubsub_local_admin_t *psa = handle;
+
+    const char *serType = celix_properties_get(props, PUBSUB_SERIALIZER_TYPE_KEY, NULL);
+    long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1L);
+
+    if (serType == NULL) {
+        L_INFO("[PSA_LOCAL] Ignoring serializer service without %s property", PUBSUB_SERIALIZER_TYPE_KEY);
+        return;
+    }
+
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    psa_local_serializer_entry_t *entry = hashMap_get(psa->serializers.map, (void*)svcId);
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(*entry));
+        entry->serType = serType;
+        entry->svcId = svcId;
+        entry->svc = svc;
+        hashMap_put(psa->serializers.map, (void*)svcId, entry);
+    }
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+}
+
+void pubsub_localAdmin_removeSerializerSvc(void *handle, void *svc __attribute__((unused)), const celix_properties_t *props) {
+    pubsub_local_admin_t *psa = handle;
+    long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1L);
+
+    //remove serializer
+    // 1) First find entry and
+    // 2) loop and destroy all topic sender using the serializer and
+    // 3) loop, disconnect and destroy all topic receivers using the serializer
+    // Note that it is the responsibility of the topology manager to create new topic senders/receivers
+
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    psa_local_serializer_entry_t *entry = hashMap_remove(psa->serializers.map, (void*)svcId);
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+
+    if (entry != NULL) {
+        celixThreadMutex_lock(&psa->topicSenders.mutex);
+        hash_map_iterator_t iter = hashMapIterator_construct(psa->topicSenders.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            hash_map_entry_t *senderEntry = hashMapIterator_nextEntry(&iter);
+            pubsub_local_topic_sender_t *sender = hashMapEntry_getValue(senderEntry);
+            if (sender != NULL && entry->svcId == pubsub_localTopicSender_serializerSvcId(sender)) {
+                char *key = hashMapEntry_getKey(senderEntry);
+                hashMapIterator_remove(&iter);
+                pubsub_localTopicSender_destroy(sender);
+                free(key);
+            }
+        }
+
+        celixThreadMutex_lock(&psa->topicReceivers.mutex);
+        iter = hashMapIterator_construct(psa->topicReceivers.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            hash_map_entry_t *receiverEntry = hashMapIterator_nextEntry(&iter);
+            pubsub_local_topic_receiver_t *receiver = hashMapEntry_getValue(receiverEntry);
+            if (receiver != NULL && entry->svcId == pubsub_localTopicReceiver_serializerSvcId(receiver)) {
+                char *key = hashMapEntry_getKey(receiverEntry);
+                pubsub_local_topic_sender_t *sender = hashMap_get(psa->topicSenders.map, key);
+                if (sender != NULL) {
+                    pubsub_localTopicSender_connectTo(sender, NULL);
+                }
+                hashMapIterator_remove(&iter);
+                pubsub_localTopicReceiver_destroy(receiver);
+                free(key);
+            }
+        }
+        celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+        celixThreadMutex_unlock(&psa->topicSenders.mutex);
+
+        free(entry);
+    }
+}
+
+celix_status_t pubsub_localAdmin_matchPublisher(void *handle, long svcRequesterBndId, const celix_filter_t *svcFilter, celix_properties_t **topicProperties, double *outScore, long *outSerializerSvcId, long *outProtocolSvcId) {
+    pubsub_local_admin_t *psa = handle;
+    L_DEBUG("[PSA_LOCAL] pubsub_localAdmin_matchPublisher");
+    celix_status_t  status = CELIX_SUCCESS;
+    double score = pubsubEndpoint_matchPublisher(psa->ctx, svcRequesterBndId, svcFilter->filterStr, PUBSUB_LOCAL_ADMIN_TYPE,
+                                                 psa->qosSampleScore, psa->qosControlScore, psa->defaultScore,
+                                                 false, topicProperties, outSerializerSvcId, outProtocolSvcId);
+    *outScore = score;
+
+    return status;
+}
+
+celix_status_t pubsub_localAdmin_matchSubscriber(void *handle, long svcProviderBndId, const celix_properties_t *svcProperties, celix_properties_t **topicProperties, double *outScore, long *outSerializerSvcId, long *outProtocolSvcId) {
+    pubsub_local_admin_t *psa = handle;
+    L_DEBUG("[PSA_LOCAL] pubsub_localAdmin_matchSubscriber");
+    celix_status_t  status = CELIX_SUCCESS;
+    double score = pubsubEndpoint_matchSubscriber(psa->ctx, svcProviderBndId, svcProperties, PUBSUB_LOCAL_ADMIN_TYPE,
+                                                  psa->qosSampleScore, psa->qosControlScore, psa->defaultScore,
+                                                  false, topicProperties, outSerializerSvcId, outProtocolSvcId);
+    if (outScore != NULL) {
+        *outScore = score;
+    }
+    return status;
+}
+
+celix_status_t pubsub_localAdmin_matchDiscoveredEndpoint(void *handle, const celix_properties_t *endpoint, bool *outMatch) {
+    pubsub_local_admin_t *psa = handle;
+    L_DEBUG("[PSA_LOCAL] pubsub_localAdmin_matchEndpoint");
+    celix_status_t  status = CELIX_SUCCESS;
+    bool match = pubsubEndpoint_match(psa->ctx, endpoint, PUBSUB_LOCAL_ADMIN_TYPE, false, NULL, NULL);
+    if (match) {
+        //only endpoints from this framework can be served by the local PSA
+        const char *fwUUID = celix_properties_get(endpoint, PUBSUB_ENDPOINT_FRAMEWORK_UUID, NULL);
+        match = fwUUID != NULL && psa->fwUUID != NULL && strcmp(fwUUID, psa->fwUUID) == 0;
+    }
+    if (outMatch != NULL) {
+        *outMatch = match;
+    }
+    return status;
+}
+
+static celix_properties_t* pubsub_localAdmin_createEndpoint(pubsub_local_admin_t *psa, const char *scope, const char *topic, const char *endpointType, const char *serType) {
+    celix_properties_t *endpoint = pubsubEndpoint_create(psa->fwUUID, scope, topic, endpointType, PUBSUB_LOCAL_ADMIN_TYPE,
+                                                         serType, NULL, NULL);
+
+    //Set endpoint visibility to local, publishers and subscribers are only connected within this framework
+    celix_properties_set(endpoint, PUBSUB_ENDPOINT_VISIBILITY, PUBSUB_ENDPOINT_LOCAL_VISIBILITY);
+
+    //if available also set container name
+    const char *cn = celix_bundleContext_getProperty(psa->ctx, "CELIX_CONTAINER_NAME", NULL);
+    if (cn != NULL) {
+        celix_properties_set(endpoint, "container_name", cn);
+    }
+    return endpoint;
+}
+
+celix_status_t pubsub_localAdmin_setupTopicSender(void *handle, const char *scope, const char *topic, const celix_properties_t *topicProperties __attribute__((unused)), long serializerSvcId, long protocolSvcId __attribute__((unused)), celix_properties_t **outPublisherEndpoint) {
+    pubsub_local_admin_t *psa = handle;
+    celix_status_t  status = CELIX_SUCCESS;
+
+    //1) Create TopicSender
+    //2) Store TopicSender
+    //3) Connect to the TopicReceiver for the same scope/topic, if present
+    //4) set outPublisherEndpoint
+
+    celix_properties_t *newEndpoint = NULL;
+
+    char *key = pubsubEndpoint_createScopeTopicKey(scope, topic);
+
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    pubsub_local_topic_sender_t *sender = hashMap_get(psa->topicSenders.map, key);
+    if (sender == NULL) {
+        psa_local_serializer_entry_t *serEntry = hashMap_get(psa->serializers.map, (void*)serializerSvcId);
+        if (serEntry != NULL) {
+            sender = pubsub_localTopicSender_create(psa->ctx, psa->log, scope, topic, serializerSvcId, serEntry->svc);
+        }
+        if (sender != NULL) {
+            newEndpoint = pubsub_localAdmin_createEndpoint(psa, scope, topic, PUBSUB_PUBLISHER_ENDPOINT_TYPE, serEntry->serType);
+
+            celixThreadMutex_lock(&psa->topicReceivers.mutex);
+            pubsub_local_topic_receiver_t *receiver = hashMap_get(psa->topicReceivers.map, key);
+            if (receiver != NULL) {
+                pubsub_localTopicSender_connectTo(sender, receiver);
+            }
+            celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+
+            hashMap_put(psa->topicSenders.map, key, sender);
+        } else {
+            L_ERROR("[PSA_LOCAL] Error creating a TopicSender");
+            free(key);
+        }
+    } else {
+        free(key);
+        L_ERROR("[PSA_LOCAL] Cannot setup already existing TopicSender for scope/topic %s/%s!", scope == NULL ? "(null)" : scope, topic);
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+
+    if (newEndpoint != NULL && outPublisherEndpoint != NULL) {
+        *outPublisherEndpoint = newEndpoint;
+    }
+
+    return status;
+}
+
+celix_status_t pubsub_localAdmin_teardownTopicSender(void *handle, const char *scope, const char *topic) {
+    pubsub_local_admin_t *psa = handle;
+    celix_status_t  status = CELIX_SUCCESS;
+
+    //1) Find and remove TopicSender from map
+    //2) destroy topic sender
+
+    char *key = pubsubEndpoint_createScopeTopicKey(scope, topic);
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    hash_map_entry_t *entry = hashMap_getEntry(psa->topicSenders.map, key);
+    if (entry != NULL) {
+        char *mapKey = hashMapEntry_getKey(entry);
+        pubsub_local_topic_sender_t *sender = hashMap_remove(psa->topicSenders.map, key);
+        free(mapKey);
+        pubsub_localTopicSender_destroy(sender);
+    } else {
+        L_ERROR("[PSA_LOCAL] Cannot teardown TopicSender with scope/topic %s/%s. Does not exists", scope == NULL ? "(null)" : scope, topic);
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+    free(key);
+
+    return status;
+}
+
+celix_status_t pubsub_localAdmin_setupTopicReceiver(void *handle, const char *scope, const char *topic, const celix_properties_t *topicProperties __attribute__((unused)), long serializerSvcId, long protocolSvcId __attribute__((unused)), celix_properties_t **outSubscriberEndpoint) {
+    pubsub_local_admin_t *psa = handle;
+
+    celix_properties_t *newEndpoint = NULL;
+
+    char *key = pubsubEndpoint_createScopeTopicKey(scope, topic);
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    pubsub_local_topic_receiver_t *receiver = hashMap_get(psa->topicReceivers.map, key);
+    if (receiver == NULL) {
+        psa_local_serializer_entry_t *serEntry = hashMap_get(psa->serializers.map, (void*)serializerSvcId);
+        if (serEntry != NULL) {
+            receiver = pubsub_localTopicReceiver_create(psa->ctx, psa->log, scope, topic, serializerSvcId, serEntry->svc);
+        } else {
+            L_ERROR("[PSA_LOCAL] Cannot find serializer for TopicReceiver %s/%s", scope == NULL ? "(null)" : scope, topic);
+        }
+        if (receiver != NULL) {
+            newEndpoint = pubsub_localAdmin_createEndpoint(psa, scope, topic, PUBSUB_SUBSCRIBER_ENDPOINT_TYPE, serEntry->serType);
+
+            pubsub_local_topic_sender_t *sender = hashMap_get(psa->topicSenders.map, key);
+            if (sender != NULL) {
+                pubsub_localTopicSender_connectTo(sender, receiver);
+            }
+
+            hashMap_put(psa->topicReceivers.map, key, receiver);
+        } else {
+            L_ERROR("[PSA_LOCAL] Error creating a TopicReceiver.");
+            free(key);
+        }
+    } else {
+        free(key);
+        L_ERROR("[PSA_LOCAL] Cannot setup already existing TopicReceiver for scope/topic %s/%s!", scope == NULL ? "(null)" : scope, topic);
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+
+    if (newEndpoint != NULL && outSubscriberEndpoint != NULL) {
+        *outSubscriberEndpoint = newEndpoint;
+    }
+
+    celix_status_t status = CELIX_SUCCESS;
+    return status;
+}
+
+celix_status_t pubsub_localAdmin_teardownTopicReceiver(void *handle, const char *scope, const char *topic) {
+    pubsub_local_admin_t *psa = handle;
+
+    char *key = pubsubEndpoint_createScopeTopicKey(scope, topic);
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    hash_map_entry_t *entry = hashMap_getEntry(psa->topicReceivers.map, key);
+    if (entry != NULL) {
+        char *receiverKey = hashMapEntry_getKey(entry);
+        pubsub_local_topic_receiver_t *receiver = hashMapEntry_getValue(entry);
+        hashMap_remove(psa->topicReceivers.map, receiverKey);
+
+        //ensure the sender no longer delivers to the receiver before destroying it
+        pubsub_local_topic_sender_t *sender = hashMap_get(psa->topicSenders.map, key);
+        if (sender != NULL) {
+            pubsub_localTopicSender_connectTo(sender, NULL);
+        }
+
+        free(receiverKey);
+        pubsub_localTopicReceiver_destroy(receiver);
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+    free(key);
+
+    celix_status_t  status = CELIX_SUCCESS;
+    return status;
+}
+
+celix_status_t pubsub_localAdmin_addDiscoveredEndpoint(void *handle __attribute__((unused)), const celix_properties_t *endpoint __attribute__((unused))) {
+    //nop, topic senders are directly connected to the topic receivers of the same scope/topic
+    return CELIX_SUCCESS;
+}
+
+celix_status_t pubsub_localAdmin_removeDiscoveredEndpoint(void *handle __attribute__((unused)), const celix_properties_t *endpoint __attribute__((unused))) {
+    //nop, see pubsub_localAdmin_addDiscoveredEndpoint
+    return CELIX_SUCCESS;
+}
+
+bool pubsub_localAdmin_executeCommand(void *handle, const char *commandLine __attribute__((unused)), FILE *out, FILE *errStream __attribute__((unused))) {
+    pubsub_local_admin_t *psa = handle;
+
+    fprintf(out, "\n");
+    fprintf(out, "Topic Senders:\n");
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(psa->topicSenders.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_local_topic_sender_t *sender = hashMapIterator_nextValue(&iter);
+        long serSvcId = pubsub_localTopicSender_serializerSvcId(sender);
+        psa_local_serializer_entry_t *serEntry = hashMap_get(psa->serializers.map, (void*)serSvcId);
+        const char *serType = serEntry == NULL ? "!Error!" : serEntry->serType;
+        const char *scope = pubsub_localTopicSender_scope(sender);
+        const char *topic = pubsub_localTopicSender_topic(sender);
+        fprintf(out, "|- Topic Sender %s/%s\n", scope == NULL ? "(null)" : scope, topic);
+        fprintf(out, "   |- serializer type = %s\n", serType);
+        fprintf(out, "   |- connected       = %s\n", pubsub_localTopicSender_isConnected(sender) ? "true" : "false");
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+
+    fprintf(out, "\n");
+    fprintf(out, "\nTopic Receivers:\n");
+    celixThreadMutex_lock(&psa->serializers.mutex);
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    iter = hashMapIterator_construct(psa->topicReceivers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_local_topic_receiver_t *receiver = hashMapIterator_nextValue(&iter);
+        long serSvcId = pubsub_localTopicReceiver_serializerSvcId(receiver);
+        psa_local_serializer_entry_t *serEntry = hashMap_get(psa->serializers.map, (void*)serSvcId);
+        const char *serType = serEntry == NULL ? "!Error!" : serEntry->serType;
+        const char *scope = pubsub_localTopicReceiver_scope(receiver);
+        const char *topic = pubsub_localTopicReceiver_topic(receiver);
+        fprintf(out, "|- Topic Receiver %s/%s\n", scope == NULL ? "(null)" : scope, topic);
+        fprintf(out, "   |- serializer type      = %s\n", serType);
+        fprintf(out, "   |- nr of subscribers    = %zu\n", pubsub_localTopicReceiver_nrOfSubscribers(receiver));
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+    celixThreadMutex_unlock(&psa->serializers.mutex);
+    fprintf(out, "\n");
+
+    return true;
+}
+
+pubsub_admin_metrics_t* pubsub_localAdmin_metrics(void *handle) {
+    pubsub_local_admin_t *psa = handle;
+    pubsub_admin_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->psaType, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", PUBSUB_LOCAL_ADMIN_TYPE);
+    result->senders = celix_arrayList_create();
+    result->receivers = celix_arrayList_create();
+
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(psa->topicSenders.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_local_topic_sender_t *sender = hashMapIterator_nextValue(&iter);
+        pubsub_admin_sender_metrics_t *metrics = pubsub_localTopicSender_metrics(sender);
+        if (metrics != NULL) {
+            celix_arrayList_add(result->senders, metrics);
+        }
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    iter = hashMapIterator_construct(psa->topicReceivers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_local_topic_receiver_t *receiver = hashMapIterator_nextValue(&iter);
+        pubsub_admin_receiver_metrics_t *metrics = pubsub_localTopicReceiver_metrics(receiver);
+        if (metrics != NULL) {
+            celix_arrayList_add(result->receivers, metrics);
+        }
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+
+    return result;
+}
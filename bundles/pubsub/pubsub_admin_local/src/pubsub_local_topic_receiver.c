@@ -0,0 +1,396 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pubsub/subscriber.h>
+#include <pubsub_constants.h>
+#include <pubsub_endpoint.h>
+#include <celix_log_helper.h>
+#include <celix_api.h>
+#include "pubsub_local_topic_receiver.h"
+#include "pubsub_psa_local_constants.h"
+
+#define L_DEBUG(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define L_INFO(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_INFO, __VA_ARGS__)
+#define L_WARN(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define L_ERROR(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+struct pubsub_local_topic_receiver {
+    celix_bundle_context_t *ctx;
+    celix_log_helper_t *logHelper;
+    long serializerSvcId;
+    pubsub_serializer_service_t *serializer;
+    char *scope;
+    char *topic;
+    const char *fwUUID;
+    pubsub_admin_metrics_receive_counters_t *metrics; //NULL if metrics are disabled
+
+    long subscriberTrackerId;
+    struct {
+        celix_thread_rwlock_t lock; //read locked during delivery, so concurrent publishers do not block each other
+        hash_map_t *map; //key = bnd id, value = psa_local_subscriber_entry_t
+    } subscribers;
+};
+
+typedef struct psa_local_subscriber_entry {
+    hash_map_t *msgTypes; //key = msg type id, value = pubsub_msg_serializer_t
+    hash_map_t *subscriberServices; //key = servide id, value = psa_local_subscriber_t*
+} psa_local_subscriber_entry_t;
+
+typedef struct psa_local_subscriber {
+    pubsub_subscriber_t *svc;
+    bool copyMsgs; //atomic, if true the subscriber gets its own copy of every msg instead of borrowing the publisher msg
+} psa_local_subscriber_t;
+
+/**
+ * A msg serialized with the publisher msg serializer. Only serialized (once) if a subscriber needs a copy of the msg.
+ */
+typedef struct psa_local_serialized_msg {
+    bool serialized;
+    struct iovec *iov;
+    size_t iovLen;
+    bool failed; //serialization or deserialization failed for a subscriber
+    bool timed; //the deserialization time of the first copy is measured (only if metrics are enabled)
+    struct timespec deserializeStart;
+    struct timespec deserializeEnd;
+} psa_local_serialized_msg_t;
+
+static void psa_local_destroySubscriberServices(hash_map_t *subscriberServices) {
+    hash_map_iterator_t iter = hashMapIterator_construct(subscriberServices);
+    while (hashMapIterator_hasNext(&iter)) {
+        free(hashMapIterator_nextValue(&iter));
+    }
+    hashMap_destroy(subscriberServices, false, false);
+}
+
+static void pubsub_localTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
+static void pubsub_localTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
+
+pubsub_local_topic_receiver_t* pubsub_localTopicReceiver_create(celix_bundle_context_t *ctx,
+                                                                 celix_log_helper_t *logHelper,
+                                                                 const char *scope,
+                                                                 const char *topic,
+                                                                 long serializerSvcId,
+                                                                 pubsub_serializer_service_t *serializer) {
+    pubsub_local_topic_receiver_t *receiver = calloc(1, sizeof(*receiver));
+    receiver->ctx = ctx;
+    receiver->logHelper = logHelper;
+    receiver->serializerSvcId = serializerSvcId;
+    receiver->serializer = serializer;
+    receiver->scope = scope == NULL ? NULL : strndup(scope, 1024 * 1024);
+    receiver->topic = strndup(topic, 1024 * 1024);
+    receiver->fwUUID = celix_bundleContext_getProperty(ctx, OSGI_FRAMEWORK_FRAMEWORK_UUID, NULL);
+    if (celix_bundleContext_getPropertyAsBool(ctx, PSA_LOCAL_METRICS_ENABLED, PSA_LOCAL_DEFAULT_METRICS_ENABLED)) {
+        receiver->metrics = pubsub_metricsReceiveCounters_create();
+    }
+
+    celixThreadRwlock_create(&receiver->subscribers.lock, NULL);
+    receiver->subscribers.map = hashMap_create(NULL, NULL, NULL, NULL);
+
+    //track subscribers
+    int size = snprintf(NULL, 0, "(%s=%s)", PUBSUB_SUBSCRIBER_TOPIC, topic);
+    char buf[size+1];
+    snprintf(buf, (size_t)size+1, "(%s=%s)", PUBSUB_SUBSCRIBER_TOPIC, topic);
+    celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
+    opts.filter.ignoreServiceLanguage = true;
+    opts.filter.serviceName = PUBSUB_SUBSCRIBER_SERVICE_NAME;
+    opts.filter.filter = buf;
+    opts.callbackHandle = receiver;
+    opts.addWithOwner = pubsub_localTopicReceiver_addSubscriber;
+    opts.removeWithOwner = pubsub_localTopicReceiver_removeSubscriber;
+    receiver->subscriberTrackerId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+
+    return receiver;
+}
+
+void pubsub_localTopicReceiver_destroy(pubsub_local_topic_receiver_t *receiver) {
+    if (receiver != NULL) {
+        celix_bundleContext_stopTracker(receiver->ctx, receiver->subscriberTrackerId);
+
+        celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+        hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_local_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (entry != NULL)  {
+                receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
+                psa_local_destroySubscriberServices(entry->subscriberServices);
+                free(entry);
+            }
+        }
+        hashMap_destroy(receiver->subscribers.map, false, false);
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
+
+        celixThreadRwlock_destroy(&receiver->subscribers.lock);
+        pubsub_metricsReceiveCounters_destroy(receiver->metrics);
+        free(receiver->scope);
+        free(receiver->topic);
+    }
+    free(receiver);
+}
+
+const char* pubsub_localTopicReceiver_scope(pubsub_local_topic_receiver_t *receiver) {
+    return receiver->scope;
+}
+
+const char* pubsub_localTopicReceiver_topic(pubsub_local_topic_receiver_t *receiver) {
+    return receiver->topic;
+}
+
+long pubsub_localTopicReceiver_serializerSvcId(pubsub_local_topic_receiver_t *receiver) {
+    return receiver->serializerSvcId;
+}
+
+size_t pubsub_localTopicReceiver_nrOfSubscribers(pubsub_local_topic_receiver_t *receiver) {
+    size_t count = 0;
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
+    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_local_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+        count += (size_t)hashMap_size(entry->subscriberServices);
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+    return count;
+}
+
+static void pubsub_localTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *bnd) {
+    pubsub_local_topic_receiver_t *receiver = handle;
+
+    long bndId = celix_bundle_getId(bnd);
+    long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    const char *subScope = celix_properties_get(props, PUBSUB_SUBSCRIBER_SCOPE, NULL);
+    if (receiver->scope == NULL){
+        if (subScope != NULL){
+            return;
+        }
+    } else if (subScope != NULL) {
+        if (strncmp(subScope, receiver->scope, strlen(receiver->scope)) != 0) {
+            //not the same scope. ignore
+            return;
+        }
+    } else {
+        //receiver scope is not NULL, but subScope is NULL -> ignore
+        return;
+    }
+
+    //note there is no receive thread, so the subscriber is initialized before it is used for delivery.
+    pubsub_subscriber_t *subSvc = svc;
+    if (subSvc->init != NULL) {
+        int rc = subSvc->init(subSvc->handle);
+        if (rc != 0) {
+            L_WARN("[PSA_LOCAL] Cannot initialize subscriber svc. Got rc %i", rc);
+        }
+    }
+
+    psa_local_subscriber_t *sub = calloc(1, sizeof(*sub));
+    if (sub == NULL) {
+        L_ERROR("[PSA_LOCAL] Cannot allocate subscriber for TopicReceiver %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        return;
+    }
+    sub->svc = subSvc;
+    sub->copyMsgs = celix_properties_getAsBool(props, PUBSUB_LOCAL_SUBSCRIBER_COPY_MSGS, PUBSUB_LOCAL_SUBSCRIBER_COPY_MSGS_DEFAULT);
+
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+    psa_local_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void*)bndId);
+    if (entry != NULL) {
+        hashMap_put(entry->subscriberServices, (void*)svcId, sub);
+    } else {
+        //new create entry
+        entry = calloc(1, sizeof(*entry));
+        entry->subscriberServices = hashMap_create(NULL, NULL, NULL, NULL);
+        hashMap_put(entry->subscriberServices, (void*)svcId, sub);
+
+        int rc = receiver->serializer->createSerializerMap(receiver->serializer->handle, (celix_bundle_t*)bnd, &entry->msgTypes);
+
+        if (rc == 0) {
+            hashMap_put(receiver->subscribers.map, (void*)bndId, entry);
+        } else {
+            L_ERROR("[PSA_LOCAL] Cannot create msg serializer map for TopicReceiver %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+            psa_local_destroySubscriberServices(entry->subscriberServices);
+            free(entry);
+        }
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+}
+
+static void pubsub_localTopicReceiver_removeSubscriber(void *handle, void *svc __attribute__((unused)), const celix_properties_t *props, const celix_bundle_t *bnd) {
+    pubsub_local_topic_receiver_t *receiver = handle;
+
+    long bndId = celix_bundle_getId(bnd);
+    long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+    psa_local_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void*)bndId);
+    if (entry != NULL) {
+        free(hashMap_remove(entry->subscriberServices, (void*)svcId));
+    }
+    if (entry != NULL && hashMap_size(entry->subscriberServices) == 0) {
+        //remove entry
+        hashMap_remove(receiver->subscribers.map, (void*)bndId);
+        int rc = receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
+        if (rc != 0) {
+            L_ERROR("[PSA_LOCAL] Cannot destroy msg serializers map for TopicReceiver %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        }
+        psa_local_destroySubscriberServices(entry->subscriberServices);
+        free(entry);
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+}
+
+static bool psa_local_checkVersion(const pubsub_msg_serializer_t *subscriberMsgSer, const pubsub_msg_serializer_t *publisherMsgSer) {
+    if (subscriberMsgSer->msgVersion == NULL || publisherMsgSer->msgVersion == NULL) {
+        //no check
+        return true;
+    }
+    int subMajor = 0, subMinor = 0, pubMajor = 0, pubMinor = 0;
+    version_getMajor(subscriberMsgSer->msgVersion, &subMajor);
+    version_getMinor(subscriberMsgSer->msgVersion, &subMinor);
+    version_getMajor(publisherMsgSer->msgVersion, &pubMajor);
+    version_getMinor(publisherMsgSer->msgVersion, &pubMinor);
+    //Different major means incompatible, compatible only if the publisher has a minor equals or greater
+    return subMajor == pubMajor && pubMinor >= subMinor;
+}
+
+/**
+ * Returns whether the publisher msg can be handed over as-is (zero copy) to subscribers using the subscriber msg
+ * serializer. This is only the case for identical msg versions; a compatible, but different version can have a
+ * different memory layout.
+ */
+static bool psa_local_isSameVersion(const pubsub_msg_serializer_t *subscriberMsgSer, const pubsub_msg_serializer_t *publisherMsgSer) {
+    if (subscriberMsgSer->msgVersion == NULL || publisherMsgSer->msgVersion == NULL) {
+        return subscriberMsgSer->msgVersion == publisherMsgSer->msgVersion;
+    }
+    int cmp = -1;
+    version_compareTo(subscriberMsgSer->msgVersion, publisherMsgSer->msgVersion, &cmp);
+    return cmp == 0;
+}
+
+/**
+ * Delivers a copy of the msg, owned by the subscriber, by deserializing the serialized publisher msg with the
+ * subscriber msg serializer. The msg is serialized on first use.
+ */
+static void psa_local_deliverCopy(pubsub_local_topic_receiver_t *receiver, psa_local_subscriber_t *sub, const pubsub_msg_serializer_t *subMsgSer,
+                                  const pubsub_msg_serializer_t *msgSer, const void *msg, psa_local_serialized_msg_t *serMsg, const celix_properties_t *metadata) {
+    if (!serMsg->serialized) {
+        celix_status_t status = msgSer->serialize(msgSer->handle, msg, &serMsg->iov, &serMsg->iovLen);
+        if (status != CELIX_SUCCESS) {
+            L_WARN("[PSA_LOCAL_TR] Cannot serialize msg of type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+            serMsg->failed = true;
+            return;
+        }
+        serMsg->serialized = true;
+    }
+    bool timed = receiver->metrics != NULL && !serMsg->timed;
+    if (timed) {
+        clock_gettime(CLOCK_REALTIME, &serMsg->deserializeStart);
+    }
+    void *copy = NULL;
+    celix_status_t status = subMsgSer->deserialize(subMsgSer->handle, serMsg->iov, serMsg->iovLen, &copy);
+    if (timed) {
+        clock_gettime(CLOCK_REALTIME, &serMsg->deserializeEnd);
+        serMsg->timed = true;
+    }
+    if (status != CELIX_SUCCESS) {
+        serMsg->failed = true;
+        L_WARN("[PSA_LOCAL_TR] Cannot deserialize msg of type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        return;
+    }
+    bool release = true;
+    sub->svc->receive(sub->svc->handle, subMsgSer->msgName, subMsgSer->msgId, copy, metadata, &release);
+    if (release) {
+        subMsgSer->freeDeserializeMsg(subMsgSer->handle, copy);
+    }
+}
+
+int pubsub_localTopicReceiver_deliver(pubsub_local_topic_receiver_t *receiver, const pubsub_msg_serializer_t *msgSer, const void *msg, const celix_properties_t *metadata) {
+    int count = 0;
+    psa_local_serialized_msg_t serMsg;
+    memset(&serMsg, 0, sizeof(serMsg));
+    struct timespec receiveTime;
+    if (receiver->metrics != NULL) {
+        clock_gettime(CLOCK_REALTIME, &receiveTime);
+    }
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
+    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_local_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+        pubsub_msg_serializer_t *subMsgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)msgSer->msgId);
+        if (subMsgSer == NULL || strcmp(subMsgSer->msgName, msgSer->msgName) != 0) {
+            L_WARN("[PSA_LOCAL_TR] Cannot find msg type for type id 0x%X, fqn %s", msgSer->msgId, msgSer->msgName);
+            continue;
+        }
+        if (!psa_local_checkVersion(subMsgSer, msgSer)) {
+            L_WARN("[PSA_LOCAL_TR] Incompatible version for msg type %s on scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+            continue;
+        }
+        bool zeroCopy = psa_local_isSameVersion(subMsgSer, msgSer);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(entry->subscriberServices);
+        while (hashMapIterator_hasNext(&iter2)) {
+            psa_local_subscriber_t *sub = hashMapIterator_nextValue(&iter2);
+            if (!zeroCopy || __atomic_load_n(&sub->copyMsgs, __ATOMIC_RELAXED)) {
+                psa_local_deliverCopy(receiver, sub, subMsgSer, msgSer, msg, &serMsg, metadata);
+                ++count;
+                continue;
+            }
+            bool release = true;
+            //note the msg is borrowed: shared between all subscribers and stays owned by the publisher.
+            sub->svc->receive(sub->svc->handle, subMsgSer->msgName, subMsgSer->msgId, (void*)msg, metadata, &release);
+            if (!release) {
+                //the subscriber keeps a msg it does not own; from now on the subscriber gets its own copies
+                L_ERROR("[PSA_LOCAL_TR] Subscriber for scope/topic %s/%s tried to take ownership of a borrowed msg of type %s. "
+                        "Subsequent msgs are copied for this subscriber; set the subscriber service property %s=true to receive owned copies.",
+                        receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic, msgSer->msgName, PUBSUB_LOCAL_SUBSCRIBER_COPY_MSGS);
+                __atomic_store_n(&sub->copyMsgs, true, __ATOMIC_RELAXED);
+            }
+            ++count;
+        }
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+    if (serMsg.serialized) {
+        msgSer->freeSerializeMsg(msgSer->handle, serMsg.iov, serMsg.iovLen);
+    }
+    if (receiver->metrics != NULL) {
+        //note delivered within the framework, so the origin is the local framework and the delay is not measured
+        pubsub_metricsReceiveCounters_update(receiver->metrics, msgSer->msgId, msgSer->msgName, receiver->fwUUID, 0, NULL,
+                                             &receiveTime, serMsg.timed ? &serMsg.deserializeStart : NULL, serMsg.timed ? &serMsg.deserializeEnd : NULL,
+                                             serMsg.failed ? 0 : 1, serMsg.failed ? 1 : 0);
+    }
+    return count;
+}
+
+pubsub_admin_receiver_metrics_t* pubsub_localTopicReceiver_metrics(pubsub_local_topic_receiver_t *receiver) {
+    if (receiver->metrics == NULL) {
+        return NULL;
+    }
+    pubsub_admin_receiver_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : receiver->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
+    pubsub_metricsReceiveCounters_fill(receiver->metrics, result);
+    return result;
+}
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_LOCAL_TOPIC_RECEIVER_H
+#define CELIX_PUBSUB_LOCAL_TOPIC_RECEIVER_H
+
+#include "celix_bundle_context.h"
+#include "celix_log_helper.h"
+#include "pubsub_serializer.h"
+#include "pubsub_admin_metrics.h"
+
+typedef struct pubsub_local_topic_receiver pubsub_local_topic_receiver_t;
+
+pubsub_local_topic_receiver_t* pubsub_localTopicReceiver_create(celix_bundle_context_t *ctx,
+        celix_log_helper_t *logHelper,
+        const char *scope,
+        const char *topic,
+        long serializerSvcId,
+        pubsub_serializer_service_t *serializer);
+void pubsub_localTopicReceiver_destroy(pubsub_local_topic_receiver_t *receiver);
+
+const char* pubsub_localTopicReceiver_scope(pubsub_local_topic_receiver_t *receiver);
+const char* pubsub_localTopicReceiver_topic(pubsub_local_topic_receiver_t *receiver);
+
+long pubsub_localTopicReceiver_serializerSvcId(pubsub_local_topic_receiver_t *receiver);
+size_t pubsub_localTopicReceiver_nrOfSubscribers(pubsub_local_topic_receiver_t *receiver);
+
+/**
+ * Delivers a message to all subscribers of the topic receiver, using the calling thread.
+ *
+ * The msg is handed over as-is to the subscriber receive callbacks; it is not copied and remains owned by the
+ * caller (the publisher). The metadata is only borrowed for the duration of the call.
+ *
+ * @return The number of subscriber services the msg is delivered to.
+ */
+int pubsub_localTopicReceiver_deliver(pubsub_local_topic_receiver_t *receiver, const pubsub_msg_serializer_t *msgSer, const void *msg, const celix_properties_t *metadata);
+
+/**
+ * Returns the receive metrics per msg type or NULL if metrics are not enabled.
+ */
+pubsub_admin_receiver_metrics_t* pubsub_localTopicReceiver_metrics(pubsub_local_topic_receiver_t *receiver);
+
+#endif //CELIX_PUBSUB_LOCAL_TOPIC_RECEIVER_H
@@ -0,0 +1,360 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pubsub_constants.h>
+#include <pubsub_endpoint.h>
+#include <pubsub/publisher.h>
+#include <utils.h>
+#include <celix_log_helper.h>
+#include "pubsub_local_topic_sender.h"
+#include "pubsub_psa_local_constants.h"
+#include "celix_constants.h"
+
+#define L_DEBUG(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define L_INFO(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_INFO, __VA_ARGS__)
+#define L_WARN(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define L_ERROR(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+struct pubsub_local_topic_sender {
+    celix_bundle_context_t *ctx;
+    celix_log_helper_t *logHelper;
+    long serializerSvcId;
+    pubsub_serializer_service_t *serializer;
+
+    char *scope;
+    char *topic;
+    bool metricsEnabled;
+
+    struct {
+        long svcId;
+        celix_service_factory_t factory;
+    } publisher;
+
+    struct {
+        celix_thread_rwlock_t lock; //write locked when (dis)connecting, read locked during send
+        pubsub_local_topic_receiver_t *receiver; //receiver for the same scope/topic, can be NULL
+    } connectedReceiver;
+
+    struct {
+        celix_thread_mutex_t mutex;
+        hash_map_t *map;  //key = bndId, value = psa_local_bounded_service_entry_t
+    } boundedServices;
+};
+
+typedef struct psa_local_bounded_service_entry {
+    pubsub_local_topic_sender_t *parent;
+    pubsub_publisher_t service;
+    long bndId;
+    hash_map_t *msgTypes; //key = msg type id, value = pubsub_msg_serializer_t
+    hash_map_t *msgTypeIds; //key = msg name, value = msg type id
+    hash_map_t *msgMetrics; //key = msg type id, value = pubsub_admin_metrics_send_counters_t*, NULL if metrics are disabled
+    int getCount;
+} psa_local_bounded_service_entry_t;
+
+static int psa_local_localMsgTypeIdForMsgType(void* handle, const char* msgType, unsigned int* msgTypeId);
+static void* psa_local_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
+static void psa_local_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
+static void psa_local_destroyBoundedServiceEntry(pubsub_local_topic_sender_t *sender, psa_local_bounded_service_entry_t *entry);
+
+static int psa_local_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *msg, celix_properties_t *metadata);
+static int psa_local_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
+
+pubsub_local_topic_sender_t* pubsub_localTopicSender_create(
+        celix_bundle_context_t *ctx,
+        celix_log_helper_t *logHelper,
+        const char *scope,
+        const char *topic,
+        long serializerSvcId,
+        pubsub_serializer_service_t *ser) {
+    pubsub_local_topic_sender_t *sender = calloc(1, sizeof(*sender));
+    sender->ctx = ctx;
+    sender->logHelper = logHelper;
+    sender->serializerSvcId = serializerSvcId;
+    sender->serializer = ser;
+    sender->scope = scope == NULL ? NULL : strndup(scope, 1024 * 1024);
+    sender->topic = strndup(topic, 1024 * 1024);
+    sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_LOCAL_METRICS_ENABLED, PSA_LOCAL_DEFAULT_METRICS_ENABLED);
+
+    celixThreadRwlock_create(&sender->connectedReceiver.lock, NULL);
+    celixThreadMutex_create(&sender->boundedServices.mutex, NULL);
+    sender->boundedServices.map = hashMap_create(NULL, NULL, NULL, NULL);
+
+    //register publisher services using a service factory
+    sender->publisher.factory.handle = sender;
+    sender->publisher.factory.getService = psa_local_getPublisherService;
+    sender->publisher.factory.ungetService = psa_local_ungetPublisherService;
+
+    celix_properties_t *props = celix_properties_create();
+    celix_properties_set(props, PUBSUB_PUBLISHER_TOPIC, sender->topic);
+    if (sender->scope != NULL) {
+        celix_properties_set(props, PUBSUB_PUBLISHER_SCOPE, sender->scope);
+    }
+
+    celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+    opts.factory = &sender->publisher.factory;
+    opts.serviceName = PUBSUB_PUBLISHER_SERVICE_NAME;
+    opts.serviceVersion = PUBSUB_PUBLISHER_SERVICE_VERSION;
+    opts.properties = props;
+
+    sender->publisher.svcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+
+    if (sender->publisher.svcId < 0) {
+        L_ERROR("[PSA_LOCAL] Cannot register publisher service for TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+        hashMap_destroy(sender->boundedServices.map, false, false);
+        celixThreadMutex_destroy(&sender->boundedServices.mutex);
+        celixThreadRwlock_destroy(&sender->connectedReceiver.lock);
+        free(sender->scope);
+        free(sender->topic);
+        free(sender);
+        sender = NULL;
+    }
+
+    return sender;
+}
+
+void pubsub_localTopicSender_destroy(pubsub_local_topic_sender_t *sender) {
+    if (sender != NULL) {
+        celix_bundleContext_unregisterService(sender->ctx, sender->publisher.svcId);
+
+        celixThreadMutex_lock(&sender->boundedServices.mutex);
+        hash_map_iterator_t iter = hashMapIterator_construct(sender->boundedServices.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_local_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (entry != NULL) {
+                psa_local_destroyBoundedServiceEntry(sender, entry);
+            }
+        }
+        hashMap_destroy(sender->boundedServices.map, false, false);
+        celixThreadMutex_unlock(&sender->boundedServices.mutex);
+
+        celixThreadMutex_destroy(&sender->boundedServices.mutex);
+        celixThreadRwlock_destroy(&sender->connectedReceiver.lock);
+
+        free(sender->scope);
+        free(sender->topic);
+        free(sender);
+    }
+}
+
+long pubsub_localTopicSender_serializerSvcId(pubsub_local_topic_sender_t *sender) {
+    return sender->serializerSvcId;
+}
+
+const char* pubsub_localTopicSender_scope(pubsub_local_topic_sender_t *sender) {
+    return sender->scope;
+}
+
+const char* pubsub_localTopicSender_topic(pubsub_local_topic_sender_t *sender) {
+    return sender->topic;
+}
+
+void pubsub_localTopicSender_connectTo(pubsub_local_topic_sender_t *sender, pubsub_local_topic_receiver_t *receiver) {
+    celixThreadRwlock_writeLock(&sender->connectedReceiver.lock);
+    sender->connectedReceiver.receiver = receiver;
+    celixThreadRwlock_unlock(&sender->connectedReceiver.lock);
+}
+
+bool pubsub_localTopicSender_isConnected(pubsub_local_topic_sender_t *sender) {
+    celixThreadRwlock_readLock(&sender->connectedReceiver.lock);
+    bool connected = sender->connectedReceiver.receiver != NULL;
+    celixThreadRwlock_unlock(&sender->connectedReceiver.lock);
+    return connected;
+}
+
+static int psa_local_localMsgTypeIdForMsgType(void* handle, const char* msgType, unsigned int* msgTypeId) {
+    psa_local_bounded_service_entry_t *entry = (psa_local_bounded_service_entry_t *) handle;
+    *msgTypeId = (unsigned int)(uintptr_t) hashMap_get(entry->msgTypeIds, msgType);
+    return 0;
+}
+
+static void* psa_local_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties __attribute__((unused))) {
+    pubsub_local_topic_sender_t *sender = handle;
+    long bndId = celix_bundle_getId(requestingBundle);
+    void *svc = NULL;
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    psa_local_bounded_service_entry_t *entry = hashMap_get(sender->boundedServices.map, (void*)bndId);
+    if (entry != NULL) {
+        entry->getCount += 1;
+        svc = &entry->service;
+    } else {
+        entry = calloc(1, sizeof(*entry));
+        entry->getCount = 1;
+        entry->parent = sender;
+        entry->bndId = bndId;
+        entry->msgTypeIds = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+        int rc = sender->serializer->createSerializerMap(sender->serializer->handle, (celix_bundle_t*)requestingBundle, &entry->msgTypes);
+        if (rc == 0) {
+            hash_map_iterator_t iter = hashMapIterator_construct(entry->msgTypes);
+            if (sender->metricsEnabled) {
+                entry->msgMetrics = hashMap_create(NULL, NULL, NULL, NULL);
+            }
+            while (hashMapIterator_hasNext(&iter)) {
+                pubsub_msg_serializer_t *msgSer = hashMapIterator_nextValue(&iter);
+                hashMap_put(entry->msgTypeIds, strndup(msgSer->msgName, 1024), (void *)(uintptr_t) msgSer->msgId);
+                if (entry->msgMetrics != NULL) {
+                    pubsub_admin_metrics_send_counters_t *counters = malloc(sizeof(*counters));
+                    if (counters != NULL) {
+                        pubsub_metricsSendCounters_init(counters);
+                        hashMap_put(entry->msgMetrics, (void *)(uintptr_t) msgSer->msgId, counters);
+                    }
+                }
+            }
+            entry->service.handle = entry;
+            entry->service.localMsgTypeIdForMsgType = psa_local_localMsgTypeIdForMsgType;
+            entry->service.send = psa_local_topicPublicationSend;
+            entry->service.sendMany = psa_local_topicPublicationSendMany;
+            hashMap_put(sender->boundedServices.map, (void*)bndId, entry);
+            svc = &entry->service;
+        } else {
+            L_ERROR("[PSA_LOCAL] Error creating serializer map for local TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+            hashMap_destroy(entry->msgTypeIds, false, false);
+            free(entry);
+        }
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+
+    return svc;
+}
+
+static void psa_local_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties __attribute__((unused))) {
+    pubsub_local_topic_sender_t *sender = handle;
+    long bndId = celix_bundle_getId(requestingBundle);
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    psa_local_bounded_service_entry_t *entry = hashMap_get(sender->boundedServices.map, (void*)bndId);
+    if (entry != NULL) {
+        entry->getCount -= 1;
+    }
+    if (entry != NULL && entry->getCount == 0) {
+        hashMap_remove(sender->boundedServices.map, (void*)bndId);
+        psa_local_destroyBoundedServiceEntry(sender, entry);
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+}
+
+static void psa_local_destroyBoundedServiceEntry(pubsub_local_topic_sender_t *sender, psa_local_bounded_service_entry_t *entry) {
+    int rc = sender->serializer->destroySerializerMap(sender->serializer->handle, entry->msgTypes);
+    if (rc != 0) {
+        L_ERROR("[PSA_LOCAL] Error destroying publisher service, serializer not available / cannot get msg serializer map");
+    }
+    hashMap_destroy(entry->msgTypeIds, true, false);
+    if (entry->msgMetrics != NULL) {
+        hash_map_iterator_t iter = hashMapIterator_construct(entry->msgMetrics);
+        while (hashMapIterator_hasNext(&iter)) {
+            pubsub_admin_metrics_send_counters_t *counters = hashMapIterator_nextValue(&iter);
+            pubsub_metricsSendCounters_deinit(counters);
+            free(counters);
+        }
+        hashMap_destroy(entry->msgMetrics, false, false);
+    }
+    free(entry);
+}
+
+static int psa_local_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
+    int status = CELIX_SUCCESS;
+    psa_local_bounded_service_entry_t *bound = handle;
+    pubsub_local_topic_sender_t *sender = bound->parent;
+    pubsub_msg_serializer_t *msgSer = hashMap_get(bound->msgTypes, (void*)(uintptr_t)msgTypeId);
+
+    if (msgSer != NULL) {
+        //note no serialization; the msg is handed over to the subscribers before send returns,
+        //so the publisher keeps ownership as documented for pubsub_publisher_t.send.
+        celixThreadRwlock_readLock(&sender->connectedReceiver.lock);
+        if (sender->connectedReceiver.receiver != NULL) {
+            pubsub_localTopicReceiver_deliver(sender->connectedReceiver.receiver, msgSer, inMsg, metadata);
+        }
+        celixThreadRwlock_unlock(&sender->connectedReceiver.lock);
+        pubsub_admin_metrics_send_counters_t *counters = bound->msgMetrics == NULL ? NULL : hashMap_get(bound->msgMetrics, (void*)(uintptr_t)msgTypeId);
+        if (counters != NULL) {
+            struct timespec sendTime;
+            clock_gettime(CLOCK_REALTIME, &sendTime);
+            pubsub_metricsSendCounters_update(counters, NULL, &sendTime, 1, 0, 0);
+        }
+    } else {
+        L_WARN("[PSA_LOCAL_TS] Error sending message with msg type id %i for scope/topic %s/%s", msgTypeId, sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+        status = CELIX_SERVICE_EXCEPTION;
+    }
+
+    if (metadata != NULL) {
+        celix_properties_destroy(metadata);
+    }
+    return status;
+}
+
+static int psa_local_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    int status = CELIX_SUCCESS;
+    for (size_t i = 0; i < nrOfMsgs; ++i) {
+        int rc = psa_local_topicPublicationSend(handle, msgs[i].msgTypeId, msgs[i].msg, msgs[i].metadata);
+        if (status == CELIX_SUCCESS) {
+            status = rc;
+        }
+    }
+    return status;
+}
+
+pubsub_admin_sender_metrics_t* pubsub_localTopicSender_metrics(pubsub_local_topic_sender_t *sender) {
+    if (!sender->metricsEnabled) {
+        return NULL;
+    }
+    pubsub_admin_sender_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : sender->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->topic);
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    unsigned int count = 0;
+    hash_map_iterator_t iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_local_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        count += (unsigned int)hashMap_size(entry->msgMetrics);
+    }
+    result->msgMetrics = calloc(count, sizeof(*result->msgMetrics));
+    unsigned int i = 0;
+    iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter) && result->msgMetrics != NULL) {
+        psa_local_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgMetrics);
+        while (hashMapIterator_hasNext(&iter2)) {
+            hash_map_entry_t *mapEntry = hashMapIterator_nextEntry(&iter2);
+            unsigned int msgTypeId = (unsigned int)(uintptr_t)hashMapEntry_getKey(mapEntry);
+            pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)msgTypeId);
+            pubsub_metricsSendCounters_fill(hashMapEntry_getValue(mapEntry), &result->msgMetrics[i]);
+            result->msgMetrics[i].bndId = entry->bndId;
+            result->msgMetrics[i].typeId = msgTypeId;
+            snprintf(result->msgMetrics[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", msgSer == NULL ? "" : msgSer->msgName);
+            i += 1;
+        }
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+    result->nrOfmsgMetrics = result->msgMetrics == NULL ? 0 : i;
+    return result;
+}
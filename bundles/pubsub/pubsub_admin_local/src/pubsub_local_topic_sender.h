@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_LOCAL_TOPIC_SENDER_H
+#define CELIX_PUBSUB_LOCAL_TOPIC_SENDER_H
+
+#include "celix_bundle_context.h"
+#include "celix_log_helper.h"
+#include "pubsub_serializer.h"
+#include "pubsub_admin_metrics.h"
+#include "pubsub_local_topic_receiver.h"
+
+typedef struct pubsub_local_topic_sender pubsub_local_topic_sender_t;
+
+pubsub_local_topic_sender_t* pubsub_localTopicSender_create(
+        celix_bundle_context_t *ctx,
+        celix_log_helper_t *logHelper,
+        const char *scope,
+        const char *topic,
+        long serializerSvcId,
+        pubsub_serializer_service_t *ser);
+void pubsub_localTopicSender_destroy(pubsub_local_topic_sender_t *sender);
+
+const char* pubsub_localTopicSender_scope(pubsub_local_topic_sender_t *sender);
+const char* pubsub_localTopicSender_topic(pubsub_local_topic_sender_t *sender);
+
+long pubsub_localTopicSender_serializerSvcId(pubsub_local_topic_sender_t *sender);
+
+/**
+ * Connects the topic sender to the topic receiver of the same scope/topic, or disconnects it if receiver is NULL.
+ * Waits for sends in progress, so after this call the previous receiver is no longer used by the sender.
+ */
+void pubsub_localTopicSender_connectTo(pubsub_local_topic_sender_t *sender, pubsub_local_topic_receiver_t *receiver);
+bool pubsub_localTopicSender_isConnected(pubsub_local_topic_sender_t *sender);
+
+/**
+ * Returns the send metrics per msg type/bundle or NULL if metrics are not enabled.
+ */
+pubsub_admin_sender_metrics_t* pubsub_localTopicSender_metrics(pubsub_local_topic_sender_t *sender);
+
+#endif //CELIX_PUBSUB_LOCAL_TOPIC_SENDER_H
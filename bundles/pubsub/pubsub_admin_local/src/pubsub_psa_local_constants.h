@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PUBSUB_PSA_LOCAL_CONSTANTS_H_
+#define PUBSUB_PSA_LOCAL_CONSTANTS_H_
+
+/**
+ * The local PSA only connects publishers and subscribers within the same framework. The default scores are therefore
+ * kept low, so that it is only selected if configured for a topic (i.e. pubsub.config=local in the topic properties)
+ * or if the scores are raised with the config properties below.
+ */
+#define PSA_LOCAL_DEFAULT_QOS_SAMPLE_SCORE            10
+#define PSA_LOCAL_DEFAULT_QOS_CONTROL_SCORE           10
+#define PSA_LOCAL_DEFAULT_SCORE                       10
+
+#define PSA_LOCAL_QOS_SAMPLE_SCORE_KEY                "PSA_LOCAL_QOS_SAMPLE_SCORE"
+#define PSA_LOCAL_QOS_CONTROL_SCORE_KEY               "PSA_LOCAL_QOS_CONTROL_SCORE"
+#define PSA_LOCAL_DEFAULT_SCORE_KEY                   "PSA_LOCAL_DEFAULT_SCORE"
+
+#define PUBSUB_LOCAL_VERBOSE_KEY                      "PSA_LOCAL_VERBOSE"
+#define PUBSUB_LOCAL_VERBOSE_DEFAULT                  false
+
+/**
+ * Collect the send/receive metrics per msg type, provided with the pubsub_admin_metrics service.
+ * Messages are delivered within the framework, so the origin is the local framework and there is no delay.
+ */
+#define PSA_LOCAL_METRICS_ENABLED                     "PSA_LOCAL_METRICS_ENABLED"
+#define PSA_LOCAL_DEFAULT_METRICS_ENABLED             false
+
+#define PUBSUB_LOCAL_ADMIN_TYPE                       "local"
+
+/**
+ * Subscriber service property. Messages delivered by the local PSA are default borrowed: the publisher msg itself is
+ * handed to the subscriber and must be treated as const and not be kept after receive returns.
+ * If set to true the subscriber gets its own (deserialized) copy of every msg and can take ownership of it.
+ */
+#define PUBSUB_LOCAL_SUBSCRIBER_COPY_MSGS             "pubsub.local.copy_msgs"
+#define PUBSUB_LOCAL_SUBSCRIBER_COPY_MSGS_DEFAULT     false
+
+#endif /* PUBSUB_PSA_LOCAL_CONSTANTS_H_ */
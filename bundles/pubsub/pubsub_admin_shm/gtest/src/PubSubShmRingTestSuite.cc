@@ -0,0 +1,287 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include "pubsub_shm_ring.h"
+
+class PubSubShmRingTestSuite : public ::testing::Test {
+public:
+    PubSubShmRingTestSuite() : name{"/celix_shm_ring_test_" + std::to_string(getpid())} {}
+
+    static celix_status_t write(pubsub_shm_ring_t* ring, const std::string& msg) {
+        struct iovec iov{};
+        iov.iov_base = (void*)msg.c_str();
+        iov.iov_len = msg.size();
+        return pubsub_shmRing_write(ring, &iov, 1);
+    }
+
+    static bool read(pubsub_shm_ring_t* ring, uint64_t& readPos, std::string& out, unsigned long& nrOfDropped) {
+        void* buf = nullptr;
+        size_t bufSize = 0;
+        size_t len = 0;
+        bool result = pubsub_shmRing_read(ring, &readPos, &buf, &bufSize, &len, &nrOfDropped);
+        if (result) {
+            out = std::string{(char*)buf, len};
+        }
+        free(buf);
+        return result;
+    }
+
+    static void benchmark(const char* name, int count, const std::function<void()>& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            fn();
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        std::cout << name << " " << count << " times took " << total / 1000 << " µs (" << total / count << " ns per call)\n";
+    }
+
+    const std::string name;
+};
+
+TEST_F(PubSubShmRingTestSuite, CreateAndOpenTest) {
+    auto* writer = pubsub_shmRing_create(name.c_str(), 5000);
+    ASSERT_NE(nullptr, writer);
+    EXPECT_STREQ(name.c_str(), pubsub_shmRing_name(writer));
+    EXPECT_EQ(8192 / 4 - 8, pubsub_shmRing_maxRecordSize(writer)); //capacity rounded up to a power of 2
+
+    auto* reader = pubsub_shmRing_open(name.c_str());
+    ASSERT_NE(nullptr, reader);
+    EXPECT_EQ(pubsub_shmRing_maxRecordSize(writer), pubsub_shmRing_maxRecordSize(reader));
+
+    pubsub_shmRing_destroy(reader);
+    pubsub_shmRing_destroy(writer);
+
+    //writer destroy unlinks the shared memory
+    EXPECT_EQ(nullptr, pubsub_shmRing_open(name.c_str()));
+}
+
+TEST_F(PubSubShmRingTestSuite, WriteAndReadTest) {
+    auto* writer = pubsub_shmRing_create(name.c_str(), 4096);
+    auto* reader = pubsub_shmRing_open(name.c_str());
+    ASSERT_NE(nullptr, reader);
+
+    uint64_t readPos = pubsub_shmRing_writePosition(reader);
+    unsigned long dropped = 0;
+    std::string out;
+    EXPECT_FALSE(read(reader, readPos, out, dropped));
+
+    std::string part1 = "header";
+    std::string part2 = "payload";
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)part1.c_str();
+    iov[0].iov_len = part1.size();
+    iov[1].iov_base = (void*)part2.c_str();
+    iov[1].iov_len = part2.size();
+    EXPECT_EQ(CELIX_SUCCESS, pubsub_shmRing_write(writer, iov, 2));
+    EXPECT_EQ(CELIX_SUCCESS, write(writer, "second"));
+
+    EXPECT_TRUE(read(reader, readPos, out, dropped));
+    EXPECT_EQ("headerpayload", out);
+    EXPECT_TRUE(read(reader, readPos, out, dropped));
+    EXPECT_EQ("second", out);
+    EXPECT_FALSE(read(reader, readPos, out, dropped));
+    EXPECT_EQ(0, dropped);
+
+    pubsub_shmRing_destroy(reader);
+    pubsub_shmRing_destroy(writer);
+}
+
+TEST_F(PubSubShmRingTestSuite, WrapAroundTest) {
+    auto* writer = pubsub_shmRing_create(name.c_str(), 4096);
+    auto* reader = pubsub_shmRing_open(name.c_str());
+    ASSERT_NE(nullptr, reader);
+
+    uint64_t readPos = pubsub_shmRing_writePosition(reader);
+    unsigned long dropped = 0;
+    for (int i = 0; i < 1000; ++i) {
+        //varying record sizes to wrap at different offsets
+        std::string msg = std::to_string(i) + std::string(i % 300, 'x');
+        ASSERT_EQ(CELIX_SUCCESS, write(writer, msg));
+        std::string out;
+        ASSERT_TRUE(read(reader, readPos, out, dropped));
+        EXPECT_EQ(msg, out);
+    }
+    EXPECT_GT(pubsub_shmRing_writePosition(writer), 4096 * 10);
+    EXPECT_EQ(0, dropped);
+
+    pubsub_shmRing_destroy(reader);
+    pubsub_shmRing_destroy(writer);
+}
+
+TEST_F(PubSubShmRingTestSuite, OverrunTest) {
+    auto* writer = pubsub_shmRing_create(name.c_str(), 4096);
+    auto* reader = pubsub_shmRing_open(name.c_str());
+    ASSERT_NE(nullptr, reader);
+
+    uint64_t readPos = pubsub_shmRing_writePosition(reader);
+    unsigned long dropped = 0;
+    std::string msg(100, 'x');
+    for (int i = 0; i < 100; ++i) {
+        write(writer, msg);
+    }
+
+    //reader is overrun and continues with the newest records
+    std::string out;
+    EXPECT_FALSE(read(reader, readPos, out, dropped));
+    EXPECT_EQ(1, dropped);
+    EXPECT_EQ(pubsub_shmRing_writePosition(writer), readPos);
+
+    write(writer, "new");
+    EXPECT_TRUE(read(reader, readPos, out, dropped));
+    EXPECT_EQ("new", out);
+    EXPECT_EQ(1, dropped);
+
+    pubsub_shmRing_destroy(reader);
+    pubsub_shmRing_destroy(writer);
+}
+
+TEST_F(PubSubShmRingTestSuite, TooLargeRecordTest) {
+    auto* writer = pubsub_shmRing_create(name.c_str(), 4096);
+    std::string msg(pubsub_shmRing_maxRecordSize(writer), 'x');
+    EXPECT_EQ(CELIX_SUCCESS, write(writer, msg));
+    msg += "x";
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, write(writer, msg));
+    pubsub_shmRing_destroy(writer);
+}
+
+TEST_F(PubSubShmRingTestSuite, OpenInvalidTest) {
+    EXPECT_EQ(nullptr, pubsub_shmRing_open("/celix_shm_ring_test_does_not_exist"));
+}
+
+TEST_F(PubSubShmRingTestSuite, WaitTest) {
+    auto* writer = pubsub_shmRing_create(name.c_str(), 4096);
+    auto* reader = pubsub_shmRing_open(name.c_str());
+    ASSERT_NE(nullptr, reader);
+
+    uint64_t readPos = pubsub_shmRing_writePosition(reader);
+    EXPECT_FALSE(pubsub_shmRing_wait(reader, readPos, 10));
+
+    std::thread thread{[writer]{
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        write(writer, "wakeup");
+    }};
+    bool available = false;
+    for (int i = 0; i < 100 && !available; ++i) {
+        available = pubsub_shmRing_wait(reader, readPos, 100);
+    }
+    EXPECT_TRUE(available);
+    thread.join();
+
+    pubsub_shmRing_destroy(reader);
+    pubsub_shmRing_destroy(writer);
+}
+
+/**
+ * Measures the round trip of a small message between two threads, once using two shm rings and once using a TCP
+ * loopback connection (the transport used by the TCP PSA).
+ */
+TEST_F(PubSubShmRingTestSuite, RoundTrip_Benchmark) {
+    const int count = 10000;
+    const std::string msg(64, 'x');
+
+    std::string pongName = name + "_pong";
+    auto* ping = pubsub_shmRing_create(name.c_str(), 1024 * 1024);
+    auto* pong = pubsub_shmRing_create(pongName.c_str(), 1024 * 1024);
+    std::atomic<bool> running{true};
+    std::thread echo{[&] {
+        auto* in = pubsub_shmRing_open(name.c_str());
+        auto* out = pubsub_shmRing_open(pongName.c_str());
+        uint64_t readPos = 0;
+        unsigned long dropped = 0;
+        std::string data;
+        while (running.load()) {
+            if (pubsub_shmRing_wait(in, readPos, 100)) {
+                while (read(in, readPos, data, dropped)) {
+                    write(out, data);
+                }
+            }
+        }
+        pubsub_shmRing_destroy(out);
+        pubsub_shmRing_destroy(in);
+    }};
+    uint64_t readPos = 0;
+    unsigned long dropped = 0;
+    std::string data;
+    benchmark("Shared memory ring round trip", count, [&]{
+        write(ping, msg);
+        while (!read(pong, readPos, data, dropped)) {
+            pubsub_shmRing_wait(pong, readPos, 100);
+        }
+    });
+    EXPECT_EQ(msg, data);
+    running = false;
+    pubsub_shmRing_wakeup(ping);
+    echo.join();
+    pubsub_shmRing_destroy(pong);
+    pubsub_shmRing_destroy(ping);
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listenFd, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    ASSERT_EQ(0, bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)));
+    socklen_t addrLen = sizeof(addr);
+    ASSERT_EQ(0, getsockname(listenFd, (struct sockaddr*)&addr, &addrLen));
+    ASSERT_EQ(0, listen(listenFd, 1));
+    std::thread tcpEcho{[listenFd, &msg] {
+        int fd = accept(listenFd, nullptr, nullptr);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        std::vector<char> buf(msg.size());
+        for (;;) {
+            if (recv(fd, buf.data(), buf.size(), MSG_WAITALL) != (ssize_t)buf.size()) {
+                break;
+            }
+            send(fd, buf.data(), buf.size(), 0);
+        }
+        close(fd);
+    }};
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(0, connect(fd, (struct sockaddr*)&addr, sizeof(addr)));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    std::vector<char> buf(msg.size());
+    benchmark("TCP loopback round trip", count, [&]{
+        send(fd, msg.c_str(), msg.size(), 0);
+        recv(fd, buf.data(), buf.size(), MSG_WAITALL);
+    });
+    EXPECT_EQ(msg, std::string(buf.data(), buf.size()));
+    close(fd);
+    tcpEcho.join();
+    close(listenFd);
+}
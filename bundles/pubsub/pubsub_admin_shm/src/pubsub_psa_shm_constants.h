@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PUBSUB_PSA_SHM_CONSTANTS_H_
+#define PUBSUB_PSA_SHM_CONSTANTS_H_
+
+/**
+ * The shm PSA only connects publishers and subscribers on the same host. The default scores are therefore kept low,
+ * so that it is only selected if configured for a topic (i.e. pubsub.config=shm in the topic properties) or if the
+ * scores are raised with the config properties below.
+ */
+#define PSA_SHM_DEFAULT_QOS_SAMPLE_SCORE        10
+#define PSA_SHM_DEFAULT_QOS_CONTROL_SCORE       10
+#define PSA_SHM_DEFAULT_SCORE                   10
+
+#define PSA_SHM_QOS_SAMPLE_SCORE_KEY            "PSA_SHM_QOS_SAMPLE_SCORE"
+#define PSA_SHM_QOS_CONTROL_SCORE_KEY           "PSA_SHM_QOS_CONTROL_SCORE"
+#define PSA_SHM_DEFAULT_SCORE_KEY               "PSA_SHM_DEFAULT_SCORE"
+
+/**
+ * The size in bytes of the shared memory ring buffer of a topic sender. Rounded up to a power of 2.
+ * A single message (incl. protocol header and metadata) can use at most a quarter of the ring.
+ * Can also be set per topic with the topic property PUBSUB_SHM_RING_SIZE_KEY.
+ */
+#define PSA_SHM_RING_SIZE                       "PSA_SHM_RING_SIZE"
+#define PSA_SHM_DEFAULT_RING_SIZE               (4 * 1024 * 1024)
+
+/**
+ * The max time in ms a topic receiver thread waits for new messages, before checking for a stop request or for
+ * subscribers to initialize.
+ */
+#define PSA_SHM_TIMEOUT                         "PSA_SHM_TIMEOUT"
+#define PSA_SHM_DEFAULT_TIMEOUT                 100
+
+/**
+ * Collect the send/receive metrics per msg type and origin, provided with the pubsub_admin_metrics service.
+ * If enabled, senders add the origin and send time metadata entries to every message.
+ */
+#define PSA_SHM_METRICS_ENABLED                 "PSA_SHM_METRICS_ENABLED"
+#define PSA_SHM_DEFAULT_METRICS_ENABLED         false
+
+#define PUBSUB_SHM_VERBOSE_KEY                  "PSA_SHM_VERBOSE"
+#define PUBSUB_SHM_VERBOSE_DEFAULT              false
+
+#define PUBSUB_SHM_ADMIN_TYPE                   "shm"
+
+/**
+ * The shared memory object name key for the topic sender endpoints
+ */
+#define PUBSUB_SHM_NAME_KEY                     "shm.name"
+
+/**
+ * The host id key for the topic sender endpoints. Endpoints are only matched if the host id is equal to the local
+ * host id (the hostname).
+ */
+#define PUBSUB_SHM_HOST_KEY                     "shm.host"
+
+/**
+ * Can be set in the topic properties to configure the ring buffer size of a topic sender
+ */
+#define PUBSUB_SHM_RING_SIZE_KEY                "shm.ring.size"
+
+#endif /* PUBSUB_PSA_SHM_CONSTANTS_H_ */
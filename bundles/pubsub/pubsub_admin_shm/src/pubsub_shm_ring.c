@@ -0,0 +1,312 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "pubsub_shm_ring.h"
+
+#define PUBSUB_SHM_RING_MAGIC                   0x43534852 //"CSHR"
+#define PUBSUB_SHM_RING_VERSION                 1
+#define PUBSUB_SHM_RING_MIN_CAPACITY            4096
+#define PUBSUB_SHM_RING_WRAP_MARKER             UINT32_MAX
+#define PUBSUB_SHM_RING_RECORD_HEADER_SIZE      8
+#define PUBSUB_SHM_RING_POLL_INTERVAL_IN_US     50
+
+#define PUBSUB_SHM_RING_ALIGN(size) (((size) + 7u) & ~((size_t)7u))
+
+/**
+ * The control block at the start of the shared memory, followed by the record data.
+ * The write position and the futex words are placed on their own cache line.
+ */
+typedef struct pubsub_shm_ring_control {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    char padding1[48];
+
+    uint64_t writePos; //total nr of bytes written, only increases
+    uint32_t notify;   //futex word, incremented for every written record
+    uint32_t waiters;  //nr of readers waiting on the notify futex
+    char padding2[48];
+} pubsub_shm_ring_control_t;
+
+struct pubsub_shm_ring {
+    char *name;
+    bool owner;
+    pubsub_shm_ring_control_t *control;
+    unsigned char *data;
+    size_t mapSize;
+    uint64_t capacity;
+    size_t maxRecordSize;
+};
+
+static void pubsub_shmRing_futexWait(uint32_t *addr, uint32_t val, unsigned int timeoutInMs) {
+#ifdef __linux__
+    struct timespec timeout;
+    timeout.tv_sec = timeoutInMs / 1000;
+    timeout.tv_nsec = (long)(timeoutInMs % 1000) * 1000000L;
+    syscall(SYS_futex, addr, FUTEX_WAIT, val, &timeout, NULL, 0);
+#else
+    (void)addr;
+    (void)val;
+    (void)timeoutInMs;
+    usleep(PUBSUB_SHM_RING_POLL_INTERVAL_IN_US);
+#endif
+}
+
+static void pubsub_shmRing_futexWake(uint32_t *addr) {
+#ifdef __linux__
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+    (void)addr;
+#endif
+}
+
+static pubsub_shm_ring_t* pubsub_shmRing_map(const char *name, int fd, size_t mapSize, bool owner) {
+    void *addr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return NULL;
+    }
+    pubsub_shm_ring_t *ring = calloc(1, sizeof(*ring));
+    ring->name = strdup(name);
+    ring->owner = owner;
+    ring->control = addr;
+    ring->data = (unsigned char*)addr + sizeof(pubsub_shm_ring_control_t);
+    ring->mapSize = mapSize;
+    return ring;
+}
+
+pubsub_shm_ring_t* pubsub_shmRing_create(const char *name, size_t capacity) {
+    uint64_t cap = PUBSUB_SHM_RING_MIN_CAPACITY;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    size_t mapSize = sizeof(pubsub_shm_ring_control_t) + cap;
+
+    //note a left over shm object (e.g. from a crashed writer) is replaced, readers of the old object keep their mapping
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+    if (fd < 0) {
+        return NULL;
+    }
+    pubsub_shm_ring_t *ring = NULL;
+    if (ftruncate(fd, (off_t)mapSize) == 0) {
+        ring = pubsub_shmRing_map(name, fd, mapSize, true);
+    }
+    close(fd);
+    if (ring == NULL) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    ring->capacity = cap;
+    ring->maxRecordSize = cap / 4;
+    ring->control->version = PUBSUB_SHM_RING_VERSION;
+    ring->control->capacity = cap;
+    ring->control->writePos = 0;
+    ring->control->notify = 0;
+    ring->control->waiters = 0;
+    __atomic_store_n(&ring->control->magic, PUBSUB_SHM_RING_MAGIC, __ATOMIC_RELEASE);
+    return ring;
+}
+
+pubsub_shm_ring_t* pubsub_shmRing_open(const char *name) {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    pubsub_shm_ring_t *ring = NULL;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > (off_t)sizeof(pubsub_shm_ring_control_t)) {
+        ring = pubsub_shmRing_map(name, fd, (size_t)st.st_size, false);
+    }
+    close(fd);
+
+    if (ring != NULL) {
+        pubsub_shm_ring_control_t *control = ring->control;
+        uint64_t cap = control->capacity;
+        bool valid = __atomic_load_n(&control->magic, __ATOMIC_ACQUIRE) == PUBSUB_SHM_RING_MAGIC &&
+                     control->version == PUBSUB_SHM_RING_VERSION &&
+                     cap >= PUBSUB_SHM_RING_MIN_CAPACITY && (cap & (cap - 1)) == 0 &&
+                     sizeof(pubsub_shm_ring_control_t) + cap <= ring->mapSize;
+        if (valid) {
+            ring->capacity = cap;
+            ring->maxRecordSize = cap / 4;
+        } else {
+            pubsub_shmRing_destroy(ring);
+            ring = NULL;
+        }
+    }
+    return ring;
+}
+
+void pubsub_shmRing_destroy(pubsub_shm_ring_t *ring) {
+    if (ring != NULL) {
+        munmap(ring->control, ring->mapSize);
+        if (ring->owner) {
+            shm_unlink(ring->name);
+        }
+        free(ring->name);
+        free(ring);
+    }
+}
+
+const char* pubsub_shmRing_name(const pubsub_shm_ring_t *ring) {
+    return ring->name;
+}
+
+size_t pubsub_shmRing_maxRecordSize(const pubsub_shm_ring_t *ring) {
+    return ring->maxRecordSize - PUBSUB_SHM_RING_RECORD_HEADER_SIZE;
+}
+
+celix_status_t pubsub_shmRing_write(pubsub_shm_ring_t *ring, const struct iovec *iov, size_t iovLen) {
+    size_t length = 0;
+    for (size_t i = 0; i < iovLen; ++i) {
+        length += iov[i].iov_len;
+    }
+    size_t recordSize = PUBSUB_SHM_RING_ALIGN(PUBSUB_SHM_RING_RECORD_HEADER_SIZE + length);
+    if (recordSize > ring->maxRecordSize) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    pubsub_shm_ring_control_t *control = ring->control;
+    uint64_t pos = __atomic_load_n(&control->writePos, __ATOMIC_RELAXED);
+    size_t offset = (size_t)(pos & (ring->capacity - 1));
+    if (ring->capacity - offset < recordSize) {
+        //record does not fit at the end, mark the remainder as skipped and continue at the start of the ring
+        uint32_t marker = PUBSUB_SHM_RING_WRAP_MARKER;
+        memcpy(ring->data + offset, &marker, sizeof(marker));
+        pos += ring->capacity - offset;
+        offset = 0;
+    }
+
+    uint32_t recordLength = (uint32_t)length;
+    memcpy(ring->data + offset, &recordLength, sizeof(recordLength));
+    unsigned char *dst = ring->data + offset + PUBSUB_SHM_RING_RECORD_HEADER_SIZE;
+    for (size_t i = 0; i < iovLen; ++i) {
+        memcpy(dst, iov[i].iov_base, iov[i].iov_len);
+        dst += iov[i].iov_len;
+    }
+
+    __atomic_store_n(&control->writePos, pos + recordSize, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&control->notify, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&control->waiters, __ATOMIC_SEQ_CST) > 0) {
+        pubsub_shmRing_futexWake(&control->notify);
+    }
+    return CELIX_SUCCESS;
+}
+
+uint64_t pubsub_shmRing_writePosition(const pubsub_shm_ring_t *ring) {
+    return __atomic_load_n(&ring->control->writePos, __ATOMIC_ACQUIRE);
+}
+
+bool pubsub_shmRing_read(pubsub_shm_ring_t *ring, uint64_t *readPos, void **buffer, size_t *bufferSize, size_t *length, unsigned long *nrOfDropped) {
+    //A record is only safe to read if the writer cannot reach it, also not with a record (incl. wrap) in progress.
+    uint64_t maxLag = ring->capacity - 2 * ring->maxRecordSize;
+    uint64_t start = *readPos;
+    uint64_t pos = start;
+    for (;;) {
+        uint64_t writePos = pubsub_shmRing_writePosition(ring);
+        if (pos == writePos) {
+            *readPos = pos;
+            return false;
+        }
+        if (writePos - start > maxLag) {
+            //overrun by the writer, continue with the newest records
+            *nrOfDropped += 1;
+            *readPos = writePos;
+            return false;
+        }
+
+        size_t offset = (size_t)(pos & (ring->capacity - 1));
+        uint32_t recordLength;
+        memcpy(&recordLength, ring->data + offset, sizeof(recordLength));
+        if (recordLength == PUBSUB_SHM_RING_WRAP_MARKER) {
+            pos += ring->capacity - offset;
+            continue;
+        }
+
+        size_t recordSize = PUBSUB_SHM_RING_ALIGN(PUBSUB_SHM_RING_RECORD_HEADER_SIZE + (size_t)recordLength);
+        if (recordSize > ring->maxRecordSize || offset + recordSize > ring->capacity) {
+            //invalid record header, can only be the result of an overrun
+            *nrOfDropped += 1;
+            *readPos = pubsub_shmRing_writePosition(ring);
+            return false;
+        }
+        if (*bufferSize < recordLength) {
+            free(*buffer);
+            *buffer = malloc(recordLength);
+            *bufferSize = recordLength;
+        }
+        memcpy(*buffer, ring->data + offset + PUBSUB_SHM_RING_RECORD_HEADER_SIZE, recordLength);
+
+        //validate that the writer did not overwrite the record during the copy
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        writePos = pubsub_shmRing_writePosition(ring);
+        if (writePos - start > maxLag) {
+            *nrOfDropped += 1;
+            *readPos = writePos;
+            return false;
+        }
+
+        *readPos = pos + recordSize;
+        *length = recordLength;
+        return true;
+    }
+}
+
+bool pubsub_shmRing_wait(pubsub_shm_ring_t *ring, uint64_t readPos, unsigned int timeoutInMs) {
+    pubsub_shm_ring_control_t *control = ring->control;
+    uint32_t notify = __atomic_load_n(&control->notify, __ATOMIC_SEQ_CST);
+    if (pubsub_shmRing_writePosition(ring) != readPos) {
+        return true;
+    }
+#ifdef __linux__
+    __atomic_add_fetch(&control->waiters, 1, __ATOMIC_SEQ_CST);
+    if (pubsub_shmRing_writePosition(ring) == readPos) {
+        pubsub_shmRing_futexWait(&control->notify, notify, timeoutInMs);
+    }
+    __atomic_sub_fetch(&control->waiters, 1, __ATOMIC_SEQ_CST);
+#else
+    unsigned long waitedInUs = 0;
+    while (pubsub_shmRing_writePosition(ring) == readPos &&
+           __atomic_load_n(&control->notify, __ATOMIC_SEQ_CST) == notify &&
+           waitedInUs < timeoutInMs * 1000UL) {
+        pubsub_shmRing_futexWait(&control->notify, notify, timeoutInMs);
+        waitedInUs += PUBSUB_SHM_RING_POLL_INTERVAL_IN_US;
+    }
+#endif
+    return pubsub_shmRing_writePosition(ring) != readPos;
+}
+
+void pubsub_shmRing_wakeup(pubsub_shm_ring_t *ring) {
+    __atomic_add_fetch(&ring->control->notify, 1, __ATOMIC_SEQ_CST);
+    pubsub_shmRing_futexWake(&ring->control->notify);
+}
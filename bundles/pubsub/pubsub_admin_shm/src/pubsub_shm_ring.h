@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_SHM_RING_H
+#define CELIX_PUBSUB_SHM_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "celix_errno.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A single writer, multiple reader ring buffer in POSIX shared memory.
+ *
+ * The writer appends length prefixed records and never waits for the readers. Every reader keeps its own read
+ * position; a reader that falls behind more than the ring capacity loses the overwritten records. Records are
+ * copied out by the readers and validated against the write position afterwards, so a reader never delivers a
+ * record that was (partially) overwritten during the copy.
+ *
+ * Readers waiting for new records are woken up using a futex in the shared memory (Linux). On other platforms the
+ * readers fall back to polling.
+ */
+typedef struct pubsub_shm_ring pubsub_shm_ring_t;
+
+/**
+ * Creates (or recreates) the shared memory object with the provided name and maps it as writer.
+ * The capacity is rounded up to a power of 2. The shared memory object is unlinked on destroy.
+ *
+ * @param name The shared memory object name, must start with a '/' and contain no other '/'.
+ * @return The ring or NULL if the shared memory could not be created.
+ */
+pubsub_shm_ring_t* pubsub_shmRing_create(const char *name, size_t capacity);
+
+/**
+ * Opens and maps an existing shared memory ring as reader.
+ *
+ * @return The ring or NULL if the shared memory object does not exist or is not a (compatible) ring.
+ */
+pubsub_shm_ring_t* pubsub_shmRing_open(const char *name);
+
+void pubsub_shmRing_destroy(pubsub_shm_ring_t *ring);
+
+const char* pubsub_shmRing_name(const pubsub_shm_ring_t *ring);
+
+/**
+ * The maximum size of a single record. Larger records are rejected by pubsub_shmRing_write.
+ */
+size_t pubsub_shmRing_maxRecordSize(const pubsub_shm_ring_t *ring);
+
+/**
+ * Writes a record, gathered from the provided io vectors, to the ring and wakes up the waiting readers.
+ * Only one thread (and process) may write to a ring at the same time.
+ *
+ * @return CELIX_SUCCESS or CELIX_ILLEGAL_ARGUMENT if the record is too large for the ring.
+ */
+celix_status_t pubsub_shmRing_write(pubsub_shm_ring_t *ring, const struct iovec *iov, size_t iovLen);
+
+/**
+ * Returns the current write position, this is the read position for a reader interested in new records only.
+ */
+uint64_t pubsub_shmRing_writePosition(const pubsub_shm_ring_t *ring);
+
+/**
+ * Reads the next record after readPos into buffer. The buffer is (re)allocated if it is too small.
+ *
+ * @param readPos       In/out the read position of the reader.
+ * @param buffer        In/out the (heap allocated) buffer to copy the record in.
+ * @param bufferSize    In/out the size of buffer.
+ * @param length        Out the length of the record read.
+ * @param nrOfDropped   Out incremented for every time the reader was overrun by the writer.
+ * @return true if a record was read, false if no (valid) record was available.
+ */
+bool pubsub_shmRing_read(pubsub_shm_ring_t *ring, uint64_t *readPos, void **buffer, size_t *bufferSize, size_t *length, unsigned long *nrOfDropped);
+
+/**
+ * Waits until a record is available after readPos, the timeout expired or the ring is woken up.
+ *
+ * @return true if a record is available after readPos.
+ */
+bool pubsub_shmRing_wait(pubsub_shm_ring_t *ring, uint64_t readPos, unsigned int timeoutInMs);
+
+/**
+ * Wakes up all readers waiting on the ring.
+ */
+void pubsub_shmRing_wakeup(pubsub_shm_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_PUBSUB_SHM_RING_H
@@ -0,0 +1,535 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pubsub/subscriber.h>
+#include <pubsub_constants.h>
+#include <pubsub_endpoint.h>
+#include <celix_log_helper.h>
+#include <celix_api.h>
+#include "pubsub_shm_topic_receiver.h"
+#include "pubsub_shm_ring.h"
+#include "pubsub_psa_shm_constants.h"
+
+#define L_DEBUG(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define L_INFO(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_INFO, __VA_ARGS__)
+#define L_WARN(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define L_ERROR(...) \
+    celix_logHelper_log(receiver->logHelper, CELIX_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+struct pubsub_shm_topic_receiver {
+    celix_bundle_context_t *ctx;
+    celix_log_helper_t *logHelper;
+    long serializerSvcId;
+    pubsub_serializer_service_t *serializer;
+    long protocolSvcId;
+    pubsub_protocol_service_t *protocol;
+    char *scope;
+    char *topic;
+    unsigned int timeoutInMs;
+    size_t headerSize;
+    size_t footerSize;
+    pubsub_admin_metrics_receive_counters_t *metrics; //NULL if metrics are not enabled
+    unsigned long nrOfDroppedMessages; //atomic, nr of messages overwritten in the rings before they were read
+
+    struct {
+        celix_thread_mutex_t mutex;
+        hash_map_t *map; //key = shm name, value = psa_shm_connection_entry_t*
+    } connections;
+
+    long subscriberTrackerId;
+    struct {
+        celix_thread_rwlock_t lock; //read locked during delivery, so the receive threads do not block each other
+        hash_map_t *map; //key = bnd id, value = psa_shm_subscriber_entry_t
+    } subscribers;
+};
+
+typedef struct psa_shm_connection_entry {
+    pubsub_shm_topic_receiver_t *parent;
+    char *shmName;
+    celix_thread_t thread;
+    bool running; //atomic
+    bool connected; //protected by connections.mutex
+} psa_shm_connection_entry_t;
+
+typedef struct psa_shm_subscriber_entry {
+    hash_map_t *msgTypes; //key = msg type id, value = pubsub_msg_serializer_t
+    hash_map_t *subscriberServices; //key = servide id, value = pubsub_subscriber_t*
+} psa_shm_subscriber_entry_t;
+
+static void pubsub_shmTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
+static void pubsub_shmTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
+static void* psa_shm_recvThread(void *data);
+static void psa_shm_processRecord(pubsub_shm_topic_receiver_t *receiver, void *record, size_t length);
+static bool psa_shm_checkVersion(version_pt msgVersion, uint16_t major, uint16_t minor);
+static void psa_shm_stopConnection(psa_shm_connection_entry_t *entry);
+
+pubsub_shm_topic_receiver_t* pubsub_shmTopicReceiver_create(celix_bundle_context_t *ctx,
+                                                             celix_log_helper_t *logHelper,
+                                                             const char *scope,
+                                                             const char *topic,
+                                                             long serializerSvcId,
+                                                             pubsub_serializer_service_t *serializer,
+                                                             long protocolSvcId,
+                                                             pubsub_protocol_service_t *protocol) {
+    pubsub_shm_topic_receiver_t *receiver = calloc(1, sizeof(*receiver));
+    receiver->ctx = ctx;
+    receiver->logHelper = logHelper;
+    receiver->serializerSvcId = serializerSvcId;
+    receiver->serializer = serializer;
+    receiver->protocolSvcId = protocolSvcId;
+    receiver->protocol = protocol;
+    receiver->scope = scope == NULL ? NULL : strndup(scope, 1024 * 1024);
+    receiver->topic = strndup(topic, 1024 * 1024);
+    long timeout = celix_bundleContext_getPropertyAsLong(ctx, PSA_SHM_TIMEOUT, PSA_SHM_DEFAULT_TIMEOUT);
+    receiver->timeoutInMs = timeout > 0 ? (unsigned int)timeout : PSA_SHM_DEFAULT_TIMEOUT;
+    protocol->getHeaderSize(protocol->handle, &receiver->headerSize);
+    protocol->getFooterSize(protocol->handle, &receiver->footerSize);
+    if (celix_bundleContext_getPropertyAsBool(ctx, PSA_SHM_METRICS_ENABLED, PSA_SHM_DEFAULT_METRICS_ENABLED)) {
+        receiver->metrics = pubsub_metricsReceiveCounters_create();
+    }
+
+    celixThreadMutex_create(&receiver->connections.mutex, NULL);
+    receiver->connections.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+    celixThreadRwlock_create(&receiver->subscribers.lock, NULL);
+    receiver->subscribers.map = hashMap_create(NULL, NULL, NULL, NULL);
+
+    //track subscribers
+    int size = snprintf(NULL, 0, "(%s=%s)", PUBSUB_SUBSCRIBER_TOPIC, topic);
+    char buf[size+1];
+    snprintf(buf, (size_t)size+1, "(%s=%s)", PUBSUB_SUBSCRIBER_TOPIC, topic);
+    celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
+    opts.filter.ignoreServiceLanguage = true;
+    opts.filter.serviceName = PUBSUB_SUBSCRIBER_SERVICE_NAME;
+    opts.filter.filter = buf;
+    opts.callbackHandle = receiver;
+    opts.addWithOwner = pubsub_shmTopicReceiver_addSubscriber;
+    opts.removeWithOwner = pubsub_shmTopicReceiver_removeSubscriber;
+    receiver->subscriberTrackerId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+
+    return receiver;
+}
+
+void pubsub_shmTopicReceiver_destroy(pubsub_shm_topic_receiver_t *receiver) {
+    if (receiver != NULL) {
+        celixThreadMutex_lock(&receiver->connections.mutex);
+        hash_map_iterator_t iter = hashMapIterator_construct(receiver->connections.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_shm_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+            __atomic_store_n(&entry->running, false, __ATOMIC_RELEASE);
+        }
+        celixThreadMutex_unlock(&receiver->connections.mutex);
+
+        //note joining the receive threads without the connections lock, the threads use the lock to update the state
+        iter = hashMapIterator_construct(receiver->connections.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_shm_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+            psa_shm_stopConnection(entry);
+        }
+        hashMap_destroy(receiver->connections.map, false, false);
+        celixThreadMutex_destroy(&receiver->connections.mutex);
+
+        celix_bundleContext_stopTracker(receiver->ctx, receiver->subscriberTrackerId);
+
+        celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+        iter = hashMapIterator_construct(receiver->subscribers.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_shm_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (entry != NULL)  {
+                receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
+                hashMap_destroy(entry->subscriberServices, false, false);
+                free(entry);
+            }
+        }
+        hashMap_destroy(receiver->subscribers.map, false, false);
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
+
+        celixThreadRwlock_destroy(&receiver->subscribers.lock);
+        if (receiver->metrics != NULL) {
+            pubsub_metricsReceiveCounters_destroy(receiver->metrics);
+        }
+        free(receiver->scope);
+        free(receiver->topic);
+    }
+    free(receiver);
+}
+
+const char* pubsub_shmTopicReceiver_scope(pubsub_shm_topic_receiver_t *receiver) {
+    return receiver->scope;
+}
+
+const char* pubsub_shmTopicReceiver_topic(pubsub_shm_topic_receiver_t *receiver) {
+    return receiver->topic;
+}
+
+long pubsub_shmTopicReceiver_serializerSvcId(pubsub_shm_topic_receiver_t *receiver) {
+    return receiver->serializerSvcId;
+}
+
+long pubsub_shmTopicReceiver_protocolSvcId(pubsub_shm_topic_receiver_t *receiver) {
+    return receiver->protocolSvcId;
+}
+
+void pubsub_shmTopicReceiver_listConnections(pubsub_shm_topic_receiver_t *receiver, celix_array_list_t *connectedNames, celix_array_list_t *unconnectedNames) {
+    celixThreadMutex_lock(&receiver->connections.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(receiver->connections.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_shm_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+        char *name = celix_utils_strdup(entry->shmName);
+        if (entry->connected) {
+            celix_arrayList_add(connectedNames, name);
+        } else {
+            celix_arrayList_add(unconnectedNames, name);
+        }
+    }
+    celixThreadMutex_unlock(&receiver->connections.mutex);
+}
+
+void pubsub_shmTopicReceiver_connectTo(pubsub_shm_topic_receiver_t *receiver, const char *shmName) {
+    L_DEBUG("[PSA_SHM] TopicReceiver %s/%s connect to shm %s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic, shmName);
+
+    celixThreadMutex_lock(&receiver->connections.mutex);
+    psa_shm_connection_entry_t *entry = hashMap_get(receiver->connections.map, shmName);
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(*entry));
+        entry->parent = receiver;
+        entry->shmName = celix_utils_strdup(shmName);
+        entry->running = true;
+        entry->connected = false;
+        hashMap_put(receiver->connections.map, entry->shmName, entry);
+        celixThread_create(&entry->thread, NULL, psa_shm_recvThread, entry);
+        char name[64];
+        snprintf(name, 64, "SHM TR %s/%s", receiver->scope == NULL ? "" : receiver->scope, receiver->topic);
+        celixThread_setName(&entry->thread, name);
+    }
+    celixThreadMutex_unlock(&receiver->connections.mutex);
+}
+
+void pubsub_shmTopicReceiver_disconnectFrom(pubsub_shm_topic_receiver_t *receiver, const char *shmName) {
+    L_DEBUG("[PSA_SHM] TopicReceiver %s/%s disconnect from shm %s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic, shmName);
+
+    celixThreadMutex_lock(&receiver->connections.mutex);
+    psa_shm_connection_entry_t *entry = hashMap_remove(receiver->connections.map, shmName);
+    if (entry != NULL) {
+        __atomic_store_n(&entry->running, false, __ATOMIC_RELEASE);
+    }
+    celixThreadMutex_unlock(&receiver->connections.mutex);
+
+    if (entry != NULL) {
+        psa_shm_stopConnection(entry);
+    }
+}
+
+static void psa_shm_stopConnection(psa_shm_connection_entry_t *entry) {
+    //note running is already false, the receive thread stops within the configured timeout
+    celixThread_join(entry->thread, NULL);
+    free(entry->shmName);
+    free(entry);
+}
+
+static void pubsub_shmTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *bnd) {
+    pubsub_shm_topic_receiver_t *receiver = handle;
+
+    long bndId = celix_bundle_getId(bnd);
+    long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    const char *subScope = celix_properties_get(props, PUBSUB_SUBSCRIBER_SCOPE, NULL);
+    if (receiver->scope == NULL){
+        if (subScope != NULL){
+            return;
+        }
+    } else if (subScope != NULL) {
+        if (strncmp(subScope, receiver->scope, strlen(receiver->scope)) != 0) {
+            //not the same scope. ignore
+            return;
+        }
+    } else {
+        //receiver scope is not NULL, but subScope is NULL -> ignore
+        return;
+    }
+
+    //note a topic receiver can have multiple (or no) receive threads, so the subscriber is initialized when added.
+    pubsub_subscriber_t *subSvc = svc;
+    if (subSvc->init != NULL) {
+        int rc = subSvc->init(subSvc->handle);
+        if (rc != 0) {
+            L_WARN("[PSA_SHM] Cannot initialize subscriber svc. Got rc %i", rc);
+        }
+    }
+
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+    psa_shm_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void*)bndId);
+    if (entry != NULL) {
+        hashMap_put(entry->subscriberServices, (void*)svcId, svc);
+    } else {
+        //new create entry
+        entry = calloc(1, sizeof(*entry));
+        entry->subscriberServices = hashMap_create(NULL, NULL, NULL, NULL);
+        hashMap_put(entry->subscriberServices, (void*)svcId, svc);
+
+        int rc = receiver->serializer->createSerializerMap(receiver->serializer->handle, (celix_bundle_t*)bnd, &entry->msgTypes);
+
+        if (rc == 0) {
+            hashMap_put(receiver->subscribers.map, (void*)bndId, entry);
+        } else {
+            L_ERROR("[PSA_SHM] Cannot create msg serializer map for TopicReceiver %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+            hashMap_destroy(entry->subscriberServices, false, false);
+            free(entry);
+        }
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+}
+
+static void pubsub_shmTopicReceiver_removeSubscriber(void *handle, void *svc __attribute__((unused)), const celix_properties_t *props, const celix_bundle_t *bnd) {
+    pubsub_shm_topic_receiver_t *receiver = handle;
+
+    long bndId = celix_bundle_getId(bnd);
+    long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+    psa_shm_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void*)bndId);
+    if (entry != NULL) {
+        hashMap_remove(entry->subscriberServices, (void*)svcId);
+    }
+    if (entry != NULL && hashMap_size(entry->subscriberServices) == 0) {
+        //remove entry
+        hashMap_remove(receiver->subscribers.map, (void*)bndId);
+        int rc = receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
+        if (rc != 0) {
+            L_ERROR("[PSA_SHM] Cannot destroy msg serializers map for TopicReceiver %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        }
+        hashMap_destroy(entry->subscriberServices, false, false);
+        free(entry);
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+}
+
+static void* psa_shm_recvThread(void *data) {
+    psa_shm_connection_entry_t *conn = data;
+    pubsub_shm_topic_receiver_t *receiver = conn->parent;
+
+    pubsub_shm_ring_t *ring = NULL;
+    uint64_t readPos = 0;
+    void *buffer = NULL;
+    size_t bufferSize = 0;
+    unsigned long nrOfDropped = 0;
+    unsigned long nrOfReportedDropped = 0;
+
+    while (__atomic_load_n(&conn->running, __ATOMIC_ACQUIRE)) {
+        if (ring == NULL) {
+            ring = pubsub_shmRing_open(conn->shmName);
+            if (ring == NULL) {
+                usleep(receiver->timeoutInMs * 1000);
+                continue;
+            }
+            readPos = pubsub_shmRing_writePosition(ring);
+            celixThreadMutex_lock(&receiver->connections.mutex);
+            conn->connected = true;
+            celixThreadMutex_unlock(&receiver->connections.mutex);
+        }
+
+        if (pubsub_shmRing_wait(ring, readPos, receiver->timeoutInMs)) {
+            size_t length = 0;
+            while (pubsub_shmRing_read(ring, &readPos, &buffer, &bufferSize, &length, &nrOfDropped)) {
+                psa_shm_processRecord(receiver, buffer, length);
+            }
+            if (nrOfDropped != nrOfReportedDropped) {
+                __atomic_fetch_add(&receiver->nrOfDroppedMessages, nrOfDropped - nrOfReportedDropped, __ATOMIC_RELAXED);
+                L_WARN("[PSA_SHM_TR] TopicReceiver %s/%s is overrun by the publisher of shm %s, messages are lost. Consider increasing the ring size.",
+                       receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic, conn->shmName);
+                nrOfReportedDropped = nrOfDropped;
+            }
+        }
+    }
+
+    pubsub_shmRing_destroy(ring);
+    free(buffer);
+    return NULL;
+}
+
+/**
+ * The (de)serialization outcome of a record over all subscriber entries, used for the metrics.
+ */
+typedef struct psa_shm_record_metrics {
+    const char *msgFqn; //NULL if no subscriber entry has a serializer for the msg type
+    bool timed;
+    struct timespec deserializeStart;
+    struct timespec deserializeEnd;
+    bool failed;
+} psa_shm_record_metrics_t;
+
+static void psa_shm_processMsgForSubscriberEntry(pubsub_shm_topic_receiver_t *receiver, psa_shm_subscriber_entry_t *entry, const pubsub_protocol_message_t *message, psa_shm_record_metrics_t *recordMetrics) {
+    //NOTE receiver->subscribers.lock read locked
+    pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)(message->header.msgId));
+    if (msgSer == NULL) {
+        L_WARN("[PSA_SHM_TR] Cannot find serializer for type id 0x%X", message->header.msgId);
+        return;
+    }
+    if (!psa_shm_checkVersion(msgSer->msgVersion, message->header.msgMajorVersion, message->header.msgMinorVersion)) {
+        L_WARN("[PSA_SHM_TR] Incompatible version %u.%u for msg type %s", message->header.msgMajorVersion, message->header.msgMinorVersion, msgSer->msgName);
+        return;
+    }
+
+    //note only the first deserialization of a record is timed
+    bool monitor = receiver->metrics != NULL && !recordMetrics->timed;
+    recordMetrics->msgFqn = msgSer->msgName;
+    struct iovec deSerializeBuffer;
+    deSerializeBuffer.iov_base = message->payload.payload;
+    deSerializeBuffer.iov_len = message->payload.length;
+    void *deSerializedMsg = NULL;
+    if (monitor) {
+        clock_gettime(CLOCK_REALTIME, &recordMetrics->deserializeStart);
+    }
+    celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 1, &deSerializedMsg);
+    if (monitor) {
+        clock_gettime(CLOCK_REALTIME, &recordMetrics->deserializeEnd);
+        recordMetrics->timed = true;
+    }
+    if (status != CELIX_SUCCESS) {
+        recordMetrics->failed = true;
+    }
+    if (status == CELIX_SUCCESS) {
+        hash_map_iterator_t iter = hashMapIterator_construct(entry->subscriberServices);
+        bool release = true;
+        while (hashMapIterator_hasNext(&iter)) {
+            pubsub_subscriber_t *svc = hashMapIterator_nextValue(&iter);
+            svc->receive(svc->handle, msgSer->msgName, msgSer->msgId, deSerializedMsg, message->metadata.metadata, &release);
+            if (!release && hashMapIterator_hasNext(&iter)) {
+                //receive function has taken ownership and still more receive function to come ..
+                //deserialize again for new message
+                status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 1, &deSerializedMsg);
+                if (status != CELIX_SUCCESS) {
+                    L_WARN("[PSA_SHM_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName,
+                           receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+                    break;
+                }
+                release = true;
+            }
+        }
+        if (release) {
+            msgSer->freeDeserializeMsg(msgSer->handle, deSerializedMsg);
+        }
+    } else {
+        L_WARN("[PSA_SHM_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName,
+               receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+    }
+}
+
+static void psa_shm_processRecord(pubsub_shm_topic_receiver_t *receiver, void *record, size_t length) {
+    struct timespec receiveTime;
+    if (receiver->metrics != NULL) {
+        clock_gettime(CLOCK_REALTIME, &receiveTime);
+    }
+    unsigned char *data = record;
+    pubsub_protocol_message_t message;
+    memset(&message, 0, sizeof(message));
+
+    //record layout: protocol header | serialized payload | protocol metadata | protocol footer
+    if (length < receiver->headerSize + receiver->footerSize ||
+        receiver->protocol->decodeHeader(receiver->protocol->handle, data, receiver->headerSize, &message) != CELIX_SUCCESS) {
+        L_WARN("[PSA_SHM_TR] Failed to decode message header for scope/topic %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        return;
+    }
+    size_t payloadSize = message.header.payloadSize;
+    size_t metadataSize = message.header.metadataSize;
+    if (receiver->headerSize + payloadSize + metadataSize + receiver->footerSize != length) {
+        L_WARN("[PSA_SHM_TR] Invalid message size %zu for scope/topic %s/%s", length, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        return;
+    }
+    if (receiver->footerSize > 0 &&
+        receiver->protocol->decodeFooter(receiver->protocol->handle, data + length - receiver->footerSize, receiver->footerSize, &message) != CELIX_SUCCESS) {
+        L_WARN("[PSA_SHM_TR] Failed to decode message footer for scope/topic %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        return;
+    }
+    receiver->protocol->decodePayload(receiver->protocol->handle, data + receiver->headerSize, payloadSize, &message);
+    if (metadataSize > 0) {
+        receiver->protocol->decodeMetadata(receiver->protocol->handle, data + receiver->headerSize + payloadSize, metadataSize, &message);
+    }
+
+    psa_shm_record_metrics_t recordMetrics;
+    memset(&recordMetrics, 0, sizeof(recordMetrics));
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
+    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_shm_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+        if (entry != NULL) {
+            psa_shm_processMsgForSubscriberEntry(receiver, entry, &message, &recordMetrics);
+        }
+    }
+    if (receiver->metrics != NULL && recordMetrics.msgFqn != NULL) {
+        //note msgFqn points to a serializer name, so the update is done while still read locked
+        const char *origin = NULL;
+        int64_t sendTimeInNs = 0;
+        pubsub_metrics_getSendMetadata(message.metadata.metadata, &origin, &sendTimeInNs);
+        unsigned int seqNr = message.header.seqNr;
+        pubsub_metricsReceiveCounters_update(receiver->metrics, message.header.msgId, recordMetrics.msgFqn, origin, sendTimeInNs, &seqNr, &receiveTime,
+                                             recordMetrics.timed ? &recordMetrics.deserializeStart : NULL,
+                                             recordMetrics.timed ? &recordMetrics.deserializeEnd : NULL,
+                                             recordMetrics.failed ? 0 : 1, recordMetrics.failed ? 1 : 0);
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+
+    if (message.metadata.metadata != NULL) {
+        celix_properties_destroy(message.metadata.metadata);
+    }
+}
+
+pubsub_admin_receiver_metrics_t* pubsub_shmTopicReceiver_metrics(pubsub_shm_topic_receiver_t *receiver) {
+    if (receiver->metrics == NULL) {
+        return NULL;
+    }
+    pubsub_admin_receiver_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : receiver->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
+    result->nrOfDroppedMessages = __atomic_load_n(&receiver->nrOfDroppedMessages, __ATOMIC_RELAXED);
+    pubsub_metricsReceiveCounters_fill(receiver->metrics, result);
+    return result;
+}
+
+static bool psa_shm_checkVersion(version_pt msgVersion, uint16_t major, uint16_t minor) {
+    bool check = false;
+
+    if (major == 0 && minor == 0) {
+        //no check
+        return true;
+    }
+
+    int versionMajor;
+    int versionMinor;
+    if (msgVersion != NULL) {
+        version_getMajor(msgVersion, &versionMajor);
+        version_getMinor(msgVersion, &versionMinor);
+        if (major == ((unsigned char) versionMajor)) { /* Different major means incompatible */
+            check = (minor >= ((unsigned char) versionMinor)); /* Compatible only if the provider has a minor equals or greater (means compatible update) */
+        }
+    }
+
+    return check;
+}
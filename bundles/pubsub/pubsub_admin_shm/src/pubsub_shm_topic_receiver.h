@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_SHM_TOPIC_RECEIVER_H
+#define CELIX_PUBSUB_SHM_TOPIC_RECEIVER_H
+
+#include "celix_bundle_context.h"
+#include "celix_log_helper.h"
+#include "pubsub_serializer.h"
+#include "pubsub_protocol.h"
+#include "pubsub_admin_metrics.h"
+
+typedef struct pubsub_shm_topic_receiver pubsub_shm_topic_receiver_t;
+
+pubsub_shm_topic_receiver_t* pubsub_shmTopicReceiver_create(celix_bundle_context_t *ctx,
+        celix_log_helper_t *logHelper,
+        const char *scope,
+        const char *topic,
+        long serializerSvcId,
+        pubsub_serializer_service_t *serializer,
+        long protocolSvcId,
+        pubsub_protocol_service_t *protocol);
+void pubsub_shmTopicReceiver_destroy(pubsub_shm_topic_receiver_t *receiver);
+
+const char* pubsub_shmTopicReceiver_scope(pubsub_shm_topic_receiver_t *receiver);
+const char* pubsub_shmTopicReceiver_topic(pubsub_shm_topic_receiver_t *receiver);
+
+long pubsub_shmTopicReceiver_serializerSvcId(pubsub_shm_topic_receiver_t *receiver);
+long pubsub_shmTopicReceiver_protocolSvcId(pubsub_shm_topic_receiver_t *receiver);
+
+/**
+ * Lists the shm names of the (un)connected publishers. The names are copied and should be freed by the caller.
+ */
+void pubsub_shmTopicReceiver_listConnections(pubsub_shm_topic_receiver_t *receiver, celix_array_list_t *connectedNames, celix_array_list_t *unconnectedNames);
+
+/**
+ * Connects the topic receiver to the shared memory ring of a publisher. Every connected ring is read by its own
+ * receive thread, which only starts reading from the messages written after the connect.
+ */
+void pubsub_shmTopicReceiver_connectTo(pubsub_shm_topic_receiver_t *receiver, const char *shmName);
+void pubsub_shmTopicReceiver_disconnectFrom(pubsub_shm_topic_receiver_t *receiver, const char *shmName);
+
+/**
+ * Returns the receive metrics per msg type/origin or NULL if metrics are not enabled.
+ */
+pubsub_admin_receiver_metrics_t* pubsub_shmTopicReceiver_metrics(pubsub_shm_topic_receiver_t *receiver);
+
+#endif //CELIX_PUBSUB_SHM_TOPIC_RECEIVER_H
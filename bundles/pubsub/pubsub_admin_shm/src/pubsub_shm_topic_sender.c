@@ -0,0 +1,506 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <pubsub_constants.h>
+#include <pubsub_endpoint.h>
+#include <pubsub/publisher.h>
+#include <utils.h>
+#include <celix_log_helper.h>
+#include "pubsub_shm_topic_sender.h"
+#include "pubsub_shm_ring.h"
+#include "pubsub_psa_shm_constants.h"
+#include "celix_constants.h"
+
+#define PSA_SHM_NAME_MAX_LENGTH     200
+
+#define L_DEBUG(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define L_INFO(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_INFO, __VA_ARGS__)
+#define L_WARN(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_WARNING, __VA_ARGS__)
+#define L_ERROR(...) \
+    celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+struct pubsub_shm_topic_sender {
+    celix_bundle_context_t *ctx;
+    celix_log_helper_t *logHelper;
+    long serializerSvcId;
+    pubsub_serializer_service_t *serializer;
+    long protocolSvcId;
+    pubsub_protocol_service_t *protocol;
+
+    char *scope;
+    char *topic;
+    const char *fwUUID;
+    bool metricsEnabled;
+
+    struct {
+        celix_thread_mutex_t mutex; //serializes the writers of the ring, protects the header buffer and seq nrs
+        pubsub_shm_ring_t *ring;
+        void *headerBuffer;
+        size_t headerBufferSize;
+        void *footerBuffer;
+        size_t footerBufferSize;
+    } shm;
+
+    struct {
+        long svcId;
+        celix_service_factory_t factory;
+    } publisher;
+
+    struct {
+        celix_thread_mutex_t mutex;
+        hash_map_t *map;  //key = bndId, value = psa_shm_bounded_service_entry_t
+    } boundedServices;
+};
+
+typedef struct psa_shm_send_msg_entry {
+    pubsub_msg_serializer_t *msgSer;
+    uint16_t major;
+    uint16_t minor;
+    uint32_t seqNr; //protected by shm.mutex
+    pubsub_admin_metrics_send_counters_t metrics; //only initialized if metrics are enabled
+} psa_shm_send_msg_entry_t;
+
+typedef struct psa_shm_bounded_service_entry {
+    pubsub_shm_topic_sender_t *parent;
+    pubsub_publisher_t service;
+    long bndId;
+    hash_map_t *msgTypes; //key = msg type id, value = pubsub_msg_serializer_t
+    hash_map_t *msgTypeIds; //key = msg name, value = msg type id
+    hash_map_t *msgEntries; //key = msg type id, value = psa_shm_send_msg_entry_t
+    int getCount;
+} psa_shm_bounded_service_entry_t;
+
+static char* psa_shm_createShmName(const char *fwUUID, const char *scope, const char *topic);
+static int psa_shm_localMsgTypeIdForMsgType(void* handle, const char* msgType, unsigned int* msgTypeId);
+static void* psa_shm_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
+static void psa_shm_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
+static void psa_shm_destroyBoundedServiceEntry(pubsub_shm_topic_sender_t *sender, psa_shm_bounded_service_entry_t *entry);
+
+static int psa_shm_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *msg, celix_properties_t *metadata);
+static int psa_shm_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
+
+pubsub_shm_topic_sender_t* pubsub_shmTopicSender_create(
+        celix_bundle_context_t *ctx,
+        celix_log_helper_t *logHelper,
+        const char *scope,
+        const char *topic,
+        const celix_properties_t *topicProperties,
+        long serializerSvcId,
+        pubsub_serializer_service_t *ser,
+        long protocolSvcId,
+        pubsub_protocol_service_t *prot) {
+    pubsub_shm_topic_sender_t *sender = calloc(1, sizeof(*sender));
+    sender->ctx = ctx;
+    sender->logHelper = logHelper;
+    sender->serializerSvcId = serializerSvcId;
+    sender->serializer = ser;
+    sender->protocolSvcId = protocolSvcId;
+    sender->protocol = prot;
+    sender->scope = scope == NULL ? NULL : strndup(scope, 1024 * 1024);
+    sender->topic = strndup(topic, 1024 * 1024);
+    sender->fwUUID = celix_bundleContext_getProperty(ctx, OSGI_FRAMEWORK_FRAMEWORK_UUID, "");
+    sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_SHM_METRICS_ENABLED, PSA_SHM_DEFAULT_METRICS_ENABLED);
+
+    //the protocol header is written in front of every message, header-less protocols are not supported.
+    size_t footerSize = 0;
+    prot->getHeaderBufferSize(prot->handle, &sender->shm.headerBufferSize);
+    prot->getFooterSize(prot->handle, &footerSize);
+    if (sender->shm.headerBufferSize > 0) {
+        sender->shm.headerBuffer = calloc(1, sender->shm.headerBufferSize);
+        sender->shm.footerBufferSize = footerSize;
+        sender->shm.footerBuffer = footerSize > 0 ? calloc(1, footerSize) : NULL;
+    } else {
+        L_ERROR("[PSA_SHM] Cannot use a protocol without a header buffer for TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+    }
+
+    if (sender->shm.headerBuffer != NULL) {
+        long ringSize = celix_bundleContext_getPropertyAsLong(ctx, PSA_SHM_RING_SIZE, PSA_SHM_DEFAULT_RING_SIZE);
+        if (topicProperties != NULL) {
+            ringSize = celix_properties_getAsLong(topicProperties, PUBSUB_SHM_RING_SIZE_KEY, ringSize);
+        }
+        char *name = psa_shm_createShmName(sender->fwUUID, scope, topic);
+        sender->shm.ring = pubsub_shmRing_create(name, ringSize > 0 ? (size_t)ringSize : PSA_SHM_DEFAULT_RING_SIZE);
+        if (sender->shm.ring == NULL) {
+            L_ERROR("[PSA_SHM] Cannot create shared memory '%s' for TopicSender %s/%s. %s", name, sender->scope == NULL ? "(null)" : sender->scope, sender->topic, strerror(errno));
+        }
+        free(name);
+    }
+
+    if (sender->shm.ring != NULL) {
+        celixThreadMutex_create(&sender->shm.mutex, NULL);
+        celixThreadMutex_create(&sender->boundedServices.mutex, NULL);
+        sender->boundedServices.map = hashMap_create(NULL, NULL, NULL, NULL);
+
+        //register publisher services using a service factory
+        sender->publisher.factory.handle = sender;
+        sender->publisher.factory.getService = psa_shm_getPublisherService;
+        sender->publisher.factory.ungetService = psa_shm_ungetPublisherService;
+
+        celix_properties_t *props = celix_properties_create();
+        celix_properties_set(props, PUBSUB_PUBLISHER_TOPIC, sender->topic);
+        if (sender->scope != NULL) {
+            celix_properties_set(props, PUBSUB_PUBLISHER_SCOPE, sender->scope);
+        }
+
+        celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
+        opts.factory = &sender->publisher.factory;
+        opts.serviceName = PUBSUB_PUBLISHER_SERVICE_NAME;
+        opts.serviceVersion = PUBSUB_PUBLISHER_SERVICE_VERSION;
+        opts.properties = props;
+
+        sender->publisher.svcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+    } else {
+        free(sender->shm.headerBuffer);
+        free(sender->shm.footerBuffer);
+        free(sender->scope);
+        free(sender->topic);
+        free(sender);
+        sender = NULL;
+    }
+
+    return sender;
+}
+
+void pubsub_shmTopicSender_destroy(pubsub_shm_topic_sender_t *sender) {
+    if (sender != NULL) {
+        celix_bundleContext_unregisterService(sender->ctx, sender->publisher.svcId);
+
+        celixThreadMutex_lock(&sender->boundedServices.mutex);
+        hash_map_iterator_t iter = hashMapIterator_construct(sender->boundedServices.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_shm_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (entry != NULL) {
+                psa_shm_destroyBoundedServiceEntry(sender, entry);
+            }
+        }
+        hashMap_destroy(sender->boundedServices.map, false, false);
+        celixThreadMutex_unlock(&sender->boundedServices.mutex);
+        celixThreadMutex_destroy(&sender->boundedServices.mutex);
+
+        pubsub_shmRing_destroy(sender->shm.ring);
+        celixThreadMutex_destroy(&sender->shm.mutex);
+        free(sender->shm.headerBuffer);
+        free(sender->shm.footerBuffer);
+
+        free(sender->scope);
+        free(sender->topic);
+        free(sender);
+    }
+}
+
+long pubsub_shmTopicSender_serializerSvcId(pubsub_shm_topic_sender_t *sender) {
+    return sender->serializerSvcId;
+}
+
+long pubsub_shmTopicSender_protocolSvcId(pubsub_shm_topic_sender_t *sender) {
+    return sender->protocolSvcId;
+}
+
+const char* pubsub_shmTopicSender_scope(pubsub_shm_topic_sender_t *sender) {
+    return sender->scope;
+}
+
+const char* pubsub_shmTopicSender_topic(pubsub_shm_topic_sender_t *sender) {
+    return sender->topic;
+}
+
+const char* pubsub_shmTopicSender_shmName(pubsub_shm_topic_sender_t *sender) {
+    return pubsub_shmRing_name(sender->shm.ring);
+}
+
+size_t pubsub_shmTopicSender_maxMessageSize(pubsub_shm_topic_sender_t *sender) {
+    return pubsub_shmRing_maxRecordSize(sender->shm.ring);
+}
+
+/**
+ * Creates a shm name unique for the framework and scope/topic, e.g. /celix_<fw uuid>_<hash>_<scope>_<topic>.
+ * Characters not allowed (or not portable) in shm names are replaced with a '_'.
+ */
+static char* psa_shm_createShmName(const char *fwUUID, const char *scope, const char *topic) {
+    char *key = pubsubEndpoint_createScopeTopicKey(scope, topic);
+    char *name = NULL;
+    asprintf(&name, "/celix_%s_%08x_%s_%s", fwUUID, utils_stringHash(key), scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : scope, topic);
+    free(key);
+    for (char *c = name + 1; *c != '\0'; ++c) {
+        if (!isalnum((unsigned char)*c) && *c != '_' && *c != '-' && *c != '.') {
+            *c = '_';
+        }
+    }
+    if (strlen(name) > PSA_SHM_NAME_MAX_LENGTH) {
+        name[PSA_SHM_NAME_MAX_LENGTH] = '\0';
+    }
+    return name;
+}
+
+static int psa_shm_localMsgTypeIdForMsgType(void* handle, const char* msgType, unsigned int* msgTypeId) {
+    psa_shm_bounded_service_entry_t *entry = (psa_shm_bounded_service_entry_t *) handle;
+    *msgTypeId = (unsigned int)(uintptr_t) hashMap_get(entry->msgTypeIds, msgType);
+    return 0;
+}
+
+static void* psa_shm_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties __attribute__((unused))) {
+    pubsub_shm_topic_sender_t *sender = handle;
+    long bndId = celix_bundle_getId(requestingBundle);
+    void *svc = NULL;
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    psa_shm_bounded_service_entry_t *entry = hashMap_get(sender->boundedServices.map, (void*)bndId);
+    if (entry != NULL) {
+        entry->getCount += 1;
+        svc = &entry->service;
+    } else {
+        entry = calloc(1, sizeof(*entry));
+        entry->getCount = 1;
+        entry->parent = sender;
+        entry->bndId = bndId;
+        entry->msgTypeIds = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+        entry->msgEntries = hashMap_create(NULL, NULL, NULL, NULL);
+
+        int rc = sender->serializer->createSerializerMap(sender->serializer->handle, (celix_bundle_t*)requestingBundle, &entry->msgTypes);
+        if (rc == 0) {
+            hash_map_iterator_t iter = hashMapIterator_construct(entry->msgTypes);
+            while (hashMapIterator_hasNext(&iter)) {
+                pubsub_msg_serializer_t *msgSer = hashMapIterator_nextValue(&iter);
+                psa_shm_send_msg_entry_t *sendEntry = calloc(1, sizeof(*sendEntry));
+                int major = 0;
+                int minor = 0;
+                if (msgSer->msgVersion != NULL) {
+                    version_getMajor(msgSer->msgVersion, &major);
+                    version_getMinor(msgSer->msgVersion, &minor);
+                }
+                sendEntry->msgSer = msgSer;
+                sendEntry->major = (uint16_t)major;
+                sendEntry->minor = (uint16_t)minor;
+                if (sender->metricsEnabled) {
+                    pubsub_metricsSendCounters_init(&sendEntry->metrics);
+                }
+                hashMap_put(entry->msgEntries, (void *)(uintptr_t) msgSer->msgId, sendEntry);
+                hashMap_put(entry->msgTypeIds, strndup(msgSer->msgName, 1024), (void *)(uintptr_t) msgSer->msgId);
+            }
+            entry->service.handle = entry;
+            entry->service.localMsgTypeIdForMsgType = psa_shm_localMsgTypeIdForMsgType;
+            entry->service.send = psa_shm_topicPublicationSend;
+            entry->service.sendMany = psa_shm_topicPublicationSendMany;
+            hashMap_put(sender->boundedServices.map, (void*)bndId, entry);
+            svc = &entry->service;
+        } else {
+            L_ERROR("[PSA_SHM] Error creating serializer map for shm TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+            hashMap_destroy(entry->msgEntries, false, false);
+            hashMap_destroy(entry->msgTypeIds, false, false);
+            free(entry);
+        }
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+
+    return svc;
+}
+
+static void psa_shm_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties __attribute__((unused))) {
+    pubsub_shm_topic_sender_t *sender = handle;
+    long bndId = celix_bundle_getId(requestingBundle);
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    psa_shm_bounded_service_entry_t *entry = hashMap_get(sender->boundedServices.map, (void*)bndId);
+    if (entry != NULL) {
+        entry->getCount -= 1;
+    }
+    if (entry != NULL && entry->getCount == 0) {
+        hashMap_remove(sender->boundedServices.map, (void*)bndId);
+        psa_shm_destroyBoundedServiceEntry(sender, entry);
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+}
+
+static void psa_shm_destroyBoundedServiceEntry(pubsub_shm_topic_sender_t *sender, psa_shm_bounded_service_entry_t *entry) {
+    int rc = sender->serializer->destroySerializerMap(sender->serializer->handle, entry->msgTypes);
+    if (rc != 0) {
+        L_ERROR("[PSA_SHM] Error destroying publisher service, serializer not available / cannot get msg serializer map");
+    }
+    hash_map_iterator_t iter = hashMapIterator_construct(entry->msgEntries);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_shm_send_msg_entry_t *sendEntry = hashMapIterator_nextValue(&iter);
+        if (sender->metricsEnabled) {
+            pubsub_metricsSendCounters_deinit(&sendEntry->metrics);
+        }
+    }
+    hashMap_destroy(entry->msgEntries, false, true);
+    hashMap_destroy(entry->msgTypeIds, true, false);
+    free(entry);
+}
+
+static int psa_shm_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
+    int status = CELIX_SUCCESS;
+    psa_shm_bounded_service_entry_t *bound = handle;
+    pubsub_shm_topic_sender_t *sender = bound->parent;
+    psa_shm_send_msg_entry_t *entry = hashMap_get(bound->msgEntries, (void*)(uintptr_t)msgTypeId);
+
+    if (entry != NULL) {
+        bool monitor = sender->metricsEnabled;
+        struct timespec serializationStart;
+        struct timespec serializationEnd;
+        if (monitor) {
+            clock_gettime(CLOCK_REALTIME, &serializationStart);
+        }
+        struct iovec *serializedIoVecOutput = NULL;
+        size_t serializedIoVecOutputLen = 0;
+        status = entry->msgSer->serialize(entry->msgSer->handle, inMsg, &serializedIoVecOutput, &serializedIoVecOutputLen);
+        if (monitor) {
+            clock_gettime(CLOCK_REALTIME, &serializationEnd);
+        }
+        if (status == CELIX_SUCCESS) {
+            if (monitor) {
+                metadata = pubsub_metrics_addSendMetadata(metadata, sender->fwUUID, &serializationStart);
+            }
+            pubsub_protocol_message_t message;
+            memset(&message, 0, sizeof(message));
+            message.metadata.metadata = metadata;
+            size_t payloadSize = 0;
+            for (size_t i = 0; i < serializedIoVecOutputLen; ++i) {
+                payloadSize += serializedIoVecOutput[i].iov_len;
+            }
+            message.header.msgId = msgTypeId;
+            message.header.msgMajorVersion = entry->major;
+            message.header.msgMinorVersion = entry->minor;
+            message.header.payloadSize = (uint32_t)payloadSize;
+            message.header.payloadPartSize = (uint32_t)payloadSize;
+            message.header.payloadOffset = 0;
+            message.header.isLastSegment = 1;
+            message.header.convertEndianess = 0;
+
+            void *metadataData = NULL;
+            size_t metadataSize = 0;
+            if (metadata != NULL && celix_properties_size(metadata) > 0) {
+                sender->protocol->encodeMetadata(sender->protocol->handle, &message, &metadataData, &metadataSize);
+            }
+            message.header.metadataSize = (uint32_t)metadataSize;
+
+            //record layout: protocol header | serialized payload | protocol metadata | protocol footer
+            struct iovec iov[serializedIoVecOutputLen + 3];
+            size_t iovLen = 1;
+            for (size_t i = 0; i < serializedIoVecOutputLen; ++i) {
+                iov[iovLen++] = serializedIoVecOutput[i];
+            }
+            if (metadataSize > 0) {
+                iov[iovLen].iov_base = metadataData;
+                iov[iovLen++].iov_len = metadataSize;
+            }
+
+            celixThreadMutex_lock(&sender->shm.mutex);
+            message.header.seqNr = entry->seqNr++;
+            void *headerData = sender->shm.headerBuffer;
+            size_t headerSize = 0;
+            sender->protocol->encodeHeader(sender->protocol->handle, &message, &headerData, &headerSize);
+            iov[0].iov_base = headerData;
+            iov[0].iov_len = headerSize;
+            if (sender->shm.footerBuffer != NULL) {
+                void *footerData = sender->shm.footerBuffer;
+                size_t footerSize = 0;
+                sender->protocol->encodeFooter(sender->protocol->handle, &message, &footerData, &footerSize);
+                iov[iovLen].iov_base = footerData;
+                iov[iovLen++].iov_len = footerSize;
+            }
+            status = pubsub_shmRing_write(sender->shm.ring, iov, iovLen);
+            celixThreadMutex_unlock(&sender->shm.mutex);
+
+            if (status != CELIX_SUCCESS) {
+                L_WARN("[PSA_SHM_TS] Error sending msg type %s for scope/topic %s/%s. Message is larger than the max message size of %zu bytes",
+                       entry->msgSer->msgName, sender->scope == NULL ? "(null)" : sender->scope, sender->topic, pubsub_shmRing_maxRecordSize(sender->shm.ring));
+            }
+            free(metadataData);
+            entry->msgSer->freeSerializeMsg(entry->msgSer->handle, serializedIoVecOutput, serializedIoVecOutputLen);
+            if (monitor) {
+                bool sendOk = status == CELIX_SUCCESS;
+                pubsub_metricsSendCounters_update(&entry->metrics, &serializationStart, &serializationEnd, sendOk ? 1 : 0, sendOk ? 0 : 1, 0);
+            }
+        } else {
+            L_WARN("[PSA_SHM_TS] Error serialize message of type %s for scope/topic %s/%s", entry->msgSer->msgName,
+                   sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+            if (monitor) {
+                pubsub_metricsSendCounters_update(&entry->metrics, &serializationStart, &serializationEnd, 0, 0, 1);
+            }
+        }
+    } else {
+        L_WARN("[PSA_SHM_TS] Error cannot serialize message with msg type id %i for scope/topic %s/%s", msgTypeId,
+               sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+        status = CELIX_SERVICE_EXCEPTION;
+    }
+
+    if (metadata != NULL) {
+        celix_properties_destroy(metadata);
+    }
+    return status;
+}
+
+static int psa_shm_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    int status = CELIX_SUCCESS;
+    for (size_t i = 0; i < nrOfMsgs; ++i) {
+        int rc = psa_shm_topicPublicationSend(handle, msgs[i].msgTypeId, msgs[i].msg, msgs[i].metadata);
+        if (status == CELIX_SUCCESS) {
+            status = rc;
+        }
+    }
+    return status;
+}
+
+pubsub_admin_sender_metrics_t* pubsub_shmTopicSender_metrics(pubsub_shm_topic_sender_t *sender) {
+    if (!sender->metricsEnabled) {
+        return NULL;
+    }
+    pubsub_admin_sender_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : sender->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->topic);
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    unsigned int count = 0;
+    hash_map_iterator_t iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_shm_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        count += (unsigned int)hashMap_size(entry->msgEntries);
+    }
+    result->msgMetrics = calloc(count, sizeof(*result->msgMetrics));
+    unsigned int i = 0;
+    iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter) && result->msgMetrics != NULL) {
+        psa_shm_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgEntries);
+        while (hashMapIterator_hasNext(&iter2)) {
+            psa_shm_send_msg_entry_t *sendEntry = hashMapIterator_nextValue(&iter2);
+            pubsub_metricsSendCounters_fill(&sendEntry->metrics, &result->msgMetrics[i]);
+            result->msgMetrics[i].bndId = entry->bndId;
+            result->msgMetrics[i].typeId = sendEntry->msgSer->msgId;
+            snprintf(result->msgMetrics[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sendEntry->msgSer->msgName);
+            i += 1;
+        }
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+    result->nrOfmsgMetrics = result->msgMetrics == NULL ? 0 : i;
+    return result;
+}
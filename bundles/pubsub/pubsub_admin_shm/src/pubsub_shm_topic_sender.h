@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_SHM_TOPIC_SENDER_H
+#define CELIX_PUBSUB_SHM_TOPIC_SENDER_H
+
+#include "celix_bundle_context.h"
+#include "celix_log_helper.h"
+#include "pubsub_serializer.h"
+#include "pubsub_protocol.h"
+#include "pubsub_admin_metrics.h"
+
+typedef struct pubsub_shm_topic_sender pubsub_shm_topic_sender_t;
+
+pubsub_shm_topic_sender_t* pubsub_shmTopicSender_create(
+        celix_bundle_context_t *ctx,
+        celix_log_helper_t *logHelper,
+        const char *scope,
+        const char *topic,
+        const celix_properties_t *topicProperties,
+        long serializerSvcId,
+        pubsub_serializer_service_t *ser,
+        long protocolSvcId,
+        pubsub_protocol_service_t *prot);
+void pubsub_shmTopicSender_destroy(pubsub_shm_topic_sender_t *sender);
+
+const char* pubsub_shmTopicSender_scope(pubsub_shm_topic_sender_t *sender);
+const char* pubsub_shmTopicSender_topic(pubsub_shm_topic_sender_t *sender);
+
+/**
+ * The name of the shared memory object the topic sender writes the messages to.
+ */
+const char* pubsub_shmTopicSender_shmName(pubsub_shm_topic_sender_t *sender);
+size_t pubsub_shmTopicSender_maxMessageSize(pubsub_shm_topic_sender_t *sender);
+
+long pubsub_shmTopicSender_serializerSvcId(pubsub_shm_topic_sender_t *sender);
+long pubsub_shmTopicSender_protocolSvcId(pubsub_shm_topic_sender_t *sender);
+
+/**
+ * Returns the send metrics per msg type/bundle or NULL if metrics are not enabled.
+ */
+pubsub_admin_sender_metrics_t* pubsub_shmTopicSender_metrics(pubsub_shm_topic_sender_t *sender);
+
+#endif //CELIX_PUBSUB_SHM_TOPIC_SENDER_H
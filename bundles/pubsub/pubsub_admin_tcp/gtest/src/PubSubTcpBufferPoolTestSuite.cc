@@ -0,0 +1,151 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "pubsub_tcp_buffer_pool.h"
+
+class PubSubTcpBufferPoolTestSuite : public ::testing::Test {
+public:
+    PubSubTcpBufferPoolTestSuite() : pool{pubsub_tcpBufferPool_create(1024 * 1024)} {}
+    ~PubSubTcpBufferPoolTestSuite() override {
+        pubsub_tcpBufferPool_destroy(pool);
+    }
+    PubSubTcpBufferPoolTestSuite(const PubSubTcpBufferPoolTestSuite&) = delete;
+    PubSubTcpBufferPoolTestSuite& operator=(const PubSubTcpBufferPoolTestSuite&) = delete;
+
+    pubsub_tcp_buffer_pool_t* pool;
+};
+
+TEST_F(PubSubTcpBufferPoolTestSuite, AcquireRoundsUpToSizeClass) {
+    ASSERT_NE(nullptr, pool);
+    const std::pair<size_t, size_t> sizes[] = {
+            {0, 64}, {1, 64}, {64, 64}, {65, 128}, {128, 128}, {1000, 1024}, {4096, 4096}, {4097, 8192},
+            {16 * 1024 * 1024, 16 * 1024 * 1024}
+    };
+    for (const auto& size : sizes) {
+        size_t capacity = 0;
+        void* buffer = pubsub_tcpBufferPool_acquire(pool, size.first, &capacity);
+        ASSERT_NE(nullptr, buffer);
+        EXPECT_EQ(size.second, capacity) << "for size " << size.first;
+        pubsub_tcpBufferPool_release(pool, buffer, capacity);
+    }
+}
+
+TEST_F(PubSubTcpBufferPoolTestSuite, ReleasedBufferIsReusedForTheSameSize) {
+    size_t capacity = 0;
+    void* buffer = pubsub_tcpBufferPool_acquire(pool, 100, &capacity);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(128, capacity);
+    pubsub_tcpBufferPool_release(pool, buffer, capacity);
+
+    //all sizes of the same size class get the cached buffer
+    size_t capacity2 = 0;
+    void* buffer2 = pubsub_tcpBufferPool_acquire(pool, 100, &capacity2);
+    EXPECT_EQ(buffer, buffer2);
+    EXPECT_EQ(capacity, capacity2);
+    pubsub_tcpBufferPool_release(pool, buffer2, capacity2);
+
+    buffer2 = pubsub_tcpBufferPool_acquire(pool, 128, &capacity2);
+    EXPECT_EQ(buffer, buffer2);
+    pubsub_tcpBufferPool_release(pool, buffer2, capacity2);
+
+    buffer2 = pubsub_tcpBufferPool_acquire(pool, 65, &capacity2);
+    EXPECT_EQ(buffer, buffer2);
+    pubsub_tcpBufferPool_release(pool, buffer2, capacity2);
+}
+
+TEST_F(PubSubTcpBufferPoolTestSuite, ReleaseWithSmallerCapacityCachesInSmallerClass) {
+    size_t capacity = 0;
+    void* buffer = pubsub_tcpBufferPool_acquire(pool, 100, &capacity);
+    ASSERT_NE(nullptr, buffer);
+    pubsub_tcpBufferPool_release(pool, buffer, 100); //e.g. the data length instead of the capacity
+
+    //the buffer is cached in the 64 byte size class, so it is only reused for sizes <= 64
+    size_t capacity2 = 0;
+    void* buffer2 = pubsub_tcpBufferPool_acquire(pool, 64, &capacity2);
+    EXPECT_EQ(buffer, buffer2);
+    EXPECT_EQ(64, capacity2);
+    pubsub_tcpBufferPool_release(pool, buffer2, capacity2);
+}
+
+TEST_F(PubSubTcpBufferPoolTestSuite, LargeBuffersAreNotPooled) {
+    size_t size = 16 * 1024 * 1024 + 1;
+    size_t capacity = 0;
+    void* buffer = pubsub_tcpBufferPool_acquire(pool, size, &capacity);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(size, capacity);
+    pubsub_tcpBufferPool_release(pool, buffer, capacity); //freed, not cached in the largest size class
+
+    //the largest size class is still empty, so a new buffer of the largest size class is allocated
+    size_t capacity2 = 0;
+    void* buffer2 = pubsub_tcpBufferPool_acquire(pool, 16 * 1024 * 1024, &capacity2);
+    ASSERT_NE(nullptr, buffer2);
+    EXPECT_EQ(16 * 1024 * 1024, capacity2);
+    pubsub_tcpBufferPool_release(pool, buffer2, capacity2);
+}
+
+TEST_F(PubSubTcpBufferPoolTestSuite, PoolIsBoundedByMaxCachedBytes) {
+    pubsub_tcpBufferPool_setMaxCachedBytes(pool, 256);
+    size_t capacity = 0;
+    void* buffers[3];
+    for (auto& buffer : buffers) {
+        buffer = pubsub_tcpBufferPool_acquire(pool, 128, &capacity);
+        ASSERT_NE(nullptr, buffer);
+    }
+    for (auto& buffer : buffers) {
+        pubsub_tcpBufferPool_release(pool, buffer, capacity); //the last buffer does not fit and is freed
+    }
+
+    //the cached buffers are returned in LIFO order
+    size_t capacity2 = 0;
+    void* buffer1 = pubsub_tcpBufferPool_acquire(pool, 128, &capacity2);
+    void* buffer2 = pubsub_tcpBufferPool_acquire(pool, 128, &capacity2);
+    EXPECT_EQ(buffers[1], buffer1);
+    EXPECT_EQ(buffers[0], buffer2);
+    pubsub_tcpBufferPool_release(pool, buffer1, capacity2);
+    pubsub_tcpBufferPool_release(pool, buffer2, capacity2);
+}
+
+TEST_F(PubSubTcpBufferPoolTestSuite, AllocationFailure) {
+    size_t capacity = 42;
+    void* buffer = pubsub_tcpBufferPool_acquire(pool, SIZE_MAX / 2, &capacity);
+    EXPECT_EQ(nullptr, buffer);
+    EXPECT_EQ(0, capacity);
+
+    //releasing a failed acquire is ignored
+    pubsub_tcpBufferPool_release(pool, buffer, capacity);
+    pubsub_tcpBufferPool_release(pool, nullptr, 128);
+
+    //the pool is still usable
+    buffer = pubsub_tcpBufferPool_acquire(pool, 128, &capacity);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(128, capacity);
+    pubsub_tcpBufferPool_release(pool, buffer, capacity);
+}
+
+TEST_F(PubSubTcpBufferPoolTestSuite, AcquiredBufferCanBeFreed) {
+    size_t capacity = 0;
+    void* buffer = pubsub_tcpBufferPool_acquire(pool, 200, &capacity);
+    ASSERT_NE(nullptr, buffer);
+    free(buffer); //e.g. when the ownership is handed over to a deserialized message
+}
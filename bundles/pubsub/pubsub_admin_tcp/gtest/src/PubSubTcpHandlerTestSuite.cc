@@ -0,0 +1,238 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "celix_framework.h"
+#include "celix_framework_factory.h"
+#include "celix_log_helper.h"
+#include "pubsub_tcp_handler.h"
+#include "pubsub_wire_v2_protocol_impl.h"
+
+static const size_t MSG_PAYLOAD_SIZE = 1024;
+
+class PubSubTcpHandlerTestSuite : public ::testing::Test {
+public:
+    PubSubTcpHandlerTestSuite() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        celix_properties_set(props, "org.osgi.framework.storage.clean", "onFirstInit");
+        celix_properties_set(props, "org.osgi.framework.storage", ".pubsub_tcp_handler_test_cache");
+        fw = celix_frameworkFactory_createFramework(props);
+        logHelper = celix_logHelper_create(celix_framework_getFrameworkContext(fw), "PubSubTcpHandlerTest");
+
+        pubsubProtocol_wire_v2_create(&wireProtocol);
+        protocolSvc.handle = wireProtocol;
+        protocolSvc.getHeaderSize = pubsubProtocol_wire_v2_getHeaderSize;
+        protocolSvc.getHeaderBufferSize = pubsubProtocol_wire_v2_getHeaderBufferSize;
+        protocolSvc.getSyncHeaderSize = pubsubProtocol_wire_v2_getSyncHeaderSize;
+        protocolSvc.getSyncHeader = pubsubProtocol_wire_v2_getSyncHeader;
+        protocolSvc.getFooterSize = pubsubProtocol_wire_v2_getFooterSize;
+        protocolSvc.isMessageSegmentationSupported = pubsubProtocol_wire_v2_isMessageSegmentationSupported;
+        protocolSvc.encodeHeader = pubsubProtocol_wire_v2_encodeHeader;
+        protocolSvc.encodePayload = pubsubProtocol_wire_v2_encodePayload;
+        protocolSvc.encodeMetadata = pubsubProtocol_wire_v2_encodeMetadata;
+        protocolSvc.encodeFooter = pubsubProtocol_wire_v2_encodeFooter;
+        protocolSvc.decodeHeader = pubsubProtocol_wire_v2_decodeHeader;
+        protocolSvc.decodePayload = pubsubProtocol_wire_v2_decodePayload;
+        protocolSvc.decodeMetadata = pubsubProtocol_wire_v2_decodeMetadata;
+        protocolSvc.decodeFooter = pubsubProtocol_wire_v2_decodeFooter;
+        pubsubProtocol_wire_v2_getHeaderSize(wireProtocol, &headerSize);
+        pubsubProtocol_wire_v2_getFooterSize(wireProtocol, &footerSize);
+
+        handler = pubsub_tcpHandler_create(&protocolSvc, logHelper);
+        pubsub_tcpHandler_addAcceptConnectionCallback(handler, this, [](void* handle, const char*) {
+            auto* suite = static_cast<PubSubTcpHandlerTestSuite*>(handle);
+            std::lock_guard<std::mutex> lck{suite->mutex};
+            suite->nrOfAcceptedConnections++;
+            suite->cond.notify_all();
+        }, [](void*, const char*) {});
+    }
+
+    ~PubSubTcpHandlerTestSuite() override {
+        if (clientFd >= 0) {
+            close(clientFd);
+        }
+        pubsub_tcpHandler_destroy(handler);
+        pubsubProtocol_wire_v2_destroy(wireProtocol);
+        celix_logHelper_destroy(logHelper);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    PubSubTcpHandlerTestSuite(const PubSubTcpHandlerTestSuite&) = delete;
+    PubSubTcpHandlerTestSuite& operator=(const PubSubTcpHandlerTestSuite&) = delete;
+
+    /**
+     * Listens on a loopback port and connects a raw subscriber socket with a small receive buffer, which is not
+     * read until readMessages is called (i.e. a slow subscriber).
+     */
+    void connectSlowSubscriber() {
+        ASSERT_GE(pubsub_tcpHandler_listen(handler, (char*)"tcp://127.0.0.1:0"), 0);
+        char* url = pubsub_tcpHandler_get_interface_url(handler);
+        ASSERT_NE(nullptr, url);
+        std::string urlStr{url};
+        free(url);
+        int port = std::stoi(urlStr.substr(urlStr.rfind(':') + 1));
+
+        clientFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        ASSERT_GE(clientFd, 0);
+        int rcvBuf = 4096;
+        setsockopt(clientFd, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+        struct sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(0, connect(clientFd, (struct sockaddr*)&addr, sizeof(addr)));
+
+        std::unique_lock<std::mutex> lck{mutex};
+        ASSERT_TRUE(cond.wait_for(lck, std::chrono::seconds{5}, [this]{ return nrOfAcceptedConnections > 0; }));
+    }
+
+    int writeMessage(uint32_t seqNr) {
+        std::vector<char> data(MSG_PAYLOAD_SIZE, 'x');
+        memcpy(data.data(), &seqNr, sizeof(seqNr));
+        pubsub_protocol_message_t message{};
+        message.header.msgId = 42;
+        message.header.msgMajorVersion = 1;
+        message.header.seqNr = seqNr;
+        //two io vectors, so that the payload is not encoded by the protocol
+        struct iovec iov[2];
+        iov[0].iov_base = data.data();
+        iov[0].iov_len = sizeof(seqNr);
+        iov[1].iov_base = data.data() + sizeof(seqNr);
+        iov[1].iov_len = data.size() - sizeof(seqNr);
+        return pubsub_tcpHandler_write(handler, &message, iov, 2, 0);
+    }
+
+    /**
+     * Reads the subscriber socket until no data is received for the idle time and returns the sequence numbers of
+     * the received messages. Fails if the stream contains a corrupt (e.g. partially dropped) message.
+     */
+    std::vector<uint32_t> readMessages(std::chrono::milliseconds idle = std::chrono::milliseconds{500}) {
+        struct timeval tv{};
+        tv.tv_sec = 0;
+        tv.tv_usec = (long)std::chrono::duration_cast<std::chrono::microseconds>(idle).count();
+        setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        char buf[64 * 1024];
+        while (true) {
+            ssize_t n = recv(clientFd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                break;
+            }
+            stream.insert(stream.end(), buf, buf + n);
+        }
+
+        std::vector<uint32_t> seqNrs{};
+        size_t msgSize = headerSize + MSG_PAYLOAD_SIZE + footerSize;
+        size_t offset = 0;
+        while (stream.size() - offset >= msgSize) {
+            pubsub_protocol_message_t message{};
+            bool valid = pubsubProtocol_wire_v2_decodeHeader(wireProtocol, &stream[offset], headerSize, &message) == CELIX_SUCCESS &&
+                         message.header.payloadSize == MSG_PAYLOAD_SIZE && message.header.metadataSize == 0 &&
+                         pubsubProtocol_wire_v2_decodeFooter(wireProtocol, &stream[offset + msgSize - footerSize], footerSize, &message) == CELIX_SUCCESS;
+            EXPECT_TRUE(valid) << "corrupt message at offset " << offset << " after " << seqNrs.size() << " messages";
+            if (!valid) {
+                break;
+            }
+            uint32_t seqNr = 0;
+            memcpy(&seqNr, &stream[offset + headerSize], sizeof(seqNr));
+            EXPECT_EQ(message.header.seqNr, seqNr);
+            seqNrs.push_back(seqNr);
+            offset += msgSize;
+        }
+        stream.erase(stream.begin(), stream.begin() + (long)offset);
+        EXPECT_TRUE(stream.empty()) << "partial message of " << stream.size() << " bytes received";
+        return seqNrs;
+    }
+
+    celix_framework_t* fw{nullptr};
+    celix_log_helper_t* logHelper{nullptr};
+    pubsub_protocol_wire_v2_t* wireProtocol{nullptr};
+    pubsub_protocol_service_t protocolSvc{};
+    size_t headerSize{0};
+    size_t footerSize{0};
+    pubsub_tcpHandler_t* handler{nullptr};
+    int clientFd{-1};
+    std::vector<char> stream{};
+
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    int nrOfAcceptedConnections{0};
+};
+
+TEST_F(PubSubTcpHandlerTestSuite, SlowSubscriberDropsMessagesAboveHighWatermark) {
+    pubsub_tcpHandler_setSendQueueHighWatermark(handler, 64 * 1024);
+    connectSlowSubscriber();
+
+    //more than the socket buffers and the high watermark can hold, the writes should not block
+    const uint32_t nrOfMessages = 32 * 1024;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nrOfMessages; ++i) {
+        EXPECT_EQ(0, writeMessage(i));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{10});
+
+    //messages are dropped as a whole, the received messages are complete and in order
+    auto seqNrs = readMessages();
+    ASSERT_FALSE(seqNrs.empty());
+    EXPECT_LT(seqNrs.size(), nrOfMessages);
+    EXPECT_EQ(0, seqNrs.front());
+    for (size_t i = 1; i < seqNrs.size(); ++i) {
+        EXPECT_LT(seqNrs[i - 1], seqNrs[i]);
+    }
+
+    //after the send queue is drained, messages are accepted again
+    EXPECT_EQ(0, writeMessage(nrOfMessages));
+    seqNrs = readMessages();
+    ASSERT_EQ(1, seqNrs.size());
+    EXPECT_EQ(nrOfMessages, seqNrs.front());
+}
+
+TEST_F(PubSubTcpHandlerTestSuite, SlowSubscriberQueuesMessagesBelowHighWatermark) {
+    pubsub_tcpHandler_setSendQueueHighWatermark(handler, 128 * 1024 * 1024);
+    connectSlowSubscriber();
+
+    //the messages do not fit in the socket buffers, but do fit below the high watermark -> queued, not dropped
+    const uint32_t nrOfMessages = 32 * 1024;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < nrOfMessages; ++i) {
+        EXPECT_EQ(0, writeMessage(i));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{10});
+
+    std::vector<uint32_t> expected(nrOfMessages);
+    for (uint32_t i = 0; i < nrOfMessages; ++i) {
+        expected[i] = i;
+    }
+    auto seqNrs = readMessages();
+    EXPECT_EQ(nrOfMessages, seqNrs.size());
+    EXPECT_TRUE(expected == seqNrs);
+}
@@ -27,6 +27,10 @@
 #define PSA_TCP_RECV_BUFFER_SIZE                "PSA_TCP_RECV_BUFFER_SIZE"
 #define PSA_TCP_TIMEOUT                         "PSA_TCP_TIMEOUT"
 #define PSA_TCP_SUBSCRIBER_CONNECTION_TIMEOUT   "PSA_TCP_SUBSCRIBER_CONNECTION_TIMEOUT"
+#define PSA_TCP_RECV_THREADS                    "PSA_TCP_RECV_THREADS"
+#define PSA_TCP_SUBSCRIBER_WORKER_THREADS       "PSA_TCP_SUBSCRIBER_WORKER_THREADS"
+#define PSA_TCP_SUBSCRIBER_QUEUE_SIZE           "PSA_TCP_SUBSCRIBER_QUEUE_SIZE"
+#define PSA_TCP_SUBSCRIBER_ORDERING             "PSA_TCP_SUBSCRIBER_ORDERING"
 
 #define PSA_TCP_DEFAULT_BASE_PORT               5501
 #define PSA_TCP_DEFAULT_MAX_PORT                6000
@@ -37,6 +41,29 @@
 #define PSA_TCP_DEFAULT_TIMEOUT                 2000 // 2 seconds
 #define PSA_TCP_SUBSCRIBER_CONNECTION_DEFAULT_TIMEOUT 250 // 250 ms
 
+/**
+ * Number of threads reading the TCP connections of a topic receiver, connections are divided over the threads.
+ */
+#define PSA_TCP_DEFAULT_RECV_THREADS            1
+
+/**
+ * Number of worker threads delivering the received messages of a topic receiver to the subscribers.
+ * If 0, messages are delivered directly on the receiving thread.
+ * If > 0, every subscriber bundle has a bounded queue (PSA_TCP_SUBSCRIBER_QUEUE_SIZE messages) and messages which
+ * do not fit in the queue of a slow subscriber are dropped (and counted in the metrics) for that subscriber only.
+ */
+#define PSA_TCP_DEFAULT_SUBSCRIBER_WORKER_THREADS 0
+#define PSA_TCP_DEFAULT_SUBSCRIBER_QUEUE_SIZE   1024
+
+/**
+ * Ordering of the delivered messages when using worker threads.
+ * "fifo": a subscriber is served by one worker at a time, messages are delivered in receive order.
+ * "none": the messages of a subscriber can be delivered concurrently, the subscriber must be thread safe.
+ */
+#define PSA_TCP_SUBSCRIBER_ORDERING_FIFO        "fifo"
+#define PSA_TCP_SUBSCRIBER_ORDERING_NONE        "none"
+#define PSA_TCP_DEFAULT_SUBSCRIBER_ORDERING     PSA_TCP_SUBSCRIBER_ORDERING_FIFO
+
 #define PSA_TCP_DEFAULT_QOS_SAMPLE_SCORE        30
 #define PSA_TCP_DEFAULT_QOS_CONTROL_SCORE       70
 #define PSA_TCP_DEFAULT_SCORE                   30
@@ -57,6 +84,23 @@
 #define PUBSUB_TCP_SUBSCRIBER_RETRY_CNT_KEY     "PUBSUB_TCP_SUBSCRIBER_RETRY_COUNT"
 #define PUBSUB_TCP_SUBSCRIBER_RETRY_CNT_DEFAULT 5
 
+/**
+ * The maximum number of bytes queued per connection for a slow subscriber. Messages that do not fit in the send
+ * queue of a connection are dropped for that connection. A message is always accepted if nothing is queued.
+ */
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_KEY     "PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HIGH_WATERMARK"
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_DEFAULT (4 * 1024 * 1024)
+
+/**
+ * Message coalescing, when enabled messages are held in the send queue of a connection and written with a single
+ * system call when the coalesce size (in bytes) is queued or the oldest queued message is older than the coalesce
+ * delay (in ms). A coalesce size of 0 disables coalescing. Batches sent with sendMany are always coalesced.
+ */
+#define PUBSUB_TCP_PUBLISHER_COALESCE_SIZE_KEY      "PUBSUB_TCP_PUBLISHER_COALESCE_SIZE"
+#define PUBSUB_TCP_PUBLISHER_COALESCE_SIZE_DEFAULT  0
+#define PUBSUB_TCP_PUBLISHER_COALESCE_DELAY_KEY     "PUBSUB_TCP_PUBLISHER_COALESCE_DELAY"
+#define PUBSUB_TCP_PUBLISHER_COALESCE_DELAY_DEFAULT 1
+
 
 //Time-out settings are only for BLOCKING connections
 #define PUBSUB_TCP_PUBLISHER_SNDTIMEO_KEY       "PUBSUB_TCP_PUBLISHER_SEND_TIMEOUT"
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include "celix_threads.h"
+#include "pubsub_tcp_buffer_pool.h"
+
+#define MIN_SIZE_CLASS_BITS 6   //64 bytes
+#define MAX_SIZE_CLASS_BITS 24  //16MB, larger buffers are not pooled
+#define NR_OF_SIZE_CLASSES (MAX_SIZE_CLASS_BITS - MIN_SIZE_CLASS_BITS + 1)
+
+typedef struct pubsub_tcp_buffer_pool_free_list {
+    void **buffers;
+    size_t size;
+    size_t cap;
+} pubsub_tcp_buffer_pool_free_list_t;
+
+struct pubsub_tcp_buffer_pool {
+    celix_thread_mutex_t mutex; //protects below
+    size_t maxCachedBytes;
+    size_t cachedBytes;
+    pubsub_tcp_buffer_pool_free_list_t freeLists[NR_OF_SIZE_CLASSES];
+};
+
+pubsub_tcp_buffer_pool_t *pubsub_tcpBufferPool_create(size_t maxCachedBytes) {
+    pubsub_tcp_buffer_pool_t *pool = calloc(1, sizeof(*pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    celixThreadMutex_create(&pool->mutex, NULL);
+    pool->maxCachedBytes = maxCachedBytes;
+    return pool;
+}
+
+void pubsub_tcpBufferPool_destroy(pubsub_tcp_buffer_pool_t *pool) {
+    if (pool != NULL) {
+        for (int i = 0; i < NR_OF_SIZE_CLASSES; ++i) {
+            for (size_t k = 0; k < pool->freeLists[i].size; ++k) {
+                free(pool->freeLists[i].buffers[k]);
+            }
+            free(pool->freeLists[i].buffers);
+        }
+        celixThreadMutex_destroy(&pool->mutex);
+        free(pool);
+    }
+}
+
+void pubsub_tcpBufferPool_setMaxCachedBytes(pubsub_tcp_buffer_pool_t *pool, size_t maxCachedBytes) {
+    celixThreadMutex_lock(&pool->mutex);
+    pool->maxCachedBytes = maxCachedBytes;
+    celixThreadMutex_unlock(&pool->mutex);
+}
+
+/**
+ * Returns the index of the smallest size class which fits size, or -1 if the size is too large to be pooled.
+ */
+static int pubsub_tcpBufferPool_sizeClass(size_t size) {
+    int bits = MIN_SIZE_CLASS_BITS;
+    while (bits <= MAX_SIZE_CLASS_BITS && ((size_t)1 << bits) < size) {
+        bits += 1;
+    }
+    return bits <= MAX_SIZE_CLASS_BITS ? bits - MIN_SIZE_CLASS_BITS : -1;
+}
+
+void *pubsub_tcpBufferPool_acquire(pubsub_tcp_buffer_pool_t *pool, size_t size, size_t *capacity) {
+    int sizeClass = pubsub_tcpBufferPool_sizeClass(size);
+    if (sizeClass < 0) {
+        void *buffer = malloc(size);
+        *capacity = buffer == NULL ? 0 : size;
+        return buffer;
+    }
+    size_t classSize = (size_t)1 << (sizeClass + MIN_SIZE_CLASS_BITS);
+    void *buffer = NULL;
+    celixThreadMutex_lock(&pool->mutex);
+    pubsub_tcp_buffer_pool_free_list_t *list = &pool->freeLists[sizeClass];
+    if (list->size > 0) {
+        list->size -= 1;
+        buffer = list->buffers[list->size];
+        pool->cachedBytes -= classSize;
+    }
+    celixThreadMutex_unlock(&pool->mutex);
+    if (buffer == NULL) {
+        buffer = malloc(classSize);
+    }
+    *capacity = buffer == NULL ? 0 : classSize;
+    return buffer;
+}
+
+void pubsub_tcpBufferPool_release(pubsub_tcp_buffer_pool_t *pool, void *buffer, size_t capacity) {
+    if (buffer == NULL) {
+        return;
+    }
+    //largest size class which fits in the buffer, buffers larger than the largest size class are not pooled
+    int sizeClass = -1;
+    if (capacity <= ((size_t)1 << MAX_SIZE_CLASS_BITS)) {
+        for (int bits = MIN_SIZE_CLASS_BITS; bits <= MAX_SIZE_CLASS_BITS && ((size_t)1 << bits) <= capacity; ++bits) {
+            sizeClass = bits - MIN_SIZE_CLASS_BITS;
+        }
+    }
+    bool cached = false;
+    if (sizeClass >= 0) {
+        capacity = (size_t)1 << (sizeClass + MIN_SIZE_CLASS_BITS);
+        celixThreadMutex_lock(&pool->mutex);
+        pubsub_tcp_buffer_pool_free_list_t *list = &pool->freeLists[sizeClass];
+        if (pool->cachedBytes + capacity <= pool->maxCachedBytes) {
+            if (list->size == list->cap) {
+                size_t newCap = list->cap == 0 ? 8 : list->cap * 2;
+                void **buffers = realloc(list->buffers, newCap * sizeof(*buffers));
+                if (buffers != NULL) {
+                    list->buffers = buffers;
+                    list->cap = newCap;
+                }
+            }
+            if (list->size < list->cap) {
+                list->buffers[list->size++] = buffer;
+                pool->cachedBytes += capacity;
+                cached = true;
+            }
+        }
+        celixThreadMutex_unlock(&pool->mutex);
+    }
+    if (!cached) {
+        free(buffer);
+    }
+}
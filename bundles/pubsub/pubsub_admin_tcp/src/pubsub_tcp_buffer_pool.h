@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_TCP_BUFFER_POOL_H
+#define CELIX_PUBSUB_TCP_BUFFER_POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A pool of receive buffers, so that the receive path does not allocate and free a buffer per message.
+ *
+ * Buffers are rounded up to a power of 2 size class and released buffers are kept in a free list per size class, until
+ * the pool holds maxCachedBytes. The buffers are plain heap allocations, so the ownership of an acquired buffer can
+ * be handed over (e.g. to a deserialized message) and freed with free() instead of being released to the pool.
+ * The pool is thread safe.
+ */
+typedef struct pubsub_tcp_buffer_pool pubsub_tcp_buffer_pool_t;
+
+/**
+ * Creates a buffer pool, returns NULL if the pool cannot be allocated.
+ */
+pubsub_tcp_buffer_pool_t *pubsub_tcpBufferPool_create(size_t maxCachedBytes);
+void pubsub_tcpBufferPool_destroy(pubsub_tcp_buffer_pool_t *pool);
+void pubsub_tcpBufferPool_setMaxCachedBytes(pubsub_tcp_buffer_pool_t *pool, size_t maxCachedBytes);
+
+/**
+ * Returns a buffer of at least size bytes. The real size of the buffer is returned in capacity and should be
+ * provided when releasing the buffer.
+ * Returns NULL (and a capacity of 0) if the buffer cannot be allocated.
+ */
+void *pubsub_tcpBufferPool_acquire(pubsub_tcp_buffer_pool_t *pool, size_t size, size_t *capacity);
+
+/**
+ * Releases a buffer acquired from the pool. capacity should be the capacity returned by the acquire, a smaller
+ * capacity results in caching the buffer in a smaller size class (so it will not be reused for its own size).
+ * If the pool is full or the buffer is larger than the largest size class the buffer is freed. NULL buffers are ignored.
+ */
+void pubsub_tcpBufferPool_release(pubsub_tcp_buffer_pool_t *pool, void *buffer, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_PUBSUB_TCP_BUFFER_POOL_H
@@ -49,9 +49,13 @@
 #include "hash_map.h"
 #include "utils.h"
 #include "pubsub_tcp_handler.h"
+#include "pubsub_tcp_buffer_pool.h"
+#include "pubsub_psa_tcp_constants.h"
 
 #define MAX_EVENTS   64
 #define MAX_DEFAULT_BUFFER_SIZE 4u
+#define DEFAULT_RECEIVE_BUFFER_POOL_SIZE (4u * 1024u * 1024u)
+#define MAX_READER_THREADS 16
 
 #if defined(__APPLE__)
 #define MSG_NOSIGNAL (0)
@@ -90,8 +94,26 @@ typedef struct psa_tcp_connection_entry {
     unsigned int metaBufferSize;
     void *metaBuffer;
     unsigned int retryCount;
+    celix_thread_mutex_t writeMutex; // protects the send queue and the write event
+    char *sendQueue;                 // bytes of messages that could not be written directly (slow connection)
+    size_t sendQueueCapacity;
+    size_t sendQueueOffset;          // start of the pending bytes in the send queue
+    size_t sendQueueSize;            // end of the pending bytes in the send queue
+    bool writeEventEnabled;
+    struct timespec sendQueueTime;   // time the oldest held (not yet written) bytes were queued, used for coalescing
+    unsigned long nofDroppedMessages;
+    int efd; // poll fd of the reader thread handling this connection
 } psa_tcp_connection_entry_t;
 
+//
+// Reader thread administration, every reader thread polls its own set of connections
+//
+typedef struct psa_tcp_reader {
+    pubsub_tcpHandler_t *handle;
+    int efd;
+    celix_thread_t thread;
+} psa_tcp_reader_t;
+
 //
 // Handle administration
 //
@@ -102,7 +124,9 @@ struct pubsub_tcpHandler {
     hash_map_t *connection_fd_map;
     hash_map_t *interface_url_map;
     hash_map_t *interface_fd_map;
-    int efd;
+    psa_tcp_reader_t readers[MAX_READER_THREADS];
+    unsigned int nofReaders;
+    unsigned int nextReader; // round robin index used to assign new connections to a reader
     pubsub_tcpHandler_receiverConnectMessage_callback_t receiverConnectMessageCallback;
     pubsub_tcpHandler_receiverConnectMessage_callback_t receiverDisconnectMessageCallback;
     void *receiverConnectPayload;
@@ -113,13 +137,18 @@ struct pubsub_tcpHandler {
     void *processMessagePayload;
     celix_log_helper_t *logHelper;
     pubsub_protocol_service_t *protocol;
+    size_t headerBufferSize;
+    size_t footerSize;
+    size_t sendQueueHighWatermark;
+    size_t coalesceSize;             // 0 = coalescing disabled
+    unsigned int coalesceDelay;      // in ms
     unsigned int bufferSize;
     unsigned int maxNofBuffer;
+    pubsub_tcp_buffer_pool_t *bufferPool; // receive buffers, shared by all connections
     unsigned int maxSendRetryCount;
     unsigned int maxRcvRetryCount;
     double sendTimeout;
     double rcvTimeout;
-    celix_thread_t thread;
     bool running;
 };
 
@@ -134,9 +163,9 @@ static inline psa_tcp_connection_entry_t *
 pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, char *external_url,
                               struct sockaddr_in *addr);
 
-static inline void pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t *entry);
+static inline void pubsub_tcpHandler_freeEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry);
 
-static inline void pubsub_tcpHandler_releaseEntryBuffer(pubsub_tcpHandler_t *handle, int fd, unsigned int index);
+static inline void pubsub_tcpHandler_releaseEntryBuffer(psa_tcp_connection_entry_t *entry);
 
 static inline int pubsub_tcpHandler_readSocket(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, int fd, void* buffer, unsigned int offset, unsigned int size, int flag );
 
@@ -144,7 +173,11 @@ static inline void pubsub_tcpHandler_decodePayload(pubsub_tcpHandler_t *handle,
 
 static inline void pubsub_tcpHandler_connectionHandler(pubsub_tcpHandler_t *handle, int fd);
 
-static inline void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle);
+static inline void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle, int efd, unsigned int timeout);
+
+static inline void pubsub_tcpHandler_flushExpired(pubsub_tcpHandler_t *handle);
+
+static inline int pubsub_tcpHandler_createPoll(void);
 
 static void *pubsub_tcpHandler_thread(void *data);
 
@@ -154,11 +187,11 @@ static void *pubsub_tcpHandler_thread(void *data);
 pubsub_tcpHandler_t *pubsub_tcpHandler_create(pubsub_protocol_service_t *protocol, celix_log_helper_t *logHelper) {
     pubsub_tcpHandler_t *handle = calloc(sizeof(*handle), 1);
     if (handle != NULL) {
-#if defined(__APPLE__)
-        handle->efd = kqueue();
-#else
-        handle->efd = epoll_create1(0);
-#endif
+        handle->bufferPool = pubsub_tcpBufferPool_create(DEFAULT_RECEIVE_BUFFER_POOL_SIZE);
+        if (handle->bufferPool == NULL) {
+            free(handle);
+            return NULL;
+        }
         handle->connection_url_map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
         handle->connection_fd_map = hashMap_create(NULL, NULL, NULL, NULL);
         handle->interface_url_map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
@@ -167,10 +200,16 @@ pubsub_tcpHandler_t *pubsub_tcpHandler_create(pubsub_protocol_service_t *protoco
         handle->logHelper = logHelper;
         handle->protocol = protocol;
         handle->bufferSize = MAX_DEFAULT_BUFFER_SIZE;
-        handle->maxNofBuffer = 1; // Reserved for future Use;
+        handle->maxNofBuffer = 1;
+        handle->sendQueueHighWatermark = PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_DEFAULT;
+        protocol->getHeaderBufferSize(protocol->handle, &handle->headerBufferSize);
+        protocol->getFooterSize(protocol->handle, &handle->footerSize);
         celixThreadRwlock_create(&handle->dbLock, 0);
         handle->running = true;
-        celixThread_create(&handle->thread, NULL, pubsub_tcpHandler_thread, handle);
+        handle->readers[0].handle = handle;
+        handle->readers[0].efd = pubsub_tcpHandler_createPoll();
+        handle->nofReaders = 1;
+        celixThread_create(&handle->readers[0].thread, NULL, pubsub_tcpHandler_thread, &handle->readers[0]);
         // signal(SIGPIPE, SIG_IGN);
     }
     return handle;
@@ -188,7 +227,9 @@ void pubsub_tcpHandler_destroy(pubsub_tcpHandler_t *handle) {
             celixThreadRwlock_writeLock(&handle->dbLock);
             handle->running = false;
             celixThreadRwlock_unlock(&handle->dbLock);
-            celixThread_join(handle->thread, NULL);
+            for (unsigned int i = 0; i < handle->nofReaders; i++) {
+                celixThread_join(handle->readers[i].thread, NULL);
+            }
         }
         celixThreadRwlock_writeLock(&handle->dbLock);
         hash_map_iterator_t interface_iter = hashMapIterator_construct(handle->interface_url_map);
@@ -206,17 +247,59 @@ void pubsub_tcpHandler_destroy(pubsub_tcpHandler_t *handle) {
                 pubsub_tcpHandler_closeConnectionEntry(handle, entry, true);
             }
         }
-        if (handle->efd >= 0) close(handle->efd);
+        for (unsigned int i = 0; i < handle->nofReaders; i++) {
+            if (handle->readers[i].efd >= 0) close(handle->readers[i].efd);
+        }
         hashMap_destroy(handle->connection_url_map, false, false);
         hashMap_destroy(handle->connection_fd_map, false, false);
         hashMap_destroy(handle->interface_url_map, false, false);
         hashMap_destroy(handle->interface_fd_map, false, false);
         celixThreadRwlock_unlock(&handle->dbLock);
         celixThreadRwlock_destroy(&handle->dbLock);
+        pubsub_tcpBufferPool_destroy(handle->bufferPool);
         free(handle);
     }
 }
 
+//
+// Creates the poll fd of a reader thread
+//
+static inline int pubsub_tcpHandler_createPoll(void) {
+#if defined(__APPLE__)
+    return kqueue();
+#else
+    return epoll_create1(0);
+#endif
+}
+
+//
+// Adds reader threads, every reader thread polls its own share of the connections.
+// Connections are assigned round robin to the reader threads when they are created.
+//
+void pubsub_tcpHandler_setNofReaderThreads(pubsub_tcpHandler_t *handle, unsigned int nofThreads) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        if (nofThreads > MAX_READER_THREADS) {
+            L_WARN("[TCP Socket] Number of reader threads %u exceeds the maximum of %u", nofThreads, MAX_READER_THREADS);
+            nofThreads = MAX_READER_THREADS;
+        }
+        unsigned int nofReaders = handle->nofReaders;
+        while (handle->running && nofReaders < nofThreads) {
+            psa_tcp_reader_t *reader = &handle->readers[nofReaders];
+            reader->handle = handle;
+            reader->efd = pubsub_tcpHandler_createPoll();
+            if (reader->efd < 0) {
+                L_ERROR("[TCP Socket] Cannot create poll for reader thread: %s\n", strerror(errno));
+                break;
+            }
+            celixThread_create(&reader->thread, NULL, pubsub_tcpHandler_thread, reader);
+            nofReaders++;
+        }
+        __atomic_store_n(&handle->nofReaders, nofReaders, __ATOMIC_RELEASE);
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
 //
 // Open the socket using an url
 //
@@ -333,11 +416,19 @@ pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, ch
         entry->footerSize = size;
         entry->bufferSize = handle->bufferSize;
         entry->connected = false;
+        unsigned int nofReaders = __atomic_load_n(&handle->nofReaders, __ATOMIC_ACQUIRE);
+        unsigned int reader = __atomic_fetch_add(&handle->nextReader, 1, __ATOMIC_RELAXED) % nofReaders;
+        entry->efd = handle->readers[reader].efd;
+        celixThreadMutex_create(&entry->writeMutex, NULL);
         if (entry->headerBufferSize) {
             entry->headerBuffer = calloc(sizeof(char), entry->headerSize);
         }
         if (entry->footerSize) entry->footerBuffer = calloc(sizeof(char), entry->footerSize);
-        if (entry->bufferSize) entry->buffer = calloc(sizeof(char), entry->bufferSize);
+        if (entry->bufferSize) {
+            size_t capacity = 0;
+            entry->buffer = pubsub_tcpBufferPool_acquire(handle->bufferPool, entry->bufferSize, &capacity);
+            entry->bufferSize = (unsigned int) capacity;
+        }
     }
     return entry;
 }
@@ -346,7 +437,7 @@ pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, ch
 // Free connection/interface entry
 //
 static inline void
-pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t *entry) {
+pubsub_tcpHandler_freeEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry) {
     if (entry) {
         if (entry->url) {
             free(entry->url);
@@ -361,7 +452,7 @@ pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t *entry) {
             entry->fd = -1;
         }
         if (entry->buffer) {
-            free(entry->buffer);
+            pubsub_tcpBufferPool_release(handle->bufferPool, entry->buffer, entry->bufferSize);
             entry->buffer = NULL;
             entry->bufferSize = 0;
         }
@@ -377,25 +468,25 @@ pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t *entry) {
         }
 
         if (entry->metaBuffer) {
-            free(entry->metaBuffer);
+            pubsub_tcpBufferPool_release(handle->bufferPool, entry->metaBuffer, entry->metaBufferSize);
             entry->metaBuffer = NULL;
             entry->metaBufferSize = 0;
         }
+        free(entry->sendQueue);
+        celixThreadMutex_destroy(&entry->writeMutex);
         entry->connected = false;
         free(entry);
     }
 }
 
 //
-// Releases the Buffer
+// Releases the ownership of the receive buffer, the message payload is now owned by the receiver.
+// A new buffer is taken from the buffer pool when the next message is read.
 //
 static inline void
-pubsub_tcpHandler_releaseEntryBuffer(pubsub_tcpHandler_t *handle, int fd, unsigned int index __attribute__((unused))) {
-    psa_tcp_connection_entry_t *entry = hashMap_get(handle->connection_fd_map, (void *) (intptr_t) fd);
-    if (entry != NULL) {
-        entry->buffer = NULL;
-        entry->bufferSize = 0;
-    }
+pubsub_tcpHandler_releaseEntryBuffer(psa_tcp_connection_entry_t *entry) {
+    entry->buffer = NULL;
+    entry->bufferSize = 0;
 }
 
 //
@@ -432,16 +523,16 @@ int pubsub_tcpHandler_connect(pubsub_tcpHandler_t *handle, char *url) {
 #if defined(__APPLE__)
             struct kevent ev;
             EV_SET (&ev, entry->fd, EVFILT_READ | EVFILT_WRITE, EV_ADD | EV_ENABLE, 0, 0, 0);
-            rc = kevent (handle->efd, &ev, 1, NULL, 0, NULL);
+            rc = kevent (entry->efd, &ev, 1, NULL, 0, NULL);
 #else
             struct epoll_event event;
             bzero(&event,  sizeof(struct epoll_event)); // zero the struct
             event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
             event.data.fd = entry->fd;
-            rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, entry->fd, &event);
+            rc = epoll_ctl(entry->efd, EPOLL_CTL_ADD, entry->fd, &event);
 #endif
             if (rc < 0) {
-                pubsub_tcpHandler_freeEntry(entry);
+                pubsub_tcpHandler_freeEntry(handle, entry);
                 L_ERROR("[TCP Socket] Cannot create poll event %s\n", strerror(errno));
                 entry = NULL;
             }
@@ -484,15 +575,15 @@ static inline int pubsub_tcpHandler_closeConnectionEntry(
     if (handle != NULL && entry != NULL) {
         fprintf(stdout, "[TCP Socket] Close connection to url: %s: \n", entry->url);
         hashMap_remove(handle->connection_fd_map, (void *) (intptr_t) entry->fd);
-        if ((handle->efd >= 0)) {
+        if ((entry->efd >= 0)) {
 #if defined(__APPLE__)
           struct kevent ev;
           EV_SET (&ev, entry->fd, EVFILT_READ, EV_DELETE , 0, 0, 0);
-          rc = kevent (handle->efd, &ev, 1, NULL, 0, NULL);
+          rc = kevent (entry->efd, &ev, 1, NULL, 0, NULL);
 #else
             struct epoll_event event;
             bzero(&event, sizeof(struct epoll_event)); // zero the struct
-            rc = epoll_ctl(handle->efd, EPOLL_CTL_DEL, entry->fd, &event);
+            rc = epoll_ctl(entry->efd, EPOLL_CTL_DEL, entry->fd, &event);
 #endif
             if (rc < 0) {
                 L_ERROR("[PSA TCP] Error disconnecting %s\n", strerror(errno));
@@ -503,7 +594,7 @@ static inline int pubsub_tcpHandler_closeConnectionEntry(
                 handle->receiverDisconnectMessageCallback(handle->receiverConnectPayload, entry->url, lock);
             if (handle->acceptConnectMessageCallback)
                 handle->acceptConnectMessageCallback(handle->acceptConnectPayload, entry->url);
-            pubsub_tcpHandler_freeEntry(entry);
+            pubsub_tcpHandler_freeEntry(handle, entry);
             entry = NULL;
         }
     }
@@ -520,22 +611,22 @@ pubsub_tcpHandler_closeInterfaceEntry(pubsub_tcpHandler_t *handle,
     if (handle != NULL && entry != NULL) {
         L_INFO("[TCP Socket] Close interface url: %s: \n", entry->url);
         hashMap_remove(handle->interface_fd_map, (void *) (intptr_t) entry->fd);
-        if ((handle->efd >= 0)) {
+        if ((entry->efd >= 0)) {
 #if defined(__APPLE__)
             struct kevent ev;
             EV_SET (&ev, entry->fd, EVFILT_READ, EV_DELETE , 0, 0, 0);
-            rc = kevent (handle->efd, &ev, 1, NULL, 0, NULL);
+            rc = kevent (entry->efd, &ev, 1, NULL, 0, NULL);
 #else
             struct epoll_event event;
             bzero(&event, sizeof(struct epoll_event)); // zero the struct
-            rc = epoll_ctl(handle->efd, EPOLL_CTL_DEL, entry->fd, &event);
+            rc = epoll_ctl(entry->efd, EPOLL_CTL_DEL, entry->fd, &event);
 #endif
             if (rc < 0) {
                 L_ERROR("[PSA TCP] Error disconnecting %s\n", strerror(errno));
             }
         }
         if (entry->fd >= 0) {
-            pubsub_tcpHandler_freeEntry(entry);
+            pubsub_tcpHandler_freeEntry(handle, entry);
         }
     }
     return rc;
@@ -584,33 +675,33 @@ int pubsub_tcpHandler_listen(pubsub_tcpHandler_t *handle, char *url) {
                 rc = listen(fd, SOMAXCONN);
                 if (rc != 0) {
                     L_ERROR("[TCP Socket] Error listen: %s\n", strerror(errno));
-                    pubsub_tcpHandler_freeEntry(entry);
+                    pubsub_tcpHandler_freeEntry(handle, entry);
                     entry = NULL;
                 }
             }
             if (rc >= 0) {
                 rc = pubsub_tcpHandler_makeNonBlocking(handle, fd);
                 if (rc < 0) {
-                    pubsub_tcpHandler_freeEntry(entry);
+                    pubsub_tcpHandler_freeEntry(handle, entry);
                     entry = NULL;
                 }
             }
-            if ((rc >= 0) && (handle->efd >= 0)) {
+            if ((rc >= 0) && (entry->efd >= 0)) {
 #if defined(__APPLE__)
                 struct kevent ev;
                 EV_SET (&ev, fd, EVFILT_READ, EV_ADD | EV_ENABLE, 0, 0, 0);
-                rc = kevent(handle->efd, &ev, 1, NULL, 0, NULL);
+                rc = kevent(entry->efd, &ev, 1, NULL, 0, NULL);
 #else
                 struct epoll_event event;
                 bzero(&event, sizeof(event)); // zero the struct
                 event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
                 event.data.fd = fd;
-                rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, fd, &event);
+                rc = epoll_ctl(entry->efd, EPOLL_CTL_ADD, fd, &event);
 #endif
                 if (rc < 0) {
                     L_ERROR("[TCP Socket] Cannot create poll: %s\n", strerror(errno));
                     errno = 0;
-                    pubsub_tcpHandler_freeEntry(entry);
+                    pubsub_tcpHandler_freeEntry(handle, entry);
                     entry = NULL;
                 }
                 if (entry) {
@@ -631,18 +722,28 @@ int pubsub_tcpHandler_listen(pubsub_tcpHandler_t *handle, char *url) {
 // Setup buffer sizes
 //
 int pubsub_tcpHandler_createReceiveBufferStore(pubsub_tcpHandler_t *handle,
-                                               unsigned int maxNofBuffers
-                                               __attribute__((__unused__)),
+                                               unsigned int maxNofBuffers,
                                                unsigned int bufferSize) {
     if (handle != NULL) {
         celixThreadRwlock_writeLock(&handle->dbLock);
         handle->bufferSize = bufferSize;
         handle->maxNofBuffer = maxNofBuffers;
+        // Buffers are rounded up to a power of 2, so a buffer can take up to twice the requested size
+        size_t poolSize = 2 * (size_t) maxNofBuffers * bufferSize;
+        pubsub_tcpBufferPool_setMaxCachedBytes(handle->bufferPool, MAX(DEFAULT_RECEIVE_BUFFER_POOL_SIZE, poolSize));
         celixThreadRwlock_unlock(&handle->dbLock);
     }
     return 0;
 }
 
+void *pubsub_tcpHandler_acquireReceiveBuffer(pubsub_tcpHandler_t *handle, size_t size, size_t *capacity) {
+    return pubsub_tcpBufferPool_acquire(handle->bufferPool, size, capacity);
+}
+
+void pubsub_tcpHandler_releaseReceiveBuffer(pubsub_tcpHandler_t *handle, void *buffer, size_t capacity) {
+    pubsub_tcpBufferPool_release(handle->bufferPool, buffer, capacity);
+}
+
 //
 // Setup thread timeout
 //
@@ -667,7 +768,9 @@ void pubsub_tcpHandler_setThreadName(pubsub_tcpHandler_t *handle,
         else
             asprintf(&thread_name, "TCP TS %s", topic);
         celixThreadRwlock_writeLock(&handle->dbLock);
-        celixThread_setName(&handle->thread, thread_name);
+        for (unsigned int i = 0; i < handle->nofReaders; i++) {
+            celixThread_setName(&handle->readers[i].thread, thread_name);
+        }
         celixThreadRwlock_unlock(&handle->dbLock);
         free(thread_name);
     }
@@ -709,7 +812,9 @@ void pubsub_tcpHandler_setThreadPriority(pubsub_tcpHandler_t *handle, long prio,
                 struct sched_param sch;
                 bzero(&sch, sizeof(struct sched_param));
                 sch.sched_priority = prio;
-                pthread_setschedparam(handle->thread.thread, policy, &sch);
+                for (unsigned int i = 0; i < handle->nofReaders; i++) {
+                    pthread_setschedparam(handle->readers[i].thread.thread, policy, &sch);
+                }
             } else {
                 L_INFO("Skipping configuration of thread prio to %i and thread "
                        "scheduling to %s. No permission\n",
@@ -752,6 +857,27 @@ void pubsub_tcpHandler_setReceiveTimeOut(pubsub_tcpHandler_t *handle, double tim
     }
 }
 
+void pubsub_tcpHandler_setSendQueueHighWatermark(pubsub_tcpHandler_t *handle, size_t size) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->sendQueueHighWatermark = size;
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+//
+// Setup message coalescing, messages are held in the send queue until size bytes are queued or the oldest
+// queued message is delay ms old. A size of 0 disables coalescing.
+//
+void pubsub_tcpHandler_setCoalescing(pubsub_tcpHandler_t *handle, size_t size, unsigned int delay) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->coalesceSize = size;
+        handle->coalesceDelay = MAX(delay, 1);
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
 static inline
 int pubsub_tcpHandler_readSocket(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, int fd, void* _buffer, unsigned int offset, unsigned int size, int flag ) {
     int expectedReadSize = size;
@@ -780,24 +906,41 @@ void pubsub_tcpHandler_decodePayload(pubsub_tcpHandler_t *handle, psa_tcp_connec
   if (entry->header.header.metadataSize > 0) {
     handle->protocol->decodeMetadata(handle->protocol->handle, entry->metaBuffer,
                                      entry->header.header.metadataSize, &entry->header);
-    entry->metaBufferSize = entry->header.header.metadataSize;
   }
   if (handle->processMessageCallback && entry->header.payload.payload != NULL && entry->header.payload.length) {
     struct timespec receiveTime;
     clock_gettime(CLOCK_REALTIME, &receiveTime);
     bool releaseEntryBuffer = false;
-    handle->processMessageCallback(handle->processMessagePayload, &entry->header, &releaseEntryBuffer, &receiveTime);
-    if (releaseEntryBuffer) pubsub_tcpHandler_releaseEntryBuffer(handle, entry->fd, 0);
+    handle->processMessageCallback(handle->processMessagePayload, &entry->header, entry->bufferSize, &releaseEntryBuffer, &receiveTime);
+    if (releaseEntryBuffer) pubsub_tcpHandler_releaseEntryBuffer(entry);
+  }
+  if (entry->header.metadata.metadata) {
+    celix_properties_destroy(entry->header.metadata.metadata);
+    entry->header.metadata.metadata = NULL;
   }
 }
 
 
+//
+// Replaces a (too small) receive buffer of a connection with a buffer of at least size bytes from the buffer pool.
+// The content of the buffer is not preserved. Returns false if the buffer cannot be allocated.
+//
+static inline bool pubsub_tcpHandler_growEntryBuffer(pubsub_tcpHandler_t *handle, void **buffer, unsigned int *bufferSize, unsigned int size) {
+    pubsub_tcpBufferPool_release(handle->bufferPool, *buffer, *bufferSize);
+    size_t capacity = 0;
+    *buffer = pubsub_tcpBufferPool_acquire(handle->bufferPool, size, &capacity);
+    *bufferSize = (unsigned int) capacity;
+    return *buffer != NULL;
+}
+
 //
 // Reads data from the filedescriptor which has date (determined by epoll()) and stores it in the internal structure
 // If the message is completely reassembled true is returned and the index and size have valid values
 //
+// Note: a connection is only read by the reader thread it is assigned to, so concurrent reads use the read lock
+//
 int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd) {
-    celixThreadRwlock_writeLock(&handle->dbLock);
+    celixThreadRwlock_readLock(&handle->dbLock);
     psa_tcp_connection_entry_t *entry = hashMap_get(handle->interface_fd_map, (void *) (intptr_t) fd);
     if (entry == NULL)
         entry = hashMap_get(handle->connection_fd_map, (void *) (intptr_t) fd);
@@ -814,11 +957,12 @@ int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd) {
 
     // Message buffer is to small, reallocate to make it bigger
     if ((!entry->headerBufferSize) && (entry->headerSize > entry->bufferSize)) {
-        handle->bufferSize = MAX(handle->bufferSize, entry->headerSize );
-        if (entry->buffer) free(entry->buffer);
-            entry->buffer = malloc((size_t) handle->bufferSize);
-            entry->bufferSize = handle->bufferSize;
+        if (!pubsub_tcpHandler_growEntryBuffer(handle, &entry->buffer, &entry->bufferSize, MAX(handle->bufferSize, entry->headerSize))) {
+            L_ERROR("[TCP Socket] Cannot allocate receive buffer (fd: %d) (url: %s), closing connection", entry->fd, entry->url);
+            celixThreadRwlock_unlock(&handle->dbLock);
+            return 0;
         }
+    }
     // Read the message
     bool validMsg = false;
     char* header_buffer = (entry->headerBufferSize) ? entry->headerBuffer : entry->buffer;
@@ -843,21 +987,20 @@ int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd) {
                 if (!entry->headerBufferSize)
                     entry->bufferReadSize += nbytes;
                 // Alloc message buffers
+                bool allocated = true;
                 if (entry->header.header.payloadSize > entry->bufferSize) {
-                    handle->bufferSize = MAX(handle->bufferSize, entry->header.header.payloadSize);
-                    if (entry->buffer)
-                        free(entry->buffer);
-                    entry->buffer = malloc((size_t) handle->bufferSize);
-                    entry->bufferSize = handle->bufferSize;
+                    allocated = pubsub_tcpHandler_growEntryBuffer(handle, &entry->buffer, &entry->bufferSize,
+                                                                  MAX(handle->bufferSize, entry->header.header.payloadSize));
                 }
-                if (entry->header.header.metadataSize > entry->metaBufferSize) {
-                    if (entry->metaBuffer) {
-                      free(entry->metaBuffer);
-                    }
-                    entry->metaBuffer = malloc((size_t) entry->header.header.metadataSize);
-                    entry->metaBufferSize = entry->header.header.metadataSize;
-                    L_WARN("[TCP Socket] socket: %d, url: %s,  realloc read meta buffer: (%d, %d) \n", entry->fd,
-                      entry->url, entry->metaBufferSize, entry->header.header.metadataSize);
+                if (allocated && entry->header.header.metadataSize > entry->metaBufferSize) {
+                    allocated = pubsub_tcpHandler_growEntryBuffer(handle, &entry->metaBuffer, &entry->metaBufferSize,
+                                                                  entry->header.header.metadataSize);
+                }
+                if (!allocated) {
+                    //note the message cannot be skipped, because the header is already read from the stream
+                    L_ERROR("[TCP Socket] Cannot allocate receive buffer (fd: %d) (url: %s), closing connection", entry->fd, entry->url);
+                    celixThreadRwlock_unlock(&handle->dbLock);
+                    return 0;
                 }
 
                 if (entry->header.header.payloadSize) {
@@ -964,46 +1107,171 @@ int pubsub_tcpHandler_addAcceptConnectionCallback(pubsub_tcpHandler_t *handle, v
     return result;
 }
 
-static inline
-int pubsub_tcpHandler_writeSocket(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, struct msghdr* msg, unsigned int size, int flag ) {
-  int nbytes = 0;
-  int msgSize = 0;
-  if (entry->fd >= 0 && size && msg->msg_iovlen) {
-    int expectedReadSize = size;
-    unsigned int offset = 0;
-    nbytes = size;
-    while (nbytes > 0 && expectedReadSize > 0) {
-      // Read the message header
-      nbytes = sendmsg(entry->fd, msg, flag | MSG_NOSIGNAL);
-      // Update admin
-      expectedReadSize -= nbytes;
-      msgSize += nbytes;
-      // Not all written
-      if (expectedReadSize && nbytes > 0) {
-        unsigned int readSize = 0;
-        unsigned int readIndex = 0;
-        unsigned int i = 0;
-        for (i = 0; i < msg->msg_iovlen; i++) {
-          if (nbytes < msg->msg_iov[i].iov_len) {
-            readIndex = i;
-            break;
-          }
-          readSize+= msg->msg_iov[i].iov_len;
-        }
-        msg->msg_iov = &msg->msg_iov[readIndex];
-        msg->msg_iovlen -= readIndex;
-        char* buffer = (char*)msg->msg_iov->iov_base;
-        offset = nbytes - readSize;
-        msg->msg_iov->iov_base = &buffer[offset];
-        msg->msg_iov->iov_len  = msg->msg_iov->iov_len - offset;
-      }
+//
+// Enables or disables the write (EPOLLOUT) event of the connection, used to flush the send queue.
+// Note: Should be called with the entry->writeMutex locked
+//
+static inline int pubsub_tcpHandler_setWriteEvent(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, bool enable) {
+    int rc = 0;
+    if (entry->writeEventEnabled != enable && entry->efd >= 0) {
+#if defined(__APPLE__)
+        struct kevent ev;
+        EV_SET (&ev, entry->fd, EVFILT_WRITE, enable ? (EV_ADD | EV_ENABLE) : EV_DELETE, 0, 0, 0);
+        rc = kevent (entry->efd, &ev, 1, NULL, 0, NULL);
+#else
+        struct epoll_event event;
+        bzero(&event, sizeof(struct epoll_event)); // zero the struct
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR | (enable ? EPOLLOUT : 0);
+        event.data.fd = entry->fd;
+        rc = epoll_ctl(entry->efd, EPOLL_CTL_MOD, entry->fd, &event);
+#endif
+        if (rc < 0) {
+            L_ERROR("[TCP Socket] Cannot update poll event for %s: %s\n", entry->url, strerror(errno));
+        } else {
+            entry->writeEventEnabled = enable;
+        }
     }
-  }
-  if (nbytes <=0)  msgSize = nbytes;
-  return msgSize;
+    return rc;
 }
+
 //
-// Write large data to TCP. .
+// Appends the io vectors to the send queue of the entry, skipping the first offset bytes (already written)
+// Note: Should be called with the entry->writeMutex locked
+//
+static inline void pubsub_tcpHandler_enqueue(psa_tcp_connection_entry_t *entry, const struct iovec *iov, size_t iovLen, size_t offset) {
+    size_t size = 0;
+    for (size_t i = 0; i < iovLen; i++) {
+        size += iov[i].iov_len;
+    }
+    size -= offset;
+    if (entry->sendQueueSize + size > entry->sendQueueCapacity && entry->sendQueueOffset > 0) {
+        // move the pending bytes to the start of the queue
+        memmove(entry->sendQueue, &entry->sendQueue[entry->sendQueueOffset], entry->sendQueueSize - entry->sendQueueOffset);
+        entry->sendQueueSize -= entry->sendQueueOffset;
+        entry->sendQueueOffset = 0;
+    }
+    if (entry->sendQueueSize + size > entry->sendQueueCapacity) {
+        entry->sendQueueCapacity = MAX(entry->sendQueueSize + size, entry->sendQueueCapacity * 2);
+        entry->sendQueue = realloc(entry->sendQueue, entry->sendQueueCapacity);
+    }
+    for (size_t i = 0; i < iovLen; i++) {
+        size_t len = iov[i].iov_len;
+        const char *data = iov[i].iov_base;
+        if (offset >= len) {
+            offset -= len;
+            continue;
+        }
+        memcpy(&entry->sendQueue[entry->sendQueueSize], &data[offset], len - offset);
+        entry->sendQueueSize += len - offset;
+        offset = 0;
+    }
+}
+
+//
+// Writes the pending bytes of the send queue without blocking. Returns -1 on a socket error.
+// Note: Should be called with the entry->writeMutex locked
+//
+static inline int pubsub_tcpHandler_flushSendQueue(psa_tcp_connection_entry_t *entry) {
+    while (entry->sendQueueOffset < entry->sendQueueSize) {
+        ssize_t nbytes = send(entry->fd, &entry->sendQueue[entry->sendQueueOffset],
+                              entry->sendQueueSize - entry->sendQueueOffset, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (nbytes < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            return -1;
+        }
+        entry->sendQueueOffset += nbytes;
+    }
+    if (entry->sendQueueOffset == entry->sendQueueSize) {
+        entry->sendQueueOffset = 0;
+        entry->sendQueueSize = 0;
+    }
+    return 0;
+}
+
+//
+// Returns true if the held bytes of the send queue should be written, i.e. coalescing is disabled or the coalesce
+// size or delay is reached.
+// Note: Should be called with the entry->writeMutex locked
+//
+static inline bool pubsub_tcpHandler_coalesceDone(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry) {
+    if (handle->coalesceSize == 0 || entry->sendQueueSize - entry->sendQueueOffset >= handle->coalesceSize) {
+        return true;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return celix_difftime(&entry->sendQueueTime, &now) * 1000.0 >= handle->coalesceDelay;
+}
+
+//
+// Writes an encoded message to a single connection without blocking. If the connection cannot take the complete
+// message, the remainder is queued and written when the socket is writable again. New messages for a connection
+// with pending bytes are queued until the high watermark is reached, after that they are dropped for that connection.
+// Messages written with the PUBSUB_TCP_HANDLER_MSG_MORE flag or while coalescing is enabled are held in the send queue,
+// so that multiple messages are written with a single system call.
+// Returns the number of bytes written or queued (0 if dropped) or -1 on a socket error.
+//
+static inline long pubsub_tcpHandler_writeEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry,
+                                                struct iovec *iov, size_t iovLen, size_t msgSize, int flags) {
+    long nbytes = 0;
+    bool more = (flags & PUBSUB_TCP_HANDLER_MSG_MORE) != 0;
+    bool hold = more || handle->coalesceSize > 0;
+    bool flushed = false;
+    flags &= ~PUBSUB_TCP_HANDLER_MSG_MORE;
+    celixThreadMutex_lock(&entry->writeMutex);
+    size_t pending = entry->sendQueueSize - entry->sendQueueOffset;
+    if (pending > 0 && (!hold || pending + msgSize > handle->sendQueueHighWatermark)) {
+        nbytes = pubsub_tcpHandler_flushSendQueue(entry);
+        pending = entry->sendQueueSize - entry->sendQueueOffset;
+        flushed = true;
+    }
+    if (nbytes >= 0 && pending > 0 && pending + msgSize > handle->sendQueueHighWatermark) {
+        // Slow connection, drop the message for this connection
+        if (entry->nofDroppedMessages++ == 0) {
+            L_WARN("[TCP Socket] Send queue of %s is full (%zu bytes pending), dropping messages", entry->url, pending);
+        }
+        nbytes = 0;
+    } else if (nbytes >= 0 && (pending > 0 || hold)) {
+        // Keep the message order by queueing behind the pending bytes, or hold the message to coalesce it
+        if (pending == 0) {
+            clock_gettime(CLOCK_MONOTONIC, &entry->sendQueueTime);
+        }
+        pubsub_tcpHandler_enqueue(entry, iov, iovLen, 0);
+        nbytes = (long) msgSize;
+        if (hold && !more && !entry->writeEventEnabled && pubsub_tcpHandler_coalesceDone(handle, entry)) {
+            nbytes = pubsub_tcpHandler_flushSendQueue(entry) < 0 ? -1 : nbytes;
+            flushed = true;
+        }
+    } else if (nbytes >= 0) {
+        struct msghdr msg;
+        memset(&msg, 0x00, sizeof(struct msghdr));
+        msg.msg_name = &entry->addr;
+        msg.msg_namelen = entry->len;
+        msg.msg_flags = flags;
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovLen;
+        nbytes = sendmsg(entry->fd, &msg, flags | MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (nbytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            nbytes = 0;
+        }
+        if (nbytes >= 0 && (size_t) nbytes < msgSize) {
+            // Always queue the remainder, a partially written message cannot be dropped (streaming protocol)
+            pubsub_tcpHandler_enqueue(entry, iov, iovLen, (size_t) nbytes);
+            nbytes = (long) msgSize;
+        }
+        flushed = true;
+    }
+    if (nbytes >= 0 && flushed) {
+        // Held bytes do not enable the write event, only bytes the socket could not take
+        pubsub_tcpHandler_setWriteEvent(handle, entry, entry->sendQueueSize > entry->sendQueueOffset);
+    }
+    celixThreadMutex_unlock(&entry->writeMutex);
+    return nbytes;
+}
+
+//
+// Write large data to TCP. The message is encoded once and the same io vectors are written to all connections.
 //
 int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_protocol_message_t *message, struct iovec *msgIoVec,
                             size_t msg_iov_len, int flags) {
@@ -1011,113 +1279,89 @@ int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_protocol_message
     int result = 0;
     int connFdCloseQueue[hashMap_size(handle->connection_fd_map)];
     int nofConnToClose = 0;
-    if (handle) {
-        hash_map_iterator_t iter = hashMapIterator_construct(handle->connection_fd_map);
-        while (hashMapIterator_hasNext(&iter)) {
-            psa_tcp_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
-            if (!entry->connected) continue;
-            void *payloadData = NULL;
-            size_t payloadSize = 0;
-            if (msg_iov_len == 1) {
-                handle->protocol->encodePayload(handle->protocol->handle, message, &payloadData, &payloadSize);
-            } else {
-                for (size_t i = 0; i < msg_iov_len; i++) {
-                    payloadSize += msgIoVec[i].iov_len;
-                }
-            }
-            message->header.convertEndianess = 0;
-            message->header.payloadSize = payloadSize;
-            message->header.payloadPartSize = payloadSize;
-            message->header.payloadOffset = 0;
-            message->header.isLastSegment = 1;
-
-            void *metadataData = NULL;
-            size_t metadataSize = 0;
-            if (message->metadata.metadata) {
-                metadataData = entry->metaBuffer;
-                handle->protocol->encodeMetadata(handle->protocol->handle, message,
-                                                 &metadataData,
-                                                 &metadataSize);
-                entry->metaBufferSize = metadataSize;
-            }
-            message->header.metadataSize = metadataSize;
-
-            void *footerData = NULL;
-            size_t footerDataSize = 0;
-            if (entry->footerSize) {
-                footerData = entry->footerBuffer;
-                handle->protocol->encodeFooter(handle->protocol->handle, message,
-                                                 &footerData,
-                                                 &footerDataSize);
-                entry->footerSize = footerDataSize;
+    if (handle && hashMap_size(handle->connection_fd_map) > 0) {
+        void *payloadData = NULL;
+        size_t payloadSize = 0;
+        if (msg_iov_len == 1) {
+            handle->protocol->encodePayload(handle->protocol->handle, message, &payloadData, &payloadSize);
+        } else {
+            for (size_t i = 0; i < msg_iov_len; i++) {
+                payloadSize += msgIoVec[i].iov_len;
             }
+        }
+        message->header.convertEndianess = 0;
+        message->header.payloadSize = payloadSize;
+        message->header.payloadPartSize = payloadSize;
+        message->header.payloadOffset = 0;
+        message->header.isLastSegment = 1;
+
+        void *metadataData = NULL;
+        size_t metadataSize = 0;
+        if (message->metadata.metadata) {
+            handle->protocol->encodeMetadata(handle->protocol->handle, message, &metadataData, &metadataSize);
+        }
+        message->header.metadataSize = metadataSize;
 
-            size_t msgSize = 0;
-            struct msghdr msg;
-            struct iovec msg_iov[IOV_MAX];
-            memset(&msg, 0x00, sizeof(struct msghdr));
-            msg.msg_name = &entry->addr;
-            msg.msg_namelen = entry->len;
-            msg.msg_flags = flags;
-            msg.msg_iov = msg_iov;
-
-            // Write generic seralized payload in vector buffer
-            if (payloadSize && payloadData) {
-                msg.msg_iovlen++;
-                msg.msg_iov[msg.msg_iovlen].iov_base = payloadData;
-                msg.msg_iov[msg.msg_iovlen].iov_len = payloadSize;
-                msgSize += msg.msg_iov[msg.msg_iovlen].iov_len;
-            } else {
-                // copy serialized vector into vector buffer
-                for (size_t i = 0; i < MIN(msg_iov_len, IOV_MAX - 2); i++) {
-                    msg.msg_iovlen++;
-                    msg.msg_iov[msg.msg_iovlen].iov_base = msgIoVec[i].iov_base;
-                    msg.msg_iov[msg.msg_iovlen].iov_len = msgIoVec[i].iov_len;
-                    msgSize += msg.msg_iov[msg.msg_iovlen].iov_len;
-                }
-            }
+        void *footerData = NULL;
+        size_t footerDataSize = 0;
+        if (handle->footerSize) {
+            handle->protocol->encodeFooter(handle->protocol->handle, message, &footerData, &footerDataSize);
+        }
 
-            // Write optional metadata in vector buffer
-            if (metadataSize && metadataData) {
-                msg.msg_iovlen++;
-                msg.msg_iov[msg.msg_iovlen].iov_base = metadataData;
-                msg.msg_iov[msg.msg_iovlen].iov_len = metadataSize;
-                msgSize += msg.msg_iov[msg.msg_iovlen].iov_len;
-            }
+        void *headerData = NULL;
+        size_t headerSize = 0;
+        // check if header is not part of the payload (=> headerBufferSize = 0)
+        if (handle->headerBufferSize) {
+            // Encode the header, with payload size and metadata size
+            handle->protocol->encodeHeader(handle->protocol->handle, message, &headerData, &headerSize);
+        }
 
-            // Write optional footerData in vector buffer
-            if (footerData && footerDataSize) {
-                msg.msg_iovlen++;
-                msg.msg_iov[msg.msg_iovlen].iov_base = footerData;
-                msg.msg_iov[msg.msg_iovlen].iov_len = footerDataSize;
-                msgSize += msg.msg_iov[msg.msg_iovlen].iov_len;
-            }
+        size_t msgSize = 0;
+        size_t iovLen = 0;
+        struct iovec msg_iov[IOV_MAX];
+
+        // Write header in 1st vector buffer item, skipped when the header is part of the payload
+        if (headerSize && headerData) {
+            msg_iov[iovLen].iov_base = headerData;
+            msg_iov[iovLen].iov_len = headerSize;
+            msgSize += msg_iov[iovLen++].iov_len;
+        } else if (handle->headerBufferSize) {
+            L_ERROR("[TCP Socket] No header buffer is generated");
+        }
 
-            void *headerData = NULL;
-            size_t headerSize = 0;
-            // check if header is not part of the payload (=> headerBufferSize = 0)s
-            if (entry->headerBufferSize) {
-              headerData = entry->headerBuffer;
-              // Encode the header, with payload size and metadata size
-              handle->protocol->encodeHeader(handle->protocol->handle, message,
-                                             &headerData,
-                                             &headerSize);
-              entry->headerBufferSize = headerSize;
-            }
-            if (!entry->headerBufferSize) {
-              // Skip header buffer, when header is part of payload;
-              msg.msg_iov = &msg_iov[1];
-            } else if (headerSize && headerData) {
-              // Write header in 1st vector buffer item
-                msg.msg_iov[0].iov_base = headerData;
-                msg.msg_iov[0].iov_len = headerSize;
-                msgSize += msg.msg_iov[0].iov_len;
-                msg.msg_iovlen++;
-            } else {
-              L_ERROR("[TCP Socket] No header buffer is generated");
-              msg.msg_iovlen = 0;
+        // Write generic seralized payload in vector buffer
+        if (payloadSize && payloadData) {
+            msg_iov[iovLen].iov_base = payloadData;
+            msg_iov[iovLen].iov_len = payloadSize;
+            msgSize += msg_iov[iovLen++].iov_len;
+        } else {
+            // copy serialized vector into vector buffer
+            for (size_t i = 0; i < MIN(msg_iov_len, IOV_MAX - 3); i++) {
+                msg_iov[iovLen].iov_base = msgIoVec[i].iov_base;
+                msg_iov[iovLen].iov_len = msgIoVec[i].iov_len;
+                msgSize += msg_iov[iovLen++].iov_len;
             }
-            long int nbytes = pubsub_tcpHandler_writeSocket(handle, entry, &msg, msgSize, flags);
+        }
+
+        // Write optional metadata in vector buffer
+        if (metadataSize && metadataData) {
+            msg_iov[iovLen].iov_base = metadataData;
+            msg_iov[iovLen].iov_len = metadataSize;
+            msgSize += msg_iov[iovLen++].iov_len;
+        }
+
+        // Write optional footerData in vector buffer
+        if (footerData && footerDataSize) {
+            msg_iov[iovLen].iov_base = footerData;
+            msg_iov[iovLen].iov_len = footerDataSize;
+            msgSize += msg_iov[iovLen++].iov_len;
+        }
+
+        hash_map_iterator_t iter = hashMapIterator_construct(handle->connection_fd_map);
+        while (msgSize && (handle->headerBufferSize == 0 || headerData) && hashMapIterator_hasNext(&iter)) {
+            psa_tcp_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (!entry->connected) continue;
+            long int nbytes = pubsub_tcpHandler_writeEntry(handle, entry, msg_iov, iovLen, msgSize, flags);
             //  When a specific socket keeps reporting errors can indicate a subscriber
             //  which is not active anymore, the connection will remain until the retry
             //  counter exceeds the maximum retry count.
@@ -1135,27 +1379,15 @@ int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_protocol_message
                     connFdCloseQueue[nofConnToClose++] = entry->fd;
                 }
                 result = -1; //At least one connection failed sending
-            } else if (msgSize) {
+            } else if (nbytes > 0) {
                 entry->retryCount = 0;
-                if (nbytes != msgSize) {
-                    L_ERROR("[TCP Socket] seq: %d MsgSize not correct: %d != %d (%s)\n", message->header.seqNr, msgSize, nbytes,  strerror(errno));
-                }
-            }
-            // Release data
-            if (headerData && headerData != entry->headerBuffer) {
-                free(headerData);
-            }
-            // Note: serialized Payload is deleted by serializer
-            if (payloadData && (payloadData != message->payload.payload)) {
-                free(payloadData);
-            }
-            if (metadataData && metadataData != entry->metaBuffer) {
-                free(metadataData);
-            }
-            if (footerData && footerData != entry->footerBuffer) {
-                free(footerData);
             }
         }
+
+        // Release data, note: serialized Payload is deleted by serializer
+        free(headerData);
+        free(metadataData);
+        free(footerData);
     }
     celixThreadRwlock_unlock(&handle->dbLock);
     //Force close all connections that are queued in a list, done outside of locking handle->dbLock to prevent deadlock
@@ -1165,6 +1397,72 @@ int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_protocol_message
     return result;
 }
 
+//
+// Writes the held bytes of all connections, when expiredOnly is set only the connections which reached the
+// coalesce size or delay are written. Connections that cannot take all bytes are flushed by the write event.
+//
+static inline int pubsub_tcpHandler_flushConnections(pubsub_tcpHandler_t *handle, bool expiredOnly) {
+    int result = 0;
+    celixThreadRwlock_readLock(&handle->dbLock);
+    hash_map_iterator_t iter = hashMapIterator_construct(handle->connection_fd_map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_tcp_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+        celixThreadMutex_lock(&entry->writeMutex);
+        if (entry->connected && !entry->writeEventEnabled && entry->sendQueueSize > entry->sendQueueOffset &&
+            (!expiredOnly || pubsub_tcpHandler_coalesceDone(handle, entry))) {
+            if (pubsub_tcpHandler_flushSendQueue(entry) < 0) {
+                L_ERROR("[TCP Socket] Failed to send queued data to %s: %s", entry->url, strerror(errno));
+                result = -1;
+            } else {
+                pubsub_tcpHandler_setWriteEvent(handle, entry, entry->sendQueueSize > entry->sendQueueOffset);
+            }
+        }
+        celixThreadMutex_unlock(&entry->writeMutex);
+    }
+    celixThreadRwlock_unlock(&handle->dbLock);
+    return result;
+}
+
+//
+// Writes the messages held by writes with the PUBSUB_TCP_HANDLER_MSG_MORE flag or by coalescing
+//
+int pubsub_tcpHandler_flush(pubsub_tcpHandler_t *handle) {
+    return handle != NULL ? pubsub_tcpHandler_flushConnections(handle, false) : -1;
+}
+
+//
+// Writes the coalesced messages of the connections which reached the coalesce delay
+//
+static inline void pubsub_tcpHandler_flushExpired(pubsub_tcpHandler_t *handle) {
+    pubsub_tcpHandler_flushConnections(handle, true);
+}
+
+//
+// Handle writable socket, writes the send queue of a slow connection (sender)
+//
+static inline
+int pubsub_tcpHandler_writeHandler(pubsub_tcpHandler_t *handle, int fd) {
+    int rc = 0;
+    celixThreadRwlock_readLock(&handle->dbLock);
+    psa_tcp_connection_entry_t *entry = hashMap_get(handle->connection_fd_map, (void *) (intptr_t) fd);
+    if (entry) {
+        celixThreadMutex_lock(&entry->writeMutex);
+        rc = pubsub_tcpHandler_flushSendQueue(entry);
+        if (rc < 0) {
+            L_ERROR("[TCP Socket] Failed to send queued data to %s: %s", entry->url, strerror(errno));
+        } else if (entry->sendQueueSize == entry->sendQueueOffset) {
+            pubsub_tcpHandler_setWriteEvent(handle, entry, false);
+            if (entry->nofDroppedMessages > 0) {
+                L_WARN("[TCP Socket] Dropped %lu messages for slow connection %s", entry->nofDroppedMessages, entry->url);
+                entry->nofDroppedMessages = 0;
+            }
+        }
+        celixThreadMutex_unlock(&entry->writeMutex);
+    }
+    celixThreadRwlock_unlock(&handle->dbLock);
+    return rc;
+}
+
 //
 // get interface URL
 //
@@ -1212,17 +1510,17 @@ int pubsub_tcpHandler_acceptHandler(pubsub_tcpHandler_t *handle, psa_tcp_connect
 #if defined(__APPLE__)
         struct kevent ev;
         EV_SET (&ev, entry->fd, EVFILT_READ, EV_ADD | EV_ENABLE , 0, 0, 0);
-        rc = kevent (handle->efd, &ev, 1, NULL, 0, NULL);
+        rc = kevent (entry->efd, &ev, 1, NULL, 0, NULL);
 #else
         struct epoll_event event;
         bzero(&event, sizeof(event)); // zero the struct
         event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
         event.data.fd = entry->fd;
         // Register Read to epoll
-        rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, entry->fd, &event);
+        rc = epoll_ctl(entry->efd, EPOLL_CTL_ADD, entry->fd, &event);
 #endif
         if (rc < 0) {
-            pubsub_tcpHandler_freeEntry(entry);
+            pubsub_tcpHandler_freeEntry(handle, entry);
             free(entry);
             L_ERROR("[TCP Socket] Cannot create epoll\n");
         } else {
@@ -1262,14 +1560,14 @@ void pubsub_tcpHandler_connectionHandler(pubsub_tcpHandler_t *handle, int fd) {
 // The main socket event loop
 //
 static inline
-void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
+void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle, int efd, unsigned int timeout) {
   int rc = 0;
-  if (handle->efd >= 0) {
+  if (efd >= 0) {
     int nof_events = 0;
     //  Wait for events.
     struct kevent events[MAX_EVENTS];
-    struct timespec ts = {handle->timeout / 1000, (handle->timeout  % 1000) * 1000000};
-    nof_events = kevent (handle->efd, NULL, 0, &events[0], MAX_EVENTS, handle->timeout ? &ts : NULL);
+    struct timespec ts = {timeout / 1000, (timeout  % 1000) * 1000000};
+    nof_events = kevent (efd, NULL, 0, &events[0], MAX_EVENTS, timeout ? &ts : NULL);
     if (nof_events < 0) {
       if ((errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
       } else
@@ -1286,6 +1584,9 @@ void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
       if (pendingConnectionEntry) {
         int fd = pubsub_tcpHandler_acceptHandler(handle, pendingConnectionEntry);
         pubsub_tcpHandler_connectionHandler(handle, fd);
+      } else if (events[i].filter == EVFILT_WRITE) {
+        int rc = pubsub_tcpHandler_writeHandler(handle, events[i].ident);
+        if (rc < 0) pubsub_tcpHandler_close(handle, events[i].ident);
       } else if (events[i].filter & EVFILT_READ) {
         int rc = pubsub_tcpHandler_read(handle, events[i].ident);
         if (rc == 0) pubsub_tcpHandler_close(handle, events[i].ident);
@@ -1314,12 +1615,12 @@ void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
 // The main socket event loop
 //
 static inline
-void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
+void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle, int efd, unsigned int timeout) {
     int rc = 0;
-    if (handle->efd >= 0) {
+    if (efd >= 0) {
         int nof_events = 0;
         struct epoll_event events[MAX_EVENTS];
-        nof_events = epoll_wait(handle->efd, events, MAX_EVENTS, handle->timeout);
+        nof_events = epoll_wait(efd, events, MAX_EVENTS, timeout);
         if (nof_events < 0) {
             if ((errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
             } else
@@ -1336,7 +1637,16 @@ void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
             if (pendingConnectionEntry) {
                int fd = pubsub_tcpHandler_acceptHandler(handle, pendingConnectionEntry);
                pubsub_tcpHandler_connectionHandler(handle, fd);
-            } else if (events[i].events & EPOLLIN) {
+               continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                rc = pubsub_tcpHandler_writeHandler(handle, events[i].data.fd);
+                if (rc < 0) {
+                    pubsub_tcpHandler_close(handle, events[i].data.fd);
+                    continue;
+                }
+            }
+            if (events[i].events & EPOLLIN) {
                 rc = pubsub_tcpHandler_read(handle, events[i].data.fd);
                 if (rc == 0) pubsub_tcpHandler_close(handle, events[i].data.fd);
             } else if (events[i].events & EPOLLRDHUP) {
@@ -1363,13 +1673,22 @@ void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
 // The socket thread
 //
 static void *pubsub_tcpHandler_thread(void *data) {
-    pubsub_tcpHandler_t *handle = data;
+    psa_tcp_reader_t *reader = data;
+    pubsub_tcpHandler_t *handle = reader->handle;
     celixThreadRwlock_readLock(&handle->dbLock);
     bool running = handle->running;
     celixThreadRwlock_unlock(&handle->dbLock);
 
     while (running) {
-        pubsub_tcpHandler_handler(handle);
+        // The first reader thread also writes the coalesced messages, it wakes up at least every coalesce delay
+        celixThreadRwlock_readLock(&handle->dbLock);
+        bool coalescing = reader == &handle->readers[0] && handle->coalesceSize > 0;
+        unsigned int timeout = coalescing ? MIN(handle->timeout, handle->coalesceDelay) : handle->timeout;
+        celixThreadRwlock_unlock(&handle->dbLock);
+        pubsub_tcpHandler_handler(handle, reader->efd, timeout);
+        if (coalescing) {
+            pubsub_tcpHandler_flushExpired(handle);
+        }
         celixThreadRwlock_readLock(&handle->dbLock);
         running = handle->running;
         celixThreadRwlock_unlock(&handle->dbLock);
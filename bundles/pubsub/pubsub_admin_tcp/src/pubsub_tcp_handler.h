@@ -45,9 +45,19 @@
 #define MAX(a, b) ((a>b) ? (a) : (b))
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct pubsub_tcpHandler pubsub_tcpHandler_t;
+// Write flag, the message is held in the send queue of the connections until a write without this flag
+// or a pubsub_tcpHandler_flush, so a batch of messages is written with one system call per connection.
+#define PUBSUB_TCP_HANDLER_MSG_MORE 0x10000000
+
+// Message callback. When the callback sets release, it takes the ownership of the payload buffer of the message,
+// which should then be freed with free() or pubsub_tcpHandler_releaseReceiveBuffer with the provided payloadCapacity.
 typedef void(*pubsub_tcpHandler_processMessage_callback_t)
-    (void *payload, const pubsub_protocol_message_t *header, bool *release, struct timespec *receiveTime);
+    (void *payload, const pubsub_protocol_message_t *header, size_t payloadCapacity, bool *release, struct timespec *receiveTime);
 typedef void (*pubsub_tcpHandler_receiverConnectMessage_callback_t)(void *payload, const char *url, bool lock);
 typedef void (*pubsub_tcpHandler_acceptConnectMessage_callback_t)(void *payload, const char *url);
 
@@ -59,14 +69,32 @@ int pubsub_tcpHandler_connect(pubsub_tcpHandler_t *handle, char *url);
 int pubsub_tcpHandler_disconnect(pubsub_tcpHandler_t *handle, char *url);
 int pubsub_tcpHandler_listen(pubsub_tcpHandler_t *handle, char *url);
 
+/**
+ * Configures the receive buffers. Receive buffers are taken from a buffer pool of the handler, which caches released
+ * buffers up to (at least) maxNofBuffers buffers of bufferSize.
+ */
 int pubsub_tcpHandler_createReceiveBufferStore(pubsub_tcpHandler_t *handle,
                                                unsigned int maxNofBuffers,
                                                unsigned int bufferSize);
+/**
+ * Acquires a buffer of at least size bytes from the receive buffer pool, e.g. to copy a received payload.
+ * The real size of the buffer is returned in capacity.
+ * The buffer can be freed with free() or released to the pool with pubsub_tcpHandler_releaseReceiveBuffer.
+ */
+void *pubsub_tcpHandler_acquireReceiveBuffer(pubsub_tcpHandler_t *handle, size_t size, size_t *capacity);
+/**
+ * Releases a receive buffer (including the payload of a message for which the processMessage callback set release)
+ * to the buffer pool. capacity should be the capacity returned by the acquire or provided to the callback.
+ */
+void pubsub_tcpHandler_releaseReceiveBuffer(pubsub_tcpHandler_t *handle, void *buffer, size_t capacity);
 void pubsub_tcpHandler_setTimeout(pubsub_tcpHandler_t *handle, unsigned int timeout);
 void pubsub_tcpHandler_setSendRetryCnt(pubsub_tcpHandler_t *handle, unsigned int count);
 void pubsub_tcpHandler_setReceiveRetryCnt(pubsub_tcpHandler_t *handle, unsigned int count);
 void pubsub_tcpHandler_setSendTimeOut(pubsub_tcpHandler_t *handle, double timeout);
 void pubsub_tcpHandler_setReceiveTimeOut(pubsub_tcpHandler_t *handle, double timeout);
+void pubsub_tcpHandler_setSendQueueHighWatermark(pubsub_tcpHandler_t *handle, size_t size);
+void pubsub_tcpHandler_setNofReaderThreads(pubsub_tcpHandler_t *handle, unsigned int nofThreads);
+void pubsub_tcpHandler_setCoalescing(pubsub_tcpHandler_t *handle, size_t size, unsigned int delay);
 
 int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd);
 int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle,
@@ -74,6 +102,7 @@ int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle,
                             struct iovec *msg_iovec,
                             size_t msg_iov_len,
                             int flags);
+int pubsub_tcpHandler_flush(pubsub_tcpHandler_t *handle);
 int pubsub_tcpHandler_addMessageHandler(pubsub_tcpHandler_t *handle,
                                         void *payload,
                                         pubsub_tcpHandler_processMessage_callback_t processMessageCallback);
@@ -89,4 +118,8 @@ char *pubsub_tcpHandler_get_interface_url(pubsub_tcpHandler_t *handle);
 void pubsub_tcpHandler_setThreadPriority(pubsub_tcpHandler_t *handle, long prio, const char *sched);
 void pubsub_tcpHandler_setThreadName(pubsub_tcpHandler_t *handle, const char *topic, const char *scope);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _PUBSUB_TCP_BUFFER_HANDLER_H_ */
@@ -82,10 +82,24 @@ struct pubsub_tcp_topic_receiver {
 
     long subscriberTrackerId;
     struct {
-        celix_thread_mutex_t mutex;
+        celix_thread_rwlock_t lock; //read locked while delivering through the workers, write locked otherwise
         hash_map_t *map; //key = bnd id, value = psa_tcp_subscriber_entry_t
         bool allInitialized;
+        celix_thread_rwlock_t metricsLock; //write locked when adding origins to the metrics maps of the subscriber entries, read locked otherwise
     } subscribers;
+
+    struct {
+        celix_thread_mutex_t mutex; //protects the workers and the subscriber queues
+        celix_thread_cond_t cond;
+        celix_array_list_t *ready; //entries = psa_tcp_subscriber_entry_t* with queued messages waiting for a worker
+        celix_thread_t *threads;
+        unsigned int nrOfThreads; //0 -> messages are delivered on the receiving thread
+        size_t queueSize;
+        bool ordered;
+        bool running;
+        unsigned long maxNrOfQueuedMessages;
+        unsigned long nrOfDroppedMessages;
+    } workers;
 };
 
 typedef struct psa_tcp_requested_connection_entry {
@@ -99,23 +113,35 @@ typedef struct psa_tcp_subscriber_metrics_entry_t {
     unsigned int msgTypeId;
     uuid_t origin;
 
+    //note updated using atomics, because messages can be processed by multiple reader/worker threads
     unsigned long nrOfMessagesReceived;
     unsigned long nrOfSerializationErrors;
-    struct timespec lastMessageReceived;
-    double averageTimeBetweenMessagesInSeconds;
-    double averageSerializationTimeInSeconds;
-    double averageDelayInSeconds;
-    double maxDelayInSeconds;
-    double minDelayInSeconds;
-    unsigned int lastSeqNr;
     unsigned long nrOfMissingSeqNumbers;
+    unsigned int lastSeqNr;
+    int64_t firstMessageReceivedInNs;
+    int64_t lastMessageReceivedInNs;
+    pubsub_admin_metrics_histogram_t *serializationTime;
+    pubsub_admin_metrics_histogram_t *delay;
 } psa_tcp_subscriber_metrics_entry_t;
 
+typedef struct psa_tcp_queued_msg {
+    pubsub_protocol_message_t message; //owns the payload (a receive buffer of the tcp handler) and a copy of the metadata
+    size_t payloadCapacity; //real size of the payload buffer, used to release the buffer to the pool
+    struct timespec receiveTime;
+} psa_tcp_queued_msg_t;
+
 typedef struct psa_tcp_subscriber_entry {
     hash_map_t *msgTypes; //map from serializer svc
     hash_map_t *metrics; //key = msg type id, value = hash_map (key = origin uuid, value = psa_tcp_subscriber_metrics_entry_t*
     hash_map_t *subscriberServices; //key = servide id, value = pubsub_subscriber_t*
     bool initialized; //true if the init function is called through the receive thread
+    struct {
+        psa_tcp_queued_msg_t **msgs; //ring buffer with size receiver->workers.queueSize
+        size_t head;
+        size_t size;
+        bool scheduled; //true if the entry is in the ready list or, for ordered delivery, being delivered by a worker
+        bool full;
+    } queue; //protected by receiver->workers.mutex
 } psa_tcp_subscriber_entry_t;
 
 static void pubsub_tcpTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props,
@@ -126,11 +152,17 @@ static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, co
 
 static void *psa_tcp_recvThread(void *data);
 
+static void *psa_tcp_workerThread(void *data);
+
+static void psa_tcp_clearQueue(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry);
+
+static void psa_tcp_destroySubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry);
+
 static void psa_tcp_connectToAllRequestedConnections(pubsub_tcp_topic_receiver_t *receiver);
 
 static void psa_tcp_initializeAllSubscribers(pubsub_tcp_topic_receiver_t *receiver);
 
-static void processMsg(void *handle, const pubsub_protocol_message_t *hdr, bool *release, struct timespec *receiveTime);
+static void processMsg(void *handle, const pubsub_protocol_message_t *hdr, size_t payloadCapacity, bool *release, struct timespec *receiveTime);
 
 static void psa_tcp_connectHandler(void *handle, const char *url, bool lock);
 
@@ -218,6 +250,10 @@ pubsub_tcp_topic_receiver_t *pubsub_tcpTopicReceiver_create(celix_bundle_context
         long buffer_size = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_RECV_BUFFER_SIZE,
                                                                  PSA_TCP_DEFAULT_RECV_BUFFER_SIZE);
         long timeout = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_TIMEOUT, PSA_TCP_DEFAULT_TIMEOUT);
+        long nrOfReaders = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_RECV_THREADS, PSA_TCP_DEFAULT_RECV_THREADS);
+        if (nrOfReaders > 1) {
+            pubsub_tcpHandler_setNofReaderThreads(receiver->socketHandler, (unsigned int) nrOfReaders);
+        }
         pubsub_tcpHandler_setThreadName(receiver->socketHandler, topic, scope);
         pubsub_tcpHandler_createReceiveBufferStore(receiver->socketHandler, (unsigned int) sessions,
                                                    (unsigned int) buffer_size);
@@ -232,12 +268,26 @@ pubsub_tcp_topic_receiver_t *pubsub_tcpTopicReceiver_create(celix_bundle_context
     receiver->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_TCP_METRICS_ENABLED,
                                                                      PSA_TCP_DEFAULT_METRICS_ENABLED);
 
-    celixThreadMutex_create(&receiver->subscribers.mutex, NULL);
+    celixThreadRwlock_create(&receiver->subscribers.lock, NULL);
+    celixThreadRwlock_create(&receiver->subscribers.metricsLock, NULL);
     celixThreadMutex_create(&receiver->requestedConnections.mutex, NULL);
     celixThreadMutex_create(&receiver->thread.mutex, NULL);
+    celixThreadMutex_create(&receiver->workers.mutex, NULL);
+    celixThreadCondition_init(&receiver->workers.cond, NULL);
 
     receiver->subscribers.map = hashMap_create(NULL, NULL, NULL, NULL);
     receiver->requestedConnections.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+    receiver->workers.ready = celix_arrayList_create();
+
+    long nrOfWorkers = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_SUBSCRIBER_WORKER_THREADS,
+                                                             PSA_TCP_DEFAULT_SUBSCRIBER_WORKER_THREADS);
+    long queueSize = celix_bundleContext_getPropertyAsLong(ctx, PSA_TCP_SUBSCRIBER_QUEUE_SIZE,
+                                                           PSA_TCP_DEFAULT_SUBSCRIBER_QUEUE_SIZE);
+    const char *ordering = celix_bundleContext_getProperty(ctx, PSA_TCP_SUBSCRIBER_ORDERING,
+                                                           PSA_TCP_DEFAULT_SUBSCRIBER_ORDERING);
+    receiver->workers.nrOfThreads = nrOfWorkers > 0 ? (unsigned int) nrOfWorkers : 0;
+    receiver->workers.queueSize = queueSize > 0 ? (size_t) queueSize : PSA_TCP_DEFAULT_SUBSCRIBER_QUEUE_SIZE;
+    receiver->workers.ordered = strncmp(ordering, PSA_TCP_SUBSCRIBER_ORDERING_NONE, strlen(PSA_TCP_SUBSCRIBER_ORDERING_NONE) + 1) != 0;
 
     if ((staticConnectUrls != NULL) && (receiver->socketHandler != NULL) && (staticServerEndPointUrls == NULL)) {
         char *urlsCopy = strndup(staticConnectUrls, 1024 * 1024);
@@ -264,6 +314,17 @@ pubsub_tcp_topic_receiver_t *pubsub_tcpTopicReceiver_create(celix_bundle_context
         celixThread_setName(&receiver->thread.thread, name);
     }
 
+    if (receiver->socketHandler != NULL && receiver->workers.nrOfThreads > 0) {
+        receiver->workers.running = true;
+        receiver->workers.threads = calloc(receiver->workers.nrOfThreads, sizeof(*receiver->workers.threads));
+        for (unsigned int i = 0; i < receiver->workers.nrOfThreads; ++i) {
+            celixThread_create(&receiver->workers.threads[i], NULL, psa_tcp_workerThread, receiver);
+            char name[64];
+            snprintf(name, 64, "TCP TW %s/%s", scope == NULL ? "(null)" : scope, topic);
+            celixThread_setName(&receiver->workers.threads[i], name);
+        }
+    }
+
     //track subscribers
     if (receiver->socketHandler != NULL) {
         int size = snprintf(NULL, 0, "(%s=%s)", PUBSUB_SUBSCRIBER_TOPIC, topic);
@@ -301,28 +362,31 @@ void pubsub_tcpTopicReceiver_destroy(pubsub_tcp_topic_receiver_t *receiver) {
             celixThread_join(receiver->thread.thread, NULL);
         }
 
+        celixThreadMutex_lock(&receiver->workers.mutex);
+        bool workersRunning = receiver->workers.running;
+        receiver->workers.running = false;
+        celixThreadCondition_broadcast(&receiver->workers.cond);
+        celixThreadMutex_unlock(&receiver->workers.mutex);
+        if (workersRunning) {
+            for (unsigned int i = 0; i < receiver->workers.nrOfThreads; ++i) {
+                celixThread_join(receiver->workers.threads[i], NULL);
+            }
+        }
+        free(receiver->workers.threads);
+
         celix_bundleContext_stopTracker(receiver->ctx, receiver->subscriberTrackerId);
 
-        celixThreadMutex_lock(&receiver->subscribers.mutex);
+        celixThreadRwlock_writeLock(&receiver->subscribers.lock);
         hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
         while (hashMapIterator_hasNext(&iter)) {
             psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
             if (entry != NULL) {
-                receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
-                hashMap_destroy(entry->subscriberServices, false, false);
-                free(entry);
-            }
-
-            hash_map_iterator_t iter2 = hashMapIterator_construct(entry->metrics);
-            while (hashMapIterator_hasNext(&iter2)) {
-                hash_map_t *origins = hashMapIterator_nextValue(&iter2);
-                hashMap_destroy(origins, true, true);
+                psa_tcp_destroySubscriberEntry(receiver, entry);
             }
-            hashMap_destroy(entry->metrics, false, false);
         }
         hashMap_destroy(receiver->subscribers.map, false, false);
 
-        celixThreadMutex_unlock(&receiver->subscribers.mutex);
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
 
         celixThreadMutex_lock(&receiver->requestedConnections.mutex);
         iter = hashMapIterator_construct(receiver->requestedConnections.map);
@@ -336,9 +400,13 @@ void pubsub_tcpTopicReceiver_destroy(pubsub_tcp_topic_receiver_t *receiver) {
         hashMap_destroy(receiver->requestedConnections.map, false, false);
         celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-        celixThreadMutex_destroy(&receiver->subscribers.mutex);
+        celixThreadRwlock_destroy(&receiver->subscribers.lock);
+        celixThreadRwlock_destroy(&receiver->subscribers.metricsLock);
         celixThreadMutex_destroy(&receiver->requestedConnections.mutex);
         celixThreadMutex_destroy(&receiver->thread.mutex);
+        celixThreadMutex_destroy(&receiver->workers.mutex);
+        celixThreadCondition_destroy(&receiver->workers.cond);
+        celix_arrayList_destroy(receiver->workers.ready);
 
         pubsub_tcpHandler_addMessageHandler(receiver->socketHandler, NULL, NULL);
         pubsub_tcpHandler_addReceiverConnectionCallback(receiver->socketHandler, NULL, NULL, NULL);
@@ -453,7 +521,7 @@ static void pubsub_tcpTopicReceiver_addSubscriber(void *handle, void *svc, const
         return;
     }
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     psa_tcp_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void *) bndId);
     if (entry != NULL) {
         hashMap_put(entry->subscriberServices, (void*)svcId, svc);
@@ -462,6 +530,9 @@ static void pubsub_tcpTopicReceiver_addSubscriber(void *handle, void *svc, const
         entry = calloc(1, sizeof(*entry));
         entry->subscriberServices = hashMap_create(NULL, NULL, NULL, NULL);
         entry->initialized = false;
+        if (receiver->workers.nrOfThreads > 0) {
+            entry->queue.msgs = calloc(receiver->workers.queueSize, sizeof(*entry->queue.msgs));
+        }
         receiver->subscribers.allInitialized = false;
 
         hashMap_put(entry->subscriberServices, (void*)svcId, svc);
@@ -485,10 +556,12 @@ static void pubsub_tcpTopicReceiver_addSubscriber(void *handle, void *svc, const
             L_ERROR("[PSA_TCP] Cannot create msg serializer map for TopicReceiver %s/%s",
                     receiver->scope == NULL ? "(null)" : receiver->scope,
                     receiver->topic);
+            hashMap_destroy(entry->subscriberServices, false, false);
+            free(entry->queue.msgs);
             free(entry);
         }
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 }
 
 static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props,
@@ -499,7 +572,8 @@ static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, co
     long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
 
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    //note write lock ensures that no worker is delivering a message to the entry
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     psa_tcp_subscriber_entry_t *entry = hashMap_get(receiver->subscribers.map, (void *) bndId);
     if (entry != NULL) {
         hashMap_remove(entry->subscriberServices, (void*)svcId);
@@ -507,28 +581,125 @@ static void pubsub_tcpTopicReceiver_removeSubscriber(void *handle, void *svc, co
     if (entry != NULL && hashMap_size(entry->subscriberServices) == 0) {
         //remove entry
         hashMap_remove(receiver->subscribers.map, (void *) bndId);
-        int rc = receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
-        if (rc != 0) {
-            L_ERROR("[PSA_TCP] Cannot destroy msg serializers map for TopicReceiver %s/%s",
-                    receiver->scope == NULL ? "(null)" : receiver->scope,
-                    receiver->topic);
+        psa_tcp_destroySubscriberEntry(receiver, entry);
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+}
+
+static void psa_tcp_destroySubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry) {
+    //NOTE receiver->subscribers.lock write locked
+    psa_tcp_clearQueue(receiver, entry);
+    int rc = receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
+    if (rc != 0) {
+        L_ERROR("[PSA_TCP] Cannot destroy msg serializers map for TopicReceiver %s/%s",
+                receiver->scope == NULL ? "(null)" : receiver->scope,
+                receiver->topic);
+    }
+    hash_map_iterator_t iter = hashMapIterator_construct(entry->metrics);
+    while (hashMapIterator_hasNext(&iter)) {
+        hash_map_t *origins = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(origins);
+        while (hashMapIterator_hasNext(&iter2)) {
+            psa_tcp_subscriber_metrics_entry_t *metrics = hashMapIterator_nextValue(&iter2);
+            pubsub_metricsHistogram_destroy(metrics->serializationTime);
+            pubsub_metricsHistogram_destroy(metrics->delay);
         }
-        hash_map_iterator_t iter = hashMapIterator_construct(entry->metrics);
-        while (hashMapIterator_hasNext(&iter)) {
-            hash_map_t *origins = hashMapIterator_nextValue(&iter);
-            hashMap_destroy(origins, true, true);
+        hashMap_destroy(origins, true, true);
+    }
+    hashMap_destroy(entry->metrics, false, false);
+    hashMap_destroy(entry->subscriberServices, false, false);
+    free(entry->queue.msgs);
+    free(entry);
+}
+
+/**
+ * Returns the metrics entry for the msg type and origin of the message. The origin is taken from the metadata added
+ * by the sender if metrics are enabled, messages without an origin (or of an origin above the
+ * PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS limit) are counted for the null UUID origin.
+ * The metrics lock is only write locked to add a new origin.
+ */
+static psa_tcp_subscriber_metrics_entry_t *psa_tcp_getMetricsEntry(pubsub_tcp_topic_receiver_t *receiver,
+                                                                   psa_tcp_subscriber_entry_t *entry,
+                                                                   const pubsub_protocol_message_t *message) {
+    const char *origin = NULL;
+    if (message->metadata.metadata != NULL) {
+        origin = celix_properties_get(message->metadata.metadata, PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY, NULL);
+    }
+    if (origin == NULL) {
+        origin = "";
+    }
+    hash_map_t *origins = hashMap_get(entry->metrics, (void *) (uintptr_t) message->header.msgId);
+    if (origins == NULL) {
+        return NULL;
+    }
+    celixThreadRwlock_readLock(&receiver->subscribers.metricsLock);
+    psa_tcp_subscriber_metrics_entry_t *metrics = hashMap_get(origins, origin);
+    celixThreadRwlock_unlock(&receiver->subscribers.metricsLock);
+    if (metrics != NULL) {
+        return metrics;
+    }
+
+    celixThreadRwlock_writeLock(&receiver->subscribers.metricsLock);
+    if (hashMap_size(origins) >= PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS && !hashMap_containsKey(origins, origin)) {
+        origin = "";
+    }
+    metrics = hashMap_get(origins, origin);
+    if (metrics == NULL) {
+        metrics = calloc(1, sizeof(*metrics));
+        if (metrics != NULL) {
+            metrics->msgTypeId = message->header.msgId;
+            if (uuid_parse(origin, metrics->origin) != 0) {
+                uuid_clear(metrics->origin);
+            }
+            metrics->serializationTime = pubsub_metricsHistogram_create();
+            metrics->delay = pubsub_metricsHistogram_create();
+            hashMap_put(origins, strndup(origin, UUID_STR_LEN + 1), metrics);
         }
-        hashMap_destroy(entry->metrics, false, false);
-        hashMap_destroy(entry->subscriberServices, false, false);
-        free(entry);
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.metricsLock);
+    return metrics;
+}
+
+static void psa_tcp_updateMetrics(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry,
+                                  const pubsub_protocol_message_t *message, const struct timespec *receiveTime,
+                                  const struct timespec *beginSer, const struct timespec *endSer,
+                                  int updateReceiveCount, int updateSerError) {
+    psa_tcp_subscriber_metrics_entry_t *metrics = psa_tcp_getMetricsEntry(receiver, entry, message);
+    if (metrics == NULL) {
+        return;
+    }
+    pubsub_metricsHistogram_record(metrics->serializationTime, celix_difftime(beginSer, endSer));
+    int64_t receiveTimeInNs = pubsub_metrics_timespecToNs(receiveTime);
+    long sendTimeInNs = 0;
+    if (message->metadata.metadata != NULL) {
+        sendTimeInNs = celix_properties_getAsLong(message->metadata.metadata, PUBSUB_ADMIN_METRICS_SEND_TIME_KEY, 0);
+    }
+    if (sendTimeInNs > 0) {
+        pubsub_metricsHistogram_record(metrics->delay, (double)(receiveTimeInNs - sendTimeInNs) / 1000000000.0);
+    }
+
+    unsigned int seqNr = message->header.seqNr;
+    unsigned int lastSeqNr = __atomic_exchange_n(&metrics->lastSeqNr, seqNr, __ATOMIC_RELAXED);
+    int64_t noTime = 0;
+    bool first = __atomic_compare_exchange_n(&metrics->firstMessageReceivedInNs, &noTime, receiveTimeInNs, false,
+                                             __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    unsigned int incr = seqNr - lastSeqNr;
+    if (!first && incr > 1 && incr < UINT32_MAX / 2) { //note a large increment is a restarted publisher
+        __atomic_fetch_add(&metrics->nrOfMissingSeqNumbers, incr - 1, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&metrics->lastMessageReceivedInNs, receiveTimeInNs, __ATOMIC_RELAXED);
+    if (updateReceiveCount > 0) {
+        __atomic_fetch_add(&metrics->nrOfMessagesReceived, updateReceiveCount, __ATOMIC_RELAXED);
+    }
+    if (updateSerError > 0) {
+        __atomic_fetch_add(&metrics->nrOfSerializationErrors, updateSerError, __ATOMIC_RELAXED);
+    }
 }
 
 static inline void
 processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry,
                              const pubsub_protocol_message_t *message, bool *releaseMsg, struct timespec *receiveTime) {
-    //NOTE receiver->subscribers.mutex locked
+    //NOTE receiver->subscribers.lock locked
     pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void *) (uintptr_t) (message->header.msgId));
     bool monitor = receiver->metricsEnabled;
 
@@ -580,9 +751,6 @@ processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subs
                 if (release) {
                     msgSer->freeDeserializeMsg(msgSer->handle, deSerializedMsg);
                 }
-                if (message->metadata.metadata) {
-                    celix_properties_destroy(message->metadata.metadata);
-                }
                 updateReceiveCount += 1;
             } else {
                 updateSerError += 1;
@@ -593,20 +761,214 @@ processMsgForSubscriberEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subs
     } else {
         L_WARN("[PSA_TCP_TR] Cannot find serializer for type id 0x%X. Received payload size is %u.", message->header.msgId, message->payload.length);
     }
+
+    if (monitor && (updateReceiveCount > 0 || updateSerError > 0)) {
+        psa_tcp_updateMetrics(receiver, entry, message, receiveTime, &beginSer, &endSer, updateReceiveCount, updateSerError);
+    }
+}
+
+/**
+ * Creates a queued message. If takePayload is true, the queued message takes over the receive buffer of the tcp
+ * handler instead of copying the payload.
+ * Returns NULL if the message cannot be allocated, the payload is then not taken over.
+ */
+static psa_tcp_queued_msg_t *psa_tcp_createQueuedMsg(pubsub_tcp_topic_receiver_t *receiver, const pubsub_protocol_message_t *message,
+                                                     size_t payloadCapacity, struct timespec *receiveTime, bool takePayload) {
+    psa_tcp_queued_msg_t *msg = malloc(sizeof(*msg));
+    if (msg == NULL) {
+        return NULL;
+    }
+    msg->message.header = message->header;
+    msg->message.payload.length = message->payload.length;
+    if (takePayload) {
+        msg->message.payload.payload = message->payload.payload;
+        msg->payloadCapacity = payloadCapacity;
+    } else {
+        msg->message.payload.payload = pubsub_tcpHandler_acquireReceiveBuffer(receiver->socketHandler, message->payload.length, &msg->payloadCapacity);
+        if (msg->message.payload.payload == NULL) {
+            free(msg);
+            return NULL;
+        }
+        memcpy(msg->message.payload.payload, message->payload.payload, message->payload.length);
+    }
+    msg->message.metadata.metadata = message->metadata.metadata == NULL ? NULL : celix_properties_copy(message->metadata.metadata);
+    msg->receiveTime = *receiveTime;
+    return msg;
+}
+
+static void psa_tcp_destroyQueuedMsg(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_queued_msg_t *msg, bool payloadReleased) {
+    if (!payloadReleased) {
+        pubsub_tcpHandler_releaseReceiveBuffer(receiver->socketHandler, msg->message.payload.payload, msg->payloadCapacity);
+    }
+    if (msg->message.metadata.metadata != NULL) {
+        celix_properties_destroy(msg->message.metadata.metadata);
+    }
+    free(msg);
+}
+
+static void psa_tcp_scheduleEntry(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry) {
+    //NOTE receiver->workers.mutex locked
+    if (entry->queue.size > 0) {
+        entry->queue.scheduled = true;
+        celix_arrayList_add(receiver->workers.ready, entry);
+        celixThreadCondition_signal(&receiver->workers.cond);
+    } else {
+        entry->queue.scheduled = false;
+    }
+}
+
+/**
+ * Queues the message for the subscriber entry. If the queue of the (slow) subscriber is full, the message
+ * is dropped for this subscriber only, so that the other subscribers and the receiving thread are not blocked.
+ * Returns whether the payload is taken over; if so, the payload can be released by a worker as soon as this
+ * function is called, so the payload must not be used afterwards.
+ */
+static bool psa_tcp_enqueueMsg(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry,
+                               const pubsub_protocol_message_t *message, size_t payloadCapacity,
+                               struct timespec *receiveTime, bool takePayload) {
+    //NOTE receiver->subscribers.lock read locked
+    psa_tcp_queued_msg_t *msg = psa_tcp_createQueuedMsg(receiver, message, payloadCapacity, receiveTime, takePayload);
+    if (msg == NULL) {
+        L_ERROR("[PSA_TCP_TR] Cannot allocate queued msg for scope/topic %s/%s, dropping message",
+                receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        celixThreadMutex_lock(&receiver->workers.mutex);
+        receiver->workers.nrOfDroppedMessages += 1;
+        celixThreadMutex_unlock(&receiver->workers.mutex);
+        return false;
+    }
+    celixThreadMutex_lock(&receiver->workers.mutex);
+    if (entry->queue.size < receiver->workers.queueSize) {
+        size_t index = (entry->queue.head + entry->queue.size) % receiver->workers.queueSize;
+        entry->queue.msgs[index] = msg;
+        entry->queue.size += 1;
+        entry->queue.full = false;
+        msg = NULL;
+        receiver->workers.maxNrOfQueuedMessages = MAX(receiver->workers.maxNrOfQueuedMessages, entry->queue.size);
+        if (!entry->queue.scheduled) {
+            psa_tcp_scheduleEntry(receiver, entry);
+        }
+    } else {
+        receiver->workers.nrOfDroppedMessages += 1;
+        if (!entry->queue.full) {
+            entry->queue.full = true;
+            L_WARN("[PSA_TCP_TR] Subscriber queue for scope/topic %s/%s is full, dropping messages",
+                   receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        }
+    }
+    celixThreadMutex_unlock(&receiver->workers.mutex);
+    if (msg != NULL) {
+        psa_tcp_destroyQueuedMsg(receiver, msg, false);
+    }
+    return takePayload;
+}
+
+static psa_tcp_queued_msg_t *psa_tcp_dequeueMsg(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry) {
+    //NOTE receiver->workers.mutex locked
+    psa_tcp_queued_msg_t *msg = NULL;
+    if (entry->queue.size > 0) {
+        msg = entry->queue.msgs[entry->queue.head];
+        entry->queue.msgs[entry->queue.head] = NULL;
+        entry->queue.head = (entry->queue.head + 1) % receiver->workers.queueSize;
+        entry->queue.size -= 1;
+    }
+    return msg;
+}
+
+static void psa_tcp_clearQueue(pubsub_tcp_topic_receiver_t *receiver, psa_tcp_subscriber_entry_t *entry) {
+    //NOTE receiver->subscribers.lock write locked, so the entry is not being delivered by a worker
+    celixThreadMutex_lock(&receiver->workers.mutex);
+    celix_arrayList_remove(receiver->workers.ready, entry);
+    psa_tcp_queued_msg_t *msg = psa_tcp_dequeueMsg(receiver, entry);
+    while (msg != NULL) {
+        psa_tcp_destroyQueuedMsg(receiver, msg, false);
+        msg = psa_tcp_dequeueMsg(receiver, entry);
+    }
+    entry->queue.scheduled = false;
+    celixThreadMutex_unlock(&receiver->workers.mutex);
 }
 
 static void
-processMsg(void *handle, const pubsub_protocol_message_t *message, bool *release, struct timespec *receiveTime) {
+processMsg(void *handle, const pubsub_protocol_message_t *message, size_t payloadCapacity, bool *release, struct timespec *receiveTime) {
     pubsub_tcp_topic_receiver_t *receiver = handle;
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
-    while (hashMapIterator_hasNext(&iter)) {
-        psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
-        if (entry != NULL) {
-            processMsgForSubscriberEntry(receiver, entry, message, release, receiveTime);
+    if (receiver->workers.nrOfThreads > 0) {
+        //the last subscriber entry takes over the receive buffer, the other entries need a copy of the payload.
+        //Note the copies are made before the buffer is handed over, because a worker can release the buffer as soon
+        //as it is queued.
+        celixThreadRwlock_readLock(&receiver->subscribers.lock);
+        int remaining = hashMap_size(receiver->subscribers.map);
+        hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+            remaining -= 1;
+            if (entry != NULL && psa_tcp_enqueueMsg(receiver, entry, message, payloadCapacity, receiveTime, !*release && remaining == 0)) {
+                *release = true;
+            }
         }
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
+    } else {
+        //note write lock, so that a subscriber is never called concurrently by multiple receiving threads
+        celixThreadRwlock_writeLock(&receiver->subscribers.lock);
+        hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (entry != NULL) {
+                processMsgForSubscriberEntry(receiver, entry, message, release, receiveTime);
+            }
+        }
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
+    }
+}
+
+/**
+ * Delivers a single queued message. For ordered delivery the subscriber entry is only rescheduled after the message
+ * is delivered, so that the messages of a subscriber are delivered one at a time in receive order.
+ */
+static void psa_tcp_deliverQueuedMsg(pubsub_tcp_topic_receiver_t *receiver) {
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
+    psa_tcp_subscriber_entry_t *entry = NULL;
+    psa_tcp_queued_msg_t *msg = NULL;
+    celixThreadMutex_lock(&receiver->workers.mutex);
+    if (celix_arrayList_size(receiver->workers.ready) > 0) {
+        entry = celix_arrayList_get(receiver->workers.ready, 0);
+        celix_arrayList_removeAt(receiver->workers.ready, 0);
+        msg = psa_tcp_dequeueMsg(receiver, entry);
+        if (!receiver->workers.ordered) {
+            psa_tcp_scheduleEntry(receiver, entry);
+        }
+    }
+    celixThreadMutex_unlock(&receiver->workers.mutex);
+
+    if (msg != NULL) {
+        bool payloadReleased = false;
+        processMsgForSubscriberEntry(receiver, entry, &msg->message, &payloadReleased, &msg->receiveTime);
+        psa_tcp_destroyQueuedMsg(receiver, msg, payloadReleased);
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    if (entry != NULL && receiver->workers.ordered) {
+        celixThreadMutex_lock(&receiver->workers.mutex);
+        psa_tcp_scheduleEntry(receiver, entry);
+        celixThreadMutex_unlock(&receiver->workers.mutex);
+    }
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
+}
+
+static void *psa_tcp_workerThread(void *data) {
+    pubsub_tcp_topic_receiver_t *receiver = data;
+
+    celixThreadMutex_lock(&receiver->workers.mutex);
+    bool running = receiver->workers.running;
+    celixThreadMutex_unlock(&receiver->workers.mutex);
+
+    while (running) {
+        psa_tcp_deliverQueuedMsg(receiver);
+
+        celixThreadMutex_lock(&receiver->workers.mutex);
+        while (receiver->workers.running && celix_arrayList_size(receiver->workers.ready) == 0) {
+            celixThreadCondition_wait(&receiver->workers.cond, &receiver->workers.mutex);
+        }
+        running = receiver->workers.running;
+        celixThreadMutex_unlock(&receiver->workers.mutex);
+    }
+    return NULL;
 }
 
 static void *psa_tcp_recvThread(void *data) {
@@ -620,9 +982,9 @@ static void *psa_tcp_recvThread(void *data) {
     bool allConnected = receiver->requestedConnections.allConnected;
     celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
     bool allInitialized = receiver->subscribers.allInitialized;
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 
     while (running) {
         if (!allConnected) {
@@ -641,13 +1003,35 @@ static void *psa_tcp_recvThread(void *data) {
         allConnected = receiver->requestedConnections.allConnected;
         celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-        celixThreadMutex_lock(&receiver->subscribers.mutex);
+        celixThreadRwlock_readLock(&receiver->subscribers.lock);
         allInitialized = receiver->subscribers.allInitialized;
-        celixThreadMutex_unlock(&receiver->subscribers.mutex);
+        celixThreadRwlock_unlock(&receiver->subscribers.lock);
     } // while
     return NULL;
 }
 
+static void psa_tcp_fillOriginMetrics(psa_tcp_subscriber_metrics_entry_t *metrics,
+                                      struct pubsub_admin_receiver_origin_metrics *out) {
+    uuid_copy(out->originUUID, metrics->origin);
+    out->nrOfMessagesReceived = __atomic_load_n(&metrics->nrOfMessagesReceived, __ATOMIC_RELAXED);
+    out->nrOfSerializationErrors = __atomic_load_n(&metrics->nrOfSerializationErrors, __ATOMIC_RELAXED);
+    out->nrOfMissingSeqNumbers = __atomic_load_n(&metrics->nrOfMissingSeqNumbers, __ATOMIC_RELAXED);
+    pubsub_metricsHistogram_summary(metrics->serializationTime, &out->serializationTime);
+    pubsub_metricsHistogram_summary(metrics->delay, &out->delay);
+    out->averageSerializationTimeInSeconds = out->serializationTime.averageInSeconds;
+    out->averageDelayInSeconds = out->delay.averageInSeconds;
+    out->minDelayInSeconds = out->delay.minInSeconds;
+    out->maxDelayInSeconds = out->delay.maxInSeconds;
+    int64_t first = __atomic_load_n(&metrics->firstMessageReceivedInNs, __ATOMIC_RELAXED);
+    int64_t last = __atomic_load_n(&metrics->lastMessageReceivedInNs, __ATOMIC_RELAXED);
+    unsigned long n = out->nrOfMessagesReceived + out->nrOfSerializationErrors;
+    if (n > 1) {
+        out->averageTimeBetweenMessagesInSeconds = (double) (last - first) / (double) (n - 1) / 1000000000.0;
+    }
+    out->lastMessageReceived.tv_sec = (time_t) (last / 1000000000);
+    out->lastMessageReceived.tv_nsec = (long) (last % 1000000000);
+}
+
 pubsub_admin_receiver_metrics_t *pubsub_tcpTopicReceiver_metrics(pubsub_tcp_topic_receiver_t *receiver) {
     pubsub_admin_receiver_metrics_t *result = calloc(1, sizeof(*result));
     snprintf(result->scope,
@@ -657,8 +1041,19 @@ pubsub_admin_receiver_metrics_t *pubsub_tcpTopicReceiver_metrics(pubsub_tcp_topi
     snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
 
     int msgTypesCount = 0;
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_readLock(&receiver->subscribers.lock);
+    celixThreadMutex_lock(&receiver->workers.mutex);
+    result->maxNrOfQueuedMessages = receiver->workers.maxNrOfQueuedMessages;
+    result->nrOfDroppedMessages = receiver->workers.nrOfDroppedMessages;
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+        result->nrOfQueuedMessages += entry->queue.size;
+    }
+    celixThreadMutex_unlock(&receiver->workers.mutex);
+
+    celixThreadRwlock_readLock(&receiver->subscribers.metricsLock);
+    iter = hashMapIterator_construct(receiver->subscribers.map);
     while (hashMapIterator_hasNext(&iter)) {
         psa_tcp_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
         hash_map_iterator_t iter2 = hashMapIterator_construct(entry->metrics);
@@ -688,18 +1083,7 @@ pubsub_admin_receiver_metrics_t *pubsub_tcpTopicReceiver_metrics(pubsub_tcp_topi
                 pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void *) (uintptr_t) metrics->msgTypeId);
                 if (msgSer) {
                     snprintf(result->msgTypes[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", msgSer->msgName);
-                    uuid_copy(result->msgTypes[i].origins[k].originUUID, metrics->origin);
-                    result->msgTypes[i].origins[k].nrOfMessagesReceived = metrics->nrOfMessagesReceived;
-                    result->msgTypes[i].origins[k].nrOfSerializationErrors = metrics->nrOfSerializationErrors;
-                    result->msgTypes[i].origins[k].averageDelayInSeconds = metrics->averageDelayInSeconds;
-                    result->msgTypes[i].origins[k].maxDelayInSeconds = metrics->maxDelayInSeconds;
-                    result->msgTypes[i].origins[k].minDelayInSeconds = metrics->minDelayInSeconds;
-                    result->msgTypes[i].origins[k].averageTimeBetweenMessagesInSeconds =
-                        metrics->averageTimeBetweenMessagesInSeconds;
-                    result->msgTypes[i].origins[k].averageSerializationTimeInSeconds =
-                        metrics->averageSerializationTimeInSeconds;
-                    result->msgTypes[i].origins[k].lastMessageReceived = metrics->lastMessageReceived;
-                    result->msgTypes[i].origins[k].nrOfMissingSeqNumbers = metrics->nrOfMissingSeqNumbers;
+                    psa_tcp_fillOriginMetrics(metrics, &result->msgTypes[i].origins[k]);
 
                     k += 1;
                 } else {
@@ -710,7 +1094,8 @@ pubsub_admin_receiver_metrics_t *pubsub_tcpTopicReceiver_metrics(pubsub_tcp_topi
             i += 1;
         }
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.metricsLock);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
     return result;
 }
 
@@ -773,7 +1158,7 @@ static void psa_tcp_disConnectHandler(void *handle, const char *url, bool lock)
 }
 
 static void psa_tcp_initializeAllSubscribers(pubsub_tcp_topic_receiver_t *receiver) {
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    celixThreadRwlock_writeLock(&receiver->subscribers.lock);
     if (!receiver->subscribers.allInitialized) {
         bool allInitialized = true;
         hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
@@ -799,7 +1184,7 @@ static void psa_tcp_initializeAllSubscribers(pubsub_tcp_topic_receiver_t *receiv
         }
         receiver->subscribers.allInitialized = allInitialized;
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    celixThreadRwlock_unlock(&receiver->subscribers.lock);
 }
 
 static bool psa_tcp_checkVersion(version_pt msgVersion, uint16_t major, uint16_t minor) {
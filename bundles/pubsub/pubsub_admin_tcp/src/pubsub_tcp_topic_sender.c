@@ -56,6 +56,7 @@ struct pubsub_tcp_topic_sender {
     long protocolSvcId;
     pubsub_protocol_service_t *protocol;
     uuid_t fwUUID;
+    char fwUUIDStr[UUID_STR_LEN+1];
     bool metricsEnabled;
     pubsub_tcpHandler_t *socketHandler;
     pubsub_tcpHandler_t *sharedSocketHandler;
@@ -89,13 +90,13 @@ typedef struct psa_tcp_send_msg_entry {
     size_t serializedIoVecOutputLen;
     unsigned int seqNr;
     struct {
-        celix_thread_mutex_t mutex; //protects entries in struct
+        //note updated using atomics, so that sending threads do not contend on a metrics lock
         unsigned long nrOfMessagesSend;
         unsigned long nrOfMessagesSendFailed;
         unsigned long nrOfSerializationErrors;
-        struct timespec lastMessageSend;
-        double averageTimeBetweenMessagesInSeconds;
-        double averageSerializationTimeInSeconds;
+        int64_t firstMessageSendInNs;
+        int64_t lastMessageSendInNs;
+        pubsub_admin_metrics_histogram_t *serializationTime;
     } metrics;
 } psa_tcp_send_msg_entry_t;
 
@@ -122,6 +123,9 @@ static void delay_first_send_for_late_joiners(pubsub_tcp_topic_sender_t *sender)
 static int
 psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *msg, celix_properties_t *metadata);
 
+static int
+psa_tcp_topicPublicationSendMany(void *handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
+
 pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
     celix_bundle_context_t *ctx,
     celix_log_helper_t *logHelper,
@@ -144,6 +148,7 @@ pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
     if (uuid != NULL) {
         uuid_parse(uuid, sender->fwUUID);
     }
+    uuid_unparse(sender->fwUUID, sender->fwUUIDStr);
     sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_TCP_METRICS_ENABLED,
                                                                    PSA_TCP_DEFAULT_METRICS_ENABLED);
     bool isEndpoint = false;
@@ -202,10 +207,25 @@ pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
         double timeout = celix_properties_getAsDouble(topicProperties, PUBSUB_TCP_PUBLISHER_SNDTIMEO_KEY,
                                                                        (!isEndpoint) ? PUBSUB_TCP_PUBLISHER_SNDTIMEO_DEFAULT :
                                                                                        PUBSUB_TCP_PUBLISHER_SNDTIMEO_ENDPOINT_DEFAULT);
+        long sendQueueHwm = celix_properties_getAsLong(topicProperties, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_KEY,
+                                                       PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_DEFAULT);
+        long coalesceSize = celix_properties_getAsLong(topicProperties, PUBSUB_TCP_PUBLISHER_COALESCE_SIZE_KEY,
+                                                       PUBSUB_TCP_PUBLISHER_COALESCE_SIZE_DEFAULT);
+        long coalesceDelay = celix_properties_getAsLong(topicProperties, PUBSUB_TCP_PUBLISHER_COALESCE_DELAY_KEY,
+                                                        PUBSUB_TCP_PUBLISHER_COALESCE_DELAY_DEFAULT);
         pubsub_tcpHandler_setThreadName(sender->socketHandler, topic, scope);
         pubsub_tcpHandler_setThreadPriority(sender->socketHandler, prio, sched);
         pubsub_tcpHandler_setSendRetryCnt(sender->socketHandler, (unsigned int) retryCnt);
         pubsub_tcpHandler_setSendTimeOut(sender->socketHandler, timeout);
+        if (sendQueueHwm <= 0) {
+            L_WARN("Invalid %s %li for TCP TopicSender %s, using %i", PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_KEY, sendQueueHwm,
+                   topic, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_DEFAULT);
+            sendQueueHwm = PUBSUB_TCP_PUBLISHER_SEND_QUEUE_HWM_DEFAULT;
+        }
+        pubsub_tcpHandler_setSendQueueHighWatermark(sender->socketHandler, (size_t) sendQueueHwm);
+        if (coalesceSize > 0) {
+            pubsub_tcpHandler_setCoalescing(sender->socketHandler, (size_t) coalesceSize, (unsigned int) coalesceDelay);
+        }
     }
 
     //setting up tcp socket for TCP TopicSender
@@ -301,7 +321,7 @@ void pubsub_tcpTopicSender_destroy(pubsub_tcp_topic_sender_t *sender) {
                     if (msgEntry->serializedIoVecOutput)
                         free(msgEntry->serializedIoVecOutput);
                     msgEntry->serializedIoVecOutput = NULL;
-                    celixThreadMutex_destroy(&msgEntry->metrics.mutex);
+                    pubsub_metricsHistogram_destroy(msgEntry->metrics.serializationTime);
                     free(msgEntry);
                 }
                 hashMap_destroy(entry->msgEntries, false, false);
@@ -399,7 +419,7 @@ static void *psa_tcp_getPublisherService(void *handle, const celix_bundle_t *req
                 sendEntry->major = (uint8_t) major;
                 sendEntry->minor = (uint8_t) minor;
                 uuid_copy(sendEntry->originUUID, sender->fwUUID);
-                celixThreadMutex_create(&sendEntry->metrics.mutex, NULL);
+                sendEntry->metrics.serializationTime = pubsub_metricsHistogram_create();
                 hashMap_put(entry->msgEntries, key, sendEntry);
                 hashMap_put(entry->msgTypeIds, strndup(sendEntry->msgSer->msgName, 1024),
                             (void *) (uintptr_t) sendEntry->msgSer->msgId);
@@ -407,6 +427,7 @@ static void *psa_tcp_getPublisherService(void *handle, const celix_bundle_t *req
             entry->service.handle = entry;
             entry->service.localMsgTypeIdForMsgType = psa_tcp_localMsgTypeIdForMsgType;
             entry->service.send = psa_tcp_topicPublicationSend;
+            entry->service.sendMany = psa_tcp_topicPublicationSendMany;
             hashMap_put(sender->boundedServices.map, (void *) bndId, entry);
         } else {
             L_ERROR("Error creating serializer map for TCP TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
@@ -441,7 +462,7 @@ static void psa_tcp_ungetPublisherService(void *handle, const celix_bundle_t *re
             if (msgEntry->serializedIoVecOutput)
                 free(msgEntry->serializedIoVecOutput);
             msgEntry->serializedIoVecOutput = NULL;
-            celixThreadMutex_destroy(&msgEntry->metrics.mutex);
+            pubsub_metricsHistogram_destroy(msgEntry->metrics.serializationTime);
             free(msgEntry);
         }
         hashMap_destroy(entry->msgEntries, false, false);
@@ -469,7 +490,7 @@ pubsub_admin_sender_metrics_t *pubsub_tcpTopicSender_metrics(pubsub_tcp_topic_se
         }
     }
 
-    result->msgMetrics = calloc(count, sizeof(*result));
+    result->msgMetrics = calloc(count, sizeof(*result->msgMetrics));
 
     iter = hashMapIterator_construct(sender->boundedServices.map);
     int i = 0;
@@ -478,19 +499,23 @@ pubsub_admin_sender_metrics_t *pubsub_tcpTopicSender_metrics(pubsub_tcp_topic_se
         hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgEntries);
         while (hashMapIterator_hasNext(&iter2)) {
             psa_tcp_send_msg_entry_t *mEntry = hashMapIterator_nextValue(&iter2);
-            celixThreadMutex_lock(&mEntry->metrics.mutex);
-            result->msgMetrics[i].nrOfMessagesSend = mEntry->metrics.nrOfMessagesSend;
-            result->msgMetrics[i].nrOfMessagesSendFailed = mEntry->metrics.nrOfMessagesSendFailed;
-            result->msgMetrics[i].nrOfSerializationErrors = mEntry->metrics.nrOfSerializationErrors;
-            result->msgMetrics[i].averageSerializationTimeInSeconds = mEntry->metrics.averageSerializationTimeInSeconds;
-            result->msgMetrics[i].averageTimeBetweenMessagesInSeconds =
-                mEntry->metrics.averageTimeBetweenMessagesInSeconds;
-            result->msgMetrics[i].lastMessageSend = mEntry->metrics.lastMessageSend;
+            result->msgMetrics[i].nrOfMessagesSend = __atomic_load_n(&mEntry->metrics.nrOfMessagesSend, __ATOMIC_RELAXED);
+            result->msgMetrics[i].nrOfMessagesSendFailed = __atomic_load_n(&mEntry->metrics.nrOfMessagesSendFailed, __ATOMIC_RELAXED);
+            result->msgMetrics[i].nrOfSerializationErrors = __atomic_load_n(&mEntry->metrics.nrOfSerializationErrors, __ATOMIC_RELAXED);
+            pubsub_metricsHistogram_summary(mEntry->metrics.serializationTime, &result->msgMetrics[i].serializationTime);
+            result->msgMetrics[i].averageSerializationTimeInSeconds = result->msgMetrics[i].serializationTime.averageInSeconds;
+            int64_t first = __atomic_load_n(&mEntry->metrics.firstMessageSendInNs, __ATOMIC_RELAXED);
+            int64_t last = __atomic_load_n(&mEntry->metrics.lastMessageSendInNs, __ATOMIC_RELAXED);
+            unsigned long n = result->msgMetrics[i].nrOfMessagesSend + result->msgMetrics[i].nrOfMessagesSendFailed;
+            if (n > 1) {
+                result->msgMetrics[i].averageTimeBetweenMessagesInSeconds = (double)(last - first) / (double)(n - 1) / 1000000000.0;
+            }
+            result->msgMetrics[i].lastMessageSend.tv_sec = (time_t)(last / 1000000000);
+            result->msgMetrics[i].lastMessageSend.tv_nsec = (long)(last % 1000000000);
             result->msgMetrics[i].bndId = entry->bndId;
             result->msgMetrics[i].typeId = mEntry->type;
             snprintf(result->msgMetrics[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", mEntry->msgSer->msgName);
             i += 1;
-            celixThreadMutex_unlock(&mEntry->metrics.mutex);
         }
     }
 
@@ -500,16 +525,15 @@ pubsub_admin_sender_metrics_t *pubsub_tcpTopicSender_metrics(pubsub_tcp_topic_se
 }
 
 static int
-psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
+psa_tcp_topicPublicationSendMsg(psa_tcp_bounded_service_entry_t *bound, unsigned int msgTypeId, const void *inMsg,
+                                celix_properties_t *metadata, int flags) {
     int status = CELIX_SUCCESS;
-    psa_tcp_bounded_service_entry_t *bound = handle;
     pubsub_tcp_topic_sender_t *sender = bound->parent;
     bool monitor = sender->metricsEnabled;
 
     psa_tcp_send_msg_entry_t *entry = hashMap_get(bound->msgEntries, (void *) (uintptr_t) (msgTypeId));
 
     //metrics updates
-    struct timespec sendTime = {0, 0};
     struct timespec serializationStart;
     struct timespec serializationEnd;
 
@@ -550,13 +574,21 @@ psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *i
             message.header.payloadPartSize = 0;
             message.header.payloadOffset = 0;
             message.header.metadataSize = 0;
+            if (monitor) {
+                //origin and send time, so that the receivers can track the metrics per origin and the delay
+                if (metadata == NULL) {
+                    metadata = celix_properties_create();
+                }
+                celix_properties_set(metadata, PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY, sender->fwUUIDStr);
+                celix_properties_setLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIME_KEY, pubsub_metrics_timespecToNs(&serializationStart));
+            }
             if (metadata != NULL)
                 message.metadata.metadata = metadata;
             entry->seqNr++;
             bool sendOk = true;
             {
                 int rc = pubsub_tcpHandler_write(sender->socketHandler, &message, serializedIoVecOutput,
-                                                 serializedIoVecOutputLen, 0);
+                                                 serializedIoVecOutputLen, flags);
                 if (rc < 0) {
                     status = -1;
                     sendOk = false;
@@ -590,24 +622,44 @@ psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *i
     }
 
     if (monitor && entry != NULL) {
-        celixThreadMutex_lock(&entry->metrics.mutex);
-        long n = entry->metrics.nrOfMessagesSend + entry->metrics.nrOfMessagesSendFailed;
-        double diff = celix_difftime(&serializationStart, &serializationEnd);
-        double average = (entry->metrics.averageSerializationTimeInSeconds * n + diff) / (n + 1);
-        entry->metrics.averageSerializationTimeInSeconds = average;
-
-        if (entry->metrics.nrOfMessagesSend > 2) {
-            diff = celix_difftime(&entry->metrics.lastMessageSend, &sendTime);
-            n = entry->metrics.nrOfMessagesSend;
-            average = (entry->metrics.averageTimeBetweenMessagesInSeconds * n + diff) / (n + 1);
-            entry->metrics.averageTimeBetweenMessagesInSeconds = average;
+        pubsub_metricsHistogram_record(entry->metrics.serializationTime, celix_difftime(&serializationStart, &serializationEnd));
+        int64_t sendTime = pubsub_metrics_timespecToNs(&serializationEnd);
+        int64_t noTime = 0;
+        __atomic_compare_exchange_n(&entry->metrics.firstMessageSendInNs, &noTime, sendTime, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->metrics.lastMessageSendInNs, sendTime, __ATOMIC_RELAXED);
+        if (sendCountUpdate > 0) {
+            __atomic_fetch_add(&entry->metrics.nrOfMessagesSend, sendCountUpdate, __ATOMIC_RELAXED);
         }
+        if (sendErrorUpdate > 0) {
+            __atomic_fetch_add(&entry->metrics.nrOfMessagesSendFailed, sendErrorUpdate, __ATOMIC_RELAXED);
+        }
+        if (serializationErrorUpdate > 0) {
+            __atomic_fetch_add(&entry->metrics.nrOfSerializationErrors, serializationErrorUpdate, __ATOMIC_RELAXED);
+        }
+    }
+    return status;
+}
+
+static int
+psa_tcp_topicPublicationSend(void *handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
+    return psa_tcp_topicPublicationSendMsg(handle, msgTypeId, inMsg, metadata, 0);
+}
 
-        entry->metrics.lastMessageSend = sendTime;
-        entry->metrics.nrOfMessagesSend += sendCountUpdate;
-        entry->metrics.nrOfMessagesSendFailed += sendErrorUpdate;
-        entry->metrics.nrOfSerializationErrors += serializationErrorUpdate;
-        celixThreadMutex_unlock(&entry->metrics.mutex);
+static int
+psa_tcp_topicPublicationSendMany(void *handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    psa_tcp_bounded_service_entry_t *bound = handle;
+    int status = CELIX_SUCCESS;
+    //hold all messages in the send queues and write them with one system call per connection
+    for (size_t i = 0; i < nrOfMsgs; i++) {
+        int rc = psa_tcp_topicPublicationSendMsg(bound, msgs[i].msgTypeId, msgs[i].msg, msgs[i].metadata,
+                                                 PUBSUB_TCP_HANDLER_MSG_MORE);
+        if (status == CELIX_SUCCESS) {
+            status = rc;
+        }
+    }
+    int rc = pubsub_tcpHandler_flush(bound->parent->socketHandler);
+    if (status == CELIX_SUCCESS && rc < 0) {
+        status = -1;
     }
     return status;
 }
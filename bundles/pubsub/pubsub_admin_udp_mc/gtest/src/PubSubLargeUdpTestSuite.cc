@@ -0,0 +1,312 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <malloc.h>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "large_udp.h"
+
+/**
+ * Same layout as the part header of large_udp.c, used to send hand crafted parts.
+ */
+struct TestPartHeader {
+    unsigned int msgIdent;
+    unsigned int totalMsgSize;
+    unsigned int partMsgSize;
+    unsigned int offset;
+};
+
+class PubSubLargeUdpTestSuite : public ::testing::Test {
+public:
+    PubSubLargeUdpTestSuite() : handle{largeUdp_create(4)} {
+        recvFd = socket(AF_INET, SOCK_DGRAM, 0);
+        sendFd = socket(AF_INET, SOCK_DGRAM, 0);
+        int size = 4 * 1024 * 1024;
+        setsockopt(recvFd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(recvFd, (struct sockaddr*)&addr, sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(recvFd, (struct sockaddr*)&addr, &len);
+    }
+
+    ~PubSubLargeUdpTestSuite() override {
+        largeUdp_destroy(handle);
+        close(recvFd);
+        close(sendFd);
+    }
+
+    PubSubLargeUdpTestSuite(const PubSubLargeUdpTestSuite&) = delete;
+    PubSubLargeUdpTestSuite& operator=(const PubSubLargeUdpTestSuite&) = delete;
+
+    void sendPart(unsigned int msgIdent, const std::string& msg, unsigned int offset, unsigned int partSize) {
+        TestPartHeader header{msgIdent, (unsigned int)msg.size(), partSize, offset};
+        std::string datagram{(const char*)&header, sizeof(header)};
+        datagram.append(msg, offset, partSize);
+        ASSERT_EQ((ssize_t)datagram.size(), sendto(sendFd, datagram.data(), datagram.size(), 0, (struct sockaddr*)&addr, sizeof(addr)));
+    }
+
+    /**
+     * Receives till no more datagrams are available and returns the number of datagrams read or -1 on error.
+     */
+    int receiveAll(largeUdp_t* h) {
+        int total = 0;
+        int n;
+        while ((n = largeUdp_receive(h, recvFd, onMessage, this)) > 0) {
+            total += n;
+        }
+        return n < 0 ? n : total;
+    }
+
+    int receiveAll() {
+        return receiveAll(handle);
+    }
+
+    static void onMessage(void* payload, void* msg, unsigned int size) {
+        auto* self = static_cast<PubSubLargeUdpTestSuite*>(payload);
+        self->received.emplace_back((const char*)msg, size);
+    }
+
+    static std::string createMsg(size_t size) {
+        std::string msg(size, ' ');
+        for (size_t i = 0; i < size; ++i) {
+            msg[i] = (char)('a' + i % 26);
+        }
+        return msg;
+    }
+
+    largeUdp_statistics_t statistics() {
+        largeUdp_statistics_t stats{};
+        largeUdp_statistics(handle, &stats);
+        return stats;
+    }
+
+    largeUdp_t* handle;
+    int recvFd{-1};
+    int sendFd{-1};
+    struct sockaddr_in addr{};
+    std::vector<std::string> received{};
+};
+
+//Fixed mmap threshold, so that large allocations are always mapped and unmapped again and are not served from heap
+//memory freed by previous tests when the address space is limited.
+static const int fixedMmapThreshold = mallopt(M_MMAP_THRESHOLD, 128 * 1024);
+
+/**
+ * Limits the address space of the process to the current size plus some slack, so that larger allocations fail.
+ * The previous limit is restored when the limiter goes out of scope.
+ */
+class AddressSpaceLimiter {
+public:
+    explicit AddressSpaceLimiter(size_t slack) {
+        getrlimit(RLIMIT_AS, &previous);
+        unsigned long pages = 0;
+        FILE* statm = fopen("/proc/self/statm", "r");
+        if (statm != nullptr) {
+            if (fscanf(statm, "%lu", &pages) != 1) {
+                pages = 0;
+            }
+            fclose(statm);
+        }
+        if (fixedMmapThreshold == 1 && pages > 0) {
+            struct rlimit limit = previous;
+            limit.rlim_cur = pages * (size_t)sysconf(_SC_PAGESIZE) + slack;
+            limited = setrlimit(RLIMIT_AS, &limit) == 0;
+        }
+    }
+
+    ~AddressSpaceLimiter() {
+        setrlimit(RLIMIT_AS, &previous);
+    }
+
+    AddressSpaceLimiter(const AddressSpaceLimiter&) = delete;
+    AddressSpaceLimiter& operator=(const AddressSpaceLimiter&) = delete;
+
+    bool limited{false};
+private:
+    struct rlimit previous{};
+};
+
+TEST_F(PubSubLargeUdpTestSuite, SinglePartMessage) {
+    ASSERT_NE(nullptr, handle);
+    std::string msg = createMsg(100);
+    ASSERT_EQ((int)(msg.size() + sizeof(TestPartHeader)), largeUdp_sendto(handle, sendFd, (void*)msg.data(), msg.size(), 0, &addr, sizeof(addr)));
+    EXPECT_EQ(1, receiveAll());
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(msg, received[0]);
+    EXPECT_EQ(1, statistics().nrOfMessages);
+    EXPECT_EQ(0, statistics().nrOfMultiPartMessages);
+}
+
+TEST_F(PubSubLargeUdpTestSuite, MultiPartMessageInOrder) {
+    largeUdp_setMaxDatagramSize(handle, sizeof(TestPartHeader) + 256);
+    EXPECT_EQ(256, largeUdp_maxPartSize(handle));
+    std::string msg = createMsg(1000);
+    ASSERT_GT(largeUdp_sendto(handle, sendFd, (void*)msg.data(), msg.size(), 0, &addr, sizeof(addr)), 0);
+    EXPECT_EQ(4, receiveAll());
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(msg, received[0]);
+    auto stats = statistics();
+    EXPECT_EQ(1, stats.nrOfMessages);
+    EXPECT_EQ(1, stats.nrOfMultiPartMessages);
+    EXPECT_EQ(0, stats.nrOfReorderedParts);
+    EXPECT_EQ(0, stats.nrOfLostMessages);
+}
+
+TEST_F(PubSubLargeUdpTestSuite, MultiPartMessageOutOfOrder) {
+    std::string msg = createMsg(192);
+    sendPart(1, msg, 128, 64);
+    sendPart(1, msg, 0, 64);
+    sendPart(1, msg, 64, 64);
+    EXPECT_EQ(3, receiveAll());
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(msg, received[0]);
+    auto stats = statistics();
+    EXPECT_EQ(1, stats.nrOfMultiPartMessages);
+    EXPECT_EQ(2, stats.nrOfReorderedParts);
+}
+
+TEST_F(PubSubLargeUdpTestSuite, DuplicatePartIsIgnored) {
+    std::string msg = createMsg(128);
+    sendPart(2, msg, 0, 64);
+    sendPart(2, msg, 0, 64); //duplicate should not complete the message
+    EXPECT_EQ(2, receiveAll());
+    EXPECT_TRUE(received.empty());
+    EXPECT_EQ(1, statistics().nrOfDuplicateParts);
+
+    sendPart(2, msg, 64, 64);
+    EXPECT_EQ(1, receiveAll());
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(msg, received[0]);
+}
+
+TEST_F(PubSubLargeUdpTestSuite, MissingPartDropsMessageAfterTimeout) {
+    largeUdp_setReassemblyTimeout(handle, 10);
+    std::string msg = createMsg(128);
+    sendPart(3, msg, 0, 64);
+    EXPECT_EQ(1, receiveAll());
+    EXPECT_TRUE(received.empty());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    //expired messages are dropped on the next receive
+    std::string other = createMsg(10);
+    sendPart(4, other, 0, 10);
+    EXPECT_EQ(1, receiveAll());
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(other, received[0]);
+    EXPECT_EQ(1, statistics().nrOfLostMessages);
+
+    //the late part starts a new reassembly and does not complete the dropped message
+    sendPart(3, msg, 64, 64);
+    EXPECT_EQ(1, receiveAll());
+    EXPECT_EQ(1, received.size());
+}
+
+TEST_F(PubSubLargeUdpTestSuite, LeastRecentlyUpdatedMessageIsEvictedWhenFull) {
+    largeUdp_t* small = largeUdp_create(2);
+    std::string msg = createMsg(128);
+    sendPart(10, msg, 0, 64);
+    EXPECT_EQ(1, receiveAll(small));
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    sendPart(11, msg, 0, 64);
+    EXPECT_EQ(1, receiveAll(small));
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    sendPart(12, msg, 0, 64); //no free slot -> message 10 is evicted
+    EXPECT_EQ(1, receiveAll(small));
+
+    largeUdp_statistics_t stats{};
+    largeUdp_statistics(small, &stats);
+    EXPECT_EQ(1, stats.nrOfLostMessages);
+
+    sendPart(11, msg, 64, 64);
+    sendPart(12, msg, 64, 64);
+    EXPECT_EQ(2, receiveAll(small));
+    EXPECT_EQ(2, received.size());
+
+    sendPart(10, msg, 64, 64); //evicted, so not complete
+    EXPECT_EQ(1, receiveAll(small));
+    EXPECT_EQ(2, received.size());
+
+    largeUdp_destroy(small);
+}
+
+TEST_F(PubSubLargeUdpTestSuite, ReceiveBufferAllocationFailure) {
+    std::string msg = createMsg(100);
+    sendPart(20, msg, 0, (unsigned int)msg.size());
+    {
+        AddressSpaceLimiter limiter{64 * 1024};
+        if (!limiter.limited) {
+            GTEST_SKIP() << "Cannot limit the address space";
+        }
+        errno = 0;
+        EXPECT_EQ(-1, largeUdp_receive(handle, recvFd, onMessage, this));
+        EXPECT_EQ(ENOMEM, errno);
+    }
+    EXPECT_TRUE(received.empty());
+
+    //the datagram is still available and the receive buffers are allocated on the next receive
+    EXPECT_EQ(1, receiveAll());
+    ASSERT_EQ(1, received.size());
+    EXPECT_EQ(msg, received[0]);
+}
+
+TEST_F(PubSubLargeUdpTestSuite, ReassemblyBufferAllocationFailure) {
+    //allocate the receive buffers first
+    std::string small = createMsg(10);
+    sendPart(30, small, 0, 10);
+    EXPECT_EQ(1, receiveAll());
+
+    //a message larger than the initial reassembly buffer, so that the first part needs a new buffer
+    std::string msg = createMsg(256 * 1024);
+    const unsigned int firstPartSize = 1024;
+    sendPart(31, msg, 0, firstPartSize);
+    {
+        AddressSpaceLimiter limiter{64 * 1024};
+        if (!limiter.limited) {
+            GTEST_SKIP() << "Cannot limit the address space";
+        }
+        EXPECT_EQ(1, largeUdp_receive(handle, recvFd, onMessage, this));
+    }
+
+    //the first part is dropped, so the other parts do not complete the message
+    const unsigned int partSize = 32 * 1024;
+    for (unsigned int offset = firstPartSize; offset < msg.size(); offset += partSize) {
+        sendPart(31, msg, offset, std::min(partSize, (unsigned int)msg.size() - offset));
+        EXPECT_EQ(1, receiveAll());
+    }
+    EXPECT_EQ(1, received.size());
+
+    //the handle is still usable and the resent first part completes the message
+    sendPart(31, msg, 0, firstPartSize);
+    EXPECT_EQ(1, receiveAll());
+    ASSERT_EQ(2, received.size());
+    EXPECT_EQ(msg, received[1]);
+}
@@ -31,31 +31,39 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <errno.h>
-#include <array_list.h>
+#include <time.h>
 #include <pthread.h>
 
 #define MAX_UDP_MSG_SIZE        65535 /* 2^16 -1 */
 #define IP_HEADER_SIZE          20
 #define UDP_HEADER_SIZE         8
-//#define MTU_SIZE                1500
-#define MTU_SIZE                8000
 #define MAX_MSG_VECTOR_LEN      64
-
-//#define NO_IP_FRAGMENTATION
-
-struct largeUdp {
-    unsigned int maxNrLists;
-    array_list_pt udpPartLists;
-    pthread_mutex_t dbLock;
-};
+#define MAX_MMSG_DATAGRAMS      16
+#define DEFAULT_REASSEMBLY_TIMEOUT_MS   1000
+#define INITIAL_REASSEMBLY_BUFFER_SIZE  MAX_UDP_MSG_SIZE
+#define MIN_PART_SIZE           64 /* parts of a message start at least MIN_PART_SIZE bytes apart */
 
 typedef struct udpPartList {
+    bool inUse;
     unsigned int msg_ident;
     unsigned int msg_size;
-    unsigned int nrPartsRemaining;
+    unsigned int receivedSize;
+    unsigned int nextOffset; //end of the part with the highest offset, a part below it is received out of order
+    struct timespec lastUpdate;
     char *data;
+    size_t capacity; //size of data, the buffer is reused for the next message
+    unsigned char *receivedParts; //bitmap with a bit per MIN_PART_SIZE bytes, set for the start offset of a received part
+    size_t receivedPartsCapacity; //size of receivedParts in bytes, the bitmap is reused for the next message
 } udpPartList_t;
 
+struct largeUdp {
+    unsigned int maxNrLists;
+    udpPartList_t *udpPartLists; //fixed size reassembly table, size is maxNrLists
+    size_t maxPartSize;
+    unsigned int reassemblyTimeoutInMs;
+    char *recvBuffers; // MAX_MMSG_DATAGRAMS datagram buffers used by largeUdp_receive, allocated on first use
+    largeUdp_statistics_t stats; //updated with atomics
+};
 
 typedef struct msg_part_header {
     unsigned int msg_ident;
@@ -64,26 +72,19 @@ typedef struct msg_part_header {
     unsigned int offset;
 } msg_part_header_t;
 
-#ifdef NO_IP_FRAGMENTATION
-#define MAX_PART_SIZE   (MTU_SIZE - (IP_HEADER_SIZE + UDP_HEADER_SIZE + sizeof(struct msg_part_header) ))
-#else
 #define MAX_PART_SIZE   (MAX_UDP_MSG_SIZE - (IP_HEADER_SIZE + UDP_HEADER_SIZE + sizeof(struct msg_part_header) ))
-#endif
 
 //
 // Create a handle
 //
 largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions)
 {
-    printf("## Creating large UDP\n");
     largeUdp_t *handle = calloc(sizeof(*handle), 1);
     if (handle != NULL) {
-        handle->maxNrLists = maxNrUdpReceptions;
-        if (arrayList_create(&handle->udpPartLists) != CELIX_SUCCESS) {
-            free(handle);
-            handle = NULL;
-        }
-        pthread_mutex_init(&handle->dbLock, 0);
+        handle->maxNrLists = maxNrUdpReceptions > 0 ? maxNrUdpReceptions : 1;
+        handle->udpPartLists = calloc(handle->maxNrLists, sizeof(*handle->udpPartLists));
+        handle->maxPartSize = MAX_PART_SIZE;
+        handle->reassemblyTimeoutInMs = DEFAULT_REASSEMBLY_TIMEOUT_MS;
     }
 
     return handle;
@@ -94,100 +95,136 @@ largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions)
 //
 void largeUdp_destroy(largeUdp_t *handle)
 {
-    printf("### Destroying large UDP\n");
     if (handle != NULL) {
-        pthread_mutex_lock(&handle->dbLock);
-        int nrUdpLists = arrayList_size(handle->udpPartLists);
-        int i;
-        for (i=0; i < nrUdpLists; i++) {
-            udpPartList_t *udpPartList = arrayList_remove(handle->udpPartLists, i);
-            if (udpPartList) {
-                if (udpPartList->data) {
-                    free(udpPartList->data);
-                    udpPartList->data = NULL;
-                }
-                free(udpPartList);
-            }
+        for (unsigned int i = 0; i < handle->maxNrLists; i++) {
+            free(handle->udpPartLists[i].data);
+            free(handle->udpPartLists[i].receivedParts);
         }
-        arrayList_destroy(handle->udpPartLists);
-        handle->udpPartLists = NULL;
-        pthread_mutex_unlock(&handle->dbLock);
-        pthread_mutex_destroy(&handle->dbLock);
+        free(handle->udpPartLists);
+        free(handle->recvBuffers);
         free(handle);
     }
 }
 
+void largeUdp_setMaxDatagramSize(largeUdp_t *handle, size_t maxDatagramSize) {
+    if (maxDatagramSize == 0 || maxDatagramSize > MAX_PART_SIZE + sizeof(msg_part_header_t)) {
+        handle->maxPartSize = MAX_PART_SIZE;
+    } else if (maxDatagramSize <= sizeof(msg_part_header_t) + MIN_PART_SIZE) {
+        handle->maxPartSize = MIN_PART_SIZE;
+    } else {
+        handle->maxPartSize = maxDatagramSize - sizeof(msg_part_header_t);
+    }
+}
+
+void largeUdp_setReassemblyTimeout(largeUdp_t *handle, unsigned int timeoutInMs) {
+    handle->reassemblyTimeoutInMs = timeoutInMs;
+}
+
+size_t largeUdp_maxPartSize(largeUdp_t *handle) {
+    return handle->maxPartSize;
+}
+
+//
+// Sends the prepared datagrams with as few system calls as possible.
+// Returns the number of bytes written or -1 on error.
+//
+static int largeUdp_sendDatagrams(int fd, struct mmsghdr *msgs, unsigned int count, int flags) {
+    int written = 0;
+    unsigned int sent = 0;
+    while (sent < count) {
+#if defined(__APPLE__)
+        int n = sendmsg(fd, &msgs[sent].msg_hdr, flags) == -1 ? -1 : 1;
+        if (n == 1) {
+            msgs[sent].msg_len = 0;
+            for (size_t i = 0; i < msgs[sent].msg_hdr.msg_iovlen; i++) {
+                msgs[sent].msg_len += msgs[sent].msg_hdr.msg_iov[i].iov_len;
+            }
+        }
+#else
+        int n = sendmmsg(fd, &msgs[sent], count - sent, flags);
+#endif
+        if (n == -1) {
+            perror("sendmmsg()");
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            written += msgs[sent + i].msg_len;
+        }
+        sent += n;
+    }
+    return written;
+}
+
 //
 // Write large data to UDP. This function splits the data in chunks and sends these chunks with a header over UDP.
+// The chunks are sent in batches of MAX_MMSG_DATAGRAMS datagrams with a single system call.
 //
 int largeUdp_sendmsg(largeUdp_t *handle, int fd, struct iovec *largeMsg_iovec, int len, int flags, struct sockaddr_in *dest_addr, size_t addrlen)
 {
-    int n;
-    int result = 0;
-    msg_part_header_t header;
+    unsigned int msg_ident = (unsigned int)random();
+    unsigned int total_msg_size = 0;
+    for (int n = 0; n < len; n++) {
+        total_msg_size += largeMsg_iovec[n].iov_len;
+    }
+    unsigned int maxPartSize = (unsigned int) handle->maxPartSize;
+    unsigned int nr_buffers = total_msg_size == 0 ? 1 : (total_msg_size + maxPartSize - 1) / maxPartSize;
+
+    msg_part_header_t headers[MAX_MMSG_DATAGRAMS];
+    struct iovec msg_iovec[MAX_MMSG_DATAGRAMS][MAX_MSG_VECTOR_LEN];
+    struct mmsghdr msgs[MAX_MMSG_DATAGRAMS];
 
     int written = 0;
-    header.msg_ident = (unsigned int)random();
-    header.total_msg_size = 0;
-    for (n = 0; n < len ;n++) {
-        header.total_msg_size += largeMsg_iovec[n].iov_len;
-    }
-    int nr_buffers = (header.total_msg_size / MAX_PART_SIZE) + 1;
-
-    struct iovec msg_iovec[MAX_MSG_VECTOR_LEN];
-    struct msghdr msg;
-    msg.msg_name = dest_addr;
-    msg.msg_namelen = addrlen;
-    msg.msg_flags = 0;
-    msg.msg_iov = msg_iovec;
-    msg.msg_iovlen = 2; // header and payload;
-    msg.msg_control = NULL;
-    msg.msg_controllen = 0;
-
-    msg.msg_iov[0].iov_base = &header;
-    msg.msg_iov[0].iov_len = sizeof(header);
-
-    for (n = 0; n < nr_buffers; n++) {
-
-        header.part_msg_size = (((header.total_msg_size - n * MAX_PART_SIZE) >  MAX_PART_SIZE) ?  MAX_PART_SIZE  : (header.total_msg_size - n * MAX_PART_SIZE));
-        header.offset = n * MAX_PART_SIZE;
-        int remainingOffset = header.offset;
-        int recvPart = 0;
-        // find the start of the part
-        while (remainingOffset > largeMsg_iovec[recvPart].iov_len) {
-            remainingOffset -= largeMsg_iovec[recvPart].iov_len;
-            recvPart++;
-        }
-        int remainingData = header.part_msg_size;
-        int sendPart = 1;
-        msg.msg_iovlen = 1;
-
-        // fill in the output iovec from the input iovec in such a way that all UDP frames are filled maximal.
-        while (remainingData > 0) {
-            int partLen = ( (largeMsg_iovec[recvPart].iov_len - remainingOffset) <= remainingData ? (largeMsg_iovec[recvPart].iov_len -remainingOffset) : remainingData);
-            msg.msg_iov[sendPart].iov_base = largeMsg_iovec[recvPart].iov_base + remainingOffset;
-            msg.msg_iov[sendPart].iov_len = partLen;
-            remainingData -= partLen;
-            remainingOffset = 0;
-            sendPart++;
-            recvPart++;
-            msg.msg_iovlen++;
-        }
-        int tmp, tmptot;
-        for (tmp = 0, tmptot=0; tmp < msg.msg_iovlen; tmp++) {
-            tmptot += msg.msg_iov[tmp].iov_len;
+    int recvPart = 0; //current input io vector
+    size_t recvOffset = 0; //offset in the current input io vector
+    unsigned int n = 0;
+    while (n < nr_buffers) {
+        unsigned int count = 0;
+        memset(msgs, 0, sizeof(msgs));
+        for (; count < MAX_MMSG_DATAGRAMS && n < nr_buffers; count++, n++) {
+            msg_part_header_t *header = &headers[count];
+            header->msg_ident = msg_ident;
+            header->total_msg_size = total_msg_size;
+            header->offset = n * maxPartSize;
+            header->part_msg_size = (total_msg_size - header->offset) > maxPartSize ? maxPartSize : (total_msg_size - header->offset);
+
+            struct msghdr *msg = &msgs[count].msg_hdr;
+            msg->msg_name = dest_addr;
+            msg->msg_namelen = addrlen;
+            msg->msg_iov = msg_iovec[count];
+            msg->msg_iov[0].iov_base = header;
+            msg->msg_iov[0].iov_len = sizeof(*header);
+            msg->msg_iovlen = 1;
+
+            // fill in the output iovec from the input iovec in such a way that all UDP frames are filled maximal.
+            unsigned int remainingData = header->part_msg_size;
+            while (remainingData > 0 && recvPart < len) {
+                size_t available = largeMsg_iovec[recvPart].iov_len - recvOffset;
+                size_t partLen = available <= remainingData ? available : remainingData;
+                if (partLen > 0) {
+                    if (msg->msg_iovlen == MAX_MSG_VECTOR_LEN) {
+                        fprintf(stderr, "ERROR: Too many io vectors for a single part\n");
+                        return -1;
+                    }
+                    msg->msg_iov[msg->msg_iovlen].iov_base = (char *) largeMsg_iovec[recvPart].iov_base + recvOffset;
+                    msg->msg_iov[msg->msg_iovlen].iov_len = partLen;
+                    msg->msg_iovlen++;
+                }
+                remainingData -= partLen;
+                recvOffset += partLen;
+                if (recvOffset == largeMsg_iovec[recvPart].iov_len) {
+                    recvPart++;
+                    recvOffset = 0;
+                }
+            }
         }
-
-        int w = sendmsg(fd, &msg, 0);
+        int w = largeUdp_sendDatagrams(fd, msgs, count, flags);
         if (w == -1) {
-            perror("send()");
-            result =  -1;
-            break;
+            return -1;
         }
         written += w;
     }
 
-    return (result == 0 ? written : result);
+    return written;
 }
 
 //
@@ -195,172 +232,250 @@ int largeUdp_sendmsg(largeUdp_t *handle, int fd, struct iovec *largeMsg_iovec, i
 //
 int largeUdp_sendto(largeUdp_t *handle, int fd, void *buf, size_t count, int flags, struct sockaddr_in *dest_addr, size_t addrlen)
 {
-    int n;
-    int nr_buffers = (count / MAX_PART_SIZE) + 1;
-    int result = 0;
-    msg_part_header_t header;
+    struct iovec msg_iovec;
+    msg_iovec.iov_base = buf;
+    msg_iovec.iov_len = count;
+    return largeUdp_sendmsg(handle, fd, &msg_iovec, 1, flags, dest_addr, addrlen);
+}
 
+//
+// Write small messages to UDP. Every message is sent in a single datagram, all datagrams are sent with one system call.
+//
+int largeUdp_sendmmsg(largeUdp_t *handle, int fd, struct iovec *datagrams, unsigned int nrOfDatagrams, int flags, struct sockaddr_in *dest_addr, size_t addrlen)
+{
     int written = 0;
-    header.msg_ident = (unsigned int)random();
-    header.total_msg_size = count;
-    char *databuf = buf;
-
-    struct iovec msg_iovec[2];
-    struct msghdr msg;
-    msg.msg_name = dest_addr;
-    msg.msg_namelen = addrlen;
-    msg.msg_flags = 0;
-    msg.msg_iov = msg_iovec;
-    msg.msg_iovlen = 2; // header and payload;
-    msg.msg_control = NULL;
-    msg.msg_controllen = 0;
-
-    msg.msg_iov[0].iov_base = &header;
-    msg.msg_iov[0].iov_len = sizeof(header);
-
-    for (n = 0; n < nr_buffers; n++) {
-
-        header.part_msg_size = (((header.total_msg_size - n * MAX_PART_SIZE) >  MAX_PART_SIZE) ?  MAX_PART_SIZE  : (header.total_msg_size - n * MAX_PART_SIZE));
-        header.offset = n * MAX_PART_SIZE;
-        msg.msg_iov[1].iov_base = &databuf[header.offset];
-        msg.msg_iov[1].iov_len = header.part_msg_size;
-        int w = sendmsg(fd, &msg, 0);
+    unsigned int sent = 0;
+    while (sent < nrOfDatagrams) {
+        unsigned int count = (nrOfDatagrams - sent) < MAX_MMSG_DATAGRAMS ? (nrOfDatagrams - sent) : MAX_MMSG_DATAGRAMS;
+        msg_part_header_t headers[MAX_MMSG_DATAGRAMS];
+        struct iovec msg_iovec[MAX_MMSG_DATAGRAMS][2];
+        struct mmsghdr msgs[MAX_MMSG_DATAGRAMS];
+        memset(msgs, 0, sizeof(msgs));
+        for (unsigned int i = 0; i < count; i++) {
+            struct iovec *datagram = &datagrams[sent + i];
+            headers[i].msg_ident = (unsigned int)random();
+            headers[i].total_msg_size = datagram->iov_len;
+            headers[i].part_msg_size = datagram->iov_len;
+            headers[i].offset = 0;
+            msg_iovec[i][0].iov_base = &headers[i];
+            msg_iovec[i][0].iov_len = sizeof(headers[i]);
+            msg_iovec[i][1] = *datagram;
+            msgs[i].msg_hdr.msg_name = dest_addr;
+            msgs[i].msg_hdr.msg_namelen = addrlen;
+            msgs[i].msg_hdr.msg_iov = msg_iovec[i];
+            msgs[i].msg_hdr.msg_iovlen = 2;
+        }
+        int w = largeUdp_sendDatagrams(fd, msgs, count, flags);
         if (w == -1) {
-            perror("send()");
-            result =  -1;
-            break;
+            return -1;
         }
         written += w;
-        //usleep(1000); // TODO: If not slept a UDP buffer overflow occurs and parts are missing at the reception side (at least via localhost)
+        sent += count;
     }
+    return written;
+}
 
-    return (result == 0 ? written : result);
+static inline long largeUdp_elapsedMs(const struct timespec *start, const struct timespec *end) {
+    return (end->tv_sec - start->tv_sec) * 1000 + (end->tv_nsec - start->tv_nsec) / 1000000;
 }
 
 //
-// Reads data from the filedescriptor which has date (determined by epoll()) and stores it in the internal structure
-// If the message is completely reassembled true is returned and the index and size have valid values
+// Drops the incomplete messages which did not receive a part within the reassembly timeout.
 //
-bool largeUdp_dataAvailable(largeUdp_t *handle, int fd, unsigned int *index, unsigned int *size) {
-    msg_part_header_t header;
-    int result = false;
-    // Only read the header, we don't know yet where to store the payload
-    if (recv(fd, &header, sizeof(header), MSG_PEEK) < 0) {
-        perror("read()");
-        return false;
+static void largeUdp_expireParts(largeUdp_t *handle, const struct timespec *now) {
+    for (unsigned int i = 0; i < handle->maxNrLists; i++) {
+        udpPartList_t *list = &handle->udpPartLists[i];
+        if (list->inUse && largeUdp_elapsedMs(&list->lastUpdate, now) > handle->reassemblyTimeoutInMs) {
+            list->inUse = false;
+            __atomic_add_fetch(&handle->stats.nrOfLostMessages, 1, __ATOMIC_RELAXED);
+        }
     }
+}
 
-    struct iovec msg_vec[2];
-    struct msghdr msg;
-    msg.msg_name = NULL;
-    msg.msg_namelen = 0;
-    msg.msg_flags = 0;
-    msg.msg_iov = msg_vec;
-    msg.msg_iovlen = 2; // header and payload;
-    msg.msg_control = NULL;
-    msg.msg_controllen = 0;
-
-    msg.msg_iov[0].iov_base = &header;
-    msg.msg_iov[0].iov_len = sizeof(header);
-
-    pthread_mutex_lock(&handle->dbLock);
-
-    int nrUdpLists = arrayList_size(handle->udpPartLists);
-    int i;
-    bool found = false;
-    for (i = 0; i < nrUdpLists; i++) {
-        udpPartList_t *udpPartList = arrayList_get(handle->udpPartLists, i);
-        if (udpPartList->msg_ident == header.msg_ident) {
-            found = true;
-
-            //sanity check
-            if (udpPartList->msg_size != header.total_msg_size) {
-                // Corruption occurred. Remove the existing administration and build up a new one.
-                arrayList_remove(handle->udpPartLists, i);
-                free(udpPartList->data);
-                free(udpPartList);
-                found = false;
-                break;
-            }
-
-            msg.msg_iov[1].iov_base = &udpPartList->data[header.offset];
-            msg.msg_iov[1].iov_len = header.part_msg_size;
-            if (recvmsg(fd, &msg, 0)<0) {
-                found=true;
-                result=false;
-                break;
-            }
+//
+// Ensures the buffers of a reassembly entry can hold a message of msgSize bytes. Returns false if the buffers cannot
+// be allocated.
+//
+static bool largeUdp_reserveParts(udpPartList_t *list, unsigned int msgSize) {
+    if (list->capacity < msgSize) {
+        size_t capacity = list->capacity == 0 ? INITIAL_REASSEMBLY_BUFFER_SIZE : list->capacity;
+        while (capacity < msgSize) {
+            capacity *= 2;
+        }
+        free(list->data);
+        list->data = malloc(capacity);
+        list->capacity = list->data == NULL ? 0 : capacity;
+        if (list->data == NULL) {
+            return false;
+        }
+    }
+    size_t bitmapSize = msgSize / MIN_PART_SIZE / 8 + 1;
+    if (list->receivedPartsCapacity < bitmapSize) {
+        free(list->receivedParts);
+        list->receivedParts = malloc(bitmapSize);
+        list->receivedPartsCapacity = list->receivedParts == NULL ? 0 : bitmapSize;
+        if (list->receivedParts == NULL) {
+            return false;
+        }
+    }
+    memset(list->receivedParts, 0, bitmapSize);
+    return true;
+}
 
-            udpPartList->nrPartsRemaining--;
-            if (udpPartList->nrPartsRemaining == 0) {
-                *index = i;
-                *size = udpPartList->msg_size;
-                result = true;
-                break;
-            } else {
-                result = false; // not complete
-                break;
-            }
+//
+// Stores a received part in the reassembly table. Returns the reassembly entry when the message is complete, the
+// entry is released (inUse = false) but its data is valid until the next call.
+// Parts are tracked by their offset, so a duplicate part is ignored and does not complete the message.
+//
+static udpPartList_t *largeUdp_storePart(largeUdp_t *handle, const msg_part_header_t *header, const char *data, const struct timespec *now) {
+    udpPartList_t *udpPartList = NULL;
+    udpPartList_t *freeList = NULL;
+    udpPartList_t *oldestList = NULL;
+    for (unsigned int i = 0; i < handle->maxNrLists; i++) {
+        udpPartList_t *list = &handle->udpPartLists[i];
+        if (!list->inUse) {
+            freeList = freeList == NULL ? list : freeList;
+        } else if (list->msg_ident == header->msg_ident) {
+            udpPartList = list;
+            break;
+        } else if (oldestList == NULL || largeUdp_elapsedMs(&list->lastUpdate, &oldestList->lastUpdate) > 0) {
+            oldestList = list;
         }
     }
 
-    if (found == false) {
-        udpPartList_t *udpPartList = NULL;
-        if (nrUdpLists == handle->maxNrLists) {
-            // remove list at index 0
-            udpPartList = arrayList_remove(handle->udpPartLists, 0);
-            fprintf(stderr, "ERROR: Removing entry for id %d: %d parts not received\n",udpPartList->msg_ident, udpPartList->nrPartsRemaining );
-            free(udpPartList->data);
-            free(udpPartList);
-            nrUdpLists--;
+    if (udpPartList != NULL && udpPartList->msg_size != header->total_msg_size) {
+        // Corruption occurred. Remove the existing administration and build up a new one.
+        __atomic_add_fetch(&handle->stats.nrOfInvalidParts, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&handle->stats.nrOfLostMessages, 1, __ATOMIC_RELAXED);
+        udpPartList->inUse = false;
+        freeList = udpPartList;
+        udpPartList = NULL;
+    }
+    if (udpPartList == NULL) {
+        if (freeList == NULL) {
+            //all slots in use, drop the least recently updated message
+            freeList = oldestList;
+            __atomic_add_fetch(&handle->stats.nrOfLostMessages, 1, __ATOMIC_RELAXED);
         }
-        udpPartList = calloc(sizeof(*udpPartList), 1);
-        udpPartList->msg_ident =  header.msg_ident;
-        udpPartList->msg_size =  header.total_msg_size;
-        udpPartList->nrPartsRemaining = header.total_msg_size / MAX_PART_SIZE;
-        udpPartList->data = calloc(sizeof(char), header.total_msg_size);
-
-        msg.msg_iov[1].iov_base = &udpPartList->data[header.offset];
-        msg.msg_iov[1].iov_len = header.part_msg_size;
-        if (recvmsg(fd, &msg, 0)<0) {
-            free(udpPartList->data);
-            free(udpPartList);
-            result=false;
-        } else {
-            arrayList_add(handle->udpPartLists, udpPartList);
-
-            if (udpPartList->nrPartsRemaining == 0) {
-                *index = nrUdpLists;
-                *size = udpPartList->msg_size;
-                result = true;
-            } else {
-                result = false;
-            }
+        udpPartList = freeList;
+        //note an evicted entry is released here, so that a failed allocation does not leave an entry without buffers in use
+        udpPartList->inUse = false;
+        if (!largeUdp_reserveParts(udpPartList, header->total_msg_size)) {
+            return NULL;
         }
-
+        udpPartList->inUse = true;
+        udpPartList->msg_ident = header->msg_ident;
+        udpPartList->msg_size = header->total_msg_size;
+        udpPartList->receivedSize = 0;
+        udpPartList->nextOffset = 0;
     }
 
-    pthread_mutex_unlock(&handle->dbLock);
+    unsigned int partIndex = header->offset / MIN_PART_SIZE;
+    unsigned char partBit = (unsigned char) (1u << (partIndex % 8));
+    if (udpPartList->receivedParts[partIndex / 8] & partBit) {
+        __atomic_add_fetch(&handle->stats.nrOfDuplicateParts, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    udpPartList->receivedParts[partIndex / 8] |= partBit;
 
-    return result;
+    if (header->offset < udpPartList->nextOffset) {
+        __atomic_add_fetch(&handle->stats.nrOfReorderedParts, 1, __ATOMIC_RELAXED);
+    } else {
+        udpPartList->nextOffset = header->offset + header->part_msg_size;
+    }
+    memcpy(&udpPartList->data[header->offset], data, header->part_msg_size);
+    udpPartList->receivedSize += header->part_msg_size;
+    udpPartList->lastUpdate = *now;
+    if (udpPartList->receivedSize >= udpPartList->msg_size) {
+        udpPartList->inUse = false;
+        return udpPartList;
+    }
+    return NULL;
 }
 
 //
-// Read out the message which is indicated available by the largeUdp_dataAvailable function
+// Reads all available datagrams (up to MAX_MMSG_DATAGRAMS) and calls the callback for every complete message.
+// Single part messages are passed directly from the receive buffer, without reassembly.
 //
-int largeUdp_read(largeUdp_t *handle, unsigned int index, void ** buffer, unsigned int size)
+int largeUdp_receive(largeUdp_t *handle, int fd, largeUdp_receive_callback_t callback, void *payload)
 {
-    int result = 0;
-    pthread_mutex_lock(&handle->dbLock);
+    if (handle->recvBuffers == NULL) {
+        handle->recvBuffers = malloc((size_t) MAX_MMSG_DATAGRAMS * MAX_UDP_MSG_SIZE);
+        if (handle->recvBuffers == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        for (unsigned int i = 0; i < handle->maxNrLists; i++) {
+            handle->udpPartLists[i].data = malloc(INITIAL_REASSEMBLY_BUFFER_SIZE);
+            handle->udpPartLists[i].capacity = handle->udpPartLists[i].data == NULL ? 0 : INITIAL_REASSEMBLY_BUFFER_SIZE;
+        }
+    }
+    struct iovec msg_iovec[MAX_MMSG_DATAGRAMS];
+    struct mmsghdr msgs[MAX_MMSG_DATAGRAMS];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < MAX_MMSG_DATAGRAMS; i++) {
+        msg_iovec[i].iov_base = &handle->recvBuffers[i * MAX_UDP_MSG_SIZE];
+        msg_iovec[i].iov_len = MAX_UDP_MSG_SIZE;
+        msgs[i].msg_hdr.msg_iov = &msg_iovec[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+#if defined(__APPLE__)
+    int n = 0;
+    ssize_t len;
+    while (n < MAX_MMSG_DATAGRAMS && (len = recvmsg(fd, &msgs[n].msg_hdr, MSG_DONTWAIT)) >= 0) {
+        msgs[n++].msg_len = (unsigned int) len;
+    }
+    if (n == 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        n = -1;
+    }
+#else
+    int n = recvmmsg(fd, msgs, MAX_MMSG_DATAGRAMS, MSG_DONTWAIT, NULL);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        n = 0;
+    }
+#endif
+    if (n < 0) {
+        perror("recvmmsg()");
+        return -1;
+    }
 
-    udpPartList_t *udpPartList = arrayList_remove(handle->udpPartLists, index);
-    if (udpPartList) {
-        *buffer = udpPartList->data;
-        free(udpPartList);
-    } else {
-        result = -1;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    largeUdp_expireParts(handle, &now);
+
+    for (int i = 0; i < n; i++) {
+        msg_part_header_t header;
+        const char *data = msg_iovec[i].iov_base;
+        if (msgs[i].msg_len < sizeof(header)) {
+            __atomic_add_fetch(&handle->stats.nrOfInvalidParts, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        memcpy(&header, data, sizeof(header));
+        if (header.part_msg_size > msgs[i].msg_len - sizeof(header) ||
+            header.offset > header.total_msg_size || header.part_msg_size > header.total_msg_size - header.offset) {
+            __atomic_add_fetch(&handle->stats.nrOfInvalidParts, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (header.offset == 0 && header.part_msg_size == header.total_msg_size) {
+            __atomic_add_fetch(&handle->stats.nrOfMessages, 1, __ATOMIC_RELAXED);
+            callback(payload, (void *) &data[sizeof(header)], header.total_msg_size);
+        } else {
+            udpPartList_t *list = largeUdp_storePart(handle, &header, &data[sizeof(header)], &now);
+            if (list != NULL) {
+                __atomic_add_fetch(&handle->stats.nrOfMessages, 1, __ATOMIC_RELAXED);
+                __atomic_add_fetch(&handle->stats.nrOfMultiPartMessages, 1, __ATOMIC_RELAXED);
+                callback(payload, list->data, list->msg_size);
+            }
+        }
     }
-    pthread_mutex_unlock(&handle->dbLock);
+    return n;
+}
 
-    return result;
+void largeUdp_statistics(largeUdp_t *handle, largeUdp_statistics_t *statistics) {
+    statistics->nrOfMessages = __atomic_load_n(&handle->stats.nrOfMessages, __ATOMIC_RELAXED);
+    statistics->nrOfMultiPartMessages = __atomic_load_n(&handle->stats.nrOfMultiPartMessages, __ATOMIC_RELAXED);
+    statistics->nrOfLostMessages = __atomic_load_n(&handle->stats.nrOfLostMessages, __ATOMIC_RELAXED);
+    statistics->nrOfReorderedParts = __atomic_load_n(&handle->stats.nrOfReorderedParts, __ATOMIC_RELAXED);
+    statistics->nrOfInvalidParts = __atomic_load_n(&handle->stats.nrOfInvalidParts, __ATOMIC_RELAXED);
+    statistics->nrOfDuplicateParts = __atomic_load_n(&handle->stats.nrOfDuplicateParts, __ATOMIC_RELAXED);
 }
@@ -33,14 +33,77 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct largeUdp largeUdp_t;
 
 largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions);
 void largeUdp_destroy(largeUdp_t *handle);
 
+/**
+ * Sets the maximum size of the datagrams (UDP payload, including the part header) used to send messages.
+ * A size which fits in the MTU of the interface (e.g. 1500 - 28 for ethernet) prevents IP fragmentation, so
+ * that a lost packet only loses a single part. A size of 0 (default) uses the maximum UDP datagram size.
+ */
+void largeUdp_setMaxDatagramSize(largeUdp_t *handle, size_t maxDatagramSize);
+
+/**
+ * Sets the time (in ms) after which an incomplete message is dropped when no new parts are received.
+ */
+void largeUdp_setReassemblyTimeout(largeUdp_t *handle, unsigned int timeoutInMs);
+
 int largeUdp_sendto(largeUdp_t *handle, int fd, void *buf, size_t count, int flags, struct sockaddr_in *dest_addr, size_t addrlen);
+
+/**
+ * Sends the message in the io vectors, split in parts of at most largeUdp_maxPartSize. All parts are sent with as
+ * few system calls as possible (sendmmsg).
+ * Returns the number of bytes written or -1 on error.
+ */
 int largeUdp_sendmsg(largeUdp_t *handle, int fd, struct iovec *largeMsg_iovec, int len, int flags, struct sockaddr_in *dest_addr, size_t addrlen);
-bool largeUdp_dataAvailable(largeUdp_t *handle, int fd, unsigned int *index, unsigned int *size);
-int largeUdp_read(largeUdp_t *handle, unsigned int index, void ** buffer, unsigned int size);
+
+/**
+ * The maximum size of a message which is sent in a single datagram.
+ */
+size_t largeUdp_maxPartSize(largeUdp_t *handle);
+
+/**
+ * Sends every io vector as a single part message in its own datagram, using one system call for all datagrams
+ * where supported (sendmmsg). The io vectors should not exceed largeUdp_maxPartSize.
+ * Returns the number of bytes written or -1 on error.
+ */
+int largeUdp_sendmmsg(largeUdp_t *handle, int fd, struct iovec *datagrams, unsigned int nrOfDatagrams, int flags, struct sockaddr_in *dest_addr, size_t addrlen);
+
+typedef void (*largeUdp_receive_callback_t)(void *payload, void *msg, unsigned int size);
+
+/**
+ * Reads the available datagrams of the filedescriptor without blocking, using one system call for multiple
+ * datagrams where supported (recvmmsg). The callback is called for every completely reassembled message, the
+ * message is only valid during the callback.
+ * Parts are reassembled in a fixed number (maxNrUdpReceptions) of reassembly slots, the buffers of the slots are
+ * reused. If no slot is free the least recently updated message is dropped.
+ * Should not be called concurrently for the same handle.
+ * Returns the number of datagrams read or -1 on error (errno is set, ENOMEM if the receive buffers cannot be allocated).
+ */
+int largeUdp_receive(largeUdp_t *handle, int fd, largeUdp_receive_callback_t callback, void *payload);
+
+typedef struct largeUdp_statistics {
+    unsigned long nrOfMessages; //nr of completely received messages
+    unsigned long nrOfMultiPartMessages; //nr of completely received messages which needed reassembly
+    unsigned long nrOfLostMessages; //nr of incomplete messages dropped, because of a timeout or because all reassembly slots were in use
+    unsigned long nrOfReorderedParts; //nr of parts received before a part with a lower offset of the same message
+    unsigned long nrOfInvalidParts; //nr of datagrams with an invalid or inconsistent part header
+    unsigned long nrOfDuplicateParts; //nr of parts received more than once, the duplicates are ignored
+} largeUdp_statistics_t;
+
+/**
+ * Returns the receive statistics. Can be called concurrently with largeUdp_receive.
+ */
+void largeUdp_statistics(largeUdp_t *handle, largeUdp_statistics_t *statistics);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* _LARGE_UDP_H_ */
@@ -24,6 +24,7 @@
 #include "celix_log_helper.h"
 
 #include "pubsub_admin.h"
+#include "pubsub_admin_metrics.h"
 #include "pubsub_udpmc_admin.h"
 #include "celix_shell_command.h"
 
@@ -37,12 +38,16 @@ typedef struct psa_udpmc_activator {
     pubsub_admin_service_t adminService;
     long adminSvcId;
 
+    pubsub_admin_metrics_service_t adminMetricsService;
+    long adminMetricsSvcId;
+
     celix_shell_command_t cmdSvc;
     long cmdSvcId;
 } psa_udpmc_activator_t;
 
 int psa_udpmc_start(psa_udpmc_activator_t *act, celix_bundle_context_t *ctx) {
     act->adminSvcId = -1L;
+    act->adminMetricsSvcId = -1L;
     act->cmdSvcId = -1L;
     act->serializersTrackerId = -1L;
 
@@ -83,6 +88,16 @@ int psa_udpmc_start(psa_udpmc_activator_t *act, celix_bundle_context_t *ctx) {
         act->adminSvcId = celix_bundleContext_registerService(ctx, psaSvc, PUBSUB_ADMIN_SERVICE_NAME, props);
     }
 
+    if (status == CELIX_SUCCESS) {
+        act->adminMetricsService.handle = act->admin;
+        act->adminMetricsService.metrics = pubsub_udpmcAdmin_metrics;
+
+        celix_properties_t *props = celix_properties_create();
+        celix_properties_set(props, PUBSUB_ADMIN_SERVICE_TYPE, PUBSUB_UDPMC_ADMIN_TYPE);
+
+        act->adminMetricsSvcId = celix_bundleContext_registerService(ctx, &act->adminMetricsService, PUBSUB_ADMIN_METRICS_SERVICE_NAME, props);
+    }
+
     //register shell command service
     {
         act->cmdSvc.handle = act->admin;
@@ -100,6 +115,7 @@ int psa_udpmc_start(psa_udpmc_activator_t *act, celix_bundle_context_t *ctx) {
 int psa_udpmc_stop(psa_udpmc_activator_t *act, celix_bundle_context_t *ctx) {
     celix_bundleContext_unregisterService(ctx, act->adminSvcId);
     celix_bundleContext_unregisterService(ctx, act->cmdSvcId);
+    celix_bundleContext_unregisterService(ctx, act->adminMetricsSvcId);
     celix_bundleContext_stopTracker(ctx, act->serializersTrackerId);
     pubsub_udpmcAdmin_destroy(act->admin);
 
@@ -45,6 +45,13 @@
 #define PUBSUB_UDPMC_MULTICAST_IP_DEFAULT           "224.100.1.1"
 #define PUBSUB_UDPMC_VERBOSE_DEFAULT                true
 
+/**
+ * Collect the send/receive metrics per msg type, provided with the pubsub_admin_metrics service.
+ * The udp mc wire format has no metadata and sequence numbers, so the origin, delay and missing messages are unknown.
+ */
+#define PSA_UDPMC_METRICS_ENABLED                   "PSA_UDPMC_METRICS_ENABLED"
+#define PSA_UDPMC_DEFAULT_METRICS_ENABLED           false
+
 /**
  * If set true on the endpoint, the udp mc TopicSender bind and/or discovery url is statically configured.
  */
@@ -61,6 +68,44 @@
  */
 #define PUBSUB_UDPMC_STATIC_BIND_PORT                   "udpmc.static.bind.port"
 
+/**
+ * Can be set in the topic properties to enable message coalescing. Messages are queued and sent packed in as few
+ * datagrams as possible when the coalesce size (in bytes) is queued or the oldest queued message is older than the
+ * coalesce delay (in ms). A coalesce size of 0 disables coalescing.
+ */
+#define PUBSUB_UDPMC_COALESCE_SIZE                      "udpmc.coalesce.size"
+#define PUBSUB_UDPMC_COALESCE_SIZE_DEFAULT              0
+#define PUBSUB_UDPMC_COALESCE_DELAY                     "udpmc.coalesce.delay"
+#define PUBSUB_UDPMC_COALESCE_DELAY_DEFAULT             1
+
+/**
+ * Can be set in the topic properties to pack multiple queued messages (sendMany batches or coalesced messages) in a
+ * single datagram. Disabled by default, because TopicReceivers of an older version only deliver the first message of
+ * a packed datagram. Without packing every queued message is sent in its own datagram(s).
+ */
+#define PUBSUB_UDPMC_PACKING                            "udpmc.packing"
+#define PUBSUB_UDPMC_PACKING_DEFAULT                    false
+
+/**
+ * Segmentation of messages larger than a single datagram, configurable per topic (topic property) or for all topics
+ * (framework property).
+ * "ip" (default) sends parts of up to ~64KB and relies on IP fragmentation, a single lost fragment loses the part.
+ * "mtu" sends parts which fit in the MTU of the multicast interface, so no IP fragmentation is needed.
+ * A number sets the MTU (in bytes) to use, e.g. 1500.
+ */
+#define PUBSUB_UDPMC_SEGMENTATION_KEY                   "udpmc.segmentation"
+#define PSA_UDPMC_SEGMENTATION                          "PSA_UDPMC_SEGMENTATION"
+#define PUBSUB_UDPMC_SEGMENTATION_IP                    "ip"
+#define PUBSUB_UDPMC_SEGMENTATION_MTU                   "mtu"
+#define PUBSUB_UDPMC_SEGMENTATION_DEFAULT               PUBSUB_UDPMC_SEGMENTATION_IP
+#define PUBSUB_UDPMC_DEFAULT_MTU                        1500
+
+/**
+ * Time in ms after which a TopicReceiver drops a partly received message if no new parts are received.
+ */
+#define PSA_UDPMC_REASSEMBLY_TIMEOUT                    "PSA_UDPMC_REASSEMBLY_TIMEOUT"
+#define PSA_UDPMC_REASSEMBLY_TIMEOUT_DEFAULT            1000
+
 /**
  * The static url which a subscriber should try to connect to.
  * The urls are space separated
@@ -23,6 +23,9 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <ifaddrs.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 #include <pubsub_endpoint.h>
 #include <pubsub_serializer.h>
 #include <ip_utils.h>
@@ -48,6 +51,7 @@ struct pubsub_udpmc_admin {
     celix_log_helper_t *log;
     char *ifIpAddress; // The local interface which is used for multicast communication
     char *mcIpAddress; // The multicast IP address
+    unsigned int interfaceMtu; // The MTU of the multicast interface, used for MTU segmentation
     int sendSocket;
     double qosSampleScore;
     double qosControlScore;
@@ -84,6 +88,7 @@ typedef struct psa_udpmc_serializer_entry {
 } psa_udpmc_serializer_entry_t;
 
 static celix_status_t udpmc_getIpAddress(const char* interface, char** ip);
+static unsigned int udpmc_getInterfaceMtu(const char* ip);
 static celix_status_t pubsub_udpmcAdmin_connectEndpointToReceiver(pubsub_udpmc_admin_t* psa, pubsub_udpmc_topic_receiver_t *receiver, const celix_properties_t *endpoint);
 static celix_status_t pubsub_udpmcAdmin_disconnectEndpointFromReceiver(pubsub_udpmc_admin_t* psa, pubsub_udpmc_topic_receiver_t *receiver, const celix_properties_t *endpoint);
 
@@ -165,8 +170,9 @@ pubsub_udpmc_admin_t* pubsub_udpmcAdmin_create(celix_bundle_context_t *ctx, celi
         psa->ifIpAddress = strdup("127.0.0.1");
 
     }
+    psa->interfaceMtu = udpmc_getInterfaceMtu(psa->ifIpAddress);
     if (psa->verbose) {
-        L_INFO("[PSA_UDPMC] Using %s as interface for multicast communication", psa->ifIpAddress);
+        L_INFO("[PSA_UDPMC] Using %s (MTU %u) as interface for multicast communication", psa->ifIpAddress, psa->interfaceMtu);
     }
 
 
@@ -306,7 +312,7 @@ celix_status_t pubsub_udpmcAdmin_setupTopicSender(void *handle, const char *scop
     if (sender == NULL) {
         psa_udpmc_serializer_entry_t *serEntry = hashMap_get(psa->serializers.map, (void*)serializerSvcId);
         if (serEntry != NULL) {
-            sender = pubsub_udpmcTopicSender_create(psa->ctx, scope, topic, serializerSvcId, serEntry->svc, psa->sendSocket, psa->mcIpAddress, topicProps);
+            sender = pubsub_udpmcTopicSender_create(psa->ctx, scope, topic, serializerSvcId, serEntry->svc, psa->sendSocket, psa->mcIpAddress, psa->interfaceMtu, topicProps);
         }
         if (sender != NULL) {
             const char *psaType = PSA_UDPMC_PUBSUB_ADMIN_TYPE;
@@ -579,6 +585,10 @@ bool pubsub_udpmcAdmin_executeCommand(void *handle, const char *commandLine __at
 
         fprintf(out, "|- Topic Receiver %s/%s\n", scope == NULL ? "(null)" : scope, topic);
         fprintf(out, "   |- serializer type = %s\n", serType);
+        largeUdp_statistics_t stats;
+        pubsub_udpmcTopicReceiver_reassemblyStatistics(receiver, &stats);
+        fprintf(out, "   |- messages        = %lu (%lu reassembled, %lu lost)\n", stats.nrOfMessages, stats.nrOfMultiPartMessages, stats.nrOfLostMessages);
+        fprintf(out, "   |- parts           = %lu reordered, %lu duplicate, %lu invalid\n", stats.nrOfReorderedParts, stats.nrOfDuplicateParts, stats.nrOfInvalidParts);
         fprintf(out, "   |- connections (%i):\n", celix_arrayList_size(connections));
         for (int i = 0 ; i < celix_arrayList_size(connections); ++i) {
             char *conn = celix_arrayList_get(connections, i);
@@ -695,4 +705,72 @@ static celix_status_t udpmc_getIpAddress(const char* interface, char** ip) {
 
     return status;
 }
+
+/**
+ * Returns the MTU of the interface with the provided IP address or PUBSUB_UDPMC_DEFAULT_MTU if it cannot be determined.
+ */
+static unsigned int udpmc_getInterfaceMtu(const char* ip) {
+    unsigned int mtu = PUBSUB_UDPMC_DEFAULT_MTU;
+    struct ifaddrs *ifaddr, *ifa;
+    char host[NI_MAXHOST];
+
+    if (getifaddrs(&ifaddr) != -1) {
+        for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
+            if (ifa->ifa_addr == NULL || ifa->ifa_addr->sa_family != AF_INET) {
+                continue;
+            }
+            if (getnameinfo(ifa->ifa_addr, sizeof(struct sockaddr_in), host, NI_MAXHOST, NULL, 0, NI_NUMERICHOST) == 0 && strcmp(host, ip) == 0) {
+                struct ifreq ifr;
+                memset(&ifr, 0, sizeof(ifr));
+                strncpy(ifr.ifr_name, ifa->ifa_name, IFNAMSIZ - 1);
+                int fd = socket(AF_INET, SOCK_DGRAM, 0);
+                if (fd >= 0 && ioctl(fd, SIOCGIFMTU, &ifr) == 0 && ifr.ifr_mtu > 0) {
+                    mtu = (unsigned int) ifr.ifr_mtu;
+                }
+                if (fd >= 0) {
+                    close(fd);
+                }
+                break;
+            }
+        }
+        freeifaddrs(ifaddr);
+    }
+
+    return mtu;
+}
 #endif
+
+pubsub_admin_metrics_t* pubsub_udpmcAdmin_metrics(void *handle) {
+    pubsub_udpmc_admin_t *psa = handle;
+    pubsub_admin_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->psaType, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", PUBSUB_UDPMC_ADMIN_TYPE);
+    result->senders = celix_arrayList_create();
+    result->receivers = celix_arrayList_create();
+
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(psa->topicSenders.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_udpmc_topic_sender_t *sender = hashMapIterator_nextValue(&iter);
+        pubsub_admin_sender_metrics_t *metrics = pubsub_udpmcTopicSender_metrics(sender);
+        if (metrics != NULL) {
+            celix_arrayList_add(result->senders, metrics);
+        }
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    iter = hashMapIterator_construct(psa->topicReceivers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_udpmc_topic_receiver_t *receiver = hashMapIterator_nextValue(&iter);
+        pubsub_admin_receiver_metrics_t *metrics = pubsub_udpmcTopicReceiver_metrics(receiver);
+        if (metrics != NULL) {
+            celix_arrayList_add(result->receivers, metrics);
+        }
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+
+    return result;
+}
@@ -22,6 +22,7 @@
 
 #include "celix_api.h"
 #include "celix_log_helper.h"
+#include "pubsub_admin_metrics.h"
 #include "pubsub_psa_udpmc_constants.h"
 
 typedef struct pubsub_udpmc_admin pubsub_udpmc_admin_t;
@@ -47,5 +48,7 @@ celix_status_t pubsub_udpmcAdmin_removeEndpoint(void *handle, const celix_proper
 
 bool pubsub_udpmcAdmin_executeCommand(void *handle, const char *commandLine, FILE *outStream, FILE *errStream);
 
+pubsub_admin_metrics_t* pubsub_udpmcAdmin_metrics(void *handle);
+
 #endif //CELIX_PUBSUB_UDPMC_ADMIN_H
 
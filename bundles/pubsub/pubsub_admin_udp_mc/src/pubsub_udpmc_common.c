@@ -19,7 +19,7 @@
 
 #include "pubsub_udpmc_common.h"
 
-bool psa_udpmc_checkVersion(version_pt msgVersion, pubsub_udp_msg_header_t *hdr) {
+bool psa_udpmc_checkVersion(version_pt msgVersion, const pubsub_udp_msg_header_t *hdr) {
     bool check = false;
 
     if (msgVersion != NULL) {
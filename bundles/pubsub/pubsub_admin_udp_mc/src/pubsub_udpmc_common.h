@@ -31,7 +31,7 @@ typedef struct pubsub_udp_msg_header {
 } pubsub_udp_msg_header_t;
 
 
-bool psa_udpmc_checkVersion(version_pt msgVersion, pubsub_udp_msg_header_t *hdr);
+bool psa_udpmc_checkVersion(version_pt msgVersion, const pubsub_udp_msg_header_t *hdr);
 
 
 #endif //CELIX_PUBSUB_UDPMC_COMMON_H
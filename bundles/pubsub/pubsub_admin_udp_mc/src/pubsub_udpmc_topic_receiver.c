@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <pubsub/subscriber.h>
 #include <memory.h>
+#include <time.h>
 #include <pubsub_constants.h>
 #if defined(__APPLE__)
 #include <sys/types.h>
@@ -64,6 +65,7 @@ struct pubsub_udpmc_topic_receiver {
     char* ifIpAddress;
     largeUdp_t *largeUdpHandle;
     int topicEpollFd; // EPOLL filedescriptor where the sockets are registered.
+    pubsub_admin_metrics_receive_counters_t *metrics; //NULL if metrics are not enabled
 
     struct {
         celix_thread_t thread;
@@ -101,15 +103,10 @@ typedef struct psa_udpmc_subscriber_entry {
     bool initialized; //true if the init function is called through the receive thread
 } psa_udpmc_subscriber_entry_t;
 
-typedef struct pubsub_udp_msg {
-    pubsub_udp_msg_header_t header;
-    unsigned int payloadSize;
-    char payload[];
-} pubsub_udp_msg_t;
-
 static void pubsub_udpmcTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
 static void pubsub_udpmcTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
-static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub_udp_msg_t *msg);
+static void psa_udpmc_processMsgs(void *handle, void *data, unsigned int size);
+static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, const pubsub_udp_msg_header_t *header, const char *payload, unsigned int payloadSize);
 static void* psa_udpmc_recvThread(void * data);
 static void psa_udpmc_connectToAllRequestedConnections(pubsub_udpmc_topic_receiver_t *receiver);
 static void psa_udpmc_initializeAllSubscribers(pubsub_udpmc_topic_receiver_t *receiver);
@@ -132,6 +129,11 @@ pubsub_udpmc_topic_receiver_t* pubsub_udpmcTopicReceiver_create(celix_bundle_con
     receiver->ifIpAddress = strndup(ifIP, 1024 * 1024);
     receiver->recvThread.running = true;
     receiver->largeUdpHandle = largeUdp_create(MAX_UDP_SESSIONS);
+    long reassemblyTimeout = celix_bundleContext_getPropertyAsLong(ctx, PSA_UDPMC_REASSEMBLY_TIMEOUT, PSA_UDPMC_REASSEMBLY_TIMEOUT_DEFAULT);
+    largeUdp_setReassemblyTimeout(receiver->largeUdpHandle, reassemblyTimeout > 0 ? (unsigned int) reassemblyTimeout : PSA_UDPMC_REASSEMBLY_TIMEOUT_DEFAULT);
+    if (celix_bundleContext_getPropertyAsBool(ctx, PSA_UDPMC_METRICS_ENABLED, PSA_UDPMC_DEFAULT_METRICS_ENABLED)) {
+        receiver->metrics = pubsub_metricsReceiveCounters_create();
+    }
 #if defined(__APPLE__)
     receiver->topicEpollFd = kqueue();
 #else
@@ -252,6 +254,9 @@ void pubsub_udpmcTopicReceiver_destroy(pubsub_udpmc_topic_receiver_t *receiver)
         celixThreadMutex_destroy(&receiver->recvThread.mutex);
 
         largeUdp_destroy(receiver->largeUdpHandle);
+        if (receiver->metrics != NULL) {
+            pubsub_metricsReceiveCounters_destroy(receiver->metrics);
+        }
 
         free(receiver->scope);
         free(receiver->topic);
@@ -429,24 +434,13 @@ static void* psa_udpmc_recvThread(void * data) {
 #endif
         int i;
         for (i = 0; i < nfds; i++ ) {
-            unsigned int index;
-            unsigned int size;
 #if defined(__APPLE__)
             int fd = events[i].ident;
 #else
             int fd = events[i].data.fd;
 #endif
-            if (largeUdp_dataAvailable(receiver->largeUdpHandle, fd, &index, &size) == true) {
-                // Handle data
-                pubsub_udp_msg_t *udpMsg = NULL;
-                if (largeUdp_read(receiver->largeUdpHandle, index, (void**) &udpMsg, size) != 0) {
-                    printf("[PSA_UDPMC]: ERROR largeUdp_read with index %d\n", index);
-                    continue;
-                }
-
-                psa_udpmc_processMsg(receiver, udpMsg);
-
-                free(udpMsg);
+            if (largeUdp_receive(receiver->largeUdpHandle, fd, psa_udpmc_processMsgs, receiver) < 0) {
+                L_ERROR("[PSA_UDPMC] Error receiving from socket: %s", strerror(errno));
             }
         }
 
@@ -466,7 +460,39 @@ static void* psa_udpmc_recvThread(void * data) {
     return NULL;
 }
 
-static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub_udp_msg_t *msg) {
+/**
+ * Processes a received udp message, which contains one or more (coalesced) records: header, payload size and payload.
+ */
+static void psa_udpmc_processMsgs(void *handle, void *data, unsigned int size) {
+    pubsub_udpmc_topic_receiver_t *receiver = handle;
+    const char *buffer = data;
+    size_t offset = 0;
+    while (offset + sizeof(pubsub_udp_msg_header_t) + sizeof(unsigned int) <= size) {
+        pubsub_udp_msg_header_t header;
+        unsigned int payloadSize;
+        memcpy(&header, &buffer[offset], sizeof(header));
+        memcpy(&payloadSize, &buffer[offset + sizeof(header)], sizeof(payloadSize));
+        offset += sizeof(header) + sizeof(payloadSize);
+        if (payloadSize > size - offset) {
+            L_WARN("[PSA_UDPMC] Invalid payload size %u for message %d.\n", payloadSize, header.type);
+            break;
+        }
+        psa_udpmc_processMsg(receiver, &header, &buffer[offset], payloadSize);
+        offset += payloadSize;
+    }
+}
+
+static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, const pubsub_udp_msg_header_t *header, const char *payload, unsigned int payloadSize) {
+    struct timespec receiveTime;
+    struct timespec deserializeStart;
+    struct timespec deserializeEnd;
+    bool timed = false;
+    bool failed = false;
+    const char *msgFqn = NULL; //NULL if no subscriber entry has a serializer for the msg type
+    if (receiver->metrics != NULL) {
+        clock_gettime(CLOCK_REALTIME, &receiveTime);
+    }
+
     celixThreadMutex_lock(&receiver->subscribers.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
     while (hashMapIterator_hasNext(&iter)) {
@@ -474,30 +500,43 @@ static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub
 
         pubsub_msg_serializer_t *msgSer = NULL;
         if (entry->msgTypes != NULL) {
-            msgSer = hashMap_get(entry->msgTypes, (void *) (uintptr_t) msg->header.type);
+            msgSer = hashMap_get(entry->msgTypes, (void *) (uintptr_t) header->type);
         }
         if (msgSer == NULL) {
-            L_WARN("[PSA_UDPMC] Serializer not available for message %d.\n", msg->header.type);
+            L_WARN("[PSA_UDPMC] Serializer not available for message %d.\n", header->type);
         } else {
             void *msgInst = NULL;
-            bool validVersion = psa_udpmc_checkVersion(msgSer->msgVersion, &msg->header);
+            bool validVersion = psa_udpmc_checkVersion(msgSer->msgVersion, header);
 
             if (validVersion) {
                 struct iovec deSerializeBuffer;
-                deSerializeBuffer.iov_base = msg->payload;
-                deSerializeBuffer.iov_len  = 0;
-                celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &msgInst);
+                deSerializeBuffer.iov_base = (void *) payload;
+                deSerializeBuffer.iov_len  = payloadSize;
+                //note only the first deserialization of a message is timed
+                bool monitor = receiver->metrics != NULL && !timed;
+                msgFqn = msgSer->msgName;
+                if (monitor) {
+                    clock_gettime(CLOCK_REALTIME, &deserializeStart);
+                }
+                celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 1, &msgInst);
+                if (monitor) {
+                    clock_gettime(CLOCK_REALTIME, &deserializeEnd);
+                    timed = true;
+                }
+                if (status != CELIX_SUCCESS) {
+                    failed = true;
+                }
 
                 if (status == CELIX_SUCCESS) {
                     hash_map_iterator_t iter2 = hashMapIterator_construct(entry->subscriberServices);
                     bool release = true;
                     while (hashMapIterator_hasNext(&iter2)) {
                         pubsub_subscriber_t *svc = hashMapIterator_nextValue(&iter2);
-                        svc->receive(svc->handle, msgSer->msgName, msg->header.type, msgInst, NULL, &release);
+                        svc->receive(svc->handle, msgSer->msgName, header->type, msgInst, NULL, &release);
                         if (!release && hashMapIterator_hasNext(&iter2)) {
                             //receive function has taken ownership and still more receive function to come ..
                             //deserialize again for new message
-                            status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &msgInst);
+                            status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 1, &msgInst);
                             if (status != CELIX_SUCCESS) {
                                 L_WARN("[PSA_UDPMC] Cannot deserialize msgType %s.\n",msgSer->msgName);
                                 break;
@@ -517,11 +556,17 @@ static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub
                 version_getMajor(msgSer->msgVersion, &major);
                 version_getMinor(msgSer->msgVersion, &minor);
                 L_WARN("[PSA_UDPMC] Version mismatch for primary message '%s' (have %d.%d, received %u.%u). NOT sending any part of the whole message.\n",
-                       msgSer->msgName,major,minor,msg->header.major,msg->header.minor);
+                       msgSer->msgName,major,minor,header->major,header->minor);
             }
 
         }
     }
+    if (receiver->metrics != NULL && msgFqn != NULL) {
+        //note msgFqn points to a serializer name, so the update is done while still locked
+        pubsub_metricsReceiveCounters_update(receiver->metrics, header->type, msgFqn, NULL, 0, NULL, &receiveTime,
+                                             timed ? &deserializeStart : NULL, timed ? &deserializeEnd : NULL,
+                                             failed ? 0 : 1, failed ? 1 : 0);
+    }
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
 
@@ -538,6 +583,27 @@ void pubsub_udpmcTopicReceiver_listConnections(pubsub_udpmc_topic_receiver_t *re
     celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 }
 
+void pubsub_udpmcTopicReceiver_reassemblyStatistics(pubsub_udpmc_topic_receiver_t *receiver, largeUdp_statistics_t *statistics) {
+    largeUdp_statistics(receiver->largeUdpHandle, statistics);
+}
+
+pubsub_admin_receiver_metrics_t* pubsub_udpmcTopicReceiver_metrics(pubsub_udpmc_topic_receiver_t *receiver) {
+    if (receiver->metrics == NULL) {
+        return NULL;
+    }
+    pubsub_admin_receiver_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : receiver->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
+    largeUdp_statistics_t statistics;
+    largeUdp_statistics(receiver->largeUdpHandle, &statistics);
+    result->nrOfDroppedMessages = statistics.nrOfLostMessages;
+    pubsub_metricsReceiveCounters_fill(receiver->metrics, result);
+    return result;
+}
+
 static bool psa_udpmc_connectToEntry(pubsub_udpmc_topic_receiver_t *receiver, psa_udpmc_requested_connection_entry_t *entry) {
     bool connected = true;
     int rc  = 0;
@@ -23,6 +23,8 @@
 #include "celix_bundle_context.h"
 #include "pubsub_serializer.h"
 #include "celix_log_helper.h"
+#include "large_udp.h"
+#include "pubsub_admin_metrics.h"
 
 typedef struct pubsub_udpmc_topic_receiver pubsub_udpmc_topic_receiver_t;
 
@@ -40,10 +42,17 @@ const char* pubsub_udpmcTopicReceiver_scope(pubsub_udpmc_topic_receiver_t *recei
 const char* pubsub_udpmcTopicReceiver_topic(pubsub_udpmc_topic_receiver_t *receiver);
 const char* pubsub_udpmcTopicReceiver_socketAddress(pubsub_udpmc_topic_receiver_t *receiver);
 void pubsub_udpmcTopicReceiver_listConnections(pubsub_udpmc_topic_receiver_t *receiver, celix_array_list_t *connections);
+void pubsub_udpmcTopicReceiver_reassemblyStatistics(pubsub_udpmc_topic_receiver_t *receiver, largeUdp_statistics_t *statistics);
 
 long pubsub_udpmcTopicReceiver_serializerSvcId(pubsub_udpmc_topic_receiver_t *receiver);
 
 void pubsub_udpmcTopicReceiver_connectTo(pubsub_udpmc_topic_receiver_t *receiver, const char *socketAddress, long socketPort);
 void pubsub_udpmcTopicReceiver_disconnectFrom(pubsub_udpmc_topic_receiver_t *receiver, const char *socketAddress, long socketPort);
 
+/**
+ * Returns the receive metrics per msg type or NULL if metrics are not enabled.
+ * The dropped messages are the incomplete messages dropped during reassembly.
+ */
+pubsub_admin_receiver_metrics_t* pubsub_udpmcTopicReceiver_metrics(pubsub_udpmc_topic_receiver_t *receiver);
+
 #endif //CELIX_PUBSUB_UDPMC_TOPIC_RECEIVER_H
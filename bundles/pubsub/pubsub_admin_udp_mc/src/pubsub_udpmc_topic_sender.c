@@ -21,7 +21,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <time.h>
 #include <pubsub_constants.h>
+#include <pubsub_endpoint.h>
 #include <pubsub/publisher.h>
 #include <utils.h>
 #include <zconf.h>
@@ -37,6 +39,7 @@
 //TODO make configurable
 #define UDP_BASE_PORT                   49152
 #define UDP_MAX_PORT                    65000
+#define UDP_IP_HEADER_SIZE              28
 
 
 struct pubsub_udpmc_topic_sender {
@@ -48,9 +51,26 @@ struct pubsub_udpmc_topic_sender {
     char *socketAddress;
     long socketPort;
     bool staticallyConfigured;
+    bool metricsEnabled;
 
     int sendSocket;
     struct sockaddr_in destAddr;
+    size_t maxDatagramSize; //0 = maximum UDP datagram size (IP fragmentation)
+
+    struct {
+        celix_thread_mutex_t mutex; //protects entries in struct, also serializes the sending of the batch
+        celix_thread_cond_t cond;
+        celix_thread_t thread; //only started when coalescing is enabled
+        bool running;
+        largeUdp_t *largeUdpHandle;
+        char *buffer; //queued records: header, payload size and payload
+        size_t size;
+        size_t capacity;
+        struct timespec time; //time the oldest record was queued
+        size_t coalesceSize; //0 = coalescing disabled
+        unsigned int coalesceDelay; //in ms
+        bool packing; //if true multiple records are packed in a single datagram
+    } batch;
 
     struct {
         long svcId;
@@ -69,6 +89,7 @@ typedef struct psa_udpmc_bounded_service_entry {
     long bndId;
     hash_map_t *msgTypes;
     hash_map_t *msgTypeIds;
+    hash_map_t *msgMetrics; //key = msg type id, value = pubsub_admin_metrics_send_counters_t*, NULL if metrics are disabled
     int getCount;
     largeUdp_t *largeUdpHandle;
 } psa_udpmc_bounded_service_entry_t;
@@ -83,7 +104,11 @@ static int psa_udpmc_localMsgTypeIdForMsgType(void* handle, const char* msgType,
 static void* psa_udpmc_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
 static void psa_udpmc_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
 static int psa_udpmc_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata);
+static int psa_udpmc_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
 static bool psa_udpmc_sendMsg(psa_udpmc_bounded_service_entry_t *entry, pubsub_udp_msg_t* msg);
+static void psa_udpmc_queueMsg(pubsub_udpmc_topic_sender_t *sender, pubsub_udp_msg_t* msg);
+static bool psa_udpmc_flushQueue(pubsub_udpmc_topic_sender_t *sender);
+static void* psa_udpmc_flushThread(void *data);
 static unsigned int rand_range(unsigned int min, unsigned int max);
 
 pubsub_udpmc_topic_sender_t* pubsub_udpmcTopicSender_create(
@@ -94,6 +119,7 @@ pubsub_udpmc_topic_sender_t* pubsub_udpmcTopicSender_create(
         pubsub_serializer_service_t *serializer,
         int sendSocket,
         const char *bindIP,
+        unsigned int interfaceMtu,
         const celix_properties_t *topicProperties) {
     pubsub_udpmc_topic_sender_t *sender = calloc(1, sizeof(*sender));
     sender->ctx = ctx;
@@ -101,6 +127,7 @@ pubsub_udpmc_topic_sender_t* pubsub_udpmcTopicSender_create(
     sender->serializer = serializer;
     sender->scope = scope == NULL ? NULL : strndup(scope, 1024 * 1024);
     sender->topic = strndup(topic, 1024 * 1024);
+    sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_UDPMC_METRICS_ENABLED, PSA_UDPMC_DEFAULT_METRICS_ENABLED);
 
     celixThreadMutex_create(&sender->boundedServices.mutex, NULL);
     sender->boundedServices.map = hashMap_create(NULL, NULL, NULL, NULL);
@@ -139,6 +166,41 @@ pubsub_udpmc_topic_sender_t* pubsub_udpmcTopicSender_create(
         sender->socketPort = port;
     }
 
+    //setting up the segmentation
+    {
+        const char *segmentation = celix_bundleContext_getProperty(ctx, PSA_UDPMC_SEGMENTATION, PUBSUB_UDPMC_SEGMENTATION_DEFAULT);
+        segmentation = celix_properties_get(topicProperties, PUBSUB_UDPMC_SEGMENTATION_KEY, segmentation);
+        long mtu = 0;
+        if (strcmp(segmentation, PUBSUB_UDPMC_SEGMENTATION_MTU) == 0) {
+            mtu = interfaceMtu;
+        } else if (strcmp(segmentation, PUBSUB_UDPMC_SEGMENTATION_IP) != 0) {
+            char *endptr = NULL;
+            mtu = strtol(segmentation, &endptr, 10);
+            if (endptr == segmentation || mtu <= UDP_IP_HEADER_SIZE) {
+                fprintf(stderr, "[PSA_UDPMC/TopicSender] Invalid segmentation '%s', using IP fragmentation\n", segmentation);
+                mtu = 0;
+            }
+        }
+        sender->maxDatagramSize = mtu > 0 ? (size_t) (mtu - UDP_IP_HEADER_SIZE) : 0;
+    }
+
+    //setting up the batch queue, used by sendMany and for coalescing
+    {
+        celixThreadMutex_create(&sender->batch.mutex, NULL);
+        celixThreadCondition_init(&sender->batch.cond, NULL);
+        sender->batch.largeUdpHandle = largeUdp_create(1);
+        largeUdp_setMaxDatagramSize(sender->batch.largeUdpHandle, sender->maxDatagramSize);
+        sender->batch.packing = celix_properties_getAsBool(topicProperties, PUBSUB_UDPMC_PACKING, PUBSUB_UDPMC_PACKING_DEFAULT);
+        long coalesceSize = celix_properties_getAsLong(topicProperties, PUBSUB_UDPMC_COALESCE_SIZE, PUBSUB_UDPMC_COALESCE_SIZE_DEFAULT);
+        long coalesceDelay = celix_properties_getAsLong(topicProperties, PUBSUB_UDPMC_COALESCE_DELAY, PUBSUB_UDPMC_COALESCE_DELAY_DEFAULT);
+        if (coalesceSize > 0) {
+            sender->batch.coalesceSize = (size_t) coalesceSize;
+            sender->batch.coalesceDelay = coalesceDelay > 0 ? (unsigned int) coalesceDelay : 1;
+            sender->batch.running = true;
+            celixThread_create(&sender->batch.thread, NULL, psa_udpmc_flushThread, sender);
+        }
+    }
+
     //register publisher services using a service factory
     {
         sender->publisher.factory.handle = sender;
@@ -171,6 +233,20 @@ void pubsub_udpmcTopicSender_destroy(pubsub_udpmc_topic_sender_t *sender) {
     if (sender != NULL) {
         celix_bundleContext_unregisterService(sender->ctx, sender->publisher.svcId);
 
+        celixThreadMutex_lock(&sender->batch.mutex);
+        bool running = sender->batch.running;
+        sender->batch.running = false;
+        celixThreadCondition_broadcast(&sender->batch.cond);
+        celixThreadMutex_unlock(&sender->batch.mutex);
+        if (running) {
+            celixThread_join(sender->batch.thread, NULL);
+        }
+        psa_udpmc_flushQueue(sender);
+        free(sender->batch.buffer);
+        largeUdp_destroy(sender->batch.largeUdpHandle);
+        celixThreadCondition_destroy(&sender->batch.cond);
+        celixThreadMutex_destroy(&sender->batch.mutex);
+
         celixThreadMutex_destroy(&sender->boundedServices.mutex);
 
         //TODO loop and cleanup?
@@ -236,19 +312,31 @@ static void* psa_udpmc_getPublisherService(void *handle, const celix_bundle_t *r
         entry->parent = sender;
         entry->bndId = bndId;
         entry->largeUdpHandle = largeUdp_create(1);
+        largeUdp_setMaxDatagramSize(entry->largeUdpHandle, sender->maxDatagramSize);
         entry->msgTypeIds = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
 
         int rc = sender->serializer->createSerializerMap(sender->serializer->handle, (celix_bundle_t*)requestingBundle, &entry->msgTypes);
         if (rc == 0) {
             hash_map_iterator_t iter = hashMapIterator_construct(entry->msgTypes);
+            if (sender->metricsEnabled) {
+                entry->msgMetrics = hashMap_create(NULL, NULL, NULL, NULL);
+            }
             while (hashMapIterator_hasNext(&iter)) {
                 pubsub_msg_serializer_t *msgSer  = hashMapIterator_nextValue(&iter);
                 hashMap_put(entry->msgTypeIds, strndup(msgSer->msgName, 1024), (void *)(uintptr_t) msgSer->msgId);
+                if (entry->msgMetrics != NULL) {
+                    pubsub_admin_metrics_send_counters_t *counters = malloc(sizeof(*counters));
+                    if (counters != NULL) {
+                        pubsub_metricsSendCounters_init(counters);
+                        hashMap_put(entry->msgMetrics, (void *)(uintptr_t) msgSer->msgId, counters);
+                    }
+                }
             }
 
             entry->service.handle = entry;
             entry->service.localMsgTypeIdForMsgType = psa_udpmc_localMsgTypeIdForMsgType;
             entry->service.send = psa_udpmc_topicPublicationSend;
+            entry->service.sendMany = psa_udpmc_topicPublicationSendMany;
             hashMap_put(sender->boundedServices.map, (void*)bndId, entry);
             svc = &entry->service;
         } else {
@@ -280,25 +368,56 @@ static void psa_udpmc_ungetPublisherService(void *handle, const celix_bundle_t *
         }
 
         hashMap_destroy(entry->msgTypeIds, true, false);
+        if (entry->msgMetrics != NULL) {
+            hash_map_iterator_t iter = hashMapIterator_construct(entry->msgMetrics);
+            while (hashMapIterator_hasNext(&iter)) {
+                pubsub_admin_metrics_send_counters_t *counters = hashMapIterator_nextValue(&iter);
+                pubsub_metricsSendCounters_deinit(counters);
+                free(counters);
+            }
+            hashMap_destroy(entry->msgMetrics, false, false);
+        }
         largeUdp_destroy(entry->largeUdpHandle);
         free(entry);
     }
     celixThreadMutex_unlock(&sender->boundedServices.mutex);
 }
 
-static int psa_udpmc_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
-    psa_udpmc_bounded_service_entry_t *entry = handle;
+/**
+ * Serializes and sends the message, or appends it to the batch queue if queue is set.
+ * Note: the batch.mutex should be locked when queue is set.
+ */
+static int psa_udpmc_publish(psa_udpmc_bounded_service_entry_t *entry, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata, bool queue) {
     int status = 0;
 
+    //metadata is not supported by the udp mc wire format, but the publisher does take ownership
+    if (metadata != NULL) {
+        celix_properties_destroy(metadata);
+    }
+
     pubsub_msg_serializer_t* msgSer = NULL;
     if (entry->msgTypes != NULL) {
         msgSer = hashMap_get(entry->msgTypes, (void*)(intptr_t)(msgTypeId));
     }
 
+    pubsub_admin_metrics_send_counters_t *counters = NULL;
+    struct timespec serializationStart;
+    struct timespec serializationEnd;
+    if (msgSer != NULL && entry->msgMetrics != NULL) {
+        counters = hashMap_get(entry->msgMetrics, (void*)(uintptr_t)msgTypeId);
+    }
+
     if (msgSer != NULL) {
         size_t serializedOutputLen = 0;
         struct iovec* serializedOutput = NULL;
-        if (msgSer->serialize(msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen) == CELIX_SUCCESS) {
+        if (counters != NULL) {
+            clock_gettime(CLOCK_REALTIME, &serializationStart);
+        }
+        celix_status_t rc = msgSer->serialize(msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen);
+        if (counters != NULL) {
+            clock_gettime(CLOCK_REALTIME, &serializationEnd);
+        }
+        if (rc == CELIX_SUCCESS) {
             pubsub_udp_msg_header_t *msg_hdr = calloc(1, sizeof(*msg_hdr));
             msg_hdr->type = msgTypeId;
 
@@ -315,15 +434,24 @@ static int psa_udpmc_topicPublicationSend(void* handle, unsigned int msgTypeId,
             msg->payload = (char *) serializedOutput->iov_base;
             msg->payloadSize = (unsigned int)  serializedOutput->iov_len;
 
-            if (psa_udpmc_sendMsg(entry, msg) == false) {
+            if (queue) {
+                psa_udpmc_queueMsg(entry->parent, msg);
+            } else if (psa_udpmc_sendMsg(entry, msg) == false) {
                 status = -1;
             }
             free(msg);
             free(msg_hdr);
             msgSer->freeSerializeMsg(msgSer->handle, serializedOutput, serializedOutputLen);
+            if (counters != NULL) {
+                //note a queued message is counted as send, a failed flush cannot be attributed to a msg type
+                pubsub_metricsSendCounters_update(counters, &serializationStart, &serializationEnd, status == 0 ? 1 : 0, status == 0 ? 0 : 1, 0);
+            }
         } else {
             printf("[PSA_UDPMC/TopicSender] Serialization of msg type id %d failed\n", msgTypeId);
             status = -1;
+            if (counters != NULL) {
+                pubsub_metricsSendCounters_update(counters, &serializationStart, &serializationEnd, 0, 0, 1);
+            }
         }
 
     } else {
@@ -333,6 +461,45 @@ static int psa_udpmc_topicPublicationSend(void* handle, unsigned int msgTypeId,
     return status;
 }
 
+static int psa_udpmc_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
+    psa_udpmc_bounded_service_entry_t *entry = handle;
+    pubsub_udpmc_topic_sender_t *sender = entry->parent;
+    if (sender->batch.coalesceSize == 0) {
+        return psa_udpmc_publish(entry, msgTypeId, inMsg, metadata, false);
+    }
+
+    celixThreadMutex_lock(&sender->batch.mutex);
+    int status = psa_udpmc_publish(entry, msgTypeId, inMsg, metadata, true);
+    if (sender->batch.size >= sender->batch.coalesceSize) {
+        if (!psa_udpmc_flushQueue(sender)) {
+            status = -1;
+        }
+    } else {
+        celixThreadCondition_signal(&sender->batch.cond);
+    }
+    celixThreadMutex_unlock(&sender->batch.mutex);
+    return status;
+}
+
+static int psa_udpmc_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    psa_udpmc_bounded_service_entry_t *entry = handle;
+    pubsub_udpmc_topic_sender_t *sender = entry->parent;
+    int status = 0;
+
+    celixThreadMutex_lock(&sender->batch.mutex);
+    for (size_t i = 0; i < nrOfMsgs; ++i) {
+        int rc = psa_udpmc_publish(entry, msgs[i].msgTypeId, msgs[i].msg, msgs[i].metadata, true);
+        if (status == 0) {
+            status = rc;
+        }
+    }
+    if (!psa_udpmc_flushQueue(sender) && status == 0) {
+        status = -1;
+    }
+    celixThreadMutex_unlock(&sender->batch.mutex);
+    return status;
+}
+
 static void delay_first_send_for_late_joiners() {
 
     static bool firstSend = true;
@@ -366,6 +533,107 @@ static bool psa_udpmc_sendMsg(psa_udpmc_bounded_service_entry_t *entry, pubsub_u
     return ret;
 }
 
+/**
+ * Appends the message as record (header, payload size, payload) to the batch queue.
+ * Note: the batch.mutex should be locked.
+ */
+static void psa_udpmc_queueMsg(pubsub_udpmc_topic_sender_t *sender, pubsub_udp_msg_t* msg) {
+    size_t recordSize = sizeof(*msg->header) + sizeof(msg->payloadSize) + msg->payloadSize;
+    if (sender->batch.size + recordSize > sender->batch.capacity) {
+        size_t capacity = sender->batch.capacity == 0 ? largeUdp_maxPartSize(sender->batch.largeUdpHandle) : sender->batch.capacity * 2;
+        while (capacity < sender->batch.size + recordSize) {
+            capacity *= 2;
+        }
+        sender->batch.buffer = realloc(sender->batch.buffer, capacity);
+        sender->batch.capacity = capacity;
+    }
+    if (sender->batch.size == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &sender->batch.time);
+    }
+    char *record = &sender->batch.buffer[sender->batch.size];
+    memcpy(record, msg->header, sizeof(*msg->header));
+    memcpy(record + sizeof(*msg->header), &msg->payloadSize, sizeof(msg->payloadSize));
+    memcpy(record + sizeof(*msg->header) + sizeof(msg->payloadSize), msg->payload, msg->payloadSize);
+    sender->batch.size += recordSize;
+}
+
+/**
+ * Sends the queued records. If packing is enabled as many records as fit in a single datagram are packed, otherwise
+ * every record gets its own datagram. All datagrams are sent with one system call, records larger than a datagram
+ * are sent on their own using multiple parts.
+ * Note: the batch.mutex should be locked.
+ */
+static bool psa_udpmc_flushQueue(pubsub_udpmc_topic_sender_t *sender) {
+    bool ret = true;
+    size_t maxDatagramSize = largeUdp_maxPartSize(sender->batch.largeUdpHandle);
+    size_t nrOfDatagrams = 0;
+    size_t maxNrOfDatagrams = sender->batch.size / sizeof(pubsub_udp_msg_header_t) + 1;
+    struct iovec *datagrams = calloc(maxNrOfDatagrams, sizeof(*datagrams));
+    size_t offset = 0;
+
+    if (sender->batch.size > 0) {
+        delay_first_send_for_late_joiners();
+    }
+    while (offset < sender->batch.size) {
+        unsigned int payloadSize;
+        memcpy(&payloadSize, &sender->batch.buffer[offset + sizeof(pubsub_udp_msg_header_t)], sizeof(payloadSize));
+        size_t recordSize = sizeof(pubsub_udp_msg_header_t) + sizeof(payloadSize) + payloadSize;
+        char *record = &sender->batch.buffer[offset];
+        struct iovec *current = nrOfDatagrams > 0 ? &datagrams[nrOfDatagrams - 1] : NULL;
+        if (recordSize > maxDatagramSize) {
+            //keep the order, first send the packed datagrams
+            if (nrOfDatagrams > 0 && largeUdp_sendmmsg(sender->batch.largeUdpHandle, sender->sendSocket, datagrams, nrOfDatagrams, 0, &sender->destAddr, sizeof(sender->destAddr)) == -1) {
+                ret = false;
+            }
+            nrOfDatagrams = 0;
+            struct iovec largeRecord = {.iov_base = record, .iov_len = recordSize};
+            if (largeUdp_sendmsg(sender->batch.largeUdpHandle, sender->sendSocket, &largeRecord, 1, 0, &sender->destAddr, sizeof(sender->destAddr)) == -1) {
+                ret = false;
+            }
+        } else if (sender->batch.packing && current != NULL && current->iov_len + recordSize <= maxDatagramSize) {
+            current->iov_len += recordSize;
+        } else {
+            datagrams[nrOfDatagrams].iov_base = record;
+            datagrams[nrOfDatagrams].iov_len = recordSize;
+            nrOfDatagrams++;
+        }
+        offset += recordSize;
+    }
+    if (nrOfDatagrams > 0 && largeUdp_sendmmsg(sender->batch.largeUdpHandle, sender->sendSocket, datagrams, nrOfDatagrams, 0, &sender->destAddr, sizeof(sender->destAddr)) == -1) {
+        ret = false;
+    }
+    if (!ret) {
+        perror("send_pubsub_msg:sendSocket");
+    }
+    free(datagrams);
+    sender->batch.size = 0;
+    return ret;
+}
+
+/**
+ * Sends the coalesced records when the oldest record reaches the coalesce delay.
+ */
+static void* psa_udpmc_flushThread(void *data) {
+    pubsub_udpmc_topic_sender_t *sender = data;
+    celixThreadMutex_lock(&sender->batch.mutex);
+    while (sender->batch.running) {
+        if (sender->batch.size == 0) {
+            celixThreadCondition_wait(&sender->batch.cond, &sender->batch.mutex);
+            continue;
+        }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double remaining = sender->batch.coalesceDelay / 1000.0 - celix_difftime(&sender->batch.time, &now);
+        if (remaining <= 0) {
+            psa_udpmc_flushQueue(sender);
+        } else {
+            celixThreadCondition_timedwaitRelative(&sender->batch.cond, &sender->batch.mutex, (long) remaining, (long) ((remaining - (long) remaining) * 1000000000.0));
+        }
+    }
+    celixThreadMutex_unlock(&sender->batch.mutex);
+    return NULL;
+}
+
 static unsigned int rand_range(unsigned int min, unsigned int max) {
     double scaled = ((double)random())/((double)RAND_MAX);
     return (unsigned int)((max-min+1)*scaled + min);
@@ -378,3 +646,43 @@ long pubsub_udpmcTopicSender_serializerSvcId(pubsub_udpmc_topic_sender_t *sender
 bool pubsub_udpmcTopicSender_isStatic(pubsub_udpmc_topic_sender_t *sender) {
     return sender->staticallyConfigured;
 }
+
+pubsub_admin_sender_metrics_t* pubsub_udpmcTopicSender_metrics(pubsub_udpmc_topic_sender_t *sender) {
+    if (!sender->metricsEnabled) {
+        return NULL;
+    }
+    pubsub_admin_sender_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : sender->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->topic);
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    unsigned int count = 0;
+    hash_map_iterator_t iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_udpmc_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        count += (unsigned int)hashMap_size(entry->msgMetrics);
+    }
+    result->msgMetrics = calloc(count, sizeof(*result->msgMetrics));
+    unsigned int i = 0;
+    iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter) && result->msgMetrics != NULL) {
+        psa_udpmc_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgMetrics);
+        while (hashMapIterator_hasNext(&iter2)) {
+            hash_map_entry_t *mapEntry = hashMapIterator_nextEntry(&iter2);
+            unsigned int msgTypeId = (unsigned int)(uintptr_t)hashMapEntry_getKey(mapEntry);
+            pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)msgTypeId);
+            pubsub_metricsSendCounters_fill(hashMapEntry_getValue(mapEntry), &result->msgMetrics[i]);
+            result->msgMetrics[i].bndId = entry->bndId;
+            result->msgMetrics[i].typeId = msgTypeId;
+            snprintf(result->msgMetrics[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", msgSer == NULL ? "" : msgSer->msgName);
+            i += 1;
+        }
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+    result->nrOfmsgMetrics = result->msgMetrics == NULL ? 0 : i;
+    return result;
+}
@@ -22,6 +22,7 @@
 
 #include "celix_bundle_context.h"
 #include "pubsub_serializer.h"
+#include "pubsub_admin_metrics.h"
 
 typedef struct pubsub_udpmc_topic_sender pubsub_udpmc_topic_sender_t;
 
@@ -33,6 +34,7 @@ pubsub_udpmc_topic_sender_t* pubsub_udpmcTopicSender_create(
         pubsub_serializer_service_t *serializer,
         int sendSocket,
         const char *bindIP,
+        unsigned int interfaceMtu,
         const celix_properties_t *topicProperties);
 void pubsub_udpmcTopicSender_destroy(pubsub_udpmc_topic_sender_t *sender);
 
@@ -50,4 +52,9 @@ long pubsub_udpmcTopicSender_serializerSvcId(pubsub_udpmc_topic_sender_t *sender
 void pubsub_udpmcTopicSender_connectTo(pubsub_udpmc_topic_sender_t *sender, const celix_properties_t *endpoint);
 void pubsub_udpmcTopicSender_disconnectFrom(pubsub_udpmc_topic_sender_t *sender, const celix_properties_t *endpoint);
 
+/**
+ * Returns the send metrics per msg type/bundle or NULL if metrics are not enabled.
+ */
+pubsub_admin_sender_metrics_t* pubsub_udpmcTopicSender_metrics(pubsub_udpmc_topic_sender_t *sender);
+
 #endif //CELIX_PUBSUB_UDPMC_TOPIC_SENDER_H
@@ -0,0 +1,278 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "celix_properties.h"
+#include "pubsub_websocket_common.h"
+
+class PubSubWebsocketCommonTestSuite : public ::testing::Test {
+public:
+    PubSubWebsocketCommonTestSuite() {
+        pubsubProtocol_wire_v2_create(&protocol);
+    }
+    ~PubSubWebsocketCommonTestSuite() override {
+        pubsubProtocol_wire_v2_destroy(protocol);
+    }
+    PubSubWebsocketCommonTestSuite(const PubSubWebsocketCommonTestSuite&) = delete;
+    PubSubWebsocketCommonTestSuite& operator=(const PubSubWebsocketCommonTestSuite&) = delete;
+
+    static std::string encodeText(const char* fqn, uint8_t major, uint8_t minor, uint32_t seqNr, const std::string& payload) {
+        size_t prefixLen = 0;
+        char* prefix = psa_websocket_createTextEnvelopePrefix(fqn, major, minor, &prefixLen);
+        EXPECT_NE(nullptr, prefix);
+        struct iovec iov{};
+        iov.iov_base = (void*)payload.data();
+        iov.iov_len = payload.size();
+        char* msg = nullptr;
+        size_t msgSize = 0;
+        EXPECT_EQ(CELIX_SUCCESS, psa_websocket_encodeTextMessage(prefix, prefixLen, seqNr, &iov, 1, &msg, &msgSize));
+        std::string result{msg, msgSize};
+        free(msg);
+        free(prefix);
+        return result;
+    }
+
+    static bool parseText(const std::string& msg, pubsub_websocket_msg_header_t* hdr, std::string* data) {
+        char* id = nullptr;
+        const char* dataStart = nullptr;
+        size_t dataSize = 0;
+        bool valid = psa_websocket_parseTextEnvelope(msg.data(), msg.size(), hdr, &id, &dataStart, &dataSize);
+        if (valid) {
+            EXPECT_NE(nullptr, id);
+            EXPECT_EQ(hdr->id, id);
+            *data = std::string{dataStart, dataSize};
+        } else {
+            EXPECT_EQ(nullptr, id);
+        }
+        free(id);
+        return valid;
+    }
+
+    pubsub_protocol_wire_v2_t* protocol{nullptr};
+};
+
+TEST_F(PubSubWebsocketCommonTestSuite, TextEnvelopeRoundTrip) {
+    std::string msg = encodeText("example.Msg", 2, 3, 42, R"({"a":1,"b":[1,2,{"c":"}"}]})");
+    EXPECT_EQ(R"({"id":"example.Msg","major":2,"minor":3,"seqNr":42,"data":{"a":1,"b":[1,2,{"c":"}"}]}})", msg);
+
+    pubsub_websocket_msg_header_t hdr{};
+    std::string data;
+    ASSERT_TRUE(parseText(msg, &hdr, &data));
+    EXPECT_EQ(2, hdr.major);
+    EXPECT_EQ(3, hdr.minor);
+    EXPECT_EQ(42, hdr.seqNr);
+    EXPECT_EQ(R"({"a":1,"b":[1,2,{"c":"}"}]})", data);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, TextEnvelopeWithEscapedId) {
+    std::string msg = encodeText("odd\"name\\", 1, 0, 1, "[]");
+    char* id = nullptr;
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    pubsub_websocket_msg_header_t hdr{};
+    ASSERT_TRUE(psa_websocket_parseTextEnvelope(msg.data(), msg.size(), &hdr, &id, &data, &dataSize));
+    EXPECT_STREQ("odd\"name\\", id);
+    EXPECT_EQ("[]", std::string(data, dataSize));
+    free(id);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, TextEnvelopeWithEmptyPayloadIsNull) {
+    std::string msg = encodeText("example.Msg", 1, 0, 7, "");
+    EXPECT_EQ(R"({"id":"example.Msg","major":1,"minor":0,"seqNr":7,"data":null})", msg);
+
+    pubsub_websocket_msg_header_t hdr{};
+    std::string data;
+    ASSERT_TRUE(parseText(msg, &hdr, &data));
+    EXPECT_EQ("null", data);
+    EXPECT_EQ(7, hdr.seqNr);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, TextEnvelopeFieldOrderAndWhitespace) {
+    pubsub_websocket_msg_header_t hdr{};
+    std::string data;
+    ASSERT_TRUE(parseText(" { \"data\" : \"x,}\" , \"extra\":[1,{}], \"seqNr\":3,\"minor\":1,\"major\":4,\"id\":\"a.B\" } ", &hdr, &data));
+    EXPECT_EQ(4, hdr.major);
+    EXPECT_EQ(1, hdr.minor);
+    EXPECT_EQ(3, hdr.seqNr);
+    EXPECT_EQ("\"x,}\"", data);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, MalformedTextEnvelopesAreRejected) {
+    const char* malformed[] = {
+            "",
+            "   ",
+            "[]",
+            "null",
+            "{}",
+            R"({"id":"a","major":1,"minor":0,"seqNr":1})", //missing data
+            R"({"id":"a","major":1,"minor":0,"data":{}})", //missing seqNr
+            R"({"major":1,"minor":0,"seqNr":1,"data":{}})", //missing id
+            R"({"id":"a","major":1,"minor":0,"seqNr":1,"data":{})", //truncated
+            R"({"id":"a","major":1,"minor":0,"seqNr":1,"data":{"b":1)",
+            R"({"id":"a","major":1,"minor":0,"seqNr":1,"data":"abc)",
+            R"({"id":"a","major":-1,"minor":0,"seqNr":1,"data":{}})", //bad numbers
+            R"({"id":"a","major":1.5,"minor":0,"seqNr":1,"data":{}})",
+            R"({"id":"a","major":"1","minor":0,"seqNr":1,"data":{}})",
+            R"({"id":1,"major":1,"minor":0,"seqNr":1,"data":{}})", //id not a string
+            R"({"id":"a","id":"b","major":1,"minor":0,"seqNr":1,"data":{}})", //duplicate id
+            R"({"id":"a" "major":1,"minor":0,"seqNr":1,"data":{}})", //missing comma
+            R"({"id":"a","major"1,"minor":0,"seqNr":1,"data":{}})", //missing colon
+            R"({id:"a","major":1,"minor":0,"seqNr":1,"data":{}})", //unquoted key
+            R"({"id":"a","major":1,"minor":0,"seqNr":1,"data":})", //missing value
+    };
+    for (const char* msg : malformed) {
+        pubsub_websocket_msg_header_t hdr{};
+        std::string data;
+        EXPECT_FALSE(parseText(msg, &hdr, &data)) << "for message " << msg;
+    }
+
+    //message size is respected, a complete envelope cut short is rejected
+    std::string msg = encodeText("example.Msg", 1, 0, 1, "{}");
+    for (size_t size = 0; size < msg.size(); ++size) {
+        pubsub_websocket_msg_header_t hdr{};
+        std::string data;
+        EXPECT_FALSE(parseText(msg.substr(0, size), &hdr, &data)) << "for size " << size;
+    }
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, BinaryMessageRoundTrip) {
+    ASSERT_NE(nullptr, protocol);
+    pubsub_protocol_message_t message{};
+    message.header.msgId = 1234;
+    message.header.msgMajorVersion = 2;
+    message.header.msgMinorVersion = 1;
+    message.header.seqNr = 99;
+    message.metadata.metadata = nullptr;
+    std::string part1 = "hello ";
+    std::string part2 = "world";
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)part1.data();
+    iov[0].iov_len = part1.size();
+    iov[1].iov_base = (void*)part2.data();
+    iov[1].iov_len = part2.size();
+
+    char* msg = nullptr;
+    size_t msgSize = 0;
+    ASSERT_EQ(CELIX_SUCCESS, psa_websocket_encodeBinaryMessage(protocol, &message, iov, 2, &msg, &msgSize));
+    EXPECT_EQ(11, message.header.payloadSize);
+    EXPECT_EQ(0, message.header.metadataSize);
+
+    pubsub_protocol_message_t decoded{};
+    const char* payload = nullptr;
+    ASSERT_TRUE(psa_websocket_decodeBinaryMessage(protocol, msg, msgSize, &decoded, &payload));
+    EXPECT_EQ(1234, decoded.header.msgId);
+    EXPECT_EQ(2, decoded.header.msgMajorVersion);
+    EXPECT_EQ(1, decoded.header.msgMinorVersion);
+    EXPECT_EQ(99, decoded.header.seqNr);
+    EXPECT_EQ(11, decoded.header.payloadSize);
+    EXPECT_EQ("hello world", std::string(payload, decoded.header.payloadSize));
+    EXPECT_EQ(nullptr, decoded.metadata.metadata);
+    free(msg);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, BinaryMessageWithMetadataRoundTrip) {
+    ASSERT_NE(nullptr, protocol);
+    pubsub_protocol_message_t message{};
+    message.header.msgId = 1;
+    message.metadata.metadata = celix_properties_create();
+    celix_properties_set(message.metadata.metadata, "key", "value");
+    std::string data = "payload";
+    struct iovec iov{};
+    iov.iov_base = (void*)data.data();
+    iov.iov_len = data.size();
+
+    char* msg = nullptr;
+    size_t msgSize = 0;
+    ASSERT_EQ(CELIX_SUCCESS, psa_websocket_encodeBinaryMessage(protocol, &message, &iov, 1, &msg, &msgSize));
+    EXPECT_GT(message.header.metadataSize, 0);
+    celix_properties_destroy(message.metadata.metadata);
+
+    pubsub_protocol_message_t decoded{};
+    const char* payload = nullptr;
+    ASSERT_TRUE(psa_websocket_decodeBinaryMessage(protocol, msg, msgSize, &decoded, &payload));
+    EXPECT_EQ("payload", std::string(payload, decoded.header.payloadSize));
+    ASSERT_NE(nullptr, decoded.metadata.metadata);
+    EXPECT_STREQ("value", celix_properties_get(decoded.metadata.metadata, "key", nullptr));
+    celix_properties_destroy(decoded.metadata.metadata);
+    free(msg);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, BinaryMessageWithEmptyPayload) {
+    ASSERT_NE(nullptr, protocol);
+    pubsub_protocol_message_t message{};
+    message.header.msgId = 1;
+    char* msg = nullptr;
+    size_t msgSize = 0;
+    ASSERT_EQ(CELIX_SUCCESS, psa_websocket_encodeBinaryMessage(protocol, &message, nullptr, 0, &msg, &msgSize));
+    EXPECT_EQ(0, message.header.payloadSize);
+
+    pubsub_protocol_message_t decoded{};
+    const char* payload = nullptr;
+    ASSERT_TRUE(psa_websocket_decodeBinaryMessage(protocol, msg, msgSize, &decoded, &payload));
+    EXPECT_EQ(0, decoded.header.payloadSize);
+    EXPECT_EQ(nullptr, decoded.metadata.metadata);
+    free(msg);
+}
+
+TEST_F(PubSubWebsocketCommonTestSuite, MalformedBinaryMessagesAreRejected) {
+    ASSERT_NE(nullptr, protocol);
+    pubsub_protocol_message_t decoded{};
+    const char* payload = nullptr;
+    EXPECT_FALSE(psa_websocket_decodeBinaryMessage(protocol, nullptr, 0, &decoded, &payload));
+    EXPECT_FALSE(psa_websocket_decodeBinaryMessage(protocol, "abc", 3, &decoded, &payload));
+
+    pubsub_protocol_message_t message{};
+    message.header.msgId = 1;
+    message.metadata.metadata = celix_properties_create();
+    celix_properties_set(message.metadata.metadata, "key", "value");
+    std::string data = "payload";
+    struct iovec iov{};
+    iov.iov_base = (void*)data.data();
+    iov.iov_len = data.size();
+    char* msg = nullptr;
+    size_t msgSize = 0;
+    ASSERT_EQ(CELIX_SUCCESS, psa_websocket_encodeBinaryMessage(protocol, &message, &iov, 1, &msg, &msgSize));
+    celix_properties_destroy(message.metadata.metadata);
+
+    //truncated
+    for (size_t size = 0; size < msgSize; ++size) {
+        EXPECT_FALSE(psa_websocket_decodeBinaryMessage(protocol, msg, size, &decoded, &payload)) << "for size " << size;
+        EXPECT_EQ(nullptr, decoded.metadata.metadata);
+    }
+
+    //trailing data
+    std::string longer{msg, msgSize};
+    longer += "x";
+    EXPECT_FALSE(psa_websocket_decodeBinaryMessage(protocol, longer.data(), longer.size(), &decoded, &payload));
+
+    //corrupted header sync word and footer
+    std::string corrupted{msg, msgSize};
+    corrupted[0] = (char)~corrupted[0];
+    EXPECT_FALSE(psa_websocket_decodeBinaryMessage(protocol, corrupted.data(), corrupted.size(), &decoded, &payload));
+    corrupted = std::string{msg, msgSize};
+    corrupted[msgSize - 1] = (char)~corrupted[msgSize - 1];
+    EXPECT_FALSE(psa_websocket_decodeBinaryMessage(protocol, corrupted.data(), corrupted.size(), &decoded, &payload));
+    EXPECT_EQ(nullptr, decoded.metadata.metadata);
+    free(msg);
+}
@@ -39,6 +39,21 @@
 #define PUBSUB_WEBSOCKET_ADDRESS_KEY                  "websocket.socket_address"
 #define PUBSUB_WEBSOCKET_PORT_KEY                     "websocket.socket_port"
 
+/**
+ * The framing used by a topic sender, configurable per topic (topic property) or for all topics (framework property).
+ * "text" (default) sends a JSON envelope with the id, major, minor, seqNr and data fields, which can be consumed by
+ * web pages. "binary" sends a binary websocket message with a wire v2 header, the serialized payload and the metadata.
+ * Topic receivers accept both framings.
+ * The JSON envelope embeds the serialized payload as is, so text framing is only used for topics with the json
+ * serializer; other serializers always use binary framing.
+ */
+#define PUBSUB_WEBSOCKET_FRAMING_KEY                  "websocket.framing"
+#define PSA_WEBSOCKET_FRAMING                         "PSA_WEBSOCKET_FRAMING"
+#define PSA_WEBSOCKET_FRAMING_TEXT                    "text"
+#define PSA_WEBSOCKET_FRAMING_BINARY                  "binary"
+#define PSA_WEBSOCKET_DEFAULT_FRAMING                 PSA_WEBSOCKET_FRAMING_TEXT
+#define PSA_WEBSOCKET_TEXT_FRAMING_SERIALIZER_TYPE    "json"
+
 /**
  * The static url which a subscriber should try to connect to.
  * The urls are space separated
@@ -17,9 +17,12 @@
  * under the License.
  */
 
+#include <stdlib.h>
 #include <memory.h>
 #include <assert.h>
 #include <stdio.h>
+#include <ctype.h>
+#include <jansson.h>
 #include "pubsub_websocket_common.h"
 
 bool psa_websocket_checkVersion(version_pt msgVersion, const pubsub_websocket_msg_header_t *hdr) {
@@ -66,3 +69,264 @@ char *psa_websocket_createURI(const char *scope, const char *topic) {
     }
     return uri;
 }
+
+static size_t psa_websocket_skipWhitespace(const char *msg, size_t msgSize, size_t idx) {
+    while (idx < msgSize && isspace((unsigned char) msg[idx])) {
+        idx++;
+    }
+    return idx;
+}
+
+/**
+ * Returns the index after the JSON value starting at idx. Objects and arrays are skipped by tracking the depth
+ * (outside of strings), the value is not validated. Returns msgSize if the value is not terminated.
+ */
+static size_t psa_websocket_skipValue(const char *msg, size_t msgSize, size_t idx) {
+    int depth = 0;
+    bool inString = false;
+    for (; idx < msgSize; ++idx) {
+        char c = msg[idx];
+        if (inString) {
+            if (c == '\\') {
+                idx++;
+            } else if (c == '"') {
+                inString = false;
+                if (depth == 0) {
+                    return idx + 1;
+                }
+            }
+        } else if (c == '"') {
+            inString = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                return idx; //end of a scalar value in the enclosing object
+            }
+            depth--;
+            if (depth == 0) {
+                return idx + 1;
+            }
+        } else if (depth == 0 && (c == ',' || isspace((unsigned char) c))) {
+            return idx;
+        }
+    }
+    return msgSize;
+}
+
+static bool psa_websocket_parseUnsigned(const char *value, size_t size, unsigned long *result) {
+    char buf[32];
+    if (size == 0 || size >= sizeof(buf) || !isdigit((unsigned char) value[0])) {
+        return false;
+    }
+    memcpy(buf, value, size);
+    buf[size] = '\0';
+    char *end = NULL;
+    *result = strtoul(buf, &end, 10);
+    return *end == '\0';
+}
+
+bool psa_websocket_parseTextEnvelope(const char *msg, size_t msgSize, pubsub_websocket_msg_header_t *hdr, char **id, const char **data, size_t *dataSize) {
+    unsigned long major = 0;
+    unsigned long minor = 0;
+    unsigned long seqNr = 0;
+    int found = 0; //bit set of the found envelope fields
+    *id = NULL;
+    *data = NULL;
+    *dataSize = 0;
+
+    size_t idx = psa_websocket_skipWhitespace(msg, msgSize, 0);
+    bool valid = idx < msgSize && msg[idx] == '{';
+    idx++;
+    while (valid) {
+        idx = psa_websocket_skipWhitespace(msg, msgSize, idx);
+        if (idx < msgSize && msg[idx] == '}' && found == 0) {
+            break; //empty object
+        }
+        //key
+        size_t keyEnd = idx < msgSize && msg[idx] == '"' ? psa_websocket_skipValue(msg, msgSize, idx) : idx;
+        if (keyEnd <= idx + 1 || keyEnd > msgSize || msg[keyEnd - 1] != '"') {
+            valid = false;
+            break;
+        }
+        const char *key = msg + idx + 1;
+        size_t keyLen = keyEnd - idx - 2;
+        idx = psa_websocket_skipWhitespace(msg, msgSize, keyEnd);
+        if (idx >= msgSize || msg[idx] != ':') {
+            valid = false;
+            break;
+        }
+        //value
+        size_t valueStart = psa_websocket_skipWhitespace(msg, msgSize, idx + 1);
+        size_t valueEnd = psa_websocket_skipValue(msg, msgSize, valueStart);
+        if (valueEnd <= valueStart) {
+            valid = false;
+            break;
+        }
+        const char *value = msg + valueStart;
+        size_t valueLen = valueEnd - valueStart;
+        if (keyLen == 2 && strncmp(key, "id", 2) == 0) {
+            if (valueLen < 2 || value[0] != '"' || value[valueLen - 1] != '"' || *id != NULL) {
+                valid = false;
+            } else if (memchr(value, '\\', valueLen) == NULL) {
+                *id = strndup(value + 1, valueLen - 2);
+            } else {
+                json_t *jsId = json_loadb(value, valueLen, JSON_DECODE_ANY, NULL);
+                *id = json_is_string(jsId) ? strdup(json_string_value(jsId)) : NULL;
+                json_decref(jsId);
+                valid = *id != NULL;
+            }
+            found |= 0x1;
+        } else if (keyLen == 5 && strncmp(key, "major", 5) == 0) {
+            valid = psa_websocket_parseUnsigned(value, valueLen, &major);
+            found |= 0x2;
+        } else if (keyLen == 5 && strncmp(key, "minor", 5) == 0) {
+            valid = psa_websocket_parseUnsigned(value, valueLen, &minor);
+            found |= 0x4;
+        } else if (keyLen == 5 && strncmp(key, "seqNr", 5) == 0) {
+            valid = psa_websocket_parseUnsigned(value, valueLen, &seqNr);
+            found |= 0x8;
+        } else if (keyLen == 4 && strncmp(key, "data", 4) == 0) {
+            *data = value;
+            *dataSize = valueLen;
+            found |= 0x10;
+        }
+        idx = psa_websocket_skipWhitespace(msg, msgSize, valueEnd);
+        if (valid && idx < msgSize && msg[idx] == ',') {
+            idx++;
+        } else if (valid && idx < msgSize && msg[idx] == '}') {
+            break;
+        } else {
+            valid = false;
+        }
+    }
+
+    valid = valid && found == 0x1F;
+    if (valid) {
+        hdr->id = *id;
+        hdr->major = (uint8_t) major;
+        hdr->minor = (uint8_t) minor;
+        hdr->seqNr = (uint32_t) seqNr;
+    } else {
+        free(*id);
+        *id = NULL;
+    }
+    return valid;
+}
+
+char* psa_websocket_createTextEnvelopePrefix(const char *fqn, uint8_t major, uint8_t minor, size_t *prefixLen) {
+    json_t *jsId = json_string(fqn);
+    char *id = json_dumps(jsId, JSON_ENCODE_ANY);
+    json_decref(jsId);
+    char *prefix = NULL;
+    int len = id == NULL ? -1 : asprintf(&prefix, "{\"id\":%s,\"major\":%u,\"minor\":%u,\"seqNr\":", id, major, minor);
+    free(id);
+    if (len < 0) {
+        *prefixLen = 0;
+        return NULL;
+    }
+    *prefixLen = (size_t) len;
+    return prefix;
+}
+
+celix_status_t psa_websocket_encodeTextMessage(const char *envelopePrefix, size_t envelopePrefixLen, uint32_t seqNr,
+                                               const struct iovec *payload, size_t payloadLen, char **msgOut, size_t *msgSizeOut) {
+    size_t payloadSize = 0;
+    for (size_t i = 0; i < payloadLen; ++i) {
+        payloadSize += payload[i].iov_len;
+    }
+    //prefix + seqNr + ,"data": + payload (or null) + }
+    size_t maxSize = envelopePrefixLen + 32 + payloadSize;
+    char *msg = malloc(maxSize);
+    if (msg == NULL) {
+        return CELIX_ENOMEM;
+    }
+    memcpy(msg, envelopePrefix, envelopePrefixLen);
+    size_t size = envelopePrefixLen;
+    size += (size_t) snprintf(msg + size, maxSize - size, "%u,\"data\":", seqNr);
+    for (size_t i = 0; i < payloadLen; ++i) {
+        memcpy(msg + size, payload[i].iov_base, payload[i].iov_len);
+        size += payload[i].iov_len;
+    }
+    if (payloadSize == 0) {
+        memcpy(msg + size, "null", 4);
+        size += 4;
+    }
+    msg[size++] = '}';
+    *msgOut = msg;
+    *msgSizeOut = size;
+    return CELIX_SUCCESS;
+}
+
+celix_status_t psa_websocket_encodeBinaryMessage(pubsub_protocol_wire_v2_t *protocol, pubsub_protocol_message_t *message,
+                                                 const struct iovec *payload, size_t payloadLen, char **msgOut, size_t *msgSizeOut) {
+    message->header.payloadSize = 0;
+    for (size_t i = 0; i < payloadLen; ++i) {
+        message->header.payloadSize += payload[i].iov_len;
+    }
+    message->header.payloadPartSize = message->header.payloadSize;
+    message->header.payloadOffset = 0;
+    message->header.isLastSegment = 1;
+
+    void *metadataData = NULL;
+    size_t metadataSize = 0;
+    if (message->metadata.metadata != NULL && celix_properties_size(message->metadata.metadata) > 0) {
+        pubsubProtocol_wire_v2_encodeMetadata(protocol, message, &metadataData, &metadataSize);
+    }
+    message->header.metadataSize = metadataSize;
+
+    size_t headerSize = 0;
+    size_t footerSize = 0;
+    pubsubProtocol_wire_v2_getHeaderSize(protocol, &headerSize);
+    pubsubProtocol_wire_v2_getFooterSize(protocol, &footerSize);
+    size_t size = headerSize + message->header.payloadSize + metadataSize + footerSize;
+    char *msg = malloc(size);
+    if (msg == NULL) {
+        free(metadataData);
+        return CELIX_ENOMEM;
+    }
+    void *header = msg;
+    pubsubProtocol_wire_v2_encodeHeader(protocol, message, &header, &headerSize);
+    size_t offset = headerSize;
+    for (size_t i = 0; i < payloadLen; ++i) {
+        memcpy(msg + offset, payload[i].iov_base, payload[i].iov_len);
+        offset += payload[i].iov_len;
+    }
+    if (metadataSize > 0) {
+        memcpy(msg + offset, metadataData, metadataSize);
+        offset += metadataSize;
+    }
+    free(metadataData);
+    void *footer = msg + offset;
+    pubsubProtocol_wire_v2_encodeFooter(protocol, message, &footer, &footerSize);
+    *msgOut = msg;
+    *msgSizeOut = size;
+    return CELIX_SUCCESS;
+}
+
+bool psa_websocket_decodeBinaryMessage(pubsub_protocol_wire_v2_t *protocol, const char *msg, size_t msgSize,
+                                       pubsub_protocol_message_t *message, const char **payload) {
+    size_t headerSize = 0;
+    size_t footerSize = 0;
+    pubsubProtocol_wire_v2_getHeaderSize(protocol, &headerSize);
+    pubsubProtocol_wire_v2_getFooterSize(protocol, &footerSize);
+
+    memset(message, 0, sizeof(*message));
+    bool valid = msg != NULL && msgSize >= headerSize + footerSize &&
+                 pubsubProtocol_wire_v2_decodeHeader(protocol, (void *)msg, headerSize, message) == CELIX_SUCCESS;
+    valid = valid && message->header.payloadPartSize == message->header.payloadSize &&
+            (size_t)message->header.payloadSize + message->header.metadataSize == msgSize - headerSize - footerSize;
+    valid = valid && pubsubProtocol_wire_v2_decodeFooter(protocol, (void *)(msg + msgSize - footerSize), footerSize, message) == CELIX_SUCCESS;
+    if (valid && message->header.metadataSize > 0) {
+        valid = pubsubProtocol_wire_v2_decodeMetadata(protocol, (void *)(msg + headerSize + message->header.payloadSize), message->header.metadataSize, message) == CELIX_SUCCESS;
+    }
+    if (!valid) {
+        if (message->metadata.metadata != NULL) {
+            celix_properties_destroy(message->metadata.metadata);
+            message->metadata.metadata = NULL;
+        }
+        return false;
+    }
+    *payload = msg + headerSize;
+    return true;
+}
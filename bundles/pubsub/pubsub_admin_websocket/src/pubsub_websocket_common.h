@@ -22,8 +22,15 @@
 
 #include <utils.h>
 #include <stdint.h>
+#include <sys/uio.h>
 
 #include "version.h"
+#include "celix_errno.h"
+#include "pubsub_wire_v2_protocol_impl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 
 struct pubsub_websocket_msg_header {
@@ -40,4 +47,47 @@ char *psa_websocket_createURI(const char *scope, const char *topic);
 
 bool psa_websocket_checkVersion(version_pt msgVersion, const pubsub_websocket_msg_header_t *hdr);
 
+/**
+ * Parses the envelope of a text websocket message: {"id":"<fqn>","major":1,"minor":0,"seqNr":1,"data":<payload>}.
+ * Only the envelope is scanned, the payload is returned as a span of msg, so that it can be deserialized directly
+ * without parsing it first. On success hdr->id points to the returned id, which should be freed by the caller.
+ * Returns false if msg is not a (complete) envelope.
+ */
+bool psa_websocket_parseTextEnvelope(const char *msg, size_t msgSize, pubsub_websocket_msg_header_t *hdr, char **id, const char **data, size_t *dataSize);
+
+/**
+ * Creates the start of the JSON envelope of a text websocket message, up to the seqNr value:
+ * {"id":"<fqn>","major":1,"minor":0,"seqNr":
+ * Returns NULL if the prefix cannot be created, the returned prefix should be freed by the caller.
+ */
+char* psa_websocket_createTextEnvelopePrefix(const char *fqn, uint8_t major, uint8_t minor, size_t *prefixLen);
+
+/**
+ * Encodes a text websocket message: the envelope prefix, the seqNr and the serialized (JSON) payload as data value.
+ * The payload is written into the envelope as is, an empty payload is written as null.
+ * Returns CELIX_ENOMEM if the message cannot be allocated, the returned message should be freed by the caller.
+ */
+celix_status_t psa_websocket_encodeTextMessage(const char *envelopePrefix, size_t envelopePrefixLen, uint32_t seqNr,
+                                               const struct iovec *payload, size_t payloadLen, char **msgOut, size_t *msgSizeOut);
+
+/**
+ * Encodes a binary websocket message: wire v2 header, payload, metadata (message->metadata.metadata, can be NULL)
+ * and footer. The payload and metadata sizes of message->header are set by this function.
+ * Returns CELIX_ENOMEM if the message cannot be allocated, the returned message should be freed by the caller.
+ */
+celix_status_t psa_websocket_encodeBinaryMessage(pubsub_protocol_wire_v2_t *protocol, pubsub_protocol_message_t *message,
+                                                 const struct iovec *payload, size_t payloadLen, char **msgOut, size_t *msgSizeOut);
+
+/**
+ * Decodes a binary websocket message. On success the payload points into msg and message->metadata.metadata is set
+ * if the message has metadata, which should be destroyed by the caller.
+ * Returns false if msg is not a (complete) binary message.
+ */
+bool psa_websocket_decodeBinaryMessage(pubsub_protocol_wire_v2_t *protocol, const char *msg, size_t msgSize,
+                                       pubsub_protocol_message_t *message, const char **payload);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif //CELIX_PUBSUB_WEBSOCKET_COMMON_H
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <pubsub/subscriber.h>
 #include <memory.h>
+#include <time.h>
 #include <pubsub_constants.h>
 #include <assert.h>
 #include <pubsub_endpoint.h>
@@ -30,6 +31,7 @@
 #include "pubsub_websocket_topic_receiver.h"
 #include "pubsub_psa_websocket_constants.h"
 #include "pubsub_websocket_common.h"
+#include "pubsub_wire_v2_protocol_impl.h"
 
 #include <uuid/uuid.h>
 #include <http_admin/api.h>
@@ -57,8 +59,10 @@ typedef struct pubsub_websocket_rcv_buffer {
 } pubsub_websocket_rcv_buffer_t;
 
 typedef struct pubsub_websocket_msg_entry {
+    bool binary; //true for a binary websocket message, false for a text message
     size_t msgSize;
     const char *msgData;
+    struct timespec receiveTime; //only set if metrics are enabled
 } pubsub_websocket_msg_entry_t;
 
 struct pubsub_websocket_topic_receiver {
@@ -75,6 +79,8 @@ struct pubsub_websocket_topic_receiver {
     long svcId;
 
     pubsub_websocket_rcv_buffer_t recvBuffer;
+    pubsub_protocol_wire_v2_t *protocol; //used to decode binary messages
+    pubsub_admin_metrics_receive_counters_t *metrics; //NULL if metrics are not enabled
 
     struct {
         celix_thread_t thread;
@@ -114,6 +120,18 @@ typedef struct psa_websocket_subscriber_entry {
     bool initialized; //true if the init function is called through the receive thread
 } psa_websocket_subscriber_entry_t;
 
+/**
+ * The deserialization outcome of a message over all subscriber entries, used for the metrics.
+ */
+typedef struct psa_websocket_msg_metrics {
+    const char *msgFqn; //NULL if no subscriber entry has a serializer for the msg type
+    unsigned int msgTypeId;
+    bool timed;
+    struct timespec deserializeStart;
+    struct timespec deserializeEnd;
+    bool failed;
+} psa_websocket_msg_metrics_t;
+
 
 static void pubsub_websocketTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
 static void pubsub_websocketTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
@@ -154,6 +172,10 @@ pubsub_websocket_topic_receiver_t* pubsub_websocketTopicReceiver_create(celix_bu
         receiver->subscribers.map = hashMap_create(NULL, NULL, NULL, NULL);
         receiver->requestedConnections.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
         arrayList_create(&receiver->recvBuffer.list);
+        pubsubProtocol_wire_v2_create(&receiver->protocol);
+        if (celix_bundleContext_getPropertyAsBool(ctx, PSA_WEBSOCKET_METRICS_ENABLED, PSA_WEBSOCKET_DEFAULT_METRICS_ENABLED)) {
+            receiver->metrics = pubsub_metricsReceiveCounters_create();
+        }
     }
 
     //track subscribers
@@ -307,6 +329,10 @@ void pubsub_websocketTopicReceiver_destroy(pubsub_websocket_topic_receiver_t *re
             msgBufSize--;
         }
         celix_arrayList_destroy(receiver->recvBuffer.list);
+        pubsubProtocol_wire_v2_destroy(receiver->protocol);
+        if (receiver->metrics != NULL) {
+            pubsub_metricsReceiveCounters_destroy(receiver->metrics);
+        }
 
         free(receiver->uri);
         free(receiver->scope);
@@ -480,92 +506,148 @@ static void * psa_websocket_getMsgTypeIdFromFqn(const char *fqn, hash_map_t *msg
     return msgTypeId;
 }
 
-static inline void processMsgForSubscriberEntry(pubsub_websocket_topic_receiver_t *receiver, psa_websocket_subscriber_entry_t* entry, pubsub_websocket_msg_header_t *hdr, const char* payload, size_t payloadSize) {
+static inline void processMsgForSubscriberEntry(pubsub_websocket_topic_receiver_t *receiver, psa_websocket_subscriber_entry_t* entry, pubsub_msg_serializer_t *msgSer, const char* payload, size_t payloadSize, celix_properties_t *metadata, psa_websocket_msg_metrics_t *msgMetrics) {
     //NOTE receiver->subscribers.mutex locked
-    void *msgTypeId = psa_websocket_getMsgTypeIdFromFqn(hdr->id, entry->msgTypes);
-    pubsub_msg_serializer_t* msgSer = hashMap_get(entry->msgTypes, msgTypeId);
-
-    if (msgSer!= NULL && msgTypeId != 0) {
-        void *deSerializedMsg = NULL;
-        bool validVersion = psa_websocket_checkVersion(msgSer->msgVersion, hdr);
-        if (validVersion) {
-            struct iovec deSerializeBuffer;
-            deSerializeBuffer.iov_base = (void *)payload;
-            deSerializeBuffer.iov_len  = payloadSize;
-            celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &deSerializedMsg);
-
-            if (status == CELIX_SUCCESS) {
-                hash_map_iterator_t iter = hashMapIterator_construct(entry->subscriberServices);
-                bool release = true;
-                while (hashMapIterator_hasNext(&iter)) {
-                    pubsub_subscriber_t *svc = hashMapIterator_nextValue(&iter);
-                    svc->receive(svc->handle, msgSer->msgName, msgSer->msgId, deSerializedMsg, NULL, &release);
-                    if (!release && hashMapIterator_hasNext(&iter)) {
-                        //receive function has taken ownership and still more receive function to come ..
-                        //deserialize again for new message
-                        status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &deSerializedMsg);
-                        if (status != CELIX_SUCCESS) {
-                            L_WARN("[PSA_WEBSOCKET_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
-                            break;
-                        }
-                        release = true;
-                    }
-                }
-                if (release) {
-                    msgSer->freeDeserializeMsg(msgSer->handle, deSerializedMsg);
+    //note only the first deserialization of a message is timed
+    bool monitor = receiver->metrics != NULL && !msgMetrics->timed;
+    msgMetrics->msgFqn = msgSer->msgName;
+    msgMetrics->msgTypeId = msgSer->msgId;
+    void *deSerializedMsg = NULL;
+    struct iovec deSerializeBuffer;
+    deSerializeBuffer.iov_base = (void *)payload;
+    deSerializeBuffer.iov_len  = payloadSize;
+    if (monitor) {
+        clock_gettime(CLOCK_REALTIME, &msgMetrics->deserializeStart);
+    }
+    celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &deSerializedMsg);
+    if (monitor) {
+        clock_gettime(CLOCK_REALTIME, &msgMetrics->deserializeEnd);
+        msgMetrics->timed = true;
+    }
+    if (status != CELIX_SUCCESS) {
+        msgMetrics->failed = true;
+    }
+
+    if (status == CELIX_SUCCESS) {
+        hash_map_iterator_t iter = hashMapIterator_construct(entry->subscriberServices);
+        bool release = true;
+        while (hashMapIterator_hasNext(&iter)) {
+            pubsub_subscriber_t *svc = hashMapIterator_nextValue(&iter);
+            svc->receive(svc->handle, msgSer->msgName, msgSer->msgId, deSerializedMsg, metadata, &release);
+            if (!release && hashMapIterator_hasNext(&iter)) {
+                //receive function has taken ownership and still more receive function to come ..
+                //deserialize again for new message
+                status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &deSerializedMsg);
+                if (status != CELIX_SUCCESS) {
+                    L_WARN("[PSA_WEBSOCKET_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+                    break;
                 }
-            } else {
-                L_WARN("[PSA_WEBSOCKET_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+                release = true;
             }
         }
+        if (release) {
+            msgSer->freeDeserializeMsg(msgSer->handle, deSerializedMsg);
+        }
     } else {
-        L_WARN("[PSA_WEBSOCKET_TR] Cannot find serializer for type id 0x%X, fqn %s", msgTypeId, hdr->id);
+        L_WARN("[PSA_WEBSOCKET_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
     }
 }
 
-static inline void processMsg(pubsub_websocket_topic_receiver_t *receiver, const char *msg, size_t msgSize) {
-    json_error_t error;
-    json_t *jsMsg = json_loadb(msg, msgSize, 0, &error);
-    if(jsMsg != NULL) {
-        json_t *jsId = json_object_get(jsMsg, "id");
-        json_t *jsMajor = json_object_get(jsMsg, "major");
-        json_t *jsMinor = json_object_get(jsMsg, "minor");
-        json_t *jsSeqNr = json_object_get(jsMsg, "seqNr");
-        json_t *jsData = json_object_get(jsMsg, "data");
-
-        if (jsId && jsMajor && jsMinor && jsSeqNr && jsData) {
-            pubsub_websocket_msg_header_t hdr;
-            hdr.id = json_string_value(jsId);
-            hdr.major = (uint8_t) json_integer_value(jsMajor);
-            hdr.minor = (uint8_t) json_integer_value(jsMinor);
-            hdr.seqNr = (uint32_t) json_integer_value(jsSeqNr);
-            const char *payload = json_dumps(jsData, 0);
-            size_t payloadSize = strlen(payload);
-            printf("Received msg: id %s\tmajor %u\tminor %u\tseqNr %u\tdata %s\n", hdr.id, hdr.major, hdr.minor, hdr.seqNr, payload);
-
-            celixThreadMutex_lock(&receiver->subscribers.mutex);
-            hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
-            while (hashMapIterator_hasNext(&iter)) {
-                psa_websocket_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
-                if (entry != NULL) {
-                    processMsgForSubscriberEntry(receiver, entry, &hdr, payload, payloadSize);
+/**
+ * Processes a text message: a JSON envelope with the id, major, minor, seqNr and (serialized) data.
+ * The data is handed to the serializer as is, so the message is only parsed once (by the serializer).
+ */
+/**
+ * Updates the receive metrics for a processed message.
+ * Note receiver->subscribers.mutex should be locked, the msgFqn points to a serializer name.
+ */
+static inline void updateReceiveMetrics(pubsub_websocket_topic_receiver_t *receiver, const psa_websocket_msg_metrics_t *msgMetrics, const celix_properties_t *metadata, unsigned int seqNr, const struct timespec *receiveTime) {
+    if (receiver->metrics != NULL && msgMetrics->msgFqn != NULL) {
+        const char *origin = NULL;
+        int64_t sendTimeInNs = 0;
+        pubsub_metrics_getSendMetadata(metadata, &origin, &sendTimeInNs);
+        pubsub_metricsReceiveCounters_update(receiver->metrics, msgMetrics->msgTypeId, msgMetrics->msgFqn, origin, sendTimeInNs, &seqNr, receiveTime,
+                                             msgMetrics->timed ? &msgMetrics->deserializeStart : NULL,
+                                             msgMetrics->timed ? &msgMetrics->deserializeEnd : NULL,
+                                             msgMetrics->failed ? 0 : 1, msgMetrics->failed ? 1 : 0);
+    }
+}
+
+static inline void processTextMsg(pubsub_websocket_topic_receiver_t *receiver, const char *msg, size_t msgSize, const struct timespec *receiveTime) {
+    pubsub_websocket_msg_header_t hdr;
+    char *id = NULL;
+    const char *payload = NULL;
+    size_t payloadSize = 0;
+    if (!psa_websocket_parseTextEnvelope(msg, msgSize, &hdr, &id, &payload, &payloadSize)) {
+        L_WARN("[PSA_WEBSOCKET_TR] Received unsupported message for scope/topic %s/%s, expected a JSON object with id, major, minor, seqNr and data",
+               receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
+        return;
+    }
+
+    psa_websocket_msg_metrics_t msgMetrics;
+    memset(&msgMetrics, 0, sizeof(msgMetrics));
+    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_websocket_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+        if (entry != NULL) {
+            void *msgTypeId = psa_websocket_getMsgTypeIdFromFqn(hdr.id, entry->msgTypes);
+            pubsub_msg_serializer_t* msgSer = hashMap_get(entry->msgTypes, msgTypeId);
+            if (msgSer != NULL && msgTypeId != 0) {
+                if (psa_websocket_checkVersion(msgSer->msgVersion, &hdr)) {
+                    processMsgForSubscriberEntry(receiver, entry, msgSer, payload, payloadSize, NULL, &msgMetrics);
                 }
+            } else {
+                L_WARN("[PSA_WEBSOCKET_TR] Cannot find serializer for type id 0x%X, fqn %s", msgTypeId, hdr.id);
             }
-            celixThreadMutex_unlock(&receiver->subscribers.mutex);
-            free((void *) payload);
-        } else {
-            L_WARN("[PSA_WEBSOCKET_TR] Received unsupported message: "
-                   "ID = %s, major = %d, minor = %d, seqNr = %d, data valid? %s",
-                   (jsId ? json_string_value(jsId) : "ERROR"),
-                   json_integer_value(jsMajor), json_integer_value(jsMinor),
-                   json_integer_value(jsSeqNr), (jsData ? "TRUE" : "FALSE"));
         }
-        json_decref(jsMsg);
-    } else {
-        L_WARN("[PSA_WEBSOCKET_TR] Failed to load websocket JSON message, error line: %d, error message: %s", error.line, error.text);
+    }
+    updateReceiveMetrics(receiver, &msgMetrics, NULL, hdr.seqNr, receiveTime);
+    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    free(id);
+}
+
+/**
+ * Processes a binary message: wire v2 header, payload, metadata and footer.
+ */
+static inline void processBinaryMsg(pubsub_websocket_topic_receiver_t *receiver, const char *msg, size_t msgSize, const struct timespec *receiveTime) {
+    pubsub_protocol_message_t message;
+    const char *payload = NULL;
+    if (!psa_websocket_decodeBinaryMessage(receiver->protocol, msg, msgSize, &message, &payload)) {
+        L_WARN("[PSA_WEBSOCKET_TR] Received invalid binary message of %lu bytes for scope/topic %s/%s",
+               msgSize, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
         return;
     }
 
+    pubsub_websocket_msg_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.major = (uint8_t)message.header.msgMajorVersion;
+    hdr.minor = (uint8_t)message.header.msgMinorVersion;
+    hdr.seqNr = message.header.seqNr;
+
+    psa_websocket_msg_metrics_t msgMetrics;
+    memset(&msgMetrics, 0, sizeof(msgMetrics));
+    celixThreadMutex_lock(&receiver->subscribers.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_websocket_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+        if (entry != NULL) {
+            pubsub_msg_serializer_t* msgSer = hashMap_get(entry->msgTypes, (void *)(uintptr_t)message.header.msgId);
+            if (msgSer != NULL) {
+                if (psa_websocket_checkVersion(msgSer->msgVersion, &hdr)) {
+                    processMsgForSubscriberEntry(receiver, entry, msgSer, payload, message.header.payloadSize, message.metadata.metadata, &msgMetrics);
+                }
+            } else {
+                L_WARN("[PSA_WEBSOCKET_TR] Cannot find serializer for type id 0x%X", message.header.msgId);
+            }
+        }
+    }
+    updateReceiveMetrics(receiver, &msgMetrics, message.metadata.metadata, message.header.seqNr, receiveTime);
+    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+
+    if (message.metadata.metadata != NULL) {
+        celix_properties_destroy(message.metadata.metadata);
+    }
 }
 
 static void* psa_websocket_recvThread(void * data) {
@@ -598,7 +680,11 @@ static void* psa_websocket_recvThread(void * data) {
             celix_arrayList_removeAt(receiver->recvBuffer.list, 0);
             celixThreadMutex_unlock(&receiver->recvBuffer.mutex);
 
-            processMsg(receiver, msg->msgData, msg->msgSize);
+            if (msg->binary) {
+                processBinaryMsg(receiver, msg->msgData, msg->msgSize, &msg->receiveTime);
+            } else {
+                processTextMsg(receiver, msg->msgData, msg->msgSize, &msg->receiveTime);
+            }
             free((void *)msg->msgData);
             free(msg);
         }
@@ -653,20 +739,26 @@ static void psa_websocketTopicReceiver_ready(struct mg_connection *connection, v
 
 
 static int psa_websocketTopicReceiver_data(struct mg_connection *connection __attribute__((unused)),
-                                            int op_code __attribute__((unused)),
+                                            int op_code,
                                             char *data,
                                             size_t length,
                                             void *handle) {
     //Received a websocket message, append this message to the buffer of the receiver.
-    if (handle != NULL) {
+    //Note the op code contains the raw websocket frame bits (FIN bit + opcode), control frames are ignored.
+    int opcode = op_code & 0xf;
+    if (handle != NULL && (opcode == MG_WEBSOCKET_OPCODE_TEXT || opcode == MG_WEBSOCKET_OPCODE_BINARY)) {
         pubsub_websocket_topic_receiver_t *receiver = (pubsub_websocket_topic_receiver_t *) handle;
 
         celixThreadMutex_lock(&receiver->recvBuffer.mutex);
         pubsub_websocket_msg_entry_t *msg = malloc(sizeof(*msg));
         const char *rcvdMsgData = malloc(length);
         memcpy((void *) rcvdMsgData, data, length);
+        msg->binary = opcode == MG_WEBSOCKET_OPCODE_BINARY;
         msg->msgData = rcvdMsgData;
         msg->msgSize = length;
+        if (receiver->metrics != NULL) {
+            clock_gettime(CLOCK_REALTIME, &msg->receiveTime);
+        }
         celix_arrayList_add(receiver->recvBuffer.list, msg);
         celixThreadMutex_unlock(&receiver->recvBuffer.mutex);
     }
@@ -773,3 +865,20 @@ static void psa_websocket_initializeAllSubscribers(pubsub_websocket_topic_receiv
     }
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
+
+pubsub_admin_receiver_metrics_t* pubsub_websocketTopicReceiver_metrics(pubsub_websocket_topic_receiver_t *receiver) {
+    if (receiver->metrics == NULL) {
+        return NULL;
+    }
+    pubsub_admin_receiver_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : receiver->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
+    celixThreadMutex_lock(&receiver->recvBuffer.mutex);
+    result->nrOfQueuedMessages = (unsigned long)celix_arrayList_size(receiver->recvBuffer.list);
+    celixThreadMutex_unlock(&receiver->recvBuffer.mutex);
+    pubsub_metricsReceiveCounters_fill(receiver->metrics, result);
+    return result;
+}
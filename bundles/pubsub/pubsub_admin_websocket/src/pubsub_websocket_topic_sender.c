@@ -20,7 +20,9 @@
 #include <pubsub_serializer.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <time.h>
 #include <pubsub_constants.h>
+#include <pubsub_endpoint.h>
 #include <pubsub/publisher.h>
 #include <utils.h>
 #include <zconf.h>
@@ -28,8 +30,8 @@
 #include "pubsub_websocket_topic_sender.h"
 #include "pubsub_psa_websocket_constants.h"
 #include "pubsub_websocket_common.h"
+#include "pubsub_wire_v2_protocol_impl.h"
 #include <uuid/uuid.h>
-#include <jansson.h>
 #include "celix_constants.h"
 #include "http_admin/api.h"
 #include "civetweb.h"
@@ -55,11 +57,16 @@ struct pubsub_websocket_topic_sender {
     char *topic;
     char scopeAndTopicFilter[5];
     char *uri;
+    const char *fwUUID;
+    bool metricsEnabled;
 
     celix_websocket_service_t websockSvc;
     long websockSvcId;
     struct mg_connection *sockConnection;
 
+    bool binaryFraming; //true -> binary websocket messages with a wire v2 header, false -> JSON envelope
+    pubsub_protocol_wire_v2_t *protocol;
+
     struct {
         long svcId;
         celix_service_factory_t factory;
@@ -73,8 +80,11 @@ struct pubsub_websocket_topic_sender {
 
 typedef struct psa_websocket_send_msg_entry {
     pubsub_websocket_msg_header_t header; //partially filled header (only seqnr and time needs to be updated per send)
+    char *envelopePrefix; //start of the JSON envelope for text framing, up to the seqNr value
+    size_t envelopePrefixLen;
     pubsub_msg_serializer_t *msgSer;
     celix_thread_mutex_t sendLock; //protects send & header(.seqNr)
+    pubsub_admin_metrics_send_counters_t metrics; //only initialized if metrics are enabled
 } psa_websocket_send_msg_entry_t;
 
 typedef struct psa_websocket_bounded_service_entry {
@@ -91,8 +101,10 @@ static int psa_websocket_localMsgTypeIdForMsgType(void* handle __attribute__((un
 static void* psa_websocket_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
 static void psa_websocket_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
 static void delay_first_send_for_late_joiners(pubsub_websocket_topic_sender_t *sender);
+static void psa_websocket_destroySendMsgEntry(pubsub_websocket_topic_sender_t *sender, psa_websocket_send_msg_entry_t *msgEntry);
 
 static int psa_websocket_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *msg, celix_properties_t *metadata);
+static int psa_websocket_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
 
 static void psa_websocketTopicSender_ready(struct mg_connection *connection, void *handle);
 static void psa_websocketTopicSender_close(const struct mg_connection *connection, void *handle);
@@ -102,13 +114,31 @@ pubsub_websocket_topic_sender_t* pubsub_websocketTopicSender_create(
         celix_log_helper_t *logHelper,
         const char *scope,
         const char *topic,
+        const celix_properties_t *topicProperties,
         long serializerSvcId,
+        const char *serType,
         pubsub_serializer_service_t *ser) {
     pubsub_websocket_topic_sender_t *sender = calloc(1, sizeof(*sender));
     sender->ctx = ctx;
     sender->logHelper = logHelper;
     sender->serializerSvcId = serializerSvcId;
     sender->serializer = ser;
+    sender->fwUUID = celix_bundleContext_getProperty(ctx, OSGI_FRAMEWORK_FRAMEWORK_UUID, "");
+    sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_WEBSOCKET_METRICS_ENABLED, PSA_WEBSOCKET_DEFAULT_METRICS_ENABLED);
+    const char *framing = celix_bundleContext_getProperty(ctx, PSA_WEBSOCKET_FRAMING, PSA_WEBSOCKET_DEFAULT_FRAMING);
+    if (topicProperties != NULL) {
+        framing = celix_properties_get(topicProperties, PUBSUB_WEBSOCKET_FRAMING_KEY, framing);
+    }
+    sender->binaryFraming = strcmp(framing, PSA_WEBSOCKET_FRAMING_BINARY) == 0;
+    if (!sender->binaryFraming && (serType == NULL || strcmp(serType, PSA_WEBSOCKET_TEXT_FRAMING_SERIALIZER_TYPE) != 0)) {
+        //the JSON envelope can only embed JSON payloads
+        L_WARN("[PSA_WEBSOCKET_TS] Serializer %s does not produce JSON, using binary framing for scope/topic %s/%s",
+               serType == NULL ? "(null)" : serType, scope == NULL ? "(null)" : scope, topic);
+        sender->binaryFraming = true;
+    }
+    if (sender->binaryFraming) {
+        pubsubProtocol_wire_v2_create(&sender->protocol);
+    }
     psa_websocket_setScopeAndTopicFilter(scope, topic, sender->scopeAndTopicFilter);
     sender->uri = psa_websocket_createURI(scope, topic);
 
@@ -155,6 +185,7 @@ pubsub_websocket_topic_sender_t* pubsub_websocketTopicSender_create(
     }
 
     if (sender->websockSvcId < 0) {
+        pubsubProtocol_wire_v2_destroy(sender->protocol);
         free(sender);
         sender = NULL;
     }
@@ -176,8 +207,7 @@ void pubsub_websocketTopicSender_destroy(pubsub_websocket_topic_sender_t *sender
                 hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgEntries);
                 while (hashMapIterator_hasNext(&iter2)) {
                     psa_websocket_send_msg_entry_t *msgEntry = hashMapIterator_nextValue(&iter2);
-                    free(msgEntry);
-
+                    psa_websocket_destroySendMsgEntry(sender, msgEntry);
                 }
                 hashMap_destroy(entry->msgEntries, false, false);
 
@@ -196,6 +226,7 @@ void pubsub_websocketTopicSender_destroy(pubsub_websocket_topic_sender_t *sender
         }
         free(sender->topic);
         free(sender->uri);
+        pubsubProtocol_wire_v2_destroy(sender->protocol);
         free(sender);
     }
 }
@@ -253,12 +284,19 @@ static void* psa_websocket_getPublisherService(void *handle, const celix_bundle_
                 version_getMinor(sendEntry->msgSer->msgVersion, &minor);
                 sendEntry->header.major = (uint8_t)major;
                 sendEntry->header.minor = (uint8_t)minor;
+                sendEntry->envelopePrefix = psa_websocket_createTextEnvelopePrefix(sendEntry->header.id, sendEntry->header.major,
+                                                                                   sendEntry->header.minor, &sendEntry->envelopePrefixLen);
+                celixThreadMutex_create(&sendEntry->sendLock, NULL);
+                if (sender->metricsEnabled) {
+                    pubsub_metricsSendCounters_init(&sendEntry->metrics);
+                }
                 hashMap_put(entry->msgEntries, key, sendEntry);
                 hashMap_put(entry->msgTypeIds, strndup(sendEntry->msgSer->msgName, 1024), (void *)(uintptr_t) sendEntry->msgSer->msgId);
             }
             entry->service.handle = entry;
             entry->service.localMsgTypeIdForMsgType = psa_websocket_localMsgTypeIdForMsgType;
             entry->service.send = psa_websocket_topicPublicationSend;
+            entry->service.sendMany = psa_websocket_topicPublicationSendMany;
             hashMap_put(sender->boundedServices.map, (void*)bndId, entry);
         } else {
             L_ERROR("Error creating serializer map for websocket TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
@@ -289,7 +327,7 @@ static void psa_websocket_ungetPublisherService(void *handle, const celix_bundle
         hash_map_iterator_t iter = hashMapIterator_construct(entry->msgEntries);
         while (hashMapIterator_hasNext(&iter)) {
             psa_websocket_send_msg_entry_t *msgEntry = hashMapIterator_nextValue(&iter);
-            free(msgEntry);
+            psa_websocket_destroySendMsgEntry(sender, msgEntry);
         }
         hashMap_destroy(entry->msgEntries, false, false);
 
@@ -299,6 +337,85 @@ static void psa_websocket_ungetPublisherService(void *handle, const celix_bundle
     celixThreadMutex_unlock(&sender->boundedServices.mutex);
 }
 
+static void psa_websocket_destroySendMsgEntry(pubsub_websocket_topic_sender_t *sender, psa_websocket_send_msg_entry_t *msgEntry) {
+    if (sender->metricsEnabled) {
+        pubsub_metricsSendCounters_deinit(&msgEntry->metrics);
+    }
+    celixThreadMutex_destroy(&msgEntry->sendLock);
+    free(msgEntry->envelopePrefix);
+    free(msgEntry);
+}
+
+/**
+ * Sends the message in a JSON envelope. The serialized (JSON) payload is written into the envelope as is, an empty
+ * payload is written as null.
+ */
+static celix_status_t psa_websocket_sendText(pubsub_websocket_topic_sender_t *sender, psa_websocket_send_msg_entry_t *entry,
+                                             const struct iovec *serializedOutput, size_t serializedOutputLen) {
+    if (entry->envelopePrefix == NULL) {
+        L_ERROR("[PSA_WEBSOCKET_TS] No JSON envelope for message %s", entry->header.id);
+        return CELIX_ENOMEM;
+    }
+    char *msg = NULL;
+    size_t size = 0;
+    celixThreadMutex_lock(&entry->sendLock);
+    celix_status_t status = psa_websocket_encodeTextMessage(entry->envelopePrefix, entry->envelopePrefixLen, entry->header.seqNr,
+                                                            serializedOutput, serializedOutputLen, &msg, &size);
+    int bytes_written = 0;
+    if (status == CELIX_SUCCESS) {
+        entry->header.seqNr++;
+        bytes_written = mg_websocket_write(sender->sockConnection, MG_WEBSOCKET_OPCODE_TEXT, msg, size);
+    }
+    celixThreadMutex_unlock(&entry->sendLock);
+
+    if (status != CELIX_SUCCESS) {
+        L_ERROR("[PSA_WEBSOCKET_TS] Cannot allocate websocket text message for %s", entry->header.id);
+        return status;
+    }
+    free(msg);
+    if (bytes_written != (int) size) {
+        L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, written %d of total %lu bytes", bytes_written, size);
+        return CELIX_ILLEGAL_STATE;
+    }
+    return CELIX_SUCCESS;
+}
+
+/**
+ * Sends the message as binary websocket message: wire v2 header, payload, metadata and footer.
+ */
+static celix_status_t psa_websocket_sendBinary(pubsub_websocket_topic_sender_t *sender, psa_websocket_send_msg_entry_t *entry,
+                                               const struct iovec *serializedOutput, size_t serializedOutputLen, celix_properties_t *metadata) {
+    pubsub_protocol_message_t message;
+    memset(&message, 0, sizeof(message));
+    message.header.msgId = entry->msgSer->msgId;
+    message.header.msgMajorVersion = entry->header.major;
+    message.header.msgMinorVersion = entry->header.minor;
+    message.metadata.metadata = metadata;
+
+    char *msg = NULL;
+    size_t size = 0;
+    celixThreadMutex_lock(&entry->sendLock);
+    message.header.seqNr = entry->header.seqNr;
+    celix_status_t status = psa_websocket_encodeBinaryMessage(sender->protocol, &message, serializedOutput, serializedOutputLen, &msg, &size);
+    int bytes_written = 0;
+    if (status == CELIX_SUCCESS) {
+        entry->header.seqNr++;
+        bytes_written = mg_websocket_write(sender->sockConnection, MG_WEBSOCKET_OPCODE_BINARY, msg, size);
+    }
+    celixThreadMutex_unlock(&entry->sendLock);
+
+    if (status != CELIX_SUCCESS) {
+        L_ERROR("[PSA_WEBSOCKET_TS] Cannot allocate websocket binary message for %s", entry->header.id);
+        return status;
+    }
+    free(msg);
+    if (bytes_written != (int) size) {
+        L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, written %d of total %lu bytes", bytes_written, size);
+        return CELIX_ILLEGAL_STATE;
+    }
+    return CELIX_SUCCESS;
+}
+
 static int psa_websocket_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
     int status = CELIX_SERVICE_EXCEPTION;
     psa_websocket_bounded_service_entry_t *bound = handle;
@@ -307,46 +424,40 @@ static int psa_websocket_topicPublicationSend(void* handle, unsigned int msgType
 
     if (sender->sockConnection != NULL && entry != NULL) {
         delay_first_send_for_late_joiners(sender);
+        bool monitor = sender->metricsEnabled;
+        struct timespec serializationStart;
+        struct timespec serializationEnd;
+        if (monitor) {
+            clock_gettime(CLOCK_REALTIME, &serializationStart);
+        }
         size_t serializedOutputLen = 0;
         struct iovec* serializedOutput = NULL;
         status = entry->msgSer->serialize(entry->msgSer->handle, inMsg, &serializedOutput, &serializedOutputLen);
+        if (monitor) {
+            clock_gettime(CLOCK_REALTIME, &serializationEnd);
+        }
 
         if (status == CELIX_SUCCESS /*ser ok*/) {
-            json_error_t jsError;
-            unsigned char *hdrEncoded = calloc(sizeof(pubsub_websocket_msg_header_t), sizeof(unsigned char));
-
-            celixThreadMutex_lock(&entry->sendLock);
-
-            json_t *jsMsg = json_object();
-            json_object_set_new_nocheck(jsMsg, "id", json_string(entry->header.id));
-            json_object_set_new_nocheck(jsMsg, "major", json_integer(entry->header.major));
-            json_object_set_new_nocheck(jsMsg, "minor", json_integer(entry->header.minor));
-            json_object_set_new_nocheck(jsMsg, "seqNr", json_integer(entry->header.seqNr++));
-
-            json_t *jsData;
-            jsData = json_loadb((const char *)serializedOutput->iov_base, serializedOutput->iov_len, 0, &jsError);
-            if(jsData != NULL) {
-                json_object_set_new_nocheck(jsMsg, "data", jsData);
-                const char *msg = json_dumps(jsMsg, 0);
-                size_t bytes_to_write = strlen(msg);
-                int bytes_written = mg_websocket_write(sender->sockConnection, MG_WEBSOCKET_OPCODE_TEXT, msg,
-                                                              bytes_to_write);
-                free((void *) msg);
-                json_decref(jsData); //Decrease ref count means freeing the object
-                if (bytes_written != (int) bytes_to_write) {
-                    L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, written %d of total %lu bytes", bytes_written, bytes_to_write);
+            if (sender->binaryFraming) {
+                //note the JSON envelope of the text framing has no metadata, so the origin and delay are only known for binary framing
+                if (monitor) {
+                    metadata = pubsub_metrics_addSendMetadata(metadata, sender->fwUUID, &serializationStart);
                 }
+                status = psa_websocket_sendBinary(sender, entry, serializedOutput, serializedOutputLen, metadata);
             } else {
-                L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, serialized data corrupt. Error(%d;%d;%d): %s", jsError.column, jsError.line, jsError.position, jsError.text);
+                status = psa_websocket_sendText(sender, entry, serializedOutput, serializedOutputLen);
             }
-            celixThreadMutex_unlock(&entry->sendLock);
-
-            json_decref(jsMsg); //Decrease ref count means freeing the object
-            free(hdrEncoded);
             entry->msgSer->freeSerializeMsg(entry->msgSer->handle, serializedOutput, serializedOutputLen);
+            if (monitor) {
+                bool sendOk = status == CELIX_SUCCESS;
+                pubsub_metricsSendCounters_update(&entry->metrics, &serializationStart, &serializationEnd, sendOk ? 1 : 0, sendOk ? 0 : 1, 0);
+            }
         } else {
             L_WARN("[PSA_WEBSOCKET_TS] Error serialize message of type %s for scope/topic %s/%s",
                    entry->msgSer->msgName, sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+            if (monitor) {
+                pubsub_metricsSendCounters_update(&entry->metrics, &serializationStart, &serializationEnd, 0, 0, 1);
+            }
         }
     } else if (entry == NULL){
         L_WARN("[PSA_WEBSOCKET_TS] Error sending message with msg type id %i for scope/topic %s/%s", msgTypeId, sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
@@ -354,6 +465,20 @@ static int psa_websocket_topicPublicationSend(void* handle, unsigned int msgType
     	status = CELIX_SUCCESS; // Not an error, just nothing to do
     }
 
+    if (metadata != NULL) {
+        celix_properties_destroy(metadata);
+    }
+    return status;
+}
+
+static int psa_websocket_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    int status = CELIX_SUCCESS;
+    for (size_t i = 0; i < nrOfMsgs; ++i) {
+        int rc = psa_websocket_topicPublicationSend(handle, msgs[i].msgTypeId, msgs[i].msg, msgs[i].metadata);
+        if (status == CELIX_SUCCESS) {
+            status = rc;
+        }
+    }
     return status;
 }
 
@@ -379,3 +504,41 @@ static void delay_first_send_for_late_joiners(pubsub_websocket_topic_sender_t *s
         firstSend = false;
     }
 }
+
+pubsub_admin_sender_metrics_t* pubsub_websocketTopicSender_metrics(pubsub_websocket_topic_sender_t *sender) {
+    if (!sender->metricsEnabled) {
+        return NULL;
+    }
+    pubsub_admin_sender_metrics_t *result = calloc(1, sizeof(*result));
+    if (result == NULL) {
+        return NULL;
+    }
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : sender->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->topic);
+
+    celixThreadMutex_lock(&sender->boundedServices.mutex);
+    unsigned int count = 0;
+    hash_map_iterator_t iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        psa_websocket_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        count += (unsigned int)hashMap_size(entry->msgEntries);
+    }
+    result->msgMetrics = calloc(count, sizeof(*result->msgMetrics));
+    unsigned int i = 0;
+    iter = hashMapIterator_construct(sender->boundedServices.map);
+    while (hashMapIterator_hasNext(&iter) && result->msgMetrics != NULL) {
+        psa_websocket_bounded_service_entry_t *entry = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgEntries);
+        while (hashMapIterator_hasNext(&iter2)) {
+            psa_websocket_send_msg_entry_t *sendEntry = hashMapIterator_nextValue(&iter2);
+            pubsub_metricsSendCounters_fill(&sendEntry->metrics, &result->msgMetrics[i]);
+            result->msgMetrics[i].bndId = entry->bndId;
+            result->msgMetrics[i].typeId = sendEntry->msgSer->msgId;
+            snprintf(result->msgMetrics[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sendEntry->msgSer->msgName);
+            i += 1;
+        }
+    }
+    celixThreadMutex_unlock(&sender->boundedServices.mutex);
+    result->nrOfmsgMetrics = result->msgMetrics == NULL ? 0 : i;
+    return result;
+}
@@ -30,7 +30,9 @@ pubsub_websocket_topic_sender_t* pubsub_websocketTopicSender_create(
         celix_log_helper_t *logHelper,
         const char *scope,
         const char *topic,
+        const celix_properties_t *topicProperties,
         long serializerSvcId,
+        const char *serType,
         pubsub_serializer_service_t *ser);
 void pubsub_websocketTopicSender_destroy(pubsub_websocket_topic_sender_t *sender);
 
@@ -40,4 +42,9 @@ const char* pubsub_websocketTopicSender_url(pubsub_websocket_topic_sender_t *sen
 
 long pubsub_websocketTopicSender_serializerSvcId(pubsub_websocket_topic_sender_t *sender);
 
+/**
+ * Returns the send metrics per msg type/bundle or NULL if metrics are not enabled.
+ */
+pubsub_admin_sender_metrics_t* pubsub_websocketTopicSender_metrics(pubsub_websocket_topic_sender_t *sender);
+
 #endif //CELIX_PUBSUB_WEBSOCKET_TOPIC_SENDER_H
@@ -107,16 +107,15 @@ typedef struct psa_zmq_subscriber_metrics_entry_t {
     unsigned int msgTypeId;
     uuid_t origin;
 
+    //note updated by the receive thread with receiver->subscribers.mutex locked
     unsigned long nrOfMessagesReceived;
     unsigned long nrOfSerializationErrors;
-    struct timespec lastMessageReceived;
-    double averageTimeBetweenMessagesInSeconds;
-    double averageSerializationTimeInSeconds;
-    double averageDelayInSeconds;
-    double maxDelayInSeconds;
-    double minDelayInSeconds;
-    unsigned int lastSeqNr;
     unsigned long nrOfMissingSeqNumbers;
+    unsigned int lastSeqNr;
+    int64_t firstMessageReceivedInNs;
+    int64_t lastMessageReceivedInNs;
+    pubsub_admin_metrics_histogram_t *serializationTime;
+    pubsub_admin_metrics_histogram_t *delay;
 } psa_zmq_subscriber_metrics_entry_t;
 
 typedef struct psa_zmq_subscriber_entry {
@@ -128,6 +127,7 @@ typedef struct psa_zmq_subscriber_entry {
 
 
 static void pubsub_zmqTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
+static void psa_zmq_destroyMetrics(hash_map_t *metrics);
 static void pubsub_zmqTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
 static void* psa_zmq_recvThread(void * data);
 static void psa_zmq_connectToAllRequestedConnections(pubsub_zmq_topic_receiver_t *receiver);
@@ -300,15 +300,9 @@ void pubsub_zmqTopicReceiver_destroy(pubsub_zmq_topic_receiver_t *receiver) {
             if (entry != NULL)  {
                 receiver->serializer->destroySerializerMap(receiver->serializer->handle, entry->msgTypes);
                 hashMap_destroy(entry->subscriberServices, false, false);
+                psa_zmq_destroyMetrics(entry->metrics);
                 free(entry);
             }
-
-            hash_map_iterator_t iter2 = hashMapIterator_construct(entry->metrics);
-            while (hashMapIterator_hasNext(&iter2)) {
-                hash_map_t *origins = hashMapIterator_nextValue(&iter2);
-                hashMap_destroy(origins, true, true);
-            }
-            hashMap_destroy(entry->metrics, false, false);
         }
         hashMap_destroy(receiver->subscribers.map, false, false);
 
@@ -484,18 +478,83 @@ static void pubsub_zmqTopicReceiver_removeSubscriber(void *handle, void *svc, co
         if (rc != 0) {
             L_ERROR("[PSA_ZMQ] Cannot destroy msg serializers map for TopicReceiver %s/%s", receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
         }
-        hash_map_iterator_t iter = hashMapIterator_construct(entry->metrics);
-        while (hashMapIterator_hasNext(&iter)) {
-            hash_map_t *origins = hashMapIterator_nextValue(&iter);
-            hashMap_destroy(origins, true, true);
-        }
-        hashMap_destroy(entry->metrics, false, false);
+        psa_zmq_destroyMetrics(entry->metrics);
         hashMap_destroy(entry->subscriberServices, false, false);
         free(entry);
     }
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
 
+static void psa_zmq_destroyMetrics(hash_map_t *metrics) {
+    hash_map_iterator_t iter = hashMapIterator_construct(metrics);
+    while (hashMapIterator_hasNext(&iter)) {
+        hash_map_t *origins = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(origins);
+        while (hashMapIterator_hasNext(&iter2)) {
+            psa_zmq_subscriber_metrics_entry_t *entry = hashMapIterator_nextValue(&iter2);
+            pubsub_metricsHistogram_destroy(entry->serializationTime);
+            pubsub_metricsHistogram_destroy(entry->delay);
+        }
+        hashMap_destroy(origins, true, true);
+    }
+    hashMap_destroy(metrics, false, false);
+}
+
+/**
+ * Updates the metrics for the msg type and origin of the message. The origin and send time are taken from the
+ * metadata added by the sender if metrics are enabled, messages without an origin (or of an origin above the
+ * PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS limit) are counted for the null UUID origin.
+ */
+static void psa_zmq_updateMetrics(psa_zmq_subscriber_entry_t *entry, const pubsub_protocol_message_t *message,
+                                  const celix_properties_t *metadata, const struct timespec *receiveTime,
+                                  const struct timespec *beginSer, const struct timespec *endSer,
+                                  int updateReceiveCount, int updateSerError) {
+    //NOTE receiver->subscribers.mutex locked
+    hash_map_t *origins = hashMap_get(entry->metrics, (void*)(uintptr_t)message->header.msgId);
+    if (origins == NULL) {
+        return;
+    }
+    const char *origin = metadata == NULL ? NULL : celix_properties_get(metadata, PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY, NULL);
+    if (origin == NULL) {
+        origin = "";
+    }
+    psa_zmq_subscriber_metrics_entry_t *metrics = hashMap_get(origins, origin);
+    if (metrics == NULL && hashMap_size(origins) >= PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS) {
+        origin = "";
+        metrics = hashMap_get(origins, origin);
+    }
+    if (metrics == NULL) {
+        metrics = calloc(1, sizeof(*metrics));
+        metrics->msgTypeId = message->header.msgId;
+        if (uuid_parse(origin, metrics->origin) != 0) {
+            uuid_clear(metrics->origin);
+        }
+        metrics->serializationTime = pubsub_metricsHistogram_create();
+        metrics->delay = pubsub_metricsHistogram_create();
+        hashMap_put(origins, strndup(origin, UUID_STR_LEN + 1), metrics);
+    }
+
+    pubsub_metricsHistogram_record(metrics->serializationTime, celix_difftime(beginSer, endSer));
+    int64_t receiveTimeInNs = pubsub_metrics_timespecToNs(receiveTime);
+    long sendTimeInNs = metadata == NULL ? 0 : celix_properties_getAsLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIME_KEY, 0);
+    if (sendTimeInNs > 0) {
+        pubsub_metricsHistogram_record(metrics->delay, (double)(receiveTimeInNs - sendTimeInNs) / 1000000000.0);
+    }
+
+    unsigned int seqNr = message->header.seqNr;
+    unsigned int incr = seqNr - metrics->lastSeqNr;
+    if (metrics->firstMessageReceivedInNs != 0 && incr > 1 && incr < UINT32_MAX / 2) { //note a large increment is a restarted publisher
+        metrics->nrOfMissingSeqNumbers += incr - 1;
+    }
+    metrics->lastSeqNr = seqNr;
+    if (metrics->firstMessageReceivedInNs == 0) {
+        metrics->firstMessageReceivedInNs = receiveTimeInNs;
+    }
+    metrics->lastMessageReceivedInNs = receiveTimeInNs;
+    metrics->nrOfMessagesReceived += updateReceiveCount;
+    metrics->nrOfSerializationErrors += updateSerError;
+}
+
 static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *receiver, psa_zmq_subscriber_entry_t* entry, pubsub_protocol_message_t *message, struct timespec *receiveTime) {
     //NOTE receiver->subscribers.mutex locked
     pubsub_msg_serializer_t* msgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)(message->header.msgId));
@@ -517,7 +576,7 @@ static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *rec
             struct iovec deSerializeBuffer;
             deSerializeBuffer.iov_base = message->payload.payload;
             deSerializeBuffer.iov_len  = message->payload.length;
-            celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &deserializedMsg);
+            celix_status_t status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 1, &deserializedMsg);
             if (monitor) {
                 clock_gettime(CLOCK_REALTIME, &endSer);
             }
@@ -537,7 +596,7 @@ static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *rec
                         if (!release && hashMapIterator_hasNext(&iter2)) {
                             //receive function has taken ownership and still more receive function to come ..
                             //deserialize again for new message
-                            status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 0, &deserializedMsg);
+                            status = msgSer->deserialize(msgSer->handle, &deSerializeBuffer, 1, &deserializedMsg);
                             if (status != CELIX_SUCCESS) {
                                 L_WARN("[PSA_ZMQ_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgSer->msgName, receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
                                 break;
@@ -559,56 +618,8 @@ static inline void processMsgForSubscriberEntry(pubsub_zmq_topic_receiver_t *rec
         L_WARN("[PSA_ZMQ_TR] Cannot find serializer for type id 0x%X", message->header.msgId);
     }
 
-    if (msgSer != NULL && monitor) {
-        // TODO disabled for now, should move to an interceptor?
-//        hash_map_t *origins = hashMap_get(entry->metrics, (void*)(uintptr_t )message->header.msgId);
-//        char uuidStr[UUID_STR_LEN+1];
-//        uuid_unparse(hdr->originUUID, uuidStr);
-//        psa_zmq_subscriber_metrics_entry_t *metrics = hashMap_get(origins, uuidStr);
-//
-//        if (metrics == NULL) {
-//            metrics = calloc(1, sizeof(*metrics));
-//            hashMap_put(origins, strndup(uuidStr, UUID_STR_LEN+1), metrics);
-//            uuid_copy(metrics->origin, hdr->originUUID);
-//            metrics->msgTypeId = hdr->type;
-//            metrics->maxDelayInSeconds = -INFINITY;
-//            metrics->minDelayInSeconds = INFINITY;
-//            metrics->lastSeqNr = 0;
-//        }
-//
-//        double diff = celix_difftime(&beginSer, &endSer);
-//        long n = metrics->nrOfMessagesReceived;
-//        metrics->averageSerializationTimeInSeconds = (metrics->averageSerializationTimeInSeconds * n + diff) / (n+1);
-//
-//        diff = celix_difftime(&metrics->lastMessageReceived, receiveTime);
-//        n = metrics->nrOfMessagesReceived;
-//        if (metrics->nrOfMessagesReceived >= 1) {
-//            metrics->averageTimeBetweenMessagesInSeconds = (metrics->averageTimeBetweenMessagesInSeconds * n + diff) / (n + 1);
-//        }
-//        metrics->lastMessageReceived = *receiveTime;
-//
-//
-//        int incr = hdr->seqNr - metrics->lastSeqNr;
-//        if (metrics->lastSeqNr >0 && incr > 1) {
-//            metrics->nrOfMissingSeqNumbers += (incr - 1);
-//            L_WARN("Missing message seq nr went from %i to %i", metrics->lastSeqNr, hdr->seqNr);
-//        }
-//        metrics->lastSeqNr = hdr->seqNr;
-//
-//        struct timespec sendTime;
-//        sendTime.tv_sec = (time_t)hdr->sendtimeSeconds;
-//        sendTime.tv_nsec = (long)hdr->sendTimeNanoseconds; //TODO FIXME the tv_nsec is not correct
-//        diff = celix_difftime(&sendTime, receiveTime);
-//        metrics->averageDelayInSeconds = (metrics->averageDelayInSeconds * n + diff) / (n+1);
-//        if (diff < metrics->minDelayInSeconds) {
-//            metrics->minDelayInSeconds = diff;
-//        }
-//        if (diff > metrics->maxDelayInSeconds) {
-//            metrics->maxDelayInSeconds = diff;
-//        }
-//
-//        metrics->nrOfMessagesReceived += updateReceiveCount;
-//        metrics->nrOfSerializationErrors += updateSerError;
+    if (monitor && (updateReceiveCount > 0 || updateSerError > 0)) {
+        psa_zmq_updateMetrics(entry, message, message->metadata.metadata, receiveTime, &beginSer, &endSer, updateReceiveCount, updateSerError);
     }
 }
 
@@ -752,16 +763,23 @@ pubsub_admin_receiver_metrics_t* pubsub_zmqTopicReceiver_metrics(pubsub_zmq_topi
                 pubsub_msg_serializer_t *msgSer = hashMap_get(entry->msgTypes, (void*)(uintptr_t)metrics->msgTypeId);
                 if (msgSer) {
                     snprintf(result->msgTypes[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", msgSer->msgName);
-                    uuid_copy(result->msgTypes[i].origins[k].originUUID, metrics->origin);
-                    result->msgTypes[i].origins[k].nrOfMessagesReceived = metrics->nrOfMessagesReceived;
-                    result->msgTypes[i].origins[k].nrOfSerializationErrors = metrics->nrOfSerializationErrors;
-                    result->msgTypes[i].origins[k].averageDelayInSeconds = metrics->averageDelayInSeconds;
-                    result->msgTypes[i].origins[k].maxDelayInSeconds = metrics->maxDelayInSeconds;
-                    result->msgTypes[i].origins[k].minDelayInSeconds = metrics->minDelayInSeconds;
-                    result->msgTypes[i].origins[k].averageTimeBetweenMessagesInSeconds = metrics->averageTimeBetweenMessagesInSeconds;
-                    result->msgTypes[i].origins[k].averageSerializationTimeInSeconds = metrics->averageSerializationTimeInSeconds;
-                    result->msgTypes[i].origins[k].lastMessageReceived = metrics->lastMessageReceived;
-                    result->msgTypes[i].origins[k].nrOfMissingSeqNumbers = metrics->nrOfMissingSeqNumbers;
+                    struct pubsub_admin_receiver_origin_metrics *out = &result->msgTypes[i].origins[k];
+                    uuid_copy(out->originUUID, metrics->origin);
+                    out->nrOfMessagesReceived = metrics->nrOfMessagesReceived;
+                    out->nrOfSerializationErrors = metrics->nrOfSerializationErrors;
+                    out->nrOfMissingSeqNumbers = metrics->nrOfMissingSeqNumbers;
+                    pubsub_metricsHistogram_summary(metrics->serializationTime, &out->serializationTime);
+                    pubsub_metricsHistogram_summary(metrics->delay, &out->delay);
+                    out->averageSerializationTimeInSeconds = out->serializationTime.averageInSeconds;
+                    out->averageDelayInSeconds = out->delay.averageInSeconds;
+                    out->minDelayInSeconds = out->delay.minInSeconds;
+                    out->maxDelayInSeconds = out->delay.maxInSeconds;
+                    unsigned long n = metrics->nrOfMessagesReceived + metrics->nrOfSerializationErrors;
+                    if (n > 1) {
+                        out->averageTimeBetweenMessagesInSeconds = (double)(metrics->lastMessageReceivedInNs - metrics->firstMessageReceivedInNs) / (double)(n - 1) / 1000000000.0;
+                    }
+                    out->lastMessageReceived.tv_sec = (time_t)(metrics->lastMessageReceivedInNs / 1000000000);
+                    out->lastMessageReceived.tv_nsec = (long)(metrics->lastMessageReceivedInNs % 1000000000);
 
                     k += 1;
                 } else {
@@ -54,6 +54,7 @@ struct pubsub_zmq_topic_sender {
     long protocolSvcId;
     pubsub_protocol_service_t *protocol;
     uuid_t fwUUID;
+    char fwUUIDStr[UUID_STR_LEN+1];
     bool metricsEnabled;
     bool zeroCopyEnabled;
 
@@ -96,13 +97,13 @@ typedef struct psa_zmq_send_msg_entry {
     size_t footerBufferSize;
     bool dataLocked; // protected ZMQ functions and seqNr
     struct {
-        celix_thread_mutex_t mutex; //protects entries in struct
+        //note updated using atomics, so that sending threads do not contend on a metrics lock
         unsigned long nrOfMessagesSend;
         unsigned long nrOfMessagesSendFailed;
         unsigned long nrOfSerializationErrors;
-        struct timespec lastMessageSend;
-        double averageTimeBetweenMessagesInSeconds;
-        double averageSerializationTimeInSeconds;
+        int64_t firstMessageSendInNs;
+        int64_t lastMessageSendInNs;
+        pubsub_admin_metrics_histogram_t *serializationTime;
     } metrics;
 } psa_zmq_send_msg_entry_t;
 
@@ -129,6 +130,7 @@ static unsigned int rand_range(unsigned int min, unsigned int max);
 static void delay_first_send_for_late_joiners(pubsub_zmq_topic_sender_t *sender);
 
 static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *msg, celix_properties_t *metadata);
+static int psa_zmq_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
 
 pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
         celix_bundle_context_t *ctx,
@@ -154,6 +156,7 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
     if (uuid != NULL) {
         uuid_parse(uuid, sender->fwUUID);
     }
+    uuid_unparse(sender->fwUUID, sender->fwUUIDStr);
     sender->metricsEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_METRICS_ENABLED, PSA_ZMQ_DEFAULT_METRICS_ENABLED);
     sender->zeroCopyEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_ZEROCOPY_ENABLED, PSA_ZMQ_DEFAULT_ZEROCOPY_ENABLED);
 
@@ -306,7 +309,7 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
 }
 
 static void pubsub_zmqTopicSender_destroyEntry(psa_zmq_send_msg_entry_t *msgEntry) {
-    celixThreadMutex_destroy(&msgEntry->metrics.mutex);
+    pubsub_metricsHistogram_destroy(msgEntry->metrics.serializationTime);
     if(msgEntry->headerBuffer != NULL) {
         free(msgEntry->headerBuffer);
     }
@@ -429,13 +432,14 @@ static void* psa_zmq_getPublisherService(void *handle, const celix_bundle_t *req
                 sendEntry->major = (uint8_t)major;
                 sendEntry->minor = (uint8_t)minor;
                 uuid_copy(sendEntry->originUUID, sender->fwUUID);
-                celixThreadMutex_create(&sendEntry->metrics.mutex, NULL);
+                sendEntry->metrics.serializationTime = pubsub_metricsHistogram_create();
                 hashMap_put(entry->msgEntries, key, sendEntry);
                 hashMap_put(entry->msgTypeIds, strndup(sendEntry->msgSer->msgName, 1024), (void *)(uintptr_t) sendEntry->msgSer->msgId);
             }
             entry->service.handle = entry;
             entry->service.localMsgTypeIdForMsgType = psa_zmq_localMsgTypeIdForMsgType;
             entry->service.send = psa_zmq_topicPublicationSend;
+            entry->service.sendMany = psa_zmq_topicPublicationSendMany;
             hashMap_put(sender->boundedServices.map, (void*)bndId, entry);
         } else {
             L_ERROR("Error creating serializer map for ZMQ TopicSender %s/%s", sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
@@ -492,7 +496,7 @@ pubsub_admin_sender_metrics_t* pubsub_zmqTopicSender_metrics(pubsub_zmq_topic_se
         }
     }
 
-    result->msgMetrics = calloc(count, sizeof(*result));
+    result->msgMetrics = calloc(count, sizeof(*result->msgMetrics));
 
     iter = hashMapIterator_construct(sender->boundedServices.map);
     int i = 0;
@@ -501,18 +505,23 @@ pubsub_admin_sender_metrics_t* pubsub_zmqTopicSender_metrics(pubsub_zmq_topic_se
         hash_map_iterator_t iter2 = hashMapIterator_construct(entry->msgEntries);
         while (hashMapIterator_hasNext(&iter2)) {
             psa_zmq_send_msg_entry_t *mEntry = hashMapIterator_nextValue(&iter2);
-            celixThreadMutex_lock(&mEntry->metrics.mutex);
-            result->msgMetrics[i].nrOfMessagesSend = mEntry->metrics.nrOfMessagesSend;
-            result->msgMetrics[i].nrOfMessagesSendFailed = mEntry->metrics.nrOfMessagesSendFailed;
-            result->msgMetrics[i].nrOfSerializationErrors = mEntry->metrics.nrOfSerializationErrors;
-            result->msgMetrics[i].averageSerializationTimeInSeconds = mEntry->metrics.averageSerializationTimeInSeconds;
-            result->msgMetrics[i].averageTimeBetweenMessagesInSeconds = mEntry->metrics.averageTimeBetweenMessagesInSeconds;
-            result->msgMetrics[i].lastMessageSend = mEntry->metrics.lastMessageSend;
+            result->msgMetrics[i].nrOfMessagesSend = __atomic_load_n(&mEntry->metrics.nrOfMessagesSend, __ATOMIC_RELAXED);
+            result->msgMetrics[i].nrOfMessagesSendFailed = __atomic_load_n(&mEntry->metrics.nrOfMessagesSendFailed, __ATOMIC_RELAXED);
+            result->msgMetrics[i].nrOfSerializationErrors = __atomic_load_n(&mEntry->metrics.nrOfSerializationErrors, __ATOMIC_RELAXED);
+            pubsub_metricsHistogram_summary(mEntry->metrics.serializationTime, &result->msgMetrics[i].serializationTime);
+            result->msgMetrics[i].averageSerializationTimeInSeconds = result->msgMetrics[i].serializationTime.averageInSeconds;
+            int64_t first = __atomic_load_n(&mEntry->metrics.firstMessageSendInNs, __ATOMIC_RELAXED);
+            int64_t last = __atomic_load_n(&mEntry->metrics.lastMessageSendInNs, __ATOMIC_RELAXED);
+            unsigned long n = result->msgMetrics[i].nrOfMessagesSend + result->msgMetrics[i].nrOfMessagesSendFailed;
+            if (n > 1) {
+                result->msgMetrics[i].averageTimeBetweenMessagesInSeconds = (double)(last - first) / (double)(n - 1) / 1000000000.0;
+            }
+            result->msgMetrics[i].lastMessageSend.tv_sec = (time_t)(last / 1000000000);
+            result->msgMetrics[i].lastMessageSend.tv_nsec = (long)(last % 1000000000);
             result->msgMetrics[i].bndId = entry->bndId;
             result->msgMetrics[i].typeId = mEntry->type;
             snprintf(result->msgMetrics[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", mEntry->msgSer->msgName);
             i += 1;
-            celixThreadMutex_unlock(&mEntry->metrics.mutex);
         }
     }
 
@@ -541,7 +550,6 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
     psa_zmq_send_msg_entry_t *entry = hashMap_get(bound->msgEntries, (void*)(uintptr_t)(msgTypeId));
 
     //metrics updates
-    struct timespec sendTime = { 0, 0 };
     struct timespec serializationStart;
     struct timespec serializationEnd;
     //int unknownMessageCountUpdate = 0;
@@ -584,6 +592,14 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
                 size_t payloadLength = 0;
                 entry->protSer->encodePayload(entry->protSer->handle, &message, &payloadData, &payloadLength);
 
+                if (monitor) {
+                    //origin and send time, so that the receivers can track the metrics per origin and the delay
+                    if (metadata == NULL) {
+                        metadata = celix_properties_create();
+                    }
+                    celix_properties_set(metadata, PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY, sender->fwUUIDStr);
+                    celix_properties_setLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIME_KEY, pubsub_metrics_timespecToNs(&serializationStart));
+                }
                 if (metadata != NULL) {
                     message.metadata.metadata = metadata;
                     entry->protSer->encodeMetadata(entry->protSer->handle, &message, &entry->metadataBuffer, &entry->metadataBufferSize);
@@ -718,28 +734,33 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
 
 
     if (monitor && entry != NULL) {
-        celixThreadMutex_lock(&entry->metrics.mutex);
-
-        long n = entry->metrics.nrOfMessagesSend + entry->metrics.nrOfMessagesSendFailed;
-        double diff = celix_difftime(&serializationStart, &serializationEnd);
-        double average = (entry->metrics.averageSerializationTimeInSeconds * n + diff) / (n+1);
-        entry->metrics.averageSerializationTimeInSeconds = average;
-
-        if (entry->metrics.nrOfMessagesSend > 2) {
-            diff = celix_difftime(&entry->metrics.lastMessageSend, &sendTime);
-            n = entry->metrics.nrOfMessagesSend;
-            average = (entry->metrics.averageTimeBetweenMessagesInSeconds * n + diff) / (n+1);
-            entry->metrics.averageTimeBetweenMessagesInSeconds = average;
+        pubsub_metricsHistogram_record(entry->metrics.serializationTime, celix_difftime(&serializationStart, &serializationEnd));
+        int64_t sendTime = pubsub_metrics_timespecToNs(&serializationEnd);
+        int64_t noTime = 0;
+        __atomic_compare_exchange_n(&entry->metrics.firstMessageSendInNs, &noTime, sendTime, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->metrics.lastMessageSendInNs, sendTime, __ATOMIC_RELAXED);
+        if (sendCountUpdate > 0) {
+            __atomic_fetch_add(&entry->metrics.nrOfMessagesSend, sendCountUpdate, __ATOMIC_RELAXED);
         }
+        if (sendErrorUpdate > 0) {
+            __atomic_fetch_add(&entry->metrics.nrOfMessagesSendFailed, sendErrorUpdate, __ATOMIC_RELAXED);
+        }
+        if (serializationErrorUpdate > 0) {
+            __atomic_fetch_add(&entry->metrics.nrOfSerializationErrors, serializationErrorUpdate, __ATOMIC_RELAXED);
+        }
+    }
 
-        entry->metrics.lastMessageSend = sendTime;
-        entry->metrics.nrOfMessagesSend += sendCountUpdate;
-        entry->metrics.nrOfMessagesSendFailed += sendErrorUpdate;
-        entry->metrics.nrOfSerializationErrors += serializationErrorUpdate;
+    return status;
+}
 
-        celixThreadMutex_unlock(&entry->metrics.mutex);
+static int psa_zmq_topicPublicationSendMany(void* handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs) {
+    int status = CELIX_SUCCESS;
+    for (size_t i = 0; i < nrOfMsgs; ++i) {
+        int rc = psa_zmq_topicPublicationSend(handle, msgs[i].msgTypeId, msgs[i].msg, msgs[i].metadata);
+        if (status == CELIX_SUCCESS) {
+            status = rc;
+        }
     }
-
     return status;
 }
 
@@ -32,13 +32,22 @@
 #include "celix_properties.h"
 
 #define PUBSUB_PUBLISHER_SERVICE_NAME           "pubsub.publisher"
-#define PUBSUB_PUBLISHER_SERVICE_VERSION        "3.0.0"
+#define PUBSUB_PUBLISHER_SERVICE_VERSION        "3.1.0"
  
 //properties
 #define PUBSUB_PUBLISHER_TOPIC                  "topic"
 #define PUBSUB_PUBLISHER_SCOPE                  "scope"
 #define PUBSUB_PUBLISHER_CONFIG                 "pubsub.config"
 
+/**
+ * A message entry for pubsub_publisher_t::sendMany.
+ */
+typedef struct pubsub_publisher_msg {
+    unsigned int msgTypeId;         // The local type id, see pubsub_publisher_t::send
+    const void *msg;                // The message to send
+    celix_properties_t *metadata;   // The meta data to send along with this message. Can be NULL.
+} pubsub_publisher_msg_t;
+
 struct pubsub_publisher {
     void *handle;
 
@@ -71,7 +80,19 @@ struct pubsub_publisher {
      * @return              Returns 0 on success.
      */
     int (*send)(void *handle, unsigned int msgTypeId, const void *msg, celix_properties_t *metadata);
- 
+
+    /**
+     * Sends a batch of messages. The messages are sent in order and with the same ownership rules as the send
+     * function, but the pubsubadmin can combine them in fewer network writes (e.g. one write per connection).
+     * All messages are handled, also when sending one of the messages fails.
+     * Can be NULL for pubsubadmins (publisher version < 3.1.0) without batch support; use send for every message then.
+     *
+     * @param handle        The publisher handle.
+     * @param msgs          The messages to send.
+     * @param nrOfMsgs      The number of messages in msgs.
+     * @return              Returns 0 if all messages are sent, otherwise the error of the first failing message.
+     */
+    int (*sendMany)(void *handle, const pubsub_publisher_msg_t *msgs, size_t nrOfMsgs);
 };
 typedef struct pubsub_publisher pubsub_publisher_t;
 
@@ -0,0 +1,284 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "pubsub_admin_metrics.h"
+#include "celix_utils.h"
+
+TEST(PubSubAdminMetricsTestSuite, EmptyHistogram) {
+    auto* hist = pubsub_metricsHistogram_create();
+    pubsub_admin_metrics_latency_t summary{};
+    summary.count = 42;
+    pubsub_metricsHistogram_summary(hist, &summary);
+    EXPECT_EQ(0, summary.count);
+    EXPECT_EQ(0.0, summary.maxInSeconds);
+    EXPECT_EQ(0.0, summary.p99InSeconds);
+    EXPECT_EQ(0.0, pubsub_metricsHistogram_valueAtPercentile(hist, 50));
+    pubsub_metricsHistogram_destroy(hist);
+}
+
+TEST(PubSubAdminMetricsTestSuite, HistogramPercentiles) {
+    auto* hist = pubsub_metricsHistogram_create();
+    //1 .. 10000 microseconds
+    for (int i = 1; i <= 10000; ++i) {
+        pubsub_metricsHistogram_record(hist, i / 1000000.0);
+    }
+    pubsub_admin_metrics_latency_t summary{};
+    pubsub_metricsHistogram_summary(hist, &summary);
+    EXPECT_EQ(10000, summary.count);
+    EXPECT_NEAR(0.000001, summary.minInSeconds, 1e-12);
+    EXPECT_NEAR(0.01, summary.maxInSeconds, 1e-12);
+    EXPECT_NEAR(0.0050005, summary.averageInSeconds, 1e-9);
+    EXPECT_NEAR(0.005, summary.p50InSeconds, 0.005 * 0.03);
+    EXPECT_NEAR(0.009, summary.p90InSeconds, 0.009 * 0.03);
+    EXPECT_NEAR(0.0099, summary.p99InSeconds, 0.0099 * 0.03);
+    EXPECT_NEAR(0.00999, summary.p999InSeconds, 0.00999 * 0.03);
+    EXPECT_NEAR(0.000001, pubsub_metricsHistogram_valueAtPercentile(hist, 0), 1e-12);
+    EXPECT_NEAR(0.01, pubsub_metricsHistogram_valueAtPercentile(hist, 100), 1e-12);
+    pubsub_metricsHistogram_destroy(hist);
+}
+
+TEST(PubSubAdminMetricsTestSuite, HistogramOutOfRangeValues) {
+    auto* hist = pubsub_metricsHistogram_create();
+    pubsub_metricsHistogram_record(hist, -1.0); //e.g. clock skew, recorded as 0
+    pubsub_metricsHistogram_record(hist, 10000.0); //larger than the highest bucket
+    pubsub_admin_metrics_latency_t summary{};
+    pubsub_metricsHistogram_summary(hist, &summary);
+    EXPECT_EQ(2, summary.count);
+    EXPECT_EQ(0.0, summary.minInSeconds);
+    EXPECT_NEAR(10000.0, summary.maxInSeconds, 1e-6);
+    EXPECT_EQ(0.0, summary.p50InSeconds);
+    EXPECT_NEAR(10000.0, summary.p99InSeconds, 1e-6);
+    pubsub_metricsHistogram_destroy(hist);
+}
+
+TEST(PubSubAdminMetricsTestSuite, ConcurrentRecord) {
+    auto* hist = pubsub_metricsHistogram_create();
+    const int nrOfThreads = 4;
+    const int count = 100000;
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < nrOfThreads; ++t) {
+        threads.emplace_back([hist, t]{
+            for (int i = 0; i < count; ++i) {
+                pubsub_metricsHistogram_record(hist, (t + 1) / 1000.0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    pubsub_admin_metrics_latency_t summary{};
+    pubsub_metricsHistogram_summary(hist, &summary);
+    EXPECT_EQ(nrOfThreads * count, summary.count);
+    EXPECT_NEAR(0.001, summary.minInSeconds, 1e-12);
+    EXPECT_NEAR(0.004, summary.maxInSeconds, 1e-12);
+    EXPECT_NEAR(0.0025, summary.averageInSeconds, 1e-9);
+    EXPECT_NEAR(0.002, summary.p50InSeconds, 0.002 * 0.03);
+    pubsub_metricsHistogram_destroy(hist);
+}
+
+TEST(PubSubAdminMetricsTestSuite, SendCounters) {
+    pubsub_admin_metrics_send_counters_t counters;
+    pubsub_metricsSendCounters_init(&counters);
+    struct timespec start = {10, 0};
+    struct timespec end = {10, 1000}; //1us serialization
+    pubsub_metricsSendCounters_update(&counters, &start, &end, 1, 0, 0);
+    start.tv_sec = 11;
+    end.tv_sec = 11;
+    pubsub_metricsSendCounters_update(&counters, &start, &end, 0, 1, 0);
+    start.tv_sec = 12;
+    end.tv_sec = 12;
+    pubsub_metricsSendCounters_update(&counters, &start, &end, 0, 0, 1);
+
+    pubsub_admin_sender_msg_type_metrics_t out{};
+    pubsub_metricsSendCounters_fill(&counters, &out);
+    EXPECT_EQ(1, out.nrOfMessagesSend);
+    EXPECT_EQ(1, out.nrOfMessagesSendFailed);
+    EXPECT_EQ(1, out.nrOfSerializationErrors);
+    EXPECT_EQ(3, out.serializationTime.count);
+    EXPECT_NEAR(0.000001, out.averageSerializationTimeInSeconds, 1e-9);
+    EXPECT_NEAR(1.0, out.averageTimeBetweenMessagesInSeconds, 1e-9);
+    EXPECT_EQ(12, out.lastMessageSend.tv_sec);
+    EXPECT_EQ(1000, out.lastMessageSend.tv_nsec);
+    pubsub_metricsSendCounters_deinit(&counters);
+}
+
+TEST(PubSubAdminMetricsTestSuite, SendMetadata) {
+    struct timespec sendTime = {100, 42};
+    auto* metadata = pubsub_metrics_addSendMetadata(nullptr, "origin", &sendTime);
+    const char* origin = nullptr;
+    int64_t sendTimeInNs = 0;
+    pubsub_metrics_getSendMetadata(metadata, &origin, &sendTimeInNs);
+    EXPECT_STREQ("origin", origin);
+    EXPECT_EQ(100000000042, sendTimeInNs);
+    celix_properties_destroy(metadata);
+
+    origin = "unchanged";
+    sendTimeInNs = 1;
+    pubsub_metrics_getSendMetadata(nullptr, &origin, &sendTimeInNs);
+    EXPECT_EQ(nullptr, origin);
+    EXPECT_EQ(0, sendTimeInNs);
+}
+
+TEST(PubSubAdminMetricsTestSuite, ReceiveCountersPerOrigin) {
+    auto* counters = pubsub_metricsReceiveCounters_create();
+    const char* uuid1 = "0c5f3a4e-0fe4-4b9e-a6d9-3a0d2b4a7f01";
+    const char* uuid2 = "0c5f3a4e-0fe4-4b9e-a6d9-3a0d2b4a7f02";
+    struct timespec sendTime = {100, 0};
+    struct timespec receiveTime = {100, 2000}; //2us delay
+    int64_t sendTimeInNs = pubsub_metrics_timespecToNs(&sendTime);
+
+    //origin 1 misses seq nr 2 and 3
+    for (unsigned int seqNr : {1u, 4u, 5u}) {
+        pubsub_metricsReceiveCounters_update(counters, 42, "msg", uuid1, sendTimeInNs, &seqNr, &receiveTime, nullptr, nullptr, 1, 0);
+    }
+    unsigned int seqNr = 1;
+    pubsub_metricsReceiveCounters_update(counters, 42, "msg", uuid2, sendTimeInNs, &seqNr, &receiveTime, nullptr, nullptr, 0, 1);
+    //no origin -> null uuid origin, no send time -> no delay
+    pubsub_metricsReceiveCounters_update(counters, 43, "other", nullptr, 0, nullptr, &receiveTime, nullptr, nullptr, 1, 0);
+
+    pubsub_admin_receiver_metrics_t out{};
+    pubsub_metricsReceiveCounters_fill(counters, &out);
+    ASSERT_EQ(2, out.nrOfMsgTypes);
+    for (unsigned long i = 0; i < out.nrOfMsgTypes; ++i) {
+        if (out.msgTypes[i].typeId == 42) {
+            EXPECT_STREQ("msg", out.msgTypes[i].typeFqn);
+            ASSERT_EQ(2, out.msgTypes[i].nrOfOrigins);
+            for (int k = 0; k < out.msgTypes[i].nrOfOrigins; ++k) {
+                auto& origin = out.msgTypes[i].origins[k];
+                char uuid[UUID_STR_LEN];
+                uuid_unparse(origin.originUUID, uuid);
+                if (strcmp(uuid, uuid1) == 0) {
+                    EXPECT_EQ(3, origin.nrOfMessagesReceived);
+                    EXPECT_EQ(2, origin.nrOfMissingSeqNumbers);
+                    EXPECT_EQ(3, origin.delay.count);
+                    EXPECT_NEAR(0.000002, origin.averageDelayInSeconds, 1e-9);
+                } else {
+                    EXPECT_STREQ(uuid2, uuid);
+                    EXPECT_EQ(0, origin.nrOfMessagesReceived);
+                    EXPECT_EQ(1, origin.nrOfSerializationErrors);
+                }
+            }
+        } else {
+            EXPECT_EQ(43, out.msgTypes[i].typeId);
+            EXPECT_STREQ("other", out.msgTypes[i].typeFqn);
+            ASSERT_EQ(1, out.msgTypes[i].nrOfOrigins);
+            EXPECT_TRUE(uuid_is_null(out.msgTypes[i].origins[0].originUUID));
+            EXPECT_EQ(1, out.msgTypes[i].origins[0].nrOfMessagesReceived);
+            EXPECT_EQ(0, out.msgTypes[i].origins[0].delay.count);
+        }
+        free(out.msgTypes[i].origins);
+    }
+    free(out.msgTypes);
+    pubsub_metricsReceiveCounters_destroy(counters);
+}
+
+TEST(PubSubAdminMetricsTestSuite, ReceiveCountersOriginLimit) {
+    auto* counters = pubsub_metricsReceiveCounters_create();
+    struct timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    for (int i = 0; i < PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS * 2; ++i) {
+        uuid_t uid;
+        char uuid[UUID_STR_LEN];
+        uuid_generate(uid);
+        uuid_unparse(uid, uuid);
+        pubsub_metricsReceiveCounters_update(counters, 1, "msg", uuid, 0, nullptr, &now, nullptr, nullptr, 1, 0);
+    }
+
+    pubsub_admin_receiver_metrics_t out{};
+    pubsub_metricsReceiveCounters_fill(counters, &out);
+    ASSERT_EQ(1, out.nrOfMsgTypes);
+    //the origins above the limit are counted for the null uuid origin
+    EXPECT_EQ(PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS + 1, out.msgTypes[0].nrOfOrigins);
+    unsigned long total = 0;
+    for (int k = 0; k < out.msgTypes[0].nrOfOrigins; ++k) {
+        total += out.msgTypes[0].origins[k].nrOfMessagesReceived;
+    }
+    EXPECT_EQ(PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS * 2, total);
+    free(out.msgTypes[0].origins);
+    free(out.msgTypes);
+    pubsub_metricsReceiveCounters_destroy(counters);
+}
+
+/**
+ * Measures the per message metrics overhead of a PSA with metrics enabled. At 100k msg/s the budget is 10us per
+ * message, so a few percent overhead is a few hundred nanoseconds.
+ * The counters (time stamps, send and receive counters) and the origin/send time metadata entries are measured
+ * separately, because a PSA which already has the origin or does not send metadata only pays for the counters.
+ */
+TEST(PubSubAdminMetricsTestSuite, MetricsOverhead) {
+    const int count = 100000;
+    const char* fwUUID = "0c5f3a4e-0fe4-4b9e-a6d9-3a0d2b4a7f01";
+    pubsub_admin_metrics_send_counters_t sendCounters;
+    pubsub_metricsSendCounters_init(&sendCounters);
+    auto* receiveCounters = pubsub_metricsReceiveCounters_create();
+
+    struct timespec begin{};
+    struct timespec end{};
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (unsigned int i = 0; i < count; ++i) {
+        struct timespec start{};
+        struct timespec stop{};
+        clock_gettime(CLOCK_REALTIME, &start);
+        clock_gettime(CLOCK_REALTIME, &stop);
+        pubsub_metricsSendCounters_update(&sendCounters, &start, &stop, 1, 0, 0);
+        struct timespec receiveTime{};
+        clock_gettime(CLOCK_REALTIME, &receiveTime);
+        pubsub_metricsReceiveCounters_update(receiveCounters, 1, "msg", fwUUID, pubsub_metrics_timespecToNs(&start),
+                                             &i, &receiveTime, &start, &stop, 1, 0);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double countersNsPerMsg = celix_difftime(&begin, &end) * 1000000000.0 / count;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (unsigned int i = 0; i < count; ++i) {
+        auto* metadata = pubsub_metrics_addSendMetadata(nullptr, fwUUID, &begin);
+        const char* origin = nullptr;
+        int64_t sendTime = 0;
+        pubsub_metrics_getSendMetadata(metadata, &origin, &sendTime);
+        EXPECT_NE(nullptr, origin);
+        celix_properties_destroy(metadata);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double metadataNsPerMsg = celix_difftime(&begin, &end) * 1000000000.0 / count;
+
+    std::cout << "Metrics overhead per msg: counters " << countersNsPerMsg << " ns ("
+              << countersNsPerMsg / 100.0 << "% of 10us), origin/send time metadata " << metadataNsPerMsg << " ns ("
+              << metadataNsPerMsg / 100.0 << "% of 10us)" << std::endl;
+
+    pubsub_admin_receiver_metrics_t out{};
+    pubsub_metricsReceiveCounters_fill(receiveCounters, &out);
+    ASSERT_EQ(1, out.nrOfMsgTypes);
+    EXPECT_EQ(count, out.msgTypes[0].origins[0].nrOfMessagesReceived);
+    EXPECT_EQ(0, out.msgTypes[0].origins[0].nrOfMissingSeqNumbers);
+    free(out.msgTypes[0].origins);
+    free(out.msgTypes);
+    //loose bound (unoptimized/instrumented builds), the measured values are reported above
+    EXPECT_LT(countersNsPerMsg + metadataNsPerMsg, 10000.0);
+
+    pubsub_metricsReceiveCounters_destroy(receiveCounters);
+    pubsub_metricsSendCounters_deinit(&sendCounters);
+}
@@ -0,0 +1,218 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "celix_api.h"
+#include "pubsub_interceptors_handler.h"
+
+class PubSubInterceptorsHandlerTestSuite : public ::testing::Test {
+public:
+    struct Interceptor {
+        pubsub_interceptor_t svc{};
+        std::atomic<long> count{0};
+        std::vector<int>* order = nullptr;
+        int id = 0;
+        bool cont = true;
+        long svcId = -1L;
+    };
+
+    PubSubInterceptorsHandlerTestSuite() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, OSGI_FRAMEWORK_FRAMEWORK_STORAGE, ".pubsub_spi_cache");
+        auto* fwPtr = celix_frameworkFactory_createFramework(props);
+        auto* ctxPtr = celix_framework_getFrameworkContext(fwPtr);
+        fw = std::shared_ptr<celix_framework_t>{fwPtr, [](auto* f) {celix_frameworkFactory_destroyFramework(f);}};
+        ctx = std::shared_ptr<celix_bundle_context_t>{ctxPtr, [](auto*){/*nop*/}};
+    }
+
+    static bool preCall(void* handle, pubsub_interceptor_properties_t*, const char*, const uint32_t, const void*, const celix_properties_t*) {
+        auto* interceptor = static_cast<Interceptor*>(handle);
+        interceptor->count.fetch_add(1, std::memory_order_relaxed);
+        if (interceptor->order != nullptr) {
+            interceptor->order->push_back(interceptor->id);
+        }
+        return interceptor->cont;
+    }
+
+    static void postCall(void* handle, pubsub_interceptor_properties_t*, const char*, const uint32_t, const void*, const celix_properties_t*) {
+        auto* interceptor = static_cast<Interceptor*>(handle);
+        interceptor->count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void registerInterceptor(Interceptor& interceptor, long ranking = 0) {
+        interceptor.svc.handle = &interceptor;
+        interceptor.svc.preSend = preCall;
+        interceptor.svc.postSend = postCall;
+        interceptor.svc.preReceive = preCall;
+        interceptor.svc.postReceive = postCall;
+        auto* props = celix_properties_create();
+        celix_properties_setLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, ranking);
+        interceptor.svcId = celix_bundleContext_registerService(ctx.get(), &interceptor.svc, PUBSUB_INTERCEPTOR_SERVICE_NAME, props);
+    }
+
+    std::shared_ptr<celix_framework_t> fw{};
+    std::shared_ptr<celix_bundle_context_t> ctx{};
+};
+
+TEST_F(PubSubInterceptorsHandlerTestSuite, NoInterceptorsTest) {
+    pubsub_interceptors_handler_t* handler = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, pubsubInterceptorsHandler_create(ctx.get(), "scope", "topic", &handler));
+
+    celix_properties_t* metadata = nullptr;
+    EXPECT_TRUE(pubsubInterceptorHandler_invokePreSend(handler, "msg", 1, nullptr, &metadata));
+    EXPECT_TRUE(pubsubInterceptorHandler_invokePreReceive(handler, "msg", 1, nullptr, &metadata));
+    EXPECT_EQ(nullptr, metadata); //no metadata created if there are no interceptors
+
+    pubsubInterceptorsHandler_destroy(handler);
+}
+
+TEST_F(PubSubInterceptorsHandlerTestSuite, InvokeOrderTest) {
+    pubsub_interceptors_handler_t* handler = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, pubsubInterceptorsHandler_create(ctx.get(), "scope", "topic", &handler));
+
+    std::vector<int> order{};
+    Interceptor low{};
+    low.id = 1;
+    low.order = &order;
+    Interceptor high{};
+    high.id = 2;
+    high.order = &order;
+    registerInterceptor(low, 0);
+    registerInterceptor(high, 10);
+
+    celix_properties_t* metadata = nullptr;
+    EXPECT_TRUE(pubsubInterceptorHandler_invokePreSend(handler, "msg", 1, nullptr, &metadata));
+    EXPECT_NE(nullptr, metadata);
+    EXPECT_TRUE(pubsubInterceptorHandler_invokePreReceive(handler, "msg", 1, nullptr, &metadata));
+    //send is intercepted starting with the highest ranking, receive starting with the lowest ranking
+    EXPECT_EQ((std::vector<int>{2, 1, 1, 2}), order);
+
+    //a pre send returning false stops the chain
+    order.clear();
+    high.cont = false;
+    EXPECT_FALSE(pubsubInterceptorHandler_invokePreSend(handler, "msg", 1, nullptr, &metadata));
+    EXPECT_EQ((std::vector<int>{2}), order);
+    high.cont = true;
+
+    pubsubInterceptorHandler_invokePostSend(handler, "msg", 1, nullptr, metadata);
+    pubsubInterceptorHandler_invokePostReceive(handler, "msg", 1, nullptr, metadata);
+    EXPECT_EQ(4, low.count);
+    EXPECT_EQ(5, high.count);
+
+    celix_bundleContext_unregisterService(ctx.get(), low.svcId);
+    order.clear();
+    EXPECT_TRUE(pubsubInterceptorHandler_invokePreSend(handler, "msg", 1, nullptr, &metadata));
+    EXPECT_EQ((std::vector<int>{2}), order);
+
+    celix_bundleContext_unregisterService(ctx.get(), high.svcId);
+    celix_properties_destroy(metadata);
+    pubsubInterceptorsHandler_destroy(handler);
+}
+
+TEST_F(PubSubInterceptorsHandlerTestSuite, UnregisterWhileInvokingTest) {
+    pubsub_interceptors_handler_t* handler = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, pubsubInterceptorsHandler_create(ctx.get(), "scope", "topic", &handler));
+
+    std::atomic<bool> running{true};
+    std::vector<std::thread> threads{};
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&]{
+            celix_properties_t* metadata = celix_properties_create();
+            while (running) {
+                pubsubInterceptorHandler_invokePreSend(handler, "msg", 1, nullptr, &metadata);
+                pubsubInterceptorHandler_invokePostSend(handler, "msg", 1, nullptr, metadata);
+            }
+            celix_properties_destroy(metadata);
+        });
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        Interceptor interceptor{};
+        registerInterceptor(interceptor);
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+        celix_bundleContext_unregisterService(ctx.get(), interceptor.svcId);
+        //after the unregister the interceptor is not called anymore
+        long count = interceptor.count;
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+        EXPECT_EQ(count, interceptor.count);
+    }
+
+    running = false;
+    for (auto& t : threads) {
+        t.join();
+    }
+    pubsubInterceptorsHandler_destroy(handler);
+}
+
+/**
+ * Measures the number of preSend/postSend invocations per second of 4 publishing threads, with 0, 1 and 5 interceptors.
+ */
+TEST_F(PubSubInterceptorsHandlerTestSuite, MultiThreadedPublish_Benchmark) {
+    pubsub_interceptors_handler_t* handler = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, pubsubInterceptorsHandler_create(ctx.get(), "scope", "topic", &handler));
+
+    const int nrOfThreads = 4;
+    const int count = 100000;
+    std::vector<std::unique_ptr<Interceptor>> interceptors{};
+    for (int nrOfInterceptors : {0, 1, 5}) {
+        while ((int)interceptors.size() < nrOfInterceptors) {
+            interceptors.emplace_back(new Interceptor{});
+            registerInterceptor(*interceptors.back());
+        }
+        for (auto& interceptor : interceptors) {
+            interceptor->count = 0;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads{};
+        for (int i = 0; i < nrOfThreads; ++i) {
+            threads.emplace_back([handler, count]{
+                celix_properties_t* metadata = nullptr;
+                for (int k = 0; k < count; ++k) {
+                    pubsubInterceptorHandler_invokePreSend(handler, "msg", 1, nullptr, &metadata);
+                    pubsubInterceptorHandler_invokePostSend(handler, "msg", 1, nullptr, metadata);
+                }
+                celix_properties_destroy(metadata);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        std::cout << nrOfThreads << " threads publishing " << count << " msgs each with " << nrOfInterceptors
+                  << " interceptor(s) took " << total / 1000 << " µs (" << (long)(nrOfThreads * count * 1e9 / total) << " msgs/s)\n";
+        for (auto& interceptor : interceptors) {
+            EXPECT_EQ(2 * nrOfThreads * count, interceptor->count);
+        }
+    }
+    for (auto& interceptor : interceptors) {
+        celix_bundleContext_unregisterService(ctx.get(), interceptor->svcId);
+    }
+    pubsubInterceptorsHandler_destroy(handler);
+}
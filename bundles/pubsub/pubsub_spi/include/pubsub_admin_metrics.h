@@ -21,13 +21,50 @@
 #define PUBSUB_ADMIN_METRICS_H_
 
 #include <uuid/uuid.h>
+#include <stdint.h>
+#include <time.h>
 #include <sys/time.h>
 #include "celix_array_list.h"
+#include "celix_properties.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #define PUBSUB_ADMIN_METRICS_SERVICE_NAME   "pubsub_admin_metrics"
 
 #define PUBSUB_AMDIN_METRICS_NAME_MAX       1024
 
+/**
+ * Metadata entries added by a topic sender if metrics are enabled for the PSA.
+ * The origin is the framework UUID of the sender and is used by a topic receiver to keep track of the metrics per
+ * origin. The send time is the CLOCK_REALTIME time in nanoseconds since the epoch and is used to measure the
+ * end-to-end delay. Note that the delay is only reliable if the clocks of the sender and receiver are synchronized.
+ */
+#define PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY    "celix.pubsub.origin"
+#define PUBSUB_ADMIN_METRICS_SEND_TIME_KEY      "celix.pubsub.send_time"
+
+/**
+ * Maximum number of origins a topic receiver keeps metrics for per message type. Messages of further origins are
+ * counted for the null UUID origin.
+ */
+#define PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS  64
+
+/**
+ * Summary of a latency histogram. All values are 0 if no values are recorded.
+ * The percentiles are accurate to within ~3% of the real value.
+ */
+typedef struct pubsub_admin_metrics_latency {
+    unsigned long count;
+    double minInSeconds;
+    double maxInSeconds;
+    double averageInSeconds;
+    double p50InSeconds;
+    double p90InSeconds;
+    double p99InSeconds;
+    double p999InSeconds;
+} pubsub_admin_metrics_latency_t;
+
 typedef struct pubsub_admin_sender_msg_type_metrics {
     long bndId;
     char typeFqn[PUBSUB_AMDIN_METRICS_NAME_MAX];
@@ -38,6 +75,7 @@ typedef struct pubsub_admin_sender_msg_type_metrics {
     struct timespec lastMessageSend;
     double averageTimeBetweenMessagesInSeconds;
     double averageSerializationTimeInSeconds;
+    pubsub_admin_metrics_latency_t serializationTime;
 } pubsub_admin_sender_msg_type_metrics_t;
 
 typedef struct pubsub_admin_sender_metrics {
@@ -51,12 +89,15 @@ typedef struct pubsub_admin_sender_metrics {
 typedef struct pubsub_admin_receiver_metrics {
     char scope[PUBSUB_AMDIN_METRICS_NAME_MAX];
     char topic[PUBSUB_AMDIN_METRICS_NAME_MAX];
+    unsigned long nrOfQueuedMessages; //nr of messages waiting in the subscriber queues (if the PSA queues messages)
+    unsigned long maxNrOfQueuedMessages; //highest nr of messages waiting in a subscriber queue
+    unsigned long nrOfDroppedMessages; //nr of messages dropped, because a subscriber queue was full
     unsigned long nrOfMsgTypes;
     struct {
         unsigned int typeId;
         char typeFqn[PUBSUB_AMDIN_METRICS_NAME_MAX];
         int nrOfOrigins;
-        struct {
+        struct pubsub_admin_receiver_origin_metrics {
             uuid_t originUUID;
             unsigned long nrOfMessagesReceived;
             unsigned long nrOfSerializationErrors;
@@ -67,6 +108,8 @@ typedef struct pubsub_admin_receiver_metrics {
             double averageDelayInSeconds;
             double minDelayInSeconds;
             double maxDelayInSeconds;
+            pubsub_admin_metrics_latency_t serializationTime;
+            pubsub_admin_metrics_latency_t delay; //only available if the sender adds the send time metadata entry
         } *origins;
     } *msgTypes;
 } pubsub_admin_receiver_metrics_t;
@@ -99,8 +142,131 @@ struct pubsub_admin_metrics_service {
 
 void pubsub_freePubSubAdminMetrics(pubsub_admin_metrics_t *metrics);
 
+/**
+ * A HDR-style (log-linear) latency histogram. Values are recorded with nanosecond resolution in buckets which
+ * are ~3% wide, up to ~36 minutes. Recording is lock free (atomic counters), so a histogram can be updated from
+ * multiple threads and summarized concurrently.
+ */
+typedef struct pubsub_admin_metrics_histogram pubsub_admin_metrics_histogram_t;
+
+pubsub_admin_metrics_histogram_t* pubsub_metricsHistogram_create(void);
+void pubsub_metricsHistogram_destroy(pubsub_admin_metrics_histogram_t *hist);
+
+/**
+ * Records a value. Negative values (e.g. a delay measured with unsynchronized clocks) are recorded as 0.
+ */
+void pubsub_metricsHistogram_record(pubsub_admin_metrics_histogram_t *hist, double valueInSeconds);
+
+/**
+ * Returns the (approximated) value at the provided percentile (0 - 100) in seconds or 0 if no values are recorded.
+ */
+double pubsub_metricsHistogram_valueAtPercentile(const pubsub_admin_metrics_histogram_t *hist, double percentile);
+
+void pubsub_metricsHistogram_summary(const pubsub_admin_metrics_histogram_t *hist, pubsub_admin_metrics_latency_t *summary);
+
+/**
+ * Returns the time in nanoseconds, so that times can be stored in metrics updated using atomics.
+ */
+static inline int64_t pubsub_metrics_timespecToNs(const struct timespec *ts) {
+    return (int64_t)ts->tv_sec * 1000000000 + ts->tv_nsec;
+}
+
+/**
+ * The send metrics of a single message type of a topic sender.
+ * All fields are updated using atomics, so that sending threads do not contend on a metrics lock.
+ */
+typedef struct pubsub_admin_metrics_send_counters {
+    unsigned long nrOfMessagesSend;
+    unsigned long nrOfMessagesSendFailed;
+    unsigned long nrOfSerializationErrors;
+    int64_t firstMessageSendInNs;
+    int64_t lastMessageSendInNs;
+    pubsub_admin_metrics_histogram_t *serializationTime;
+} pubsub_admin_metrics_send_counters_t;
+
+void pubsub_metricsSendCounters_init(pubsub_admin_metrics_send_counters_t *counters);
+void pubsub_metricsSendCounters_deinit(pubsub_admin_metrics_send_counters_t *counters);
+
+/**
+ * Updates the send metrics for a send attempt.
+ * @param serializationStart The serialization start time or NULL if the msg is not serialized.
+ * @param sendTime The send time, i.e. the serialization end time.
+ */
+void pubsub_metricsSendCounters_update(pubsub_admin_metrics_send_counters_t *counters,
+                                       const struct timespec *serializationStart,
+                                       const struct timespec *sendTime,
+                                       int nrOfMessagesSend,
+                                       int nrOfMessagesSendFailed,
+                                       int nrOfSerializationErrors);
+
+/**
+ * Fills the counters, serialization time and (average) send times of the msg type metrics.
+ * The bndId, typeId and typeFqn are not touched.
+ */
+void pubsub_metricsSendCounters_fill(const pubsub_admin_metrics_send_counters_t *counters,
+                                     pubsub_admin_sender_msg_type_metrics_t *out);
+
+/**
+ * Adds the PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY and PUBSUB_ADMIN_METRICS_SEND_TIME_KEY metadata entries.
+ * Creates the metadata if metadata is NULL.
+ * @return The (created) metadata.
+ */
+celix_properties_t* pubsub_metrics_addSendMetadata(celix_properties_t *metadata, const char *originUUID, const struct timespec *sendTime);
+
+/**
+ * Gets the origin (or NULL) and send time in nanoseconds (or 0) from the metadata added with
+ * pubsub_metrics_addSendMetadata. The metadata can be NULL.
+ */
+void pubsub_metrics_getSendMetadata(const celix_properties_t *metadata, const char **originUUID, int64_t *sendTimeInNs);
+
+/**
+ * The receive metrics of a topic receiver per message type and origin.
+ * Messages without an origin, or of an origin above the PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS limit, are counted
+ * for the null UUID origin.
+ *
+ * Updates are thread safe. The counters are updated using atomics and a (write) lock is only taken to add a
+ * message type or origin.
+ */
+typedef struct pubsub_admin_metrics_receive_counters pubsub_admin_metrics_receive_counters_t;
+
+pubsub_admin_metrics_receive_counters_t* pubsub_metricsReceiveCounters_create(void);
+void pubsub_metricsReceiveCounters_destroy(pubsub_admin_metrics_receive_counters_t *counters);
+
+/**
+ * Updates the receive metrics for a received message.
+ * @param msgFqn The fully qualified name of the msg type, only used the first time a msg type is updated.
+ * @param originUUID The origin (framework UUID) of the sender or NULL if unknown.
+ * @param sendTimeInNs The send time (CLOCK_REALTIME) or 0 if unknown, used for the delay.
+ * @param seqNr The sequence number of the message or NULL if the protocol has no sequence numbers,
+ *              used to count the missing messages.
+ * @param serializationStart/serializationEnd The deserialization start/end time or NULL if the message is not
+ *              deserialized.
+ */
+void pubsub_metricsReceiveCounters_update(pubsub_admin_metrics_receive_counters_t *counters,
+                                          unsigned int msgTypeId,
+                                          const char *msgFqn,
+                                          const char *originUUID,
+                                          int64_t sendTimeInNs,
+                                          const unsigned int *seqNr,
+                                          const struct timespec *receiveTime,
+                                          const struct timespec *serializationStart,
+                                          const struct timespec *serializationEnd,
+                                          int nrOfMessagesReceived,
+                                          int nrOfSerializationErrors);
+
+/**
+ * Fills the nrOfMsgTypes and msgTypes of the receiver metrics. The msgTypes are allocated and should be released
+ * with pubsub_freePubSubAdminMetrics.
+ */
+void pubsub_metricsReceiveCounters_fill(pubsub_admin_metrics_receive_counters_t *counters,
+                                        pubsub_admin_receiver_metrics_t *out);
+
 typedef struct pubsub_admin_metrics_service pubsub_admin_metrics_service_t;
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* PUBSUB_ADMIN_METRICS_H_ */
 
 
@@ -26,6 +26,10 @@
 #include "pubsub_interceptor.h"
 #include "celix_properties.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct pubsub_interceptors_handler pubsub_interceptors_handler_t;
 
 celix_status_t pubsubInterceptorsHandler_create(celix_bundle_context_t *ctx, const char *scope, const char *topic, pubsub_interceptors_handler_t **handler);
@@ -36,4 +40,8 @@ void pubsubInterceptorHandler_invokePostSend(pubsub_interceptors_handler_t *hand
 bool pubsubInterceptorHandler_invokePreReceive(pubsub_interceptors_handler_t *handler, const char *messageType, const uint32_t messageId, const void *message, celix_properties_t **metadata);
 void pubsubInterceptorHandler_invokePostReceive(pubsub_interceptors_handler_t *handler, const char *messageType, const uint32_t messageId, const void *message, celix_properties_t *metadata);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif //PUBSUB_INTERCEPTORS_HANDLER_H
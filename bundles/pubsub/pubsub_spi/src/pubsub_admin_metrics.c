@@ -22,9 +22,29 @@
 #else
 #include <malloc.h>
 #endif
-#include <pubsub_admin_metrics.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "celix_threads.h"
+#include "celix_utils.h"
+#include "hash_map.h"
+#include "utils.h"
 #include "pubsub_admin_metrics.h"
 
+#define HISTOGRAM_SUB_BUCKET_BITS   5
+#define HISTOGRAM_SUB_BUCKET_COUNT  (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_MAX_EXPONENT      40 //values >= 2^41 ns (~36 minutes) are counted in the last bucket
+#define HISTOGRAM_BUCKET_COUNT      ((HISTOGRAM_MAX_EXPONENT - HISTOGRAM_SUB_BUCKET_BITS + 2) * HISTOGRAM_SUB_BUCKET_COUNT)
+
+struct pubsub_admin_metrics_histogram {
+    //note all fields are updated using atomics
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[HISTOGRAM_BUCKET_COUNT];
+};
+
 void pubsub_freePubSubAdminMetrics(pubsub_admin_metrics_t *metrics) {
     if (metrics != NULL) {
         if (metrics->receivers != NULL) {
@@ -48,4 +68,379 @@ void pubsub_freePubSubAdminMetrics(pubsub_admin_metrics_t *metrics) {
         }
         free(metrics);
     }
-}
\ No newline at end of file
+}
+/**
+ * Values below 2^SUB_BUCKET_BITS get their own bucket, larger values are divided per power of 2 in
+ * SUB_BUCKET_COUNT linear sub buckets.
+ */
+static size_t pubsub_metricsHistogram_bucketIndex(uint64_t value) {
+    if (value < HISTOGRAM_SUB_BUCKET_COUNT) {
+        return (size_t)value;
+    }
+    int exponent = 63 - __builtin_clzll(value);
+    if (exponent > HISTOGRAM_MAX_EXPONENT) {
+        return HISTOGRAM_BUCKET_COUNT - 1;
+    }
+    size_t sub = (size_t)(value >> (exponent - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKET_COUNT - 1);
+    return (size_t)(exponent - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_COUNT + sub;
+}
+
+static uint64_t pubsub_metricsHistogram_bucketMidValue(size_t index) {
+    if (index < HISTOGRAM_SUB_BUCKET_COUNT) {
+        return index;
+    }
+    int exponent = (int)(index / HISTOGRAM_SUB_BUCKET_COUNT) + HISTOGRAM_SUB_BUCKET_BITS - 1;
+    uint64_t sub = index % HISTOGRAM_SUB_BUCKET_COUNT;
+    uint64_t width = 1ULL << (exponent - HISTOGRAM_SUB_BUCKET_BITS);
+    return (1ULL << exponent) + sub * width + width / 2;
+}
+
+pubsub_admin_metrics_histogram_t* pubsub_metricsHistogram_create(void) {
+    pubsub_admin_metrics_histogram_t *hist = calloc(1, sizeof(*hist));
+    hist->min = UINT64_MAX;
+    return hist;
+}
+
+void pubsub_metricsHistogram_destroy(pubsub_admin_metrics_histogram_t *hist) {
+    free(hist);
+}
+
+void pubsub_metricsHistogram_record(pubsub_admin_metrics_histogram_t *hist, double valueInSeconds) {
+    uint64_t value = valueInSeconds > 0 ? (uint64_t)(valueInSeconds * 1000000000.0) : 0;
+    __atomic_fetch_add(&hist->buckets[pubsub_metricsHistogram_bucketIndex(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->sum, value, __ATOMIC_RELAXED);
+    uint64_t current = __atomic_load_n(&hist->min, __ATOMIC_RELAXED);
+    while (value < current && !__atomic_compare_exchange_n(&hist->min, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        //retry with updated current
+    }
+    current = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while (value > current && !__atomic_compare_exchange_n(&hist->max, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        //retry with updated current
+    }
+    __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELEASE);
+}
+
+double pubsub_metricsHistogram_valueAtPercentile(const pubsub_admin_metrics_histogram_t *hist, double percentile) {
+    uint64_t count = __atomic_load_n(&hist->count, __ATOMIC_ACQUIRE);
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t min = __atomic_load_n(&hist->min, __ATOMIC_RELAXED);
+    uint64_t max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    double fraction = percentile < 0 ? 0 : (percentile > 100 ? 1 : percentile / 100.0);
+    uint64_t target = (uint64_t)(fraction * (double)count);
+    if (target == 0 || (double)target < fraction * (double)count) {
+        target += 1;
+    }
+    uint64_t value = max;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+        seen += __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+        if (seen >= target) {
+            //note the last bucket also counts all larger values, so use the max for that bucket
+            value = i == HISTOGRAM_BUCKET_COUNT - 1 ? max : pubsub_metricsHistogram_bucketMidValue(i);
+            break;
+        }
+    }
+    //the exact min/max are known, so clamp the bucket approximation
+    if (value < min) {
+        value = min;
+    } else if (value > max) {
+        value = max;
+    }
+    return (double)value / 1000000000.0;
+}
+
+void pubsub_metricsHistogram_summary(const pubsub_admin_metrics_histogram_t *hist, pubsub_admin_metrics_latency_t *summary) {
+    uint64_t count = __atomic_load_n(&hist->count, __ATOMIC_ACQUIRE);
+    summary->count = (unsigned long)count;
+    if (count == 0) {
+        summary->minInSeconds = 0;
+        summary->maxInSeconds = 0;
+        summary->averageInSeconds = 0;
+        summary->p50InSeconds = 0;
+        summary->p90InSeconds = 0;
+        summary->p99InSeconds = 0;
+        summary->p999InSeconds = 0;
+        return;
+    }
+    summary->minInSeconds = (double)__atomic_load_n(&hist->min, __ATOMIC_RELAXED) / 1000000000.0;
+    summary->maxInSeconds = (double)__atomic_load_n(&hist->max, __ATOMIC_RELAXED) / 1000000000.0;
+    summary->averageInSeconds = (double)__atomic_load_n(&hist->sum, __ATOMIC_RELAXED) / (double)count / 1000000000.0;
+    summary->p50InSeconds = pubsub_metricsHistogram_valueAtPercentile(hist, 50);
+    summary->p90InSeconds = pubsub_metricsHistogram_valueAtPercentile(hist, 90);
+    summary->p99InSeconds = pubsub_metricsHistogram_valueAtPercentile(hist, 99);
+    summary->p999InSeconds = pubsub_metricsHistogram_valueAtPercentile(hist, 99.9);
+}
+
+void pubsub_metricsSendCounters_init(pubsub_admin_metrics_send_counters_t *counters) {
+    memset(counters, 0, sizeof(*counters));
+    counters->serializationTime = pubsub_metricsHistogram_create();
+}
+
+void pubsub_metricsSendCounters_deinit(pubsub_admin_metrics_send_counters_t *counters) {
+    pubsub_metricsHistogram_destroy(counters->serializationTime);
+    counters->serializationTime = NULL;
+}
+
+void pubsub_metricsSendCounters_update(pubsub_admin_metrics_send_counters_t *counters,
+                                       const struct timespec *serializationStart,
+                                       const struct timespec *sendTime,
+                                       int nrOfMessagesSend,
+                                       int nrOfMessagesSendFailed,
+                                       int nrOfSerializationErrors) {
+    if (serializationStart != NULL && counters->serializationTime != NULL) {
+        pubsub_metricsHistogram_record(counters->serializationTime, celix_difftime(serializationStart, sendTime));
+    }
+    int64_t sendTimeInNs = pubsub_metrics_timespecToNs(sendTime);
+    int64_t noTime = 0;
+    __atomic_compare_exchange_n(&counters->firstMessageSendInNs, &noTime, sendTimeInNs, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    __atomic_store_n(&counters->lastMessageSendInNs, sendTimeInNs, __ATOMIC_RELAXED);
+    if (nrOfMessagesSend > 0) {
+        __atomic_fetch_add(&counters->nrOfMessagesSend, nrOfMessagesSend, __ATOMIC_RELAXED);
+    }
+    if (nrOfMessagesSendFailed > 0) {
+        __atomic_fetch_add(&counters->nrOfMessagesSendFailed, nrOfMessagesSendFailed, __ATOMIC_RELAXED);
+    }
+    if (nrOfSerializationErrors > 0) {
+        __atomic_fetch_add(&counters->nrOfSerializationErrors, nrOfSerializationErrors, __ATOMIC_RELAXED);
+    }
+}
+
+void pubsub_metricsSendCounters_fill(const pubsub_admin_metrics_send_counters_t *counters,
+                                     pubsub_admin_sender_msg_type_metrics_t *out) {
+    out->nrOfMessagesSend = __atomic_load_n(&counters->nrOfMessagesSend, __ATOMIC_RELAXED);
+    out->nrOfMessagesSendFailed = __atomic_load_n(&counters->nrOfMessagesSendFailed, __ATOMIC_RELAXED);
+    out->nrOfSerializationErrors = __atomic_load_n(&counters->nrOfSerializationErrors, __ATOMIC_RELAXED);
+    if (counters->serializationTime != NULL) {
+        pubsub_metricsHistogram_summary(counters->serializationTime, &out->serializationTime);
+    }
+    out->averageSerializationTimeInSeconds = out->serializationTime.averageInSeconds;
+    int64_t first = __atomic_load_n(&counters->firstMessageSendInNs, __ATOMIC_RELAXED);
+    int64_t last = __atomic_load_n(&counters->lastMessageSendInNs, __ATOMIC_RELAXED);
+    unsigned long n = out->nrOfMessagesSend + out->nrOfMessagesSendFailed + out->nrOfSerializationErrors;
+    if (n > 1) {
+        out->averageTimeBetweenMessagesInSeconds = (double)(last - first) / (double)(n - 1) / 1000000000.0;
+    }
+    out->lastMessageSend.tv_sec = (time_t)(last / 1000000000);
+    out->lastMessageSend.tv_nsec = (long)(last % 1000000000);
+}
+
+celix_properties_t* pubsub_metrics_addSendMetadata(celix_properties_t *metadata, const char *originUUID, const struct timespec *sendTime) {
+    if (metadata == NULL) {
+        metadata = celix_properties_create();
+    }
+    celix_properties_set(metadata, PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY, originUUID);
+    celix_properties_setLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIME_KEY, pubsub_metrics_timespecToNs(sendTime));
+    return metadata;
+}
+
+void pubsub_metrics_getSendMetadata(const celix_properties_t *metadata, const char **originUUID, int64_t *sendTimeInNs) {
+    *originUUID = NULL;
+    *sendTimeInNs = 0;
+    if (metadata != NULL) {
+        *originUUID = celix_properties_get(metadata, PUBSUB_ADMIN_METRICS_ORIGIN_UUID_KEY, NULL);
+        *sendTimeInNs = celix_properties_getAsLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIME_KEY, 0);
+    }
+}
+
+typedef struct pubsub_admin_metrics_origin_entry {
+    uuid_t origin;
+
+    //note updated using atomics
+    unsigned long nrOfMessagesReceived;
+    unsigned long nrOfSerializationErrors;
+    unsigned long nrOfMissingSeqNumbers;
+    unsigned int lastSeqNr;
+    int64_t firstMessageReceivedInNs;
+    int64_t lastMessageReceivedInNs;
+    pubsub_admin_metrics_histogram_t *serializationTime;
+    pubsub_admin_metrics_histogram_t *delay;
+} pubsub_admin_metrics_origin_entry_t;
+
+typedef struct pubsub_admin_metrics_msg_type_entry {
+    unsigned int typeId;
+    char *typeFqn;
+    hash_map_t *origins; //key = origin uuid string, value = pubsub_admin_metrics_origin_entry_t*
+} pubsub_admin_metrics_msg_type_entry_t;
+
+struct pubsub_admin_metrics_receive_counters {
+    celix_thread_rwlock_t lock; //write locked when adding msg types or origins, read locked otherwise
+    hash_map_t *msgTypes; //key = msg type id, value = pubsub_admin_metrics_msg_type_entry_t*
+};
+
+pubsub_admin_metrics_receive_counters_t* pubsub_metricsReceiveCounters_create(void) {
+    pubsub_admin_metrics_receive_counters_t *counters = calloc(1, sizeof(*counters));
+    if (counters != NULL) {
+        celixThreadRwlock_create(&counters->lock, NULL);
+        counters->msgTypes = hashMap_create(NULL, NULL, NULL, NULL);
+    }
+    return counters;
+}
+
+void pubsub_metricsReceiveCounters_destroy(pubsub_admin_metrics_receive_counters_t *counters) {
+    if (counters == NULL) {
+        return;
+    }
+    hash_map_iterator_t iter = hashMapIterator_construct(counters->msgTypes);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_admin_metrics_msg_type_entry_t *msgType = hashMapIterator_nextValue(&iter);
+        hash_map_iterator_t iter2 = hashMapIterator_construct(msgType->origins);
+        while (hashMapIterator_hasNext(&iter2)) {
+            pubsub_admin_metrics_origin_entry_t *entry = hashMapIterator_nextValue(&iter2);
+            pubsub_metricsHistogram_destroy(entry->serializationTime);
+            pubsub_metricsHistogram_destroy(entry->delay);
+            free(entry);
+        }
+        hashMap_destroy(msgType->origins, true, false);
+        free(msgType->typeFqn);
+        free(msgType);
+    }
+    hashMap_destroy(counters->msgTypes, false, false);
+    celixThreadRwlock_destroy(&counters->lock);
+    free(counters);
+}
+
+/**
+ * Returns the origin entry for the msg type and origin, adds them if needed.
+ * The lock is only write locked to add a msg type or origin.
+ */
+static pubsub_admin_metrics_origin_entry_t* pubsub_metricsReceiveCounters_getEntry(pubsub_admin_metrics_receive_counters_t *counters,
+                                                                                   unsigned int msgTypeId,
+                                                                                   const char *msgFqn,
+                                                                                   const char *origin) {
+    pubsub_admin_metrics_origin_entry_t *entry = NULL;
+    celixThreadRwlock_readLock(&counters->lock);
+    pubsub_admin_metrics_msg_type_entry_t *msgType = hashMap_get(counters->msgTypes, (void*)(uintptr_t)msgTypeId);
+    if (msgType != NULL) {
+        entry = hashMap_get(msgType->origins, origin);
+    }
+    celixThreadRwlock_unlock(&counters->lock);
+    if (entry != NULL) {
+        return entry;
+    }
+
+    celixThreadRwlock_writeLock(&counters->lock);
+    msgType = hashMap_get(counters->msgTypes, (void*)(uintptr_t)msgTypeId);
+    if (msgType == NULL) {
+        msgType = calloc(1, sizeof(*msgType));
+        if (msgType != NULL) {
+            msgType->typeId = msgTypeId;
+            msgType->typeFqn = strndup(msgFqn == NULL ? "" : msgFqn, PUBSUB_AMDIN_METRICS_NAME_MAX);
+            msgType->origins = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+            hashMap_put(counters->msgTypes, (void*)(uintptr_t)msgTypeId, msgType);
+        }
+    }
+    if (msgType != NULL) {
+        if (hashMap_size(msgType->origins) >= PUBSUB_ADMIN_METRICS_MAX_NR_OF_ORIGINS && !hashMap_containsKey(msgType->origins, origin)) {
+            origin = "";
+        }
+        entry = hashMap_get(msgType->origins, origin);
+        if (entry == NULL) {
+            entry = calloc(1, sizeof(*entry));
+            if (entry != NULL) {
+                if (uuid_parse(origin, entry->origin) != 0) {
+                    uuid_clear(entry->origin);
+                }
+                entry->serializationTime = pubsub_metricsHistogram_create();
+                entry->delay = pubsub_metricsHistogram_create();
+                hashMap_put(msgType->origins, strndup(origin, UUID_STR_LEN + 1), entry);
+            }
+        }
+    }
+    celixThreadRwlock_unlock(&counters->lock);
+    return entry;
+}
+
+void pubsub_metricsReceiveCounters_update(pubsub_admin_metrics_receive_counters_t *counters,
+                                          unsigned int msgTypeId,
+                                          const char *msgFqn,
+                                          const char *originUUID,
+                                          int64_t sendTimeInNs,
+                                          const unsigned int *seqNr,
+                                          const struct timespec *receiveTime,
+                                          const struct timespec *serializationStart,
+                                          const struct timespec *serializationEnd,
+                                          int nrOfMessagesReceived,
+                                          int nrOfSerializationErrors) {
+    pubsub_admin_metrics_origin_entry_t *entry = pubsub_metricsReceiveCounters_getEntry(counters, msgTypeId, msgFqn, originUUID == NULL ? "" : originUUID);
+    if (entry == NULL) {
+        return;
+    }
+
+    if (serializationStart != NULL && serializationEnd != NULL) {
+        pubsub_metricsHistogram_record(entry->serializationTime, celix_difftime(serializationStart, serializationEnd));
+    }
+    int64_t receiveTimeInNs = pubsub_metrics_timespecToNs(receiveTime);
+    if (sendTimeInNs > 0) {
+        pubsub_metricsHistogram_record(entry->delay, (double)(receiveTimeInNs - sendTimeInNs) / 1000000000.0);
+    }
+    int64_t noTime = 0;
+    bool first = __atomic_compare_exchange_n(&entry->firstMessageReceivedInNs, &noTime, receiveTimeInNs, false,
+                                             __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    if (seqNr != NULL) {
+        unsigned int lastSeqNr = __atomic_exchange_n(&entry->lastSeqNr, *seqNr, __ATOMIC_RELAXED);
+        unsigned int incr = *seqNr - lastSeqNr;
+        if (!first && incr > 1 && incr < UINT32_MAX / 2) { //note a large increment is a restarted publisher
+            __atomic_fetch_add(&entry->nrOfMissingSeqNumbers, incr - 1, __ATOMIC_RELAXED);
+        }
+    }
+    __atomic_store_n(&entry->lastMessageReceivedInNs, receiveTimeInNs, __ATOMIC_RELAXED);
+    if (nrOfMessagesReceived > 0) {
+        __atomic_fetch_add(&entry->nrOfMessagesReceived, nrOfMessagesReceived, __ATOMIC_RELAXED);
+    }
+    if (nrOfSerializationErrors > 0) {
+        __atomic_fetch_add(&entry->nrOfSerializationErrors, nrOfSerializationErrors, __ATOMIC_RELAXED);
+    }
+}
+
+static void pubsub_metricsReceiveCounters_fillOrigin(const pubsub_admin_metrics_origin_entry_t *entry,
+                                                     struct pubsub_admin_receiver_origin_metrics *out) {
+    uuid_copy(out->originUUID, entry->origin);
+    out->nrOfMessagesReceived = __atomic_load_n(&entry->nrOfMessagesReceived, __ATOMIC_RELAXED);
+    out->nrOfSerializationErrors = __atomic_load_n(&entry->nrOfSerializationErrors, __ATOMIC_RELAXED);
+    out->nrOfMissingSeqNumbers = __atomic_load_n(&entry->nrOfMissingSeqNumbers, __ATOMIC_RELAXED);
+    pubsub_metricsHistogram_summary(entry->serializationTime, &out->serializationTime);
+    pubsub_metricsHistogram_summary(entry->delay, &out->delay);
+    out->averageSerializationTimeInSeconds = out->serializationTime.averageInSeconds;
+    out->averageDelayInSeconds = out->delay.averageInSeconds;
+    out->minDelayInSeconds = out->delay.minInSeconds;
+    out->maxDelayInSeconds = out->delay.maxInSeconds;
+    int64_t first = __atomic_load_n(&entry->firstMessageReceivedInNs, __ATOMIC_RELAXED);
+    int64_t last = __atomic_load_n(&entry->lastMessageReceivedInNs, __ATOMIC_RELAXED);
+    unsigned long n = out->nrOfMessagesReceived + out->nrOfSerializationErrors;
+    if (n > 1) {
+        out->averageTimeBetweenMessagesInSeconds = (double)(last - first) / (double)(n - 1) / 1000000000.0;
+    }
+    out->lastMessageReceived.tv_sec = (time_t)(last / 1000000000);
+    out->lastMessageReceived.tv_nsec = (long)(last % 1000000000);
+}
+
+void pubsub_metricsReceiveCounters_fill(pubsub_admin_metrics_receive_counters_t *counters,
+                                        pubsub_admin_receiver_metrics_t *out) {
+    celixThreadRwlock_readLock(&counters->lock);
+    out->nrOfMsgTypes = (unsigned long)hashMap_size(counters->msgTypes);
+    out->msgTypes = calloc(out->nrOfMsgTypes, sizeof(*out->msgTypes));
+    if (out->msgTypes == NULL) {
+        out->nrOfMsgTypes = 0;
+    }
+    unsigned long i = 0;
+    hash_map_iterator_t iter = hashMapIterator_construct(counters->msgTypes);
+    while (hashMapIterator_hasNext(&iter) && i < out->nrOfMsgTypes) {
+        pubsub_admin_metrics_msg_type_entry_t *msgType = hashMapIterator_nextValue(&iter);
+        out->msgTypes[i].typeId = msgType->typeId;
+        snprintf(out->msgTypes[i].typeFqn, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", msgType->typeFqn);
+        out->msgTypes[i].origins = calloc((size_t)hashMap_size(msgType->origins), sizeof(*out->msgTypes[i].origins));
+        if (out->msgTypes[i].origins != NULL) {
+            int k = 0;
+            hash_map_iterator_t iter2 = hashMapIterator_construct(msgType->origins);
+            while (hashMapIterator_hasNext(&iter2)) {
+                pubsub_admin_metrics_origin_entry_t *entry = hashMapIterator_nextValue(&iter2);
+                pubsub_metricsReceiveCounters_fillOrigin(entry, &out->msgTypes[i].origins[k++]);
+            }
+            out->msgTypes[i].nrOfOrigins = k;
+        }
+        i += 1;
+    }
+    celixThreadRwlock_unlock(&counters->lock);
+}
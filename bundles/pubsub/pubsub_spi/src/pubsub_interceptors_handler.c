@@ -16,6 +16,8 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <stdio.h>
+
 #include "celix_bundle_context.h"
 #include "celix_constants.h"
 #include "utils.h"
@@ -27,10 +29,29 @@ typedef struct entry {
     pubsub_interceptor_t *interceptor;
 } entry_t;
 
+/**
+ * Immutable sorted snapshot of the interceptors, used by the invoke functions without locking.
+ */
+typedef struct interceptors_snapshot {
+    uint32_t size;
+    entry_t entries[];
+} interceptors_snapshot_t;
+
 struct pubsub_interceptors_handler {
     pubsub_interceptor_properties_t properties;
 
-    celix_array_list_t *interceptors;
+    celix_array_list_t *interceptors; //protected by lock, entries = entry_t*
+
+    //Updated with atomics. The snapshot is replaced on every add/remove (under lock) and the old snapshot is freed
+    //after a grace period: when all invocations that started before the replacement are done.
+    //NULL if the snapshot could not be allocated, the invocations then lock the handler.
+    interceptors_snapshot_t *snapshot;
+    uint32_t nrOfInterceptors; //nr of interceptors, used as fast path when there are no interceptors
+    unsigned int epoch; //index of the activeInvocations counter used by new invocations
+    unsigned long activeInvocations[2];
+    unsigned long nrOfRetireWaiters; //nr of threads waiting in retireSnapshot (atomic)
+    celix_thread_mutex_t retireLock; //serializes retiring snapshots
+    celix_thread_cond_t retireCond; //signaled when the invocations of an epoch are done and there are waiters
 
     long interceptorsTrackerId;
 
@@ -57,8 +78,15 @@ celix_status_t pubsubInterceptorsHandler_create(celix_bundle_context_t *ctx, con
         (*handler)->properties.topic = topic;
 
         (*handler)->interceptors = celix_arrayList_create();
+        (*handler)->snapshot = calloc(1, sizeof(interceptors_snapshot_t));
 
         status = celixThreadMutex_create(&(*handler)->lock, NULL);
+        if (status == CELIX_SUCCESS) {
+            status = celixThreadMutex_create(&(*handler)->retireLock, NULL);
+        }
+        if (status == CELIX_SUCCESS) {
+            status = celixThreadCondition_init(&(*handler)->retireCond, NULL);
+        }
 
         if (status == CELIX_SUCCESS) {
             // Create service tracker here, and not in the activator
@@ -78,15 +106,107 @@ celix_status_t pubsubInterceptorsHandler_create(celix_bundle_context_t *ctx, con
 celix_status_t pubsubInterceptorsHandler_destroy(pubsub_interceptors_handler_t *handler) {
     celix_bundleContext_stopTracker(handler->ctx, handler->interceptorsTrackerId);
 
+    for (uint32_t i = 0; i < arrayList_size(handler->interceptors); i++) {
+        free(arrayList_get(handler->interceptors, i));
+    }
     celix_arrayList_destroy(handler->interceptors);
+    free(handler->snapshot);
     celixThreadMutex_destroy(&handler->lock);
+    celixThreadMutex_destroy(&handler->retireLock);
+    celixThreadCondition_destroy(&handler->retireCond);
     free(handler);
 
     return CELIX_SUCCESS;
 }
 
+/**
+ * Publishes a new snapshot of the (sorted) interceptors list and returns the replaced snapshot, which must be retired
+ * with pubsubInterceptorsHandler_retireSnapshot after handler->lock is unlocked.
+ * If the new snapshot cannot be allocated, the snapshot is set to NULL and the invocations lock the handler instead;
+ * the replaced snapshot cannot be kept, because it can contain a removed interceptor.
+ */
+static interceptors_snapshot_t* pubsubInterceptorsHandler_updateSnapshot(pubsub_interceptors_handler_t *handler) {
+    //NOTE handler->lock locked
+    uint32_t size = (uint32_t) arrayList_size(handler->interceptors);
+    interceptors_snapshot_t *snapshot = malloc(sizeof(*snapshot) + size * sizeof(entry_t));
+    if (snapshot != NULL) {
+        snapshot->size = size;
+        for (uint32_t i = 0; i < size; i++) {
+            entry_t *entry = arrayList_get(handler->interceptors, i);
+            snapshot->entries[i] = *entry;
+        }
+    } else {
+        fprintf(stderr, "[Error] Cannot allocate interceptors snapshot for topic %s, invocations will lock the interceptors\n",
+                handler->properties.topic);
+    }
+    interceptors_snapshot_t *old = __atomic_exchange_n(&handler->snapshot, snapshot, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&handler->nrOfInterceptors, size, __ATOMIC_SEQ_CST);
+    return old;
+}
+
+/**
+ * Waits until the replaced snapshot is no longer used and frees it, so that a removed interceptor is not called
+ * anymore when the remove callback returns. Called without handler->lock, so that invocations using the locked
+ * fallback are not blocked while waiting.
+ */
+static void pubsubInterceptorsHandler_retireSnapshot(pubsub_interceptors_handler_t *handler, interceptors_snapshot_t *old) {
+    celixThreadMutex_lock(&handler->retireLock);
+    __atomic_fetch_add(&handler->nrOfRetireWaiters, 1, __ATOMIC_SEQ_CST);
+    //An invocation which can still use the old snapshot has registered itself in one of the two activeInvocations
+    //counters. Wait until both counters are drained, flipping the epoch first so that new invocations (which use the
+    //new snapshot) register in the other counter and cannot keep the counter being waited for busy.
+    for (int i = 0; i < 2; i++) {
+        unsigned int oldEpoch = __atomic_fetch_xor(&handler->epoch, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&handler->activeInvocations[oldEpoch], __ATOMIC_SEQ_CST) > 0) {
+            celixThreadCondition_wait(&handler->retireCond, &handler->retireLock);
+        }
+    }
+    __atomic_fetch_sub(&handler->nrOfRetireWaiters, 1, __ATOMIC_SEQ_CST);
+    celixThreadMutex_unlock(&handler->retireLock);
+    free(old);
+}
+
+static void pubsubInterceptorsHandler_releaseEpoch(pubsub_interceptors_handler_t *handler, unsigned int epoch) {
+    if (__atomic_sub_fetch(&handler->activeInvocations[epoch], 1, __ATOMIC_SEQ_CST) == 0 &&
+        __atomic_load_n(&handler->nrOfRetireWaiters, __ATOMIC_SEQ_CST) > 0) {
+        //last invocation of the epoch and a snapshot is being retired -> wake up the retiring thread
+        celixThreadMutex_lock(&handler->retireLock);
+        celixThreadCondition_broadcast(&handler->retireCond);
+        celixThreadMutex_unlock(&handler->retireLock);
+    }
+}
+
+/**
+ * Starts an invocation and returns the number of interceptors to invoke. If there is no snapshot, handler->lock is
+ * locked instead and the interceptors list is used till the invocation ends.
+ */
+static uint32_t pubsubInterceptorsHandler_beginInvocation(pubsub_interceptors_handler_t *handler, interceptors_snapshot_t **snapshot, unsigned int *epoch) {
+    *epoch = __atomic_load_n(&handler->epoch, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&handler->activeInvocations[*epoch], 1, __ATOMIC_SEQ_CST);
+    *snapshot = __atomic_load_n(&handler->snapshot, __ATOMIC_SEQ_CST);
+    if (*snapshot != NULL) {
+        return (*snapshot)->size;
+    }
+    pubsubInterceptorsHandler_releaseEpoch(handler, *epoch);
+    celixThreadMutex_lock(&handler->lock);
+    return (uint32_t) arrayList_size(handler->interceptors);
+}
+
+static inline entry_t* pubsubInterceptorsHandler_getEntry(pubsub_interceptors_handler_t *handler, interceptors_snapshot_t *snapshot, uint32_t index) {
+    return snapshot != NULL ? &snapshot->entries[index] : arrayList_get(handler->interceptors, index);
+}
+
+static void pubsubInterceptorsHandler_endInvocation(pubsub_interceptors_handler_t *handler, interceptors_snapshot_t *snapshot, unsigned int epoch) {
+    if (snapshot != NULL) {
+        pubsubInterceptorsHandler_releaseEpoch(handler, epoch);
+    } else {
+        celixThreadMutex_unlock(&handler->lock);
+    }
+}
+
 void pubsubInterceptorsHandler_addInterceptor(void *handle, void *svc, const celix_properties_t *props) {
     pubsub_interceptors_handler_t *handler = handle;
+    interceptors_snapshot_t *old = NULL;
 
     celixThreadMutex_lock(&handler->lock);
 
@@ -104,39 +224,56 @@ void pubsubInterceptorsHandler_addInterceptor(void *handle, void *svc, const cel
         celix_arrayList_add(handler->interceptors, entry);
 
         celix_arrayList_sort(handler->interceptors, referenceCompare);
+        old = pubsubInterceptorsHandler_updateSnapshot(handler);
     }
 
     celixThreadMutex_unlock(&handler->lock);
+
+    if (!exists) {
+        pubsubInterceptorsHandler_retireSnapshot(handler, old);
+    }
 }
 
 void pubsubInterceptorsHandler_removeInterceptor(void *handle, void *svc, __attribute__((unused)) const celix_properties_t *props) {
     pubsub_interceptors_handler_t *handler = handle;
+    entry_t *removed = NULL;
+    interceptors_snapshot_t *old = NULL;
 
     celixThreadMutex_lock(&handler->lock);
 
     for (uint32_t i = 0; i < arrayList_size(handler->interceptors); i++) {
         entry_t *entry = arrayList_get(handler->interceptors, i);
         if (entry->interceptor == svc) {
-            void *old = arrayList_remove(handler->interceptors, i);
-            free(old);
+            removed = arrayList_remove(handler->interceptors, i);
+            old = pubsubInterceptorsHandler_updateSnapshot(handler);
             break;
         }
     }
 
     celixThreadMutex_unlock(&handler->lock);
+
+    if (removed != NULL) {
+        pubsubInterceptorsHandler_retireSnapshot(handler, old);
+        free(removed);
+    }
 }
 
 bool pubsubInterceptorHandler_invokePreSend(pubsub_interceptors_handler_t *handler, const char *messageType, const uint32_t messageId, const void *message, celix_properties_t **metadata) {
     bool cont = true;
+    if (__atomic_load_n(&handler->nrOfInterceptors, __ATOMIC_ACQUIRE) == 0) {
+        return cont;
+    }
 
-    celixThreadMutex_lock(&handler->lock);
+    unsigned int epoch;
+    interceptors_snapshot_t *snapshot;
+    uint32_t size = pubsubInterceptorsHandler_beginInvocation(handler, &snapshot, &epoch);
 
-    if (*metadata == NULL && arrayList_size(handler->interceptors) > 0) {
+    if (*metadata == NULL && size > 0) {
         *metadata = celix_properties_create();
     }
 
-    for (uint32_t i = arrayList_size(handler->interceptors); i > 0; i--) {
-        entry_t *entry = arrayList_get(handler->interceptors, i - 1);
+    for (uint32_t i = size; i > 0; i--) {
+        entry_t *entry = pubsubInterceptorsHandler_getEntry(handler, snapshot, i - 1);
 
         cont = entry->interceptor->preSend(entry->interceptor->handle, &handler->properties, messageType, messageId, message, *metadata);
         if (!cont) {
@@ -144,34 +281,45 @@ bool pubsubInterceptorHandler_invokePreSend(pubsub_interceptors_handler_t *handl
         }
     }
 
-    celixThreadMutex_unlock(&handler->lock);
+    pubsubInterceptorsHandler_endInvocation(handler, snapshot, epoch);
 
     return cont;
 }
 
 void pubsubInterceptorHandler_invokePostSend(pubsub_interceptors_handler_t *handler, const char *messageType, const uint32_t messageId, const void *message, celix_properties_t *metadata) {
-    celixThreadMutex_lock(&handler->lock);
+    if (__atomic_load_n(&handler->nrOfInterceptors, __ATOMIC_ACQUIRE) == 0) {
+        return;
+    }
+
+    unsigned int epoch;
+    interceptors_snapshot_t *snapshot;
+    uint32_t size = pubsubInterceptorsHandler_beginInvocation(handler, &snapshot, &epoch);
 
-    for (uint32_t i = arrayList_size(handler->interceptors); i > 0; i--) {
-        entry_t *entry = arrayList_get(handler->interceptors, i - 1);
+    for (uint32_t i = size; i > 0; i--) {
+        entry_t *entry = pubsubInterceptorsHandler_getEntry(handler, snapshot, i - 1);
 
         entry->interceptor->postSend(entry->interceptor->handle, &handler->properties, messageType, messageId, message, metadata);
     }
 
-    celixThreadMutex_unlock(&handler->lock);
+    pubsubInterceptorsHandler_endInvocation(handler, snapshot, epoch);
 }
 
 bool pubsubInterceptorHandler_invokePreReceive(pubsub_interceptors_handler_t *handler, const char *messageType, const uint32_t messageId, const void *message, celix_properties_t **metadata) {
     bool cont = true;
+    if (__atomic_load_n(&handler->nrOfInterceptors, __ATOMIC_ACQUIRE) == 0) {
+        return cont;
+    }
 
-    celixThreadMutex_lock(&handler->lock);
+    unsigned int epoch;
+    interceptors_snapshot_t *snapshot;
+    uint32_t size = pubsubInterceptorsHandler_beginInvocation(handler, &snapshot, &epoch);
 
-    if (*metadata == NULL && arrayList_size(handler->interceptors) > 0) {
+    if (*metadata == NULL && size > 0) {
         *metadata = celix_properties_create();
     }
 
-    for (uint32_t i = 0; i < arrayList_size(handler->interceptors); i++) {
-        entry_t *entry = arrayList_get(handler->interceptors, i);
+    for (uint32_t i = 0; i < size; i++) {
+        entry_t *entry = pubsubInterceptorsHandler_getEntry(handler, snapshot, i);
 
         cont = entry->interceptor->preReceive(entry->interceptor->handle, &handler->properties, messageType, messageId, message, *metadata);
         if (!cont) {
@@ -179,21 +327,27 @@ bool pubsubInterceptorHandler_invokePreReceive(pubsub_interceptors_handler_t *ha
         }
     }
 
-    celixThreadMutex_unlock(&handler->lock);
+    pubsubInterceptorsHandler_endInvocation(handler, snapshot, epoch);
 
     return cont;
 }
 
 void pubsubInterceptorHandler_invokePostReceive(pubsub_interceptors_handler_t *handler, const char *messageType, const uint32_t messageId, const void *message, celix_properties_t *metadata) {
-    celixThreadMutex_lock(&handler->lock);
+    if (__atomic_load_n(&handler->nrOfInterceptors, __ATOMIC_ACQUIRE) == 0) {
+        return;
+    }
 
-    for (uint32_t i = 0; i < arrayList_size(handler->interceptors); i++) {
-        entry_t *entry = arrayList_get(handler->interceptors, i);
+    unsigned int epoch;
+    interceptors_snapshot_t *snapshot;
+    uint32_t size = pubsubInterceptorsHandler_beginInvocation(handler, &snapshot, &epoch);
+
+    for (uint32_t i = 0; i < size; i++) {
+        entry_t *entry = pubsubInterceptorsHandler_getEntry(handler, snapshot, i);
 
         entry->interceptor->postReceive(entry->interceptor->handle, &handler->properties, messageType, messageId, message, metadata);
     }
 
-    celixThreadMutex_unlock(&handler->lock);
+    pubsubInterceptorsHandler_endInvocation(handler, snapshot, epoch);
 }
 
 int referenceCompare(const void *a, const void *b) {
@@ -1285,6 +1285,13 @@ static void fetchBundleName(void *handle, const bundle_t *bundle) {
     *out = celix_bundle_getSymbolicName(bundle);
 }
 
+static void pubsub_topologyManager_printLatency(FILE *os, const char *name, const pubsub_admin_metrics_latency_t *latency) {
+    if (latency->count > 0) {
+        fprintf(os, "      |- %s p50/p90/p99/p99.9/max = %f/%f/%f/%f/%f s\n", name, latency->p50InSeconds,
+                latency->p90InSeconds, latency->p99InSeconds, latency->p999InSeconds, latency->maxInSeconds);
+    }
+}
+
 static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *manager, const char *commandLine __attribute__((unused)), FILE *os, FILE *errorStream __attribute__((unused))) {
     celix_array_list_t *psaMetrics = celix_arrayList_create();
     celixThreadMutex_lock(&manager->psaMetrics.mutex);
@@ -1307,13 +1314,14 @@ static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *
                     continue;
                 }
                 const char *bndName = NULL;
-                celix_bundleContext_useBundle(manager->context, sm->msgMetrics->bndId, &bndName, fetchBundleName);
-                fprintf(os, "   |- Message '%s' from bundle '%s' (%li):\n", sm->msgMetrics[j].typeFqn, bndName, sm->msgMetrics->bndId);
+                celix_bundleContext_useBundle(manager->context, sm->msgMetrics[j].bndId, &bndName, fetchBundleName);
+                fprintf(os, "   |- Message '%s' from bundle '%s' (%li):\n", sm->msgMetrics[j].typeFqn, bndName, sm->msgMetrics[j].bndId);
                 fprintf(os, "      |- msg type = 0x%X\n", sm->msgMetrics[j].typeId);
                 fprintf(os, "      |- send count = %li\n", sm->msgMetrics[j].nrOfMessagesSend);
                 fprintf(os, "      |- fail count = %li\n", sm->msgMetrics[j].nrOfMessagesSendFailed);
                 fprintf(os, "      |- serialization failed = %li\n", sm->msgMetrics[j].nrOfSerializationErrors);
                 fprintf(os, "      |- average serialization time = %f s\n", sm->msgMetrics[j].averageSerializationTimeInSeconds);
+                pubsub_topologyManager_printLatency(os, "serialization time", &sm->msgMetrics[j].serializationTime);
                 fprintf(os, "      |- average time between messages = %f s\n", sm->msgMetrics[j].averageTimeBetweenMessagesInSeconds);
                 //TODO last msg send
             }
@@ -1321,6 +1329,11 @@ static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *
         for (int k = 0; k < celix_arrayList_size(metrics->receivers); ++k) {
             pubsub_admin_receiver_metrics_t *rm = celix_arrayList_get(metrics->receivers, k);
             fprintf(os, "|- Topic Receiver %s/%s:\n", rm->scope, rm->topic);
+            if (rm->maxNrOfQueuedMessages > 0 || rm->nrOfDroppedMessages > 0) {
+                fprintf(os, "   |- queued messages = %lu\n", rm->nrOfQueuedMessages);
+                fprintf(os, "   |- max queued messages = %lu\n", rm->maxNrOfQueuedMessages);
+                fprintf(os, "   |- dropped messages = %lu\n", rm->nrOfDroppedMessages);
+            }
             for (int j = 0; j < rm->nrOfMsgTypes; ++j) {
                 int nrOfOrigins = rm->msgTypes[j].nrOfOrigins;
                 for (int m = 0; m < nrOfOrigins; ++m) {
@@ -1339,6 +1352,8 @@ static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *
                     fprintf(os, "      |- max delay = %fs\n", rm->msgTypes[j].origins[m].maxDelayInSeconds);
                     fprintf(os, "      |- min delay = %fs\n", rm->msgTypes[j].origins[m].minDelayInSeconds);
                     fprintf(os, "      |- average serialization time = %fs\n", rm->msgTypes[j].origins[m].averageSerializationTimeInSeconds);
+                    pubsub_topologyManager_printLatency(os, "serialization time", &rm->msgTypes[j].origins[m].serializationTime);
+                    pubsub_topologyManager_printLatency(os, "delay", &rm->msgTypes[j].origins[m].delay);
                     fprintf(os, "      |- average time between messages time = %fs\n", rm->msgTypes[j].origins[m].averageTimeBetweenMessagesInSeconds);
                 }
             }
@@ -136,6 +136,31 @@ extern "C" {
         ASSERT_TRUE(ok);
     };
 
+    static void testAsyncCalculator(void *handle __attribute__((unused)), void *svc) {
+        auto *tst = static_cast<tst_service_t *>(svc);
+
+        bool discovered = tst->isCalcDiscovered(tst->handle);
+        ASSERT_TRUE(discovered);
+
+        bool ok = tst->testAsyncCalculator(tst->handle);
+        ASSERT_TRUE(ok);
+    };
+
+    static void benchmarkCalculator(void *handle __attribute__((unused)), void *svc) {
+        auto *tst = static_cast<tst_service_t *>(svc);
+
+        bool discovered = tst->isCalcDiscovered(tst->handle);
+        ASSERT_TRUE(discovered);
+
+        for (int nrOfThreads : {1, 8, 32}) {
+            double syncCalls = tst->benchmarkCalculator(tst->handle, nrOfThreads, 100, false);
+            double asyncCalls = tst->benchmarkCalculator(tst->handle, nrOfThreads, 100, true);
+            ASSERT_GT(syncCalls, 0.0);
+            ASSERT_GT(asyncCalls, 0.0);
+            printf("Remote calculator with %i client thread(s): %.0f calls/s, pipelined async: %.0f calls/s\n", nrOfThreads, syncCalls, asyncCalls);
+        }
+    };
+
     static void testCreateDestroyComponentWithRemoteService(void *handle __attribute__((unused)), void *svc) {
         auto *tst = static_cast<tst_service_t *>(svc);
         bool ok = tst->testCreateDestroyComponentWithRemoteService(tst->handle);
@@ -177,6 +202,14 @@ TEST_F(RsaDfiClientServerTests, TestRemoteCalculator) {
     test(testCalculator);
 }
 
+TEST_F(RsaDfiClientServerTests, TestRemoteAsyncCalculator) {
+    test(testAsyncCalculator);
+}
+
+TEST_F(RsaDfiClientServerTests, DISABLED_BenchmarkRemoteCalculatorCalls) {
+    test(benchmarkCalculator);
+}
+
 TEST_F(RsaDfiClientServerTests, TestRemoteComplex) {
     test(testComplex);
 }
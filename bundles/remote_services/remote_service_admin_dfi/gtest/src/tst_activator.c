@@ -26,8 +26,11 @@
 #include "tst_service.h"
 #include "calculator_service.h"
 #include "remote_example.h"
+#include "remote_async_call.h"
 #include <unistd.h>
 
+#define ASYNC_CALL_WINDOW 16
+
 //note exports double diff variable (time in ms)
 #define TIMED_EXPR(expr) \
     double diff; \
@@ -299,6 +302,126 @@ static bool testCreateRemoteServiceInRemoteCall(void *handle) {
     return rc == 0;
 }
 
+struct bnd_calc_calls {
+    calculator_service_t *calc;
+    remote_async_call_service_t *async; //if NULL sync calls are used
+    int nrOfCalls;
+    int nrOfErrors;
+};
+
+static void bndCallAddAsync(struct bnd_calc_calls *calls) {
+    double a[ASYNC_CALL_WINDOW];
+    double b[ASYNC_CALL_WINDOW];
+    double results[ASYNC_CALL_WINDOW];
+    double *resultPtrs[ASYNC_CALL_WINDOW];
+    void *args[ASYNC_CALL_WINDOW][3];
+    remote_async_call_t *inFlight[ASYNC_CALL_WINDOW];
+
+    for (int i = 0; i < calls->nrOfCalls; i += ASYNC_CALL_WINDOW) {
+        int n = calls->nrOfCalls - i < ASYNC_CALL_WINDOW ? calls->nrOfCalls - i : ASYNC_CALL_WINDOW;
+        for (int j = 0; j < n; ++j) {
+            a[j] = i + j;
+            b[j] = 2.0;
+            resultPtrs[j] = &results[j];
+            args[j][0] = &a[j];
+            args[j][1] = &b[j];
+            args[j][2] = &resultPtrs[j];
+            celix_status_t status = calls->async->call(calls->async->handle, calls->calc, 0 /*add*/, args[j], &inFlight[j]);
+            if (status != CELIX_SUCCESS) {
+                inFlight[j] = NULL;
+                calls->nrOfErrors += 1;
+            }
+        }
+        for (int j = 0; j < n; ++j) {
+            if (inFlight[j] != NULL) {
+                int rc = -1;
+                calls->async->await(calls->async->handle, inFlight[j], &rc);
+                if (rc != 0 || results[j] != i + j + 2.0) {
+                    calls->nrOfErrors += 1;
+                }
+            }
+        }
+    }
+}
+
+static void* bndCallAdd(void *data) {
+    struct bnd_calc_calls *calls = data;
+    if (calls->async != NULL) {
+        bndCallAddAsync(calls);
+    } else {
+        for (int i = 0; i < calls->nrOfCalls; ++i) {
+            double result = -1.0;
+            int rc = calls->calc->add(calls->calc->handle, i, 2.0, &result);
+            if (rc != 0 || result != i + 2.0) {
+                calls->nrOfErrors += 1;
+            }
+        }
+    }
+    return NULL;
+}
+
+struct bnd_benchmark {
+    calculator_service_t *calc;
+    int nrOfThreads;
+    int nrOfCallsPerThread;
+    double callsPerSecond;
+};
+
+static void bndRunBenchmark(void *handle, void *svc) {
+    struct bnd_benchmark *bench = handle;
+    pthread_t threads[bench->nrOfThreads];
+    struct bnd_calc_calls calls[bench->nrOfThreads];
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (int i = 0; i < bench->nrOfThreads; ++i) {
+        calls[i].calc = bench->calc;
+        calls[i].async = svc;
+        calls[i].nrOfCalls = bench->nrOfCallsPerThread;
+        calls[i].nrOfErrors = 0;
+        pthread_create(&threads[i], NULL, bndCallAdd, &calls[i]);
+    }
+    int nrOfErrors = 0;
+    for (int i = 0; i < bench->nrOfThreads; ++i) {
+        pthread_join(threads[i], NULL);
+        nrOfErrors += calls[i].nrOfErrors;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = celix_difftime(&begin, &end);
+    if (nrOfErrors == 0 && seconds > 0) {
+        bench->callsPerSecond = (bench->nrOfThreads * bench->nrOfCallsPerThread) / seconds;
+    } else {
+        fprintf(stderr, "%i failed remote calls\n", nrOfErrors);
+    }
+}
+
+static double bndBenchmarkCalculator(void *handle, int nrOfThreads, int nrOfCallsPerThread, bool async) {
+    struct activator *act = handle;
+
+    pthread_mutex_lock(&act->mutex);
+    struct bnd_benchmark bench;
+    bench.calc = act->calc;
+    bench.nrOfThreads = nrOfThreads;
+    bench.nrOfCallsPerThread = nrOfCallsPerThread;
+    bench.callsPerSecond = -1.0;
+    if (bench.calc != NULL && async) {
+        celix_bundleContext_useService(act->ctx, REMOTE_ASYNC_CALL_SERVICE_NAME, &bench, bndRunBenchmark);
+    } else if (bench.calc != NULL) {
+        bndRunBenchmark(&bench, NULL);
+    } else {
+        printf("calc not ready\n");
+    }
+    pthread_mutex_unlock(&act->mutex);
+
+    return bench.callsPerSecond;
+}
+
+static bool bndTestAsyncCalculator(void *handle) {
+    double callsPerSecond = bndBenchmarkCalculator(handle, 1, ASYNC_CALL_WINDOW * 2 + 1, true);
+    return callsPerSecond > 0;
+}
+
 static celix_status_t bndStart(struct activator *act, celix_bundle_context_t* ctx) {
     //initialize service struct
     act->ctx = ctx;
@@ -314,6 +437,8 @@ static celix_status_t bndStart(struct activator *act, celix_bundle_context_t* ct
     act->testSvc.testRemoteComplex = bndTestRemoteComplex;
     act->testSvc.testCreateRemoteServiceInRemoteCall = testCreateRemoteServiceInRemoteCall;
     act->testSvc.testCreateDestroyComponentWithRemoteService = bndTestCreateDestroyComponentWithRemoteService;
+    act->testSvc.testAsyncCalculator = bndTestAsyncCalculator;
+    act->testSvc.benchmarkCalculator = bndBenchmarkCalculator;
 
 
     //create mutex
@@ -35,6 +35,8 @@ struct tst_service {
     bool (*testRemoteComplex)(void *handle);
     bool (*testCreateDestroyComponentWithRemoteService)(void *handle);
     bool (*testCreateRemoteServiceInRemoteCall)(void *handle);
+    bool (*testAsyncCalculator)(void *handle);
+    double (*benchmarkCalculator)(void *handle, int nrOfThreads, int nrOfCallsPerThread, bool async); //returns calls/s, < 0 on error
 };
 
 typedef struct tst_service tst_service_t;
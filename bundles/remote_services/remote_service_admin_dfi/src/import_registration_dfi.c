@@ -36,7 +36,7 @@ struct import_registration {
     const char *classObject; //NOTE owned by endpoint
     version_pt version;
 
-    celix_thread_mutex_t mutex; //protects send & sendhandle
+    celix_thread_rwlock_t sendLock; //protects send & sendHandle. Calls read lock for the duration of the send, so calls are concurrent
     send_func_type send;
     void *sendHandle;
 
@@ -62,6 +62,7 @@ static celix_status_t importRegistration_findAndParseInterfaceDescriptor(celix_b
 static celix_status_t importRegistration_createProxy(import_registration_t *import, celix_bundle_t *bundle,
                                               struct service_proxy **proxy);
 static void importRegistration_proxyFunc(void *userData, void *args[], void *returnVal);
+static celix_status_t importRegistration_invoke(import_registration_t *import, struct method_entry *entry, void *args[], int *rc);
 static void importRegistration_destroyProxy(struct service_proxy *proxy);
 static void importRegistration_clearProxies(import_registration_t *import);
 static const char* importRegistration_getUrl(import_registration_t *reg);
@@ -83,7 +84,7 @@ celix_status_t importRegistration_create(celix_bundle_context_t *context, endpoi
 
         remoteInterceptorsHandler_create(context, &reg->interceptorsHandler);
 
-        celixThreadMutex_create(&reg->mutex, NULL);
+        celixThreadRwlock_create(&reg->sendLock, NULL);
         celixThreadMutex_create(&reg->proxiesMutex, NULL);
         status = version_createVersionFromString((char*)serviceVersion,&(reg->version));
 
@@ -110,10 +111,10 @@ celix_status_t importRegistration_create(celix_bundle_context_t *context, endpoi
 celix_status_t importRegistration_setSendFn(import_registration_t *reg,
                                             send_func_type send,
                                             void *handle) {
-    celixThreadMutex_lock(&reg->mutex);
+    celixThreadRwlock_writeLock(&reg->sendLock);
     reg->send = send;
     reg->sendHandle = handle;
-    celixThreadMutex_unlock(&reg->mutex);
+    celixThreadRwlock_unlock(&reg->sendLock);
 
     return CELIX_SUCCESS;
 }
@@ -143,7 +144,7 @@ void importRegistration_destroy(import_registration_t *import) {
 
         remoteInterceptorsHandler_destroy(import->interceptorsHandler);
 
-        pthread_mutex_destroy(&import->mutex);
+        celixThreadRwlock_destroy(&import->sendLock);
         pthread_mutex_destroy(&import->proxiesMutex);
 
         if (import->factory != NULL) {
@@ -157,6 +158,10 @@ void importRegistration_destroy(import_registration_t *import) {
     }
 }
 
+endpoint_description_t* importRegistration_getEndpointDescription(import_registration_t *import) {
+    return import->endpoint;
+}
+
 celix_status_t importRegistration_start(import_registration_t *import) {
     celix_status_t  status = CELIX_SUCCESS;
     if (import->factoryReg == NULL && import->factory != NULL) {
@@ -320,14 +325,61 @@ static celix_status_t importRegistration_createProxy(import_registration_t *impo
 }
 
 static void importRegistration_proxyFunc(void *userData, void *args[], void *returnVal) {
-    int  status = CELIX_SUCCESS;
     struct method_entry *entry = userData;
     import_registration_t *import = *((void **)args[0]);
 
-    if (import == NULL || import->send == NULL) {
-        status = CELIX_ILLEGAL_ARGUMENT;
+    int rc = 0;
+    celix_status_t status = importRegistration_invoke(import, entry, args, &rc);
+    *(int *) returnVal = status == CELIX_SUCCESS ? rc : status;
+}
+
+celix_status_t importRegistration_getProxyMethod(import_registration_t *import, void *proxySvc, int methodIndex, struct method_entry **out) {
+    celix_status_t status = CELIX_ILLEGAL_ARGUMENT;
+
+    pthread_mutex_lock(&import->proxiesMutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(import->proxies);
+    while (hashMapIterator_hasNext(&iter)) {
+        struct service_proxy *proxy = hashMapIterator_nextValue(&iter);
+        if (proxy->service == proxySvc) {
+            struct methods_head *list = NULL;
+            dynInterface_methods(proxy->intf, &list);
+            struct method_entry *entry = NULL;
+            TAILQ_FOREACH(entry, list, entries) {
+                if (entry->index == methodIndex) {
+                    *out = entry;
+                    status = CELIX_SUCCESS;
+                    break;
+                }
+            }
+            break;
+        }
     }
+    pthread_mutex_unlock(&import->proxiesMutex);
 
+    return status;
+}
+
+celix_status_t importRegistration_invokeProxyMethod(import_registration_t *import, void *proxySvc, struct method_entry *method, void *args[], int *rc) {
+    int nrOfArgs = dynFunction_nrOfArguments(method->dynFunc);
+    if (nrOfArgs < 1) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    void *allArgs[nrOfArgs];
+    allArgs[0] = proxySvc; //note the first member of the proxy service is the handle (the import)
+    for (int i = 1; i < nrOfArgs; ++i) {
+        allArgs[i] = args[i - 1];
+    }
+    return importRegistration_invoke(import, method, allArgs, rc);
+}
+
+static celix_status_t importRegistration_invoke(import_registration_t *import, struct method_entry *entry, void *args[], int *rc) {
+    celix_status_t status = CELIX_SUCCESS;
+    *rc = 0;
+
+    if (import == NULL) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    }
 
     char *invokeRequest = NULL;
     if (status == CELIX_SUCCESS) {
@@ -335,47 +387,44 @@ static void importRegistration_proxyFunc(void *userData, void *args[], void *ret
         //printf("Need to send following json '%s'\n", invokeRequest);
     }
 
-
     if (status == CELIX_SUCCESS) {
         char *reply = NULL;
-        int rc = 0;
         //printf("sending request\n");
         celix_properties_t *metadata = NULL;
         bool cont = remoteInterceptorHandler_invokePreProxyCall(import->interceptorsHandler, import->endpoint->properties, entry->name, &metadata);
         if (cont) {
-            celixThreadMutex_lock(&import->mutex);
+            //note only a read lock, the send function must support concurrent calls
+            celixThreadRwlock_readLock(&import->sendLock);
             if (import->send != NULL) {
-                import->send(import->sendHandle, import->endpoint, invokeRequest, metadata, &reply, &rc);
+                import->send(import->sendHandle, import->endpoint, invokeRequest, metadata, &reply, rc);
+            } else {
+                status = CELIX_ILLEGAL_STATE;
             }
-            celixThreadMutex_unlock(&import->mutex);
+            celixThreadRwlock_unlock(&import->sendLock);
             //printf("request sended. got reply '%s' with status %i\n", reply, rc);
 
-            if (rc == 0 && dynFunction_hasReturn(entry->dynFunc)) {
+            if (status == CELIX_SUCCESS && *rc == 0 && dynFunction_hasReturn(entry->dynFunc)) {
                 //fjprintf("Handling reply '%s'\n", reply);
                 status = jsonRpc_handleReply(entry->dynFunc, reply, args);
             }
 
-            *(int *) returnVal = rc;
-
             remoteInterceptorHandler_invokePostProxyCall(import->interceptorsHandler, import->endpoint->properties, entry->name, metadata);
         }
 
         if (import->logFile != NULL) {
             static int callCount = 0;
+            int callNr = __atomic_fetch_add(&callCount, 1, __ATOMIC_RELAXED);
             const char *url = importRegistration_getUrl(import);
             const char *svcName = importRegistration_getServiceName(import);
             fprintf(import->logFile, "REMOTE CALL NR %i\n\turl=%s\n\tservice=%s\n\tpayload=%s\n\treturn_code=%i\n\treply=%s\n",
-                                       callCount, url, svcName, invokeRequest, rc, reply);
+                                       callNr, url, svcName, invokeRequest, *rc, reply);
             fflush(import->logFile);
-            callCount += 1;
         }
         free(invokeRequest); //Allocated by json_dumps in jsonRpc_prepareInvokeRequest
         free(reply); //Allocated by json_dumps in remoteServiceAdmin_send through curl call
     }
 
-    if (status != CELIX_SUCCESS) {
-        //TODO log error
-    }
+    return status;
 }
 
 celix_status_t importRegistration_ungetService(import_registration_t *import, celix_bundle_t *bundle, service_registration_t *registration, void **out) {
@@ -35,10 +35,26 @@ void importRegistration_destroy(import_registration_t *import);
 celix_status_t importRegistration_setSendFn(import_registration_t *reg,
                                             send_func_type,
                                             void *handle);
+endpoint_description_t* importRegistration_getEndpointDescription(import_registration_t *import);
+
 celix_status_t importRegistration_start(import_registration_t *import);
 celix_status_t importRegistration_stop(import_registration_t *import);
 
 celix_status_t importRegistration_getService(import_registration_t *import, celix_bundle_t *bundle, service_registration_t *registration, void **service);
 celix_status_t importRegistration_ungetService(import_registration_t *import, celix_bundle_t *bundle, service_registration_t *registration, void **service);
 
+struct method_entry;
+
+/**
+ * Returns the method with the provided index of a proxy service of the import registration.
+ * Returns CELIX_ILLEGAL_ARGUMENT if the proxy service is not (or no longer) provided by the import registration.
+ */
+celix_status_t importRegistration_getProxyMethod(import_registration_t *import, void *proxySvc, int methodIndex, struct method_entry **method);
+
+/**
+ * Performs a remote call of a proxy method. The args are the method arguments without the service handle.
+ * Can be called concurrently, the remote calls are not serialized.
+ */
+celix_status_t importRegistration_invokeProxyMethod(import_registration_t *import, void *proxySvc, struct method_entry *method, void *args[], int *rc);
+
 #endif //CELIX_IMPORT_REGISTRATION_DFI_H
@@ -19,10 +19,12 @@
 
 #include <stdlib.h>
 #include <remote_service_admin.h>
+#include <remote_async_call.h>
 
 #include "remote_service_admin_dfi.h"
 
 #include "bundle_activator.h"
+#include "celix_constants.h"
 #include "service_registration.h"
 
 #include "export_registration_dfi.h"
@@ -32,6 +34,8 @@ struct activator {
 	remote_service_admin_t *admin;
 	remote_service_admin_service_t *adminService;
 	service_registration_t *registration;
+	remote_async_call_service_t asyncCallService;
+	service_registration_t *asyncCallRegistration;
 };
 
 celix_status_t bundleActivator_create(celix_bundle_context_t *context, void **userData) {
@@ -88,6 +92,16 @@ celix_status_t bundleActivator_start(void * userData, celix_bundle_context_t *co
 		}
 	}
 
+	if (status == CELIX_SUCCESS) {
+		activator->asyncCallService.handle = activator->admin;
+		activator->asyncCallService.call = remoteServiceAdmin_asyncCall;
+		activator->asyncCallService.isDone = remoteServiceAdmin_isAsyncCallDone;
+		activator->asyncCallService.await = remoteServiceAdmin_awaitAsyncCall;
+		celix_properties_t *props = celix_properties_create();
+		celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_LANGUAGE, CELIX_FRAMEWORK_SERVICE_C_LANGUAGE);
+		status = bundleContext_registerService(context, REMOTE_ASYNC_CALL_SERVICE_NAME, &activator->asyncCallService, props, &activator->asyncCallRegistration);
+	}
+
 	return status;
 }
 
@@ -95,6 +109,8 @@ celix_status_t bundleActivator_stop(void * userData, celix_bundle_context_t *con
     celix_status_t status = CELIX_SUCCESS;
     struct activator *activator = userData;
 
+    serviceRegistration_unregister(activator->asyncCallRegistration);
+    activator->asyncCallRegistration = NULL;
     serviceRegistration_unregister(activator->registration);
     activator->registration = NULL;
 
@@ -25,6 +25,7 @@
 #include <netdb.h>
 #include <ifaddrs.h>
 #include <string.h>
+#include <time.h>
 #include <uuid/uuid.h>
 #include <curl/curl.h>
 
@@ -42,11 +43,15 @@
 #include "civetweb.h"
 
 #include "remote_service_admin_dfi_constants.h"
+#include "remote_async_call.h"
 #include "celix_bundle_context.h"
 
 // defines how often the webserver is restarted (with an increased port number)
 #define MAX_NUMBER_OF_RESTARTS 5
 
+// initial size of the reply buffer of a connection, the buffer grows if needed and is reused for following calls
+#define RSA_REPLY_BUFFER_INITIAL_SIZE 4096
+
 
 #define RSA_LOG_ERROR(admin, msg, ...) \
     celix_logHelper_log((admin)->loghelper, CELIX_LOG_LEVEL_ERROR, (msg),  ##__VA_ARGS__)
@@ -84,40 +89,83 @@ struct remote_service_admin {
     celix_thread_mutex_t importedServicesLock;
     array_list_pt importedServices;
 
+    //NOTE the async call threads perform the calls started with the remote async call service.
+    //The async calls mutex and conds are created in remoteServiceAdmin_create and destroyed in remoteServiceAdmin_destroy,
+    //so that a call started after remoteServiceAdmin_stop fails on asyncCallsActive instead of using a destroyed mutex.
+    celix_thread_mutex_t asyncCallsMutex; //protects below
+    celix_thread_cond_t asyncCallsCond;
+    celix_thread_cond_t asyncCallsDoneCond; //signaled when a running call is done
+    remote_async_call_t *asyncCallsHead; //FIFO of calls waiting for a async call thread
+    remote_async_call_t *asyncCallsTail;
+    celix_array_list_t *asyncCallsRunning; //calls performed by a async call thread
+    bool asyncCallsActive;
+    int nrOfAsyncCallThreads;
+    celix_thread_t *asyncCallThreads;
+
     char *port;
     char *ip;
 
     struct mg_context *ctx;
 
     FILE *logFile;
-    void *curlShare;
-    pthread_mutex_t curlMutexConnect;
-    pthread_mutex_t curlMutexCookie;
-    pthread_mutex_t curlMutexDns;
-};
 
-struct post {
-    const char *readptr;
-    size_t size;
-    size_t read;
+    celix_thread_mutex_t connectionPoolsLock; //protects connectionPools
+    hash_map_pt connectionPools; //key = scheme://host:port of the remote RSA, value = rsa_connection_pool_t*
+    long maxConnectionsPerEndpoint; //max nr of connections per remote RSA
+    long proxyTimeout; //default timeout of remote calls, in seconds
+    long keepAliveTimeoutInMs;
 };
 
-struct get {
-    char *writeptr;
-    size_t size;
+struct remote_async_call {
+    import_registration_t *import;
+    void *proxySvc;
+    struct method_entry *method;
+    void **args; //NOTE not owned
+    remote_async_call_t *next;
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond;
+    bool done;
+    celix_status_t status;
+    int rc;
 };
 
+/**
+ * A curl easy handle used for calls to a single endpoint. The handle is reused for following calls, so that the
+ * (keep-alive) connection, the resolved address and the reply buffer are reused.
+ */
+typedef struct rsa_connection {
+    CURL *curl;
+    struct timespec lastUsed;
+    char *reply;
+    size_t replySize;
+    size_t replyCap;
+} rsa_connection_t;
+
+typedef struct rsa_connection_pool {
+    char *serverUrl; //scheme://host:port of the remote RSA
+    int nrOfUsers; //nr of imports using the pool, protected by the connectionPoolsLock
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_thread_cond_t cond;
+    celix_array_list_t *idle; //LIFO, the most recently used connection is the most likely to be still open
+    long nrOfConnections; //idle and in use
+} rsa_connection_pool_t;
+
 #define OSGI_RSA_REMOTE_PROXY_FACTORY   "remote_proxy_factory"
 #define OSGI_RSA_REMOTE_PROXY_TIMEOUT   "remote_proxy_timeout"
 
+//NOTE the content length is needed for keep-alive connections
 static const char *data_response_headers =
         "HTTP/1.1 200 OK\r\n"
                 "Cache: no-cache\r\n"
                 "Content-Type: application/json\r\n"
+                "Content-Length: %zu\r\n"
                 "\r\n";
 
 static const char *no_content_response_headers =
-        "HTTP/1.1 204 OK\r\n";
+        "HTTP/1.1 204 OK\r\n"
+                "\r\n";
 
 static const unsigned int DEFAULT_TIMEOUT = 0;
 
@@ -125,52 +173,16 @@ static int remoteServiceAdmin_callback(struct mg_connection *conn);
 static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_service_admin_t *admin, service_reference_pt reference, celix_properties_t *props, char *interface, endpoint_description_t **description);
 static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description_t *endpointDescription, char *request, celix_properties_t *metadata, char **reply, int* replyStatus);
 static celix_status_t remoteServiceAdmin_getIpAddress(char* interface, char** ip);
-static size_t remoteServiceAdmin_readCallback(void *ptr, size_t size, size_t nmemb, void *userp);
 static size_t remoteServiceAdmin_write(void *contents, size_t size, size_t nmemb, void *userp);
+static void remoteServiceAdmin_destroyConnectionPool(rsa_connection_pool_t *pool);
+static void remoteServiceAdmin_removeConnectionPool(remote_service_admin_t *rsa, endpoint_description_t *endpointDescription);
+static void remoteServiceAdmin_addConnectionPoolUser(remote_service_admin_t *rsa, endpoint_description_t *endpointDescription);
 static void remoteServiceAdmin_log(remote_service_admin_t *admin, int level, const char *file, int line, const char *msg, ...);
 static void remoteServiceAdmin_setupStopExportsThread(remote_service_admin_t* admin);
 static void remoteServiceAdmin_teardownStopExportsThread(remote_service_admin_t* admin);
-
-static void remoteServiceAdmin_curlshare_lock(CURL *handle, curl_lock_data data, curl_lock_access laccess, void *userptr)
-{
-    (void)handle;
-    (void)data;
-    (void)laccess;
-    remote_service_admin_t *rsa = userptr;
-    switch(data) {
-        case CURL_LOCK_DATA_CONNECT:
-            pthread_mutex_lock(&rsa->curlMutexConnect);
-            break;
-        case CURL_LOCK_DATA_COOKIE:
-            pthread_mutex_lock(&rsa->curlMutexCookie);
-            break;
-        case CURL_LOCK_DATA_DNS:
-            pthread_mutex_lock(&rsa->curlMutexDns);
-            break;
-        default:
-            break;
-    }
-}
-
-static void remoteServiceAdmin_curlshare_unlock(CURL *handle, curl_lock_data data, void *userptr)
-{
-    (void)handle;
-    (void)data;
-    remote_service_admin_t *rsa = userptr;
-    switch(data) {
-        case CURL_LOCK_DATA_CONNECT:
-            pthread_mutex_unlock(&rsa->curlMutexConnect);
-            break;
-        case CURL_LOCK_DATA_COOKIE:
-            pthread_mutex_unlock(&rsa->curlMutexCookie);
-            break;
-        case CURL_LOCK_DATA_DNS:
-            pthread_mutex_unlock(&rsa->curlMutexDns);
-            break;
-        default:
-            break;
-    }
-}
+static void remoteServiceAdmin_setupAsyncCallThreads(remote_service_admin_t* admin);
+static void remoteServiceAdmin_teardownAsyncCallThreads(remote_service_admin_t* admin);
+static void remoteServiceAdmin_destroyAsyncCalls(remote_service_admin_t* admin);
 
 celix_status_t remoteServiceAdmin_create(celix_bundle_context_t *context, remote_service_admin_t **admin) {
     celix_status_t status = CELIX_SUCCESS;
@@ -216,31 +228,23 @@ celix_status_t remoteServiceAdmin_create(celix_bundle_context_t *context, remote
             free(detectedIp);
         }
 
-        (*admin)->curlShare = curl_share_init();
-        curl_share_setopt((*admin)->curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
-        curl_share_setopt((*admin)->curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
-        curl_share_setopt((*admin)->curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
-        curl_share_setopt((*admin)->curlShare, CURLSHOPT_USERDATA, *admin);
-
-        curl_share_setopt((*admin)->curlShare, CURLSHOPT_LOCKFUNC, remoteServiceAdmin_curlshare_lock);
-        curl_share_setopt((*admin)->curlShare, CURLSHOPT_UNLOCKFUNC, remoteServiceAdmin_curlshare_unlock);
-
-        if(status == CELIX_SUCCESS && pthread_mutex_init(&(*admin)->curlMutexConnect, NULL) != 0) {
-            fprintf(stderr, "Could not initialize mutex connect\n");
-            status = EPERM;
-        }
-
-        if(status == CELIX_SUCCESS && pthread_mutex_init(&(*admin)->curlMutexCookie, NULL) != 0) {
-            fprintf(stderr, "Could not initialize mutex cookie\n");
-            status = EPERM;
+        celixThreadMutex_create(&(*admin)->connectionPoolsLock, NULL);
+        (*admin)->connectionPools = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+        (*admin)->maxConnectionsPerEndpoint = celix_bundleContext_getPropertyAsLong(context, RSA_MAX_CONNECTIONS_PER_ENDPOINT_KEY, RSA_MAX_CONNECTIONS_PER_ENDPOINT_DEFAULT);
+        if ((*admin)->maxConnectionsPerEndpoint < 1) {
+            celix_logHelper_log((*admin)->loghelper, CELIX_LOG_LEVEL_WARNING, "RSA: Invalid %s value %li, using 1", RSA_MAX_CONNECTIONS_PER_ENDPOINT_KEY, (*admin)->maxConnectionsPerEndpoint);
+            (*admin)->maxConnectionsPerEndpoint = 1;
         }
-
-        if(status == CELIX_SUCCESS && pthread_mutex_init(&(*admin)->curlMutexDns, NULL) != 0) {
-            fprintf(stderr, "Could not initialize mutex dns\n");
-            status = EPERM;
+        (*admin)->keepAliveTimeoutInMs = celix_bundleContext_getPropertyAsLong(context, RSA_KEEP_ALIVE_TIMEOUT_MS_KEY, RSA_KEEP_ALIVE_TIMEOUT_MS_DEFAULT);
+        if ((*admin)->keepAliveTimeoutInMs < 1) {
+            celix_logHelper_log((*admin)->loghelper, CELIX_LOG_LEVEL_WARNING, "RSA: Invalid %s value %li, using %i", RSA_KEEP_ALIVE_TIMEOUT_MS_KEY, (*admin)->keepAliveTimeoutInMs, RSA_KEEP_ALIVE_TIMEOUT_MS_DEFAULT);
+            (*admin)->keepAliveTimeoutInMs = RSA_KEEP_ALIVE_TIMEOUT_MS_DEFAULT;
         }
+        long nrOfServerThreads = celix_bundleContext_getPropertyAsLong(context, RSA_NUM_THREADS_KEY, RSA_NUM_THREADS_DEFAULT);
+        (*admin)->proxyTimeout = celix_bundleContext_getPropertyAsLong(context, OSGI_RSA_REMOTE_PROXY_TIMEOUT, DEFAULT_TIMEOUT);
 
         remoteServiceAdmin_setupStopExportsThread(*admin);
+        remoteServiceAdmin_setupAsyncCallThreads(*admin);
 
         // Prepare callbacks structure. We have only one callback, the rest are NULL.
         struct mg_callbacks callbacks;
@@ -249,11 +253,16 @@ celix_status_t remoteServiceAdmin_create(celix_bundle_context_t *context, remote
 
         char newPort[10];
         snprintf(newPort, 10, "%li", port);
+        char numThreads[32];
+        snprintf(numThreads, sizeof(numThreads), "%li", nrOfServerThreads);
+        //NOTE the request timeout is also the time a idle keep-alive connection is kept open (and uses a server thread)
+        char requestTimeout[32];
+        snprintf(requestTimeout, sizeof(requestTimeout), "%li", (*admin)->keepAliveTimeoutInMs);
 
         unsigned int port_counter = 0;
         do {
 
-            const char *options[] = { "listening_ports", newPort, "num_threads", "5", NULL};
+            const char *options[] = { "listening_ports", newPort, "num_threads", numThreads, "enable_keep_alive", "yes", "request_timeout_ms", requestTimeout, NULL};
 
             (*admin)->ctx = mg_start(&callbacks, (*admin), options);
 
@@ -296,10 +305,15 @@ celix_status_t remoteServiceAdmin_destroy(remote_service_admin_t **admin)
 
     free((*admin)->ip);
     free((*admin)->port);
-    curl_share_cleanup((*admin)->curlShare);
-    pthread_mutex_destroy(&(*admin)->curlMutexConnect);
-    pthread_mutex_destroy(&(*admin)->curlMutexCookie);
-    pthread_mutex_destroy(&(*admin)->curlMutexDns);
+
+    hash_map_iterator_t iter = hashMapIterator_construct((*admin)->connectionPools);
+    while (hashMapIterator_hasNext(&iter)) {
+        rsa_connection_pool_t *pool = hashMapIterator_nextValue(&iter);
+        remoteServiceAdmin_destroyConnectionPool(pool);
+    }
+    hashMap_destroy((*admin)->connectionPools, false, false);
+    celixThreadMutex_destroy(&(*admin)->connectionPoolsLock);
+    remoteServiceAdmin_destroyAsyncCalls(*admin);
     free(*admin);
 
     *admin = NULL;
@@ -353,6 +367,245 @@ static void remoteServiceAdmin_teardownStopExportsThread(remote_service_admin_t*
     }
 }
 
+static void remoteServiceAdmin_completeAsyncCall(remote_async_call_t *call, celix_status_t status, int rc) {
+    celixThreadMutex_lock(&call->mutex);
+    call->status = status;
+    call->rc = rc;
+    call->done = true;
+    celixThreadCondition_broadcast(&call->cond);
+    celixThreadMutex_unlock(&call->mutex);
+}
+
+static void* remoteServiceAdmin_asyncCallThread(void *data) {
+    remote_service_admin_t* admin = data;
+
+    celixThreadMutex_lock(&admin->asyncCallsMutex);
+    while (admin->asyncCallsActive) {
+        remote_async_call_t *call = admin->asyncCallsHead;
+        if (call == NULL) {
+            celixThreadCondition_wait(&admin->asyncCallsCond, &admin->asyncCallsMutex);
+            continue;
+        }
+        admin->asyncCallsHead = call->next;
+        if (admin->asyncCallsHead == NULL) {
+            admin->asyncCallsTail = NULL;
+        }
+        celix_arrayList_add(admin->asyncCallsRunning, call);
+        celixThreadMutex_unlock(&admin->asyncCallsMutex);
+
+        int rc = 0;
+        celix_status_t status = importRegistration_invokeProxyMethod(call->import, call->proxySvc, call->method, call->args, &rc);
+
+        //NOTE the import is no longer used, a import removal waiting for this call can continue
+        celixThreadMutex_lock(&admin->asyncCallsMutex);
+        celix_arrayList_remove(admin->asyncCallsRunning, call);
+        celixThreadCondition_broadcast(&admin->asyncCallsDoneCond);
+        celixThreadMutex_unlock(&admin->asyncCallsMutex);
+
+        remoteServiceAdmin_completeAsyncCall(call, status, rc);
+
+        celixThreadMutex_lock(&admin->asyncCallsMutex);
+    }
+    celixThreadMutex_unlock(&admin->asyncCallsMutex);
+
+    return NULL;
+}
+
+static void remoteServiceAdmin_setupAsyncCallThreads(remote_service_admin_t* admin) {
+    celixThreadMutex_create(&admin->asyncCallsMutex, NULL);
+    celixThreadCondition_init(&admin->asyncCallsCond, NULL);
+    celixThreadCondition_init(&admin->asyncCallsDoneCond, NULL);
+    admin->asyncCallsRunning = celix_arrayList_create();
+    admin->asyncCallsActive = true;
+
+    long nrOfThreads = celix_bundleContext_getPropertyAsLong(admin->context, RSA_ASYNC_CALL_THREADS_KEY, RSA_ASYNC_CALL_THREADS_DEFAULT);
+    if (nrOfThreads < 1) {
+        celix_logHelper_log(admin->loghelper, CELIX_LOG_LEVEL_WARNING, "RSA: Invalid %s value %li, using 1", RSA_ASYNC_CALL_THREADS_KEY, nrOfThreads);
+        nrOfThreads = 1;
+    }
+    admin->asyncCallThreads = calloc(nrOfThreads, sizeof(*admin->asyncCallThreads));
+    for (int i = 0; admin->asyncCallThreads != NULL && i < nrOfThreads; ++i) {
+        celixThread_create(&admin->asyncCallThreads[i], NULL, remoteServiceAdmin_asyncCallThread, admin);
+        celixThread_setName(&admin->asyncCallThreads[i], "RSA AsyncCall");
+        admin->nrOfAsyncCallThreads += 1;
+    }
+}
+
+static void remoteServiceAdmin_teardownAsyncCallThreads(remote_service_admin_t* admin) {
+    celixThreadMutex_lock(&admin->asyncCallsMutex);
+    admin->asyncCallsActive = false;
+    celixThreadCondition_broadcast(&admin->asyncCallsCond);
+    celixThreadMutex_unlock(&admin->asyncCallsMutex);
+
+    for (int i = 0; i < admin->nrOfAsyncCallThreads; ++i) {
+        celixThread_join(admin->asyncCallThreads[i], NULL);
+    }
+    free(admin->asyncCallThreads);
+    admin->asyncCallThreads = NULL;
+    admin->nrOfAsyncCallThreads = 0;
+
+    //calls not yet started will not be performed anymore
+    celixThreadMutex_lock(&admin->asyncCallsMutex);
+    remote_async_call_t *call = admin->asyncCallsHead;
+    admin->asyncCallsHead = NULL;
+    admin->asyncCallsTail = NULL;
+    celixThreadMutex_unlock(&admin->asyncCallsMutex);
+    while (call != NULL) {
+        remote_async_call_t *next = call->next;
+        remoteServiceAdmin_completeAsyncCall(call, CELIX_ILLEGAL_STATE, 0);
+        call = next;
+    }
+}
+
+static void remoteServiceAdmin_destroyAsyncCalls(remote_service_admin_t* admin) {
+    if (admin->asyncCallsRunning != NULL) {
+        celix_arrayList_destroy(admin->asyncCallsRunning);
+        celixThreadMutex_destroy(&admin->asyncCallsMutex);
+        celixThreadCondition_destroy(&admin->asyncCallsCond);
+        celixThreadCondition_destroy(&admin->asyncCallsDoneCond);
+    }
+}
+
+/**
+ * Cancels the queued async calls for the import with CELIX_ILLEGAL_STATE and waits until the running async calls for
+ * the import are done, so that the import (and its proxies) can be closed.
+ * Note: admin->importedServicesLock should be locked, so that no new async calls for the import are queued.
+ */
+static void remoteServiceAdmin_cancelAsyncCalls(remote_service_admin_t* admin, import_registration_t *import) {
+    remote_async_call_t *canceled = NULL;
+    celixThreadMutex_lock(&admin->asyncCallsMutex);
+    remote_async_call_t *prev = NULL;
+    remote_async_call_t *call = admin->asyncCallsHead;
+    while (call != NULL) {
+        remote_async_call_t *next = call->next;
+        if (call->import == import) {
+            if (prev == NULL) {
+                admin->asyncCallsHead = next;
+            } else {
+                prev->next = next;
+            }
+            if (admin->asyncCallsTail == call) {
+                admin->asyncCallsTail = prev;
+            }
+            call->next = canceled;
+            canceled = call;
+        } else {
+            prev = call;
+        }
+        call = next;
+    }
+
+    bool running = true;
+    while (running) {
+        running = false;
+        for (int i = 0; i < celix_arrayList_size(admin->asyncCallsRunning); ++i) {
+            remote_async_call_t *runningCall = celix_arrayList_get(admin->asyncCallsRunning, i);
+            if (runningCall->import == import) {
+                running = true;
+                break;
+            }
+        }
+        if (running) {
+            celixThreadCondition_wait(&admin->asyncCallsDoneCond, &admin->asyncCallsMutex);
+        }
+    }
+    celixThreadMutex_unlock(&admin->asyncCallsMutex);
+
+    while (canceled != NULL) {
+        remote_async_call_t *next = canceled->next;
+        remoteServiceAdmin_completeAsyncCall(canceled, CELIX_ILLEGAL_STATE, 0);
+        canceled = next;
+    }
+}
+
+celix_status_t remoteServiceAdmin_asyncCall(void *handle, void *proxySvc, int methodIndex, void *args[], remote_async_call_t **out) {
+    remote_service_admin_t *admin = handle;
+    celix_status_t status = CELIX_ILLEGAL_ARGUMENT;
+
+    if (proxySvc == NULL || out == NULL) {
+        return status;
+    }
+
+    //note the first member of a proxy service is the handle, which is the import registration
+    import_registration_t *import = *((void **)proxySvc);
+    struct method_entry *method = NULL;
+    //NOTE the importedServicesLock is kept until the call is queued, so that the import cannot be removed before the
+    //call is queued. A removed import cancels the queued calls and waits for the running calls.
+    celixThreadMutex_lock(&admin->importedServicesLock);
+    for (int i = 0; i < arrayList_size(admin->importedServices); ++i) {
+        if (arrayList_get(admin->importedServices, i) == import) {
+            status = importRegistration_getProxyMethod(import, proxySvc, methodIndex, &method);
+            break;
+        }
+    }
+
+    remote_async_call_t *call = NULL;
+    if (status == CELIX_SUCCESS) {
+        call = calloc(1, sizeof(*call));
+        status = call == NULL ? CELIX_ENOMEM : CELIX_SUCCESS;
+    }
+
+    if (status == CELIX_SUCCESS) {
+        call->import = import;
+        call->proxySvc = proxySvc;
+        call->method = method;
+        call->args = args;
+        celixThreadMutex_create(&call->mutex, NULL);
+        celixThreadCondition_init(&call->cond, NULL);
+
+        celixThreadMutex_lock(&admin->asyncCallsMutex);
+        if (admin->asyncCallsActive && admin->nrOfAsyncCallThreads > 0) {
+            if (admin->asyncCallsTail == NULL) {
+                admin->asyncCallsHead = call;
+            } else {
+                admin->asyncCallsTail->next = call;
+            }
+            admin->asyncCallsTail = call;
+            celixThreadCondition_signal(&admin->asyncCallsCond);
+        } else {
+            status = CELIX_ILLEGAL_STATE;
+        }
+        celixThreadMutex_unlock(&admin->asyncCallsMutex);
+
+        if (status != CELIX_SUCCESS) {
+            celixThreadMutex_destroy(&call->mutex);
+            celixThreadCondition_destroy(&call->cond);
+            free(call);
+        }
+    }
+    celixThreadMutex_unlock(&admin->importedServicesLock);
+
+    if (status == CELIX_SUCCESS) {
+        *out = call;
+    }
+    return status;
+}
+
+bool remoteServiceAdmin_isAsyncCallDone(void *handle __attribute__((unused)), remote_async_call_t *call) {
+    celixThreadMutex_lock(&call->mutex);
+    bool done = call->done;
+    celixThreadMutex_unlock(&call->mutex);
+    return done;
+}
+
+celix_status_t remoteServiceAdmin_awaitAsyncCall(void *handle __attribute__((unused)), remote_async_call_t *call, int *returnValue) {
+    celixThreadMutex_lock(&call->mutex);
+    while (!call->done) {
+        celixThreadCondition_wait(&call->cond, &call->mutex);
+    }
+    celixThreadMutex_unlock(&call->mutex);
+
+    celix_status_t status = call->status;
+    if (returnValue != NULL) {
+        *returnValue = status == CELIX_SUCCESS ? call->rc : status;
+    }
+
+    celixThreadMutex_destroy(&call->mutex);
+    celixThreadCondition_destroy(&call->cond);
+    free(call);
+    return status;
+}
+
 static void remoteServiceAdmin_stopExport(remote_service_admin_t *admin, export_registration_t* export) {
     if (export != NULL) {
         if (CELIX_RSA_USE_STOP_EXPORT_THREAD) {
@@ -388,6 +641,7 @@ celix_status_t remoteServiceAdmin_stop(remote_service_admin_t *admin) {
     celixThreadRwlock_unlock(&admin->exportedServicesLock);
 
     remoteServiceAdmin_teardownStopExportsThread(admin);
+    remoteServiceAdmin_teardownAsyncCallThreads(admin);
 
     celixThreadMutex_lock(&admin->importedServicesLock);
     int i;
@@ -504,8 +758,9 @@ static int remoteServiceAdmin_callback(struct mg_connection *conn) {
             }
 
             if (rc == CELIX_SUCCESS && response != NULL) {
-                mg_write(conn, data_response_headers, strlen(data_response_headers));
-                mg_write(conn, response, strlen(response));
+                size_t len = strlen(response);
+                mg_printf(conn, data_response_headers, len);
+                mg_write(conn, response, len);
                 free(response);
             } else {
                 mg_write(conn, no_content_response_headers, strlen(no_content_response_headers));
@@ -674,10 +929,9 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
         }
     }
 
-    hash_map_entry_pt entry = hashMap_getEntry(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
-
-    char* key = hashMapEntry_getKey(entry);
-    char *serviceId = (char *) hashMap_remove(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
+    const char *svcIdStr = celix_properties_get(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID, NULL);
+    char *serviceId = svcIdStr == NULL ? NULL : strdup(svcIdStr);
+    celix_properties_unset(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID);
     const char *uuid = NULL;
 
     char buf[512];
@@ -701,12 +955,10 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
     celix_properties_set(endpointProperties, RSA_DFI_ENDPOINT_URL, url);
 
     if (props != NULL) {
-        hash_map_iterator_pt propIter = hashMapIterator_create(props);
-        while (hashMapIterator_hasNext(propIter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(propIter);
-            celix_properties_set(endpointProperties, (char*)hashMapEntry_getKey(entry), (char*)hashMapEntry_getValue(entry));
+        const char *propKey;
+        CELIX_PROPERTIES_FOR_EACH(props, propKey) {
+            celix_properties_set(endpointProperties, propKey, celix_properties_get(props, propKey, NULL));
         }
-        hashMapIterator_destroy(propIter);
     }
 
     *endpoint = calloc(1, sizeof(**endpoint));
@@ -722,7 +974,6 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
         (*endpoint)->properties = endpointProperties;
     }
 
-    free(key);
     free(serviceId);
     free(keys);
 
@@ -825,6 +1076,7 @@ celix_status_t remoteServiceAdmin_importService(remote_service_admin_t *admin, e
                                                admin->logFile, &import);
         }
         if (status == CELIX_SUCCESS && import != NULL) {
+            remoteServiceAdmin_addConnectionPoolUser(admin, importRegistration_getEndpointDescription(import));
             importRegistration_setSendFn(import, (send_func_type) remoteServiceAdmin_send, admin);
         }
 
@@ -857,7 +1109,11 @@ celix_status_t remoteServiceAdmin_removeImportedService(remote_service_admin_t *
         current = arrayList_get(admin->importedServices, i);
         if (current == registration) {
             arrayList_remove(admin->importedServices, i);
+            remoteServiceAdmin_cancelAsyncCalls(admin, current);
+            //NOTE resetting the send function waits for the calls in progress, so the connection pool is no longer used by the import
+            importRegistration_setSendFn(current, NULL, NULL);
             importRegistration_close(current);
+            remoteServiceAdmin_removeConnectionPool(admin, importRegistration_getEndpointDescription(current));
             importRegistration_destroy(current);
             break;
         }
@@ -867,45 +1123,221 @@ celix_status_t remoteServiceAdmin_removeImportedService(remote_service_admin_t *
     return status;
 }
 
-static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description_t *endpointDescription, char *request, celix_properties_t *metadata, char **reply, int* replyStatus) {
-    remote_service_admin_t * rsa = handle;
-    struct post post;
-    post.readptr = request;
-    post.size = strlen(request);
-    post.read = 0;
+/**
+ * Returns the length of the scheme://host:port part of a endpoint url.
+ */
+static size_t remoteServiceAdmin_serverUrlLength(const char *url) {
+    const char *host = strstr(url, "://");
+    host = host == NULL ? url : host + 3;
+    const char *path = strchr(host, '/');
+    return path == NULL ? strlen(url) : (size_t) (path - url);
+}
 
-    struct get get;
-    get.size = 0;
-    get.writeptr = NULL;
+/**
+ * Returns the connection pool for the remote RSA (scheme://host:port) of the endpoint, or NULL if there is no pool.
+ * The connections of a pool are shared by all services imported from the same remote RSA.
+ */
+static rsa_connection_pool_t* remoteServiceAdmin_getConnectionPool(remote_service_admin_t *rsa, endpoint_description_t *endpointDescription) {
+    const char *serviceUrl = celix_properties_get(endpointDescription->properties, (char*) RSA_DFI_ENDPOINT_URL, NULL);
+    if (serviceUrl == NULL) {
+        return NULL;
+    }
+    size_t len = remoteServiceAdmin_serverUrlLength(serviceUrl);
+    char serverUrl[len + 1];
+    memcpy(serverUrl, serviceUrl, len);
+    serverUrl[len] = '\0';
+
+    celixThreadMutex_lock(&rsa->connectionPoolsLock);
+    rsa_connection_pool_t *pool = hashMap_get(rsa->connectionPools, serverUrl);
+    celixThreadMutex_unlock(&rsa->connectionPoolsLock);
+    return pool;
+}
 
+/**
+ * Adds a import as user of the connection pool for the remote RSA of the endpoint, the pool is created if needed.
+ */
+static void remoteServiceAdmin_addConnectionPoolUser(remote_service_admin_t *rsa, endpoint_description_t *endpointDescription) {
     const char *serviceUrl = celix_properties_get(endpointDescription->properties, (char*) RSA_DFI_ENDPOINT_URL, NULL);
-    char url[256];
-    snprintf(url, 256, "%s", serviceUrl);
+    if (serviceUrl == NULL) {
+        return;
+    }
+    size_t len = remoteServiceAdmin_serverUrlLength(serviceUrl);
+
+    celixThreadMutex_lock(&rsa->connectionPoolsLock);
+    char *serverUrl = strndup(serviceUrl, len);
+    rsa_connection_pool_t *pool = serverUrl == NULL ? NULL : hashMap_get(rsa->connectionPools, serverUrl);
+    if (pool == NULL && serverUrl != NULL) {
+        pool = calloc(1, sizeof(*pool));
+        if (pool != NULL) {
+            pool->serverUrl = serverUrl;
+            serverUrl = NULL;
+            celixThreadMutex_create(&pool->mutex, NULL);
+            celixThreadCondition_init(&pool->cond, NULL);
+            pool->idle = celix_arrayList_create();
+            hashMap_put(rsa->connectionPools, pool->serverUrl, pool);
+        }
+    }
+    if (pool != NULL) {
+        pool->nrOfUsers += 1;
+    }
+    celixThreadMutex_unlock(&rsa->connectionPoolsLock);
+    free(serverUrl);
+}
 
-    // assume the default timeout
-    int timeout = DEFAULT_TIMEOUT;
+static void remoteServiceAdmin_destroyConnection(rsa_connection_t *connection) {
+    if (connection != NULL) {
+        if (connection->curl != NULL) {
+            curl_easy_cleanup(connection->curl);
+        }
+        free(connection->reply);
+        free(connection);
+    }
+}
 
-    const char *timeoutStr = NULL;
-    // Check if the endpoint has a timeout, if so, use it.
-    timeoutStr = (char*) celix_properties_get(endpointDescription->properties, (char*) OSGI_RSA_REMOTE_PROXY_TIMEOUT, NULL);
-    if (timeoutStr == NULL) {
-        // If not, get the global variable and use that one.
-        bundleContext_getProperty(rsa->context, (char*) OSGI_RSA_REMOTE_PROXY_TIMEOUT, &timeoutStr);
+/**
+ * Destroys the connection pool, after waiting until all connections are released.
+ */
+static void remoteServiceAdmin_destroyConnectionPool(rsa_connection_pool_t *pool) {
+    celixThreadMutex_lock(&pool->mutex);
+    while (pool->nrOfConnections > celix_arrayList_size(pool->idle)) {
+        celixThreadCondition_wait(&pool->cond, &pool->mutex);
     }
+    celixThreadMutex_unlock(&pool->mutex);
 
-    // Update timeout if a property is used to set it.
-    if (timeoutStr != NULL) {
-        timeout = atoi(timeoutStr);
+    for (int i = 0; i < celix_arrayList_size(pool->idle); ++i) {
+        remoteServiceAdmin_destroyConnection(celix_arrayList_get(pool->idle, i));
     }
+    celix_arrayList_destroy(pool->idle);
+    celixThreadMutex_destroy(&pool->mutex);
+    celixThreadCondition_destroy(&pool->cond);
+    free(pool->serverUrl);
+    free(pool);
+}
 
-    celix_status_t status = CELIX_SUCCESS;
-    CURL *curl;
-    CURLcode res;
+/**
+ * Removes a import as user of the connection pool for the remote RSA of the endpoint. The pool is destroyed when the
+ * last user is removed. The send function of the import should already be reset, so that no calls of the import are
+ * in progress.
+ */
+void remoteServiceAdmin_removeConnectionPool(remote_service_admin_t *rsa, endpoint_description_t *endpointDescription) {
+    const char *serviceUrl = endpointDescription == NULL ? NULL : celix_properties_get(endpointDescription->properties, (char*) RSA_DFI_ENDPOINT_URL, NULL);
+    if (serviceUrl != NULL) {
+        size_t len = remoteServiceAdmin_serverUrlLength(serviceUrl);
+        char serverUrl[len + 1];
+        memcpy(serverUrl, serviceUrl, len);
+        serverUrl[len] = '\0';
+
+        celixThreadMutex_lock(&rsa->connectionPoolsLock);
+        rsa_connection_pool_t *pool = hashMap_get(rsa->connectionPools, serverUrl);
+        if (pool != NULL) {
+            pool->nrOfUsers -= 1;
+            if (pool->nrOfUsers <= 0) {
+                hashMap_remove(rsa->connectionPools, serverUrl);
+            } else {
+                pool = NULL;
+            }
+        }
+        celixThreadMutex_unlock(&rsa->connectionPoolsLock);
+        if (pool != NULL) {
+            remoteServiceAdmin_destroyConnectionPool(pool);
+        }
+    }
+}
+
+static celix_status_t remoteServiceAdmin_acquireConnection(remote_service_admin_t *rsa, rsa_connection_pool_t *pool, rsa_connection_t **out) {
+    rsa_connection_t *connection = NULL;
 
-    curl = curl_easy_init();
-    if(!curl) {
-        status = CELIX_ILLEGAL_STATE;
+    celixThreadMutex_lock(&pool->mutex);
+    while (celix_arrayList_size(pool->idle) == 0 && pool->nrOfConnections >= rsa->maxConnectionsPerEndpoint) {
+        celixThreadCondition_wait(&pool->cond, &pool->mutex);
+    }
+    int nrOfIdle = celix_arrayList_size(pool->idle);
+    if (nrOfIdle > 0) {
+        connection = celix_arrayList_get(pool->idle, nrOfIdle - 1);
+        celix_arrayList_removeAt(pool->idle, nrOfIdle - 1);
     } else {
+        pool->nrOfConnections += 1;
+    }
+    celixThreadMutex_unlock(&pool->mutex);
+
+    if (connection != NULL && connection->curl != NULL) {
+        //NOTE do not reuse a connection which the server is about to close, because of the keep-alive timeout
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (celix_difftime(&connection->lastUsed, &now) * 1000.0 > rsa->keepAliveTimeoutInMs / 2.0) {
+            curl_easy_cleanup(connection->curl);
+            connection->curl = NULL;
+        }
+    }
+
+    if (connection == NULL) {
+        connection = calloc(1, sizeof(*connection));
+        if (connection != NULL) {
+            connection->reply = malloc(RSA_REPLY_BUFFER_INITIAL_SIZE);
+            connection->replyCap = connection->reply == NULL ? 0 : RSA_REPLY_BUFFER_INITIAL_SIZE;
+        }
+    }
+
+    if (connection != NULL && connection->curl == NULL) {
+        connection->curl = curl_easy_init();
+        if (connection->curl != NULL) {
+            curl_easy_setopt(connection->curl, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(connection->curl, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(connection->curl, CURLOPT_MAXCONNECTS, 1L);
+            curl_easy_setopt(connection->curl, CURLOPT_POST, 1L);
+            curl_easy_setopt(connection->curl, CURLOPT_WRITEFUNCTION, remoteServiceAdmin_write);
+            curl_easy_setopt(connection->curl, CURLOPT_WRITEDATA, (void *)connection);
+        }
+    }
+
+    if (connection == NULL || connection->curl == NULL) {
+        remoteServiceAdmin_destroyConnection(connection);
+        celixThreadMutex_lock(&pool->mutex);
+        pool->nrOfConnections -= 1;
+        celixThreadCondition_broadcast(&pool->cond);
+        celixThreadMutex_unlock(&pool->mutex);
+        return CELIX_ILLEGAL_STATE;
+    }
+
+    *out = connection;
+    return CELIX_SUCCESS;
+}
+
+static void remoteServiceAdmin_releaseConnection(rsa_connection_pool_t *pool, rsa_connection_t *connection, bool reusable) {
+    if (!reusable) {
+        //NOTE the connection could be in an unknown state, start over with a new curl handle
+        curl_easy_cleanup(connection->curl);
+        connection->curl = NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &connection->lastUsed);
+
+    celixThreadMutex_lock(&pool->mutex);
+    celix_arrayList_add(pool->idle, connection);
+    //note broadcast, a pool being destroyed also waits for released connections
+    celixThreadCondition_broadcast(&pool->cond);
+    celixThreadMutex_unlock(&pool->mutex);
+}
+
+static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description_t *endpointDescription, char *request, celix_properties_t *metadata, char **reply, int* replyStatus) {
+    remote_service_admin_t * rsa = handle;
+
+    rsa_connection_pool_t *pool = remoteServiceAdmin_getConnectionPool(rsa, endpointDescription);
+    rsa_connection_t *connection = NULL;
+    celix_status_t status = pool == NULL ? CELIX_ILLEGAL_ARGUMENT : remoteServiceAdmin_acquireConnection(rsa, pool, &connection);
+
+    if (status == CELIX_SUCCESS) {
+        CURL *curl = connection->curl;
+        CURLcode res;
+
+        //NOTE the connection is shared by the services imported from the same remote RSA, so the url and timeout are set per call
+        long timeout = rsa->proxyTimeout;
+        const char *timeoutStr = celix_properties_get(endpointDescription->properties, (char*) OSGI_RSA_REMOTE_PROXY_TIMEOUT, NULL);
+        if (timeoutStr != NULL) {
+            timeout = atoi(timeoutStr);
+        }
+        curl_easy_setopt(curl, CURLOPT_URL, celix_properties_get(endpointDescription->properties, (char*) RSA_DFI_ENDPOINT_URL, NULL));
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+
         struct curl_slist *metadataHeader = NULL;
         if (metadata != NULL && celix_properties_size(metadata) > 0) {
             const char *key = NULL;
@@ -918,61 +1350,56 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
                 snprintf(header, length, "X-RSA-Metadata-%s: %s", key, val);
                 metadataHeader = curl_slist_append(metadataHeader, header);
             }
-
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, metadataHeader);
         }
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, metadataHeader);
 
-        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_READFUNCTION, remoteServiceAdmin_readCallback);
-        curl_easy_setopt(curl, CURLOPT_READDATA, &post);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, remoteServiceAdmin_write);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&get);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (curl_off_t)post.size);
-        curl_easy_setopt(curl, CURLOPT_SHARE, rsa->curlShare);
+        //NOTE the request is not copied by curl and only used during the perform
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (curl_off_t)strlen(request));
+        connection->replySize = 0;
         //celix_logHelper_log(rsa->loghelper, CELIX_LOG_LEVEL_DEBUG, "RSA: Performing curl post\n");
         res = curl_easy_perform(curl);
 
-        *reply = get.writeptr;
+        //NOTE the reply buffer stays with the connection, the caller gets a copy with the exact size
+        *reply = NULL;
+        if (res == CURLE_OK && connection->replySize > 0) {
+            *reply = malloc(connection->replySize + 1);
+            if (*reply != NULL) {
+                memcpy(*reply, connection->reply, connection->replySize);
+                (*reply)[connection->replySize] = '\0';
+            }
+        }
         *replyStatus = res;
 
-        curl_easy_cleanup(curl);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, NULL);
         curl_slist_free_all(metadataHeader);
+        remoteServiceAdmin_releaseConnection(pool, connection, res == CURLE_OK);
     }
 
     return status;
 }
 
-static size_t remoteServiceAdmin_readCallback(void *voidBuffer, size_t size, size_t nmemb, void *userp) {
-    struct post *post = userp;
-    size_t buffSize = size * nmemb;
-    size_t readSize = post->size - post->read;
-    if (readSize > buffSize) {
-        readSize = buffSize;
-    }
-    void *startRead = (void*)(post->readptr + post->read);
-    memcpy(voidBuffer, startRead, readSize);
-    post->read += readSize;
-    return readSize;
-}
-
 static size_t remoteServiceAdmin_write(void *contents, size_t size, size_t nmemb, void *userp) {
     size_t realsize = size * nmemb;
-    struct get *mem = (struct get *)userp;
+    rsa_connection_t *connection = userp;
 
-    mem->writeptr =malloc(realsize + 1);
-    if (mem->writeptr == NULL) {
-        /* out of memory! */
-        fprintf(stderr, "not enough memory (malloc returned NULL)");
-        return 0;
-    } else {
-        memcpy(&(mem->writeptr[mem->size]), contents, realsize);
-        mem->size += realsize;
-        mem->writeptr[mem->size] = 0;
-        return realsize;
+    if (connection->replySize + realsize > connection->replyCap) {
+        size_t newCap = connection->replyCap == 0 ? RSA_REPLY_BUFFER_INITIAL_SIZE : connection->replyCap;
+        while (newCap < connection->replySize + realsize) {
+            newCap *= 2;
+        }
+        char *newReply = realloc(connection->reply, newCap);
+        if (newReply == NULL) {
+            /* out of memory! */
+            fprintf(stderr, "not enough memory (realloc returned NULL)");
+            return 0;
+        }
+        connection->reply = newReply;
+        connection->replyCap = newCap;
     }
+    memcpy(connection->reply + connection->replySize, contents, realsize);
+    connection->replySize += realsize;
+    return realsize;
 }
 
 
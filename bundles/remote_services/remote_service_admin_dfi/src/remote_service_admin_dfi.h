@@ -26,6 +26,7 @@
 #include "export_registration_dfi.h"
 
 #include "remote_service_admin.h" //service typedef and remote_service_admin_t *typedef
+#include "remote_async_call.h"
 
 //typedef struct remote_service_admin *remote_service_admin_pt;
 
@@ -41,6 +42,11 @@ celix_status_t remoteServiceAdmin_getImportedEndpoints(remote_service_admin_t *a
 celix_status_t remoteServiceAdmin_importService(remote_service_admin_t *admin, endpoint_description_t *endpoint, import_registration_t **registration);
 celix_status_t remoteServiceAdmin_removeImportedService(remote_service_admin_t *admin, import_registration_t *registration);
 
+//remote async call service functions, handle is the remote service admin
+celix_status_t remoteServiceAdmin_asyncCall(void *handle, void *proxySvc, int methodIndex, void *args[], remote_async_call_t **call);
+bool remoteServiceAdmin_isAsyncCallDone(void *handle, remote_async_call_t *call);
+celix_status_t remoteServiceAdmin_awaitAsyncCall(void *handle, remote_async_call_t *call, int *returnValue);
+
 
 celix_status_t exportReference_getExportedEndpoint(export_reference_t *reference, endpoint_description_t **endpoint);
 celix_status_t exportReference_getExportedService(export_reference_t *reference, service_reference_pt *service);
@@ -33,6 +33,18 @@
 #define RSA_LOG_CALLS_FILE_KEY          "RSA_LOG_CALLS_FILE"
 #define RSA_LOG_CALLS_FILE_DEFAULT      "stdout"
 
+#define RSA_ASYNC_CALL_THREADS_KEY      "RSA_ASYNC_CALL_THREADS"
+#define RSA_ASYNC_CALL_THREADS_DEFAULT  8
+
+#define RSA_NUM_THREADS_KEY             "RSA_NUM_THREADS"
+#define RSA_NUM_THREADS_DEFAULT         10
+
+#define RSA_MAX_CONNECTIONS_PER_ENDPOINT_KEY        "RSA_MAX_CONNECTIONS_PER_ENDPOINT"
+#define RSA_MAX_CONNECTIONS_PER_ENDPOINT_DEFAULT    4
+
+#define RSA_KEEP_ALIVE_TIMEOUT_MS_KEY       "RSA_KEEP_ALIVE_TIMEOUT_MS"
+#define RSA_KEEP_ALIVE_TIMEOUT_MS_DEFAULT   2000
+
 
 
 
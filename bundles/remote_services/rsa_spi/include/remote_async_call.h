@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_REMOTE_ASYNC_CALL_H
+#define CELIX_REMOTE_ASYNC_CALL_H
+
+#include <stdbool.h>
+#include "celix_errno.h"
+
+#define REMOTE_ASYNC_CALL_SERVICE_NAME "remote.async_call"
+#define REMOTE_ASYNC_CALL_SERVICE_VERSION "1.0.0"
+
+typedef struct remote_async_call remote_async_call_t;
+
+/**
+ * Service to invoke methods of imported (proxy) services asynchronously, so that a caller can have multiple remote
+ * calls in flight (pipelining) without using a thread per call.
+ */
+typedef struct remote_async_call_service {
+    void *handle;
+
+    /**
+     * Starts a remote call of a method of an imported service.
+     *
+     * @param handle        The service handle.
+     * @param proxySvc      The imported service, as retrieved from the service registry.
+     * @param methodIndex   Index of the method in the service struct, not counting the handle (i.e. 0 is the first function pointer).
+     * @param args          Pointers to the method arguments, not counting the handle. Same as for a synchronous call,
+     *                      pre/out arguments must point to the output locations.
+     *                      The args array, the arguments and the proxySvc must stay valid until the call is awaited.
+     * @param call          Output argument for the call handle, which must be awaited.
+     * @return              CELIX_SUCCESS if the call is started, CELIX_ILLEGAL_ARGUMENT if proxySvc is not an imported
+     *                      service of this remote service admin or the method index is invalid.
+     */
+    celix_status_t (*call)(void *handle, void *proxySvc, int methodIndex, void *args[], remote_async_call_t **call);
+
+    /**
+     * Returns whether the call is done, i.e. whether await will not block.
+     */
+    bool (*isDone)(void *handle, remote_async_call_t *call);
+
+    /**
+     * Waits till the call is done and releases the call handle.
+     *
+     * @param handle        The service handle.
+     * @param call          The call handle, invalid after this call.
+     * @param returnValue   Optional output argument for the return value of the method, as returned by a synchronous call.
+     * @return              CELIX_SUCCESS if the call is performed.
+     */
+    celix_status_t (*await)(void *handle, remote_async_call_t *call, int *returnValue);
+} remote_async_call_service_t;
+
+#endif //CELIX_REMOTE_ASYNC_CALL_H
@@ -68,9 +68,9 @@ static void printFullInfo(FILE *out, bool colors, long bundleId, dm_component_in
         dm_interface_info_pt intfInfo = arrayList_get(compInfo->interfaces, interfCnt);
         fprintf(out, "   |- Interface: %s\n", intfInfo->name);
 
-        hash_map_iterator_t iter = hashMapIterator_construct((hash_map_pt) intfInfo->properties);
-        char *key = NULL;
-        while ((key = hashMapIterator_nextKey(&iter)) != NULL) {
+        celix_properties_iterator_t iter = celix_propertiesIterator_construct(intfInfo->properties);
+        const char *key = NULL;
+        while ((key = celix_propertiesIterator_nextKey(&iter)) != NULL) {
             fprintf(out, "      | %15s = %s\n", key, properties_get(intfInfo->properties, key));
         }
     }
@@ -20,6 +20,10 @@
 #include "gtest/gtest.h"
 
 #include <stdarg.h>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
 
 
 extern "C" {
@@ -610,3 +614,227 @@ public:
 TEST_F(AvrobinSerializerTests, GeneralTests) {
     generalTests();
 }
+
+TEST_F(AvrobinSerializerTests, SerializeIntoBufferAndTruncatedInput) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{[{DD one two}[Jt a b c}", "buffer", nullptr, &type));
+
+    struct test8_subtype items[2] = {{1.0, 2.0}, {3.0, 4.0}};
+    int64_t longs[3] = {-1, 0, 1LL << 40};
+    struct {
+        struct test8_type a;
+        struct { uint32_t cap; uint32_t len; int64_t *buf; } b;
+        char *c;
+    } val = {{2, 2, items}, {3, 3, longs}, (char*)"text"};
+
+    size_t size = 0;
+    ASSERT_EQ(0, avrobinSerializer_serializedSize(type, &val, &size));
+
+    uint8_t *data = nullptr;
+    size_t dataLen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(type, &val, &data, &dataLen));
+    EXPECT_EQ(size, dataLen);
+
+    uint8_t buffer[128];
+    size_t written = 0;
+    ASSERT_EQ(0, avrobinSerializer_serializeInto(type, &val, buffer, sizeof(buffer), &written));
+    ASSERT_EQ(dataLen, written);
+    EXPECT_EQ(0, memcmp(data, buffer, written));
+    EXPECT_NE(0, avrobinSerializer_serializeInto(type, &val, buffer, size - 1, &written));
+
+    //every truncation of the input must be rejected
+    for (size_t len = 0; len < dataLen; ++len) {
+        void *inst = nullptr;
+        EXPECT_NE(0, avrobinSerializer_deserialize(type, data, len, &inst));
+    }
+
+    void *inst = nullptr;
+    ASSERT_EQ(0, avrobinSerializer_deserialize(type, data, dataLen, &inst));
+    auto *result = (decltype(val)*)inst;
+    ASSERT_EQ(2, result->a.len);
+    EXPECT_EQ(4.0, result->a.buf[1].two);
+    ASSERT_EQ(3, result->b.len);
+    EXPECT_EQ(-1, result->b.buf[0]);
+    EXPECT_EQ(1LL << 40, result->b.buf[2]);
+    EXPECT_STREQ("text", result->c);
+    dynType_free(type, inst);
+
+    free(data);
+    dynType_destroy(type);
+}
+
+static void benchmark(const char* name, int count, size_t bytesPerCall, const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << " " << count << " times took " << total / 1000 << " µs (" << total / count << " ns per call, "
+              << (double)bytesPerCall * count / (double)total * 1000.0 << " MB/s)\n";
+}
+
+/**
+ * Encodes longs the way the FILE* based serializer did (zigzag varints written with fputc to a memstream).
+ * Used as baseline for the benchmark.
+ */
+static size_t memstreamEncodeLongs(const std::vector<int64_t>& values) {
+    char *buf = nullptr;
+    size_t len = 0;
+    FILE *stream = open_memstream(&buf, &len);
+    for (int64_t val : values) {
+        uint64_t uval = ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+        while (uval & ~0x7FULL) {
+            fputc((int)((uval & 0x7F) | 0x80), stream);
+            uval >>= 7;
+        }
+        fputc((int)uval, stream);
+    }
+    fclose(stream);
+    free(buf);
+    return len;
+}
+
+/**
+ * Benchmark, not part of the default run. Run with --gtest_also_run_disabled_tests --gtest_filter=*Serialization_Benchmark
+ */
+TEST_F(AvrobinSerializerTests, DISABLED_Serialization_Benchmark) {
+    struct point {
+        double x;
+        double y;
+        double z;
+    };
+    struct message {
+        int64_t id;
+        char *name;
+        struct { uint32_t cap; uint32_t len; double *buf; } samples;
+        struct { uint32_t cap; uint32_t len; int64_t *buf; } counts;
+        struct { uint32_t cap; uint32_t len; point *buf; } path;
+    };
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("Tpoint={DDD x y z};{Jt[D[J[lpoint; id name samples counts path}", "msg", nullptr, &type));
+
+    std::vector<double> samples(1000);
+    std::vector<int64_t> counts(1000);
+    std::vector<point> path(100);
+    for (int i = 0; i < 1000; ++i) {
+        samples[i] = i * 0.5;
+        counts[i] = i * 1000 - 500000;
+    }
+    for (int i = 0; i < 100; ++i) {
+        path[i] = point{(double)i, i * 2.0, i * 3.0};
+    }
+    message msg{42, (char*)"benchmark", {1000, 1000, samples.data()}, {1000, 1000, counts.data()}, {100, 100, path.data()}};
+
+    uint8_t *data = nullptr;
+    size_t dataLen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(type, &msg, &data, &dataLen));
+
+    const int count = 2000;
+    benchmark("Avrobin serialize", count, dataLen, [&]{
+        uint8_t *out = nullptr;
+        size_t outLen = 0;
+        avrobinSerializer_serialize(type, &msg, &out, &outLen);
+        free(out);
+    });
+    benchmark("Avrobin deserialize", count, dataLen, [&]{
+        void *inst = nullptr;
+        avrobinSerializer_deserialize(type, data, dataLen, &inst);
+        dynType_free(type, inst);
+    });
+
+    //complex type with strings, enums, nested complex types and sequences of complex types
+    struct location {
+        double lat;
+        double lon;
+    };
+    struct sample {
+        int64_t time;
+        char *unit;
+        int32_t status;
+        struct { uint32_t cap; uint32_t len; double *buf; } values;
+        location loc;
+    };
+    struct report {
+        int64_t id;
+        char *source;
+        char *description;
+        struct { uint32_t cap; uint32_t len; sample *buf; } samples;
+        bool valid;
+    };
+    dyn_type *reportType = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("Tlocation={DD lat lon};Tsample={Jt#OK=0;#WARN=1;#ERROR=2;E[Dllocation; time unit status values loc};"
+                                      "{Jtt[lsample;Z id source description samples valid}", "report", nullptr, &reportType));
+    std::vector<double> values(10);
+    for (int i = 0; i < 10; ++i) {
+        values[i] = i * 0.25;
+    }
+    std::vector<sample> reportSamples(200);
+    for (int i = 0; i < 200; ++i) {
+        reportSamples[i] = sample{1600000000000LL + i, (char*)"degrees celsius", i % 3, {10, 10, values.data()}, {52.0 + i * 0.001, 4.5 - i * 0.001}};
+    }
+    report rep{7, (char*)"sensor-node-12", (char*)"periodic temperature report of the sensor node",
+               {200, 200, reportSamples.data()}, true};
+    uint8_t *reportData = nullptr;
+    size_t reportLen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(reportType, &rep, &reportData, &reportLen));
+    benchmark("Avrobin serialize complex", count, reportLen, [&]{
+        uint8_t *out = nullptr;
+        size_t outLen = 0;
+        avrobinSerializer_serialize(reportType, &rep, &out, &outLen);
+        free(out);
+    });
+    benchmark("Avrobin deserialize complex", count, reportLen, [&]{
+        void *inst = nullptr;
+        avrobinSerializer_deserialize(reportType, reportData, reportLen, &inst);
+        dynType_free(reportType, inst);
+    });
+    void *reportInst = nullptr;
+    ASSERT_EQ(0, avrobinSerializer_deserialize(reportType, reportData, reportLen, &reportInst));
+    auto *reportResult = (report*)reportInst;
+    EXPECT_STREQ("sensor-node-12", reportResult->source);
+    EXPECT_TRUE(reportResult->valid);
+    ASSERT_EQ(200, reportResult->samples.len);
+    EXPECT_STREQ("degrees celsius", reportResult->samples.buf[199].unit);
+    EXPECT_EQ(199 % 3, reportResult->samples.buf[199].status);
+    ASSERT_EQ(10, reportResult->samples.buf[199].values.len);
+    EXPECT_EQ(2.25, reportResult->samples.buf[199].values.buf[9]);
+    EXPECT_EQ(4.5 - 199 * 0.001, reportResult->samples.buf[199].loc.lon);
+    dynType_free(reportType, reportInst);
+    free(reportData);
+    dynType_destroy(reportType);
+
+    //sequence of longs only, compared with the FILE* memstream based encoding
+    dyn_type *longsType = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("[J", "longs", nullptr, &longsType));
+    uint8_t *longsData = nullptr;
+    size_t longsLen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(longsType, &msg.counts, &longsData, &longsLen));
+    free(longsData);
+    benchmark("FILE* memstream encode longs (baseline)", count, longsLen, [&]{
+        memstreamEncodeLongs(counts);
+    });
+    benchmark("Avrobin serialize longs", count, longsLen, [&]{
+        uint8_t *out = nullptr;
+        size_t outLen = 0;
+        avrobinSerializer_serialize(longsType, &msg.counts, &out, &outLen);
+        free(out);
+    });
+
+    void *inst = nullptr;
+    ASSERT_EQ(0, avrobinSerializer_deserialize(type, data, dataLen, &inst));
+    auto *result = (message*)inst;
+    EXPECT_EQ(42, result->id);
+    EXPECT_STREQ("benchmark", result->name);
+    ASSERT_EQ(1000, result->samples.len);
+    EXPECT_EQ(499.5, result->samples.buf[999]);
+    ASSERT_EQ(1000, result->counts.len);
+    EXPECT_EQ(-500000, result->counts.buf[0]);
+    ASSERT_EQ(100, result->path.len);
+    EXPECT_EQ(297.0, result->path.buf[99].z);
+    dynType_free(type, inst);
+
+    free(data);
+    dynType_destroy(longsType);
+    dynType_destroy(type);
+}
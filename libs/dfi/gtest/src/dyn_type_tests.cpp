@@ -24,6 +24,7 @@ extern "C" {
     
     #include "dyn_common.h"
     #include "dyn_type.h"
+    #include "dyn_type_common.h"
 
 	static void stdLog(void*, int level, const char *file, int line, const char *msg, ...) {
 	    va_list ap;
@@ -323,4 +324,37 @@ TEST_F(DynTypeTests, NrOfEntriesTest) {
     ASSERT_EQ(0, rc);
     ASSERT_EQ(4, dynType_complex_nrOfEntries(type));
     dynType_destroy(type);
-}
\ No newline at end of file
+}
+TEST_F(DynTypeTests, CompilePlanTest) {
+    dyn_type *type = NULL;
+    int rc = dynType_parseWithStr("Tpoint={DD x y};{lpoint;{I c}[Dt a b d e}", NULL, NULL, &type);
+    ASSERT_EQ(0, rc);
+    ASSERT_EQ(0, dynType_compile(type));
+
+    const struct dyn_type_plan *plan = dynType_plan(type);
+    ASSERT_TRUE(plan != NULL);
+    ASSERT_EQ(plan, dynType_plan(type)); //cached
+    EXPECT_FALSE(plan->packedReals);
+
+    //nested complex types are inlined
+    const char *descriptors = "{{DD}{I}[t}";
+    ASSERT_EQ(strlen(descriptors), plan->nrOfOps);
+    for (size_t i = 0; i < plan->nrOfOps; ++i) {
+        EXPECT_EQ(descriptors[i], plan->ops[i].descriptor);
+    }
+    EXPECT_EQ(DYN_TYPE_PLAN_BEGIN_COMPLEX, plan->ops[0].kind);
+    EXPECT_EQ(10, plan->ops[0].end);
+    EXPECT_STREQ("a", plan->ops[1].name);
+    EXPECT_EQ(4, plan->ops[1].end);
+    EXPECT_STREQ("y", plan->ops[3].name);
+    EXPECT_EQ(sizeof(double), plan->ops[3].offset);
+    EXPECT_EQ(2 * sizeof(double), plan->ops[6].offset);
+    EXPECT_EQ(DYN_TYPE_PLAN_SEQUENCE, plan->ops[8].kind);
+    EXPECT_EQ(sizeof(double), plan->ops[8].itemSize);
+
+    const struct dyn_type_plan *itemPlan = dynType_plan(plan->ops[8].subType);
+    ASSERT_TRUE(itemPlan != NULL);
+    EXPECT_TRUE(itemPlan->packedReals);
+    EXPECT_TRUE(dynType_plan(plan->ops[1].type)->packedReals);
+    dynType_destroy(type);
+}
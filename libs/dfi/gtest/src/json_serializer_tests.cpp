@@ -19,12 +19,16 @@
 
 #include "gtest/gtest.h"
 
+#include <cmath>
+#include <string>
+
 extern "C" {
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <locale.h>
 
 #include <ffi.h>
 
@@ -1437,3 +1441,246 @@ TEST_F(JsonSerializerTests, WriteTest3) {
     writeAvprTest3();
 }
 
+
+/**
+ * Serializes the instance with the streaming serializer and with jansson (json_t + json_dumps) and checks if
+ * the output is the same.
+ */
+static std::string checkStreamingOutput(dyn_type *type, void *inst) {
+    char *streamed = nullptr;
+    EXPECT_EQ(0, jsonSerializer_serialize(type, inst, &streamed));
+    json_t *root = nullptr;
+    EXPECT_EQ(0, jsonSerializer_serializeJson(type, inst, &root));
+    char *dumped = json_dumps(root, JSON_COMPACT);
+    EXPECT_STREQ(dumped, streamed);
+    std::string result = streamed == nullptr ? "" : streamed;
+    free(dumped);
+    free(streamed);
+    json_decref(root);
+    return result;
+}
+
+TEST_F(JsonSerializerTests, StreamingOutputIsJanssonCompatible) {
+    struct {
+        const char *descriptor;
+        const char *input;
+    } examples[] = {
+        {"{DFJISBbsijZN a b c d e f g h i j k l}",
+            R"({"a":0.1,"b":8.8,"c":-9223372036854775808,"d":-2147483648,"e":-32768,"f":-128,"g":255,"h":65535,"i":4294967295,"j":-1,"k":true,"l":42})"},
+        {"{DDDDDDD a b c d e f g}", R"({"a":3,"b":1e300,"c":-0.0,"d":1e-7,"e":123456789.125,"f":5e-324,"g":-2.5E+20})"},
+        {"{tt a b}", R"({"a":"\"\\\/\b\f\n\r\t\u0001\u001f","b":"café € 😀 é"})"},
+        {"{[I[[D{[tZ a b} a b c}", R"({"a":[1,2,3],"b":[[],[1.5,2.5]],"c":{"a":["x","y"],"b":false}})"},
+        {"Tperson={ti name age};{[Lperson;*Lperson; persons best}", R"({"persons":[{"name":"John","age":33},{"name":"Carol","age":55}],"best":{"name":"Elton","age":66}})"},
+        {"{#v1=0;#v2=1;E[#a=1;#b=2;E e s}", R"({"e":"v2","s":["b","a","b"]})"},
+        {"[D", "[1.0,2.0,0.30000000000000004]"},
+    };
+
+    for (auto &example : examples) {
+        dyn_type *type = nullptr;
+        ASSERT_EQ(0, dynType_parseWithStr(example.descriptor, nullptr, nullptr, &type)) << example.descriptor;
+        void *inst = nullptr;
+        ASSERT_EQ(0, jsonSerializer_deserialize(type, example.input, strlen(example.input), &inst)) << example.input;
+        checkStreamingOutput(type, inst);
+        dynType_free(type, inst);
+        dynType_destroy(type);
+    }
+}
+
+TEST_F(JsonSerializerTests, StreamingOutputOmitsUnsupportedValues) {
+    struct example {
+        double a;
+        double b;
+        const char *c;
+        const char *d;
+        int32_t e;
+        int32_t *f;
+    };
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{DDtt#v1=0;E*I a b c d e f}", nullptr, nullptr, &type));
+
+    //NaN, NULL strings, invalid UTF-8 strings and unknown enum values are omitted
+    int32_t f = 3;
+    char invalidUtf8[] = {'a', (char)0xC3, 'b', '\0'};
+    example ex {NAN, 1.5, nullptr, invalidUtf8, 2, &f};
+    EXPECT_EQ(R"({"b":1.5,"f":3})", checkStreamingOutput(type, &ex));
+
+    example ex2 {INFINITY, 2.0, "c", "d", 0, &f};
+    EXPECT_EQ(R"({"b":2.0,"c":"c","d":"d","e":"v1","f":3})", checkStreamingOutput(type, &ex2));
+
+    //NULL typed pointers are omitted as well (not supported by the jansson based serializer)
+    ex2.f = nullptr;
+    char *result = nullptr;
+    ASSERT_EQ(0, jsonSerializer_serialize(type, &ex2, &result));
+    EXPECT_STREQ(R"({"b":2.0,"c":"c","d":"d","e":"v1"})", result);
+    free(result);
+
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, StreamingRoundTrip) {
+    const char *descriptor = "Tperson={ti name age};{[Lperson;t[[IZD persons text matrix flag value}";
+    const char *input = R"( { "persons" : [ { "age" : 33, "name" : "John" }, {"name":"Carol"} ],
+        "text" : "a\nb", "matrix" : [[1, 2], [], [3]], "flag" : true, "value" : 2.5 } )";
+    const char *expected = R"({"persons":[{"name":"John","age":33},{"name":"Carol","age":0}],"text":"a\nb","matrix":[[1,2],[],[3]],"flag":true,"value":2.5})";
+
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr(descriptor, nullptr, nullptr, &type));
+    void *inst = nullptr;
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), &inst));
+    EXPECT_EQ(expected, checkStreamingOutput(type, inst));
+    dynType_free(type, inst);
+
+    //the last value of a duplicate member is used
+    const char *duplicate = R"({"text":"first","persons":[{"name":"A"}],"text":"second","persons":[]})";
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, duplicate, strlen(duplicate), &inst));
+    char *result = nullptr;
+    ASSERT_EQ(0, jsonSerializer_serialize(type, inst, &result));
+    EXPECT_STREQ(R"({"persons":[],"text":"second","matrix":[],"flag":false,"value":0.0})", result);
+    free(result);
+    dynType_free(type, inst);
+
+    //input does not have to be '\0' terminated
+    std::string withTrailingData = std::string{expected} + "garbage";
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, withTrailingData.c_str(), strlen(expected), &inst));
+    dynType_free(type, inst);
+
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, StreamingParseIntegerForRealMember) {
+    //an integer json value for a real member is 0, same as the jansson based deserializer (json_real_value)
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{DFD a b c}", nullptr, nullptr, &type));
+    const char *input = R"({"a":2,"b":-3,"c":2.0})";
+    struct {
+        double a;
+        float b;
+        double c;
+    } *streamed = nullptr, *parsed = nullptr;
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), (void**)&streamed));
+    json_t *root = json_loads(input, JSON_DECODE_ANY, nullptr);
+    ASSERT_EQ(0, jsonSerializer_deserializeJson(type, root, (void**)&parsed));
+    EXPECT_EQ(0.0, streamed->a);
+    EXPECT_EQ(0.0f, streamed->b);
+    EXPECT_EQ(2.0, streamed->c);
+    EXPECT_EQ(parsed->a, streamed->a);
+    EXPECT_EQ(parsed->b, streamed->b);
+    EXPECT_EQ(parsed->c, streamed->c);
+    json_decref(root);
+    dynType_free(type, streamed);
+    dynType_free(type, parsed);
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, StreamingRealsAreLocaleIndependent) {
+    const char *locales[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "nl_NL.UTF-8", "fr_FR.UTF-8"};
+    std::string previous = setlocale(LC_NUMERIC, nullptr);
+    bool commaLocale = false;
+    for (auto *locale : locales) {
+        if (setlocale(LC_NUMERIC, locale) != nullptr && *localeconv()->decimal_point == ',') {
+            commaLocale = true;
+            break;
+        }
+    }
+    if (!commaLocale) {
+        setlocale(LC_NUMERIC, previous.c_str());
+        GTEST_SKIP() << "no locale with a ',' decimal point available";
+    }
+
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{DF[D a b c}", nullptr, nullptr, &type));
+    const char *input = R"({"a":1.5,"b":-0.25,"c":[0.0078125,123456.125,1e20,2.0]})";
+    void *inst = nullptr;
+    EXPECT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), &inst));
+    char *result = nullptr;
+    EXPECT_EQ(0, jsonSerializer_serialize(type, inst, &result));
+    setlocale(LC_NUMERIC, previous.c_str());
+
+    ASSERT_NE(nullptr, result);
+    EXPECT_STREQ(R"({"a":1.5,"b":-0.25,"c":[0.0078125,123456.125,1e20,2.0]})", result);
+    free(result);
+    dynType_free(type, inst);
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, StreamingParseInvalidInput) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{It[J a b c}", nullptr, nullptr, &type));
+
+    const char *invalid[] = {
+        "",
+        R"({"a":1)",
+        R"({"a":1} x)",
+        R"({"a":01})",
+        R"({"a":1,})",
+        R"({"a":-})",
+        R"({"c":[1 2]})",
+        R"({"c":[1,]})",
+        R"({"c":[99999999999999999999]})",
+        R"({"a":1e999})",
+        R"({"b":"\x"})",
+        R"({"b":"\u0000"})",
+        R"({"b":"\ud800"})",
+        "{\"b\":\"a\nb\"}",
+        "{\"b\":\"\xff\"}",
+        R"({"b":1})",
+        R"({"c":{}})",
+        R"({"d":1})",
+        R"({"a":nul})",
+        R"({"a":{"x":[1,}})",
+    };
+    for (auto *input : invalid) {
+        void *inst = (void*)0x1;
+        EXPECT_NE(0, jsonSerializer_deserialize(type, input, strlen(input), &inst)) << input;
+        EXPECT_EQ(nullptr, inst) << input;
+    }
+
+    //values of the wrong type for numbers and complex types are skipped (same as the jansson based serializer)
+    const char *input = R"({"a":{"x":[1,{"y":null}]},"b":null,"c":[true,"1",2]})";
+    struct {
+        int32_t a;
+        char *b;
+        struct {
+            uint32_t cap;
+            uint32_t len;
+            int64_t *buf;
+        } c;
+    } *inst = nullptr;
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), (void**)&inst));
+    EXPECT_EQ(0, inst->a);
+    EXPECT_EQ(nullptr, inst->b);
+    ASSERT_EQ(3, inst->c.len);
+    EXPECT_EQ(0, inst->c.buf[0]);
+    EXPECT_EQ(2, inst->c.buf[2]);
+    dynType_free(type, inst);
+
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, MemberIndexTest) {
+    std::string descriptor = "{";
+    std::string names;
+    for (int i = 0; i < 100; ++i) {
+        descriptor += "I";
+        names += " m" + std::to_string(99 - i);
+    }
+    descriptor += names + "}";
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr(descriptor.c_str(), nullptr, nullptr, &type));
+    for (int i = 0; i < 100; ++i) {
+        std::string name = "m" + std::to_string(99 - i);
+        EXPECT_EQ(i, dynType_complex_indexForName(type, name.c_str()));
+    }
+    EXPECT_EQ(-1, dynType_complex_indexForName(type, "m"));
+    EXPECT_EQ(-1, dynType_complex_indexForName(type, "m100"));
+    EXPECT_EQ(-1, dynType_complex_indexForName(type, ""));
+
+    std::string input = R"({"m0":0,"m99":99,"m50":50,"m0":1})";
+    auto *inst = (int32_t*)nullptr;
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input.c_str(), input.size(), (void**)&inst));
+    EXPECT_EQ(1, inst[99]);
+    EXPECT_EQ(99, inst[0]);
+    EXPECT_EQ(50, inst[49]);
+    dynType_free(type, inst);
+    dynType_destroy(type);
+}
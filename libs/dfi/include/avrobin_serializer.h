@@ -35,6 +35,17 @@ int avrobinSerializer_deserialize(dyn_type *type, const uint8_t *input, size_t i
 
 int avrobinSerializer_serialize(dyn_type *type, const void *input, uint8_t **output, size_t *outlen);
 
+/**
+ * Calculates the exact number of bytes needed to serialize the input.
+ */
+int avrobinSerializer_serializedSize(dyn_type *type, const void *input, size_t *size);
+
+/**
+ * Serializes the input into a caller provided buffer. Fails if the buffer is too small,
+ * see avrobinSerializer_serializedSize.
+ */
+int avrobinSerializer_serializeInto(dyn_type *type, const void *input, uint8_t *buffer, size_t bufferSize, size_t *outlen);
+
 int avrobinSerializer_generateSchema(dyn_type *type, char **output);
 
 int avrobinSerializer_saveFile(const char *filename, const char *schema, const uint8_t *serdata, size_t serdatalen);
@@ -205,6 +205,15 @@ void dynType_print(dyn_type *type, FILE *stream);
  */
 size_t dynType_size(dyn_type *type);
 
+/**
+ * Compiles the serialization plan of the dyn type, used by the json and avrobin serializers.
+ * The plan is otherwise compiled on the first (de)serialization of the type.
+ *
+ * @param type  The dyn type.
+ * @return      0 on success.
+ */
+int dynType_compile(dyn_type *type);
+
 /**
  * The type of the dyn type
  * E.g. DYN_TYPE_SIMPLE, DYN_TYPE_COMPLEX, etc
@@ -33,6 +33,60 @@ extern "C" {
 
 DFI_SETUP_LOG_HEADER(dynTypeCommon);
 
+/**
+ * Entry of the member name index of a complex type. The index is sorted on name (and member index for
+ * duplicate names), so that members can be looked up using a binary search.
+ */
+struct complex_type_name_index_entry {
+    const char *name; //NOTE: not owned, points to the complex_type_entry name
+    size_t nameLength;
+    int index;
+};
+
+/**
+ * Memory layout of a sequence instance.
+ */
+struct generic_sequence {
+    uint32_t cap;
+    uint32_t len;
+    void *buf;
+};
+
+/**
+ * Instruction kinds of a serialization plan.
+ */
+enum dyn_type_plan_kind {
+    DYN_TYPE_PLAN_VALUE, //simple value, enum or text. The descriptor tells which one
+    DYN_TYPE_PLAN_BEGIN_COMPLEX, //start of a complex type, the instructions of its members follow
+    DYN_TYPE_PLAN_END_COMPLEX,
+    DYN_TYPE_PLAN_SEQUENCE, //the items are serialized with the plan of the item type
+    DYN_TYPE_PLAN_TYPED_POINTER //the pointed to value is serialized with the plan of the typed type
+};
+
+/**
+ * Instruction of a serialization plan. References are already resolved.
+ */
+struct dyn_type_plan_op {
+    enum dyn_type_plan_kind kind;
+    char descriptor;
+    const char *name; //NOTE: not owned, member name or NULL for the root of the plan
+    size_t offset; //offset relative to the start of the instance the plan is executed for
+    dyn_type *type; //the (resolved) type of the value
+    dyn_type *subType; //item type for sequences, typed type for typed pointers
+    size_t itemSize; //item size for sequences
+    size_t end; //index of the matching DYN_TYPE_PLAN_END_COMPLEX for DYN_TYPE_PLAN_BEGIN_COMPLEX
+};
+
+/**
+ * Flat serialization plan of a dyn type. By value complex types are inlined, so executing the plan for an instance
+ * is a single loop over the instructions. Sequences and typed pointers refer to the plan of their item/typed type.
+ */
+struct dyn_type_plan {
+    struct dyn_type_plan_op *ops;
+    size_t nrOfOps;
+    bool packedReals; //true if the instance only consists of floats and doubles without any padding
+};
+
 struct _dyn_type {
     char *name;
     char descriptor;
@@ -42,11 +96,15 @@ struct _dyn_type {
     struct types_head *referenceTypes; //NOTE: not owned
     struct types_head nestedTypesHead;
     struct meta_properties_head metaProperties;
+    struct dyn_type_plan *plan; //compiled on first use or by dynType_compile, see dynType_plan
     union {
         struct {
             struct complex_type_entries_head entriesHead;
             ffi_type structType; //dyn_type.ffiType points to this
             dyn_type **types; //based on entriesHead for fast access
+            size_t *offsets; //member offsets, based on entriesHead for fast access
+            struct complex_type_name_index_entry *nameIndex; //sorted on name for fast member lookup
+            size_t nameIndexSize;
         } complex;
         struct {
             ffi_type seqType; //dyn_type.ffiType points to this
@@ -64,6 +122,23 @@ struct _dyn_type {
 dyn_type * dynType_findType(dyn_type *type, char *name);
 ffi_type * dynType_ffiType(dyn_type * type);
 void dynType_prepCif(ffi_type *type);
+void dynType_deepFree(dyn_type *type, void *loc, bool alsoDeleteSelf);
+
+/**
+ * Creates the member offsets and the member name index of a (prepped) complex type.
+ */
+int dynType_complex_buildIndex(dyn_type *type);
+
+/**
+ * Returns the index of the member with the provided name (not necessarily '\0' terminated) or -1 if not found.
+ */
+int dynType_complex_indexForNameWithLength(dyn_type *type, const char *name, size_t nameLength);
+
+/**
+ * Returns the serialization plan of the type, compiles and caches the plan if needed.
+ * Safe to call concurrently. Returns NULL if the plan could not be created.
+ */
+const struct dyn_type_plan* dynType_plan(dyn_type *type);
 
 #ifdef __cplusplus
 }
@@ -20,41 +20,74 @@
 #include "dyn_type_common.h"
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <jansson.h>
 
 #define MAX_VARINT_BUF_SIZE 10
 
+//avro floats and doubles are little endian, on little endian hosts they can be copied as is
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define AVROBIN_LITTLE_ENDIAN_HOST 1
+#else
+#define AVROBIN_LITTLE_ENDIAN_HOST 0
+#endif
+
+/**
+ * Read cursor over the avrobin input. All reads are bounds checked against end.
+ */
+typedef struct avrobin_reader {
+    const uint8_t *pos;
+    const uint8_t *end;
+} avrobin_reader_t;
+
+/**
+ * Write cursor over a preallocated output buffer. All writes are bounds checked against cap.
+ * If buf is NULL nothing is written and only len is updated, which is used to calculate the exact serialized size.
+ */
+typedef struct avrobin_writer {
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+} avrobin_writer_t;
+
 static int generate_sync(uint8_t **result);
 static int generate_record_name(char **result);
 
-static int avrobin_read_boolean(FILE *stream,bool *val);
-static int avrobin_read_int(FILE *stream,int32_t *val);
-static int avrobin_read_long(FILE *stream,int64_t *val);
-static int avrobin_read_float(FILE *stream,float *val);
-static int avrobin_read_double(FILE *stream,double *val);
-static int avrobin_read_string(FILE *stream,char **val);
-
-static int avrobin_write_boolean(FILE *stream,bool val);
-static int avrobin_write_int(FILE *stream,int32_t val);
-static int avrobin_write_long(FILE *stream,int64_t val);
-static int avrobin_write_float(FILE *stream,float val);
-static int avrobin_write_double(FILE *stream,double val);
-static int avrobin_write_string(FILE *stream,const char *val);
+static int avrobin_read_boolean(avrobin_reader_t *reader,bool *val);
+static int avrobin_read_int(avrobin_reader_t *reader,int32_t *val);
+static int avrobin_read_long(avrobin_reader_t *reader,int64_t *val);
+static int avrobin_read_float(avrobin_reader_t *reader,float *val);
+static int avrobin_read_double(avrobin_reader_t *reader,double *val);
+static int avrobin_read_string(avrobin_reader_t *reader,char **val);
+
+static int avrobin_write_bytes(avrobin_writer_t *writer,const void *data,size_t size);
+static int avrobin_write_boolean(avrobin_writer_t *writer,bool val);
+static int avrobin_write_int(avrobin_writer_t *writer,int32_t val);
+static int avrobin_write_long(avrobin_writer_t *writer,int64_t val);
+static int avrobin_write_float(avrobin_writer_t *writer,float val);
+static int avrobin_write_double(avrobin_writer_t *writer,double val);
+static int avrobin_write_string(avrobin_writer_t *writer,const char *val);
 
 static int avrobin_schema_primitive(const char *tname, json_t **output);
 
-static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **result);
-static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, FILE *stream);
-
-static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, FILE *stream);
+static int avrobinSerializer_createType(dyn_type *type, avrobin_reader_t *reader, void **result);
+static int avrobinSerializer_parsePlan(const struct dyn_type_plan *plan, void *inst, avrobin_reader_t *reader);
+static int avrobinSerializer_parseValue(const struct dyn_type_plan_op *op, void *loc, avrobin_reader_t *reader);
+static int avrobinSerializer_parseSequence(const struct dyn_type_plan_op *op, void *loc, avrobin_reader_t *reader);
+static int avrobinSerializer_parseItems(const struct dyn_type_plan *itemPlan, size_t itemSize, void *items, uint32_t count, avrobin_reader_t *reader);
+static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, avrobin_reader_t *reader);
+
+static int avrobinSerializer_writeType(dyn_type *type, const void *inst, avrobin_writer_t *writer);
+static int avrobinSerializer_writePlan(const struct dyn_type_plan *plan, const void *inst, avrobin_writer_t *writer);
+static int avrobinSerializer_writeValue(const struct dyn_type_plan_op *op, const void *loc, avrobin_writer_t *writer);
+static int avrobinSerializer_writeSequence(const struct dyn_type_plan_op *op, const void *loc, avrobin_writer_t *writer);
+static int avrobinSerializer_writeItems(const struct dyn_type_plan *itemPlan, size_t itemSize, const void *items, uint32_t count, avrobin_writer_t *writer);
+static int avrobinSerializer_writeEnum(dyn_type *type, const void *loc, avrobin_writer_t *writer);
+static int avrobinSerializer_writeContainer(avrobin_writer_t *writer, const char *schema, const uint8_t *sync, const uint8_t *serdata, size_t serdatalen);
 
 static int avrobinSerializer_generateAny(dyn_type *type, json_t **output);
 static int avrobinSerializer_generateComplex(dyn_type *type, json_t **output);
@@ -71,42 +104,80 @@ DFI_SETUP_LOG(avrobinSerializer);
 int avrobinSerializer_deserialize(dyn_type *type, const uint8_t *input, size_t inlen, void **result) {
     int status = OK;
 
-    FILE *stream = fmemopen((void*)input, inlen, "rb");
-
-    if (stream != NULL) {
-        status = avrobinSerializer_createType(type, stream, result);
-
-        fclose(stream);
+    if (input != NULL || inlen == 0) {
+        avrobin_reader_t reader;
+        reader.pos = input;
+        reader.end = input + inlen;
+        status = avrobinSerializer_createType(type, &reader, result);
 
         if (status != OK) {
             LOG_ERROR("Error cannot deserialize avrobin.");
         }
     } else {
         status = ERROR;
-        LOG_ERROR("Error initializing memory stream for reading. Length was %d.", inlen);
+        LOG_ERROR("Error no input provided. Length was %zu.", inlen);
     }
 
     return status;
 }
 
-int avrobinSerializer_serialize(dyn_type *type, const void *input, uint8_t **output, size_t *outlen) {
+int avrobinSerializer_serializedSize(dyn_type *type, const void *input, size_t *size) {
+    avrobin_writer_t writer;
+    writer.buf = NULL;
+    writer.len = 0;
+    writer.cap = SIZE_MAX;
+
+    int status = avrobinSerializer_writeType(type, input, &writer);
+    if (status == OK) {
+        *size = writer.len;
+    }
+    return status;
+}
+
+int avrobinSerializer_serializeInto(dyn_type *type, const void *input, uint8_t *buffer, size_t bufferSize, size_t *outlen) {
     int status = OK;
 
-    FILE *stream = open_memstream((char**)output, outlen);
+    if (buffer != NULL) {
+        avrobin_writer_t writer;
+        writer.buf = buffer;
+        writer.len = 0;
+        writer.cap = bufferSize;
+
+        status = avrobinSerializer_writeType(type, input, &writer);
+        if (status == OK) {
+            *outlen = writer.len;
+        }
+    } else {
+        status = ERROR;
+        LOG_ERROR("Error no output buffer provided.");
+    }
 
-    if (stream != NULL) {
-        status = avrobinSerializer_writeAny(type, (void*)input, stream);
+    return status;
+}
 
-        fclose(stream);
+int avrobinSerializer_serialize(dyn_type *type, const void *input, uint8_t **output, size_t *outlen) {
+    size_t size = 0;
+    uint8_t *buf = NULL;
 
-        if (status != OK) {
-            free(*output);
+    int status = avrobinSerializer_serializedSize(type, input, &size);
 
-            LOG_ERROR("Error cannot serialize avrobin.");
+    if (status == OK) {
+        buf = malloc(size > 0 ? size : 1);
+        if (buf == NULL) {
+            status = ERROR;
+            LOG_ERROR("Error allocating memory for avrobin output.");
         }
+    }
+
+    if (status == OK) {
+        status = avrobinSerializer_serializeInto(type, input, buf, size, outlen);
+    }
+
+    if (status == OK) {
+        *output = buf;
     } else {
-        status = ERROR;
-        LOG_ERROR("Error initializing memory stream for writing.");
+        free(buf);
+        LOG_ERROR("Error cannot serialize avrobin.");
     }
 
     return status;
@@ -134,101 +205,94 @@ int avrobinSerializer_generateSchema(dyn_type *type, char **output) {
 }
 
 int avrobinSerializer_saveFile(const char *filename, const char *schema, const uint8_t *serdata, size_t serdatalen) {
-    int status = OK;
+    uint8_t *sync = NULL;
+    uint8_t *buf = NULL;
+    avrobin_writer_t writer;
+    writer.buf = NULL;
+    writer.len = 0;
+    writer.cap = SIZE_MAX;
 
-    FILE *file = fopen(filename, "wb");
+    int status = generate_sync(&sync);
 
-    if (file != NULL) {
-        if (status == OK) {
-            if (fputc('O', file) == EOF) {
-                status = ERROR;
-            }
-        }
-        if (status == OK) {
-            if (fputc('b', file) == EOF) {
-                status = ERROR;
-            }
+    //first calculate the container size, then write the container in one go
+    if (status == OK) {
+        status = avrobinSerializer_writeContainer(&writer, schema, sync, serdata, serdatalen);
+    }
+    if (status == OK) {
+        buf = malloc(writer.len);
+        if (buf == NULL) {
+            status = ERROR;
         }
-        if (status == OK) {
-            if (fputc('j', file) == EOF) {
+    }
+    if (status == OK) {
+        writer.buf = buf;
+        writer.cap = writer.len;
+        writer.len = 0;
+        status = avrobinSerializer_writeContainer(&writer, schema, sync, serdata, serdatalen);
+    }
+    if (status == OK) {
+        FILE *file = fopen(filename, "wb");
+        if (file != NULL) {
+            if (fwrite(buf, 1, writer.len, file) != writer.len) {
                 status = ERROR;
             }
-        }
-        if (status == OK) {
-            if (fputc(1, file) == EOF) {
+            if (fclose(file) != 0) {
                 status = ERROR;
             }
+        } else {
+            status = ERROR;
         }
-        if (status == OK) {
-            status = avrobin_write_long(file, 1);
-        }
-        if (status == OK) {
-            status = avrobin_write_string(file, "avro.schema");
-        }
-        if (status == OK) {
-            status = avrobin_write_string(file, schema);
-        }
-        if (status == OK) {
-            status = avrobin_write_long(file, 0);
-        }
-        if (status == OK) {
-            uint8_t *sync = NULL;
-            status = generate_sync(&sync);
-            if (status == OK) {
-                for (int i=0; i<16; i++) {
-                    if (status == OK) {
-                        if (fputc(sync[i], file) == EOF) {
-                            status = ERROR;
-                        }
-                    }
-                    if (status != OK) break;
-                }
-                if (status == OK) {
-                    status = avrobin_write_long(file, 1);
-                }
-                if (status == OK) {
-                    status = avrobin_write_long(file, serdatalen);
-                }
-                if (status == OK) {
-                    for (int i=0; i<serdatalen; i++) {
-                        if (status == OK) {
-                            if (fputc(serdata[i], file) == EOF) {
-                                status = ERROR;
-                            }
-                        }
-                        if (status != OK) break;
-                    }
-                }
-                for (int i=0; i<16; i++) {
-                    if (status == OK) {
-                        if (fputc(sync[i], file) == EOF) {
-                            status = ERROR;
-                        }
-                    }
-                    if (status != OK) break;
-                }
+    }
 
-                free(sync);
-            }
-        }
+    free(buf);
+    free(sync);
+    return status;
+}
 
-        fclose(file);
-    } else {
-        status = ERROR;
-    }
+static int avrobinSerializer_writeContainer(avrobin_writer_t *writer, const char *schema, const uint8_t *sync, const uint8_t *serdata, size_t serdatalen) {
+    static const uint8_t magic[4] = { 'O', 'b', 'j', 1 };
 
+    int status = avrobin_write_bytes(writer, magic, sizeof(magic));
+    if (status == OK) {
+        status = avrobin_write_long(writer, 1);
+    }
+    if (status == OK) {
+        status = avrobin_write_string(writer, "avro.schema");
+    }
+    if (status == OK) {
+        status = avrobin_write_string(writer, schema);
+    }
+    if (status == OK) {
+        status = avrobin_write_long(writer, 0);
+    }
+    if (status == OK) {
+        status = avrobin_write_bytes(writer, sync, 16);
+    }
+    if (status == OK) {
+        status = avrobin_write_long(writer, 1);
+    }
+    if (status == OK) {
+        status = avrobin_write_long(writer, (int64_t)serdatalen);
+    }
+    if (status == OK) {
+        status = avrobin_write_bytes(writer, serdata, serdatalen);
+    }
+    if (status == OK) {
+        status = avrobin_write_bytes(writer, sync, 16);
+    }
     return status;
 }
 
-static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **result) {
+static int avrobinSerializer_createType(dyn_type *type, avrobin_reader_t *reader, void **result) {
     int status = OK;
     void *inst = NULL;
+    const struct dyn_type_plan *plan = dynType_plan(type);
 
-    status = dynType_alloc(type, &inst);
+    status = plan != NULL ? dynType_alloc(type, &inst) : ERROR;
 
     if (status == OK) {
         assert(inst != NULL);
-        status = avrobinSerializer_parseAny(type, inst, stream);
+        status = avrobinSerializer_parsePlan(plan, inst, reader);
 
         if (status == OK) {
             *result = inst;
@@ -241,11 +305,33 @@ static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **res
     return status;
 }
 
-static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_parsePlan(const struct dyn_type_plan *plan, void *inst, avrobin_reader_t *reader) {
     int status = OK;
 
-    dyn_type *subType = NULL;
-    char c = dynType_descriptorType(type);
+    for (size_t i = 0; i < plan->nrOfOps && status == OK; ++i) {
+        const struct dyn_type_plan_op *op = &plan->ops[i];
+        void *loc = (char*)inst + op->offset;
+        switch (op->kind) {
+            case DYN_TYPE_PLAN_VALUE :
+                status = avrobinSerializer_parseValue(op, loc, reader);
+                break;
+            case DYN_TYPE_PLAN_SEQUENCE :
+                status = avrobinSerializer_parseSequence(op, loc, reader);
+                break;
+            case DYN_TYPE_PLAN_TYPED_POINTER :
+                status = avrobinSerializer_createType(op->subType, reader, (void**)loc);
+                break;
+            default :
+                //begin/end of a complex type, the members are part of the plan
+                break;
+        }
+    }
+
+    return status;
+}
+
+static int avrobinSerializer_parseValue(const struct dyn_type_plan_op *op, void *loc, avrobin_reader_t *reader) {
+    int status = OK;
 
     bool *z;            //Z
     float *f;           //F
@@ -263,125 +349,85 @@ static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream) {
     bool avro_boolean;
     int32_t avro_int;
     int64_t avro_long;
-    float avro_float;
-    double avro_double;
-    char *avro_string;
 
-    switch (c) {
+    switch (op->descriptor) {
         case 'Z' :
             z = loc;
-            status = avrobin_read_boolean(stream,&avro_boolean);
+            status = avrobin_read_boolean(reader,&avro_boolean);
             if (status == OK) {
                 *z = avro_boolean;
             }
             break;
         case 'F' :
             f = loc;
-            status = avrobin_read_float(stream,&avro_float);
-            if (status == OK) {
-                *f = avro_float;
-            }
+            status = avrobin_read_float(reader,f);
             break;
         case 'D' :
             d = loc;
-            status = avrobin_read_double(stream,&avro_double);
-            if (status == OK) {
-                *d = avro_double;
-            }
+            status = avrobin_read_double(reader,d);
             break;
         case 'N' :
             n = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *n = (int)avro_int;
             }
             break;
         case 'B' :
             b = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *b = (char)avro_int;
             }
             break;
         case 'S' :
             s = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *s = (int16_t)avro_int;
             }
             break;
         case 'I' :
             i = loc;
-            status = avrobin_read_int(stream,&avro_int);
-            if (status == OK) {
-                *i = avro_int;
-            }
+            status = avrobin_read_int(reader,i);
             break;
         case 'J' :
             l = loc;
-            status = avrobin_read_long(stream,&avro_long);
-            if (status == OK) {
-                *l = avro_long;
-            }
+            status = avrobin_read_long(reader,l);
             break;
         case 'b' :
             ub = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *ub = (uint8_t)avro_int;
             }
             break;
         case 's' :
             us = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *us = (uint16_t)avro_int;
             }
             break;
         case 'i' :
             ui = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *ui = (uint32_t)avro_int;
             }
             break;
         case 'j' :
             ul = loc;
-            status = avrobin_read_long(stream,&avro_long);
+            status = avrobin_read_long(reader,&avro_long);
             if (status == OK) {
                 *ul = (uint64_t)avro_long;
             }
             break;
         case 't' :
-            status = avrobin_read_string(stream,&avro_string);
-            if (status == OK) {
-                status = dynType_text_allocAndInit(type, loc, avro_string);
-                free(avro_string);
-            }
-            break;
-        case '[' :
-            if (status == OK) {
-                status = avrobinSerializer_parseSequence(type, loc, stream);
-            }
-            break;
-        case '{' :
-            if (status == OK) {
-                status = avrobinSerializer_parseComplex(type, loc, stream);
-            }
-            break;
-        case '*' :
-            status = dynType_typedPointer_getTypedType(type, &subType);
-            if (status == OK) {
-                status = avrobinSerializer_createType(subType, stream, (void**)loc);
-            }
+            status = avrobin_read_string(reader,(char**)loc);
             break;
         case 'E' :
-            if (status == OK) {
-                status = avrobinSerializer_parseEnum(type, loc, stream);
-            }
-            break;
-        case 'l':
-            status = avrobinSerializer_parseAny(type->ref.ref, loc, stream);
+            status = avrobinSerializer_parseEnum(op->type, loc, reader);
             break;
         case 'P' :
             status = ERROR;
@@ -389,55 +435,14 @@ static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream) {
             break;
         default :
             status = ERROR;
-            LOG_ERROR("Error provided type '%c' not supported for AVRO.", dynType_descriptorType(type));
+            LOG_ERROR("Error provided type '%c' not supported for AVRO.", op->descriptor);
             break;
     }
 
     return status;
 }
 
-static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, FILE *stream) {
-    int status = OK;
-
-    struct complex_type_entry *entry = NULL;
-    struct complex_type_entries_head *entries = NULL;
-    dyn_type *subType = NULL;
-    void *subLoc = NULL;
-    int index = -1;
-
-    status = dynType_complex_entries(type, &entries);
-
-    if (status == OK) {
-        TAILQ_FOREACH(entry, entries, entries) {
-            index = dynType_complex_indexForName(type, entry->name);
-
-            if (index < 0) {
-                status = ERROR;
-                LOG_ERROR("Cannot find index for member '%s'.", entry->name);
-            }
-
-            if (status == OK) {
-                status = dynType_complex_dynTypeAt(type, index, &subType);
-            }
-
-            if (status == OK) {
-                status = dynType_complex_valLocAt(type, index, loc, &subLoc);
-            }
-
-            if (status == OK) {
-                status = avrobinSerializer_parseAny(subType, subLoc, stream);
-            }
-
-            if (status != OK) {
-                break;
-            }
-        }
-    }
-
-    return status;
-}
-
-static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_parseSequence(const struct dyn_type_plan_op *op, void *loc, avrobin_reader_t *reader) {
     /* Avro 1.8.1 Specification
      * Arrays
      * Arrays are encoded as a series of blocks. Each block consists of a long count value, followed by that many array items. A block with count zero indicates the end of the array. Each item is encoded per the array's item schema.
@@ -449,56 +454,95 @@ static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stre
      * The blocked representation permits one to read and write arrays larger than can be buffered in memory, since one can start writing items without knowing the full length of the array.
      */
 
-    dynType_sequence_init(type, loc);
-    int status = 0;
-    dyn_type *itemType = dynType_sequence_itemType(type);
-    size_t itemSize = (int64_t)dynType_size(itemType);
-    uint32_t cap = 0;
+    dynType_sequence_init(op->type, loc);
+    int status = OK;
+    struct generic_sequence *seq = loc;
+    const struct dyn_type_plan *itemPlan = dynType_plan(op->subType);
+    if (itemPlan == NULL) {
+        return ERROR;
+    }
 
     int64_t blockCount = 0;
     int64_t blockSize = 0;
 
     do {
-        status = avrobin_read_long(stream, &blockCount);
-        if (status != OK) {
-            break;
-        } else if (blockCount < 0) {
-            blockSize = blockCount * -1; //found a block of blockSize bytes
-            blockCount = blockSize / itemSize;
-            int64_t rest = blockSize % itemSize;
-            if (rest != 0) {
-                LOG_ERROR("Found block size (%li) is not a multitude of the item size (%li)", blockSize, itemSize);
+        status = avrobin_read_long(reader, &blockCount);
+        if (status == OK && blockCount < 0) {
+            blockCount = -blockCount;
+            status = avrobin_read_long(reader, &blockSize); //not needed, all items are read
+        }
+        if (status == OK && blockCount > 0) {
+            //every item takes at least one byte, so a larger count can only come from corrupt input
+            if (blockCount > reader->end - reader->pos || blockCount > UINT32_MAX - seq->len) {
+                LOG_ERROR("Invalid block count (%" PRId64 ") for the remaining input.", blockCount);
                 status = ERROR;
                 break;
             }
-        }
-        if (blockCount > 0) {
-            LOG_DEBUG("Parsing block count of %li", blockCount);
-            cap += blockCount;
-            dynType_sequence_reserve(type, loc, cap);
-            for (int64_t i = 0; i < blockCount; ++i) {
-                void* itemLoc = NULL;
-                status = dynType_sequence_increaseLengthAndReturnLastLoc(type, loc, &itemLoc);
-                if (status != OK) {
-                    break;
-                }
-                avrobinSerializer_parseAny(itemType, itemLoc, stream);
+            LOG_DEBUG("Parsing block count of %" PRId64, blockCount);
+            uint32_t count = (uint32_t)blockCount;
+            if (seq->cap < seq->len + count) {
+                status = dynType_sequence_reserve(op->type, loc, seq->len + count);
             }
-            if (status != OK) {
-                break;
+            if (status == OK) {
+                //items are zeroed and added upfront, so that a partially parsed sequence can be freed
+                void *items = (char*)seq->buf + seq->len * op->itemSize;
+                memset(items, 0, count * op->itemSize);
+                seq->len += count;
+                status = avrobinSerializer_parseItems(itemPlan, op->itemSize, items, count, reader);
             }
         }
-    } while (blockCount != 0);
+    } while (status == OK && blockCount != 0);
+
+    return status;
+}
+
+static int avrobinSerializer_parseItems(const struct dyn_type_plan *itemPlan, size_t itemSize, void *items, uint32_t count, avrobin_reader_t *reader) {
+    int status = OK;
+
+    if (AVROBIN_LITTLE_ENDIAN_HOST && itemPlan->packedReals) {
+        size_t size = count * itemSize;
+        if (size <= (size_t)(reader->end - reader->pos)) {
+            memcpy(items, reader->pos, size);
+            reader->pos += size;
+        } else {
+            LOG_ERROR("Unexpected end of input.");
+            status = ERROR;
+        }
+        return status;
+    }
 
-    if (status != OK) {
-        dynType_free(type, loc);
+    char descriptor = itemPlan->nrOfOps == 1 ? itemPlan->ops[0].descriptor : '{';
+    switch (descriptor) {
+        case 'J' : {
+            int64_t *vals = items;
+            for (uint32_t i = 0; i < count && status == OK; ++i) {
+                status = avrobin_read_long(reader, &vals[i]);
+            }
+            break;
+        }
+        case 'I' : {
+            int32_t *vals = items;
+            for (uint32_t i = 0; i < count && status == OK; ++i) {
+                status = avrobin_read_int(reader, &vals[i]);
+            }
+            break;
+        }
+        default : {
+            char *item = items;
+            for (uint32_t i = 0; i < count && status == OK; ++i) {
+                status = avrobinSerializer_parsePlan(itemPlan, item, reader);
+                item += itemSize;
+            }
+            break;
+        }
     }
+
     return status;
 }
 
-static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, avrobin_reader_t *reader) {
     int32_t index;
-    if (avrobin_read_int(stream, &index) != OK) {
+    if (avrobin_read_int(reader, &index) != OK) {
         return ERROR;
     }
     if (index < 0) {
@@ -519,94 +563,111 @@ static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, FILE *stream)
     return ERROR;
 }
 
-static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeType(dyn_type *type, const void *inst, avrobin_writer_t *writer) {
+    const struct dyn_type_plan *plan = dynType_plan(type);
+    return plan != NULL ? avrobinSerializer_writePlan(plan, inst, writer) : ERROR;
+}
+
+static int avrobinSerializer_writePlan(const struct dyn_type_plan *plan, const void *inst, avrobin_writer_t *writer) {
     int status = OK;
 
-    int descriptor = dynType_descriptorType(type);
-    dyn_type *subType = NULL;
+    for (size_t i = 0; i < plan->nrOfOps && status == OK; ++i) {
+        const struct dyn_type_plan_op *op = &plan->ops[i];
+        const void *loc = (const char*)inst + op->offset;
+        switch (op->kind) {
+            case DYN_TYPE_PLAN_VALUE :
+                status = avrobinSerializer_writeValue(op, loc, writer);
+                break;
+            case DYN_TYPE_PLAN_SEQUENCE :
+                status = avrobinSerializer_writeSequence(op, loc, writer);
+                break;
+            case DYN_TYPE_PLAN_TYPED_POINTER :
+                if (*(void* const*)loc != NULL) {
+                    status = avrobinSerializer_writeType(op->subType, *(void* const*)loc, writer);
+                } else {
+                    status = ERROR;
+                    LOG_ERROR("Cannot serialize a NULL typed pointer.");
+                }
+                break;
+            default :
+                //begin/end of a complex type, the members are part of the plan
+                break;
+        }
+    }
 
-    bool *z;            //Z
-    float *f;           //F
-    double *d;          //D
-    char *b;            //B
-    int *n;             //N
-    int16_t *s;         //S
-    int32_t *i;         //I
-    int64_t *l;         //J
-    uint8_t   *ub;      //b
-    uint16_t  *us;      //s
-    uint32_t  *ui;      //i
-    uint64_t  *ul;      //j
+    return status;
+}
 
-    switch (descriptor) {
+static int avrobinSerializer_writeValue(const struct dyn_type_plan_op *op, const void *loc, avrobin_writer_t *writer) {
+    int status = OK;
+
+    const bool *z;            //Z
+    const float *f;           //F
+    const double *d;          //D
+    const char *b;            //B
+    const int *n;             //N
+    const int16_t *s;         //S
+    const int32_t *i;         //I
+    const int64_t *l;         //J
+    const uint8_t   *ub;      //b
+    const uint16_t  *us;      //s
+    const uint32_t  *ui;      //i
+    const uint64_t  *ul;      //j
+
+    switch (op->descriptor) {
         case 'Z' :
             z = loc;
-            status = avrobin_write_boolean(stream,*z);
+            status = avrobin_write_boolean(writer,*z);
             break;
         case 'B' :
             b = loc;
-            status = avrobin_write_int(stream,(int32_t)*b);
+            status = avrobin_write_int(writer,(int32_t)*b);
             break;
         case 'S' :
             s = loc;
-            status = avrobin_write_int(stream,(int32_t)*s);
+            status = avrobin_write_int(writer,(int32_t)*s);
             break;
         case 'I' :
             i = loc;
-            status = avrobin_write_int(stream,*i);
+            status = avrobin_write_int(writer,*i);
             break;
         case 'J' :
             l = loc;
-            status = avrobin_write_long(stream,*l);
+            status = avrobin_write_long(writer,*l);
             break;
         case 'b' :
             ub = loc;
-            status = avrobin_write_int(stream,(int32_t)*ub);
+            status = avrobin_write_int(writer,(int32_t)*ub);
             break;
         case 's' :
             us = loc;
-            status = avrobin_write_int(stream,(int32_t)*us);
+            status = avrobin_write_int(writer,(int32_t)*us);
             break;
         case 'i' :
             ui = loc;
-            status = avrobin_write_int(stream,(int32_t)*ui);
+            status = avrobin_write_int(writer,(int32_t)*ui);
             break;
         case 'j' :
             ul = loc;
-            status = avrobin_write_long(stream,(int64_t)*ul);
+            status = avrobin_write_long(writer,(int64_t)*ul);
             break;
         case 'N' :
             n = loc;
-            status = avrobin_write_int(stream,(int32_t)*n);
+            status = avrobin_write_int(writer,(int32_t)*n);
             break;
         case 'F' :
             f = loc;
-            status = avrobin_write_float(stream,*f);
+            status = avrobin_write_float(writer,*f);
             break;
         case 'D' :
             d = loc;
-            status = avrobin_write_double(stream,*d);
+            status = avrobin_write_double(writer,*d);
             break;
         case 't' :
-            status = avrobin_write_string(stream,*(const char**)loc);
-            break;
-        case '*' :
-            status = dynType_typedPointer_getTypedType(type, &subType);
-            if (status == OK) {
-                status = avrobinSerializer_writeAny(subType, *(void**)loc, stream);
-            }
-            break;
-        case '{' :
-            status = avrobinSerializer_writeComplex(type, loc, stream);
-            break;
-        case '[' :
-            status = avrobinSerializer_writeSequence(type, loc, stream);
+            status = avrobin_write_string(writer,*(const char**)loc);
             break;
         case 'E' :
-            status = avrobinSerializer_writeEnum(type, loc, stream);
-            break;
-        case 'l':
-            status = avrobinSerializer_writeAny(type->ref.ref, loc, stream);
+            status = avrobinSerializer_writeEnum(op->type, loc, writer);
             break;
         case 'P' :
             status = ERROR;
@@ -614,85 +675,72 @@ static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream) {
             break;
         default :
             status = ERROR;
-            LOG_ERROR("Unsupported descriptor '%c'.", descriptor);
+            LOG_ERROR("Unsupported descriptor '%c'.", op->descriptor);
             break;
     }
 
     return status;
 }
 
-static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeSequence(const struct dyn_type_plan_op *op, const void *loc, avrobin_writer_t *writer) {
+    const struct generic_sequence *seq = loc;
     int status = OK;
 
-    struct complex_type_entry *entry = NULL;
-    struct complex_type_entries_head *entries = NULL;
-    dyn_type *subType = NULL;
-    void *subLoc = NULL;
-    int index = -1;
-
-    status = dynType_complex_entries(type, &entries);
+    //all items are written in a single block, followed by the zero count end block
+    if (seq->len > 0) {
+        const struct dyn_type_plan *itemPlan = dynType_plan(op->subType);
+        status = itemPlan != NULL ? avrobin_write_long(writer, seq->len) : ERROR;
+        if (status == OK) {
+            status = avrobinSerializer_writeItems(itemPlan, op->itemSize, seq->buf, seq->len, writer);
+        }
+    }
 
     if (status == OK) {
-        TAILQ_FOREACH(entry, entries, entries) {
-            index = dynType_complex_indexForName(type, entry->name);
-
-            if (index < 0) {
-                status = ERROR;
-                LOG_ERROR("Cannot find index for member '%s'.", entry->name);
-            }
-
-            if (status == OK) {
-                status = dynType_complex_dynTypeAt(type, index, &subType);
-            }
-
-            if (status == OK) {
-                status = dynType_complex_valLocAt(type, index, loc, &subLoc);
-            }
-
-            if (status == OK) {
-                status = avrobinSerializer_writeAny(subType, subLoc, stream);
-            }
-
-            if (status != OK) {
-                break;
-            }
-        }
+        status = avrobin_write_long(writer, 0);
     }
 
     return status;
 }
 
-static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, FILE *stream) {
-    uint32_t arrayLen = dynType_sequence_length(loc);
-
-    dyn_type *itemType = dynType_sequence_itemType(type);
-    void *itemLoc = NULL;
+static int avrobinSerializer_writeItems(const struct dyn_type_plan *itemPlan, size_t itemSize, const void *items, uint32_t count, avrobin_writer_t *writer) {
+    int status = OK;
 
-    if (avrobin_write_long(stream, arrayLen) != OK) {
-        LOG_ERROR("Failed to write array block count.");
-        return ERROR;
+    if (AVROBIN_LITTLE_ENDIAN_HOST && itemPlan->packedReals) {
+        return avrobin_write_bytes(writer, items, count * itemSize);
     }
 
-    for (int i=0; i<arrayLen; i++) {
-        if (dynType_sequence_locForIndex(type, loc, i, &itemLoc)) {
-            return ERROR;
+    char descriptor = itemPlan->nrOfOps == 1 ? itemPlan->ops[0].descriptor : '{';
+    switch (descriptor) {
+        case 'J' : {
+            const int64_t *vals = items;
+            for (uint32_t i = 0; i < count && status == OK; ++i) {
+                status = avrobin_write_long(writer, vals[i]);
+            }
+            break;
         }
-        if (avrobinSerializer_writeAny(itemType, itemLoc, stream) != OK) {
-            return ERROR;
+        case 'I' : {
+            const int32_t *vals = items;
+            for (uint32_t i = 0; i < count && status == OK; ++i) {
+                status = avrobin_write_int(writer, vals[i]);
+            }
+            break;
+        }
+        default : {
+            const char *item = items;
+            for (uint32_t i = 0; i < count && status == OK; ++i) {
+                status = avrobinSerializer_writePlan(itemPlan, item, writer);
+                item += itemSize;
+            }
+            break;
         }
     }
 
-    if (avrobin_write_long(stream, 0) != OK) {
-        LOG_ERROR("Failed to write array block count.");
-        return ERROR;
-    }
-
-    return OK;
+    return status;
 }
 
-static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeEnum(dyn_type *type, const void *loc, avrobin_writer_t *writer) {
     char enum_value_str[16];
-    if (sprintf(enum_value_str, "%d", *(int32_t*)loc) < 0) {
+    if (sprintf(enum_value_str, "%d", *(const int32_t*)loc) < 0) {
         return ERROR;
     }
 
@@ -701,7 +749,7 @@ static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, FILE *stream)
 
     TAILQ_FOREACH(entry, &type->metaProperties, entries) {
         if (0 == strcmp(enum_value_str, entry->value)) {
-            return avrobin_write_int(stream, index);
+            return avrobin_write_int(writer, index);
         }
         index++;
     }
@@ -1117,67 +1165,62 @@ static int generate_record_name(char **result) {
     return OK;
 }
 
-static int avrobin_read_boolean(FILE *stream,bool *val) {
-    int c = fgetc(stream);
-    if (c == EOF) {
-        LOG_ERROR("Unexpected end of file.");
+static int avrobin_read_boolean(avrobin_reader_t *reader,bool *val) {
+    if (reader->pos == reader->end) {
+        LOG_ERROR("Unexpected end of input.");
         return ERROR;
     }
+    uint8_t c = *reader->pos;
     if (c!=0 && c!=1) {
         LOG_ERROR("Unexpected value for boolean.");
         return ERROR;
     }
-    if (c == 0) {
-        *val = false;
-    } else {
-        *val = true;
-    }
+    reader->pos += 1;
+    *val = (c == 1);
     return OK;
 }
 
-static int avrobin_read_int(FILE *stream,int32_t *val) {
+static int avrobin_read_int(avrobin_reader_t *reader,int32_t *val) {
     int64_t lval;
-    int status = avrobin_read_long(stream,&lval);
-    //TODO Do range check.
-    *val = (int32_t)lval;
+    int status = avrobin_read_long(reader,&lval);
+    if (status == OK && (lval < INT32_MIN || lval > INT32_MAX)) {
+        LOG_ERROR("Value out of range for int.");
+        status = ERROR;
+    }
+    if (status == OK) {
+        *val = (int32_t)lval;
+    }
     return status;
 }
 
-static int avrobin_read_long(FILE *stream,int64_t *val) {
+static int avrobin_read_long(avrobin_reader_t *reader,int64_t *val) {
     uint64_t uval = 0;
     uint8_t b;
-    int c;
     int offset = 0;
     do {
         if (offset == MAX_VARINT_BUF_SIZE) {
             LOG_ERROR("Varint too long.");
             return ERROR;
         }
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
+        if (reader->pos == reader->end) {
+            LOG_ERROR("Unexpected end of input.");
             return ERROR;
         }
-        b = (uint8_t)c;
+        b = *reader->pos++;
         uval |= (uint64_t) (b & 0x7F) << (7 * offset);
         ++offset;
     }
     while (b & 0x80);
-    *val = ((uval >> 1) ^ -(uval & 1));
+    *val = (int64_t)((uval >> 1) ^ -(uval & 1));
     return OK;
 }
 
-static int avrobin_read_float(FILE *stream,float *val) {
-    uint8_t b[4];
-    int c;
-    for (int i=0;i<4;i++) {
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
-            return ERROR;
-        }
-        b[i] = (uint8_t)c;
+static int avrobin_read_float(avrobin_reader_t *reader,float *val) {
+    if (reader->end - reader->pos < 4) {
+        LOG_ERROR("Unexpected end of input.");
+        return ERROR;
     }
+    const uint8_t *b = reader->pos;
     union {
         float f;
         uint32_t i;
@@ -1188,20 +1231,16 @@ static int avrobin_read_float(FILE *stream,float *val) {
     ((uint32_t)b[2] << 16) |
     ((uint32_t)b[3] << 24);
     *val = v.f;
+    reader->pos += 4;
     return OK;
 }
 
-static int avrobin_read_double(FILE *stream,double *val) {
-    uint8_t b[8];
-    int c;
-    for (int i=0;i<8;i++) {
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
-            return ERROR;
-        }
-        b[i] = (uint8_t)c;
+static int avrobin_read_double(avrobin_reader_t *reader,double *val) {
+    if (reader->end - reader->pos < 8) {
+        LOG_ERROR("Unexpected end of input.");
+        return ERROR;
     }
+    const uint8_t *b = reader->pos;
     union {
         double d;
         uint64_t i;
@@ -1216,12 +1255,13 @@ static int avrobin_read_double(FILE *stream,double *val) {
     ((uint64_t)b[6] << 48) |
     ((uint64_t)b[7] << 56);
     *val = v.d;
+    reader->pos += 8;
     return OK;
 }
 
-static int avrobin_read_string(FILE *stream,char **val) {
+static int avrobin_read_string(avrobin_reader_t *reader,char **val) {
     int64_t len;
-    if (avrobin_read_long(stream,&len) != OK) {
+    if (avrobin_read_long(reader,&len) != OK) {
         LOG_ERROR("Failed to read string length.");
         return ERROR;
     }
@@ -1229,63 +1269,69 @@ static int avrobin_read_string(FILE *stream,char **val) {
         LOG_ERROR("Negative string length.");
         return ERROR;
     }
+    if (len > reader->end - reader->pos) {
+        LOG_ERROR("Unexpected end of input.");
+        return ERROR;
+    }
     *val = (char*)malloc(sizeof(char) * (len+1));
     if (*val == NULL) {
         LOG_ERROR("Failed to allocate memory for avro string.");
         return ERROR;
     }
-    int c;
-    for (int64_t i=0;i<len;i++) {
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
-            free(*val);
-            return ERROR;
-        }
-        (*val)[i] = (char)c;
-    }
+    memcpy(*val, reader->pos, (size_t)len);
     (*val)[len] = '\0';
+    reader->pos += len;
     return OK;
 }
 
-static int avrobin_write_boolean(FILE *stream,bool val) {
-    int r;
-    if (val) {
-        r = fputc(1, stream);
-    } else {
-        r = fputc(0, stream);
-    }
-    if (r == EOF) {
-        LOG_ERROR("Write error.");
-        return ERROR;
+static int avrobin_write_bytes(avrobin_writer_t *writer,const void *data,size_t size) {
+    if (writer->buf != NULL) {
+        if (size > writer->cap - writer->len) {
+            LOG_ERROR("Write error, output buffer too small.");
+            return ERROR;
+        }
+        if (size > 0) {
+            memcpy(writer->buf + writer->len, data, size);
+        }
     }
+    writer->len += size;
     return OK;
 }
 
-static int avrobin_write_int(FILE *stream,int32_t val) {
+static int avrobin_write_boolean(avrobin_writer_t *writer,bool val) {
+    uint8_t b = val ? 1 : 0;
+    return avrobin_write_bytes(writer, &b, 1);
+}
+
+static int avrobin_write_int(avrobin_writer_t *writer,int32_t val) {
     int64_t lval = val;
-    return avrobin_write_long(stream,lval);
+    return avrobin_write_long(writer,lval);
 }
 
-static int avrobin_write_long(FILE *stream,int64_t val) {
-    uint64_t uval = (val << 1) ^ (val >> 63);
+static int avrobin_write_long(avrobin_writer_t *writer,int64_t val) {
+    uint64_t uval = ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+    if (writer->buf == NULL) {
+        //size calculation only
+        size_t size = 1;
+        while (uval & ~0x7FULL) {
+            uval >>= 7;
+            ++size;
+        }
+        writer->len += size;
+        return OK;
+    }
+
     uint8_t b[MAX_VARINT_BUF_SIZE];
     int bytes_written = 0;
-    while (uval & ~0x7F) {
+    while (uval & ~0x7FULL) {
         b[bytes_written++] = (uint8_t)((uval & 0x7F) | 0x80);
         uval >>= 7;
     }
     b[bytes_written++] = (uint8_t)uval;
-    for (int i=0;i<bytes_written;i++) {
-        if (fputc(b[i],stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, b, bytes_written);
 }
 
-static int avrobin_write_float(FILE *stream,float val) {
+static int avrobin_write_float(avrobin_writer_t *writer,float val) {
     uint8_t b[4];
     union {
         float f;
@@ -1296,16 +1342,10 @@ static int avrobin_write_float(FILE *stream,float val) {
     b[1] = (uint8_t)((v.i & 0x0000FF00) >> 8);
     b[2] = (uint8_t)((v.i & 0x00FF0000) >> 16);
     b[3] = (uint8_t)((v.i & 0xFF000000) >> 24);
-    for (int i=0;i<4;i++) {
-        if (fputc(b[i],stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, b, 4);
 }
 
-static int avrobin_write_double(FILE *stream,double val) {
+static int avrobin_write_double(avrobin_writer_t *writer,double val) {
     uint8_t b[8];
     union {
         double d;
@@ -1320,31 +1360,23 @@ static int avrobin_write_double(FILE *stream,double val) {
     b[5] = (uint8_t)((v.i & 0x0000FF0000000000) >> 40);
     b[6] = (uint8_t)((v.i & 0x00FF000000000000) >> 48);
     b[7] = (uint8_t)((v.i & 0xFF00000000000000) >> 56);
-    for (int i=0;i<8;i++) {
-        if (fputc(b[i],stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, b, 8);
 }
 
-static int avrobin_write_string(FILE *stream,const char *val) {
-    assert(val != NULL);
+static int avrobin_write_string(avrobin_writer_t *writer,const char *val) {
+    if (val == NULL) {
+        LOG_ERROR("Cannot write NULL string.");
+        return ERROR;
+    }
     size_t len = strlen(val);
-    if (avrobin_write_long(stream, (int64_t)len) != OK) {
+    if (avrobin_write_long(writer, (int64_t)len) != OK) {
         LOG_ERROR("Failed to write string length.");
         return ERROR;
     }
-    for (size_t i=0;i<len;i++) {
-        if (fputc((unsigned char)(val[i]),stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, val, len);
 }
 
+
 static int avrobin_schema_primitive(const char *tname, json_t **output) {
     json_t *jo = json_object();
     if (jo == NULL) {
@@ -424,7 +424,7 @@ static inline bool dynAvprType_finalizeRecord(dyn_type * type, const size_t size
     }
 
     dynType_prepCif(type->ffiType);
-    return true;
+    return dynType_complex_buildIndex(type) == 0;
 }
 
 static inline struct complex_type_entry *dynAvprType_parseRecordEntry(dyn_type *root, dyn_type *parent, json_t const *const entry_object, json_t const *const array_object, const char *fqn_parent, const char *parent_ns, const char *record_ns) {
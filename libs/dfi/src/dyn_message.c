@@ -281,6 +281,11 @@ static int dynMessage_parseMessage(dyn_message_type *msg, FILE *stream) {
     	status = dynType_parse(stream, name, &(msg->types), &(msg->msgType));
     }
 
+    if (status == OK) {
+        //messages are (de)serialized often, so compile the serialization plan upfront
+        status = dynType_compile(msg->msgType);
+    }
+
     return status;
 }
 
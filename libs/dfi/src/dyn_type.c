@@ -23,6 +23,7 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #include <ffi.h>
 #include <dyn_type_common.h>
 
@@ -55,6 +56,7 @@ static int dynType_parseSequence(FILE *stream, dyn_type *type);
 static int dynType_parseSimple(int c, dyn_type *type);
 static int dynType_parseTypedPointer(FILE *stream, dyn_type *type);
 static unsigned short dynType_getOffset(dyn_type *type, int index);
+static void dynType_destroyPlan(struct dyn_type_plan *plan);
 
 static void dynType_printAny(char *name, dyn_type *type, int depth, FILE *stream);
 static void dynType_printComplex(char *name, dyn_type *type, int depth, FILE *stream);
@@ -76,12 +78,6 @@ void dynType_freeSequenceType(dyn_type *type, void *seqLoc);
 
 static int dynType_parseMetaInfo(FILE *stream, dyn_type *type);
 
-struct generic_sequence {
-    uint32_t cap;
-    uint32_t len;
-    void *buf;
-};
-
 int dynType_parse(FILE *descriptorStream, const char *name, struct types_head *refTypes, dyn_type **type) {
     return dynType_parseWithStream(descriptorStream, name, NULL, refTypes, type);
 }
@@ -327,6 +323,7 @@ static int dynType_parseComplex(FILE *stream, dyn_type *type) {
 
     if (status == OK) {
         dynType_prepCif(type->ffiType);
+        status = dynType_complex_buildIndex(type);
     }
 
 
@@ -533,6 +530,7 @@ static void dynType_clear(dyn_type *type) {
     if (type->name != NULL) {
         free(type->name);
     }
+    dynType_destroyPlan(type->plan);
 }
 
 static void dynType_clearComplex(dyn_type *type) {
@@ -551,6 +549,8 @@ static void dynType_clearComplex(dyn_type *type) {
     if (type->complex.types != NULL) {
         free(type->complex.types);
     }
+    free(type->complex.offsets);
+    free(type->complex.nameIndex);
     if (type->complex.structType.elements != NULL) {
         free(type->complex.structType.elements);
     }
@@ -589,16 +589,86 @@ int dynType_alloc(dyn_type *type, void **bufLoc) {
 }
 
 
+static int dynType_compareNameIndexEntries(const void *a, const void *b) {
+    const struct complex_type_name_index_entry *entryA = a;
+    const struct complex_type_name_index_entry *entryB = b;
+    size_t len = entryA->nameLength < entryB->nameLength ? entryA->nameLength : entryB->nameLength;
+    int cmp = memcmp(entryA->name, entryB->name, len);
+    if (cmp == 0 && entryA->nameLength != entryB->nameLength) {
+        cmp = entryA->nameLength < entryB->nameLength ? -1 : 1;
+    }
+    if (cmp == 0) {
+        cmp = entryA->index - entryB->index;
+    }
+    return cmp;
+}
+
+int dynType_complex_buildIndex(dyn_type *type) {
+    assert(type->type == DYN_TYPE_COMPLEX);
+    int status = OK;
+    size_t count = dynType_complex_nrOfEntries(type);
+
+    size_t *offsets = calloc(count + 1, sizeof(size_t));
+    type->complex.nameIndex = calloc(count + 1, sizeof(struct complex_type_name_index_entry));
+    if (offsets == NULL || type->complex.nameIndex == NULL) {
+        free(offsets);
+        free(type->complex.nameIndex);
+        type->complex.nameIndex = NULL;
+        status = MEM_ERROR;
+        LOG_ERROR("Error allocating memory for complex type index");
+    }
+
+    if (status == OK) {
+        int index = 0;
+        size_t nameIndexSize = 0;
+        struct complex_type_entry *entry = NULL;
+        TAILQ_FOREACH(entry, &type->complex.entriesHead, entries) {
+            offsets[index] = dynType_getOffset(type, index);
+            if (entry->name != NULL) {
+                struct complex_type_name_index_entry *nameEntry = &type->complex.nameIndex[nameIndexSize++];
+                nameEntry->name = entry->name;
+                nameEntry->nameLength = strlen(entry->name);
+                nameEntry->index = index;
+            }
+            index += 1;
+        }
+        qsort(type->complex.nameIndex, nameIndexSize, sizeof(*type->complex.nameIndex), dynType_compareNameIndexEntries);
+        type->complex.nameIndexSize = nameIndexSize;
+        type->complex.offsets = offsets;
+    }
+
+    return status;
+}
+
 int dynType_complex_indexForName(dyn_type *type, const char *name) {
+    return dynType_complex_indexForNameWithLength(type, name, strlen(name));
+}
+
+int dynType_complex_indexForNameWithLength(dyn_type *type, const char *name, size_t nameLength) {
     assert(type->type == DYN_TYPE_COMPLEX);
-    int i = 0;
+    struct complex_type_name_index_entry key;
+    key.name = name;
+    key.nameLength = nameLength;
+    key.index = INT_MAX; //for duplicate names the last member wins
+
+    //binary search for the last entry <= key
+    size_t low = 0;
+    size_t high = type->complex.nameIndexSize;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (dynType_compareNameIndexEntries(&type->complex.nameIndex[mid], &key) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
     int index = -1;
-    struct complex_type_entry *entry = NULL;
-    TAILQ_FOREACH(entry, &type->complex.entriesHead, entries) {
-        if (strcmp(name, entry->name) == 0) {
-            index = i;
+    if (low > 0) {
+        struct complex_type_name_index_entry *entry = &type->complex.nameIndex[low - 1];
+        if (entry->nameLength == nameLength && memcmp(entry->name, name, nameLength) == 0) {
+            index = entry->index;
         }
-        i +=1;
     }
     return index;
 }
@@ -905,6 +975,9 @@ static ffi_type * dynType_ffiTypeFor(int c) {
 
 static unsigned short dynType_getOffset(dyn_type *type, int index) {
     assert(type->type == DYN_TYPE_COMPLEX);
+    if (type->complex.offsets != NULL) {
+        return (unsigned short)type->complex.offsets[index];
+    }
     unsigned short offset = 0;
 
     ffi_type *ffiType = &type->complex.structType;
@@ -932,6 +1005,133 @@ size_t dynType_size(dyn_type *type) {
     return rType->ffiType->size;
 }
 
+static int dynType_planAddOp(struct dyn_type_plan *plan, size_t *cap, struct dyn_type_plan_op **op) {
+    int status = OK;
+    if (plan->nrOfOps == *cap) {
+        size_t newCap = *cap == 0 ? 8 : *cap * 2;
+        struct dyn_type_plan_op *ops = realloc(plan->ops, newCap * sizeof(*ops));
+        if (ops != NULL) {
+            plan->ops = ops;
+            *cap = newCap;
+        } else {
+            status = MEM_ERROR;
+            LOG_ERROR("Error allocating memory for serialization plan");
+        }
+    }
+    if (status == OK) {
+        *op = &plan->ops[plan->nrOfOps++];
+        memset(*op, 0, sizeof(**op));
+    }
+    return status;
+}
+
+static int dynType_planCompileAny(dyn_type *type, const char *name, size_t offset, struct dyn_type_plan *plan, size_t *cap) {
+    int status = OK;
+    struct dyn_type_plan_op *op = NULL;
+    while (type->type == DYN_TYPE_REF) {
+        type = type->ref.ref;
+    }
+
+    status = dynType_planAddOp(plan, cap, &op);
+    if (status == OK) {
+        op->descriptor = type->descriptor;
+        op->name = name;
+        op->offset = offset;
+        op->type = type;
+        switch (type->type) {
+            case DYN_TYPE_COMPLEX : {
+                op->kind = DYN_TYPE_PLAN_BEGIN_COMPLEX;
+                size_t beginIndex = plan->nrOfOps - 1;
+                struct complex_type_entry *entry = NULL;
+                int index = 0;
+                TAILQ_FOREACH(entry, &type->complex.entriesHead, entries) {
+                    status = dynType_planCompileAny(type->complex.types[index], entry->name,
+                                                    offset + type->complex.offsets[index], plan, cap);
+                    if (status != OK) {
+                        break;
+                    }
+                    index += 1;
+                }
+                if (status == OK) {
+                    status = dynType_planAddOp(plan, cap, &op);
+                }
+                if (status == OK) {
+                    op->kind = DYN_TYPE_PLAN_END_COMPLEX;
+                    op->descriptor = '}';
+                    op->name = name;
+                    op->offset = offset;
+                    op->type = type;
+                    plan->ops[beginIndex].end = plan->nrOfOps - 1;
+                }
+                break;
+            }
+            case DYN_TYPE_SEQUENCE :
+                op->kind = DYN_TYPE_PLAN_SEQUENCE;
+                op->subType = dynType_sequence_itemType(type);
+                op->itemSize = dynType_size(op->subType);
+                break;
+            case DYN_TYPE_TYPED_POINTER :
+                op->kind = DYN_TYPE_PLAN_TYPED_POINTER;
+                op->subType = type->typedPointer.typedType;
+                break;
+            default :
+                op->kind = DYN_TYPE_PLAN_VALUE;
+                break;
+        }
+    }
+    return status;
+}
+
+static bool dynType_planIsPackedReals(dyn_type *type, const struct dyn_type_plan *plan) {
+    size_t expectedOffset = 0;
+    for (size_t i = 0; i < plan->nrOfOps; ++i) {
+        const struct dyn_type_plan_op *op = &plan->ops[i];
+        if (op->kind == DYN_TYPE_PLAN_VALUE && (op->descriptor == 'F' || op->descriptor == 'D') && op->offset == expectedOffset) {
+            expectedOffset += dynType_size(op->type);
+        } else if (op->kind != DYN_TYPE_PLAN_BEGIN_COMPLEX && op->kind != DYN_TYPE_PLAN_END_COMPLEX) {
+            return false;
+        }
+    }
+    return expectedOffset > 0 && expectedOffset == dynType_size(type);
+}
+
+static void dynType_destroyPlan(struct dyn_type_plan *plan) {
+    if (plan != NULL) {
+        free(plan->ops);
+        free(plan);
+    }
+}
+
+const struct dyn_type_plan* dynType_plan(dyn_type *type) {
+    struct dyn_type_plan *plan = __atomic_load_n(&type->plan, __ATOMIC_ACQUIRE);
+    if (plan == NULL) {
+        size_t cap = 0;
+        plan = calloc(1, sizeof(*plan));
+        int status = plan != NULL ? OK : MEM_ERROR;
+        if (status == OK) {
+            status = dynType_planCompileAny(type, NULL, 0, plan, &cap);
+        }
+        if (status == OK) {
+            plan->packedReals = dynType_planIsPackedReals(type, plan);
+            //another thread could have compiled the plan concurrently, only one plan is kept
+            struct dyn_type_plan *current = NULL;
+            if (!__atomic_compare_exchange_n(&type->plan, &current, plan, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                dynType_destroyPlan(plan);
+                plan = current;
+            }
+        } else {
+            LOG_ERROR("Error compiling serialization plan for type '%c'", type->descriptor);
+            dynType_destroyPlan(plan);
+            plan = NULL;
+        }
+    }
+    return plan;
+}
+
+int dynType_compile(dyn_type *type) {
+    return dynType_plan(type) != NULL ? OK : ERROR;
+}
+
 int dynType_type(dyn_type *type) {
     return type->type;
 }
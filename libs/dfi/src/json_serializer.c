@@ -24,9 +24,36 @@
 
 #include <jansson.h>
 #include <assert.h>
+#include <errno.h>
+#include <locale.h>
+#include <math.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
+//same as the jansson parser
+#define JSON_SERIALIZER_MAX_DEPTH 2048
+
+/**
+ * Pull reader state. Instead of creating a jansson DOM, the JSON input is read token by token and directly
+ * written in the dyn_type instance.
+ */
+typedef struct json_serializer_reader {
+    const char *pos;
+    const char *end;
+    int depth;
+} json_serializer_reader_t;
+
+/**
+ * Growable output buffer used to stream the JSON output. The output is byte-compatible with
+ * json_dumps(val, JSON_COMPACT).
+ */
+typedef struct json_serializer_writer {
+    char *buf;
+    size_t len;
+    size_t cap;
+} json_serializer_writer_t;
+
 static int jsonSerializer_createType(dyn_type *type, json_t *object, void **result);
 static int jsonSerializer_parseObject(dyn_type *type, json_t *object, void *inst);
 static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, json_t *val, void *inst);
@@ -39,6 +66,26 @@ static int jsonSerializer_writeComplex(dyn_type *type, void *input, json_t **val
 static int jsonSerializer_writeSequence(dyn_type *type, void *input, json_t **out);
 static int jsonSerializer_writeEnum(dyn_type *type, int32_t enum_value, json_t **out);
 
+static void jsonSerializer_skipWhitespace(json_serializer_reader_t *reader);
+static int jsonSerializer_readType(json_serializer_reader_t *reader, dyn_type *type, void **result);
+static int jsonSerializer_readAny(json_serializer_reader_t *reader, dyn_type *type, void *loc);
+static int jsonSerializer_readObject(json_serializer_reader_t *reader, dyn_type *type, void *inst);
+static int jsonSerializer_readSequence(json_serializer_reader_t *reader, dyn_type *seq, void *seqLoc);
+static int jsonSerializer_readString(json_serializer_reader_t *reader, char **out);
+static int jsonSerializer_readNumber(json_serializer_reader_t *reader, bool *isInteger, json_int_t *integer, double *real);
+static int jsonSerializer_skipValue(json_serializer_reader_t *reader);
+static void jsonSerializer_toLocale(char *number);
+static void jsonSerializer_fromLocale(char *number);
+
+static int jsonSerializer_ensure(json_serializer_writer_t *writer, size_t size);
+static int jsonSerializer_streamType(json_serializer_writer_t *writer, dyn_type *type, const void *input, bool *written);
+static int jsonSerializer_streamPlan(json_serializer_writer_t *writer, const struct dyn_type_plan *plan, const void *input, bool *written);
+static int jsonSerializer_streamValue(json_serializer_writer_t *writer, const struct dyn_type_plan_op *op, const void *input, bool *written);
+static int jsonSerializer_streamSequence(json_serializer_writer_t *writer, const struct dyn_type_plan_op *op, const void *input);
+static int jsonSerializer_streamString(json_serializer_writer_t *writer, const char *str, bool *written);
+static int jsonSerializer_streamInteger(json_serializer_writer_t *writer, json_int_t val);
+static int jsonSerializer_streamReal(json_serializer_writer_t *writer, double val, bool *written);
+
 
 static int OK = 0;
 static int ERROR = 1;
@@ -49,19 +96,25 @@ int jsonSerializer_deserialize(dyn_type *type, const char *input, size_t length,
     assert(dynType_type(type) == DYN_TYPE_COMPLEX || dynType_type(type) == DYN_TYPE_SEQUENCE);
     int status = 0;
 
-    json_error_t error;
-    json_t *root = json_loadb(input, length, JSON_DECODE_ANY, &error);
+    json_serializer_reader_t reader;
+    reader.pos = input;
+    reader.end = input + length;
+    reader.depth = 0;
 
-    if (root != NULL) {
-        status = jsonSerializer_deserializeJson(type, root, result);
-        json_decref(root);
-    } else {
-        status = ERROR;
-        LOG_ERROR("Error parsing json input '%s'. Error is: %s\n", input, error.text);
+    jsonSerializer_skipWhitespace(&reader);
+    status = jsonSerializer_readType(&reader, type, result);
+    if (status == OK) {
+        jsonSerializer_skipWhitespace(&reader);
+        if (reader.pos != reader.end) {
+            LOG_ERROR("Error parsing json input, unexpected data after the JSON value at position %zu", (size_t)(reader.pos - input));
+            dynType_free(type, *result);
+            *result = NULL;
+            status = ERROR;
+        }
     }
 
     if (status != OK) {
-        LOG_ERROR("Error cannot deserialize json. Input is '%s'\n", input);
+        LOG_ERROR("Error cannot deserialize json. Input is '%.*s'\n", (int)length, input);
     }
     return status;
 }
@@ -310,12 +363,32 @@ static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, void *seqL
 int jsonSerializer_serialize(dyn_type *type, const void* input, char **output) {
     int status = OK;
 
-    json_t *root = NULL;
-    status = jsonSerializer_serializeJson(type, input, &root);
+    json_serializer_writer_t writer;
+    writer.len = 0;
+    writer.cap = 256;
+    writer.buf = malloc(writer.cap);
+    if (writer.buf == NULL) {
+        status = ERROR;
+        LOG_ERROR("Error allocating memory for json output");
+    }
 
+    bool written = false;
     if (status == OK) {
-        *output = json_dumps(root, JSON_COMPACT);
-        json_decref(root);
+        status = jsonSerializer_streamType(&writer, type, input, &written);
+    }
+    if (status == OK && written) {
+        status = jsonSerializer_ensure(&writer, 1);
+    }
+
+    if (status == OK && written) {
+        writer.buf[writer.len] = '\0';
+        *output = writer.buf;
+    } else if (status == OK) {
+        //nothing to serialize (e.g. a NULL string), same as json_dumps for a NULL json_t
+        *output = NULL;
+        free(writer.buf);
+    } else {
+        free(writer.buf);
     }
 
     return status;
@@ -546,3 +619,1070 @@ static int jsonSerializer_writeEnum(dyn_type *type, int32_t enum_value, json_t *
     LOG_ERROR("Could not find Enum value %s in enum type", enum_value_str);
     return ERROR;
 }
+
+static inline int jsonSerializer_peek(json_serializer_reader_t *reader) {
+    return reader->pos < reader->end ? (unsigned char)*reader->pos : EOF;
+}
+
+static void jsonSerializer_skipWhitespace(json_serializer_reader_t *reader) {
+    while (reader->pos < reader->end && (*reader->pos == ' ' || *reader->pos == '\t' || *reader->pos == '\n' || *reader->pos == '\r')) {
+        reader->pos += 1;
+    }
+}
+
+static bool jsonSerializer_readLiteral(json_serializer_reader_t *reader, const char *literal, size_t length) {
+    bool match = (size_t)(reader->end - reader->pos) >= length && memcmp(reader->pos, literal, length) == 0;
+    if (match) {
+        reader->pos += length;
+    }
+    return match;
+}
+
+/**
+ * Returns the length of the UTF-8 sequence starting at str or 0 if the sequence is invalid (same rules as jansson).
+ */
+static size_t jsonSerializer_utf8Length(const unsigned char *str, size_t available) {
+    unsigned char first = str[0];
+    size_t size;
+    int32_t value;
+    if (first < 0x80) {
+        return 1;
+    } else if (first < 0xC2) {
+        return 0; //continuation byte or overlong 2 byte sequence
+    } else if (first <= 0xDF) {
+        size = 2;
+        value = first & 0x1F;
+    } else if (first <= 0xEF) {
+        size = 3;
+        value = first & 0x0F;
+    } else if (first <= 0xF4) {
+        size = 4;
+        value = first & 0x07;
+    } else {
+        return 0;
+    }
+
+    if (available < size) {
+        return 0;
+    }
+    for (size_t i = 1; i < size; ++i) {
+        if ((str[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) + (str[i] & 0x3F);
+    }
+    if (value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF) || (size == 3 && value < 0x800) || (size == 4 && value < 0x10000)) {
+        return 0;
+    }
+    return size;
+}
+
+static bool jsonSerializer_readHex4(const char *str, const char *end, int32_t *out) {
+    int32_t value = 0;
+    if (end - str < 4) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        char c = str[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') {
+            value += c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value += c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value += c - 'A' + 10;
+        } else {
+            return false;
+        }
+    }
+    *out = value;
+    return true;
+}
+
+/**
+ * Validates the JSON string at the reader position and moves the reader past the string.
+ * The raw (still escaped) content of the string is returned in start/length.
+ */
+static int jsonSerializer_scanString(json_serializer_reader_t *reader, const char **start, size_t *length, bool *hasEscapes) {
+    int status = OK;
+    const char *p = reader->pos + 1;
+    bool escapes = false;
+
+    while (status == OK) {
+        if (p >= reader->end) {
+            status = ERROR;
+            LOG_ERROR("Premature end of json input in string");
+            break;
+        }
+        unsigned char c = (unsigned char)*p;
+        if (c == '"') {
+            break;
+        } else if (c < 0x20) {
+            status = ERROR;
+            LOG_ERROR("Control character in json string");
+        } else if (c == '\\') {
+            escapes = true;
+            c = p + 1 < reader->end ? (unsigned char)p[1] : '\0';
+            if (c == 'u') {
+                int32_t value = 0;
+                int32_t low = 0;
+                if (!jsonSerializer_readHex4(p + 2, reader->end, &value) || value == 0) {
+                    status = ERROR;
+                } else if (value >= 0xD800 && value <= 0xDBFF) {
+                    //surrogate pair
+                    p += 6;
+                    if (reader->end - p >= 2 && p[0] == '\\' && p[1] == 'u' && jsonSerializer_readHex4(p + 2, reader->end, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        p += 6;
+                    } else {
+                        status = ERROR;
+                    }
+                } else if (value >= 0xDC00 && value <= 0xDFFF) {
+                    status = ERROR;
+                } else {
+                    p += 6;
+                }
+                if (status != OK) {
+                    LOG_ERROR("Invalid unicode escape in json string");
+                }
+            } else if (c == '"' || c == '\\' || c == '/' || c == 'b' || c == 'f' || c == 'n' || c == 'r' || c == 't') {
+                p += 2;
+            } else {
+                status = ERROR;
+                LOG_ERROR("Invalid escape in json string");
+            }
+        } else if (c < 0x80) {
+            p += 1;
+        } else {
+            size_t size = jsonSerializer_utf8Length((const unsigned char *)p, (size_t)(reader->end - p));
+            if (size > 0) {
+                p += size;
+            } else {
+                status = ERROR;
+                LOG_ERROR("Invalid UTF-8 in json string");
+            }
+        }
+    }
+
+    if (status == OK) {
+        *start = reader->pos + 1;
+        *length = (size_t)(p - *start);
+        *hasEscapes = escapes;
+        reader->pos = p + 1;
+    }
+    return status;
+}
+
+/**
+ * Decodes a (validated) escaped string into out. The decoded string is never longer than the escaped string.
+ * Returns the length of the decoded string.
+ */
+static size_t jsonSerializer_unescape(const char *str, size_t length, char *out) {
+    const char *p = str;
+    const char *end = str + length;
+    char *o = out;
+    while (p < end) {
+        if (*p != '\\') {
+            *o++ = *p++;
+            continue;
+        }
+        char c = p[1];
+        p += 2;
+        switch (c) {
+            case 'b' : *o++ = '\b'; break;
+            case 'f' : *o++ = '\f'; break;
+            case 'n' : *o++ = '\n'; break;
+            case 'r' : *o++ = '\r'; break;
+            case 't' : *o++ = '\t'; break;
+            case 'u' : {
+                int32_t value = 0;
+                int32_t low = 0;
+                jsonSerializer_readHex4(p, end, &value);
+                p += 4;
+                if (value >= 0xD800 && value <= 0xDBFF) {
+                    jsonSerializer_readHex4(p + 2, end, &low);
+                    p += 6;
+                    value = 0x10000 + ((value - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (value < 0x80) {
+                    *o++ = (char)value;
+                } else if (value < 0x800) {
+                    *o++ = (char)(0xC0 + (value >> 6));
+                    *o++ = (char)(0x80 + (value & 0x3F));
+                } else if (value < 0x10000) {
+                    *o++ = (char)(0xE0 + (value >> 12));
+                    *o++ = (char)(0x80 + ((value >> 6) & 0x3F));
+                    *o++ = (char)(0x80 + (value & 0x3F));
+                } else {
+                    *o++ = (char)(0xF0 + (value >> 18));
+                    *o++ = (char)(0x80 + ((value >> 12) & 0x3F));
+                    *o++ = (char)(0x80 + ((value >> 6) & 0x3F));
+                    *o++ = (char)(0x80 + (value & 0x3F));
+                }
+                break;
+            }
+            default : *o++ = c; break;
+        }
+    }
+    return (size_t)(o - out);
+}
+
+/**
+ * Reads a JSON string as newly allocated '\0' terminated string.
+ */
+static int jsonSerializer_readString(json_serializer_reader_t *reader, char **out) {
+    const char *start = NULL;
+    size_t len = 0;
+    bool hasEscapes = false;
+    int status = jsonSerializer_scanString(reader, &start, &len, &hasEscapes);
+
+    char *str = NULL;
+    if (status == OK) {
+        str = malloc(len + 1);
+        if (str == NULL) {
+            status = ERROR;
+            LOG_ERROR("Error allocating memory for json string");
+        }
+    }
+    if (status == OK) {
+        if (hasEscapes) {
+            len = jsonSerializer_unescape(start, len, str);
+        } else {
+            memcpy(str, start, len);
+        }
+        str[len] = '\0';
+        *out = str;
+    }
+    return status;
+}
+
+/**
+ * strtod and snprintf use the decimal point of the current (LC_NUMERIC) locale, JSON always uses a '.'.
+ * Same as jansson, the decimal point is replaced before parsing and after formatting a real.
+ */
+static void jsonSerializer_toLocale(char *number) {
+    const char *point = localeconv()->decimal_point;
+    if (*point != '.') {
+        char *pos = strchr(number, '.');
+        if (pos != NULL) {
+            *pos = *point;
+        }
+    }
+}
+
+static void jsonSerializer_fromLocale(char *number) {
+    const char *point = localeconv()->decimal_point;
+    if (*point != '.') {
+        char *pos = strchr(number, *point);
+        if (pos != NULL) {
+            *pos = '.';
+        }
+    }
+}
+
+static int jsonSerializer_readNumber(json_serializer_reader_t *reader, bool *isInteger, json_int_t *integer, double *real) {
+    int status = OK;
+    const char *start = reader->pos;
+    const char *p = start;
+    const char *end = reader->end;
+    bool isInt = true;
+
+    if (p < end && *p == '-') {
+        p += 1;
+    }
+    if (p < end && *p == '0') {
+        p += 1;
+        if (p < end && *p >= '0' && *p <= '9') {
+            status = ERROR; //leading zero
+        }
+    } else if (p < end && *p >= '0' && *p <= '9') {
+        while (p < end && *p >= '0' && *p <= '9') {
+            p += 1;
+        }
+    } else {
+        status = ERROR;
+    }
+    if (status == OK && p < end && *p == '.') {
+        isInt = false;
+        p += 1;
+        if (p < end && *p >= '0' && *p <= '9') {
+            while (p < end && *p >= '0' && *p <= '9') {
+                p += 1;
+            }
+        } else {
+            status = ERROR;
+        }
+    }
+    if (status == OK && p < end && (*p == 'e' || *p == 'E')) {
+        isInt = false;
+        p += 1;
+        if (p < end && (*p == '+' || *p == '-')) {
+            p += 1;
+        }
+        if (p < end && *p >= '0' && *p <= '9') {
+            while (p < end && *p >= '0' && *p <= '9') {
+                p += 1;
+            }
+        } else {
+            status = ERROR;
+        }
+    }
+    if (status != OK) {
+        LOG_ERROR("Invalid number in json input");
+        return status;
+    }
+
+    //strtoll/strtod need a '\0' terminated string, the input is not
+    size_t len = (size_t)(p - start);
+    char buf[64];
+    char *str = len < sizeof(buf) ? buf : malloc(len + 1);
+    if (str == NULL) {
+        LOG_ERROR("Error allocating memory for json number");
+        return ERROR;
+    }
+    memcpy(str, start, len);
+    str[len] = '\0';
+
+    errno = 0;
+    if (isInt) {
+        *integer = strtoll(str, NULL, 10);
+        if (errno == ERANGE) {
+            status = ERROR;
+            LOG_ERROR("Too big integer in json input: %s", str);
+        }
+    } else {
+        jsonSerializer_toLocale(str);
+        *real = strtod(str, NULL);
+        if (errno == ERANGE && (*real == HUGE_VAL || *real == -HUGE_VAL)) {
+            status = ERROR;
+            LOG_ERROR("Real number overflow in json input: %s", str);
+        }
+    }
+    *isInteger = isInt;
+    if (str != buf) {
+        free(str);
+    }
+
+    reader->pos = p;
+    return status;
+}
+
+static int jsonSerializer_skipValue(json_serializer_reader_t *reader) {
+    int status = OK;
+    int c = jsonSerializer_peek(reader);
+    const char *start = NULL;
+    size_t len = 0;
+    bool flag = false;
+    json_int_t integer = 0;
+    double real = 0.0;
+
+    if (c == '"') {
+        status = jsonSerializer_scanString(reader, &start, &len, &flag);
+    } else if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        if (++reader->depth > JSON_SERIALIZER_MAX_DEPTH) {
+            LOG_ERROR("Maximum json parsing depth reached");
+            return ERROR;
+        }
+        reader->pos += 1;
+        jsonSerializer_skipWhitespace(reader);
+        if (jsonSerializer_peek(reader) == close) {
+            reader->pos += 1;
+        } else {
+            while (status == OK) {
+                if (c == '{') {
+                    if (jsonSerializer_peek(reader) == '"') {
+                        status = jsonSerializer_scanString(reader, &start, &len, &flag);
+                    } else {
+                        status = ERROR;
+                    }
+                    jsonSerializer_skipWhitespace(reader);
+                    if (status == OK && jsonSerializer_peek(reader) == ':') {
+                        reader->pos += 1;
+                        jsonSerializer_skipWhitespace(reader);
+                    } else {
+                        status = ERROR;
+                    }
+                }
+                if (status == OK) {
+                    status = jsonSerializer_skipValue(reader);
+                }
+                if (status == OK) {
+                    jsonSerializer_skipWhitespace(reader);
+                    int next = jsonSerializer_peek(reader);
+                    if (next == ',') {
+                        reader->pos += 1;
+                        jsonSerializer_skipWhitespace(reader);
+                    } else if (next == close) {
+                        reader->pos += 1;
+                        break;
+                    } else {
+                        status = ERROR;
+                    }
+                }
+            }
+        }
+        reader->depth -= 1;
+    } else if (c == 't') {
+        status = jsonSerializer_readLiteral(reader, "true", 4) ? OK : ERROR;
+    } else if (c == 'f') {
+        status = jsonSerializer_readLiteral(reader, "false", 5) ? OK : ERROR;
+    } else if (c == 'n') {
+        status = jsonSerializer_readLiteral(reader, "null", 4) ? OK : ERROR;
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        status = jsonSerializer_readNumber(reader, &flag, &integer, &real);
+    } else {
+        status = ERROR;
+    }
+
+    if (status != OK) {
+        LOG_ERROR("Error parsing json input, invalid value");
+    }
+    return status;
+}
+
+/**
+ * Counts the elements of the array at the reader position (just after the '['), without validating them.
+ * Used to allocate the sequence buffer in one go.
+ */
+static uint32_t jsonSerializer_countElements(const json_serializer_reader_t *reader) {
+    uint32_t count = 0;
+    int depth = 0;
+    bool empty = true;
+    const char *p = reader->pos;
+    while (p < reader->end) {
+        char c = *p;
+        if (c == '"') {
+            p += 1;
+            while (p < reader->end && *p != '"') {
+                p += *p == '\\' ? 2 : 1;
+            }
+        } else if (c == '[' || c == '{') {
+            depth += 1;
+        } else if (c == ']' || c == '}') {
+            if (depth == 0) {
+                break;
+            }
+            depth -= 1;
+        } else if (c == ',' && depth == 0) {
+            count += 1;
+        }
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            empty = false;
+        }
+        p += 1;
+    }
+    return empty ? 0 : count + 1;
+}
+
+static int jsonSerializer_readType(json_serializer_reader_t *reader, dyn_type *type, void **result) {
+    int status = OK;
+    void *inst = NULL;
+
+    if (dynType_descriptorType(type) == 't') {
+        if (jsonSerializer_peek(reader) == '"') {
+            //note a deserialized C string is a sequence of memory for the actual string and a
+            //pointer to that sequence. That pointer also needs to reside in the memory (heap).
+            inst = calloc(1, sizeof(char*));
+            status = inst != NULL ? jsonSerializer_readString(reader, (char **)inst) : ERROR;
+        } else {
+            status = ERROR;
+            LOG_ERROR("Expected json string");
+        }
+    } else {
+        status = dynType_alloc(type, &inst);
+
+        if (status == OK) {
+            assert(inst != NULL);
+            status = jsonSerializer_readAny(reader, type, inst);
+        }
+    }
+
+    if (status == OK) {
+        *result = inst;
+    } else {
+        *result = NULL;
+        dynType_free(type, inst);
+    }
+
+    return status;
+}
+
+static int jsonSerializer_readEnum(json_serializer_reader_t *reader, dyn_type *type, int32_t *out) {
+    char *name = NULL;
+    int status = jsonSerializer_readString(reader, &name);
+    if (status == OK) {
+        status = jsonSerializer_parseEnum(type, name, out);
+    }
+    free(name);
+    return status;
+}
+
+static int jsonSerializer_readAny(json_serializer_reader_t *reader, dyn_type *type, void *loc) {
+    int status = OK;
+    dyn_type *subType = NULL;
+    char c = dynType_descriptorType(type);
+    int next = jsonSerializer_peek(reader);
+
+    bool isInteger = true;
+    json_int_t integer = 0;
+    double real = 0.0;
+
+    switch (c) {
+        case 'Z' :
+            if (next == 't' && jsonSerializer_readLiteral(reader, "true", 4)) {
+                *(bool *)loc = true;
+            } else {
+                *(bool *)loc = false;
+                status = jsonSerializer_skipValue(reader);
+            }
+            break;
+        case 'F' :
+        case 'D' :
+        case 'N' :
+        case 'B' :
+        case 'S' :
+        case 'I' :
+        case 'J' :
+        case 'b' :
+        case 's' :
+        case 'i' :
+        case 'j' :
+            if (next == '-' || (next >= '0' && next <= '9')) {
+                status = jsonSerializer_readNumber(reader, &isInteger, &integer, &real);
+            } else {
+                //not a number, value is 0 (same as json_integer_value/json_real_value)
+                status = jsonSerializer_skipValue(reader);
+            }
+            if (!isInteger) {
+                integer = 0; //real value for an integer member (same as json_integer_value)
+            }
+            //note an integer value for a real member is 0 (same as json_real_value), real is only set for reals
+            switch (c) {
+                case 'F' : *(float *)loc = (float)real; break;
+                case 'D' : *(double *)loc = real; break;
+                case 'N' : *(int *)loc = (int)integer; break;
+                case 'B' : *(char *)loc = (char)integer; break;
+                case 'S' : *(int16_t *)loc = (int16_t)integer; break;
+                case 'I' : *(int32_t *)loc = (int32_t)integer; break;
+                case 'J' : *(int64_t *)loc = (int64_t)integer; break;
+                case 'b' : *(uint8_t *)loc = (uint8_t)integer; break;
+                case 's' : *(uint16_t *)loc = (uint16_t)integer; break;
+                case 'i' : *(uint32_t *)loc = (uint32_t)integer; break;
+                default : *(uint64_t *)loc = (uint64_t)integer; break;
+            }
+            break;
+        case 'E' :
+            if (next == 'n' && jsonSerializer_readLiteral(reader, "null", 4)) {
+                //nop
+            } else if (next == '"') {
+                status = jsonSerializer_readEnum(reader, type, (int32_t *)loc);
+            } else {
+                status = ERROR;
+                LOG_ERROR("Expected json string for enum type");
+            }
+            break;
+        case 't' :
+            if (next == 'n' && jsonSerializer_readLiteral(reader, "null", 4)) {
+                //nop
+            } else if (next == '"') {
+                status = jsonSerializer_readString(reader, (char **)loc);
+            } else {
+                status = ERROR;
+                LOG_ERROR("Expected json string type");
+            }
+            break;
+        case '[' :
+            if (next == '[') {
+                status = jsonSerializer_readSequence(reader, type, loc);
+            } else {
+                status = ERROR;
+                LOG_ERROR("Expected json array type");
+            }
+            break;
+        case '{' :
+            if (next == '{') {
+                status = jsonSerializer_readObject(reader, type, loc);
+            } else {
+                //not an object, no members to read
+                status = jsonSerializer_skipValue(reader);
+            }
+            break;
+        case '*' :
+            status = dynType_typedPointer_getTypedType(type, &subType);
+            if (status == OK) {
+                status = jsonSerializer_readType(reader, subType, (void **) loc);
+            }
+            break;
+        case 'P' :
+            status = ERROR;
+            LOG_WARNING("Untyped pointer are not supported for serialization");
+            break;
+        case 'l':
+            status = jsonSerializer_readAny(reader, type->ref.ref, loc);
+            break;
+        default :
+            status = ERROR;
+            LOG_ERROR("Error provided type '%c' not supported for JSON\n", dynType_descriptorType(type));
+            break;
+    }
+
+    return status;
+}
+
+static int jsonSerializer_readObject(json_serializer_reader_t *reader, dyn_type *type, void *inst) {
+    assert(dynType_type(type) == DYN_TYPE_COMPLEX);
+    int status = OK;
+    //members already read. For duplicate members the last value wins (same as jansson), so the previous value is freed.
+    uint64_t read = 0;
+
+    if (++reader->depth > JSON_SERIALIZER_MAX_DEPTH) {
+        LOG_ERROR("Maximum json parsing depth reached");
+        return ERROR;
+    }
+    reader->pos += 1; //'{'
+    jsonSerializer_skipWhitespace(reader);
+    if (jsonSerializer_peek(reader) == '}') {
+        reader->pos += 1;
+        reader->depth -= 1;
+        return status;
+    }
+
+    while (status == OK) {
+        const char *name = NULL;
+        size_t nameLength = 0;
+        bool hasEscapes = false;
+        char *decoded = NULL;
+        int index = -1;
+
+        if (jsonSerializer_peek(reader) == '"') {
+            status = jsonSerializer_scanString(reader, &name, &nameLength, &hasEscapes);
+        } else {
+            status = ERROR;
+            LOG_ERROR("Expected json object member name");
+        }
+        if (status == OK && hasEscapes) {
+            decoded = malloc(nameLength + 1);
+            if (decoded != NULL) {
+                nameLength = jsonSerializer_unescape(name, nameLength, decoded);
+                name = decoded;
+            } else {
+                status = ERROR;
+            }
+        }
+        if (status == OK) {
+            index = dynType_complex_indexForNameWithLength(type, name, nameLength);
+            if (index < 0) {
+                LOG_ERROR("Cannot find index for member '%.*s'", (int)nameLength, name);
+                status = ERROR;
+            }
+        }
+        free(decoded);
+
+        if (status == OK) {
+            jsonSerializer_skipWhitespace(reader);
+            if (jsonSerializer_peek(reader) == ':') {
+                reader->pos += 1;
+                jsonSerializer_skipWhitespace(reader);
+            } else {
+                status = ERROR;
+                LOG_ERROR("Expected ':' after json object member name");
+            }
+        }
+
+        if (status == OK) {
+            void *valLoc = (char *)inst + type->complex.offsets[index];
+            dyn_type *valType = type->complex.types[index];
+            if (index >= 64 || (read & (UINT64_C(1) << index)) != 0) {
+                dynType_deepFree(valType, valLoc, false);
+                memset(valLoc, 0, dynType_size(valType));
+            }
+            if (index < 64) {
+                read |= UINT64_C(1) << index;
+            }
+            status = jsonSerializer_readAny(reader, valType, valLoc);
+        }
+
+        if (status == OK) {
+            jsonSerializer_skipWhitespace(reader);
+            int next = jsonSerializer_peek(reader);
+            if (next == ',') {
+                reader->pos += 1;
+                jsonSerializer_skipWhitespace(reader);
+            } else if (next == '}') {
+                reader->pos += 1;
+                break;
+            } else {
+                status = ERROR;
+                LOG_ERROR("Expected ',' or '}' in json object");
+            }
+        }
+    }
+
+    reader->depth -= 1;
+    return status;
+}
+
+static int jsonSerializer_readSequence(json_serializer_reader_t *reader, dyn_type *seq, void *seqLoc) {
+    assert(dynType_type(seq) == DYN_TYPE_SEQUENCE);
+    int status = OK;
+
+    if (++reader->depth > JSON_SERIALIZER_MAX_DEPTH) {
+        LOG_ERROR("Maximum json parsing depth reached");
+        return ERROR;
+    }
+    reader->pos += 1; //'['
+    status = dynType_sequence_alloc(seq, seqLoc, jsonSerializer_countElements(reader));
+
+    dyn_type *itemType = dynType_sequence_itemType(seq);
+    size_t itemSize = dynType_size(itemType);
+    jsonSerializer_skipWhitespace(reader);
+    if (status == OK && jsonSerializer_peek(reader) == ']') {
+        reader->pos += 1;
+    } else {
+        while (status == OK) {
+            void *valLoc = NULL;
+            status = dynType_sequence_increaseLengthAndReturnLastLoc(seq, seqLoc, &valLoc);
+            if (status == OK) {
+                memset(valLoc, 0, itemSize);
+                status = jsonSerializer_readAny(reader, itemType, valLoc);
+            }
+            if (status == OK) {
+                jsonSerializer_skipWhitespace(reader);
+                int next = jsonSerializer_peek(reader);
+                if (next == ',') {
+                    reader->pos += 1;
+                    jsonSerializer_skipWhitespace(reader);
+                } else if (next == ']') {
+                    reader->pos += 1;
+                    break;
+                } else {
+                    status = ERROR;
+                    LOG_ERROR("Expected ',' or ']' in json array");
+                }
+            }
+        }
+    }
+
+    reader->depth -= 1;
+    return status;
+}
+
+static int jsonSerializer_ensure(json_serializer_writer_t *writer, size_t size) {
+    int status = OK;
+    if (writer->len + size > writer->cap) {
+        size_t cap = writer->cap * 2;
+        while (cap < writer->len + size) {
+            cap *= 2;
+        }
+        char *buf = realloc(writer->buf, cap);
+        if (buf != NULL) {
+            writer->buf = buf;
+            writer->cap = cap;
+        } else {
+            status = ERROR;
+            LOG_ERROR("Error allocating memory for json output");
+        }
+    }
+    return status;
+}
+
+static inline int jsonSerializer_write(json_serializer_writer_t *writer, const char *data, size_t size) {
+    int status = jsonSerializer_ensure(writer, size);
+    if (status == OK) {
+        memcpy(writer->buf + writer->len, data, size);
+        writer->len += size;
+    }
+    return status;
+}
+
+static const char* jsonSerializer_enumName(dyn_type *type, int32_t enum_value) {
+    struct meta_entry * entry;
+    char enum_value_str[32];
+    snprintf(enum_value_str, 32, "%d", enum_value);
+    TAILQ_FOREACH(entry, &type->metaProperties, entries) {
+        if (0 == strcmp(enum_value_str, entry->value)) {
+            return entry->name;
+        }
+    }
+    LOG_ERROR("Could not find Enum value %s in enum type", enum_value_str);
+    return NULL;
+}
+
+/**
+ * Streams the instance using the serialization plan of the type. If a value cannot be represented in JSON
+ * (e.g. a NULL string or an untyped pointer) nothing is written and written is set to false. Like the jansson based
+ * serializer these values are omitted.
+ */
+static int jsonSerializer_streamType(json_serializer_writer_t *writer, dyn_type *type, const void *input, bool *written) {
+    const struct dyn_type_plan *plan = dynType_plan(type);
+    return plan != NULL ? jsonSerializer_streamPlan(writer, plan, input, written) : ERROR;
+}
+
+/**
+ * Executes the serialization plan. Every member of a complex type is written followed by a ',', the last ',' is
+ * replaced by the closing '}' at the end of the complex type.
+ */
+static int jsonSerializer_streamPlan(json_serializer_writer_t *writer, const struct dyn_type_plan *plan, const void *input, bool *written) {
+    int status = OK;
+    *written = true;
+
+    for (size_t i = 0; i < plan->nrOfOps && status == OK; i += 1) {
+        const struct dyn_type_plan_op *op = &plan->ops[i];
+        const void *loc = (const char *)input + op->offset;
+        size_t mark = writer->len;
+        bool valueWritten = true;
+
+        if (op->name != NULL && op->kind != DYN_TYPE_PLAN_END_COMPLEX) {
+            bool nameWritten = false;
+            status = jsonSerializer_streamString(writer, op->name, &nameWritten);
+            if (status == OK && !nameWritten) {
+                //member omitted, for a complex member this includes all its members
+                writer->len = mark;
+                if (op->kind == DYN_TYPE_PLAN_BEGIN_COMPLEX) {
+                    i = op->end;
+                }
+                continue;
+            }
+            if (status == OK) {
+                status = jsonSerializer_write(writer, ":", 1);
+            }
+            if (status != OK) {
+                break;
+            }
+        }
+
+        switch (op->kind) {
+            case DYN_TYPE_PLAN_BEGIN_COMPLEX :
+                status = jsonSerializer_write(writer, "{", 1);
+                break;
+            case DYN_TYPE_PLAN_END_COMPLEX :
+                if (writer->buf[writer->len - 1] == ',') {
+                    writer->buf[writer->len - 1] = '}';
+                } else {
+                    status = jsonSerializer_write(writer, "}", 1);
+                }
+                break;
+            case DYN_TYPE_PLAN_VALUE :
+                status = jsonSerializer_streamValue(writer, op, loc, &valueWritten);
+                break;
+            case DYN_TYPE_PLAN_SEQUENCE :
+                status = jsonSerializer_streamSequence(writer, op, loc);
+                break;
+            case DYN_TYPE_PLAN_TYPED_POINTER :
+                if (*(const void * const *)loc != NULL) {
+                    status = jsonSerializer_streamType(writer, op->subType, *(const void * const *)loc, &valueWritten);
+                } else {
+                    valueWritten = false;
+                }
+                break;
+        }
+
+        if (status == OK && !valueWritten) {
+            writer->len = mark; //value omitted
+            if (op->name == NULL) {
+                *written = false;
+            }
+        } else if (status == OK && op->name != NULL && op->kind != DYN_TYPE_PLAN_BEGIN_COMPLEX) {
+            status = jsonSerializer_write(writer, ",", 1);
+        }
+    }
+
+    return status;
+}
+
+static int jsonSerializer_streamValue(json_serializer_writer_t *writer, const struct dyn_type_plan_op *op, const void *input, bool *written) {
+    int status = OK;
+    *written = true;
+
+    switch (op->descriptor) {
+        case 'Z' :
+            status = *(const bool *)input ? jsonSerializer_write(writer, "true", 4) : jsonSerializer_write(writer, "false", 5);
+            break;
+        case 'B' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const char *)input);
+            break;
+        case 'S' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const int16_t *)input);
+            break;
+        case 'I' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const int32_t *)input);
+            break;
+        case 'J' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const int64_t *)input);
+            break;
+        case 'b' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const uint8_t *)input);
+            break;
+        case 's' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const uint16_t *)input);
+            break;
+        case 'i' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const uint32_t *)input);
+            break;
+        case 'j' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const uint64_t *)input);
+            break;
+        case 'N' :
+            status = jsonSerializer_streamInteger(writer, (json_int_t)*(const int *)input);
+            break;
+        case 'F' :
+            status = jsonSerializer_streamReal(writer, (double)*(const float *)input, written);
+            break;
+        case 'D' :
+            status = jsonSerializer_streamReal(writer, *(const double *)input, written);
+            break;
+        case 't' :
+            status = jsonSerializer_streamString(writer, *(const char * const *)input, written);
+            break;
+        case 'E':
+            status = jsonSerializer_streamString(writer, jsonSerializer_enumName(op->type, *(const int32_t *)input), written);
+            break;
+        case 'P' :
+            LOG_WARNING("Untyped pointer not supported for serialization. ignoring");
+            *written = false;
+            break;
+        default :
+            LOG_ERROR("Unsupported descriptor '%c'", op->descriptor);
+            status = ERROR;
+            break;
+    }
+
+    return status;
+}
+
+static int jsonSerializer_streamSequence(json_serializer_writer_t *writer, const struct dyn_type_plan_op *op, const void *input) {
+    const struct dyn_type_plan *itemPlan = dynType_plan(op->subType);
+    const struct generic_sequence *seq = input;
+    int status = itemPlan != NULL ? jsonSerializer_write(writer, "[", 1) : ERROR;
+
+    for (uint32_t i = 0; i < seq->len && status == OK; i += 1) {
+        const void *itemLoc = (const char *)seq->buf + i * op->itemSize;
+        size_t mark = writer->len;
+        bool written = false;
+        status = jsonSerializer_streamPlan(writer, itemPlan, itemLoc, &written);
+        if (status == OK && written) {
+            status = jsonSerializer_write(writer, ",", 1);
+        } else {
+            writer->len = mark; //item omitted
+        }
+    }
+
+    if (status == OK) {
+        if (writer->buf[writer->len - 1] == ',') {
+            writer->buf[writer->len - 1] = ']';
+        } else {
+            status = jsonSerializer_write(writer, "]", 1);
+        }
+    }
+    return status;
+}
+
+/**
+ * Streams a string using the same escaping as jansson. NULL or invalid UTF-8 strings are omitted.
+ */
+static int jsonSerializer_streamString(json_serializer_writer_t *writer, const char *str, bool *written) {
+    *written = false;
+    if (str == NULL) {
+        return OK;
+    }
+
+    size_t mark = writer->len;
+    int status = jsonSerializer_write(writer, "\"", 1);
+    const unsigned char *p = (const unsigned char *)str;
+    const unsigned char *run = p;
+    while (status == OK && *p != '\0') {
+        unsigned char c = *p;
+        if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80) {
+            p += 1;
+            continue;
+        } else if (c >= 0x80) {
+            //note a '\0' fails the continuation byte check, so at most the terminating '\0' is read
+            size_t size = jsonSerializer_utf8Length(p, 4);
+            if (size == 0) {
+                writer->len = mark;
+                return OK;
+            }
+            p += size;
+            continue;
+        }
+
+        status = jsonSerializer_write(writer, (const char *)run, (size_t)(p - run));
+        char seq[8];
+        const char *escape = seq;
+        switch (c) {
+            case '"' : escape = "\\\""; break;
+            case '\\' : escape = "\\\\"; break;
+            case '\b' : escape = "\\b"; break;
+            case '\f' : escape = "\\f"; break;
+            case '\n' : escape = "\\n"; break;
+            case '\r' : escape = "\\r"; break;
+            case '\t' : escape = "\\t"; break;
+            default : snprintf(seq, sizeof(seq), "\\u%04X", (unsigned int)c); break;
+        }
+        if (status == OK) {
+            status = jsonSerializer_write(writer, escape, strlen(escape));
+        }
+        p += 1;
+        run = p;
+    }
+    if (status == OK) {
+        status = jsonSerializer_write(writer, (const char *)run, (size_t)(p - run));
+    }
+    if (status == OK) {
+        status = jsonSerializer_write(writer, "\"", 1);
+    }
+    *written = status == OK;
+    return status;
+}
+
+static int jsonSerializer_streamInteger(json_serializer_writer_t *writer, json_int_t val) {
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    unsigned long long u = val < 0 ? 0ULL - (unsigned long long)val : (unsigned long long)val;
+    do {
+        *--p = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (val < 0) {
+        *--p = '-';
+    }
+    return jsonSerializer_write(writer, p, (size_t)(buf + sizeof(buf) - p));
+}
+
+/**
+ * Streams a real using the same format as jansson (%.17g, always with a '.' or exponent).
+ * NaN and infinity cannot be represented in JSON and are omitted.
+ */
+static int jsonSerializer_streamReal(json_serializer_writer_t *writer, double val, bool *written) {
+    if (isnan(val) || isinf(val)) {
+        *written = false;
+        return OK;
+    }
+
+    char buf[100];
+    size_t len = (size_t)snprintf(buf, sizeof(buf), "%.17g", val);
+    jsonSerializer_fromLocale(buf);
+    if (strchr(buf, '.') == NULL && strchr(buf, 'e') == NULL) {
+        buf[len++] = '.';
+        buf[len++] = '0';
+        buf[len] = '\0';
+    }
+
+    //remove the leading '+' and leading zeros from the exponent
+    char *start = strchr(buf, 'e');
+    if (start != NULL) {
+        start += 1;
+        char *end = start + 1;
+        if (*start == '-') {
+            start += 1;
+        }
+        while (*end == '0') {
+            end += 1;
+        }
+        if (end != start) {
+            memmove(start, end, len - (size_t)(end - buf));
+            len -= (size_t)(end - start);
+        }
+    }
+    return jsonSerializer_write(writer, buf, len);
+}
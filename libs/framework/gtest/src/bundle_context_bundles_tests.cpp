@@ -25,6 +25,10 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
 #include <celix_log_utils.h>
 
 #include "celix_api.h"
@@ -471,3 +475,187 @@ TEST_F(CelixBundleContextBundlesTests, bundleInfoTests) {
     celix_bundleContext_unregisterService(ctx, svcId);
     celix_bundleContext_stopTracker(ctx, trackerId);
 }
+
+class CelixBundleContextBundlesWithEventDispatcherPoolTests : public ::testing::Test {
+public:
+    celix_framework_t* fw = nullptr;
+    celix_bundle_context_t *ctx = nullptr;
+
+    const char * const TEST_BND1_LOC = "" SIMPLE_TEST_BUNDLE1_LOCATION "";
+    const char * const TEST_BND2_LOC = "" SIMPLE_TEST_BUNDLE2_LOCATION "";
+    const char * const TEST_BND3_LOC = "" SIMPLE_TEST_BUNDLE3_LOCATION "";
+
+    CelixBundleContextBundlesWithEventDispatcherPoolTests() {
+        auto* properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheBundleContextTestFramework");
+        properties_set(properties, CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE, "4");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    ~CelixBundleContextBundlesWithEventDispatcherPoolTests() override {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    CelixBundleContextBundlesWithEventDispatcherPoolTests(CelixBundleContextBundlesWithEventDispatcherPoolTests&&) = delete;
+    CelixBundleContextBundlesWithEventDispatcherPoolTests(const CelixBundleContextBundlesWithEventDispatcherPoolTests&) = delete;
+    CelixBundleContextBundlesWithEventDispatcherPoolTests& operator=(CelixBundleContextBundlesWithEventDispatcherPoolTests&&) = delete;
+    CelixBundleContextBundlesWithEventDispatcherPoolTests& operator=(const CelixBundleContextBundlesWithEventDispatcherPoolTests&) = delete;
+};
+
+TEST_F(CelixBundleContextBundlesWithEventDispatcherPoolTests, trackBundlesInOrderTest) {
+    struct data {
+        std::mutex mutex{};
+        std::map<long, std::vector<std::string>> events{};
+    };
+    struct data data{};
+
+    auto installed = [](void *handle, const bundle_t *bnd) {
+        auto *d = static_cast<struct data*>(handle);
+        std::lock_guard<std::mutex> lock{d->mutex};
+        d->events[celix_bundle_getId(bnd)].emplace_back("installed");
+    };
+    auto started = [](void *handle, const bundle_t *bnd) {
+        auto *d = static_cast<struct data*>(handle);
+        std::lock_guard<std::mutex> lock{d->mutex};
+        d->events[celix_bundle_getId(bnd)].emplace_back("started");
+    };
+    auto stopped = [](void *handle, const bundle_t *bnd) {
+        auto *d = static_cast<struct data*>(handle);
+        std::lock_guard<std::mutex> lock{d->mutex};
+        d->events[celix_bundle_getId(bnd)].emplace_back("stopped");
+    };
+
+    celix_bundle_tracking_options_t opts{};
+    opts.callbackHandle = static_cast<void*>(&data);
+    opts.onInstalled = installed;
+    opts.onStarted = started;
+    opts.onStopped = stopped;
+    long trackerId = celix_bundleContext_trackBundlesWithOptions(ctx, &opts);
+
+    long bndIds[3];
+    bndIds[0] = celix_bundleContext_installBundle(ctx, TEST_BND1_LOC, true);
+    bndIds[1] = celix_bundleContext_installBundle(ctx, TEST_BND2_LOC, true);
+    bndIds[2] = celix_bundleContext_installBundle(ctx, TEST_BND3_LOC, true);
+    for (long bndId : bndIds) {
+        EXPECT_TRUE(bndId >= 0);
+        celix_bundleContext_stopBundle(ctx, bndId);
+    }
+    celix_framework_waitForEmptyEventQueue(fw);
+    EXPECT_EQ(0, celix_framework_getEventQueueSize(fw));
+
+    std::vector<std::string> expected{"installed", "started", "stopped"};
+    for (long bndId : bndIds) {
+        std::lock_guard<std::mutex> lock{data.mutex};
+        EXPECT_EQ(expected, data.events[bndId]);
+    }
+
+    celix_framework_event_queue_stats_t stats{};
+    celix_framework_getEventQueueStats(fw, &stats);
+    EXPECT_EQ(0, stats.size);
+    EXPECT_GE(stats.maxSize, 1);
+    EXPECT_GE(stats.nrOfHandledEvents, 9); //at least the installed, started and stopped events for the 3 bundles
+    EXPECT_GT(stats.averageLatency, 0.0);
+    EXPECT_GE(stats.maxLatency, stats.averageLatency);
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+}
+
+TEST(CelixBundleContextBundlesAutoStartTests, parallelAutoStartTest) {
+    auto* properties = properties_create();
+    properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+    properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+    properties_set(properties, "org.osgi.framework.storage", ".cacheBundleContextTestFramework");
+    properties_set(properties, CELIX_AUTO_START_1, SIMPLE_TEST_BUNDLE1_LOCATION " " SIMPLE_TEST_BUNDLE2_LOCATION);
+    properties_set(properties, CELIX_AUTO_START_2, SIMPLE_TEST_BUNDLE3_LOCATION " " SIMPLE_TEST_BUNDLE1_LOCATION);
+    properties_set(properties, CELIX_AUTO_START_POOL_SIZE, "4");
+
+    auto* fw = celix_frameworkFactory_createFramework(properties);
+    ASSERT_TRUE(fw != nullptr);
+    auto* ctx = framework_getContext(fw);
+
+    auto* bndIds = celix_bundleContext_listBundles(ctx);
+    EXPECT_EQ(3, celix_arrayList_size(bndIds)); //note bundle 1 is configured twice, but only installed once
+    for (int i = 0; i < celix_arrayList_size(bndIds); ++i) {
+        long bndId = celix_arrayList_getLong(bndIds, i);
+        bool called = celix_bundleContext_useBundle(ctx, bndId, nullptr, [](void *, const celix_bundle_t *bnd) {
+            EXPECT_EQ(OSGI_FRAMEWORK_BUNDLE_ACTIVE, celix_bundle_getState(bnd));
+        });
+        EXPECT_TRUE(called);
+    }
+    celix_arrayList_destroy(bndIds);
+
+    celix_frameworkFactory_destroyFramework(fw);
+}
+
+TEST(CelixBundleContextBundlesCacheTests, reuseExtractedBundlesOnRestartTest) {
+    const char* cacheDir = ".cacheBundleContextReuseTestFramework";
+    auto createFramework = [cacheDir](const char* clean) {
+        auto* properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", clean);
+        properties_set(properties, "org.osgi.framework.storage", cacheDir);
+        return celix_frameworkFactory_createFramework(properties);
+    };
+    auto fileSize = [](const std::string& path) -> long {
+        struct stat st{};
+        return stat(path.c_str(), &st) == 0 ? (long)st.st_size : -1L;
+    };
+
+    auto* fw = createFramework("true");
+    ASSERT_TRUE(fw != nullptr);
+    long bndId = celix_bundleContext_installBundle(framework_getContext(fw), SIMPLE_TEST_BUNDLE1_LOCATION, true);
+    ASSERT_GE(bndId, 0);
+    celix_frameworkFactory_destroyFramework(fw);
+
+    std::string revisionRoot = std::string{cacheDir} + "/bundle" + std::to_string(bndId) + "/version0.0";
+    std::string manifest = revisionRoot + "/META-INF/MANIFEST.MF";
+    long extractedSize = fileSize(manifest);
+    ASSERT_GT(extractedSize, 0);
+    FILE* f = fopen(manifest.c_str(), "a");
+    ASSERT_TRUE(f != nullptr);
+    fputs("\n", f);
+    fclose(f);
+
+    //restart with cache, bundle zip is unchanged -> no extraction (changed manifest stays)
+    fw = createFramework("false");
+    ASSERT_TRUE(fw != nullptr);
+    EXPECT_TRUE(celix_bundleContext_isBundleInstalled(framework_getContext(fw), bndId));
+    EXPECT_EQ(extractedSize + 1, fileSize(manifest));
+    celix_frameworkFactory_destroyFramework(fw);
+
+    //restart with cache, only the bundle zip modification time changed -> no extraction and the index is updated
+    std::string revisionIndex = revisionRoot + "/revision.index";
+    auto* index = celix_properties_load(revisionIndex.c_str());
+    ASSERT_TRUE(index != nullptr);
+    long mtime = celix_properties_getAsLong(index, "source.mtime", -1);
+    celix_properties_setLong(index, "source.mtime", 1);
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_store(index, revisionIndex.c_str(), nullptr));
+    celix_properties_destroy(index);
+
+    fw = createFramework("false");
+    ASSERT_TRUE(fw != nullptr);
+    EXPECT_TRUE(celix_bundleContext_isBundleInstalled(framework_getContext(fw), bndId));
+    EXPECT_EQ(extractedSize + 1, fileSize(manifest));
+    celix_frameworkFactory_destroyFramework(fw);
+    index = celix_properties_load(revisionIndex.c_str());
+    ASSERT_TRUE(index != nullptr);
+    EXPECT_EQ(mtime, celix_properties_getAsLong(index, "source.mtime", -1));
+    celix_properties_destroy(index);
+
+    //restart with cache, bundle zip considered changed -> extraction
+    index = celix_properties_load(revisionIndex.c_str());
+    ASSERT_TRUE(index != nullptr);
+    celix_properties_setLong(index, "source.size", 1);
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_store(index, revisionIndex.c_str(), nullptr));
+    celix_properties_destroy(index);
+
+    fw = createFramework("false");
+    ASSERT_TRUE(fw != nullptr);
+    EXPECT_TRUE(celix_bundleContext_isBundleInstalled(framework_getContext(fw), bndId));
+    EXPECT_EQ(extractedSize, fileSize(manifest));
+    celix_frameworkFactory_destroyFramework(fw);
+}
@@ -27,6 +27,9 @@
 #include <condition_variable>
 #include <string.h>
 #include <future>
+#include <vector>
+#include <string>
+#include <atomic>
 
 #include "celix_api.h"
 #include "celix_framework_factory.h"
@@ -782,6 +785,486 @@ TEST_F(CelixBundleContextServicesTests, findServicesTest) {
     celix_bundleContext_unregisterService(ctx, svcId2);
 }
 
+TEST_F(CelixBundleContextServicesTests, findServicesWithFilterAndCustomObjectClassTest) {
+    long svcId1 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    celix_properties_t *props = celix_properties_create();
+    celix_properties_set(props, "key", "value");
+    long svcId2 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", props);
+    long svcId3 = celix_bundleContext_registerService(ctx, (void*)0x100, "other", nullptr);
+
+    celix_service_filter_options_t opts{};
+    opts.serviceName = "example";
+    opts.filter = "(key=value)";
+    celix_array_list_t *list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    ASSERT_EQ(1, celix_arrayList_size(list));
+    ASSERT_EQ(svcId2, celix_arrayList_getLong(list, 0));
+    celix_arrayList_destroy(list);
+
+    opts.serviceName = "other";
+    opts.filter = nullptr;
+    list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    ASSERT_EQ(1, celix_arrayList_size(list));
+    ASSERT_EQ(svcId3, celix_arrayList_getLong(list, 0));
+    celix_arrayList_destroy(list);
+
+    //registration with a objectClass property which differs from the service name
+    props = celix_properties_create();
+    celix_properties_set(props, OSGI_FRAMEWORK_OBJECTCLASS, "custom");
+    long svcId4 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", props);
+    opts.serviceName = "custom";
+    list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    ASSERT_EQ(1, celix_arrayList_size(list));
+    ASSERT_EQ(svcId4, celix_arrayList_getLong(list, 0));
+    celix_arrayList_destroy(list);
+
+    celix_bundleContext_unregisterService(ctx, svcId4);
+    list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    ASSERT_EQ(0, celix_arrayList_size(list));
+    celix_arrayList_destroy(list);
+
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    celix_bundleContext_unregisterService(ctx, svcId3);
+}
+
+TEST_F(CelixBundleContextServicesTests, findServiceWithManyRegisteredServices_Benchmark) {
+    std::vector<long> svcIds{};
+    for (int nrOfServices : {10, 100, 1000, 5000}) {
+        while ((int)svcIds.size() < nrOfServices) {
+            std::string name = std::string{"service"} + std::to_string(svcIds.size());
+            svcIds.push_back(celix_bundleContext_registerService(ctx, (void*)0x42, name.c_str(), nullptr));
+        }
+
+        auto start = std::chrono::system_clock::now();
+        for (int i = 0; i < 1000; ++i) {
+            long svcId = celix_bundleContext_findService(ctx, "service0");
+            ASSERT_EQ(svcIds[0], svcId);
+        }
+        auto end = std::chrono::system_clock::now();
+        std::cout << "findService with " << nrOfServices << " registered services took " << std::chrono::duration_cast<std::chrono::microseconds>(end-start).count() / 1000 << " µs per call\n";
+    }
+    for (long svcId : svcIds) {
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+}
+
+TEST_F(CelixBundleContextServicesTests, useTrackedServiceTest) {
+    struct calc {
+        int (*calc)(int);
+    };
+    struct calc svc{};
+    svc.calc = [](int n) -> int {
+        return n * 42;
+    };
+
+    long trackerId = celix_bundleContext_trackServices(ctx, "calc", nullptr, nullptr, nullptr);
+    ASSERT_TRUE(trackerId >= 0);
+
+    auto use = [](void *handle, void *svc) {
+        int *total = static_cast<int*>(handle);
+        *total += static_cast<struct calc*>(svc)->calc(1);
+    };
+    int total = 0;
+    bool called = celix_bundleContext_useTrackedService(ctx, trackerId, &total, use);
+    ASSERT_FALSE(called);
+
+    long svcId1 = celix_bundleContext_registerService(ctx, &svc, "calc", nullptr);
+    long svcId2 = celix_bundleContext_registerService(ctx, &svc, "calc", nullptr);
+
+    called = celix_bundleContext_useTrackedService(ctx, trackerId, &total, use);
+    ASSERT_TRUE(called);
+    ASSERT_EQ(42, total);
+
+    total = 0;
+    size_t count = celix_bundleContext_useTrackedServices(ctx, trackerId, &total, use);
+    ASSERT_EQ(2, count);
+    ASSERT_EQ(84, total);
+
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    total = 0;
+    count = celix_bundleContext_useTrackedServices(ctx, trackerId, &total, use);
+    ASSERT_EQ(0, count);
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+    called = celix_bundleContext_useTrackedService(ctx, trackerId, &total, use); //unknown tracker id
+    ASSERT_FALSE(called);
+}
+
+TEST_F(CelixBundleContextServicesTests, stopTrackerWaitsForUseTrackedServiceTest) {
+    int svc = 42;
+    long svcId = celix_bundleContext_registerService(ctx, &svc, "test", nullptr);
+    long trackerId = celix_bundleContext_trackServices(ctx, "test", nullptr, nullptr, nullptr);
+    ASSERT_TRUE(trackerId >= 0);
+
+    struct use_data {
+        std::promise<void> inUse{};
+        std::promise<void> done{};
+        std::shared_future<void> doneFuture{done.get_future()};
+    } data{};
+    std::thread user{[&] {
+        bool called = celix_bundleContext_useTrackedService(ctx, trackerId, &data, [](void *handle, void *) {
+            auto *d = static_cast<struct use_data*>(handle);
+            d->inUse.set_value();
+            d->doneFuture.wait();
+        });
+        EXPECT_TRUE(called);
+    }};
+    data.inUse.get_future().wait();
+
+    std::atomic<bool> stopped{false};
+    std::thread stopper{[&] {
+        celix_bundleContext_stopTracker(ctx, trackerId);
+        stopped = true;
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_FALSE(stopped); //waiting for the pending use call
+    data.done.set_value();
+    user.join();
+    stopper.join();
+    EXPECT_TRUE(stopped);
+
+    celix_bundleContext_unregisterService(ctx, svcId);
+}
+
+TEST_F(CelixBundleContextServicesTests, useServiceVersusUseTrackedService_Benchmark) {
+    struct calc {
+        int (*calc)(int);
+    };
+    struct calc svc{};
+    svc.calc = [](int n) -> int {
+        return n * 42;
+    };
+    long svcId = celix_bundleContext_registerService(ctx, &svc, "calc", nullptr);
+    auto use = [](void *handle, void *svc) {
+        int *total = static_cast<int*>(handle);
+        *total += static_cast<struct calc*>(svc)->calc(1);
+    };
+    const int nrOfCalls = 10000;
+
+    int total = 0;
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < nrOfCalls; ++i) {
+        celix_bundleContext_useService(ctx, "calc", &total, use);
+    }
+    auto end = std::chrono::system_clock::now();
+    ASSERT_EQ(42 * nrOfCalls, total);
+    std::cout << "useService took " << std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count() / nrOfCalls << " ns per call\n";
+
+    long trackerId = celix_bundleContext_trackServices(ctx, "calc", nullptr, nullptr, nullptr);
+    total = 0;
+    start = std::chrono::system_clock::now();
+    for (int i = 0; i < nrOfCalls; ++i) {
+        celix_bundleContext_useTrackedService(ctx, trackerId, &total, use);
+    }
+    end = std::chrono::system_clock::now();
+    ASSERT_EQ(42 * nrOfCalls, total);
+    std::cout << "useTrackedService took " << std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count() / nrOfCalls << " ns per call\n";
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+    celix_bundleContext_unregisterService(ctx, svcId);
+}
+
+TEST_F(CelixBundleContextServicesTests, useTrackedServicesInRankingOrderTest) {
+    //ranking, expected order index
+    const long rankings[] = {5, 10, 1, 10, -3, 5};
+    const int nrOfServices = 6;
+    long svcIds[nrOfServices];
+    for (int i = 0; i < nrOfServices; ++i) {
+        auto *props = celix_properties_create();
+        celix_properties_setLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, rankings[i]);
+        svcIds[i] = celix_bundleContext_registerService(ctx, (void*)0x42, "calc", props);
+    }
+    long trackerId = celix_bundleContext_trackServices(ctx, "calc", nullptr, nullptr, nullptr);
+
+    //highest ranking, lowest service id for equal rankings
+    long highestSvcId = -1;
+    celix_service_use_options_t opts{};
+    opts.callbackHandle = &highestSvcId;
+    opts.useWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        *static_cast<long*>(handle) = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    };
+    EXPECT_TRUE(celix_bundleContext_useTrackedServiceWithOptions(ctx, trackerId, &opts));
+    EXPECT_EQ(svcIds[1], highestSvcId);
+    EXPECT_EQ(svcIds[1], celix_bundleContext_findService(ctx, "calc"));
+
+    std::vector<long> ordered{};
+    opts.callbackHandle = &ordered;
+    opts.useWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        static_cast<std::vector<long>*>(handle)->push_back(celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1));
+    };
+    EXPECT_EQ(3, celix_bundleContext_useTopRankedTrackedServicesWithOptions(ctx, trackerId, 3, &opts));
+    std::vector<long> expected{svcIds[1], svcIds[3], svcIds[0]};
+    EXPECT_EQ(expected, ordered);
+
+    ordered.clear();
+    EXPECT_EQ(nrOfServices, celix_bundleContext_useTrackedServicesWithOptions(ctx, trackerId, &opts));
+    expected = std::vector<long>{svcIds[1], svcIds[3], svcIds[0], svcIds[5], svcIds[2], svcIds[4]};
+    EXPECT_EQ(expected, ordered);
+
+    //highest ranking is updated when unregistered
+    celix_bundleContext_unregisterService(ctx, svcIds[1]);
+    opts.callbackHandle = &highestSvcId;
+    opts.useWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        *static_cast<long*>(handle) = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    };
+    EXPECT_TRUE(celix_bundleContext_useTrackedServiceWithOptions(ctx, trackerId, &opts));
+    EXPECT_EQ(svcIds[3], highestSvcId);
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+    for (int i = 0; i < nrOfServices; ++i) {
+        if (i != 1) {
+            celix_bundleContext_unregisterService(ctx, svcIds[i]);
+        }
+    }
+}
+
+TEST_F(CelixBundleContextServicesTests, trackedServiceRankingUpdatedOnSetPropertiesTest) {
+    service_registration_t *reg1 = nullptr;
+    service_registration_t *reg2 = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, bundleContext_registerService(ctx, "calc", (void*)0x100, nullptr, &reg1));
+    ASSERT_EQ(CELIX_SUCCESS, bundleContext_registerService(ctx, "calc", (void*)0x200, nullptr, &reg2));
+    long svcId1 = serviceRegistration_getServiceId(reg1);
+    long svcId2 = serviceRegistration_getServiceId(reg2);
+
+    struct data {
+        std::atomic<long> setSvcId{-1};
+        long highestSvcId{-1};
+    };
+    data d{};
+
+    celix_service_tracking_options_t trkOpts{};
+    trkOpts.filter.serviceName = "calc";
+    trkOpts.filter.ignoreServiceLanguage = true; //services registered with the deprecated api have no language
+    trkOpts.callbackHandle = &d;
+    trkOpts.setWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        auto *d = static_cast<data*>(handle);
+        d->setSvcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    };
+    long trackerId = celix_bundleContext_trackServicesWithOptions(ctx, &trkOpts);
+
+    celix_service_use_options_t opts{};
+    opts.callbackHandle = &d;
+    opts.useWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        static_cast<data*>(handle)->highestSvcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    };
+    EXPECT_TRUE(celix_bundleContext_useTrackedServiceWithOptions(ctx, trackerId, &opts));
+    EXPECT_EQ(svcId1, d.highestSvcId); //equal ranking -> lowest service id
+    EXPECT_EQ(svcId1, d.setSvcId);
+
+    //increase the ranking of svc2 -> svc2 should be the highest ranking service
+    auto *props = celix_properties_create();
+    celix_properties_set(props, OSGI_FRAMEWORK_OBJECTCLASS, "calc");
+    celix_properties_setLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, 10);
+    EXPECT_EQ(CELIX_SUCCESS, serviceRegistration_setProperties(reg2, props));
+    EXPECT_TRUE(celix_bundleContext_useTrackedServiceWithOptions(ctx, trackerId, &opts));
+    EXPECT_EQ(svcId2, d.highestSvcId);
+    EXPECT_EQ(svcId2, d.setSvcId);
+
+    std::vector<long> ordered{};
+    opts.callbackHandle = &ordered;
+    opts.useWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        static_cast<std::vector<long>*>(handle)->push_back(celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1));
+    };
+    EXPECT_EQ(2, celix_bundleContext_useTrackedServicesWithOptions(ctx, trackerId, &opts));
+    std::vector<long> expected{svcId2, svcId1};
+    EXPECT_EQ(expected, ordered);
+
+    //decrease the ranking of svc2 again -> svc1 should be the highest ranking service
+    props = celix_properties_create();
+    celix_properties_set(props, OSGI_FRAMEWORK_OBJECTCLASS, "calc");
+    celix_properties_setLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, -1);
+    EXPECT_EQ(CELIX_SUCCESS, serviceRegistration_setProperties(reg2, props));
+    opts.callbackHandle = &d;
+    opts.useWithProperties = [](void *handle, void *, const celix_properties_t *props) {
+        static_cast<data*>(handle)->highestSvcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
+    };
+    EXPECT_TRUE(celix_bundleContext_useTrackedServiceWithOptions(ctx, trackerId, &opts));
+    EXPECT_EQ(svcId1, d.highestSvcId);
+    EXPECT_EQ(svcId1, d.setSvcId);
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+    serviceRegistration_unregister(reg1);
+    serviceRegistration_unregister(reg2);
+}
+
+TEST_F(CelixBundleContextServicesTests, useHighestRankingTrackedServiceWithManyServices_Benchmark) {
+    const int nrOfServices = 1000;
+    std::vector<long> svcIds{};
+    for (int i = 0; i < nrOfServices; ++i) {
+        auto *props = celix_properties_create();
+        celix_properties_setLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, i % 100);
+        svcIds.push_back(celix_bundleContext_registerService(ctx, (void*)0x42, "calc", props));
+    }
+    long trackerId = celix_bundleContext_trackServices(ctx, "calc", nullptr, nullptr, nullptr);
+
+    const int nrOfCalls = 10000;
+    int count = 0;
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < nrOfCalls; ++i) {
+        celix_bundleContext_useTrackedService(ctx, trackerId, &count, [](void *handle, void *) {
+            *static_cast<int*>(handle) += 1;
+        });
+    }
+    auto end = std::chrono::system_clock::now();
+    EXPECT_EQ(nrOfCalls, count);
+    std::cout << "useTrackedService with " << nrOfServices << " tracked services took "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count() / nrOfCalls << " ns per call\n";
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+    for (long svcId : svcIds) {
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+}
+
+TEST_F(CelixBundleContextServicesTests, concurrentUseTrackedServices_Benchmark) {
+    struct calc {
+        int (*calc)(int);
+    };
+    struct calc svc{};
+    svc.calc = [](int n) -> int {
+        return n * 42;
+    };
+    const int nrOfServices = 4;
+    std::vector<long> svcIds{};
+    for (int i = 0; i < nrOfServices; ++i) {
+        svcIds.push_back(celix_bundleContext_registerService(ctx, &svc, "calc", nullptr));
+    }
+    long trackerId = celix_bundleContext_trackServices(ctx, "calc", nullptr, nullptr, nullptr);
+    auto use = [](void *handle, void *svc) {
+        auto *total = static_cast<long*>(handle);
+        *total += static_cast<struct calc*>(svc)->calc(1);
+    };
+
+    const int nrOfCallsPerThread = 100000;
+    for (int nrOfThreads : {1, 2, 4, 8}) {
+        std::vector<std::thread> threads{};
+        std::atomic<long> total{0};
+        auto start = std::chrono::system_clock::now();
+        for (int t = 0; t < nrOfThreads; ++t) {
+            threads.emplace_back([&]{
+                long localTotal = 0;
+                for (int i = 0; i < nrOfCallsPerThread; ++i) {
+                    celix_bundleContext_useTrackedService(ctx, trackerId, &localTotal, use);
+                    celix_bundleContext_useTrackedServices(ctx, trackerId, &localTotal, use);
+                }
+                total.fetch_add(localTotal);
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::system_clock::now();
+        EXPECT_EQ(42L * (1 + nrOfServices) * nrOfCallsPerThread * nrOfThreads, total.load());
+        long totalCalls = 2L * nrOfCallsPerThread * nrOfThreads;
+        std::cout << "useTrackedService(s) with " << nrOfThreads << " threads took "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(end-start).count() << " µs ("
+                  << std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count() / totalCalls << " ns per call)\n";
+    }
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+    for (long svcId : svcIds) {
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+}
+
+TEST_F(CelixBundleContextServicesTests, useTrackedServicesWhileRegisteringAndUnregisteringTest) {
+    struct calc {
+        std::atomic<bool> registered{false};
+    };
+    const int nrOfServices = 8;
+    struct calc svcs[nrOfServices];
+    long trackerId = celix_bundleContext_trackServices(ctx, "calc", nullptr, nullptr, nullptr);
+
+    std::atomic<bool> running{true};
+    std::atomic<long> nrOfUnregisteredUses{0};
+    std::vector<std::thread> users{};
+    for (int t = 0; t < 4; ++t) {
+        users.emplace_back([&]{
+            while (running) {
+                celix_bundleContext_useTrackedServices(ctx, trackerId, &nrOfUnregisteredUses, [](void *handle, void *svc) {
+                    if (!static_cast<struct calc*>(svc)->registered) {
+                        static_cast<std::atomic<long>*>(handle)->fetch_add(1);
+                    }
+                });
+            }
+        });
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        long svcIds[nrOfServices];
+        for (int i = 0; i < nrOfServices; ++i) {
+            svcs[i].registered = true;
+            svcIds[i] = celix_bundleContext_registerService(ctx, &svcs[i], "calc", nullptr);
+        }
+        for (int i = 0; i < nrOfServices; ++i) {
+            celix_bundleContext_unregisterService(ctx, svcIds[i]);
+            //after unregister the tracker should not use the service anymore
+            svcs[i].registered = false;
+        }
+    }
+    running = false;
+    for (auto &user : users) {
+        user.join();
+    }
+    EXPECT_EQ(0, nrOfUnregisteredUses.load());
+    celix_bundleContext_stopTracker(ctx, trackerId);
+}
+
+static void registerServicesWithManyTrackersBenchmark(celix_framework_t* fw, celix_bundle_context_t* ctx, const char* mode) {
+    const int nrOfTrackers = 100;
+    const int nrOfServices = 100;
+    struct counts {
+        std::atomic<long> add{0};
+        std::atomic<long> remove{0};
+    };
+    struct counts counts{};
+
+    std::vector<long> trackerIds{};
+    for (int i = 0; i < nrOfTrackers; ++i) {
+        celix_service_tracking_options_t opts{};
+        opts.filter.serviceName = "calc";
+        opts.callbackHandle = &counts;
+        opts.add = [](void *handle, void *) {
+            static_cast<struct counts*>(handle)->add.fetch_add(1);
+        };
+        opts.remove = [](void *handle, void *) {
+            static_cast<struct counts*>(handle)->remove.fetch_add(1);
+        };
+        trackerIds.push_back(celix_bundleContext_trackServicesWithOptions(ctx, &opts));
+    }
+
+    std::vector<long> svcIds{};
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < nrOfServices; ++i) {
+        svcIds.push_back(celix_bundleContext_registerService(ctx, (void*)0x42, "calc", nullptr));
+    }
+    auto end = std::chrono::system_clock::now();
+    celix_framework_waitForEmptyEventQueue(fw);
+    auto handled = std::chrono::system_clock::now();
+    EXPECT_EQ(nrOfTrackers * nrOfServices, counts.add.load());
+    std::cout << "[" << mode << "] registering " << nrOfServices << " services with " << nrOfTrackers << " trackers took "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end-start).count() / nrOfServices << " µs per call ("
+              << std::chrono::duration_cast<std::chrono::microseconds>(handled-start).count() / nrOfServices << " µs per service until all trackers are updated)\n";
+
+    start = std::chrono::system_clock::now();
+    for (long svcId : svcIds) {
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+    end = std::chrono::system_clock::now();
+    EXPECT_EQ(nrOfTrackers * nrOfServices, counts.remove.load()); //UNREGISTERING events are always synchronous
+    std::cout << "[" << mode << "] unregistering " << nrOfServices << " services with " << nrOfTrackers << " trackers took "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end-start).count() / nrOfServices << " µs per call\n";
+
+    for (long trackerId : trackerIds) {
+        celix_bundleContext_stopTracker(ctx, trackerId);
+    }
+}
+
+TEST_F(CelixBundleContextServicesTests, registerServicesWithManyTrackers_Benchmark) {
+    registerServicesWithManyTrackersBenchmark(fw, ctx, "sync");
+}
+
 TEST_F(CelixBundleContextServicesTests, trackServiceTrackerTest) {
 
     int count = 0;
@@ -825,3 +1308,127 @@ TEST_F(CelixBundleContextServicesTests, trackServiceTrackerTest) {
     celix_bundleContext_stopTracker(ctx, trackerId);
     celix_bundleContext_stopTracker(ctx, tracker4);
 }
+
+class CelixBundleContextServicesWithAsyncEventsTests : public ::testing::Test {
+public:
+    celix_framework_t* fw = nullptr;
+    celix_bundle_context_t *ctx = nullptr;
+
+    CelixBundleContextServicesWithAsyncEventsTests() {
+        auto* properties = properties_create();
+        properties_set(properties, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        properties_set(properties, "org.osgi.framework.storage.clean", "onFirstInit");
+        properties_set(properties, "org.osgi.framework.storage", ".cacheBundleContextTestFramework");
+        properties_set(properties, CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS, "true");
+        properties_set(properties, CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE, "4");
+
+        fw = celix_frameworkFactory_createFramework(properties);
+        ctx = framework_getContext(fw);
+    }
+
+    ~CelixBundleContextServicesWithAsyncEventsTests() override {
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    CelixBundleContextServicesWithAsyncEventsTests(CelixBundleContextServicesWithAsyncEventsTests&&) = delete;
+    CelixBundleContextServicesWithAsyncEventsTests(const CelixBundleContextServicesWithAsyncEventsTests&) = delete;
+    CelixBundleContextServicesWithAsyncEventsTests& operator=(CelixBundleContextServicesWithAsyncEventsTests&&) = delete;
+    CelixBundleContextServicesWithAsyncEventsTests& operator=(const CelixBundleContextServicesWithAsyncEventsTests&) = delete;
+};
+
+TEST_F(CelixBundleContextServicesWithAsyncEventsTests, asyncRegisteredEventTest) {
+    struct data {
+        std::atomic<int> addCount{0};
+        std::atomic<int> removeCount{0};
+    };
+    struct data data{};
+
+    celix_service_tracking_options_t opts{};
+    opts.filter.serviceName = "calc";
+    opts.callbackHandle = &data;
+    opts.add = [](void *handle, void *) {
+        static_cast<struct data*>(handle)->addCount.fetch_add(1);
+    };
+    opts.remove = [](void *handle, void *) {
+        static_cast<struct data*>(handle)->removeCount.fetch_add(1);
+    };
+    long trackerId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+    ASSERT_TRUE(trackerId >= 0);
+
+    long svcId1 = celix_bundleContext_registerService(ctx, (void*)0x42, "calc", nullptr);
+    long svcId2 = celix_bundleContext_registerService(ctx, (void*)0x43, "calc", nullptr);
+    celix_framework_waitForEmptyEventQueue(fw);
+    EXPECT_EQ(2, data.addCount.load());
+    EXPECT_EQ(2, celix_bundleContext_useTrackedServices(ctx, trackerId, nullptr, [](void *, void *){}));
+
+    //unregister directly after register: the REGISTERED event is always delivered before the UNREGISTERING event
+    long svcId3 = celix_bundleContext_registerService(ctx, (void*)0x44, "calc", nullptr);
+    celix_bundleContext_unregisterService(ctx, svcId3);
+    EXPECT_EQ(3, data.addCount.load());
+    EXPECT_EQ(1, data.removeCount.load());
+
+    //UNREGISTERING events are delivered synchronously
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    EXPECT_EQ(3, data.removeCount.load());
+    EXPECT_EQ(0, celix_bundleContext_useTrackedServices(ctx, trackerId, nullptr, [](void *, void *){}));
+
+    celix_bundleContext_stopTracker(ctx, trackerId);
+}
+
+TEST_F(CelixBundleContextServicesWithAsyncEventsTests, unregisterOnEventDispatcherThreadTest) {
+    struct data {
+        celix_bundle_context_t *ctx{nullptr};
+        std::atomic<int> addCount{0};
+        std::atomic<int> removeCount{0};
+    };
+    struct data data{};
+    data.ctx = ctx;
+
+    //tracker for the short lived services, must never end up with a stale (unregistered) service
+    celix_service_tracking_options_t opts{};
+    opts.filter.serviceName = "short_lived";
+    opts.callbackHandle = &data;
+    opts.add = [](void *handle, void *) {
+        static_cast<struct data*>(handle)->addCount.fetch_add(1);
+    };
+    opts.remove = [](void *handle, void *) {
+        static_cast<struct data*>(handle)->removeCount.fetch_add(1);
+    };
+    long trackerId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+    ASSERT_TRUE(trackerId >= 0);
+
+    //the add callback of this tracker is called on an event dispatcher thread and registers and directly
+    //unregisters a service
+    celix_service_tracking_options_t triggerOpts{};
+    triggerOpts.filter.serviceName = "trigger";
+    triggerOpts.callbackHandle = &data;
+    triggerOpts.add = [](void *handle, void *) {
+        auto *d = static_cast<struct data*>(handle);
+        for (int i = 0; i < 10; ++i) {
+            long svcId = celix_bundleContext_registerService(d->ctx, (void*)0x42, "short_lived", nullptr);
+            celix_bundleContext_unregisterService(d->ctx, svcId);
+        }
+    };
+    long triggerTrackerId = celix_bundleContext_trackServicesWithOptions(ctx, &triggerOpts);
+    ASSERT_TRUE(triggerTrackerId >= 0);
+
+    std::vector<long> triggerSvcIds{};
+    for (int i = 0; i < 20; ++i) {
+        triggerSvcIds.push_back(celix_bundleContext_registerService(ctx, (void*)0x43, "trigger", nullptr));
+    }
+    celix_framework_waitForEmptyEventQueue(fw);
+
+    EXPECT_EQ(data.addCount.load(), data.removeCount.load());
+    EXPECT_EQ(0, celix_bundleContext_useTrackedServices(ctx, trackerId, nullptr, [](void *, void *){}));
+
+    for (long svcId : triggerSvcIds) {
+        celix_bundleContext_unregisterService(ctx, svcId);
+    }
+    celix_bundleContext_stopTracker(ctx, triggerTrackerId);
+    celix_bundleContext_stopTracker(ctx, trackerId);
+}
+
+TEST_F(CelixBundleContextServicesWithAsyncEventsTests, registerServicesWithManyTrackers_Benchmark) {
+    registerServicesWithManyTrackersBenchmark(fw, ctx, "async");
+}
@@ -575,6 +575,108 @@ size_t celix_bundleContext_useServicesWithOptions(
         celix_bundle_context_t *ctx,
         const celix_service_use_options_t *opts);
 
+/**
+ * Use the highest ranking service tracked by the service tracker with the provided tracker id using the provided
+ * callback.
+ *
+ * In contrast with celix_bundleContext_useService, this function does not create and open a service tracker for
+ * every call. The service tracker, created once with celix_bundleContext_trackServices(WithOptions), is used as
+ * persistent use handle; as result using a service is a (read locked) lookup of the tracked services.
+ * The tracker callbacks (set, add, remove, etc) can be left NULL if the tracker is only used as use handle.
+ *
+ * The svc is should only be considered valid during the callback.
+ * If no service is found the callback will not be invoked.
+ *
+ * This function will block till the callback is finished. As result it is possible to provide callback data from the
+ * stack.
+ * Stopping the service tracker will wait for pending use calls, so the tracker should not be stopped in the callback.
+ *
+ * @param   ctx The bundle context
+ * @param   trackerId The id of the service tracker to use. Should be a service tracker owned by the bundle context.
+ * @param   callbackHandle The data pointer, which will be used in the callbacks
+ * @param   use The callback, which will be called when service is retrieved.
+ * @return  True if a service was found.
+ */
+bool celix_bundleContext_useTrackedService(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc)
+);
+
+/**
+ * Use the highest ranking service tracked by the service tracker with the provided tracker id using the callbacks
+ * and wait timeout of the provided use options. The filter part of the use options is ignored, the service tracker
+ * filter is used instead.
+ *
+ * @see celix_bundleContext_useTrackedService
+ *
+ * @param   ctx The bundle context
+ * @param   trackerId The id of the service tracker to use. Should be a service tracker owned by the bundle context.
+ * @param   opts The use options.
+ * @return  True if a service was found.
+ */
+bool celix_bundleContext_useTrackedServiceWithOptions(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        const celix_service_use_options_t *opts);
+
+/**
+ * Use all services tracked by the service tracker with the provided tracker id using the provided callback.
+ *
+ * @see celix_bundleContext_useTrackedService
+ *
+ * @param   ctx The bundle context
+ * @param   trackerId The id of the service tracker to use. Should be a service tracker owned by the bundle context.
+ * @param   callbackHandle The data pointer, which will be used in the callbacks
+ * @param   use The callback, which will be called for every tracked service.
+ * @return  The number of services called.
+ */
+size_t celix_bundleContext_useTrackedServices(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc)
+);
+
+/**
+ * Use all services tracked by the service tracker with the provided tracker id using the callbacks of the provided
+ * use options. The filter part and wait timeout of the use options are ignored.
+ *
+ * @see celix_bundleContext_useTrackedService
+ *
+ * @param   ctx The bundle context
+ * @param   trackerId The id of the service tracker to use. Should be a service tracker owned by the bundle context.
+ * @param   opts The use options.
+ * @return  The number of services called.
+ */
+size_t celix_bundleContext_useTrackedServicesWithOptions(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        const celix_service_use_options_t *opts);
+
+/**
+ * Use the maxNrOfServices highest ranking services tracked by the service tracker with the provided tracker id using
+ * the callbacks of the provided use options. The services are called in ranking order (highest ranking first, and
+ * for equal rankings lowest service id first).
+ * The filter part and wait timeout of the use options are ignored.
+ *
+ * The tracked services are kept sorted on ranking, so this does not scan all tracked services.
+ *
+ * @see celix_bundleContext_useTrackedService
+ *
+ * @param   ctx The bundle context
+ * @param   trackerId The id of the service tracker to use. Should be a service tracker owned by the bundle context.
+ * @param   maxNrOfServices The max number of services to call.
+ * @param   opts The use options.
+ * @return  The number of services called.
+ */
+size_t celix_bundleContext_useTopRankedTrackedServicesWithOptions(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        size_t maxNrOfServices,
+        const celix_service_use_options_t *opts);
+
 
 
 
@@ -85,6 +85,26 @@ static const char *const CELIX_LOAD_BUNDLES_WITH_NODELETE = "CELIX_LOAD_BUNDLES_
  */
 static const char *const CELIX_SYSTEM_BUNDLE_ARCHIVE_PATH = "CELIX_SYSTEM_BUNDLE_ARCHIVE_PATH";
 
+/**
+ * The number of threads used to dispatch framework and bundle events. Default is 1.
+ * Events for the same bundle (or the same service) are always handled in order by the same thread, events for
+ * different bundles or services can be handled concurrently. Note that this means that bundle listeners can be
+ * called concurrently.
+ */
+static const char *const CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE = "CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE";
+static const long        CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE_DEFAULT = 1;
+
+/**
+ * Whether service REGISTERED events are delivered asynchronously on the framework event dispatcher thread(s).
+ * Default is false.
+ * If enabled, registering a service does not wait until all service listeners (e.g. service trackers) are called.
+ * REGISTERED events for the same service id are always delivered in order and before the UNREGISTERING event
+ * of that service. UNREGISTERING events are always delivered synchronously, so that after unregistering a
+ * service it is no longer in use.
+ */
+static const char *const CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS = "CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS";
+static const bool        CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS_DEFAULT = false;
+
 
 #define CELIX_AUTO_START_0 "CELIX_AUTO_START_0"
 #define CELIX_AUTO_START_1 "CELIX_AUTO_START_1"
@@ -94,6 +114,14 @@ static const char *const CELIX_SYSTEM_BUNDLE_ARCHIVE_PATH = "CELIX_SYSTEM_BUNDLE
 #define CELIX_AUTO_START_5 "CELIX_AUTO_START_5"
 #define CELIX_AUTO_START_6 "CELIX_AUTO_START_6"
 
+/**
+ * The number of threads used to install and start the CELIX_AUTO_START_N bundles. Default is 1 (sequential).
+ * If larger than 1, the bundles of the same auto start level are installed (extracted) and started concurrently.
+ * The levels itself are still handled in order.
+ */
+#define CELIX_AUTO_START_POOL_SIZE "CELIX_AUTO_START_POOL_SIZE"
+#define CELIX_AUTO_START_POOL_SIZE_DEFAULT 1
+
 
 #ifdef __cplusplus
 }
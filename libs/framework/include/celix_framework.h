@@ -146,6 +146,32 @@ bool celix_framework_startBundle(celix_framework_t *fw, long bndId);
  */
 void celix_framework_waitForEmptyEventQueue(celix_framework_t *fw);
 
+/**
+ * Statistics of the framework event queue.
+ */
+typedef struct celix_framework_event_queue_stats {
+    size_t size; //nr of events queued or being handled
+    size_t maxSize; //max nr of events queued or being handled at the same time
+    size_t nrOfHandledEvents;
+    double averageLatency; //average time in seconds between firing and completely handling an event
+    double maxLatency; //max time in seconds between firing and completely handling an event
+} celix_framework_event_queue_stats_t;
+
+/**
+ * Returns the number of events queued or being handled by the framework event dispatcher(s).
+ *
+ * @param fw The Celix Framework
+ */
+size_t celix_framework_getEventQueueSize(celix_framework_t *fw);
+
+/**
+ * Gets the statistics of the framework event queue.
+ *
+ * @param fw The Celix Framework
+ * @param stats The stats output argument.
+ */
+void celix_framework_getEventQueueStats(celix_framework_t *fw, celix_framework_event_queue_stats_t *stats);
+
 /**
  * Sets the log function for this framework.
  * Default the celix framework will log to stdout/stderr.
@@ -123,6 +123,7 @@ bool celix_serviceTracker_useHighestRankingService(
 
 /**
  * Calls the use callback for every services found by this tracker.
+ * The services are called in ranking order (highest ranking first).
  * Returns the number of called services
  */
 size_t celix_serviceTracker_useServices(
@@ -134,6 +135,20 @@ size_t celix_serviceTracker_useServices(
         void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)
 );
 
+/**
+ * Calls the use callback for the maxNrOfServices highest ranking services found by this tracker.
+ * The services are called in ranking order (highest ranking first). For equal rankings the lowest service id is used first.
+ * Returns the number of called services
+ */
+size_t celix_serviceTracker_useTopRankedServices(
+        service_tracker_t *tracker,
+        size_t maxNrOfServices,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc),
+        void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
+        void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)
+);
+
 /**
  * blocks until all shutdown threads for the service tracker instances for the provided framework are done.
  */
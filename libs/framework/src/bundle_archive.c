@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "celix_utils_api.h"
+#include "celix_properties.h"
 #include "bundle_archive.h"
 #include "linked_list_iterator.h"
 
@@ -56,6 +57,34 @@ static celix_status_t bundleArchive_reviseInternal(bundle_archive_pt archive, bo
 static celix_status_t bundleArchive_readLastModified(bundle_archive_pt archive, time_t *time);
 static celix_status_t bundleArchive_writeLastModified(bundle_archive_pt archive);
 
+static celix_status_t bundleArchive_storeIndex(bundle_archive_pt archive);
+static void bundleArchive_loadIndex(bundle_archive_pt archive);
+
+static const char* bundleArchive_persistentStateToString(bundle_state_e state) {
+	switch (state) {
+	case OSGI_FRAMEWORK_BUNDLE_ACTIVE:
+		return "active";
+	case OSGI_FRAMEWORK_BUNDLE_STARTING:
+		return "starting";
+	case OSGI_FRAMEWORK_BUNDLE_UNINSTALLED:
+		return "uninstalled";
+	default:
+		return "installed";
+	}
+}
+
+static bundle_state_e bundleArchive_persistentStateFromString(const char *state) {
+	if (strncmp(state, "active", 256) == 0) {
+		return OSGI_FRAMEWORK_BUNDLE_ACTIVE;
+	} else if (strncmp(state, "starting", 256) == 0) {
+		return OSGI_FRAMEWORK_BUNDLE_STARTING;
+	} else if (strncmp(state, "uninstalled", 256) == 0) {
+		return OSGI_FRAMEWORK_BUNDLE_UNINSTALLED;
+	} else {
+		return OSGI_FRAMEWORK_BUNDLE_INSTALLED;
+	}
+}
+
 celix_status_t bundleArchive_createSystemBundleArchive(bundle_archive_pt *bundle_archive) {
 	celix_status_t status = CELIX_SUCCESS;
 	char *error = NULL;
@@ -186,6 +215,7 @@ celix_status_t bundleArchive_recreate(const char * archiveRoot, bundle_archive_p
 			archive->location = NULL;
 			archive->refreshCount = -1;
 			archive->lastModified = (time_t) NULL;
+			bundleArchive_loadIndex(archive);
 
 			archive->archiveRootDir = opendir(archiveRoot);
 			if (archive->archiveRootDir == NULL) {
@@ -345,16 +375,7 @@ celix_status_t bundleArchive_getPersistentState(bundle_archive_pt archive, bundl
 		}
 
 		if (status == CELIX_SUCCESS) {
-			if (strncmp(stateString, "active", 256) == 0) {
-				archive->persistentState = OSGI_FRAMEWORK_BUNDLE_ACTIVE;
-			} else if (strncmp(stateString, "starting", 256) == 0) {
-				archive->persistentState = OSGI_FRAMEWORK_BUNDLE_STARTING;
-			} else if (strncmp(stateString, "uninstalled", 256) == 0) {
-				archive->persistentState = OSGI_FRAMEWORK_BUNDLE_UNINSTALLED;
-			} else {
-				archive->persistentState = OSGI_FRAMEWORK_BUNDLE_INSTALLED;
-			}
-
+			archive->persistentState = bundleArchive_persistentStateFromString(stateString);
 			*state = archive->persistentState;
 		}
 	}
@@ -366,34 +387,12 @@ celix_status_t bundleArchive_getPersistentState(bundle_archive_pt archive, bundl
 
 celix_status_t bundleArchive_setPersistentState(bundle_archive_pt archive, bundle_state_e state) {
 	celix_status_t status = CELIX_SUCCESS;
-	char persistentStateLocation[512];
-	FILE *persistentStateLocationFile;
 
-	snprintf(persistentStateLocation, sizeof(persistentStateLocation), "%s/bundle.state", archive->archiveRoot);
-
-	persistentStateLocationFile = fopen(persistentStateLocation, "w");
-	if (persistentStateLocationFile == NULL) {
-		status = CELIX_FILE_IO_EXCEPTION;
-	} else {
-		char * s;
-		switch (state) {
-		case OSGI_FRAMEWORK_BUNDLE_ACTIVE:
-			s = "active";
-			break;
-		case OSGI_FRAMEWORK_BUNDLE_STARTING:
-			s = "starting";
-			break;
-		case OSGI_FRAMEWORK_BUNDLE_UNINSTALLED:
-			s = "uninstalled";
-			break;
-		default:
-			s = "installed";
-			break;
-		}
-		fprintf(persistentStateLocationFile, "%s", s);
-		if (fclose(persistentStateLocationFile) ==  0) {
-			archive->persistentState = state;
-		}
+	bundle_state_e oldState = archive->persistentState;
+	archive->persistentState = state;
+	status = bundleArchive_storeIndex(archive);
+	if (status != CELIX_SUCCESS) {
+		archive->persistentState = oldState;
 	}
 
 	framework_logIfError(celix_frameworkLogger_globalLogger(), status, NULL, "Could not set persistent state");
@@ -434,20 +433,7 @@ celix_status_t bundleArchive_getRefreshCount(bundle_archive_pt archive, long *re
 }
 
 celix_status_t bundleArchive_setRefreshCount(bundle_archive_pt archive) {
-	FILE *refreshCounterFile;
-	celix_status_t status = CELIX_SUCCESS;
-	char refreshCounter[512];
-
-	snprintf(refreshCounter, sizeof(refreshCounter), "%s/refresh.counter", archive->archiveRoot);
-
-	refreshCounterFile = fopen(refreshCounter, "w");
-	if (refreshCounterFile == NULL) {
-		status = CELIX_FILE_IO_EXCEPTION;
-	} else {
-		fprintf(refreshCounterFile, "%ld", archive->refreshCount);
-		if (fclose(refreshCounterFile) ==  0) {
-		}
-	}
+	celix_status_t status = bundleArchive_storeIndex(archive);
 
 	framework_logIfError(celix_frameworkLogger_globalLogger(), status, NULL, "Could not set refresh count");
 
@@ -521,26 +507,77 @@ static celix_status_t bundleArchive_readLastModified(bundle_archive_pt archive,
 }
 
 static celix_status_t bundleArchive_writeLastModified(bundle_archive_pt archive) {
-	celix_status_t status = CELIX_SUCCESS;
-	FILE *lastModifiedFile;
-	char lastModified[512];
+	celix_status_t status = bundleArchive_storeIndex(archive);
 
-	snprintf(lastModified, sizeof(lastModified), "%s/bundle.lastmodified", archive->archiveRoot);
-	lastModifiedFile = fopen(lastModified, "w");
-	if (lastModifiedFile == NULL) {
+	framework_logIfError(celix_frameworkLogger_globalLogger(), status, NULL, "Could not write last modified");
+
+	return status;
+}
+
+/**
+ * Stores the archive state (id, location, persistent state, refresh count and last modified) in a single
+ * bundle.index file, instead of a file per value. The separate files are still read if no index is present
+ * (bundle cache created by an older framework).
+ */
+static celix_status_t bundleArchive_storeIndex(bundle_archive_pt archive) {
+	celix_status_t status = CELIX_SUCCESS;
+	char indexFile[512];
+	char tmpIndexFile[512];
+	snprintf(indexFile, sizeof(indexFile), "%s/bundle.index", archive->archiveRoot);
+	snprintf(tmpIndexFile, sizeof(tmpIndexFile), "%s/bundle.index.tmp", archive->archiveRoot);
+
+	celix_properties_t *index = celix_properties_create();
+	if (archive->id >= 0) {
+		celix_properties_setLong(index, "bundle.id", archive->id);
+	}
+	if (archive->location != NULL) {
+		celix_properties_set(index, "bundle.location", archive->location);
+	}
+	if (archive->persistentState != OSGI_FRAMEWORK_BUNDLE_UNKNOWN && archive->persistentState != (bundle_state_e)-1) {
+		celix_properties_set(index, "bundle.state", bundleArchive_persistentStateToString(archive->persistentState));
+	}
+	if (archive->refreshCount >= 0) {
+		celix_properties_setLong(index, "refresh.counter", archive->refreshCount);
+	}
+	celix_properties_setLong(index, "bundle.lastmodified", (long)archive->lastModified);
+
+	//write to a tmp file and rename, so that an interrupted write cannot leave a corrupt index behind
+	status = celix_properties_store(index, tmpIndexFile, NULL);
+	if (status != CELIX_SUCCESS) {
+		fw_log(celix_frameworkLogger_globalLogger(), CELIX_LOG_LEVEL_ERROR, "Could not write bundle archive index %s", tmpIndexFile);
+		remove(tmpIndexFile);
+	} else if (rename(tmpIndexFile, indexFile) != 0) {
 		status = CELIX_FILE_IO_EXCEPTION;
-	} else {
-		char timeStr[20];
-		strftime(timeStr, 20, "%Y %m %d %H:%M:%S", localtime(&archive->lastModified));
-		fprintf(lastModifiedFile, "%s", timeStr);
-		fclose(lastModifiedFile);
 	}
+	celix_properties_destroy(index);
 
-	framework_logIfError(celix_frameworkLogger_globalLogger(), status, NULL, "Could not write last modified");
+	framework_logIfError(celix_frameworkLogger_globalLogger(), status, NULL, "Could not store bundle archive index");
 
 	return status;
 }
 
+static void bundleArchive_loadIndex(bundle_archive_pt archive) {
+	char indexFile[512];
+	snprintf(indexFile, sizeof(indexFile), "%s/bundle.index", archive->archiveRoot);
+
+	celix_properties_t *index = celix_properties_load(indexFile);
+	if (index != NULL) {
+		archive->id = celix_properties_getAsLong(index, "bundle.id", archive->id);
+		const char *location = celix_properties_get(index, "bundle.location", NULL);
+		if (location != NULL) {
+			free(archive->location);
+			archive->location = strdup(location);
+		}
+		const char *state = celix_properties_get(index, "bundle.state", NULL);
+		if (state != NULL) {
+			archive->persistentState = bundleArchive_persistentStateFromString(state);
+		}
+		archive->refreshCount = celix_properties_getAsLong(index, "refresh.counter", archive->refreshCount);
+		archive->lastModified = (time_t)celix_properties_getAsLong(index, "bundle.lastmodified", (long)archive->lastModified);
+		celix_properties_destroy(index);
+	}
+}
+
 celix_status_t bundleArchive_revise(bundle_archive_pt archive, const char * location, const char *inputFile) {
 	celix_status_t status = CELIX_SUCCESS;
 	long revNr = 0l;
@@ -699,35 +736,7 @@ static celix_status_t bundleArchive_initialize(bundle_archive_pt archive) {
 			if (archive->archiveRootDir == NULL) {
 				status = CELIX_FILE_IO_EXCEPTION;
 			} else {
-				FILE *bundleIdFile;
-				char bundleId[512];
-
-				snprintf(bundleId, sizeof(bundleId), "%s/bundle.id", archive->archiveRoot);
-				bundleIdFile = fopen(bundleId, "w");
-
-				if (bundleIdFile == NULL) {
-					status = CELIX_FILE_IO_EXCEPTION;
-				} else {
-					FILE *bundleLocationFile;
-					char bundleLocation[512];
-
-					fprintf(bundleIdFile, "%ld", archive->id);
-					// Ignore close status, let it fail if needed again
-					fclose(bundleIdFile);
-
-					snprintf(bundleLocation, sizeof(bundleLocation), "%s/bundle.location", archive->archiveRoot);
-					bundleLocationFile = fopen(bundleLocation, "w");
-
-					if (bundleLocationFile == NULL) {
-						status = CELIX_FILE_IO_EXCEPTION;
-					} else {
-						fprintf(bundleLocationFile, "%s", archive->location);
-						// Ignore close status, let it fail if needed again
-						fclose(bundleLocationFile);
-
-						status = bundleArchive_writeLastModified(archive);
-					}
-				}
+				status = bundleArchive_storeIndex(archive);
 				closedir(archive->archiveRootDir);
 			}
 		}
@@ -30,6 +30,7 @@
 #include "celix_bundle.h"
 #include "celix_log.h"
 #include "service_tracker.h"
+#include "service_tracker_private.h"
 #include "celix_dependency_manager.h"
 #include "dm_dependency_manager_impl.h"
 #include "celix_array_list.h"
@@ -60,6 +61,7 @@ celix_status_t bundleContext_create(framework_pt framework, celix_framework_logg
             arrayList_create(&context->svcRegistrations);
             context->bundleTrackers = hashMap_create(NULL,NULL,NULL,NULL);
             context->serviceTrackers = hashMap_create(NULL,NULL,NULL,NULL);
+            celixThreadCondition_init(&context->serviceTrackerUseCond, NULL);
             context->metaTrackers =  hashMap_create(NULL,NULL,NULL,NULL);
             context->nextTrackerId = 1L;
 
@@ -88,6 +90,7 @@ celix_status_t bundleContext_destroy(bundle_context_pt context) {
 	    //service registry (serviceRegistry_clearServiceRegistrations).
         celixThreadMutex_unlock(&context->mutex);
 	    celixThreadMutex_destroy(&context->mutex); 
+	    celixThreadCondition_destroy(&context->serviceTrackerUseCond);
 	    arrayList_destroy(context->svcRegistrations);
 
 	    if (context->mng != NULL) {
@@ -649,6 +652,11 @@ void celix_bundleContext_stopTracker(bundle_context_t *ctx, long trackerId) {
         } else if (hashMap_containsKey(ctx->serviceTrackers, (void*)trackerId)) {
             found = true;
             serviceTracker = hashMap_remove(ctx->serviceTrackers, (void*)trackerId);
+            //wait for pending useTrackedService(s) calls
+            __atomic_store_n(&serviceTracker->stopping, true, __ATOMIC_SEQ_CST);
+            while (__atomic_load_n(&serviceTracker->useCount, __ATOMIC_SEQ_CST) > 0) {
+                celixThreadCondition_wait(&ctx->serviceTrackerUseCond, &ctx->mutex);
+            }
         } else if (hashMap_containsKey(ctx->metaTrackers, (void*)trackerId)) {
             found = true;
             svcTrackerTracker = hashMap_remove(ctx->metaTrackers, (void*)trackerId);
@@ -874,6 +882,94 @@ long celix_bundleContext_findServiceWithOptions(celix_bundle_context_t *ctx, con
 }
 
 
+/**
+ * Looks up the service tracker and increases its use count. Note that the context mutex is only used for the lookup,
+ * the use count is atomic and stopTracker waits till the use count is 0.
+ */
+static celix_service_tracker_t* bundleContext_retainServiceTracker(celix_bundle_context_t *ctx, long trackerId) {
+    celixThreadMutex_lock(&ctx->mutex);
+    celix_service_tracker_t *tracker = hashMap_get(ctx->serviceTrackers, (void*)trackerId);
+    if (tracker != NULL) {
+        __atomic_add_fetch(&tracker->useCount, 1, __ATOMIC_SEQ_CST);
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+    if (tracker == NULL) {
+        framework_logIfError(ctx->framework->logger, CELIX_ILLEGAL_ARGUMENT, NULL, "No service tracker with id %li found", trackerId);
+    }
+    return tracker;
+}
+
+static void bundleContext_releaseServiceTracker(celix_bundle_context_t *ctx, celix_service_tracker_t *tracker) {
+    size_t count = __atomic_sub_fetch(&tracker->useCount, 1, __ATOMIC_SEQ_CST);
+    if (count == 0 && __atomic_load_n(&tracker->stopping, __ATOMIC_SEQ_CST)) {
+        celixThreadMutex_lock(&ctx->mutex);
+        celixThreadCondition_broadcast(&ctx->serviceTrackerUseCond);
+        celixThreadMutex_unlock(&ctx->mutex);
+    }
+}
+
+bool celix_bundleContext_useTrackedService(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc)) {
+    celix_service_use_options_t opts = CELIX_EMPTY_SERVICE_USE_OPTIONS;
+    opts.callbackHandle = callbackHandle;
+    opts.use = use;
+    return celix_bundleContext_useTrackedServiceWithOptions(ctx, trackerId, &opts);
+}
+
+bool celix_bundleContext_useTrackedServiceWithOptions(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        const celix_service_use_options_t *opts) {
+    bool called = false;
+    celix_service_tracker_t *tracker = ctx != NULL && opts != NULL ? bundleContext_retainServiceTracker(ctx, trackerId) : NULL;
+    if (tracker != NULL) {
+        called = celix_serviceTracker_useHighestRankingService(tracker, NULL, opts->waitTimeoutInSeconds, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
+        bundleContext_releaseServiceTracker(ctx, tracker);
+    }
+    return called;
+}
+
+size_t celix_bundleContext_useTrackedServices(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc)) {
+    celix_service_use_options_t opts = CELIX_EMPTY_SERVICE_USE_OPTIONS;
+    opts.callbackHandle = callbackHandle;
+    opts.use = use;
+    return celix_bundleContext_useTrackedServicesWithOptions(ctx, trackerId, &opts);
+}
+
+size_t celix_bundleContext_useTrackedServicesWithOptions(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        const celix_service_use_options_t *opts) {
+    size_t count = 0;
+    celix_service_tracker_t *tracker = ctx != NULL && opts != NULL ? bundleContext_retainServiceTracker(ctx, trackerId) : NULL;
+    if (tracker != NULL) {
+        count = celix_serviceTracker_useServices(tracker, NULL, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
+        bundleContext_releaseServiceTracker(ctx, tracker);
+    }
+    return count;
+}
+
+size_t celix_bundleContext_useTopRankedTrackedServicesWithOptions(
+        celix_bundle_context_t *ctx,
+        long trackerId,
+        size_t maxNrOfServices,
+        const celix_service_use_options_t *opts) {
+    size_t count = 0;
+    celix_service_tracker_t *tracker = ctx != NULL && opts != NULL ? bundleContext_retainServiceTracker(ctx, trackerId) : NULL;
+    if (tracker != NULL) {
+        count = celix_serviceTracker_useTopRankedServices(tracker, maxNrOfServices, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
+        bundleContext_releaseServiceTracker(ctx, tracker);
+    }
+    return count;
+}
+
 celix_array_list_t* celix_bundleContext_findServices(celix_bundle_context_t *ctx, const char *serviceName) {
     celix_service_filter_options_t opts = CELIX_EMPTY_SERVICE_FILTER_OPTIONS;
     opts.serviceName = serviceName;
@@ -55,6 +55,7 @@ struct celix_bundle_context {
 	long nextTrackerId;
 	hash_map_t *bundleTrackers; //key = trackerId, value = celix_bundle_context_bundle_tracker_entry_t*
 	hash_map_t *serviceTrackers; //key = trackerId, value = celix_service_tracker_t*
+	celix_thread_cond_t serviceTrackerUseCond; //signaled when the last useTrackedService(s) call of a stopping tracker is done
 	hash_map_t *metaTrackers; //key = trackerId, value = celix_bundle_context_service_tracker_tracker_entry_t*
 };
 
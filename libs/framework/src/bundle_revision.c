@@ -22,10 +22,91 @@
 #include <sys/stat.h>
 #include <archive.h>
 #include <string.h>
+#include <stdint.h>
 #include <sys/stat.h>
 
 
 #include "bundle_revision_private.h"
+#include "celix_properties.h"
+
+static uint64_t bundleRevision_hashFile(const char *file) {
+    uint64_t hash = 14695981039346656037ULL; //FNV-1a 64 bit
+    FILE *f = fopen(file, "r");
+    if (f != NULL) {
+        unsigned char buf[64 * 1024];
+        size_t read;
+        while ((read = fread(buf, 1, sizeof(buf), f)) > 0) {
+            for (size_t i = 0; i < read; ++i) {
+                hash ^= buf[i];
+                hash *= 1099511628211ULL;
+            }
+        }
+        fclose(f);
+    }
+    return hash;
+}
+
+/**
+ * Returns whether the revision root already contains an extraction of the bundle zip, i.e. the revision.index
+ * of the revision root matches the bundle zip. The bundle zip is considered unchanged if the size and modification
+ * time are unchanged, or - if only the modification time is changed - the content hash is unchanged.
+ */
+static bool bundleRevision_isExtracted(const char *root, const char *bundleZip) {
+    bool extracted = false;
+    char indexFile[512];
+    snprintf(indexFile, sizeof(indexFile), "%s/revision.index", root);
+
+    struct stat st;
+    celix_properties_t *index = celix_properties_load(indexFile);
+    if (index != NULL && stat(bundleZip, &st) == 0) {
+        const char *source = celix_properties_get(index, "source", "");
+        extracted = strcmp(source, bundleZip) == 0 && celix_properties_getAsLong(index, "source.size", -1) == (long)st.st_size;
+        if (extracted && celix_properties_getAsLong(index, "source.mtime", -1) != (long)st.st_mtime) {
+            extracted = celix_properties_getAsLong(index, "source.hash", 0) == (long)bundleRevision_hashFile(bundleZip);
+            if (extracted) {
+                //only the modification time is changed, update the index so that the bundle zip is not hashed again
+                celix_properties_setLong(index, "source.mtime", (long)st.st_mtime);
+                if (celix_properties_store(index, indexFile, NULL) != CELIX_SUCCESS) {
+                    fw_log(celix_frameworkLogger_globalLogger(), CELIX_LOG_LEVEL_WARNING, "Could not update revision index %s", indexFile);
+                }
+            }
+        }
+    }
+    if (index != NULL) {
+        celix_properties_destroy(index);
+    }
+    return extracted;
+}
+
+static void bundleRevision_storeIndex(const char *root, const char *bundleZip) {
+    struct stat st;
+    if (stat(bundleZip, &st) == 0) {
+        char indexFile[512];
+        snprintf(indexFile, sizeof(indexFile), "%s/revision.index", root);
+        celix_properties_t *index = celix_properties_create();
+        celix_properties_set(index, "source", bundleZip);
+        celix_properties_setLong(index, "source.size", (long)st.st_size);
+        celix_properties_setLong(index, "source.mtime", (long)st.st_mtime);
+        celix_properties_setLong(index, "source.hash", (long)bundleRevision_hashFile(bundleZip));
+        if (celix_properties_store(index, indexFile, NULL) != CELIX_SUCCESS) {
+            fw_log(celix_frameworkLogger_globalLogger(), CELIX_LOG_LEVEL_WARNING, "Could not store revision index %s", indexFile);
+        }
+        celix_properties_destroy(index);
+    }
+}
+
+static celix_status_t bundleRevision_extract(const char *bundleZip, const char *root) {
+    celix_status_t status = CELIX_SUCCESS;
+    if (bundleRevision_isExtracted(root, bundleZip)) {
+        fw_log(celix_frameworkLogger_globalLogger(), CELIX_LOG_LEVEL_DEBUG, "Bundle %s already extracted in %s, skipping extraction", bundleZip, root);
+    } else {
+        status = extractBundle(bundleZip, root);
+        if (status == CELIX_SUCCESS) {
+            bundleRevision_storeIndex(root, bundleZip);
+        }
+    }
+    return status;
+}
 
 celix_status_t bundleRevision_create(const char *root, const char *location, long revisionNr, const char *inputFile, bundle_revision_pt *bundle_revision) {
     celix_status_t status = CELIX_SUCCESS;
@@ -41,10 +122,10 @@ celix_status_t bundleRevision_create(const char *root, const char *location, lon
             status = CELIX_FILE_IO_EXCEPTION;
         } else {
             if (inputFile != NULL) {
-                status = extractBundle(inputFile, root);
+                status = bundleRevision_extract(inputFile, root);
             } else if (strcmp(location, "inputstream:") != 0) {
             	// If location != inputstream, extract it, else ignore it and assume this is a cache entry.
-                status = extractBundle(location, root);
+                status = bundleRevision_extract(location, root);
             }
 
             status = CELIX_DO_IF(status, arrayList_create(&(revision->libraryHandles)));
@@ -18,8 +18,10 @@
  */
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include "celixbool.h"
 #include <uuid/uuid.h>
@@ -40,6 +42,7 @@
 #include "service_tracker.h"
 #include "celix_library_loader.h"
 #include "celix_log_constants.h"
+#include "celix_utils.h"
 
 typedef celix_status_t (*create_function_fp)(bundle_context_t *context, void **userData);
 typedef celix_status_t (*start_function_fp)(void *userData, bundle_context_t *context);
@@ -161,7 +164,7 @@ celix_status_t fw_populateDependentGraph(framework_pt framework, bundle_pt expor
 
 celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e, celix_framework_bundle_entry_t* entry);
 celix_status_t fw_fireFrameworkEvent(framework_pt framework, framework_event_type_e eventType, celix_status_t errorCode);
-static void *fw_eventDispatcher(void *fw);
+static void *fw_eventDispatcher(void *data);
 
 celix_status_t fw_invokeBundleListener(framework_pt framework, bundle_listener_pt listener, bundle_event_pt event, bundle_pt bundle);
 celix_status_t fw_invokeFrameworkListener(framework_pt framework, framework_listener_pt listener, framework_event_pt event, bundle_pt bundle);
@@ -175,8 +178,8 @@ static celix_status_t frameworkActivator_stop(void * userData, bundle_context_t
 static celix_status_t frameworkActivator_destroy(void * userData, bundle_context_t *context);
 
 static void framework_autoStartConfiguredBundles(bundle_context_t *fwCtx);
-static void framework_autoInstallConfiguredBundlesForList(bundle_context_t *fwCtx, const char *autoStart, celix_array_list_t *installedBundles);
-static void framework_autoStartConfiguredBundlesForList(bundle_context_t *fwCtx, const celix_array_list_t *installedBundles);
+static void framework_autoStartAddConfiguredBundles(const char *autoStart, int level, celix_array_list_t *autoStartBundles);
+static void framework_autoStartHandleLevel(bundle_context_t *fwCtx, celix_array_list_t *autoStartBundles, int level, bool install, size_t poolSize);
 
 struct fw_refreshHelper {
     framework_pt framework;
@@ -255,6 +258,9 @@ struct request {
 
 	char *filter;
 	celix_framework_bundle_entry_t* bndEntry;
+	void *eventData;
+	void (*processEvent)(void *data);
+	struct timespec fireTime;
 };
 
 typedef struct request request_t;
@@ -271,26 +277,51 @@ celix_status_t framework_create(framework_pt *framework, properties_pt config) {
 
         status = CELIX_DO_IF(status, celixThreadCondition_init(&(*framework)->shutdown.cond, NULL));
         status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->shutdown.mutex, NULL));
-        status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->dispatcher.mutex, NULL));
         status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->frameworkListenersLock, &attr));
         status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->bundleListenerLock, NULL));
         status = CELIX_DO_IF(status, celixThreadMutex_create(&(*framework)->installedBundles.mutex, NULL));
-        status = CELIX_DO_IF(status, celixThreadCondition_init(&(*framework)->dispatcher.cond, NULL));
         if (status == CELIX_SUCCESS) {
             (*framework)->bundle = NULL;
             (*framework)->registry = NULL;
             (*framework)->shutdown.done = false;
             (*framework)->shutdown.initialized = false;
-            (*framework)->dispatcher.active = true;
             (*framework)->nextBundleId = 1L; //system bundle is 0
+            celixThreadMutex_create(&(*framework)->moduleLock, NULL);
             (*framework)->cache = NULL;
             (*framework)->installRequestMap = hashMap_create(utils_stringHash, utils_stringHash, utils_stringEquals, utils_stringEquals);
             (*framework)->installedBundles.entries = celix_arrayList_create();
             (*framework)->bundleListeners = NULL;
             (*framework)->frameworkListeners = NULL;
-            (*framework)->dispatcher.requests = NULL;
-            (*framework)->dispatcher.nrOfLocalRequest = 0;
             (*framework)->configurationMap = config;
+            (*framework)->dispatcher.size = 0;
+            (*framework)->dispatcher.maxSize = 0;
+
+            long poolSize = celix_properties_getAsLong(config, CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE, CELIX_FRAMEWORK_EVENT_DISPATCHER_POOL_SIZE_DEFAULT);
+            size_t nrOfQueues = poolSize < 1 ? 1 : (size_t)poolSize;
+            (*framework)->dispatcher.nrOfQueues = 0; //nr of initialized queues
+            (*framework)->dispatcher.queues = calloc(nrOfQueues, sizeof(*(*framework)->dispatcher.queues));
+            if ((*framework)->dispatcher.queues == NULL) {
+                status = CELIX_ENOMEM;
+            }
+            for (size_t i = 0; status == CELIX_SUCCESS && i < nrOfQueues; ++i) {
+                celix_framework_event_queue_t *queue = &(*framework)->dispatcher.queues[i];
+                queue->fw = *framework;
+                queue->active = true;
+                queue->capacity = CELIX_FRAMEWORK_EVENT_QUEUE_INITIAL_CAPACITY;
+                queue->requests = calloc(queue->capacity, sizeof(*queue->requests));
+                if (queue->requests == NULL) {
+                    status = CELIX_ENOMEM;
+                    break;
+                }
+                status = CELIX_DO_IF(status, celixThreadMutex_create(&queue->mutex, NULL));
+                status = CELIX_DO_IF(status, celixThreadCondition_init(&queue->cond, NULL));
+                status = CELIX_DO_IF(status, celixThreadCondition_init(&queue->emptyCond, NULL));
+                if (status == CELIX_SUCCESS) {
+                    (*framework)->dispatcher.nrOfQueues += 1;
+                } else {
+                    free(queue->requests);
+                }
+            }
 
             const char* logStr = getenv(CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL_CONFIG_NAME);
             if (logStr == NULL) {
@@ -340,10 +371,8 @@ celix_status_t framework_destroy(framework_pt framework) {
         if (count > 0) {
             const char *bndName = celix_bundle_getSymbolicName(bnd);
             fw_log(framework->logger, CELIX_LOG_LEVEL_FATAL, "Cannot destroy framework. The use count of bundle %s (bnd id %li) is not 0, but %u.", bndName, entry->bndId, count);
-            celixThreadMutex_lock(&framework->dispatcher.mutex);
-            int nrOfRequests = celix_arrayList_size(framework->dispatcher.requests);
-            celixThreadMutex_unlock(&framework->dispatcher.mutex);
-            fw_log(framework->logger, CELIX_LOG_LEVEL_WARNING, "nr of request left: %i (should be 0).", nrOfRequests);
+            size_t nrOfRequests = celix_framework_getEventQueueSize(framework);
+            fw_log(framework->logger, CELIX_LOG_LEVEL_WARNING, "nr of request left: %zu (should be 0).", nrOfRequests);
         }
         fw_bundleEntry_destroy(entry, true);
 
@@ -387,15 +416,21 @@ celix_status_t framework_destroy(framework_pt framework) {
         arrayList_destroy(framework->frameworkListeners);
     }
 
-    assert(celix_arrayList_size(framework->dispatcher.requests) == 0);
-    celix_arrayList_destroy(framework->dispatcher.requests);
+    assert(framework->dispatcher.size == 0);
+    for (size_t i = 0; i < framework->dispatcher.nrOfQueues; ++i) {
+        celix_framework_event_queue_t *queue = &framework->dispatcher.queues[i];
+        celixThreadCondition_destroy(&queue->emptyCond);
+        celixThreadCondition_destroy(&queue->cond);
+        celixThreadMutex_destroy(&queue->mutex);
+        free(queue->requests);
+    }
+    free(framework->dispatcher.queues);
 
 	bundleCache_destroy(&framework->cache);
 
-	celixThreadCondition_destroy(&framework->dispatcher.cond);
     celixThreadMutex_destroy(&framework->frameworkListenersLock);
 	celixThreadMutex_destroy(&framework->bundleListenerLock);
-	celixThreadMutex_destroy(&framework->dispatcher.mutex);
+	celixThreadMutex_destroy(&framework->moduleLock);
 	celixThreadMutex_destroy(&framework->shutdown.mutex);
 	celixThreadCondition_destroy(&framework->shutdown.cond);
 
@@ -428,8 +463,9 @@ celix_status_t fw_init(framework_pt framework) {
 	celix_status_t status = CELIX_SUCCESS;
 	status = CELIX_DO_IF(status, arrayList_create(&framework->bundleListeners));
 	status = CELIX_DO_IF(status, arrayList_create(&framework->frameworkListeners));
-	status = CELIX_DO_IF(status, arrayList_create(&framework->dispatcher.requests));
-	status = CELIX_DO_IF(status, celixThread_create(&framework->dispatcher.thread, NULL, fw_eventDispatcher, framework));
+	for (size_t i = 0; i < framework->dispatcher.nrOfQueues; ++i) {
+	    status = CELIX_DO_IF(status, celixThread_create(&framework->dispatcher.queues[i].thread, NULL, fw_eventDispatcher, &framework->dispatcher.queues[i]));
+	}
 	status = CELIX_DO_IF(status, bundle_getState(framework->bundle, &state));
 	if (status == CELIX_SUCCESS) {
 	    if ((state == OSGI_FRAMEWORK_BUNDLE_INSTALLED) || (state == OSGI_FRAMEWORK_BUNDLE_RESOLVED)) {
@@ -585,10 +621,32 @@ celix_status_t framework_start(framework_pt framework) {
 	return status;
 }
 
+/**
+ * A bundle configured in one of the CELIX_AUTO_START_N properties.
+ */
+typedef struct celix_framework_auto_start_bundle {
+    char *location;
+    int level;
+    bundle_t *bnd; //NULL if not (yet) installed
+    double installTime; //in seconds
+    double startTime; //in seconds
+} celix_framework_auto_start_bundle_t;
+
+/**
+ * Installs or starts a set of auto start bundles, shared by the auto start threads.
+ */
+typedef struct celix_framework_auto_start_job {
+    bundle_context_t *fwCtx;
+    bool install; //if true install the bundles, else start the bundles
+    celix_framework_auto_start_bundle_t **bundles;
+    size_t nrOfBundles;
+    size_t next; //index of the next bundle to handle, atomically increased
+} celix_framework_auto_start_job_t;
+
 static void framework_autoStartConfiguredBundles(bundle_context_t *fwCtx) {
     const char* cosgiKeys[] = {"cosgi.auto.start.0","cosgi.auto.start.1","cosgi.auto.start.2","cosgi.auto.start.3","cosgi.auto.start.4","cosgi.auto.start.5","cosgi.auto.start.6"};
     const char* celixKeys[] = {CELIX_AUTO_START_0, CELIX_AUTO_START_1, CELIX_AUTO_START_2, CELIX_AUTO_START_3, CELIX_AUTO_START_4, CELIX_AUTO_START_5, CELIX_AUTO_START_6};
-    celix_array_list_t *installedBundles = celix_arrayList_create();
+    celix_array_list_t *autoStartBundles = celix_arrayList_create();
     size_t len = 7;
     for (int i = 0; i < len; ++i) {
         const char *autoStart = celix_bundleContext_getProperty(fwCtx, celixKeys[i], NULL);
@@ -596,15 +654,45 @@ static void framework_autoStartConfiguredBundles(bundle_context_t *fwCtx) {
             autoStart = celix_bundleContext_getProperty(fwCtx, cosgiKeys[i], NULL);
         }
         if (autoStart != NULL) {
-            framework_autoInstallConfiguredBundlesForList(fwCtx, autoStart, installedBundles);
+            framework_autoStartAddConfiguredBundles(autoStart, i, autoStartBundles);
         }
     }
-    framework_autoStartConfiguredBundlesForList(fwCtx, installedBundles);
-    celix_arrayList_destroy(installedBundles);
-}
 
+    long poolSize = celix_bundleContext_getPropertyAsLong(fwCtx, CELIX_AUTO_START_POOL_SIZE, CELIX_AUTO_START_POOL_SIZE_DEFAULT);
+    if (poolSize < 1) {
+        poolSize = 1;
+    }
 
-static void framework_autoInstallConfiguredBundlesForList(bundle_context_t *fwCtx, const char *autoStartIn, celix_array_list_t *installedBundles) {
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    //first install all bundles and then start all bundles, level by level
+    for (int i = 0; i < len; ++i) {
+        framework_autoStartHandleLevel(fwCtx, autoStartBundles, i, true, (size_t)poolSize);
+    }
+    for (int i = 0; i < len; ++i) {
+        framework_autoStartHandleLevel(fwCtx, autoStartBundles, i, false, (size_t)poolSize);
+    }
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    celix_framework_t *fw = celix_bundleContext_getFramework(fwCtx);
+    for (int i = 0; i < celix_arrayList_size(autoStartBundles); ++i) {
+        celix_framework_auto_start_bundle_t *entry = celix_arrayList_get(autoStartBundles, i);
+        if (entry->bnd != NULL) {
+            fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG, "Auto start bundle %s (level %i): installed in %.3f ms, started in %.3f ms",
+                   celix_bundle_getSymbolicName(entry->bnd), entry->level, entry->installTime * 1000.0, entry->startTime * 1000.0);
+        }
+        free(entry->location);
+        free(entry);
+    }
+    if (celix_arrayList_size(autoStartBundles) > 0) {
+        fw_log(fw->logger, CELIX_LOG_LEVEL_INFO, "Installed and started %i auto start bundles in %.3f ms (pool size %li)",
+               celix_arrayList_size(autoStartBundles), celix_difftime(&begin, &end) * 1000.0, poolSize);
+    }
+    celix_arrayList_destroy(autoStartBundles);
+}
+
+static void framework_autoStartAddConfiguredBundles(const char *autoStartIn, int level, celix_array_list_t *autoStartBundles) {
     char delims[] = " ";
     char *save_ptr = NULL;
     char *autoStart = celix_utils_strdup(autoStartIn);
@@ -612,13 +700,19 @@ static void framework_autoInstallConfiguredBundlesForList(bundle_context_t *fwCt
     if (autoStart != NULL) {
         char *location = strtok_r(autoStart, delims, &save_ptr);
         while (location != NULL) {
-            //first install
-            bundle_t *bnd = NULL;
-            celix_status_t  rc = bundleContext_installBundle(fwCtx, location, &bnd);
-            if (rc == CELIX_SUCCESS) {
-                celix_arrayList_add(installedBundles, bnd);
-            } else {
-                printf("Could not install bundle '%s'\n", location);
+            bool alreadyAdded = false;
+            for (int i = 0; i < celix_arrayList_size(autoStartBundles); ++i) {
+                celix_framework_auto_start_bundle_t *entry = celix_arrayList_get(autoStartBundles, i);
+                if (strcmp(entry->location, location) == 0) {
+                    alreadyAdded = true;
+                    break;
+                }
+            }
+            if (!alreadyAdded) {
+                celix_framework_auto_start_bundle_t *entry = calloc(1, sizeof(*entry));
+                entry->location = celix_utils_strdup(location);
+                entry->level = level;
+                celix_arrayList_add(autoStartBundles, entry);
             }
             location = strtok_r(NULL, delims, &save_ptr);
         }
@@ -626,16 +720,73 @@ static void framework_autoInstallConfiguredBundlesForList(bundle_context_t *fwCt
     free(autoStart);
 }
 
-static void framework_autoStartConfiguredBundlesForList(bundle_context_t *fwCtx, const celix_array_list_t *installedBundles) {
-    for (int i = 0; i < celix_arrayList_size(installedBundles); ++i) {
-        long bndId = -1;
-        bundle_t *bnd = celix_arrayList_get(installedBundles, i);
-        bundle_getBundleId(bnd, &bndId);
-        celix_status_t rc = bundle_startWithOptions(bnd, 0);
+static void framework_autoStartHandleBundle(bundle_context_t *fwCtx, celix_framework_auto_start_bundle_t *entry, bool install) {
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    if (install) {
+        bundle_t *bnd = NULL;
+        celix_status_t rc = bundleContext_installBundle(fwCtx, entry->location, &bnd);
+        if (rc == CELIX_SUCCESS) {
+            entry->bnd = bnd;
+        } else {
+            printf("Could not install bundle '%s'\n", entry->location);
+        }
+    } else if (entry->bnd != NULL) {
+        celix_status_t rc = bundle_startWithOptions(entry->bnd, 0);
         if (rc != CELIX_SUCCESS) {
-            printf("Could not start bundle %li\n", bndId);
+            printf("Could not start bundle %li\n", celix_bundle_getId(entry->bnd));
+        }
+    }
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (install) {
+        entry->installTime = celix_difftime(&begin, &end);
+    } else {
+        entry->startTime = celix_difftime(&begin, &end);
+    }
+}
+
+static void* framework_autoStartThread(void *data) {
+    celix_framework_auto_start_job_t *job = data;
+    size_t index = __atomic_fetch_add(&job->next, 1, __ATOMIC_SEQ_CST);
+    while (index < job->nrOfBundles) {
+        framework_autoStartHandleBundle(job->fwCtx, job->bundles[index], job->install);
+        index = __atomic_fetch_add(&job->next, 1, __ATOMIC_SEQ_CST);
+    }
+    return NULL;
+}
+
+/**
+ * Installs or starts the auto start bundles for the provided level.
+ * If the pool size is larger than 1, the bundles are handled concurrently by max pool size threads (incl. the
+ * calling thread).
+ */
+static void framework_autoStartHandleLevel(bundle_context_t *fwCtx, celix_array_list_t *autoStartBundles, int level, bool install, size_t poolSize) {
+    celix_framework_auto_start_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.fwCtx = fwCtx;
+    job.install = install;
+    job.bundles = calloc(celix_arrayList_size(autoStartBundles) + 1, sizeof(*job.bundles));
+    for (int i = 0; i < celix_arrayList_size(autoStartBundles); ++i) {
+        celix_framework_auto_start_bundle_t *entry = celix_arrayList_get(autoStartBundles, i);
+        if (entry->level == level) {
+            job.bundles[job.nrOfBundles++] = entry;
+        }
+    }
+
+    size_t nrOfThreads = poolSize < job.nrOfBundles ? poolSize : job.nrOfBundles;
+    celix_thread_t threads[nrOfThreads > 1 ? nrOfThreads - 1 : 1];
+    size_t nrOfStartedThreads = 0;
+    for (size_t i = 1; i < nrOfThreads; ++i) {
+        if (celixThread_create(&threads[nrOfStartedThreads], NULL, framework_autoStartThread, &job) == CELIX_SUCCESS) {
+            nrOfStartedThreads += 1;
         }
     }
+    framework_autoStartThread(&job);
+    for (size_t i = 0; i < nrOfStartedThreads; ++i) {
+        celixThread_join(threads[i], NULL);
+    }
+    free(job.bundles);
 }
 
 celix_status_t framework_stop(framework_pt framework) {
@@ -752,18 +903,22 @@ celix_status_t fw_installBundle2(framework_pt framework, bundle_pt * bundle, lon
             // multiple revisions not yet implemented
         }
 
+        celixThreadMutex_lock(&framework->moduleLock);
         if (status == CELIX_SUCCESS) {
             status = bundle_createFromArchive(bundle, framework, archive);
         }
 
+        celix_framework_bundle_entry_t *bEntry = NULL;
         if (status == CELIX_SUCCESS) {
-            long bndId = -1L;
-            bundle_getBundleId(*bundle, &bndId);
-            celix_framework_bundle_entry_t *bEntry = fw_bundleEntry_create(*bundle);
+            bEntry = fw_bundleEntry_create(*bundle);
             fw_bundleEntry_increaseUseCount(bEntry);
             celixThreadMutex_lock(&framework->installedBundles.mutex);
             celix_arrayList_add(framework->installedBundles.entries, bEntry);
             celixThreadMutex_unlock(&framework->installedBundles.mutex);
+        }
+        celixThreadMutex_unlock(&framework->moduleLock);
+
+        if (status == CELIX_SUCCESS) {
             fw_fireBundleEvent(framework, OSGI_FRAMEWORK_BUNDLE_EVENT_INSTALLED, bEntry);
             fw_bundleEntry_decreaseUseCount(bEntry);
         } else {
@@ -853,16 +1008,19 @@ celix_status_t fw_startBundle(framework_pt framework, long bndId, int options __
             case OSGI_FRAMEWORK_BUNDLE_INSTALLED:
                 bundle_getCurrentModule(entry->bnd, &module);
                 module_getSymbolicName(module, &name);
+                celixThreadMutex_lock(&framework->moduleLock);
                 if (!module_isResolved(module)) {
                     wires = resolver_resolve(module);
                     if (wires == NULL) {
+                        celixThreadMutex_unlock(&framework->moduleLock);
                         fw_bundleEntry_decreaseUseCount(entry);
                         return CELIX_BUNDLE_EXCEPTION;
                     }
                     status = framework_markResolvedModules(framework, wires);
-                    if (status != CELIX_SUCCESS) {
-                        break;
-                    }
+                }
+                celixThreadMutex_unlock(&framework->moduleLock);
+                if (status != CELIX_SUCCESS) {
+                    break;
                 }
                 /* no break */
             case OSGI_FRAMEWORK_BUNDLE_RESOLVED:
@@ -1655,9 +1813,7 @@ celix_status_t fw_removeFrameworkListener(framework_pt framework, bundle_pt bund
 //}
 
 long framework_getNextBundleId(framework_pt framework) {
-    long id = framework->nextBundleId;
-    framework->nextBundleId++;
-    return id;
+    return __atomic_fetch_add(&framework->nextBundleId, 1, __ATOMIC_SEQ_CST);
 }
 
 celix_status_t framework_markResolvedModules(framework_pt framework, linked_list_pt resolvedModuleWireMap) {
@@ -1922,6 +2078,64 @@ bundle_context_t* framework_getContext(const_framework_pt framework) {
     return result;
 }
 
+/**
+ * Returns the index of the event queue for the events of a bundle or of a service.
+ * Bundle ids and service ids are separate key spaces: the kind of id is part of the key, so that bundle and service
+ * events with the same id are not forced on the same queue.
+ */
+static size_t fw_eventQueueIndex(celix_framework_t *framework, bool isServiceId, long id) {
+    //splitmix64 finalizer to spread the (sequential) ids over the queues
+    uint64_t key = ((uint64_t)id << 1) | (isServiceId ? 1 : 0);
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    key = key ^ (key >> 31);
+    return (size_t)(key % framework->dispatcher.nrOfQueues);
+}
+
+/**
+ * Adds the request to the event queue for the bundle or service id. Events of the same bundle or of the same service
+ * are always added to the same queue, so that they are handled in order.
+ * Returns false if the dispatcher is not active (anymore) or if the queue cannot grow, in that case the request is
+ * not queued.
+ */
+static bool fw_queueEventRequest(celix_framework_t *framework, bool isServiceId, long id, request_t *request) {
+    clock_gettime(CLOCK_MONOTONIC, &request->fireTime);
+
+    celix_framework_event_queue_t *queue = &framework->dispatcher.queues[fw_eventQueueIndex(framework, isServiceId, id)];
+    celixThreadMutex_lock(&queue->mutex);
+    bool queued = queue->active;
+    if (queued && queue->size == queue->capacity) {
+        size_t newCapacity = queue->capacity * 2;
+        request_t **newRequests = calloc(newCapacity, sizeof(*newRequests));
+        if (newRequests != NULL) {
+            for (size_t i = 0; i < queue->size; ++i) {
+                newRequests[i] = queue->requests[(queue->first + i) % queue->capacity];
+            }
+            free(queue->requests);
+            queue->requests = newRequests;
+            queue->capacity = newCapacity;
+            queue->first = 0;
+        } else {
+            fw_log(framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot grow event queue to %zu entries", newCapacity);
+            queued = false;
+        }
+    }
+    if (queued) {
+        queue->requests[(queue->first + queue->size) % queue->capacity] = request;
+        queue->size += 1;
+        queue->pending += 1;
+
+        size_t size = __atomic_add_fetch(&framework->dispatcher.size, 1, __ATOMIC_ACQ_REL);
+        size_t maxSize = __atomic_load_n(&framework->dispatcher.maxSize, __ATOMIC_RELAXED);
+        while (size > maxSize && !__atomic_compare_exchange_n(&framework->dispatcher.maxSize, &maxSize, size, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            //maxSize updated with the current value, retry
+        }
+        celixThreadCondition_signal(&queue->cond);
+    }
+    celixThreadMutex_unlock(&queue->mutex);
+    return queued;
+}
+
 celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e eventType, celix_framework_bundle_entry_t* entry) {
     celix_status_t status = CELIX_SUCCESS;
 
@@ -1944,12 +2158,7 @@ celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e ev
         request->error = NULL;
         request->bndEntry = entry;
 
-        celixThreadMutex_lock(&framework->dispatcher.mutex);
-        if (framework->dispatcher.active) {
-            //fw_log(framework->logger, CELIX_LOG_LEVEL_TRACE, "Adding dispatcher bundle event request for bnd id %li with event type %i", entry->bndId, eventType);
-            celix_arrayList_add(framework->dispatcher.requests, request);
-            celixThreadCondition_broadcast(&framework->dispatcher.cond);
-        } else {
+        if (!fw_queueEventRequest(framework, false, entry->bndId, request)) {
             /*
              * NOTE because stopping the framework is done through stopping the framework bundle,
              * most bundle stopping / stopped events cannot be fired.
@@ -1960,7 +2169,6 @@ celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e ev
             fw_bundleEntry_decreaseUseCount(entry);
             free(request);
         }
-        celixThreadMutex_unlock(&framework->dispatcher.mutex);
     }
 
     framework_logIfError(framework->logger, status, NULL, "Failed to fire bundle event");
@@ -1968,6 +2176,36 @@ celix_status_t fw_fireBundleEvent(framework_pt framework, bundle_event_type_e ev
     return status;
 }
 
+celix_status_t fw_fireServiceEvent(framework_pt framework, long svcId, void *data, void (*processEvent)(void *data)) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    request_t* request = calloc(1, sizeof(*request));
+    if (!request) {
+        status = CELIX_ENOMEM;
+    } else {
+        request->type = EVENT_TYPE_SERVICE;
+        request->eventData = data;
+        request->processEvent = processEvent;
+
+        if (!fw_queueEventRequest(framework, true, svcId, request)) {
+            free(request);
+            status = CELIX_ILLEGAL_STATE;
+        }
+    }
+
+    return status;
+}
+
+bool fw_isEventDispatcherThread(framework_pt framework) {
+    celix_thread_t self = celixThread_self();
+    for (size_t i = 0; i < framework->dispatcher.nrOfQueues; ++i) {
+        if (celixThread_equals(self, framework->dispatcher.queues[i].thread)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 celix_status_t fw_fireFrameworkEvent(framework_pt framework, framework_event_type_e eventType, celix_status_t errorCode) {
     celix_status_t status = CELIX_SUCCESS;
 
@@ -1985,15 +2223,9 @@ celix_status_t fw_fireFrameworkEvent(framework_pt framework, framework_event_typ
             request->error = celix_strerror(errorCode);
         }
 
-        celixThreadMutex_lock(&framework->dispatcher.mutex);
-        if (framework->dispatcher.active) {
-            //fw_log(framework->logger, CELIX_LOG_LEVEL_TRACE, "Adding dispatcher framework event request for event type %i", eventType);
-            celix_arrayList_add(framework->dispatcher.requests, request);
-            celixThreadCondition_broadcast(&framework->dispatcher.cond);
-        } else {
+        if (!fw_queueEventRequest(framework, false, framework->bundleId, request)) {
             free(request);
         }
-        celixThreadMutex_unlock(&framework->dispatcher.mutex);
     }
 
     framework_logIfError(framework->logger, status, NULL, "Failed to fire framework event");
@@ -2038,77 +2270,53 @@ static void fw_handleEventRequest(celix_framework_t *framework, request_t* reque
             fw_invokeFrameworkListener(framework, listener->listener, &event, listener->bundle);
         }
         celixThreadMutex_unlock(&framework->frameworkListenersLock);
+    } else if (request->type == EVENT_TYPE_SERVICE) {
+        request->processEvent(request->eventData);
     }
 }
 
-static inline void fw_handleEvents(celix_framework_t* framework, celix_array_list_t* localRequests) {
-    celixThreadMutex_lock(&framework->dispatcher.mutex);
-    if (celix_arrayList_size(framework->dispatcher.requests) == 0) {
-        //TODO needs a timed wait, because this loop sometimes misses the active=false/broadcast.
-        //FIXME an go back to 'normal' cond wait.
-        celixThreadCondition_timedwaitRelative(&framework->dispatcher.cond, &framework->dispatcher.mutex, 1, 0);
-    }
-    for (int i = 0; i < celix_arrayList_size(framework->dispatcher.requests); ++i) {
-        request_t* r = celix_arrayList_get(framework->dispatcher.requests, i);
-        celix_arrayList_add(localRequests, r);
-//        if (r->type == BUNDLE_EVENT_TYPE) {
-//            fw_log(framework->logger, CELIX_LOG_LEVEL_TRACE,
-//                   "Removing dispatcher bundle event request for bnd id %li with event type %i", r->bndEntry->bndId, r->eventType);
-//        } else {
-//            fw_log(framework->logger, CELIX_LOG_LEVEL_TRACE,
-//                   "Removing dispatcher framework event request for event type %i", r->eventType);
-//        }
-    }
-    celix_arrayList_clear(framework->dispatcher.requests);
-    framework->dispatcher.nrOfLocalRequest = celix_arrayList_size(localRequests);
-    celixThreadMutex_unlock(&framework->dispatcher.mutex);
+static void *fw_eventDispatcher(void *data) {
+    celix_framework_event_queue_t *queue = data;
+    celix_framework_t *framework = queue->fw;
+
+    celixThreadMutex_lock(&queue->mutex);
+    while (true) {
+        while (queue->size == 0 && queue->active) {
+            celixThreadCondition_wait(&queue->cond, &queue->mutex);
+        }
+        if (queue->size == 0) {
+            //not active anymore and all request left overs are handled
+            break;
+        }
+        request_t *request = queue->requests[queue->first];
+        queue->requests[queue->first] = NULL;
+        queue->first = (queue->first + 1) % queue->capacity;
+        queue->size -= 1;
+        celixThreadMutex_unlock(&queue->mutex);
 
-    for (int i = 0; i < celix_arrayList_size(localRequests); ++i) {
-        request_t* request = celix_arrayList_get(localRequests, i);
         fw_handleEventRequest(framework, request);
         if (request->bndEntry != NULL) {
             fw_bundleEntry_decreaseUseCount(request->bndEntry);
         }
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double latency = celix_difftime(&request->fireTime, &now);
         free(request);
-    }
-    celix_arrayList_clear(localRequests);
-
-    celixThreadMutex_lock(&framework->dispatcher.mutex);
-    framework->dispatcher.nrOfLocalRequest = 0;
-    celixThreadMutex_unlock(&framework->dispatcher.mutex);
-}
-
-static void *fw_eventDispatcher(void *fw) {
-    framework_pt framework = (framework_pt) fw;
-
-    celixThreadMutex_lock(&framework->dispatcher.mutex);
-    bool active = framework->dispatcher.active;
-    celixThreadMutex_unlock(&framework->dispatcher.mutex);
-
-    celix_array_list_t *localRequests = celix_arrayList_create();
-
-    while (active) {
-        fw_handleEvents(framework, localRequests);
-
-        celixThreadMutex_lock(&framework->dispatcher.mutex);
-        celixThreadCondition_broadcast(&framework->dispatcher.cond); //trigger threads waiting for an empty event queue (after local events are handled)
-        active = framework->dispatcher.active;
-        celixThreadMutex_unlock(&framework->dispatcher.mutex);
-    }
 
-    //not active any more, last run for possible request left overs
-    celixThreadMutex_lock(&framework->dispatcher.mutex);
-    bool needLastRun = celix_arrayList_size(framework->dispatcher.requests) > 0;
-    celixThreadMutex_unlock(&framework->dispatcher.mutex);
-    if (needLastRun) {
-        fw_handleEvents(framework, localRequests);
+        celixThreadMutex_lock(&queue->mutex);
+        __atomic_sub_fetch(&framework->dispatcher.size, 1, __ATOMIC_ACQ_REL);
+        queue->pending -= 1;
+        queue->nrOfHandledEvents += 1;
+        queue->totalLatency += latency;
+        if (latency > queue->maxLatency) {
+            queue->maxLatency = latency;
+        }
+        celixThreadCondition_broadcast(&queue->emptyCond); //trigger threads waiting for an empty event queue
     }
+    celixThreadMutex_unlock(&queue->mutex);
 
-
-    celix_arrayList_destroy(localRequests);
     celixThread_exit(NULL);
     return NULL;
-
 }
 
 celix_status_t fw_invokeBundleListener(framework_pt framework, bundle_listener_pt listener, bundle_event_pt event, bundle_pt bundle) {
@@ -2152,11 +2360,16 @@ static celix_status_t frameworkActivator_stop(void * userData, bundle_context_t
         celixThreadMutex_unlock(&framework->shutdown.mutex);
 
         if (!alreadyInitialized) {
-            celixThreadMutex_lock(&framework->dispatcher.mutex);
-            framework->dispatcher.active = false;
-            celixThreadCondition_broadcast(&framework->dispatcher.cond);
-            celixThreadMutex_unlock(&framework->dispatcher.mutex);
-            celixThread_join(framework->dispatcher.thread, NULL);
+            for (size_t i = 0; i < framework->dispatcher.nrOfQueues; ++i) {
+                celix_framework_event_queue_t *queue = &framework->dispatcher.queues[i];
+                celixThreadMutex_lock(&queue->mutex);
+                queue->active = false;
+                celixThreadCondition_broadcast(&queue->cond);
+                celixThreadMutex_unlock(&queue->mutex);
+            }
+            for (size_t i = 0; i < framework->dispatcher.nrOfQueues; ++i) {
+                celixThread_join(framework->dispatcher.queues[i].thread, NULL);
+            }
             fw_log(framework->logger, CELIX_LOG_LEVEL_TRACE, "Joined shutdown thread for framework %s", celix_framework_getUUID(framework));
 
             celixThread_create(&framework->shutdown.thread, NULL, &framework_shutdown, framework);
@@ -2528,11 +2741,44 @@ bool celix_framework_startBundle(celix_framework_t *fw, long bndId) {
 }
 
 void celix_framework_waitForEmptyEventQueue(celix_framework_t *fw) {
-    celixThreadMutex_lock(&fw->dispatcher.mutex);
-    while ((celix_arrayList_size(fw->dispatcher.requests) + fw->dispatcher.nrOfLocalRequest) != 0) {
-        celixThreadCondition_wait(&fw->dispatcher.cond, &fw->dispatcher.mutex);
+    //note handling an event can queue events on already checked queues, so repeat until no waiting was needed
+    bool waited = true;
+    while (waited) {
+        waited = false;
+        for (size_t i = 0; i < fw->dispatcher.nrOfQueues; ++i) {
+            celix_framework_event_queue_t *queue = &fw->dispatcher.queues[i];
+            celixThreadMutex_lock(&queue->mutex);
+            while (queue->pending != 0) {
+                celixThreadCondition_wait(&queue->emptyCond, &queue->mutex);
+                waited = true;
+            }
+            celixThreadMutex_unlock(&queue->mutex);
+        }
+    }
+}
+
+size_t celix_framework_getEventQueueSize(celix_framework_t *fw) {
+    return __atomic_load_n(&fw->dispatcher.size, __ATOMIC_ACQUIRE);
+}
+
+void celix_framework_getEventQueueStats(celix_framework_t *fw, celix_framework_event_queue_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    double totalLatency = 0.0;
+    for (size_t i = 0; i < fw->dispatcher.nrOfQueues; ++i) {
+        celix_framework_event_queue_t *queue = &fw->dispatcher.queues[i];
+        celixThreadMutex_lock(&queue->mutex);
+        stats->nrOfHandledEvents += queue->nrOfHandledEvents;
+        totalLatency += queue->totalLatency;
+        if (queue->maxLatency > stats->maxLatency) {
+            stats->maxLatency = queue->maxLatency;
+        }
+        celixThreadMutex_unlock(&queue->mutex);
+    }
+    stats->size = __atomic_load_n(&fw->dispatcher.size, __ATOMIC_ACQUIRE);
+    stats->maxSize = __atomic_load_n(&fw->dispatcher.maxSize, __ATOMIC_RELAXED);
+    if (stats->nrOfHandledEvents > 0) {
+        stats->averageLatency = totalLatency / (double)stats->nrOfHandledEvents;
     }
-    celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
 
 void celix_framework_setLogCallback(celix_framework_t* fw, void* logHandle, void (*logFunction)(void* handle, celix_log_level_e level, const char* file, const char *function, int line, const char *format, va_list formatArgs)) {
@@ -41,6 +41,28 @@
 #include "celix_threads.h"
 #include "service_registry.h"
 
+#define CELIX_FRAMEWORK_EVENT_QUEUE_INITIAL_CAPACITY 16
+
+/**
+ * Event queue (ring buffer) with its own dispatcher thread and its own lock.
+ */
+typedef struct celix_framework_event_queue {
+    celix_framework_t *fw;
+    celix_thread_t thread;
+    celix_thread_mutex_t mutex; //protects the fields below
+    celix_thread_cond_t cond; //signaled when an event is added or the queue is deactivated
+    celix_thread_cond_t emptyCond; //broadcast when an event is handled, used to wait for an empty event queue
+    bool active;
+    struct request **requests;
+    size_t capacity;
+    size_t first; //index of the first queued request
+    size_t size; //nr of queued requests
+    size_t pending; //nr of queued requests and the request being handled
+    size_t nrOfHandledEvents;
+    double totalLatency;
+    double maxLatency;
+} celix_framework_event_queue_t;
+
 struct celix_framework {
 #ifdef WITH_APR
     apr_pool_t *pool;
@@ -56,6 +78,7 @@ struct celix_framework {
     celix_thread_mutex_t bundleListenerLock;
 
     long nextBundleId;
+    celix_thread_mutex_t moduleLock; //protects creating and resolving bundle modules, so that bundles can be installed and started concurrently
     celix_service_registry_t *registry;
     bundle_cache_pt cache;
 
@@ -78,12 +101,10 @@ struct celix_framework {
 
 
     struct {
-        celix_thread_cond_t cond;
-        celix_thread_t thread;
-        celix_thread_mutex_t mutex; //protect active and requests
-        bool active;
-        celix_array_list_t *requests;
-        size_t nrOfLocalRequest;
+        size_t nrOfQueues;
+        celix_framework_event_queue_t *queues; //the events of a bundle or of a service are always added to the same queue
+        size_t size; //nr of events queued or being handled in all queues, atomic
+        size_t maxSize; //atomic
     } dispatcher;
 
     celix_framework_logger_t* logger;
@@ -120,6 +141,18 @@ FRAMEWORK_EXPORT celix_status_t fw_removeBundleListener(framework_pt framework,
 FRAMEWORK_EXPORT celix_status_t fw_addFrameworkListener(framework_pt framework, bundle_pt bundle, framework_listener_pt listener);
 FRAMEWORK_EXPORT celix_status_t fw_removeFrameworkListener(framework_pt framework, bundle_pt bundle, framework_listener_pt listener);
 
+/**
+ * Queues a service event on the framework event dispatcher. processEvent is called with data on a
+ * framework event dispatcher thread. Events for the same service id are handled in order.
+ * Returns CELIX_ILLEGAL_STATE if the event dispatcher is not active, in that case the event is not queued.
+ */
+FRAMEWORK_EXPORT celix_status_t fw_fireServiceEvent(framework_pt framework, long svcId, void *data, void (*processEvent)(void *data));
+
+/**
+ * Returns whether the calling thread is one of the framework event dispatcher threads.
+ */
+FRAMEWORK_EXPORT bool fw_isEventDispatcherThread(framework_pt framework);
+
 FRAMEWORK_EXPORT void fw_serviceChanged(framework_pt framework, celix_service_event_type_t eventType, service_registration_pt registration, properties_pt oldprops);
 
 FRAMEWORK_EXPORT celix_status_t fw_isServiceAssignable(framework_pt fw, bundle_pt requester, service_reference_pt reference, bool* assignable);
@@ -105,8 +105,15 @@ static celix_status_t serviceRegistration_destroy(service_registration_pt regist
 	registration->className = NULL;
 
     registration->callback.unregister = NULL;
+    registration->callback.modified = NULL;
 
 	properties_destroy(registration->properties);
+    if (registration->replacedProperties != NULL) {
+        for (int i = 0; i < celix_arrayList_size(registration->replacedProperties); ++i) {
+            properties_destroy(celix_arrayList_get(registration->replacedProperties, i));
+        }
+        celix_arrayList_destroy(registration->replacedProperties);
+    }
 	celixThreadRwlock_unlock(&registration->lock);
     celixThreadRwlock_destroy(&registration->lock);
 	free(registration);
@@ -230,11 +237,26 @@ celix_status_t serviceRegistration_getProperties(service_registration_pt registr
 
 celix_status_t serviceRegistration_setProperties(service_registration_pt registration, properties_pt properties) {
     celix_status_t status;
+    registry_callback_t callback;
+    callback.modified = NULL;
 
     celixThreadRwlock_writeLock(&registration->lock);
+    if (registration->properties != NULL && registration->properties != properties) {
+        if (registration->replacedProperties == NULL) {
+            registration->replacedProperties = celix_arrayList_create();
+        }
+        celix_arrayList_add(registration->replacedProperties, registration->properties);
+    }
     status = serviceRegistration_initializeProperties(registration, properties);
+    if (status == CELIX_SUCCESS && registration->svcObj != NULL && !registration->isUnregistering) {
+        callback = registration->callback;
+    }
     celixThreadRwlock_unlock(&registration->lock);
 
+    if (callback.modified != NULL) {
+        callback.modified(callback.handle, registration);
+    }
+
 	return status;
 }
 
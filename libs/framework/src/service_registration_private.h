@@ -36,6 +36,7 @@ struct serviceRegistration {
 	char * className;
 	bundle_pt bundle;
 	properties_pt properties;
+	celix_array_list_t *replacedProperties; //properties replaced by setProperties, kept till destroy because users can still refer to them
 	unsigned long serviceId;
 
 	bool isUnregistering;
@@ -50,6 +50,8 @@ static celix_status_t serviceRegistry_setReferenceStatus(service_registry_pt reg
 static celix_status_t serviceRegistry_getUsingBundles(service_registry_pt registry, service_registration_pt reg, array_list_pt *bundles);
 static celix_status_t serviceRegistry_getServiceReference_internal(service_registry_pt registry, bundle_pt owner, service_registration_pt registration, service_reference_pt *out);
 static void celix_serviceRegistry_serviceChanged(celix_service_registry_t *registry, celix_service_event_type_t eventType, service_registration_pt registration);
+static void serviceRegistry_servicePropertiesModified(service_registry_pt registry, service_registration_pt registration);
+static void celix_serviceRegistry_fireRegisteredEvent(celix_service_registry_t *registry, service_registration_pt registration);
 static void serviceRegistry_callHooksForListenerFilter(service_registry_pt registry, celix_bundle_t *owner, const celix_filter_t *filter, bool removed);
 
     static celix_service_registry_listener_hook_entry_t* celix_createHookEntry(long svcId, celix_listener_hook_service_t*);
@@ -63,7 +65,13 @@ static void celix_waitAndDestroyServiceListener(celix_service_registry_service_l
 
 static void celix_increasePendingRegisteredEvent(celix_service_registry_t *registry, long svcId);
 static void celix_decreasePendingRegisteredEvent(celix_service_registry_t *registry, long svcId);
-static void celix_waitForPendingRegisteredEvents(celix_service_registry_t *registry, long svcId);
+static void celix_decreasePendingRegisteredEventLocked(celix_service_registry_t *registry, long svcId);
+static void celix_waitForOrCancelPendingRegisteredEvents(celix_service_registry_t *registry, long svcId);
+
+static void serviceRegistry_addToNameIndex(celix_service_registry_t *registry, service_registration_pt registration);
+static void serviceRegistry_removeFromNameIndex(celix_service_registry_t *registry, service_registration_pt registration);
+static const char* serviceRegistry_requiredServiceNameForFilter(const celix_filter_t *filter);
+static void serviceRegistry_collectMatchingRegistrations(celix_service_registry_t *registry, const char *serviceName, const celix_filter_t *filter, celix_array_list_t *matchingRegistrations);
 
 celix_status_t serviceRegistry_create(framework_pt framework, service_registry_pt *out) {
 	celix_status_t status;
@@ -76,8 +84,10 @@ celix_status_t serviceRegistry_create(framework_pt framework, service_registry_p
         reg->callback.handle = reg;
         reg->callback.getUsingBundles = (void *)serviceRegistry_getUsingBundles;
         reg->callback.unregister = (void *) serviceRegistry_unregisterService;
+        reg->callback.modified = (void *) serviceRegistry_servicePropertiesModified;
 
 		reg->serviceRegistrations = hashMap_create(NULL, NULL, NULL, NULL);
+		reg->serviceRegistrationsByName = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
 		reg->framework = framework;
 		reg->nextServiceId = 1L;
 		reg->serviceReferences = hashMap_create(NULL, NULL, NULL, NULL);
@@ -91,6 +101,9 @@ celix_status_t serviceRegistry_create(framework_pt framework, service_registry_p
 		celixThreadMutex_create(&reg->pendingRegisterEvents.mutex, NULL);
 		celixThreadCondition_init(&reg->pendingRegisterEvents.cond, NULL);
 		reg->pendingRegisterEvents.map = hashMap_create(NULL, NULL, NULL, NULL);
+		reg->pendingRegisterEvents.asyncEvents = hashMap_create(NULL, NULL, NULL, NULL);
+
+		reg->asyncServiceEvents = celix_properties_getAsBool(framework->configurationMap, CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS, CELIX_FRAMEWORK_ASYNC_SERVICE_EVENTS_DEFAULT);
 
 		status = celixThreadRwlock_create(&reg->lock, NULL);
 	}
@@ -139,6 +152,7 @@ celix_status_t serviceRegistry_destroy(service_registry_pt registry) {
 
     assert(size == 0);
     hashMap_destroy(registry->serviceRegistrations, false, false);
+    hashMap_destroy(registry->serviceRegistrationsByName, true, false);
 
     //destroy service references (double) map);
     size = hashMap_size(registry->serviceReferences);
@@ -159,9 +173,12 @@ celix_status_t serviceRegistry_destroy(service_registry_pt registry) {
 
     size = hashMap_size(registry->pendingRegisterEvents.map);
     assert(size == 0);
+    size = hashMap_size(registry->pendingRegisterEvents.asyncEvents);
+    assert(size == 0);
     celixThreadMutex_destroy(&registry->pendingRegisterEvents.mutex);
     celixThreadCondition_destroy(&registry->pendingRegisterEvents.cond);
     hashMap_destroy(registry->pendingRegisterEvents.map, false, false);
+    hashMap_destroy(registry->pendingRegisterEvents.asyncEvents, false, false);
 
     free(registry);
 
@@ -230,6 +247,7 @@ static celix_status_t serviceRegistry_registerServiceInternal(service_registry_p
         hashMap_put(registry->serviceRegistrations, bundle, regs);
     }
 	arrayList_add(regs, *registration);
+    serviceRegistry_addToNameIndex(registry, *registration);
 
     //update pending register event
     celix_increasePendingRegisteredEvent(registry, svcId);
@@ -241,9 +259,7 @@ static celix_status_t serviceRegistry_registerServiceInternal(service_registry_p
     //The handling of pending registered events is to ensure that the UNREGISTERING event is always
     //after the 1 or 2 REGISTERED events.
 
-	celix_serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED, *registration);
-    //update pending register event count
-    celix_decreasePendingRegisteredEvent(registry, svcId);
+	celix_serviceRegistry_fireRegisteredEvent(registry, *registration);
 
 	return CELIX_SUCCESS;
 }
@@ -265,6 +281,7 @@ celix_status_t serviceRegistry_unregisterService(service_registry_pt registry, b
 	regs = (celix_array_list_t*) hashMap_get(registry->serviceRegistrations, bundle);
 	if (regs != NULL) {
 		arrayList_removeElement(regs, registration);
+        serviceRegistry_removeFromNameIndex(registry, registration);
         int size = arrayList_size(regs);
         if (size == 0) {
             celix_arrayList_destroy(regs);
@@ -274,8 +291,9 @@ celix_status_t serviceRegistry_unregisterService(service_registry_pt registry, b
 	celixThreadRwlock_unlock(&registry->lock);
 
 
-    //check and wait for pending register events
-    celix_waitForPendingRegisteredEvents(registry, svcId);
+    //check and wait for (or cancel) pending register events, so that the UNREGISTERING event is always after the
+    //REGISTERED event
+    celix_waitForOrCancelPendingRegisteredEvents(registry, svcId);
 
     celix_serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_UNREGISTERING, registration);
 
@@ -321,7 +339,10 @@ celix_status_t serviceRegistry_clearServiceRegistrations(service_registry_pt reg
             serviceRegistration_unregister(reg);
         }
         else {
+            celixThreadRwlock_writeLock(&registry->lock);
             arrayList_remove(registrations, 0);
+            serviceRegistry_removeFromNameIndex(registry, reg);
+            celixThreadRwlock_unlock(&registry->lock);
         }
 
         // not removed by last unregister call?
@@ -396,54 +417,17 @@ static celix_status_t serviceRegistry_getServiceReference_internal(service_regis
 
 celix_status_t serviceRegistry_getServiceReferences(service_registry_pt registry, bundle_pt owner, const char *serviceName, filter_pt filter, array_list_pt *out) {
 	celix_status_t status;
-	hash_map_iterator_pt iterator;
     array_list_pt references = NULL;
 	array_list_pt matchingRegistrations = NULL;
-    bool matchResult;
 
     status = arrayList_create(&references);
     status = CELIX_DO_IF(status, arrayList_create(&matchingRegistrations));
 
-    celixThreadRwlock_readLock(&registry->lock);
-	iterator = hashMapIterator_create(registry->serviceRegistrations);
-	while (status == CELIX_SUCCESS && hashMapIterator_hasNext(iterator)) {
-		array_list_pt regs = (array_list_pt) hashMapIterator_nextValue(iterator);
-		unsigned int regIdx;
-		for (regIdx = 0; (regs != NULL) && regIdx < arrayList_size(regs); regIdx++) {
-			service_registration_pt registration = (service_registration_pt) arrayList_get(regs, regIdx);
-			properties_pt props = NULL;
-
-			status = serviceRegistration_getProperties(registration, &props);
-			if (status == CELIX_SUCCESS) {
-				bool matched = false;
-				matchResult = false;
-				if (filter != NULL) {
-					filter_match(filter, props, &matchResult);
-				}
-				if ((serviceName == NULL) && ((filter == NULL) || matchResult)) {
-					matched = true;
-				} else if (serviceName != NULL) {
-					const char *className = NULL;
-					matchResult = false;
-					serviceRegistration_getServiceName(registration, &className);
-					if (filter != NULL) {
-						filter_match(filter, props, &matchResult);
-					}
-					if ((strcmp(className, serviceName) == 0) && ((filter == NULL) || matchResult)) {
-						matched = true;
-					}
-				}
-				if (matched) {
-					if (serviceRegistration_isValid(registration)) {
-                        serviceRegistration_retain(registration);
-                        arrayList_add(matchingRegistrations, registration);
-					}
-				}
-			}
-		}
-	}
-    celixThreadRwlock_unlock(&registry->lock);
-	hashMapIterator_destroy(iterator);
+    if (status == CELIX_SUCCESS) {
+        celixThreadRwlock_readLock(&registry->lock);
+        serviceRegistry_collectMatchingRegistrations(registry, serviceName, filter, matchingRegistrations);
+        celixThreadRwlock_unlock(&registry->lock);
+    }
 
     if (status == CELIX_SUCCESS) {
         unsigned int i;
@@ -1127,21 +1111,11 @@ celix_status_t celix_serviceRegistry_addServiceListener(celix_service_registry_t
     celix_arrayList_add(registry->serviceListeners, entry); //use count 1
 
     //find already registered services
-    hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceRegistrations);
-    while (hashMapIterator_hasNext(&iter)) {
-        celix_array_list_t *regs = (array_list_pt) hashMapIterator_nextValue(&iter);
-        for (int regIdx = 0; (regs != NULL) && regIdx < celix_arrayList_size(regs); ++regIdx) {
-            service_registration_pt registration = celix_arrayList_get(regs, regIdx);
-            properties_pt props = NULL;
-            serviceRegistration_getProperties(registration, &props);
-            if (celix_filter_match(filter, props)) {
-                serviceRegistration_retain(registration);
-                long svcId = serviceRegistration_getServiceId(registration);
-                celix_arrayList_add(registrations, registration);
-                //update pending register event count
-                celix_increasePendingRegisteredEvent(registry, svcId);
-            }
-        }
+    serviceRegistry_collectMatchingRegistrations(registry, NULL, filter, registrations);
+    for (int i = 0; i < celix_arrayList_size(registrations); ++i) {
+        service_registration_pt registration = celix_arrayList_get(registrations, i);
+        //update pending register event count
+        celix_increasePendingRegisteredEvent(registry, serviceRegistration_getServiceId(registration));
     }
     celixThreadRwlock_unlock(&registry->lock);
 
@@ -1199,6 +1173,10 @@ celix_status_t celix_serviceRegistry_removeServiceListener(celix_service_registr
     return CELIX_SUCCESS;
 }
 
+static void serviceRegistry_servicePropertiesModified(service_registry_pt registry, service_registration_pt registration) {
+    celix_serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_MODIFIED, registration);
+}
+
 static void celix_serviceRegistry_serviceChanged(celix_service_registry_t *registry, celix_service_event_type_t eventType, service_registration_pt registration) {
     celix_service_registry_service_listener_entry_t *entry;
 
@@ -1254,6 +1232,77 @@ static void celix_serviceRegistry_serviceChanged(celix_service_registry_t *regis
     celix_arrayList_destroy(matchedEntries);
 }
 
+typedef struct celix_service_registry_registered_event {
+    celix_service_registry_t *registry;
+    service_registration_t *registration;
+    long svcId;
+    //below protected by the pending register events mutex
+    bool canceled; //true if the service is unregistered before the event is delivered
+    bool delivering;
+    celix_thread_t deliveringThread;
+} celix_service_registry_registered_event_t;
+
+static void celix_serviceRegistry_processRegisteredEvent(void *data) {
+    celix_service_registry_registered_event_t *event = data;
+    celix_service_registry_t *registry = event->registry;
+
+    celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+    bool deliver = !event->canceled;
+    if (deliver) {
+        event->delivering = true;
+        event->deliveringThread = celixThread_self();
+    }
+    celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+
+    if (deliver) {
+        celix_serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED, event->registration);
+
+        //update pending register event count. Note for a canceled event this is done when canceling.
+        celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+        hashMap_remove(registry->pendingRegisterEvents.asyncEvents, (void*)event->svcId);
+        celix_decreasePendingRegisteredEventLocked(registry, event->svcId);
+        celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+    }
+
+    serviceRegistration_release(event->registration);
+    free(event);
+}
+
+/**
+ * Fires the REGISTERED event for the registration. If async service events are enabled the event is delivered
+ * on a framework event dispatcher thread, otherwise (or if the event dispatcher is not active) on the calling thread.
+ * Precondition: the pending registered event count for the service is increased.
+ */
+static void celix_serviceRegistry_fireRegisteredEvent(celix_service_registry_t *registry, service_registration_pt registration) {
+    if (registry->asyncServiceEvents) {
+        celix_service_registry_registered_event_t *event = calloc(1, sizeof(*event));
+        if (event != NULL) {
+            event->registry = registry;
+            event->registration = registration;
+            event->svcId = serviceRegistration_getServiceId(registration);
+            serviceRegistration_retain(registration);
+
+            //note added before queueing, so that an unregister (also on a dispatcher thread) always finds the event
+            celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+            hashMap_put(registry->pendingRegisterEvents.asyncEvents, (void*)event->svcId, event);
+            celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+
+            celix_status_t status = fw_fireServiceEvent(registry->framework, event->svcId, event, celix_serviceRegistry_processRegisteredEvent);
+            if (status == CELIX_SUCCESS) {
+                return;
+            }
+
+            celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+            hashMap_remove(registry->pendingRegisterEvents.asyncEvents, (void*)event->svcId);
+            celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+            serviceRegistration_release(registration);
+            free(event);
+        }
+    }
+    celix_serviceRegistry_serviceChanged(registry, OSGI_FRAMEWORK_SERVICE_EVENT_REGISTERED, registration);
+    //update pending register event count
+    celix_decreasePendingRegisteredEvent(registry, serviceRegistration_getServiceId(registration));
+}
 
 static void celix_increasePendingRegisteredEvent(celix_service_registry_t *registry, long svcId) {
     celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
@@ -1265,6 +1314,11 @@ static void celix_increasePendingRegisteredEvent(celix_service_registry_t *regis
 
 static void celix_decreasePendingRegisteredEvent(celix_service_registry_t *registry, long svcId) {
     celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+    celix_decreasePendingRegisteredEventLocked(registry, svcId);
+    celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+}
+
+static void celix_decreasePendingRegisteredEventLocked(celix_service_registry_t *registry, long svcId) {
     long count = (long)hashMap_get(registry->pendingRegisterEvents.map, (void*)svcId);
     assert(count >= 1);
     count -= 1;
@@ -1273,12 +1327,28 @@ static void celix_decreasePendingRegisteredEvent(celix_service_registry_t *regis
     } else {
         hashMap_remove(registry->pendingRegisterEvents.map, (void*)svcId);
     }
-    celixThreadCondition_signal(&registry->pendingRegisterEvents.cond);
-    celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+    celixThreadCondition_broadcast(&registry->pendingRegisterEvents.cond);
 }
 
-static void celix_waitForPendingRegisteredEvents(celix_service_registry_t *registry, long svcId) {
+/**
+ * Waits until the pending REGISTERED events of the service are delivered.
+ * On a framework event dispatcher thread a queued (not yet delivered) async REGISTERED event is canceled instead,
+ * because a dispatcher thread cannot wait for an event queued after the event it is handling.
+ * The REGISTERED event being delivered by the calling thread itself (i.e. the service is unregistered from a
+ * REGISTERED callback) is not waited for.
+ */
+static void celix_waitForOrCancelPendingRegisteredEvents(celix_service_registry_t *registry, long svcId) {
+    bool isDispatcherThread = registry->asyncServiceEvents && fw_isEventDispatcherThread(registry->framework);
     celixThreadMutex_lock(&registry->pendingRegisterEvents.mutex);
+    celix_service_registry_registered_event_t *event = hashMap_get(registry->pendingRegisterEvents.asyncEvents, (void*)svcId);
+    if (event != NULL && !event->delivering && isDispatcherThread) {
+        event->canceled = true;
+        hashMap_remove(registry->pendingRegisterEvents.asyncEvents, (void*)svcId);
+        celix_decreasePendingRegisteredEventLocked(registry, svcId);
+    } else if (event != NULL && celixThread_equals(event->deliveringThread, celixThread_self())) {
+        celixThreadMutex_unlock(&registry->pendingRegisterEvents.mutex);
+        return;
+    }
     long count = (long)hashMap_get(registry->pendingRegisterEvents.map, (void*)svcId);
     while (count > 0) {
         celixThreadCondition_wait(&registry->pendingRegisterEvents.cond, &registry->pendingRegisterEvents.mutex);
@@ -1290,4 +1360,117 @@ static void celix_waitForPendingRegisteredEvents(celix_service_registry_t *regis
 long celix_serviceRegistry_nextSvcId(celix_service_registry_t* registry) {
     long scvId = __atomic_fetch_add(&registry->nextServiceId, 1, __ATOMIC_SEQ_CST);
     return scvId;
-}
\ No newline at end of file
+}
+
+static void serviceRegistry_addToNameIndex(celix_service_registry_t *registry, service_registration_pt registration) {
+    //only call after locked registry RWlock
+    const char *svcName = NULL;
+    serviceRegistration_getServiceName(registration, &svcName);
+    celix_array_list_t *regs = hashMap_get(registry->serviceRegistrationsByName, svcName);
+    if (regs == NULL) {
+        regs = celix_arrayList_create();
+        hashMap_put(registry->serviceRegistrationsByName, celix_utils_strdup(svcName), regs);
+    }
+    celix_arrayList_add(regs, registration);
+
+    properties_pt props = NULL;
+    serviceRegistration_getProperties(registration, &props);
+    const char *objectClass = celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, NULL);
+    if (objectClass == NULL || strcmp(objectClass, svcName) != 0) {
+        registry->nrOfCustomObjectClassRegistrations += 1;
+    }
+}
+
+static void serviceRegistry_removeFromNameIndex(celix_service_registry_t *registry, service_registration_pt registration) {
+    //only call after locked registry RWlock
+    const char *svcName = NULL;
+    serviceRegistration_getServiceName(registration, &svcName);
+    hash_map_entry_t *entry = hashMap_getEntry(registry->serviceRegistrationsByName, svcName);
+    celix_array_list_t *regs = entry != NULL ? hashMapEntry_getValue(entry) : NULL;
+    int sizeBefore = regs != NULL ? celix_arrayList_size(regs) : 0;
+    if (regs != NULL) {
+        celix_arrayList_remove(regs, registration);
+    }
+    if (regs == NULL || celix_arrayList_size(regs) == sizeBefore) {
+        return; //not indexed (anymore)
+    } else if (celix_arrayList_size(regs) == 0) {
+        char *key = hashMapEntry_getKey(entry);
+        hashMap_remove(registry->serviceRegistrationsByName, key);
+        free(key);
+        celix_arrayList_destroy(regs);
+    }
+
+    properties_pt props = NULL;
+    serviceRegistration_getProperties(registration, &props);
+    const char *objectClass = celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, NULL);
+    if (objectClass == NULL || strcmp(objectClass, svcName) != 0) {
+        registry->nrOfCustomObjectClassRegistrations -= 1;
+    }
+}
+
+/**
+ * Returns the objectClass a filter requires, i.e. a top level (objectClass=<name>) criteria or a
+ * (objectClass=<name>) criteria directly below a top level AND (the form used by service trackers).
+ * Returns NULL if the filter does not restrict the objectClass to a single value.
+ */
+static const char* serviceRegistry_requiredServiceNameForFilter(const celix_filter_t *filter) {
+    if (filter == NULL) {
+        return NULL;
+    } else if (filter->operand == CELIX_FILTER_OPERAND_EQUAL) {
+        return strcmp(filter->attribute, OSGI_FRAMEWORK_OBJECTCLASS) == 0 ? filter->value : NULL;
+    } else if (filter->operand == CELIX_FILTER_OPERAND_AND) {
+        for (int i = 0; i < celix_arrayList_size(filter->children); ++i) {
+            const celix_filter_t *child = celix_arrayList_get(filter->children, i);
+            if (child->operand == CELIX_FILTER_OPERAND_EQUAL && strcmp(child->attribute, OSGI_FRAMEWORK_OBJECTCLASS) == 0) {
+                return child->value;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void serviceRegistry_addMatchingRegistrationsFromList(celix_array_list_t *regs, const char *serviceName, const celix_filter_t *filter, celix_array_list_t *matchingRegistrations) {
+    for (int i = 0; regs != NULL && i < celix_arrayList_size(regs); ++i) {
+        service_registration_pt registration = celix_arrayList_get(regs, i);
+        bool matched = true;
+        if (serviceName != NULL) {
+            const char *className = NULL;
+            serviceRegistration_getServiceName(registration, &className);
+            matched = strcmp(className, serviceName) == 0;
+        }
+        if (matched && filter != NULL) {
+            properties_pt props = NULL;
+            serviceRegistration_getProperties(registration, &props);
+            matched = celix_filter_match(filter, props);
+        }
+        if (matched && serviceRegistration_isValid(registration)) {
+            serviceRegistration_retain(registration);
+            celix_arrayList_add(matchingRegistrations, registration);
+        }
+    }
+}
+
+/**
+ * Adds the (retained) registrations matching the service name and filter to the provided list.
+ * If the service name is known - directly or through the filter - only the registrations in the
+ * service name index are visited, otherwise all registrations are visited.
+ */
+static void serviceRegistry_collectMatchingRegistrations(celix_service_registry_t *registry, const char *serviceName, const celix_filter_t *filter, celix_array_list_t *matchingRegistrations) {
+    //only call after locked registry RWlock
+    const char *indexName = serviceName;
+    if (indexName == NULL && registry->nrOfCustomObjectClassRegistrations == 0) {
+        //note the objectClass of a filter can only be used if all registrations have an objectClass equal to the service name
+        indexName = serviceRegistry_requiredServiceNameForFilter(filter);
+    }
+
+    if (indexName != NULL) {
+        celix_array_list_t *regs = hashMap_get(registry->serviceRegistrationsByName, indexName);
+        serviceRegistry_addMatchingRegistrationsFromList(regs, serviceName, filter, matchingRegistrations);
+    } else {
+        hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceRegistrations);
+        while (hashMapIterator_hasNext(&iter)) {
+            celix_array_list_t *regs = hashMapIterator_nextValue(&iter);
+            serviceRegistry_addMatchingRegistrationsFromList(regs, serviceName, filter, matchingRegistrations);
+        }
+    }
+}
@@ -39,6 +39,8 @@ struct celix_serviceRegistry {
     celix_thread_rwlock_t lock; //protect below
 
 	hash_map_t *serviceRegistrations; //key = bundle (reg owner), value = list ( registration )
+	hash_map_t *serviceRegistrationsByName; //key = service name (owned), value = list ( registration )
+	long nrOfCustomObjectClassRegistrations; //nr of registrations where the objectClass property differs from the service name
 	hash_map_t *serviceReferences; //key = bundle, value = map (key = serviceId, value = reference)
 
 	bool checkDeletedReferences; //If enabled. check if provided service references are still valid
@@ -49,6 +51,8 @@ struct celix_serviceRegistry {
 	celix_array_list_t *listenerHooks; //celix_service_registry_listener_hook_entry_t*
 	celix_array_list_t *serviceListeners; //celix_service_registry_service_listener_entry_t*
 
+	bool asyncServiceEvents; //if true, REGISTERED events are delivered on the framework event dispatcher thread(s)
+
 	/**
 	 * The pending register events are introduced to ensure UNREGISTERING events are always
 	 * after REGISTERED events in service listeners.
@@ -62,6 +66,7 @@ struct celix_serviceRegistry {
 	    celix_thread_mutex_t mutex;
 	    celix_thread_cond_t cond;
 	    hash_map_t *map; //key = svc id, value = long (nr of pending register events)
+	    hash_map_t *asyncEvents; //key = svc id, value = celix_service_registry_registered_event_t* (queued or being delivered)
 	} pendingRegisterEvents;
 };
 
@@ -24,6 +24,8 @@
 #include "framework_private.h"
 #include <assert.h>
 #include <unistd.h>
+#include <sched.h>
+#include <stdint.h>
 #include <celix_api.h>
 
 #include "service_tracker_private.h"
@@ -76,6 +78,8 @@ static inline celix_tracked_entry_t* tracked_create(service_reference_pt ref, vo
     tracked->properties = props;
     tracked->serviceOwner = bnd;
     tracked->serviceName = celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, "Error");
+    tracked->serviceId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1L);
+    tracked->serviceRanking = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, 0L);
 
     tracked->useCount = 1;
     celixThreadMutex_create(&tracked->mutex, NULL);
@@ -83,23 +87,38 @@ static inline celix_tracked_entry_t* tracked_create(service_reference_pt ref, vo
     return tracked;
 }
 
+/**
+ * Returns true if the tracked entry a should be ordered before tracked entry b, i.e. has a higher ranking or
+ * has an equal ranking and a lower service id.
+ */
+static inline bool tracked_isRankedHigher(const celix_tracked_entry_t *a, const celix_tracked_entry_t *b) {
+    return a->serviceRanking > b->serviceRanking || (a->serviceRanking == b->serviceRanking && a->serviceId < b->serviceId);
+}
+
 static inline void tracked_retain(celix_tracked_entry_t *tracked) {
-    celixThreadMutex_lock(&tracked->mutex);
-    tracked->useCount += 1;
-    celixThreadMutex_unlock(&tracked->mutex);
+    __atomic_add_fetch(&tracked->useCount, 1, __ATOMIC_ACQ_REL);
 }
 
 static inline void tracked_release(celix_tracked_entry_t *tracked) {
+    //lock free if this is not the last use. The last use is released with the mutex locked, so that
+    //tracked_waitAndDestroy cannot destroy the entry before the useCond is signalled.
+    size_t count = __atomic_load_n(&tracked->useCount, __ATOMIC_ACQUIRE);
+    while (count > 1) {
+        if (__atomic_compare_exchange_n(&tracked->useCount, &count, count - 1, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return;
+        }
+    }
     celixThreadMutex_lock(&tracked->mutex);
-    assert(tracked->useCount > 0);
-    tracked->useCount -= 1;
-    celixThreadCondition_signal(&tracked->useCond);
+    assert(__atomic_load_n(&tracked->useCount, __ATOMIC_ACQUIRE) > 0);
+    if (__atomic_sub_fetch(&tracked->useCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        celixThreadCondition_broadcast(&tracked->useCond);
+    }
     celixThreadMutex_unlock(&tracked->mutex);
 }
 
 static inline void tracked_waitAndDestroy(celix_tracked_entry_t *tracked) {
     celixThreadMutex_lock(&tracked->mutex);
-    while (tracked->useCount != 0) {
+    while (__atomic_load_n(&tracked->useCount, __ATOMIC_ACQUIRE) != 0) {
         celixThreadCondition_wait(&tracked->useCond, &tracked->mutex);
     }
     celixThreadMutex_unlock(&tracked->mutex);
@@ -110,6 +129,97 @@ static inline void tracked_waitAndDestroy(celix_tracked_entry_t *tracked) {
     free(tracked);
 }
 
+/**
+ * Replaces the tracked snapshot with a copy of the current trackedServices and returns the replaced snapshot.
+ * Must be called with the instance lock write locked.
+ *
+ * If the new snapshot cannot be allocated, the snapshot is set to NULL so that the use calls fall back to read
+ * locking the tracker; the replaced snapshot cannot be kept, because it could contain entries no longer tracked.
+ *
+ * The returned snapshot can still be used by snapshot readers and must be retired with
+ * serviceTracker_retireSnapshot after the instance lock is unlocked.
+ */
+static celix_tracked_snapshot_t* serviceTracker_publishSnapshot(celix_service_tracker_instance_t *instance) {
+    int size = celix_arrayList_size(instance->trackedServices);
+    celix_tracked_snapshot_t *snapshot = malloc(sizeof(*snapshot) + size * sizeof(snapshot->entries[0]));
+    if (snapshot != NULL) {
+        snapshot->size = (size_t)size;
+        for (int i = 0; i < size; ++i) {
+            snapshot->entries[i] = celix_arrayList_get(instance->trackedServices, i);
+        }
+    } else {
+        fw_log(instance->context->framework->logger, CELIX_LOG_LEVEL_ERROR,
+               "Cannot allocate tracked services snapshot, use calls will lock the tracker [filter=%s]", instance->filter);
+    }
+    return __atomic_exchange_n(&instance->snapshot, snapshot, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * Waits till all snapshot readers which could have seen the replaced snapshot are done and frees it.
+ * Must be called without the instance lock, so that new snapshot readers and the use calls of the read locked
+ * fallback are not blocked while waiting.
+ *
+ * After this call tracked entries no longer in the current snapshot cannot be retained anymore.
+ */
+static void serviceTracker_retireSnapshot(celix_service_tracker_instance_t *instance, celix_tracked_snapshot_t *old) {
+    celixThreadMutex_lock(&instance->snapshotMutex);
+    __atomic_add_fetch(&instance->snapshotWaiters, 1, __ATOMIC_SEQ_CST);
+    //Flip the reader epoch and wait till the readers of the previous epoch are done. This is done twice, because a
+    //reader can read the epoch before a previous flip and only increase the reader count of that epoch after it.
+    for (int i = 0; i < 2; ++i) {
+        unsigned int epoch = __atomic_load_n(&instance->snapshotEpoch, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&instance->snapshotEpoch, 1 - epoch, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&instance->snapshotReaders[epoch], __ATOMIC_SEQ_CST) != 0) {
+            celixThreadCondition_wait(&instance->snapshotCond, &instance->snapshotMutex);
+        }
+    }
+    __atomic_sub_fetch(&instance->snapshotWaiters, 1, __ATOMIC_SEQ_CST);
+    celixThreadMutex_unlock(&instance->snapshotMutex);
+    free(old);
+}
+
+static inline celix_tracked_snapshot_t* serviceTracker_acquireSnapshot(celix_service_tracker_instance_t *instance, unsigned int *epochOut) {
+    unsigned int epoch = __atomic_load_n(&instance->snapshotEpoch, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&instance->snapshotReaders[epoch], 1, __ATOMIC_SEQ_CST);
+    *epochOut = epoch;
+    return __atomic_load_n(&instance->snapshot, __ATOMIC_SEQ_CST);
+}
+
+static inline void serviceTracker_releaseSnapshot(celix_service_tracker_instance_t *instance, unsigned int epoch) {
+    if (__atomic_sub_fetch(&instance->snapshotReaders[epoch], 1, __ATOMIC_SEQ_CST) == 0 &&
+        __atomic_load_n(&instance->snapshotWaiters, __ATOMIC_SEQ_CST) > 0) {
+        //last reader of the epoch and a snapshot is being retired -> wake up the retiring thread
+        celixThreadMutex_lock(&instance->snapshotMutex);
+        celixThreadCondition_broadcast(&instance->snapshotCond);
+        celixThreadMutex_unlock(&instance->snapshotMutex);
+    }
+}
+
+/**
+ * Returns the nr of entries of an acquired snapshot. If there is no snapshot, the snapshot is released and the
+ * instance lock is read locked instead and the nr of tracked services is returned.
+ */
+static inline size_t serviceTracker_snapshotSizeOrLock(celix_service_tracker_instance_t *instance, celix_tracked_snapshot_t *snapshot, unsigned int epoch) {
+    if (snapshot != NULL) {
+        return snapshot->size;
+    }
+    serviceTracker_releaseSnapshot(instance, epoch);
+    celixThreadRwlock_readLock(&instance->lock);
+    return (size_t)celix_arrayList_size(instance->trackedServices);
+}
+
+static inline celix_tracked_entry_t* serviceTracker_snapshotEntry(celix_service_tracker_instance_t *instance, celix_tracked_snapshot_t *snapshot, size_t index) {
+    return snapshot != NULL ? snapshot->entries[index] : celix_arrayList_get(instance->trackedServices, (int)index);
+}
+
+static inline void serviceTracker_releaseSnapshotOrUnlock(celix_service_tracker_instance_t *instance, celix_tracked_snapshot_t *snapshot, unsigned int epoch) {
+    if (snapshot != NULL) {
+        serviceTracker_releaseSnapshot(instance, epoch);
+    } else {
+        celixThreadRwlock_unlock(&instance->lock);
+    }
+}
+
 celix_status_t serviceTracker_create(bundle_context_pt context, const char * service, service_tracker_customizer_pt customizer, service_tracker_pt *tracker) {
 	celix_status_t status = CELIX_SUCCESS;
 
@@ -176,6 +286,9 @@ celix_status_t serviceTracker_open(service_tracker_pt tracker) {
 
         celixThreadRwlock_create(&instance->lock, NULL);
         instance->trackedServices = celix_arrayList_create();
+        instance->snapshot = calloc(1, sizeof(*instance->snapshot));
+        celixThreadMutex_create(&instance->snapshotMutex, NULL);
+        celixThreadCondition_init(&instance->snapshotCond, NULL);
 
         celixThreadMutex_create(&instance->mutex, NULL);
         instance->currentHighestServiceId = -1;
@@ -239,7 +352,9 @@ celix_status_t serviceTracker_close(service_tracker_pt tracker) {
                 trackedEntries[i] = (celix_tracked_entry_t *) arrayList_get(instance->trackedServices, i);
             }
             arrayList_clear(instance->trackedServices);
+            celix_tracked_snapshot_t *old = serviceTracker_publishSnapshot(instance);
             celixThreadRwlock_unlock(&instance->lock);
+            serviceTracker_retireSnapshot(instance, old);
 
             //loop trough tracked entries an untrack
             for (unsigned int i = 0u; i < size; i++) {
@@ -275,6 +390,9 @@ celix_status_t serviceTracker_close(service_tracker_pt tracker) {
         celixThreadMutex_destroy(&instance->mutex);
         celixThreadRwlock_destroy(&instance->lock);
         celix_arrayList_destroy(instance->trackedServices);
+        free(instance->snapshot);
+        celixThreadMutex_destroy(&instance->snapshotMutex);
+        celixThreadCondition_destroy(&instance->snapshotCond);
         free(instance->filter);
         free(instance);
 #endif
@@ -442,6 +560,73 @@ size_t serviceTracker_nrOfTrackedServices(service_tracker_t *tracker) {
     return result;
 }
 
+/**
+ * Adds the tracked entry to trackedServices on the position matching its ranking.
+ * Must be called with the instance lock write locked.
+ */
+static void serviceTracker_addSorted(celix_service_tracker_instance_t *instance, celix_tracked_entry_t *tracked) {
+    //binary search the insert position to keep the tracked services sorted on ranking
+    int low = 0;
+    int high = celix_arrayList_size(instance->trackedServices);
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        celix_tracked_entry_t *visit = celix_arrayList_get(instance->trackedServices, mid);
+        if (tracked_isRankedHigher(visit, tracked)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    arrayList_addIndex(instance->trackedServices, low, tracked);
+}
+
+/**
+ * Updates the properties and ranking of a tracked entry after a MODIFIED event and, if the ranking changed,
+ * moves the entry to its new position and updates the highest ranking service.
+ */
+static void serviceTracker_updateTracked(celix_service_tracker_instance_t *instance, service_reference_pt reference, celix_tracked_entry_t *tracked) {
+    service_registration_t *reg = NULL;
+    celix_properties_t *props = NULL;
+    serviceReference_getServiceRegistration(reference, &reg);
+    if (reg != NULL) {
+        serviceRegistration_getProperties(reg, &props);
+    }
+    if (props == NULL) {
+        return;
+    }
+
+    bool rankingChanged = false;
+    const char *serviceName = NULL;
+    celix_tracked_snapshot_t *old = NULL;
+    celixThreadRwlock_writeLock(&instance->lock);
+    int index = -1;
+    for (int i = 0; i < celix_arrayList_size(instance->trackedServices); ++i) {
+        if (celix_arrayList_get(instance->trackedServices, i) == tracked) {
+            index = i;
+            break;
+        }
+    }
+    if (index >= 0) { //note can already be untracked
+        //the replaced properties are kept by the registration till it is destroyed, so concurrent users can still access them
+        __atomic_store_n(&tracked->properties, props, __ATOMIC_RELEASE);
+        long ranking = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_RANKING, 0L);
+        if (ranking != tracked->serviceRanking) {
+            rankingChanged = true;
+            serviceName = tracked->serviceName;
+            celix_arrayList_removeAt(instance->trackedServices, index);
+            tracked->serviceRanking = ranking;
+            serviceTracker_addSorted(instance, tracked);
+            old = serviceTracker_publishSnapshot(instance);
+        }
+    }
+    celixThreadRwlock_unlock(&instance->lock);
+
+    if (rankingChanged) {
+        serviceTracker_retireSnapshot(instance, old);
+        serviceTracker_useHighestRankingServiceInternal(instance, serviceName, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
+    }
+}
+
 static celix_status_t serviceTracker_track(celix_service_tracker_instance_t *instance, service_reference_pt reference, celix_service_event_t *event) {
 	celix_status_t status = CELIX_SUCCESS;
 
@@ -463,7 +648,13 @@ static celix_status_t serviceTracker_track(celix_service_tracker_instance_t *ins
     }
     celixThreadRwlock_unlock(&instance->lock);
 
-    if (found == NULL) {
+    if (found != NULL) {
+        //already tracked, only the additional reference retain needs to be released
+        bundleContext_ungetServiceReference(instance->context, reference);
+        if (event != NULL && event->type == OSGI_FRAMEWORK_SERVICE_EVENT_MODIFIED) {
+            serviceTracker_updateTracked(instance, reference, found);
+        }
+    } else {
         //NEW entry
         void *service = NULL;
         status = serviceTracker_invokeAddingService(instance, reference, &service);
@@ -483,8 +674,10 @@ static celix_status_t serviceTracker_track(celix_service_tracker_instance_t *ins
             celix_tracked_entry_t *tracked = tracked_create(reference, service, props, bnd); //use count 1
 
             celixThreadRwlock_writeLock(&instance->lock);
-            arrayList_add(instance->trackedServices, tracked);
+            serviceTracker_addSorted(instance, tracked);
+            celix_tracked_snapshot_t *old = serviceTracker_publishSnapshot(instance);
             celixThreadRwlock_unlock(&instance->lock);
+            serviceTracker_retireSnapshot(instance, old);
 
             serviceTracker_invokeAddService(instance, tracked);
             serviceTracker_useHighestRankingServiceInternal(instance, tracked->serviceName, instance, NULL, NULL, serviceTracker_checkAndInvokeSetService);
@@ -599,7 +792,14 @@ static celix_status_t serviceTracker_untrack(celix_service_tracker_instance_t* i
         }
     }
     size = arrayList_size(instance->trackedServices); //updated size
+    celix_tracked_snapshot_t *old = NULL;
+    if (remove != NULL) {
+        old = serviceTracker_publishSnapshot(instance);
+    }
     celixThreadRwlock_unlock(&instance->lock);
+    if (remove != NULL) {
+        serviceTracker_retireSnapshot(instance, old);
+    }
 
     if (size == 0) {
         serviceTracker_checkAndInvokeSetService(instance, NULL, NULL, NULL);
@@ -789,31 +989,26 @@ static bool serviceTracker_useHighestRankingServiceInternal(celix_service_tracke
                                                             void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
                                                             void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)) {
     bool called = false;
-    celix_tracked_entry_t *tracked = NULL;
     celix_tracked_entry_t *highest = NULL;
-    long highestRank = 0;
-    unsigned int i;
-
-    //first lock tracker and get highest tracked entry
-    celixThreadRwlock_readLock(&instance->lock);
-    unsigned int size = arrayList_size(instance->trackedServices);
-
-    for (i = 0; i < size; i++) {
-        tracked = (celix_tracked_entry_t *) arrayList_get(instance->trackedServices, i);
-        if (serviceName != NULL && tracked->serviceName != NULL && strncmp(tracked->serviceName, serviceName, 10*1024) == 0) {
-            const char *val = properties_getWithDefault(tracked->properties, OSGI_FRAMEWORK_SERVICE_RANKING, "0");
-            long rank = strtol(val, NULL, 10);
-            if (highest == NULL || rank > highestRank) {
-                highest = tracked;
-            }
+    unsigned int epoch;
+
+    //first get highest tracked entry from the current snapshot, the snapshot is sorted on ranking so this is the
+    //first (matching) entry.
+    celix_tracked_snapshot_t *snapshot = serviceTracker_acquireSnapshot(instance, &epoch);
+    size_t size = serviceTracker_snapshotSizeOrLock(instance, snapshot, epoch);
+    for (size_t i = 0; i < size; i++) {
+        celix_tracked_entry_t *tracked = serviceTracker_snapshotEntry(instance, snapshot, i);
+        if (serviceName == NULL || (tracked->serviceName != NULL && strncmp(tracked->serviceName, serviceName, 10*1024) == 0)) {
+            highest = tracked;
+            break;
         }
     }
     if (highest != NULL) {
         //highest found lock tracked entry and increase use count
         tracked_retain(highest);
     }
-    //unlock tracker so that the tracked entry can be removed from the trackedServices list if unregistered.
-    celixThreadRwlock_unlock(&instance->lock);
+    //release the snapshot so that the tracked entry can be removed from the tracker if unregistered.
+    serviceTracker_releaseSnapshotOrUnlock(instance, snapshot, epoch);
 
     if (highest != NULL) {
         //got service, call, decrease use count an signal useCond after.
@@ -867,9 +1062,9 @@ bool celix_serviceTracker_useHighestRankingService(
     return called;
 }
 
-size_t celix_serviceTracker_useServices(
+static size_t serviceTracker_useServicesInternal(
         service_tracker_t *tracker,
-        const char* serviceName /*sanity*/,
+        size_t maxNrOfServices,
         void *callbackHandle,
         void (*use)(void *handle, void *svc),
         void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
@@ -878,21 +1073,24 @@ size_t celix_serviceTracker_useServices(
     celixThreadRwlock_readLock(&tracker->instanceLock);
     celix_service_tracker_instance_t *instance = tracker->instance;
     if (instance != NULL) {
-        //first lock tracker, get tracked entries and increase use count
-        celixThreadRwlock_readLock(&instance->lock);
-        int size = celix_arrayList_size(instance->trackedServices);
-        count = (size_t)size;
-        celix_tracked_entry_t *entries[size];
-        for (int i = 0; i < size; i++) {
-            celix_tracked_entry_t *tracked = (celix_tracked_entry_t *) arrayList_get(instance->trackedServices, i);
+        //first get tracked entries from the current snapshot and increase use count.
+        //note that the snapshot is sorted on ranking, so the first maxNrOfServices entries are the top ranked.
+        unsigned int epoch;
+        celix_tracked_snapshot_t *snapshot = serviceTracker_acquireSnapshot(instance, &epoch);
+        size_t size = serviceTracker_snapshotSizeOrLock(instance, snapshot, epoch);
+        size = size < maxNrOfServices ? size : maxNrOfServices;
+        count = size;
+        celix_tracked_entry_t *entries[size == 0 ? 1 : size];
+        for (size_t i = 0; i < size; i++) {
+            celix_tracked_entry_t *tracked = serviceTracker_snapshotEntry(instance, snapshot, i);
             tracked_retain(tracked);
             entries[i] = tracked;
         }
-        //unlock tracker so that the tracked entry can be removed from the trackedServices list if unregistered.
-        celixThreadRwlock_unlock(&instance->lock);
+        //release the snapshot so that the tracked entries can be removed from the tracker if unregistered.
+        serviceTracker_releaseSnapshotOrUnlock(instance, snapshot, epoch);
 
         //then use entries and decrease use count
-        for (int i = 0; i < size; i++) {
+        for (size_t i = 0; i < size; i++) {
             celix_tracked_entry_t *entry = entries[i];
             //got service, call, decrease use count an signal useCond after.
             if (use != NULL) {
@@ -912,6 +1110,26 @@ size_t celix_serviceTracker_useServices(
     return count;
 }
 
+size_t celix_serviceTracker_useServices(
+        service_tracker_t *tracker,
+        const char* serviceName __attribute__((unused)) /*sanity*/,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc),
+        void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
+        void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)) {
+    return serviceTracker_useServicesInternal(tracker, SIZE_MAX, callbackHandle, use, useWithProperties, useWithOwner);
+}
+
+size_t celix_serviceTracker_useTopRankedServices(
+        service_tracker_t *tracker,
+        size_t maxNrOfServices,
+        void *callbackHandle,
+        void (*use)(void *handle, void *svc),
+        void (*useWithProperties)(void *handle, void *svc, const celix_properties_t *props),
+        void (*useWithOwner)(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner)) {
+    return serviceTracker_useServicesInternal(tracker, maxNrOfServices, callbackHandle, use, useWithProperties, useWithOwner);
+}
+
 void celix_serviceTracker_syncForFramework(void *fw) {
     celixThread_once(&g_once, serviceTracker_once);
     celixThreadMutex_lock(&g_shutdownMutex);
@@ -1005,6 +1223,9 @@ static void* shutdownServiceTrackerInstanceHandler(void *data) {
     celixThreadMutex_destroy(&instance->mutex);
     celixThreadRwlock_destroy(&instance->lock);
     celix_arrayList_destroy(instance->trackedServices);
+    free(instance->snapshot);
+    celixThreadMutex_destroy(&instance->snapshotMutex);
+    celixThreadCondition_destroy(&instance->snapshotCond);
     free(instance->filter);
 
     serviceTracker_remInstanceFromShutdownList(instance);
@@ -54,7 +54,20 @@ typedef struct celix_service_tracker_instance {
 	void (*modifiedWithOwner)(void *handle, void *svc, const properties_t *props, const bundle_t *owner);
 
 	celix_thread_rwlock_t lock; //projects trackedServices
-	array_list_t *trackedServices;
+	array_list_t *trackedServices; //sorted on ranking, highest ranking (and lowest service id for equal rankings) first
+
+	/*
+	 * Immutable copy of trackedServices used by the use calls, so that these do not need to lock the tracker.
+	 * Replaced (with the lock write locked) every time trackedServices changes. A replaced snapshot is only freed
+	 * after all snapshot readers which could have seen it are done (see serviceTracker_retireSnapshot).
+	 * NULL if the snapshot could not be allocated, the use calls then read lock the tracker.
+	 */
+	struct celix_tracked_snapshot *snapshot;
+	unsigned int snapshotEpoch; //index of snapshotReaders used by new snapshot readers
+	size_t snapshotReaders[2];
+	size_t snapshotWaiters; //nr of threads waiting for snapshot readers (atomic)
+	celix_thread_mutex_t snapshotMutex; //serializes retiring snapshots
+	celix_thread_cond_t snapshotCond; //signaled when the snapshot readers of an epoch are done and there are waiters
 
 	celix_thread_mutex_t mutex; //protect current highest service id
 	long currentHighestServiceId;
@@ -89,18 +102,33 @@ struct celix_serviceTracker {
 	celix_thread_rwlock_t instanceLock;
 	celix_service_tracker_instance_t *instance; /*NULL -> close, !NULL->open*/
 
+	/*
+	 * Nr of active celix_bundleContext_useTrackedService(s) calls (atomic). The bundle context sets stopping (atomic)
+	 * when it stops the tracker and then waits till useCount is 0, only the release of the last use of a stopping
+	 * tracker locks the bundle context mutex.
+	 */
+	size_t useCount;
+	bool stopping;
+
 };
 
+typedef struct celix_tracked_snapshot {
+	size_t size;
+	struct celix_tracked_entry *entries[];
+} celix_tracked_snapshot_t;
+
 typedef struct celix_tracked_entry {
 	service_reference_pt reference;
 	void *service;
 	const char *serviceName;
 	properties_t *properties;
 	bundle_t *serviceOwner;
+	long serviceId;
+	long serviceRanking;
 
-    celix_thread_mutex_t mutex; //protects useCount
+    size_t useCount; //atomic, only the release of the last use is done with the mutex locked.
+    celix_thread_mutex_t mutex; //used for waiting till useCount is 0
 	celix_thread_cond_t useCond;
-    size_t useCount;
 } celix_tracked_entry_t;
 
 
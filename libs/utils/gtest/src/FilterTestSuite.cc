@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "celix_filter.h"
+#include "celix_properties.h"
+#include "celix_version.h"
+
+class FilterTestSuite : public ::testing::Test {};
+
+static bool matches(const char* filterStr, const celix_properties_t* props) {
+    celix_filter_t* filter = celix_filter_create(filterStr);
+    EXPECT_TRUE(filter != nullptr) << "Cannot create filter " << filterStr;
+    bool result = celix_filter_match(filter, props);
+    celix_filter_destroy(filter);
+    return result;
+}
+
+TEST_F(FilterTestSuite, MatchTypedOperands) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "long", "9");
+    celix_properties_set(props, "negative", "-42");
+    celix_properties_set(props, "double", "2.5");
+    celix_properties_set(props, "version", "1.10.0");
+    celix_properties_set(props, "str", "bcd");
+
+    //numeric compare instead of lexical compare ("9" > "10" lexical, 9 < 10 numeric)
+    EXPECT_TRUE(matches("(long<10)", props));
+    EXPECT_FALSE(matches("(long>10)", props));
+    EXPECT_TRUE(matches("(long>=9)", props));
+    EXPECT_TRUE(matches("(long<=9)", props));
+    EXPECT_TRUE(matches("(negative<-5)", props));
+    EXPECT_FALSE(matches("(negative>=-5)", props));
+
+    EXPECT_TRUE(matches("(double>2.25)", props));
+    EXPECT_TRUE(matches("(double<10.0)", props));
+    EXPECT_FALSE(matches("(double>=2.75)", props));
+
+    //version compare ("1.10.0" < "1.9.0" lexical)
+    EXPECT_TRUE(matches("(version>1.9.0)", props));
+    EXPECT_TRUE(matches("(version>=1.10.0)", props));
+    EXPECT_FALSE(matches("(version<1.2.3)", props));
+    EXPECT_TRUE(matches("(version<2.0.0.beta)", props));
+
+    //string compare if both values are strings
+    EXPECT_TRUE(matches("(str>abc)", props));
+    EXPECT_FALSE(matches("(str<abc)", props));
+
+    //a compare of a number or version with a string never matches
+    EXPECT_FALSE(matches("(str>10)", props));
+    EXPECT_FALSE(matches("(str<10)", props));
+    EXPECT_FALSE(matches("(str>=1.0.0)", props));
+    EXPECT_FALSE(matches("(long>abc)", props));
+    EXPECT_FALSE(matches("(long<abc)", props));
+    EXPECT_FALSE(matches("(version<abc)", props));
+
+    //a number can be compared with a version
+    EXPECT_TRUE(matches("(version>1)", props));
+    EXPECT_TRUE(matches("(version<1.11)", props));
+    EXPECT_TRUE(matches("(long<9.1.0)", props));
+
+    //missing attribute never matches
+    EXPECT_FALSE(matches("(missing<10)", props));
+    EXPECT_FALSE(matches("(missing>=1.0.0)", props));
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(FilterTestSuite, MatchEmptyAndOr) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "name", "value");
+
+    EXPECT_TRUE(matches("(&)", props));
+    EXPECT_FALSE(matches("(|)", props));
+    EXPECT_TRUE(matches("(&)", nullptr));
+    EXPECT_TRUE(matches("(|(&)(name=other))", props));
+    EXPECT_FALSE(matches("(&(|)(name=value))", props));
+    EXPECT_TRUE(matches("(!(|))", props));
+    EXPECT_EQ(nullptr, celix_filter_create("(!)"));
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(FilterTestSuite, VersionParsingIsConsistent) {
+    //filter version operands and celix_version accept the same version strings
+    for (const char* str : {"1..3", "1.2.", ".1", "1.2.3.", "1.2.3.a|b", ""}) {
+        EXPECT_EQ(nullptr, celix_version_createVersionFromString(str)) << str;
+    }
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "version", "1.10.0");
+    EXPECT_FALSE(matches("(version>1..3)", props)); //string operand, no version compare
+    EXPECT_TRUE(matches("(version>1.3)", props));
+    celix_properties_destroy(props);
+}
+
+TEST_F(FilterTestSuite, MatchSubstring) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "name", "celix_framework_bundle");
+
+    EXPECT_TRUE(matches("(name=celix*)", props));
+    EXPECT_TRUE(matches("(name=*bundle)", props));
+    EXPECT_TRUE(matches("(name=*framework*)", props));
+    EXPECT_TRUE(matches("(name=celix*framework*bundle)", props));
+    EXPECT_TRUE(matches("(name=c*_*_*e)", props));
+    EXPECT_FALSE(matches("(name=framework*)", props));
+    EXPECT_FALSE(matches("(name=*celix)", props));
+    EXPECT_FALSE(matches("(name=celix*bundle*framework)", props));
+    EXPECT_FALSE(matches("(name=celix*notPresent*)", props));
+    EXPECT_FALSE(matches("(name=celix_framework_bundle_too_long*)", props));
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(FilterTestSuite, MatchCompositeAndSubFilters) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "objectClass", "my_service");
+    celix_properties_set(props, "service.ranking", "10");
+    celix_properties_set(props, "service.version", "1.2.0");
+
+    const char* filterStr = "(&(objectClass=my_service)(|(service.ranking>100)(service.version>=1.1))(!(disabled=*)))";
+    celix_filter_t* filter = celix_filter_create(filterStr);
+    ASSERT_TRUE(filter != nullptr);
+    EXPECT_TRUE(celix_filter_match(filter, props));
+
+    //sub filters (not compiled) still match the same way
+    ASSERT_EQ(3, celix_arrayList_size(filter->children));
+    auto* orFilter = (celix_filter_t*)celix_arrayList_get(filter->children, 1);
+    EXPECT_TRUE(celix_filter_match(orFilter, props));
+    auto* notFilter = (celix_filter_t*)celix_arrayList_get(filter->children, 2);
+    EXPECT_TRUE(celix_filter_match(notFilter, props));
+
+    celix_properties_set(props, "disabled", "true");
+    EXPECT_FALSE(celix_filter_match(filter, props));
+    EXPECT_FALSE(celix_filter_match(notFilter, props));
+    celix_properties_unset(props, "disabled");
+
+    celix_properties_set(props, "service.version", "1.0.9");
+    EXPECT_FALSE(celix_filter_match(filter, props));
+    EXPECT_FALSE(celix_filter_match(orFilter, props));
+
+    EXPECT_FALSE(celix_filter_match(filter, nullptr));
+
+    celix_filter_destroy(filter);
+    celix_properties_destroy(props);
+}
+
+TEST_F(FilterTestSuite, MatchFilter_Benchmark) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "objectClass", "my_service");
+    celix_properties_set(props, "service.id", "42");
+    celix_properties_set(props, "service.ranking", "10");
+    celix_properties_set(props, "service.version", "1.2.0");
+    celix_properties_set(props, "service.lang", "C");
+    celix_properties_set(props, "name", "my_service_instance");
+
+    const char* filterStr = "(&(objectClass=my_service)(service.lang=C)(service.ranking>=10)(service.id<99)"
+                            "(|(service.version>=1.1.0)(name=my_service*))(!(disabled=*)))";
+    celix_filter_t* filter = celix_filter_create(filterStr);
+    ASSERT_TRUE(filter != nullptr);
+
+    const int nrOfMatches = 1000000;
+    int count = 0;
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < nrOfMatches; ++i) {
+        if (celix_filter_match(filter, props)) {
+            ++count;
+        }
+    }
+    auto end = std::chrono::system_clock::now();
+    EXPECT_EQ(nrOfMatches, count);
+
+    auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << "Matching filter " << nrOfMatches << " times took " << total / 1000 << " µs (" << total / nrOfMatches << " ns per match)\n";
+
+    celix_filter_destroy(filter);
+    celix_properties_destroy(props);
+}
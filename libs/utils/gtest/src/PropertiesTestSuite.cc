@@ -0,0 +1,301 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <functional>
+#include <malloc.h>
+
+#include "celix_properties.h"
+
+class PropertiesTestSuite : public ::testing::Test {
+public:
+    static celix_properties_t* createServiceLikeProperties() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, "objectClass", "my_service");
+        celix_properties_set(props, "service.id", "42");
+        celix_properties_set(props, "service.bundleid", "3");
+        celix_properties_set(props, "service.scope", "singleton");
+        celix_properties_set(props, "service.ranking", "10");
+        celix_properties_set(props, "service.version", "1.2.0");
+        celix_properties_set(props, "service.lang", "C");
+        celix_properties_set(props, "name", "my_service_instance_with_a_somewhat_longer_name");
+        return props;
+    }
+
+    static void benchmark(const char* name, int count, const std::function<void()>& fn) {
+        auto start = std::chrono::system_clock::now();
+        for (int i = 0; i < count; ++i) {
+            fn();
+        }
+        auto end = std::chrono::system_clock::now();
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        std::cout << name << " " << count << " times took " << total / 1000 << " µs (" << total / count << " ns per call)\n";
+    }
+};
+
+TEST_F(PropertiesTestSuite, SetGetUnsetTest) {
+    auto* props = celix_properties_create();
+    EXPECT_EQ(0, celix_properties_size(props));
+
+    const int nrOfEntries = 1000; //forces resizing and use of heap allocated strings
+    for (int i = 0; i < nrOfEntries; ++i) {
+        std::string key = "key" + std::to_string(i);
+        std::string val = "value" + std::to_string(i) + std::string(i % 50, 'x');
+        celix_properties_set(props, key.c_str(), val.c_str());
+    }
+    EXPECT_EQ(nrOfEntries, celix_properties_size(props));
+    for (int i = 0; i < nrOfEntries; ++i) {
+        std::string key = "key" + std::to_string(i);
+        std::string val = "value" + std::to_string(i) + std::string(i % 50, 'x');
+        EXPECT_STREQ(val.c_str(), celix_properties_get(props, key.c_str(), nullptr));
+    }
+
+    //overwrite
+    celix_properties_set(props, "key1", "overwritten");
+    EXPECT_STREQ("overwritten", celix_properties_get(props, "key1", nullptr));
+    EXPECT_EQ(nrOfEntries, celix_properties_size(props));
+
+    //unset every other entry
+    for (int i = 0; i < nrOfEntries; i += 2) {
+        std::string key = "key" + std::to_string(i);
+        celix_properties_unset(props, key.c_str());
+    }
+    EXPECT_EQ(nrOfEntries / 2, celix_properties_size(props));
+    for (int i = 0; i < nrOfEntries; ++i) {
+        std::string key = "key" + std::to_string(i);
+        const char* val = celix_properties_get(props, key.c_str(), nullptr);
+        if (i % 2 == 0) {
+            EXPECT_EQ(nullptr, val);
+        } else {
+            EXPECT_NE(nullptr, val);
+        }
+    }
+    celix_properties_unset(props, "notPresent");
+    EXPECT_STREQ("default", celix_properties_get(props, "notPresent", "default"));
+
+    int count = 0;
+    const char* key;
+    CELIX_PROPERTIES_FOR_EACH(props, key) {
+        EXPECT_NE(nullptr, celix_properties_get(props, key, nullptr));
+        ++count;
+    }
+    EXPECT_EQ(nrOfEntries / 2, count);
+
+    auto* copy = celix_properties_copy(props);
+    EXPECT_EQ(nrOfEntries / 2, celix_properties_size(copy));
+    EXPECT_STREQ("overwritten", celix_properties_get(copy, "key1", nullptr));
+    celix_properties_destroy(copy);
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, SetWithoutCopyTest) {
+    auto* props = celix_properties_create();
+    celix_properties_setWithoutCopy(props, strdup("key"), strdup("value1"));
+    EXPECT_STREQ("value1", celix_properties_get(props, "key", nullptr));
+    celix_properties_setWithoutCopy(props, strdup("key"), strdup("value2"));
+    EXPECT_STREQ("value2", celix_properties_get(props, "key", nullptr));
+    EXPECT_EQ(1, celix_properties_size(props));
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, TypedGetTest) {
+    auto* props = celix_properties_create();
+    celix_properties_setLong(props, "long", 42);
+    celix_properties_set(props, "negativeLong", "-3");
+    celix_properties_set(props, "partialLong", "10abc");
+    celix_properties_setDouble(props, "double", 2.5);
+    celix_properties_set(props, "exponent", "1e3");
+    celix_properties_setBool(props, "true", true);
+    celix_properties_set(props, "false", "FALSE");
+    celix_properties_set(props, "trueish", " true and more");
+    celix_properties_set(props, "version", "1.2.3.qualifier");
+    celix_properties_set(props, "str", "string");
+
+    EXPECT_EQ(42, celix_properties_getAsLong(props, "long", -1));
+    EXPECT_EQ(-3, celix_properties_getAsLong(props, "negativeLong", -1));
+    EXPECT_EQ(10, celix_properties_getAsLong(props, "partialLong", -1));
+    EXPECT_EQ(2, celix_properties_getAsLong(props, "double", -1));
+    EXPECT_EQ(-1, celix_properties_getAsLong(props, "str", -1));
+    EXPECT_EQ(-1, celix_properties_getAsLong(props, "notPresent", -1));
+
+    EXPECT_DOUBLE_EQ(2.5, celix_properties_getAsDouble(props, "double", -1.0));
+    EXPECT_DOUBLE_EQ(42.0, celix_properties_getAsDouble(props, "long", -1.0));
+    EXPECT_DOUBLE_EQ(1000.0, celix_properties_getAsDouble(props, "exponent", -1.0));
+    EXPECT_DOUBLE_EQ(-1.0, celix_properties_getAsDouble(props, "str", -1.0));
+
+    EXPECT_TRUE(celix_properties_getAsBool(props, "true", false));
+    EXPECT_FALSE(celix_properties_getAsBool(props, "false", true));
+    EXPECT_TRUE(celix_properties_getAsBool(props, "trueish", false));
+    EXPECT_TRUE(celix_properties_getAsBool(props, "str", true));
+    EXPECT_FALSE(celix_properties_getAsBool(props, "notPresent", false));
+
+    //overwriting a value also updates the typed value
+    celix_properties_set(props, "long", "43");
+    EXPECT_EQ(43, celix_properties_getAsLong(props, "long", -1));
+    celix_properties_set(props, "long", "no longer a long");
+    EXPECT_EQ(-1, celix_properties_getAsLong(props, "long", -1));
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, GetEntryTest) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "long", "-42");
+    celix_properties_set(props, "double", "1.5");
+    celix_properties_set(props, "bool", "True");
+    celix_properties_set(props, "version", "1.2.3.qualifier");
+    celix_properties_set(props, "str", "10 apples");
+
+    auto* entry = celix_properties_getEntry(props, "long");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_STREQ("-42", entry->value);
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_LONG, entry->valueType);
+    EXPECT_EQ(-42, entry->typed.longValue);
+
+    entry = celix_properties_getEntry(props, "double");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_DOUBLE, entry->valueType);
+    EXPECT_DOUBLE_EQ(1.5, entry->typed.doubleValue);
+
+    entry = celix_properties_getEntry(props, "bool");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_BOOL, entry->valueType);
+    EXPECT_TRUE(entry->typed.boolValue);
+
+    entry = celix_properties_getEntry(props, "version");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_VERSION, entry->valueType);
+    EXPECT_EQ(2, celix_version_getMinor(entry->typed.versionValue));
+
+    entry = celix_properties_getEntry(props, "str");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(CELIX_PROPERTIES_VALUE_TYPE_STRING, entry->valueType);
+
+    EXPECT_EQ(nullptr, celix_properties_getEntry(props, "notPresent"));
+
+    const celix_version_t* version = celix_properties_getAsVersion(props, "version", nullptr);
+    ASSERT_NE(nullptr, version);
+    EXPECT_EQ(1, celix_version_getMajor(version));
+    EXPECT_EQ(3, celix_version_getMicro(version));
+    EXPECT_STREQ("qualifier", celix_version_getQualifier(version));
+    EXPECT_EQ(nullptr, celix_properties_getAsVersion(props, "str", nullptr));
+
+    //typed values are also copied
+    auto* copy = celix_properties_copy(props);
+    version = celix_properties_getAsVersion(copy, "version", nullptr);
+    ASSERT_NE(nullptr, version);
+    EXPECT_EQ(1, celix_version_getMajor(version));
+    EXPECT_EQ(-42, celix_properties_getAsLong(copy, "long", 0));
+    celix_properties_destroy(copy);
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, StoreTest) {
+    const char* file = "properties_store_test.properties";
+    auto* props = createServiceLikeProperties();
+    EXPECT_EQ(CELIX_SUCCESS, celix_properties_store(props, file, nullptr));
+    auto* loaded = celix_properties_load(file);
+    ASSERT_NE(nullptr, loaded);
+    EXPECT_EQ(celix_properties_size(props), celix_properties_size(loaded));
+    EXPECT_STREQ("my_service", celix_properties_get(loaded, "objectClass", nullptr));
+    celix_properties_destroy(loaded);
+    remove(file);
+
+    EXPECT_EQ(CELIX_FILE_IO_EXCEPTION, celix_properties_store(props, "non_existing_dir/test.properties", nullptr));
+    EXPECT_EQ(CELIX_FILE_IO_EXCEPTION, celix_properties_store(props, "/dev/full", nullptr));
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, RepeatedSetUnsetMemoryBoundedTest) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    auto* props = createServiceLikeProperties();
+    auto updateLoop = [props](int count) {
+        for (int i = 0; i < count; ++i) {
+            std::string key = "key" + std::to_string(i % 16);
+            celix_properties_set(props, key.c_str(), "initial value");
+            celix_properties_set(props, key.c_str(), std::to_string(i).c_str());
+            celix_properties_setLong(props, "service.ranking", i);
+            if (i % 2 == 0) {
+                celix_properties_unset(props, key.c_str());
+            }
+        }
+        for (int i = 0; i < 16; ++i) {
+            celix_properties_unset(props, ("key" + std::to_string(i)).c_str());
+        }
+    };
+    updateLoop(1000); //warm up
+    size_t before = mallinfo2().uordblks;
+    updateLoop(100000);
+    size_t after = mallinfo2().uordblks;
+    EXPECT_EQ(8, celix_properties_size(props));
+    EXPECT_EQ(99999, celix_properties_getAsLong(props, "service.ranking", -1));
+    EXPECT_LT(after, before + 16 * 1024);
+    celix_properties_destroy(props);
+#else
+    GTEST_SKIP() << "mallinfo2 not available";
+#endif
+}
+
+TEST_F(PropertiesTestSuite, Create_Benchmark) {
+    benchmark("Creating and destroying service properties", 100000, []{
+        auto* props = createServiceLikeProperties();
+        celix_properties_destroy(props);
+    });
+}
+
+TEST_F(PropertiesTestSuite, Copy_Benchmark) {
+    auto* props = createServiceLikeProperties();
+    benchmark("Copying service properties", 100000, [props]{
+        auto* copy = celix_properties_copy(props);
+        celix_properties_destroy(copy);
+    });
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, Get_Benchmark) {
+    auto* props = createServiceLikeProperties();
+    long sum = 0;
+    benchmark("Getting a service property", 1000000, [props, &sum]{
+        sum += celix_properties_get(props, "service.lang", nullptr)[0];
+    });
+    benchmark("Getting a service property as long", 1000000, [props, &sum]{
+        sum += celix_properties_getAsLong(props, "service.ranking", 0);
+    });
+    EXPECT_EQ(1000000L * 'C' + 1000000L * 10, sum);
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, Iterate_Benchmark) {
+    auto* props = createServiceLikeProperties();
+    int count = 0;
+    benchmark("Iterating over service properties", 1000000, [props, &count]{
+        const char* key;
+        CELIX_PROPERTIES_FOR_EACH(props, key) {
+            ++count;
+        }
+    });
+    EXPECT_EQ(8 * 1000000, count);
+    celix_properties_destroy(props);
+}
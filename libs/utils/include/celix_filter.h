@@ -44,6 +44,8 @@ typedef enum celix_filter_operand_enum
 
 typedef struct celix_filter_struct celix_filter_t;
 
+typedef struct celix_filter_internal celix_filter_internal_t;
+
 struct celix_filter_struct {
     celix_filter_operand_t operand;
     const char *attribute; //NULL for operands AND, OR ot NOT
@@ -53,6 +55,10 @@ struct celix_filter_struct {
     //type is celix_filter_t* for AND, OR and NOT operator and char* for SUBSTRING
     //for other operands children is NULL
     celix_array_list_t *children;
+
+    //compiled form of the filter (typed operands and flattened instructions).
+    //only set for filters created with celix_filter_create; for internal use only.
+    celix_filter_internal_t *internal;
 };
 
 
@@ -21,6 +21,7 @@
 
 #include "hash_map.h"
 #include "exports.h"
+#include "celix_version.h"
 #include "celix_errno.h"
 
 #ifndef CELIX_PROPERTIES_H_
@@ -30,8 +31,39 @@
 extern "C" {
 #endif
 
-typedef hash_map_t celix_properties_t;
-typedef hash_map_iterator_t celix_properties_iterator_t;
+typedef struct celix_properties celix_properties_t; //opaque struct type
+
+typedef struct celix_properties_iterator {
+    //private data
+    const celix_properties_t *_props;
+    unsigned int _index;
+} celix_properties_iterator_t;
+
+/**
+ * The type a property value string can be (completely) converted to.
+ * Determined once when the property is set.
+ */
+typedef enum celix_properties_value_type {
+    CELIX_PROPERTIES_VALUE_TYPE_STRING = 0,
+    CELIX_PROPERTIES_VALUE_TYPE_LONG,
+    CELIX_PROPERTIES_VALUE_TYPE_DOUBLE,
+    CELIX_PROPERTIES_VALUE_TYPE_BOOL,
+    CELIX_PROPERTIES_VALUE_TYPE_VERSION,
+} celix_properties_value_type_e;
+
+/**
+ * A property entry: the property value and - if the value can be converted - the cached typed value.
+ */
+typedef struct celix_properties_entry {
+    const char *value;
+    celix_properties_value_type_e valueType;
+    union {
+        long longValue; //for CELIX_PROPERTIES_VALUE_TYPE_LONG
+        double doubleValue; //for CELIX_PROPERTIES_VALUE_TYPE_DOUBLE
+        bool boolValue; //for CELIX_PROPERTIES_VALUE_TYPE_BOOL
+        const celix_version_t *versionValue; //for CELIX_PROPERTIES_VALUE_TYPE_VERSION
+    } typed;
+} celix_properties_entry_t;
 
 
 /**********************************************************************************************************************
@@ -50,10 +82,21 @@ celix_properties_t* celix_properties_loadWithStream(FILE *stream);
 
 celix_properties_t* celix_properties_loadFromString(const char *input);
 
-void celix_properties_store(celix_properties_t *properties, const char *file, const char *header);
+/**
+ * Stores the properties in file.
+ * @return CELIX_SUCCESS, or CELIX_FILE_IO_EXCEPTION if the file cannot be opened or (completely) written.
+ */
+celix_status_t celix_properties_store(celix_properties_t *properties, const char *file, const char *header);
 
 const char* celix_properties_get(const celix_properties_t *properties, const char *key, const char *defaultValue);
 
+/**
+ * Returns the property entry (value and cached typed value) for the provided key.
+ * The entry is valid until the property is set or unset again.
+ * @return The entry or NULL if the key is not present.
+ */
+const celix_properties_entry_t* celix_properties_getEntry(const celix_properties_t *properties, const char *key);
+
 void celix_properties_set(celix_properties_t *properties, const char *key, const char *value);
 
 void celix_properties_setWithoutCopy(celix_properties_t *properties, char *key, char *value);
@@ -72,6 +115,15 @@ void celix_properties_setBool(celix_properties_t *props, const char *key, bool v
 void celix_properties_setDouble(celix_properties_t *props, const char *key, double val);
 double celix_properties_getAsDouble(const celix_properties_t *props, const char *key, double defaultValue);
 
+/**
+ * Returns the property value as version.
+ * The returned version is owned by the properties and valid until the property is set or unset again.
+ * Note that only values with a micro part or qualifier (e.g. "1.2.3") are cached as version,
+ * values like "1" or "1.2" are cached as long and double.
+ * @return The version or defaultValue if the key is not present or the value is not a version.
+ */
+const celix_version_t* celix_properties_getAsVersion(const celix_properties_t *props, const char *key, const celix_version_t *defaultValue);
+
 int celix_properties_size(const celix_properties_t *properties);
 
 celix_properties_iterator_t celix_propertiesIterator_construct(const celix_properties_t *properties);
@@ -79,7 +131,7 @@ bool celix_propertiesIterator_hasNext(celix_properties_iterator_t *iter);
 const char* celix_propertiesIterator_nextKey(celix_properties_iterator_t *iter);
 
 #define CELIX_PROPERTIES_FOR_EACH(props, key) \
-    for(hash_map_iterator_t iter = celix_propertiesIterator_construct(props); \
+    for(celix_properties_iterator_t iter = celix_propertiesIterator_construct(props); \
         celix_propertiesIterator_hasNext(&iter), (key) = celix_propertiesIterator_nextKey(&iter);)
 
 
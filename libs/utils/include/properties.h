@@ -44,8 +44,15 @@ extern "C" {
 #define CELIX_DEPRECATED_ATTR
 #endif
 
-typedef hash_map_pt properties_pt CELIX_DEPRECATED_ATTR;
-typedef hash_map_t properties_t CELIX_DEPRECATED_ATTR;
+/**
+ * Deprecated, use celix_properties_t.
+ * Note that properties_pt and properties_t are no longer a hash_map_pt / hash_map_t. Code which uses the hash map
+ * API (e.g. hashMap_get, hashMap_remove or hash map iterators) on properties must be migrated to the properties API
+ * (celix_properties_get, celix_properties_unset, CELIX_PROPERTIES_FOR_EACH).
+ * This is a source and binary incompatible change.
+ */
+typedef struct celix_properties* properties_pt CELIX_DEPRECATED_ATTR;
+typedef struct celix_properties properties_t CELIX_DEPRECATED_ATTR;
 
 UTILS_EXPORT celix_properties_t* properties_create(void);
 
@@ -70,8 +77,8 @@ UTILS_EXPORT void properties_unset(celix_properties_t *properties, const char *k
 UTILS_EXPORT celix_status_t properties_copy(celix_properties_t *properties, celix_properties_t **copy);
 
 #define PROPERTIES_FOR_EACH(props, key) \
-    for(hash_map_iterator_t iter = hashMapIterator_construct(props); \
-        hashMapIterator_hasNext(&iter), (key) = (const char*)hashMapIterator_nextKey(&iter);)
+    for(celix_properties_iterator_t iter = celix_propertiesIterator_construct(props); \
+        celix_propertiesIterator_hasNext(&iter), (key) = celix_propertiesIterator_nextKey(&iter);)
 
 
 #ifdef __cplusplus
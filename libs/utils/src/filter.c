@@ -22,11 +22,14 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
 #include <utils.h>
 
 #include "celix_filter.h"
 #include "filter.h"
 #include "celix_errno.h"
+#include "version_private.h"
 
 static void filter_skipWhiteSpace(char* filterString, int* pos);
 static celix_filter_t * filter_parseFilter(char* filterString, int* pos);
@@ -38,7 +41,44 @@ static char * filter_parseAttr(char* filterString, int* pos);
 static char * filter_parseValue(char* filterString, int* pos);
 static celix_array_list_t* filter_parseSubstring(char* filterString, int* pos);
 
-static celix_status_t filter_compare(const celix_filter_t* filter, const char *propertyValue, bool *result);
+typedef enum celix_filter_value_type {
+    CELIX_FILTER_VALUE_TYPE_STRING,
+    CELIX_FILTER_VALUE_TYPE_LONG,
+    CELIX_FILTER_VALUE_TYPE_DOUBLE,
+    CELIX_FILTER_VALUE_TYPE_VERSION,
+} celix_filter_value_type_e;
+
+typedef struct celix_filter_version_parts {
+    int major;
+    int minor;
+    int micro;
+    const char *qualifier; //points into the parsed string
+} celix_filter_version_parts_t;
+
+typedef struct celix_filter_instruction {
+    celix_filter_operand_t operand;
+    unsigned int next; //index of the first instruction after this (sub)filter
+    unsigned int nrOfChildren; //for AND, OR and NOT. The children directly follow the parent instruction.
+    const char *attribute; //NULL for AND, OR and NOT
+    const char *value;
+    const celix_array_list_t *substrings; //for SUBSTRING, type is char*. NULL entries are wildcards
+    celix_filter_value_type_e valueType; //for GREATER, GREATEREQUAL, LESS and LESSEQUAL
+    long longValue;
+    double doubleValue;
+    bool hasVersionValue; //a long or double value can also be a version (e.g. "1" or "1.2")
+    celix_filter_version_parts_t versionValue;
+} celix_filter_instruction_t;
+
+struct celix_filter_internal {
+    unsigned int nrOfInstructions;
+    celix_filter_instruction_t *instructions;
+};
+
+static celix_filter_internal_t* filter_compile(const celix_filter_t *filter);
+static void filter_destroyInternal(celix_filter_internal_t *internal);
+static void filter_initInstruction(const celix_filter_t *filter, celix_filter_instruction_t *ins);
+static bool filter_matchLeaf(const celix_filter_instruction_t *ins, const celix_properties_t *properties);
+static bool filter_matchInstructions(const celix_filter_instruction_t *instructions, unsigned int index, const celix_properties_t *properties);
 
 static void filter_skipWhiteSpace(char * filterString, int * pos) {
     int length;
@@ -109,11 +149,12 @@ static celix_filter_t * filter_parseAndOrOr(char * filterString, celix_filter_op
     filter_skipWhiteSpace(filterString, pos);
     bool failure = false;
 
-    if (filterString[*pos] != '(') {
+    if (filterString[*pos] != '(' && filterString[*pos] != ')') {
         fprintf(stderr, "Filter Error: Missing '('.\n");
         return NULL;
     }
 
+    //note an empty AND "(&)" always matches and an empty OR "(|)" never matches
     celix_array_list_t *children = celix_arrayList_create();
     while(filterString[*pos] == '(') {
         celix_filter_t * child = filter_parseFilter(filterString, pos);
@@ -412,104 +453,304 @@ celix_status_t filter_match(celix_filter_t * filter, celix_properties_t *propert
     return CELIX_SUCCESS;
 }
 
-static celix_status_t filter_compare(const celix_filter_t* filter, const char *propertyValue, bool *out) {
-    celix_status_t  status = CELIX_SUCCESS;
-    bool result = false;
+static bool filter_parseLong(const char *str, long *out) {
+    if (str == NULL || *str == '\0') {
+        return false;
+    }
+    char *end = NULL;
+    errno = 0;
+    long val = strtol(str, &end, 10);
+    if (end == str || *end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    *out = val;
+    return true;
+}
 
-    if (filter == NULL || propertyValue == NULL) {
-        *out = false;
-        return status;
+static bool filter_parseDouble(const char *str, double *out) {
+    if (str == NULL || !(isdigit((unsigned char)str[0]) || str[0] == '-' || str[0] == '+' || str[0] == '.')) {
+        return false; //note also prevents parsing of "inf" and "nan" strings
+    }
+    char *end = NULL;
+    errno = 0;
+    double val = strtod(str, &end);
+    if (end == str || *end != '\0' || errno == ERANGE) {
+        return false;
     }
+    *out = val;
+    return true;
+}
 
-    switch (filter->operand) {
-        case CELIX_FILTER_OPERAND_SUBSTRING: {
-            int pos = 0;
-            unsigned int i;
-            int size = celix_arrayList_size(filter->children);
-            for (i = 0; i < size; i++) {
-                char * substr = (char *) celix_arrayList_get(filter->children, i);
-
-                if (i + 1 < size) {
-                    if (substr == NULL) {
-                        unsigned int index;
-                        char * substr2 = (char *) celix_arrayList_get(filter->children, i + 1);
-                        if (substr2 == NULL) {
-                            continue;
-                        }
-                        index = strcspn(propertyValue+pos, substr2);
-                        if (index == strlen(propertyValue+pos)) {
-                            *out = false;
-                            return CELIX_SUCCESS;
-                        }
+static bool filter_parseVersion(const char *str, celix_filter_version_parts_t *out) {
+    return celix_version_parse(str, &out->major, &out->minor, &out->micro, &out->qualifier);
+}
 
-                        pos = index + strlen(substr2);
-                        if (i + 2 < size) {
-                            i++;
-                        }
-                    } else {
-                        unsigned int len = strlen(substr);
-                        char * region = (char *)calloc(1, len+1);
-                        strncpy(region, propertyValue+pos, len);
-                        region[len]    = '\0';
-                        if (strcmp(region, substr) == 0) {
-                            pos += len;
-                        } else {
-                            free(region);
-                            *out = false;
-                            return CELIX_SUCCESS;
-                        }
-                        free(region);
-                    }
-                } else {
-                    unsigned int len;
-                    int begin;
+static int filter_compareVersionParts(const celix_filter_version_parts_t *v1, const celix_filter_version_parts_t *v2) {
+    if (v1->major != v2->major) {
+        return v1->major < v2->major ? -1 : 1;
+    }
+    if (v1->minor != v2->minor) {
+        return v1->minor < v2->minor ? -1 : 1;
+    }
+    if (v1->micro != v2->micro) {
+        return v1->micro < v2->micro ? -1 : 1;
+    }
+    return strcmp(v1->qualifier, v2->qualifier);
+}
 
-                    if (substr == NULL) {
-                        *out = true;
-                        return CELIX_SUCCESS;
-                    }
-                    len = strlen(substr);
-                    begin = strlen(propertyValue)-len;
-                    *out = (strcmp(propertyValue+begin, substr) == 0);
-                    return CELIX_SUCCESS;
-                }
+/**
+ * Initializes a (leaf) instruction for the provided filter.
+ * The operand value is converted to a long, double or version once, so that no parsing of the filter value is
+ * needed during matching. Does not allocate memory.
+ */
+static void filter_initInstruction(const celix_filter_t *filter, celix_filter_instruction_t *ins) {
+    memset(ins, 0, sizeof(*ins));
+    ins->operand = filter->operand;
+    ins->attribute = filter->attribute;
+    ins->value = filter->value;
+    ins->valueType = CELIX_FILTER_VALUE_TYPE_STRING;
+    if (filter->operand == CELIX_FILTER_OPERAND_SUBSTRING) {
+        ins->substrings = filter->children;
+    } else if (filter->operand == CELIX_FILTER_OPERAND_GREATER || filter->operand == CELIX_FILTER_OPERAND_GREATEREQUAL ||
+               filter->operand == CELIX_FILTER_OPERAND_LESS || filter->operand == CELIX_FILTER_OPERAND_LESSEQUAL) {
+        ins->hasVersionValue = filter_parseVersion(filter->value, &ins->versionValue);
+        if (filter_parseLong(filter->value, &ins->longValue)) {
+            ins->valueType = CELIX_FILTER_VALUE_TYPE_LONG;
+            ins->doubleValue = (double)ins->longValue;
+        } else if (filter_parseDouble(filter->value, &ins->doubleValue)) {
+            ins->valueType = CELIX_FILTER_VALUE_TYPE_DOUBLE;
+        } else if (ins->hasVersionValue) {
+            ins->valueType = CELIX_FILTER_VALUE_TYPE_VERSION;
+        }
+    }
+}
+
+static int filter_compareLongs(long l1, long l2) {
+    return l1 < l2 ? -1 : (l1 > l2 ? 1 : 0);
+}
+
+static int filter_compareDoubles(double d1, double d2) {
+    return d1 < d2 ? -1 : (d1 > d2 ? 1 : 0);
+}
+
+static bool filter_getEntryVersion(const celix_properties_entry_t *entry, celix_filter_version_parts_t *out) {
+    if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
+        const celix_version_t *version = entry->typed.versionValue;
+        out->major = celix_version_getMajor(version);
+        out->minor = celix_version_getMinor(version);
+        out->micro = celix_version_getMicro(version);
+        out->qualifier = celix_version_getQualifier(version);
+        return true;
+    }
+    //note values as "1" or "1.2" are cached as long and double
+    return filter_parseVersion(entry->value, out);
+}
+
+/**
+ * Compares the property entry with the (typed) instruction value.
+ * Numbers are compared numerically, versions as versions and strings lexically. Returns false if the property value
+ * and the instruction value have incompatible types (e.g. a number and a string), in which case the leaf does not match.
+ */
+static bool filter_compareValue(const celix_filter_instruction_t *ins, const celix_properties_entry_t *entry, int *cmp) {
+    celix_filter_version_parts_t val;
+    switch (ins->valueType) {
+        case CELIX_FILTER_VALUE_TYPE_LONG:
+            if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_LONG) {
+                *cmp = filter_compareLongs(entry->typed.longValue, ins->longValue);
+                return true;
+            }
+            //fallthrough, compare as double or as version
+        case CELIX_FILTER_VALUE_TYPE_DOUBLE:
+            if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_DOUBLE) {
+                *cmp = filter_compareDoubles(entry->typed.doubleValue, ins->doubleValue);
+                return true;
+            } else if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_LONG) {
+                *cmp = filter_compareDoubles((double)entry->typed.longValue, ins->doubleValue);
+                return true;
+            } else if (ins->hasVersionValue && filter_getEntryVersion(entry, &val)) {
+                *cmp = filter_compareVersionParts(&val, &ins->versionValue);
+                return true;
+            }
+            return false;
+        case CELIX_FILTER_VALUE_TYPE_VERSION:
+            if (filter_getEntryVersion(entry, &val)) {
+                *cmp = filter_compareVersionParts(&val, &ins->versionValue);
+                return true;
             }
-            *out = true;
-            return CELIX_SUCCESS;
+            return false;
+        case CELIX_FILTER_VALUE_TYPE_STRING:
+        default:
+            if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_STRING || entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_BOOL) {
+                *cmp = strcmp(entry->value, ins->value);
+                return true;
+            }
+            return false;
+    }
+}
+
+static bool filter_matchSubstring(const celix_array_list_t *substrings, const char *propertyValue) {
+    int size = celix_arrayList_size(substrings);
+    const char *pos = propertyValue;
+    for (int i = 0; i < size; ++i) {
+        const char *substr = celix_arrayList_get(substrings, i);
+        if (substr == NULL) {
+            continue; //wildcard
         }
+        size_t len = strlen(substr);
+        if (i == 0) {
+            //initial part, must be a prefix
+            if (strncmp(pos, substr, len) != 0) {
+                return false;
+            }
+            pos += len;
+        } else if (i + 1 == size) {
+            //final part, must be a suffix of the not yet matched part
+            size_t remaining = strlen(pos);
+            return remaining >= len && strcmp(pos + remaining - len, substr) == 0;
+        } else {
+            const char *found = strstr(pos, substr);
+            if (found == NULL) {
+                return false;
+            }
+            pos = found + len;
+        }
+    }
+    return true;
+}
+
+static bool filter_matchLeaf(const celix_filter_instruction_t *ins, const celix_properties_t *properties) {
+    const celix_properties_entry_t *entry = properties == NULL ? NULL : celix_properties_getEntry(properties, ins->attribute);
+    if (entry == NULL) {
+        return false;
+    }
+    const char *value = entry->value;
+    int cmp = 0;
+    switch (ins->operand) {
+        case CELIX_FILTER_OPERAND_PRESENT:
+            return true;
+        case CELIX_FILTER_OPERAND_SUBSTRING:
+            return filter_matchSubstring(ins->substrings, value);
         case CELIX_FILTER_OPERAND_APPROX: //TODO: Implement strcmp with ignorecase and ignorespaces
-        case CELIX_FILTER_OPERAND_EQUAL: {
-            *out = (strcmp(propertyValue, filter->value) == 0);
-            return CELIX_SUCCESS;
+        case CELIX_FILTER_OPERAND_EQUAL:
+            return strcmp(value, ins->value) == 0;
+        case CELIX_FILTER_OPERAND_GREATER:
+            return filter_compareValue(ins, entry, &cmp) && cmp > 0;
+        case CELIX_FILTER_OPERAND_GREATEREQUAL:
+            return filter_compareValue(ins, entry, &cmp) && cmp >= 0;
+        case CELIX_FILTER_OPERAND_LESS:
+            return filter_compareValue(ins, entry, &cmp) && cmp < 0;
+        case CELIX_FILTER_OPERAND_LESSEQUAL:
+            return filter_compareValue(ins, entry, &cmp) && cmp <= 0;
+        default:
+            return false;
+    }
+}
+
+static bool filter_matchInstructions(const celix_filter_instruction_t *instructions, unsigned int index, const celix_properties_t *properties) {
+    const celix_filter_instruction_t *ins = &instructions[index];
+    switch (ins->operand) {
+        case CELIX_FILTER_OPERAND_AND: {
+            unsigned int child = index + 1;
+            for (unsigned int i = 0; i < ins->nrOfChildren; ++i) {
+                if (!filter_matchInstructions(instructions, child, properties)) {
+                    return false;
+                }
+                child = instructions[child].next;
+            }
+            return true;
         }
-        case CELIX_FILTER_OPERAND_GREATER: {
-            *out = (strcmp(propertyValue, filter->value) > 0);
-            return CELIX_SUCCESS;
+        case CELIX_FILTER_OPERAND_OR: {
+            unsigned int child = index + 1;
+            for (unsigned int i = 0; i < ins->nrOfChildren; ++i) {
+                if (filter_matchInstructions(instructions, child, properties)) {
+                    return true;
+                }
+                child = instructions[child].next;
+            }
+            return false;
         }
-        case CELIX_FILTER_OPERAND_GREATEREQUAL: {
-            *out = (strcmp(propertyValue, filter->value) >= 0);
-            return CELIX_SUCCESS;
+        case CELIX_FILTER_OPERAND_NOT:
+            return !filter_matchInstructions(instructions, index + 1, properties);
+        default:
+            return filter_matchLeaf(ins, properties);
+    }
+}
+
+/**
+ * Counts the instructions needed for the filter. Returns 0 if the filter tree is incomplete.
+ * An AND or OR without children is a single instruction, which is constant true (AND) or constant false (OR).
+ */
+static unsigned int filter_countInstructions(const celix_filter_t *filter) {
+    if (filter == NULL) {
+        return 0;
+    }
+    unsigned int count = 1;
+    if (filter->operand == CELIX_FILTER_OPERAND_AND || filter->operand == CELIX_FILTER_OPERAND_OR || filter->operand == CELIX_FILTER_OPERAND_NOT) {
+        if (filter->children == NULL) {
+            return 0;
         }
-        case CELIX_FILTER_OPERAND_LESS: {
-            *out = (strcmp(propertyValue, filter->value) < 0);
-            return CELIX_SUCCESS;
+        int size = celix_arrayList_size(filter->children);
+        if (size == 0 && filter->operand == CELIX_FILTER_OPERAND_NOT) {
+            return 0;
         }
-        case CELIX_FILTER_OPERAND_LESSEQUAL: {
-            *out = (strcmp(propertyValue, filter->value) <= 0);
-            return CELIX_SUCCESS;
+        for (int i = 0; i < size; ++i) {
+            unsigned int childCount = filter_countInstructions(celix_arrayList_get(filter->children, i));
+            if (childCount == 0) {
+                return 0;
+            }
+            count += childCount;
         }
-        case CELIX_FILTER_OPERAND_AND:
-        case CELIX_FILTER_OPERAND_NOT:
-        case CELIX_FILTER_OPERAND_OR:
-        case CELIX_FILTER_OPERAND_PRESENT: {
+    } else if (filter->attribute == NULL) {
+        return 0;
+    }
+    return count;
+}
+
+/**
+ * Adds the instructions for the filter (depth first) starting at index and returns the index after the added instructions.
+ */
+static unsigned int filter_compileInstructions(const celix_filter_t *filter, celix_filter_internal_t *internal, unsigned int index) {
+    celix_filter_instruction_t *ins = &internal->instructions[index];
+    filter_initInstruction(filter, ins);
+    unsigned int next = index + 1;
+    if (filter->operand == CELIX_FILTER_OPERAND_AND || filter->operand == CELIX_FILTER_OPERAND_OR || filter->operand == CELIX_FILTER_OPERAND_NOT) {
+        int size = celix_arrayList_size(filter->children);
+        ins->nrOfChildren = (unsigned int)size;
+        for (int i = 0; i < size; ++i) {
+            next = filter_compileInstructions(celix_arrayList_get(filter->children, i), internal, next);
         }
-            /* no break */
     }
+    internal->instructions[index].next = next;
+    return next;
+}
 
-    if (status == CELIX_SUCCESS && out != NULL) {
-        *out = result;
+/**
+ * Compiles the filter tree into a contiguous array of instructions (depth first), so that matching does not need to
+ * traverse the array lists of the filter tree, does not need to parse the filter values and does not allocate memory.
+ */
+static celix_filter_internal_t* filter_compile(const celix_filter_t *filter) {
+    unsigned int count = filter_countInstructions(filter);
+    if (count == 0) {
+        return NULL;
+    }
+    celix_filter_internal_t *internal = calloc(1, sizeof(*internal));
+    if (internal != NULL) {
+        internal->instructions = calloc(count, sizeof(*internal->instructions));
+        if (internal->instructions == NULL) {
+            filter_destroyInternal(internal);
+            return NULL;
+        }
+        internal->nrOfInstructions = filter_compileInstructions(filter, internal, 0);
+        assert(internal->nrOfInstructions == count);
+    }
+    return internal;
+}
+
+static void filter_destroyInternal(celix_filter_internal_t *internal) {
+    if (internal != NULL) {
+        free(internal->instructions);
+        free(internal);
     }
-    return status;
 }
 
 celix_status_t filter_getString(celix_filter_t * filter, const char **filterStr) {
@@ -548,6 +789,15 @@ celix_filter_t* celix_filter_create(const char *filterString) {
         }
     }
 
+    if (filter != NULL) {
+        filter->internal = filter_compile(filter);
+        if (filter->internal == NULL) {
+            fprintf(stderr, "Filter Error: Cannot compile filter '%s'.\n", filterStr);
+            filter_destroy(filter);
+            filter = NULL;
+        }
+    }
+
     if (filter == NULL) {
         free(filterStr);
     } else {
@@ -588,12 +838,18 @@ void celix_filter_destroy(celix_filter_t *filter) {
         filter->attribute = NULL;
         free((char*)filter->filterStr);
         filter->filterStr = NULL;
+        filter_destroyInternal(filter->internal);
+        filter->internal = NULL;
         free(filter);
     }
 }
 
 bool celix_filter_match(const celix_filter_t *filter, const celix_properties_t* properties) {
-    bool result = false;
+    if (filter->internal != NULL) {
+        return filter_matchInstructions(filter->internal->instructions, 0, properties);
+    }
+
+    //not compiled (e.g. a sub filter), interpret the filter tree
     switch (filter->operand) {
         case CELIX_FILTER_OPERAND_AND: {
             celix_array_list_t* children = filter->children;
@@ -624,23 +880,12 @@ bool celix_filter_match(const celix_filter_t *filter, const celix_properties_t*
             bool mresult = celix_filter_match(sfilter, properties);
             return !mresult;
         }
-        case CELIX_FILTER_OPERAND_SUBSTRING :
-        case CELIX_FILTER_OPERAND_EQUAL :
-        case CELIX_FILTER_OPERAND_GREATER :
-        case CELIX_FILTER_OPERAND_GREATEREQUAL :
-        case CELIX_FILTER_OPERAND_LESS :
-        case CELIX_FILTER_OPERAND_LESSEQUAL :
-        case CELIX_FILTER_OPERAND_APPROX : {
-            char * value = (properties == NULL) ? NULL: (char*)celix_properties_get(properties, filter->attribute, NULL);
-            filter_compare(filter, value, &result);
-            return result;
-        }
-        case CELIX_FILTER_OPERAND_PRESENT: {
-            char * value = (properties == NULL) ? NULL: (char*)celix_properties_get(properties, filter->attribute, NULL);
-            return value != NULL;
+        default: {
+            celix_filter_instruction_t ins;
+            filter_initInstruction(filter, &ins);
+            return filter_matchLeaf(&ins, properties);
         }
     }
-    return result;
 }
 
 bool celix_filter_matchFilter(const celix_filter_t *filter1, const celix_filter_t *filter2) {
@@ -32,12 +32,47 @@
 #include "properties.h"
 #include "celix_properties.h"
 #include "utils.h"
-#include "hash_map_private.h"
 #include <errno.h>
 
 
 #define MALLOC_BLOCK_SIZE        5
 
+#define CELIX_PROPERTIES_INITIAL_CAPACITY       8 //must be a power of 2
+#define CELIX_PROPERTIES_MIN_STRING_BLOCK_SIZE  128
+#define CELIX_PROPERTIES_MAX_STRING_BLOCK_SIZE  4096
+
+typedef struct celix_properties_slot {
+    unsigned int hash;
+    char *key; //NULL for an empty slot
+    celix_properties_entry_t entry;
+} celix_properties_slot_t;
+
+/**
+ * Block of memory used to store the key and value strings of a properties set.
+ */
+typedef struct celix_properties_string_block {
+    struct celix_properties_string_block *next; //older (smaller) block
+    size_t size;
+    size_t used;
+    size_t freed; //nr of used bytes of removed or replaced strings
+    char data[];
+} celix_properties_string_block_t;
+
+/**
+ * Properties as a flat open-addressing (linear probing) hash table.
+ * The slot table and the string blocks are allocated on first use, so an empty properties set is a single small
+ * allocation. String blocks start small and double in size (up to a maximum) when a block is full. Strings which
+ * are too large for a block and values which replace an existing value are heap allocated.
+ * Block space of removed strings is not reused, but a block is released (or reset if it is the newest block) as soon
+ * as all its strings are removed.
+ */
+struct celix_properties {
+    unsigned int size;
+    unsigned int capacity; //0 if no slot table is allocated yet
+    celix_properties_slot_t *slots;
+    celix_properties_string_block_t *strings; //newest string block, NULL if no string block is allocated yet
+};
+
 static void parseLine(const char* line, celix_properties_t *props);
 
 properties_pt properties_create(void) {
@@ -65,7 +100,7 @@ properties_pt properties_loadFromString(const char *input){
  * Header is ignored for now, cannot handle comments yet
  */
 void properties_store(properties_pt properties, const char* filename, const char* header) {
-    return celix_properties_store(properties, filename, header);
+    celix_properties_store(properties, filename, header);
 }
 
 celix_status_t properties_copy(properties_pt properties, properties_pt *out) {
@@ -215,21 +250,225 @@ static void parseLine(const char* line, celix_properties_t *props) {
  **********************************************************************************************************************
  **********************************************************************************************************************/
 
+static char* celix_properties_createString(celix_properties_t *properties, const char *str) {
+    if (str == NULL) {
+        return NULL;
+    }
+    size_t len = strnlen(str, 1024 * 1024) + 1;
+    char *result = NULL;
+    celix_properties_string_block_t *block = properties->strings;
+    if (block == NULL || block->used + len > block->size) {
+        size_t blockSize = block == NULL ? CELIX_PROPERTIES_MIN_STRING_BLOCK_SIZE : block->size * 2;
+        if (blockSize > CELIX_PROPERTIES_MAX_STRING_BLOCK_SIZE) {
+            blockSize = CELIX_PROPERTIES_MAX_STRING_BLOCK_SIZE;
+        }
+        if (len * 4 <= blockSize) { //only start a new block for strings which are small compared to the block
+            celix_properties_string_block_t *newBlock = malloc(sizeof(*newBlock) + blockSize);
+            if (newBlock != NULL) {
+                newBlock->next = block;
+                newBlock->size = blockSize;
+                newBlock->used = 0;
+                newBlock->freed = 0;
+                properties->strings = newBlock;
+                block = newBlock;
+            }
+        }
+    }
+    if (block != NULL && block->used + len <= block->size) {
+        result = block->data + block->used;
+        block->used += len;
+    } else {
+        result = malloc(len);
+        if (result == NULL) {
+            return NULL;
+        }
+    }
+    memcpy(result, str, len - 1);
+    result[len - 1] = '\0';
+    return result;
+}
+
+static void celix_properties_freeString(celix_properties_t *properties, char *str) {
+    if (str == NULL) {
+        return;
+    }
+    celix_properties_string_block_t *prev = NULL;
+    for (celix_properties_string_block_t *block = properties->strings; block != NULL; prev = block, block = block->next) {
+        if (str >= block->data && str < block->data + block->size) {
+            block->freed += strlen(str) + 1;
+            if (block->freed == block->used) {
+                if (prev == NULL) {
+                    block->used = 0;
+                    block->freed = 0;
+                } else {
+                    prev->next = block->next;
+                    free(block);
+                }
+            }
+            return;
+        }
+    }
+    free(str);
+}
+
+/**
+ * Sets the value of the entry and determines and caches the typed value.
+ * Only a complete conversion of the value string results in a typed value.
+ */
+static void celix_properties_initEntry(celix_properties_entry_t *entry, const char *value) {
+    memset(entry, 0, sizeof(*entry));
+    entry->value = value;
+    entry->valueType = CELIX_PROPERTIES_VALUE_TYPE_STRING;
+    if (value == NULL || value[0] == '\0') {
+        return;
+    }
+
+    char *end = NULL;
+    errno = 0;
+    long l = strtol(value, &end, 10);
+    if (end != value && *end == '\0' && errno == 0) {
+        entry->valueType = CELIX_PROPERTIES_VALUE_TYPE_LONG;
+        entry->typed.longValue = l;
+        return;
+    }
+
+    if (isdigit((unsigned char)value[0]) || value[0] == '-' || value[0] == '+' || value[0] == '.') {
+        errno = 0;
+        double d = strtod(value, &end);
+        if (end != value && *end == '\0' && errno == 0) {
+            entry->valueType = CELIX_PROPERTIES_VALUE_TYPE_DOUBLE;
+            entry->typed.doubleValue = d;
+            return;
+        }
+        celix_version_t *version = isdigit((unsigned char)value[0]) && strchr(value, '.') != NULL ? celix_version_createVersionFromString(value) : NULL;
+        if (version != NULL) {
+            entry->valueType = CELIX_PROPERTIES_VALUE_TYPE_VERSION;
+            entry->typed.versionValue = version;
+        }
+        return;
+    }
+
+    if (strcasecmp("true", value) == 0) {
+        entry->valueType = CELIX_PROPERTIES_VALUE_TYPE_BOOL;
+        entry->typed.boolValue = true;
+    } else if (strcasecmp("false", value) == 0) {
+        entry->valueType = CELIX_PROPERTIES_VALUE_TYPE_BOOL;
+        entry->typed.boolValue = false;
+    }
+}
 
+static void celix_properties_clearEntry(celix_properties_t *properties, celix_properties_entry_t *entry) {
+    if (entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
+        celix_version_destroy((celix_version_t*)entry->typed.versionValue);
+    }
+    celix_properties_freeString(properties, (char*)entry->value);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static celix_properties_slot_t* celix_properties_findSlot(const celix_properties_t *properties, const char *key, unsigned int hash) {
+    if (properties->capacity == 0) {
+        return NULL;
+    }
+    unsigned int mask = properties->capacity - 1;
+    unsigned int index = hash & mask;
+    while (properties->slots[index].key != NULL) {
+        celix_properties_slot_t *slot = &properties->slots[index];
+        if (slot->hash == hash && strcmp(slot->key, key) == 0) {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
+
+/**
+ * Returns the empty slot to use for a key which is not yet present (linear probing).
+ */
+static celix_properties_slot_t* celix_properties_findEmptySlot(celix_properties_slot_t *slots, unsigned int capacity, unsigned int hash) {
+    unsigned int mask = capacity - 1;
+    unsigned int index = hash & mask;
+    while (slots[index].key != NULL) {
+        index = (index + 1) & mask;
+    }
+    return &slots[index];
+}
+
+static celix_status_t celix_properties_ensureCapacity(celix_properties_t *properties, unsigned int size) {
+    unsigned int newCapacity = properties->capacity == 0 ? CELIX_PROPERTIES_INITIAL_CAPACITY : properties->capacity;
+    while (size * 4 > newCapacity * 3) { //max load factor 0.75
+        newCapacity *= 2;
+    }
+    if (newCapacity == properties->capacity) {
+        return CELIX_SUCCESS;
+    }
+
+    celix_properties_slot_t *newSlots = calloc(newCapacity, sizeof(*newSlots));
+    if (newSlots == NULL) {
+        return CELIX_ENOMEM;
+    }
+    for (unsigned int i = 0; i < properties->capacity; ++i) {
+        celix_properties_slot_t *slot = &properties->slots[i];
+        if (slot->key != NULL) {
+            *celix_properties_findEmptySlot(newSlots, newCapacity, slot->hash) = *slot;
+        }
+    }
+    free(properties->slots);
+    properties->slots = newSlots;
+    properties->capacity = newCapacity;
+    return CELIX_SUCCESS;
+}
+
+/**
+ * Puts the key/value in the properties. The properties takes ownership of the provided key and value strings.
+ */
+static void celix_properties_put(celix_properties_t *properties, char *key, char *value) {
+    unsigned int hash = celix_utils_stringHash(key);
+    celix_properties_slot_t *slot = celix_properties_findSlot(properties, key, hash);
+    if (slot != NULL) {
+        celix_properties_freeString(properties, key);
+        celix_properties_clearEntry(properties, &slot->entry);
+    } else if (celix_properties_ensureCapacity(properties, properties->size + 1) == CELIX_SUCCESS) {
+        slot = celix_properties_findEmptySlot(properties->slots, properties->capacity, hash);
+        slot->hash = hash;
+        slot->key = key;
+        properties->size += 1;
+    } else {
+        fprintf(stderr, "Properties Error: Cannot add property '%s'.\n", key);
+        celix_properties_freeString(properties, key);
+        celix_properties_freeString(properties, value);
+        return;
+    }
+    celix_properties_initEntry(&slot->entry, value);
+}
 
 celix_properties_t* celix_properties_create(void) {
-    return hashMap_create(utils_stringHash, utils_stringHash, utils_stringEquals, utils_stringEquals);
+    celix_properties_t *props = malloc(sizeof(*props));
+    if (props != NULL) {
+        props->size = 0;
+        props->capacity = 0;
+        props->slots = NULL;
+        props->strings = NULL;
+    }
+    return props;
 }
 
 void celix_properties_destroy(celix_properties_t *properties) {
     if (properties != NULL) {
-        hash_map_iterator_pt iter = hashMapIterator_create(properties);
-        while (hashMapIterator_hasNext(iter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-            hashMapEntry_clear(entry, true, true);
+        for (unsigned int i = 0; i < properties->capacity; ++i) {
+            celix_properties_slot_t *slot = &properties->slots[i];
+            if (slot->key != NULL) {
+                celix_properties_clearEntry(properties, &slot->entry);
+                celix_properties_freeString(properties, slot->key);
+            }
+        }
+        free(properties->slots);
+        celix_properties_string_block_t *block = properties->strings;
+        while (block != NULL) {
+            celix_properties_string_block_t *next = block->next;
+            free(block);
+            block = next;
         }
-        hashMapIterator_destroy(iter);
-        hashMap_destroy(properties, false, false);
+        free(properties);
     }
 }
 
@@ -306,16 +545,16 @@ celix_properties_t* celix_properties_loadFromString(const char *input) {
     return props;
 }
 
-void celix_properties_store(celix_properties_t *properties, const char *filename, const char *header) {
+celix_status_t celix_properties_store(celix_properties_t *properties, const char *filename, const char *header) {
     FILE *file = fopen (filename, "w+" );
-    char *str;
+    const char *str;
+    celix_status_t status = CELIX_SUCCESS;
 
     if (file != NULL) {
-        if (hashMap_size(properties) > 0) {
-            hash_map_iterator_pt iterator = hashMapIterator_create(properties);
-            while (hashMapIterator_hasNext(iterator)) {
-                hash_map_entry_pt entry = hashMapIterator_nextEntry(iterator);
-                str = hashMapEntry_getKey(entry);
+        if (celix_properties_size(properties) > 0) {
+            const char *key;
+            CELIX_PROPERTIES_FOR_EACH(properties, key) {
+                str = key;
                 for (int i = 0; i < strlen(str); i += 1) {
                     if (str[i] == '#' || str[i] == '!' || str[i] == '=' || str[i] == ':') {
                         fputc('\\', file);
@@ -325,7 +564,7 @@ void celix_properties_store(celix_properties_t *properties, const char *filename
 
                 fputc('=', file);
 
-                str = hashMapEntry_getValue(entry);
+                str = celix_properties_get(properties, key, "");
                 for (int i = 0; i < strlen(str); i += 1) {
                     if (str[i] == '#' || str[i] == '!' || str[i] == '=' || str[i] == ':') {
                         fputc('\\', file);
@@ -336,76 +575,141 @@ void celix_properties_store(celix_properties_t *properties, const char *filename
                 fputc('\n', file);
 
             }
-            hashMapIterator_destroy(iterator);
         }
-        fclose(file);
+        if (ferror(file)) {
+            status = CELIX_FILE_IO_EXCEPTION;
+        }
+        if (fclose(file) != 0) {
+            status = CELIX_FILE_IO_EXCEPTION;
+        }
     } else {
         perror("File is null");
+        status = CELIX_FILE_IO_EXCEPTION;
     }
+    return status;
 }
 
 celix_properties_t* celix_properties_copy(const celix_properties_t *properties) {
     celix_properties_t *copy = celix_properties_create();
-    if (copy != NULL) {
-        hash_map_iterator_t iter = hashMapIterator_construct((hash_map_t*)properties);
-        while (hashMapIterator_hasNext(&iter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(&iter);
-            char *key = hashMapEntry_getKey(entry);
-            char *value = hashMapEntry_getValue(entry);
-            celix_properties_set(copy, key, value);
+    if (copy != NULL && properties != NULL && properties->size > 0) {
+        if (celix_properties_ensureCapacity(copy, properties->size) != CELIX_SUCCESS) {
+            celix_properties_destroy(copy);
+            return NULL;
+        }
+        //note a single string block for all the strings in the string blocks of the source
+        size_t stringsSize = 0;
+        for (const celix_properties_string_block_t *block = properties->strings; block != NULL; block = block->next) {
+            stringsSize += block->used - block->freed;
+        }
+        if (stringsSize > 0) {
+            copy->strings = malloc(sizeof(*copy->strings) + stringsSize);
+            if (copy->strings != NULL) {
+                copy->strings->next = NULL;
+                copy->strings->size = stringsSize;
+                copy->strings->used = 0;
+                copy->strings->freed = 0;
+            }
+        }
+        for (unsigned int i = 0; i < properties->capacity; ++i) {
+            const celix_properties_slot_t *slot = &properties->slots[i];
+            if (slot->key == NULL) {
+                continue;
+            }
+            //note no need to search for existing keys or to parse the values again
+            celix_properties_slot_t *copySlot = celix_properties_findEmptySlot(copy->slots, copy->capacity, slot->hash);
+            copySlot->hash = slot->hash;
+            copySlot->key = celix_properties_createString(copy, slot->key);
+            copySlot->entry = slot->entry;
+            copySlot->entry.value = celix_properties_createString(copy, slot->entry.value);
+            if (slot->entry.valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
+                copySlot->entry.typed.versionValue = celix_version_copy(slot->entry.typed.versionValue);
+            }
+            copy->size += 1;
         }
     }
     return copy;
 }
 
 const char* celix_properties_get(const celix_properties_t *properties, const char *key, const char *defaultValue) {
-    const char* value = NULL;
-    if (properties != NULL) {
-        value = hashMap_get((hash_map_t*)properties, (void*)key);
+    const celix_properties_entry_t *entry = celix_properties_getEntry(properties, key);
+    return entry == NULL ? defaultValue : entry->value;
+}
+
+const celix_properties_entry_t* celix_properties_getEntry(const celix_properties_t *properties, const char *key) {
+    const celix_properties_entry_t *entry = NULL;
+    if (properties != NULL && key != NULL) {
+        celix_properties_slot_t *slot = celix_properties_findSlot(properties, key, celix_utils_stringHash(key));
+        if (slot != NULL && slot->entry.value != NULL) {
+            entry = &slot->entry;
+        }
     }
-    return value == NULL ? defaultValue : value;
+    return entry;
 }
 
 void celix_properties_set(celix_properties_t *properties, const char *key, const char *value) {
-    if (properties != NULL) {
-        hash_map_entry_pt entry = hashMap_getEntry(properties, key);
-        char *oldVal = NULL;
-        char *newVal = value == NULL ? NULL : strndup(value, 1024 * 1024);
-        if (entry != NULL) {
-            char *oldKey = hashMapEntry_getKey(entry);
-            oldVal = hashMapEntry_getValue(entry);
-            hashMap_put(properties, oldKey, newVal);
-        } else {
-            hashMap_put(properties, strndup(key, 1024 * 1024), newVal);
+    if (properties == NULL || key == NULL) {
+        return;
+    }
+    celix_properties_slot_t *slot = celix_properties_findSlot(properties, key, celix_utils_stringHash(key));
+    if (slot != NULL) {
+        //note replaced values are heap allocated, so that repeatedly updating a property does not fill the string blocks
+        char *copy = value == NULL ? NULL : strdup(value);
+        if (value != NULL && copy == NULL) {
+            fprintf(stderr, "Properties Error: Cannot update property '%s'.\n", key);
+            return;
         }
-        free(oldVal);
+        celix_properties_clearEntry(properties, &slot->entry);
+        celix_properties_initEntry(&slot->entry, copy);
+    } else {
+        celix_properties_put(properties, celix_properties_createString(properties, key), celix_properties_createString(properties, value));
     }
 }
 
 void celix_properties_setWithoutCopy(celix_properties_t *properties, char *key, char *value) {
-    if (properties != NULL) {
-        hash_map_entry_pt entry = hashMap_getEntry(properties, key);
-        char *oldVal = NULL;
-        if (entry != NULL) {
-            char *oldKey = hashMapEntry_getKey(entry);
-            oldVal = hashMapEntry_getValue(entry);
-            hashMap_put(properties, oldKey, value);
-        } else {
-            hashMap_put(properties, key, value);
-        }
-        free(oldVal);
+    if (properties != NULL && key != NULL) {
+        celix_properties_put(properties, key, value);
     }
 }
 
 void celix_properties_unset(celix_properties_t *properties, const char *key) {
-    char* oldValue = hashMap_remove(properties, key);
-    free(oldValue);
+    if (properties == NULL || key == NULL) {
+        return;
+    }
+    celix_properties_slot_t *slot = celix_properties_findSlot(properties, key, celix_utils_stringHash(key));
+    if (slot == NULL) {
+        return;
+    }
+    celix_properties_clearEntry(properties, &slot->entry);
+    celix_properties_freeString(properties, slot->key);
+    properties->size -= 1;
+
+    //backward shift deletion, so that no tombstones are needed for linear probing
+    unsigned int mask = properties->capacity - 1;
+    unsigned int empty = (unsigned int)(slot - properties->slots);
+    unsigned int index = empty;
+    while (true) {
+        index = (index + 1) & mask;
+        celix_properties_slot_t *next = &properties->slots[index];
+        if (next->key == NULL) {
+            break;
+        }
+        unsigned int home = next->hash & mask;
+        bool homeBetween = empty <= index ? (empty < home && home <= index) : (empty < home || home <= index);
+        if (!homeBetween) {
+            properties->slots[empty] = *next;
+            empty = index;
+        }
+    }
+    memset(&properties->slots[empty], 0, sizeof(properties->slots[empty]));
 }
 
 long celix_properties_getAsLong(const celix_properties_t *props, const char *key, long defaultValue) {
     long result = defaultValue;
-    const char *val = celix_properties_get(props, key, NULL);
-    if (val != NULL) {
+    const celix_properties_entry_t *entry = celix_properties_getEntry(props, key);
+    if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_LONG) {
+        result = entry->typed.longValue;
+    } else if (entry != NULL) {
+        const char *val = entry->value;
         char *enptr = NULL;
         errno = 0;
         long r = strtol(val, &enptr, 10);
@@ -428,8 +732,13 @@ void celix_properties_setLong(celix_properties_t *props, const char *key, long v
 
 double celix_properties_getAsDouble(const celix_properties_t *props, const char *key, double defaultValue) {
     double result = defaultValue;
-    const char *val = celix_properties_get(props, key, NULL);
-    if (val != NULL) {
+    const celix_properties_entry_t *entry = celix_properties_getEntry(props, key);
+    if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_DOUBLE) {
+        result = entry->typed.doubleValue;
+    } else if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_LONG) {
+        result = (double)entry->typed.longValue;
+    } else if (entry != NULL) {
+        const char *val = entry->value;
         char *enptr = NULL;
         errno = 0;
         double r = strtod(val, &enptr);
@@ -450,12 +759,22 @@ void celix_properties_setDouble(celix_properties_t *props, const char *key, doub
     }
 }
 
+const celix_version_t* celix_properties_getAsVersion(const celix_properties_t *props, const char *key, const celix_version_t *defaultValue) {
+    const celix_properties_entry_t *entry = celix_properties_getEntry(props, key);
+    if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_VERSION) {
+        return entry->typed.versionValue;
+    }
+    return defaultValue;
+}
+
 bool celix_properties_getAsBool(const celix_properties_t *props, const char *key, bool defaultValue) {
     bool result = defaultValue;
-    const char *val = celix_properties_get(props, key, NULL);
-    if (val != NULL) {
+    const celix_properties_entry_t *entry = celix_properties_getEntry(props, key);
+    if (entry != NULL && entry->valueType == CELIX_PROPERTIES_VALUE_TYPE_BOOL) {
+        result = entry->typed.boolValue;
+    } else if (entry != NULL) {
         char buf[32];
-        snprintf(buf, 32, "%s", val);
+        snprintf(buf, 32, "%s", entry->value);
         char *trimmed = utils_stringTrim(buf);
         if (strncasecmp("true", trimmed, strlen("true")) == 0) {
             result = true;
@@ -471,15 +790,32 @@ void celix_properties_setBool(celix_properties_t *props, const char *key, bool v
 }
 
 int celix_properties_size(const celix_properties_t *properties) {
-    return hashMap_size((hash_map_t*)properties);
+    return properties == NULL ? 0 : (int)properties->size;
 }
 
 celix_properties_iterator_t celix_propertiesIterator_construct(const celix_properties_t *properties) {
-    return hashMapIterator_construct((hash_map_t*)properties);
+    celix_properties_iterator_t iter;
+    iter._props = properties;
+    iter._index = 0;
+    return iter;
 }
+
 bool celix_propertiesIterator_hasNext(celix_properties_iterator_t *iter) {
-    return hashMapIterator_hasNext(iter);
+    const celix_properties_t *props = iter->_props;
+    if (props == NULL) {
+        return false;
+    }
+    while (iter->_index < props->capacity && props->slots[iter->_index].key == NULL) {
+        iter->_index += 1;
+    }
+    return iter->_index < props->capacity;
 }
+
 const char* celix_propertiesIterator_nextKey(celix_properties_iterator_t *iter) {
-    return (const char*)hashMapIterator_nextKey(iter);
+    const char *key = NULL;
+    if (celix_propertiesIterator_hasNext(iter)) {
+        key = iter->_props->slots[iter->_index].key;
+        iter->_index += 1;
+    }
+    return key;
 }
@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
+#include <limits.h>
 #include <celix_utils.h>
 
 #include "celix_version.h"
@@ -149,82 +151,61 @@ celix_version_t* celix_version_copy(const celix_version_t* version) {
 }
 
 
-celix_version_t* celix_version_createVersionFromString(const char *versionStr) {
+bool celix_version_parse(const char *versionStr, int *major, int *minor, int *micro, const char **qualifier) {
     if (versionStr == NULL) {
-        return NULL;
+        return false;
     }
-
-    int major = 0;
-    int minor = 0;
-    int micro = 0;
-    char * qualifier = NULL;
-
-    char delims[] = ".";
-    char *token = NULL;
-    char *last = NULL;
-
-    int i = 0;
-
-    char* versionWrkStr = strdup(versionStr);
-
-    celix_status_t status = CELIX_SUCCESS;
-    token = strtok_r(versionWrkStr, delims, &last);
-    if (token != NULL) {
-        for (i = 0; i < strlen(token); i++) {
-            char ch = token[i];
-            if (('0' <= ch) && (ch <= '9')) {
-                continue;
+    int parts[3] = {0, 0, 0};
+    const char *c = versionStr;
+    int i;
+    for (i = 0; i < 3 && (i == 0 || *c != '\0'); ++i) {
+        if (i > 0) {
+            if (*c != '.') {
+                return false;
             }
-            status = CELIX_ILLEGAL_ARGUMENT;
-            break;
+            ++c;
         }
-        major = atoi(token);
-        token = strtok_r(NULL, delims, &last);
-        if (token != NULL) {
-            for (i = 0; i < strlen(token); i++) {
-                char ch = token[i];
-                if (('0' <= ch) && (ch <= '9')) {
-                    continue;
-                }
-                status = CELIX_ILLEGAL_ARGUMENT;
-                break;
-            }
-            minor = atoi(token);
-            token = strtok_r(NULL, delims, &last);
-            if (token != NULL) {
-                for (i = 0; i < strlen(token); i++) {
-                    char ch = token[i];
-                    if (('0' <= ch) && (ch <= '9')) {
-                        continue;
-                    }
-                    status = CELIX_ILLEGAL_ARGUMENT;
-                    break;
-                }
-                micro = atoi(token);
-                token = strtok_r(NULL, delims, &last);
-                if (token != NULL) {
-                    qualifier = strdup(token);
-                    token = strtok_r(NULL, delims, &last);
-                    if (token != NULL) {
-                        status = CELIX_ILLEGAL_ARGUMENT;
-                    }
-                }
+        if (!isdigit((unsigned char)*c)) {
+            return false; //note also rejects empty parts, e.g. "1..3"
+        }
+        long part = 0;
+        while (isdigit((unsigned char)*c)) {
+            part = part * 10 + (*c - '0');
+            if (part > INT_MAX) {
+                return false;
             }
+            ++c;
         }
+        parts[i] = (int)part;
     }
-
-    free(versionWrkStr);
-
-    celix_version_t* version = NULL;
-    if (status == CELIX_SUCCESS) {
-        version = celix_version_createVersion(major, minor, micro, qualifier);
+    const char *qual = "";
+    if (*c != '\0') {
+        if (i < 3 || *c != '.' || *(c + 1) == '\0') {
+            return false;
+        }
+        qual = ++c;
+        for (; *c != '\0'; ++c) {
+            if (!isalnum((unsigned char)*c) && *c != '_' && *c != '-') {
+                return false;
+            }
+        }
     }
+    *major = parts[0];
+    *minor = parts[1];
+    *micro = parts[2];
+    *qualifier = qual;
+    return true;
+}
 
-    if (qualifier != NULL) {
-        free(qualifier);
+celix_version_t* celix_version_createVersionFromString(const char *versionStr) {
+    int major;
+    int minor;
+    int micro;
+    const char *qualifier;
+    if (!celix_version_parse(versionStr, &major, &minor, &micro, &qualifier)) {
+        return NULL;
     }
-
-    return version;
+    return celix_version_createVersion(major, minor, micro, qualifier);
 }
 
 
@@ -20,6 +20,8 @@
 #ifndef VERSION_PRIVATE_H_
 #define VERSION_PRIVATE_H_
 
+#include <stdbool.h>
+
 struct celix_version {
     int major;
     int minor;
@@ -27,5 +29,12 @@ struct celix_version {
     char *qualifier;
 };
 
+/**
+ * Parses a version string (major[.minor[.micro[.qualifier]]]) without allocating memory.
+ * The qualifier points into the provided string.
+ * Used for creating versions and for the version operands of filters, so that both accept the same version strings.
+ */
+bool celix_version_parse(const char *versionStr, int *major, int *minor, int *micro, const char **qualifier);
+
 
 #endif /* VERSION_PRIVATE_H_ */
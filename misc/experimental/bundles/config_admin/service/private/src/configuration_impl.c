@@ -598,9 +598,9 @@ celix_status_t configuration_updateDictionary(configuration_impl_pt configuratio
 
 	if ( newDictionary != NULL ){
 
-		hashMap_remove(newDictionary, (void *) OSGI_FRAMEWORK_SERVICE_PID);
-		hashMap_remove(newDictionary, (void *) SERVICE_FACTORYPID);
-		hashMap_remove(newDictionary, (void *) SERVICE_BUNDLELOCATION);
+		celix_properties_unset(newDictionary, OSGI_FRAMEWORK_SERVICE_PID);
+		celix_properties_unset(newDictionary, SERVICE_FACTORYPID);
+		celix_properties_unset(newDictionary, SERVICE_BUNDLELOCATION);
 	}
 
 	configuration->dictionary = newDictionary;